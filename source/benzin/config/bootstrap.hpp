@@ -12,6 +12,7 @@
 #include "benzin/utility/string_utils.hpp"
 
 #include "benzin/core/common.hpp"
+#include "benzin/core/frame_arena.hpp"
 #include "benzin/core/scoped_timer.hpp"
 
 // Global configs
@@ -10,6 +10,14 @@
   #error Unknown build type
 #endif
 
+// Replaces global 'operator new' and 'operator delete' to count allocations, see 'heap_allocation_counter.cpp'
+// Always on in Debug, Release builds get it with the 'heap-allocation-counting' premake option
+#if BENZIN_IS_DEBUG_BUILD || defined(BENZIN_HEAP_ALLOCATION_COUNTING)
+  #define BENZIN_IS_HEAP_ALLOCATION_COUNTING_ENABLED 1
+#else
+  #define BENZIN_IS_HEAP_ALLOCATION_COUNTING_ENABLED 0
+#endif
+
 #if defined(BENZIN_PLATFORM_WIN64)
   #define BENZIN_IS_PLATFORM_WIN64 1
 #else
@@ -5,10 +5,14 @@
 #include <ctime>
 
 #include <array>
+#include <atomic>
+#include <bit>
 #include <bitset>
 #include <charconv>
 #include <chrono>
 #include <concepts>
+#include <condition_variable>
+#include <deque>
 #include <execution>
 #include <expected>
 #include <filesystem>
@@ -21,6 +25,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numbers>
 #include <numeric>
 #include <print>
@@ -31,6 +36,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
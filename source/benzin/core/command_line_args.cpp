@@ -54,6 +54,8 @@ namespace benzin
         uint32_t WindowHeight = 720;
         bool IsWindowResizable = true;
 
+        uint32_t JobWorkerCount = 0;
+
         uint32_t AdapterIndex = 0;
         uint32_t FrameInFlightCount = 3;
         GraphicsFormat BackBufferFormat = GraphicsFormat::Rgba8Unorm;
@@ -69,6 +71,8 @@ namespace benzin
                 SupportedCommandLineArg{ "-window_height:", &WindowHeight, ParseArithmetic<decltype(WindowHeight)> },
                 SupportedCommandLineArg{ "-disable_window_resizing", &IsWindowResizable, SetFalseIfExists },
 
+                SupportedCommandLineArg{ "-job_worker_count:", &JobWorkerCount, ParseArithmetic<decltype(JobWorkerCount)> },
+
                 SupportedCommandLineArg{ "-adapter_index:", &AdapterIndex, ParseArithmetic<decltype(AdapterIndex)> },
                 SupportedCommandLineArg{ "-frame_in_flight_count:", &FrameInFlightCount, ParseArithmetic<decltype(FrameInFlightCount)> },
                 SupportedCommandLineArg{ "-force_disable_gpu_upload_heaps", &IsGpuUploadHeapsEnabled, SetFalseIfExists },
@@ -110,6 +114,7 @@ namespace benzin
     uint32_t CommandLineArgs::GetWindowWidth() { return g_CommandLineArgsState->WindowWidth; }
     uint32_t CommandLineArgs::GetWindowHeight() { return g_CommandLineArgsState->WindowHeight; }
     bool CommandLineArgs::IsWindowResizable() { return g_CommandLineArgsState->IsWindowResizable; }
+    uint32_t CommandLineArgs::GetJobWorkerCount() { return g_CommandLineArgsState->JobWorkerCount; }
     uint32_t CommandLineArgs::GetAdapterIndex() { return g_CommandLineArgsState->AdapterIndex; }
     uint32_t CommandLineArgs::GetFrameInFlightCount() { return g_CommandLineArgsState->FrameInFlightCount; }
     GraphicsFormat CommandLineArgs::GetBackBufferFormat() { return g_CommandLineArgsState->BackBufferFormat; }
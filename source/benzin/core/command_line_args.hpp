@@ -20,6 +20,8 @@ namespace benzin
         static uint32_t GetWindowHeight();
         static bool IsWindowResizable();
 
+        static uint32_t GetJobWorkerCount(); // Zero means one per core except the main thread
+
         static uint32_t GetAdapterIndex();
         static uint32_t GetFrameInFlightCount();
         static GraphicsFormat GetBackBufferFormat();
@@ -99,6 +99,29 @@ namespace benzin
         const T m_Lambda;
     };
 
+    template <typename Signature>
+    class FunctionRef;
+
+    // Non owning reference to a callable. Unlike 'std::function' it never allocates, so it's used for callbacks of hot paths
+    // The callable must outlive the reference, so it's meant for parameters only
+    template <typename Result, typename... Args>
+    class FunctionRef<Result(Args...)>
+    {
+    public:
+        template <typename Function> requires (!std::is_same_v<std::remove_cvref_t<Function>, FunctionRef> && std::is_invocable_r_v<Result, Function&, Args...>)
+        FunctionRef(Function&& function)
+            : m_Callable{ const_cast<void*>(static_cast<const void*>(std::addressof(function))) }
+            , m_Invoke{ [](void* callable, Args... args) -> Result { return std::invoke(*static_cast<std::remove_reference_t<Function>*>(callable), std::forward<Args>(args)...); } }
+        {}
+
+    public:
+        Result operator()(Args... args) const { return m_Invoke(m_Callable, std::forward<Args>(args)...); }
+
+    private:
+        void* m_Callable = nullptr;
+        Result (*m_Invoke)(void*, Args...) = nullptr;
+    };
+
 
     template <typename From, size_t Size, typename Transformator, size_t... Is>
     auto TransformArray(const std::array<From, Size>& from, Transformator&& transformator, std::index_sequence<Is...>)
@@ -3,10 +3,16 @@
 
 #include "benzin/core/asserter.hpp"
 #include "benzin/core/command_line_args.hpp"
+#include "benzin/core/job_system.hpp"
 #include "benzin/core/logger.hpp"
 
 #if BENZIN_IS_PLATFORM_WIN64
 
+#if BENZIN_IS_HEAP_ALLOCATION_COUNTING_ENABLED
+// Links the counting 'operator new' and 'operator delete' of 'heap_allocation_counter.cpp' into every executable
+#pragma comment(linker, "/include:g_BenzinHeapAllocationCounterAnchor")
+#endif
+
 namespace benzin
 {
 
@@ -30,6 +36,12 @@ namespace benzin
 
         CommandLineArgs::Initialize(argc, argv);
 
+        JobSystem::Initialize(CommandLineArgs::GetJobWorkerCount());
+        BenzinExecuteOnScopeExit([] { JobSystem::Shutdown(); });
+
+        FrameArena::Initialize();
+        BenzinExecuteOnScopeExit([] { FrameArena::Shutdown(); });
+
         return ClientMain();
     }
 
@@ -0,0 +1,198 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/core/frame_arena.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/command_line_args.hpp"
+#include "benzin/core/heap_allocation_counter.hpp"
+#include "benzin/core/logger.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        struct FrameArenaState
+        {
+            std::vector<std::unique_ptr<LinearArena>> Arenas; // Per frame in flight
+            uint32_t ActiveFrameIndex = 0;
+
+            std::thread::id MainThreadId = std::this_thread::get_id();
+
+            uint64_t FrameStartHeapAllocationCount = 0;
+            FrameArenaStats LastFrameStats;
+
+            uint64_t FrameCount = 0;
+            uint64_t SteadyHeapAllocationCount = 0;
+            uint64_t SteadyAllocatingFrameCount = 0;
+        };
+
+        std::unique_ptr<FrameArenaState> g_FrameArenaState;
+
+        // Frames after the first ones are expected to make no heap allocations, e.g. the UI allocates on its first frames
+        constexpr uint64_t g_WarmUpFrameCount = 120;
+
+    } // anonymous namespace
+
+    // LinearArena
+
+    LinearArena::LinearArena(size_t capacityInBytes)
+        : m_Memory{ std::make_unique_for_overwrite<std::byte[]>(capacityInBytes) }
+        , m_CapacityInBytes{ capacityInBytes }
+    {}
+
+    LinearArena::~LinearArena()
+    {
+        // Not 'Reset', which would grow the memory that is about to be released
+        for (const auto& [memory, alignment] : m_OverflowAllocations)
+        {
+            ::operator delete(memory, alignment);
+        }
+    }
+
+    void* LinearArena::Allocate(size_t sizeInBytes, size_t alignment)
+    {
+        BenzinAssert(std::has_single_bit(alignment));
+
+        const auto memoryAddress = (uintptr_t)m_Memory.get();
+
+        size_t offsetInBytes = m_OffsetInBytes.load(std::memory_order_relaxed);
+        size_t alignedOffsetInBytes = 0;
+
+        do
+        {
+            alignedOffsetInBytes = AlignAbove(memoryAddress + offsetInBytes, alignment) - memoryAddress;
+
+            if (alignedOffsetInBytes + sizeInBytes > m_CapacityInBytes)
+            {
+                return AllocateOverflow(sizeInBytes, alignment);
+            }
+        }
+        while (!m_OffsetInBytes.compare_exchange_weak(offsetInBytes, alignedOffsetInBytes + sizeInBytes, std::memory_order_relaxed));
+
+        return m_Memory.get() + alignedOffsetInBytes;
+    }
+
+    void LinearArena::Reset()
+    {
+        const size_t overflowSizeInBytes = m_OverflowSizeInBytes.exchange(0, std::memory_order_relaxed);
+
+        for (const auto& [memory, alignment] : m_OverflowAllocations)
+        {
+            ::operator delete(memory, alignment);
+        }
+        m_OverflowAllocations.clear();
+
+        // Next use of the arena likely needs the same amount of memory
+        if (overflowSizeInBytes != 0)
+        {
+            m_CapacityInBytes = std::bit_ceil(m_CapacityInBytes + overflowSizeInBytes);
+            m_Memory = std::make_unique_for_overwrite<std::byte[]>(m_CapacityInBytes);
+        }
+
+        m_OffsetInBytes.store(0, std::memory_order_relaxed);
+    }
+
+    void* LinearArena::AllocateOverflow(size_t sizeInBytes, size_t alignment)
+    {
+        const auto overflowAlignment = (std::align_val_t)std::max(alignment, alignof(std::max_align_t));
+        void* memory = ::operator new(std::max(sizeInBytes, size_t{ 1 }), overflowAlignment);
+
+        {
+            std::lock_guard lock{ m_OverflowMutex };
+            m_OverflowAllocations.emplace_back(memory, overflowAlignment);
+        }
+
+        // Alignment padding is counted, so the grown arena fits the same allocations
+        m_OverflowSizeInBytes.fetch_add(sizeInBytes + alignment - 1, std::memory_order_relaxed);
+
+        return memory;
+    }
+
+    // FrameArena
+
+    void FrameArena::Initialize(size_t capacityInBytes)
+    {
+        BenzinAssert(!g_FrameArenaState);
+
+        MakeUniquePtr(g_FrameArenaState);
+
+        g_FrameArenaState->Arenas.resize(CommandLineArgs::GetFrameInFlightCount());
+        for (auto& arena : g_FrameArenaState->Arenas)
+        {
+            MakeUniquePtr(arena, capacityInBytes);
+        }
+
+        g_FrameArenaState->FrameStartHeapAllocationCount = GetHeapAllocationCount();
+    }
+
+    void FrameArena::Shutdown()
+    {
+        BenzinAssert(g_FrameArenaState);
+
+        g_FrameArenaState.reset();
+    }
+
+    void FrameArena::BeginFrame(uint32_t activeFrameIndex)
+    {
+        BenzinAssert(g_FrameArenaState);
+        BenzinAssert(activeFrameIndex < g_FrameArenaState->Arenas.size());
+        BenzinAssert(std::this_thread::get_id() == g_FrameArenaState->MainThreadId);
+
+        const LinearArena& lastFrameArena = *g_FrameArenaState->Arenas[g_FrameArenaState->ActiveFrameIndex];
+        const uint64_t heapAllocationCount = GetHeapAllocationCount() - g_FrameArenaState->FrameStartHeapAllocationCount;
+
+        const uint64_t frameIndex = g_FrameArenaState->FrameCount++;
+        if (frameIndex >= g_WarmUpFrameCount && heapAllocationCount != 0)
+        {
+            // Reported once, the stats show the rest
+            if (g_FrameArenaState->SteadyAllocatingFrameCount == 0)
+            {
+                BenzinWarning("FrameArena: Frame {} made {} heap allocations after the warm-up", frameIndex, heapAllocationCount);
+            }
+
+            g_FrameArenaState->SteadyHeapAllocationCount += heapAllocationCount;
+            g_FrameArenaState->SteadyAllocatingFrameCount++;
+        }
+
+        g_FrameArenaState->LastFrameStats = FrameArenaStats
+        {
+            .UsedSizeInBytes = lastFrameArena.GetUsedSizeInBytes(),
+            .CapacityInBytes = lastFrameArena.GetCapacityInBytes(),
+            .OverflowSizeInBytes = lastFrameArena.GetOverflowSizeInBytes(),
+            .HeapAllocationCount = heapAllocationCount,
+            .SteadyFrameCount = frameIndex >= g_WarmUpFrameCount ? frameIndex - g_WarmUpFrameCount + 1 : 0,
+            .SteadyHeapAllocationCount = g_FrameArenaState->SteadyHeapAllocationCount,
+            .SteadyAllocatingFrameCount = g_FrameArenaState->SteadyAllocatingFrameCount,
+        };
+
+        g_FrameArenaState->ActiveFrameIndex = activeFrameIndex;
+        g_FrameArenaState->Arenas[activeFrameIndex]->Reset();
+
+        // Growth of the arena isn't a part of the next frame
+        g_FrameArenaState->FrameStartHeapAllocationCount = GetHeapAllocationCount();
+    }
+
+    void* FrameArena::Allocate(size_t sizeInBytes, size_t alignment)
+    {
+        BenzinAssert(g_FrameArenaState);
+
+        return g_FrameArenaState->Arenas[g_FrameArenaState->ActiveFrameIndex]->Allocate(sizeInBytes, alignment);
+    }
+
+    void* FrameArena::AllocateOnMainThread(size_t sizeInBytes, size_t alignment)
+    {
+        BenzinAssert(g_FrameArenaState);
+        BenzinAssert(std::this_thread::get_id() == g_FrameArenaState->MainThreadId);
+
+        return g_FrameArenaState->Arenas[g_FrameArenaState->ActiveFrameIndex]->Allocate(sizeInBytes, alignment);
+    }
+
+    const FrameArenaStats& FrameArena::GetLastFrameStats()
+    {
+        BenzinAssert(g_FrameArenaState);
+
+        return g_FrameArenaState->LastFrameStats;
+    }
+
+} // namespace benzin
@@ -0,0 +1,118 @@
+#pragma once
+
+namespace benzin
+{
+
+    // Bump allocator, memory is released all at once by 'Reset'. 'Allocate' is lock free, so jobs can allocate in parallel
+    // Allocations that don't fit are taken from the heap until the next 'Reset', which grows the arena to fit all of them
+    class LinearArena
+    {
+    public:
+        BenzinDefineNonCopyable(LinearArena);
+        BenzinDefineNonMoveable(LinearArena);
+
+    public:
+        explicit LinearArena(size_t capacityInBytes);
+        ~LinearArena();
+
+    public:
+        size_t GetCapacityInBytes() const { return m_CapacityInBytes; }
+        size_t GetUsedSizeInBytes() const { return m_OffsetInBytes.load(std::memory_order_relaxed); }
+        size_t GetOverflowSizeInBytes() const { return m_OverflowSizeInBytes.load(std::memory_order_relaxed); }
+
+        void* Allocate(size_t sizeInBytes, size_t alignment);
+
+        // Must not run in parallel with 'Allocate'
+        void Reset();
+
+    private:
+        void* AllocateOverflow(size_t sizeInBytes, size_t alignment);
+
+    private:
+        std::unique_ptr<std::byte[]> m_Memory;
+        size_t m_CapacityInBytes = 0;
+
+        std::atomic<size_t> m_OffsetInBytes = 0;
+
+        std::mutex m_OverflowMutex;
+        std::vector<std::pair<void*, std::align_val_t>> m_OverflowAllocations;
+        std::atomic<size_t> m_OverflowSizeInBytes = 0;
+    };
+
+    struct FrameArenaStats
+    {
+        size_t UsedSizeInBytes = 0;
+        size_t CapacityInBytes = 0;
+        size_t OverflowSizeInBytes = 0;
+
+        uint64_t HeapAllocationCount = 0; // Global 'operator new' calls of all threads between two 'BeginFrame'
+
+        // Frames after the warm-up, which are expected to make no heap allocations
+        uint64_t SteadyFrameCount = 0;
+        uint64_t SteadyHeapAllocationCount = 0;
+        uint64_t SteadyAllocatingFrameCount = 0;
+    };
+
+    // Transient memory of a frame. There is an arena per frame in flight, it's reset when the frame fence guarantees
+    // that the frame which used it last is finished, so frame data can be referenced until the end of the frame
+    class FrameArena
+    {
+    public:
+        BenzinDefineNonConstructable(FrameArena);
+
+        static void Initialize(size_t capacityInBytes = MbToBytes(1));
+        static void Shutdown();
+
+        // Called by 'SwapChain::OnFlip' after the frame fence wait. Jobs must not allocate during the call
+        static void BeginFrame(uint32_t activeFrameIndex);
+
+        static void* Allocate(size_t sizeInBytes, size_t alignment);
+
+        // Same as 'Allocate', but asserts that it's called by the thread that initialized the arena and begins frames.
+        // Used by UI code, which can't be sure that it doesn't run around 'BeginFrame'
+        static void* AllocateOnMainThread(size_t sizeInBytes, size_t alignment);
+
+        static const FrameArenaStats& GetLastFrameStats();
+    };
+
+    // Stateless allocator of the active frame arena. Deallocation is a no op
+    template <typename T>
+    class FrameAllocator
+    {
+    public:
+        using value_type = T;
+
+    public:
+        FrameAllocator() = default;
+
+        template <typename U>
+        FrameAllocator(const FrameAllocator<U>&) {}
+
+    public:
+        T* allocate(size_t count) { return static_cast<T*>(FrameArena::Allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T*, size_t) {}
+
+        template <typename U>
+        bool operator==(const FrameAllocator<U>&) const { return true; }
+    };
+
+    template <typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+    using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+
+    // Null terminated string that lives until the end of the frame. Main thread only, see 'BenzinFormatCstr' for other threads
+    template <typename... Args>
+    const char* FormatToFrameArena(std::format_string<Args...> fmt, Args&&... args)
+    {
+        const size_t size = std::formatted_size(fmt, std::forward<Args>(args)...);
+
+        auto* string = static_cast<char*>(FrameArena::AllocateOnMainThread(size + 1, alignof(char)));
+        *std::format_to(string, fmt, std::forward<Args>(args)...) = '\0';
+
+        return string;
+    }
+
+} // namespace benzin
+
+#define BenzinFrameFormatCstr(formatString, ...) ::benzin::FormatToFrameArena(formatString, __VA_ARGS__)
@@ -0,0 +1,128 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/core/heap_allocation_counter.hpp"
+
+#if BENZIN_IS_HEAP_ALLOCATION_COUNTING_ENABLED
+
+// Replaces the global allocation functions of the executable. The linker takes an object from a static library only to resolve
+// a symbol, so 'entry_point.cpp' forces this one in with '/include' of the anchor below, before the CRT versions are considered
+
+extern "C" const int g_BenzinHeapAllocationCounterAnchor = 0;
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        std::atomic<uint64_t> g_HeapAllocationCount = 0;
+
+        void* AllocateHeap(size_t sizeInBytes)
+        {
+            g_HeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+            return std::malloc(std::max(sizeInBytes, size_t{ 1 }));
+        }
+
+        void* AllocateAlignedHeap(size_t sizeInBytes, std::align_val_t alignment)
+        {
+            g_HeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+            return ::_aligned_malloc(std::max(sizeInBytes, size_t{ 1 }), (size_t)alignment);
+        }
+
+        template <typename AllocateFunction>
+        void* AllocateOrThrow(AllocateFunction&& allocateFunction)
+        {
+            while (true)
+            {
+                if (void* memory = allocateFunction())
+                {
+                    return memory;
+                }
+
+                const std::new_handler newHandler = std::get_new_handler();
+                if (!newHandler)
+                {
+                    throw std::bad_alloc{};
+                }
+
+                newHandler();
+            }
+        }
+
+    } // anonymous namespace
+
+    //
+
+    uint64_t GetHeapAllocationCount()
+    {
+        return g_HeapAllocationCount.load(std::memory_order_relaxed);
+    }
+
+} // namespace benzin
+
+void* operator new(size_t sizeInBytes)
+{
+    return benzin::AllocateOrThrow([&] { return benzin::AllocateHeap(sizeInBytes); });
+}
+
+void* operator new[](size_t sizeInBytes)
+{
+    return ::operator new(sizeInBytes);
+}
+
+void* operator new(size_t sizeInBytes, const std::nothrow_t&) noexcept
+{
+    return benzin::AllocateHeap(sizeInBytes);
+}
+
+void* operator new[](size_t sizeInBytes, const std::nothrow_t&) noexcept
+{
+    return benzin::AllocateHeap(sizeInBytes);
+}
+
+void* operator new(size_t sizeInBytes, std::align_val_t alignment)
+{
+    return benzin::AllocateOrThrow([&] { return benzin::AllocateAlignedHeap(sizeInBytes, alignment); });
+}
+
+void* operator new[](size_t sizeInBytes, std::align_val_t alignment)
+{
+    return ::operator new(sizeInBytes, alignment);
+}
+
+void* operator new(size_t sizeInBytes, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return benzin::AllocateAlignedHeap(sizeInBytes, alignment);
+}
+
+void* operator new[](size_t sizeInBytes, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return benzin::AllocateAlignedHeap(sizeInBytes, alignment);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { ::_aligned_free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { ::_aligned_free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { ::_aligned_free(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { ::_aligned_free(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { ::_aligned_free(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { ::_aligned_free(memory); }
+
+#else
+
+namespace benzin
+{
+
+    uint64_t GetHeapAllocationCount()
+    {
+        return 0;
+    }
+
+} // namespace benzin
+
+#endif // BENZIN_IS_HEAP_ALLOCATION_COUNTING_ENABLED
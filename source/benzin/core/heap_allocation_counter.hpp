@@ -0,0 +1,10 @@
+#pragma once
+
+namespace benzin
+{
+
+    // Number of global 'operator new' calls of all threads since the start of the program
+    // Always 0 if 'BENZIN_IS_HEAP_ALLOCATION_COUNTING_ENABLED' is off
+    uint64_t GetHeapAllocationCount();
+
+} // namespace benzin
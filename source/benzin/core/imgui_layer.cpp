@@ -117,8 +117,8 @@ namespace benzin
             if (ImGui::TreeNode("NvAPI CpuVisibleVram"))
             {
                 const auto [totalSize, freeSize] = NvApiWrapper::GetCpuVisibleVramInBytes(m_Device.GetD3D12Device());
-                ImGui::Text(BenzinFormatCstr("- TotalSize: {} b, {:.2f} mb, {:.2f} gb", totalSize, BytesToFloatMb(totalSize), BytesToFloatGb(totalSize)));
-                ImGui::Text(BenzinFormatCstr("- FreeSize: {} b, {:.2f} mb, {:.2f} gb", freeSize, BytesToFloatMb(freeSize), BytesToFloatGb(freeSize)));
+                ImGui::Text(BenzinFrameFormatCstr("- TotalSize: {} b, {:.2f} mb, {:.2f} gb", totalSize, BytesToFloatMb(totalSize), BytesToFloatGb(totalSize)));
+                ImGui::Text(BenzinFrameFormatCstr("- FreeSize: {} b, {:.2f} mb, {:.2f} gb", freeSize, BytesToFloatMb(freeSize), BytesToFloatGb(freeSize)));
 
                 ImGui::TreePop();
             }
@@ -143,17 +143,17 @@ namespace benzin
                 {
                     const auto nodeFlags = ImGuiTreeNodeFlags_DefaultOpen;
 
-                    ImGui::Text(BenzinFormatCstr("- Total DedicatedVram: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterInfo.TotalDedicatedVramInBytes), BytesToFloatGb(adapterInfo.TotalDedicatedVramInBytes)));
-                    ImGui::Text(BenzinFormatCstr("- Total DedicatedRam: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterInfo.TotalDedicatedRamInBytes), BytesToFloatGb(adapterInfo.TotalDedicatedRamInBytes)));
-                    ImGui::Text(BenzinFormatCstr("- Total SharedRam: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterInfo.TotalSharedRamInBytes), BytesToFloatGb(adapterInfo.TotalSharedRamInBytes)));
+                    ImGui::Text(BenzinFrameFormatCstr("- Total DedicatedVram: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterInfo.TotalDedicatedVramInBytes), BytesToFloatGb(adapterInfo.TotalDedicatedVramInBytes)));
+                    ImGui::Text(BenzinFrameFormatCstr("- Total DedicatedRam: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterInfo.TotalDedicatedRamInBytes), BytesToFloatGb(adapterInfo.TotalDedicatedRamInBytes)));
+                    ImGui::Text(BenzinFrameFormatCstr("- Total SharedRam: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterInfo.TotalSharedRamInBytes), BytesToFloatGb(adapterInfo.TotalSharedRamInBytes)));
                     ImGui::NewLine();
 
                     if (ImGui::TreeNodeEx("##treenode0", nodeFlags, "Dxgi Dedicated Vram"))
                     {   
-                        ImGui::Text(BenzinFormatCstr("- OsBudget: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.DedicatedVramOsBudgetInBytes), BytesToFloatGb(adapterMemoryInfo.DedicatedVramOsBudgetInBytes)));
-                        ImGui::Text(BenzinFormatCstr("- Used: {:.2f} mb, {:.2f} gb", BytesToFloatMb(usedVram), BytesToFloatGb(usedVram)));
-                        ImGui::Text(BenzinFormatCstr("- Available: {:.2f} mb, {:.2f} gb", BytesToFloatMb(availableVram), BytesToFloatGb(availableVram)));
-                        ImGui::Text(BenzinFormatCstr("- Available (relative to OS-budget): {:.2f} mb, {:.2f} gb", BytesToFloatMb(availableVramRelativeToOsBudget), BytesToFloatGb(availableVramRelativeToOsBudget)));
+                        ImGui::Text(BenzinFrameFormatCstr("- OsBudget: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.DedicatedVramOsBudgetInBytes), BytesToFloatGb(adapterMemoryInfo.DedicatedVramOsBudgetInBytes)));
+                        ImGui::Text(BenzinFrameFormatCstr("- Used: {:.2f} mb, {:.2f} gb", BytesToFloatMb(usedVram), BytesToFloatGb(usedVram)));
+                        ImGui::Text(BenzinFrameFormatCstr("- Available: {:.2f} mb, {:.2f} gb", BytesToFloatMb(availableVram), BytesToFloatGb(availableVram)));
+                        ImGui::Text(BenzinFrameFormatCstr("- Available (relative to OS-budget): {:.2f} mb, {:.2f} gb", BytesToFloatMb(availableVramRelativeToOsBudget), BytesToFloatGb(availableVramRelativeToOsBudget)));
                         ImGui::NewLine();
                         
                         ImGui::TreePop();
@@ -161,8 +161,8 @@ namespace benzin
 
                     if (ImGui::TreeNodeEx("##treenode1", nodeFlags, "Dxgi Shared Ram"))
                     {
-                        ImGui::Text(BenzinFormatCstr("- OsBudget: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.SharedRamOsBudgetInBytes), BytesToFloatGb(adapterMemoryInfo.SharedRamOsBudgetInBytes)));
-                        ImGui::Text(BenzinFormatCstr("- Used: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.ProcessUsedSharedRamInBytes), BytesToFloatGb(adapterMemoryInfo.ProcessUsedSharedRamInBytes)));
+                        ImGui::Text(BenzinFrameFormatCstr("- OsBudget: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.SharedRamOsBudgetInBytes), BytesToFloatGb(adapterMemoryInfo.SharedRamOsBudgetInBytes)));
+                        ImGui::Text(BenzinFrameFormatCstr("- Used: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.ProcessUsedSharedRamInBytes), BytesToFloatGb(adapterMemoryInfo.ProcessUsedSharedRamInBytes)));
                         ImGui::NewLine();
 
                         ImGui::TreePop();
@@ -177,9 +177,9 @@ namespace benzin
 
                     if (ImGui::TreeNodeEx("##treenode2", nodeFlags, "%s Dedicated Vram", vendorLibName))
                     {
-                        ImGui::Text(BenzinFormatCstr("- TotalUsed: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.TotalUsedDedicatedVramInBytes), BytesToFloatGb(adapterMemoryInfo.TotalUsedDedicatedVramInBytes)));
-                        ImGui::Text(BenzinFormatCstr("- TotalAvailable: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.AvailableDedicatedVramInBytes), BytesToFloatGb(adapterMemoryInfo.AvailableDedicatedVramInBytes)));
-                        ImGui::Text(BenzinFormatCstr("- TotalAvailable (relative to OS-budget): {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.AvailableDedicatedVramRelativeToOsBudgetInBytes), BytesToFloatGb(adapterMemoryInfo.AvailableDedicatedVramRelativeToOsBudgetInBytes)));
+                        ImGui::Text(BenzinFrameFormatCstr("- TotalUsed: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.TotalUsedDedicatedVramInBytes), BytesToFloatGb(adapterMemoryInfo.TotalUsedDedicatedVramInBytes)));
+                        ImGui::Text(BenzinFrameFormatCstr("- TotalAvailable: {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.AvailableDedicatedVramInBytes), BytesToFloatGb(adapterMemoryInfo.AvailableDedicatedVramInBytes)));
+                        ImGui::Text(BenzinFrameFormatCstr("- TotalAvailable (relative to OS-budget): {:.2f} mb, {:.2f} gb", BytesToFloatMb(adapterMemoryInfo.AvailableDedicatedVramRelativeToOsBudgetInBytes), BytesToFloatGb(adapterMemoryInfo.AvailableDedicatedVramRelativeToOsBudgetInBytes)));
                         ImGui::NewLine();
 
                         ImGui::TreePop();
@@ -193,7 +193,7 @@ namespace benzin
 
         // BottomPanel
         {
-            static constexpr uint32_t rowCount = 2;
+            static constexpr uint32_t rowCount = 3;
 
             ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0.0f);
             ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.0f);
@@ -217,7 +217,7 @@ namespace benzin
             {
                 const auto adapterMemoryInfo = m_Backend.GetMainAdapterMemoryInfo();
 
-                ImGui::Text(BenzinFormatCstr(
+                ImGui::Text(BenzinFrameFormatCstr(
                     "{} | "
                     "VRAM Local: {:.0f} / {:.0f} mb | "
                     "VRAM NonLocal: {:.0f} / {:.0f} mb | "
@@ -228,7 +228,7 @@ namespace benzin
                     m_Device.GetCpuFrameIndex(), m_Device.GetGpuFrameIndex(), m_Device.GetActiveFrameIndex()
                 ));
 
-                ImGui::Text(BenzinFormatCstr(
+                ImGui::Text(BenzinFrameFormatCstr(
                     "({} x {}) | "
                     "FPS: {:.1f} ({:.3f} ms) | "
                     "Begin: {:.3f}, Process: {:.3f}, End: {:.3f}",
@@ -236,6 +236,15 @@ namespace benzin
                     m_FrameRate, m_FrameDeltaTimeMS,
                     ToFloatMs(m_ApplicationTimings[ApplicationTiming::BeginFrame]), ToFloatMs(m_ApplicationTimings[ApplicationTiming::ProcessFrame]), ToFloatMs(m_ApplicationTimings[ApplicationTiming::EndFrame])
                 ));
+
+                const auto& frameArenaStats = FrameArena::GetLastFrameStats();
+
+                ImGui::Text(BenzinFrameFormatCstr(
+                    "HeapAllocations: {}, Steady: {} in {} of {} frames | "
+                    "FrameArena: {:.3f} / {:.3f} mb, Overflow: {:.3f} mb",
+                    frameArenaStats.HeapAllocationCount, frameArenaStats.SteadyHeapAllocationCount, frameArenaStats.SteadyAllocatingFrameCount, frameArenaStats.SteadyFrameCount,
+                    BytesToFloatMb(frameArenaStats.UsedSizeInBytes), BytesToFloatMb(frameArenaStats.CapacityInBytes), BytesToFloatMb(frameArenaStats.OverflowSizeInBytes)
+                ));
             }
             ImGui::End();
         }
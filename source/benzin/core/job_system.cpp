@@ -0,0 +1,422 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/core/job_system.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/logger.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // Owner takes jobs from the back, thieves from the front. Jobs are kept in a ring buffer, which grows to the peak job count
+        // and never shrinks, so queueing doesn't allocate once the queue has grown
+        struct alignas(64) JobQueue
+        {
+            std::mutex Mutex;
+
+            std::vector<Job> Jobs;
+            size_t FrontIndex = 0;
+            size_t JobCount = 0;
+
+            void PushBack(Job&& job)
+            {
+                if (JobCount == Jobs.size())
+                {
+                    std::vector<Job> jobs(std::max(Jobs.size() * 2, size_t{ 64 }));
+                    for (size_t i = 0; i < JobCount; ++i)
+                    {
+                        jobs[i] = std::move(Jobs[(FrontIndex + i) % Jobs.size()]);
+                    }
+
+                    Jobs = std::move(jobs);
+                    FrontIndex = 0;
+                }
+
+                Jobs[(FrontIndex + JobCount) % Jobs.size()] = std::move(job);
+                ++JobCount;
+            }
+
+            Job PopBack()
+            {
+                --JobCount;
+                return std::move(Jobs[(FrontIndex + JobCount) % Jobs.size()]);
+            }
+
+            Job PopFront()
+            {
+                Job job = std::move(Jobs[FrontIndex]);
+
+                FrontIndex = (FrontIndex + 1) % Jobs.size();
+                --JobCount;
+
+                return job;
+            }
+        };
+
+        struct JobSystemState
+        {
+            std::vector<std::unique_ptr<JobQueue>> WorkerQueues;
+            JobQueue SharedQueue; // Jobs submitted by threads outside the pool
+
+            std::atomic<uint32_t> QueuedJobCount = 0; // Changed under the lock of the queue
+
+            // Idle threads sleep until a job is queued, a counter is done or workers are stopped
+            std::mutex SleepMutex;
+            std::condition_variable SleepCondition;
+
+            std::vector<std::jthread> Workers;
+        };
+
+        std::unique_ptr<JobSystemState> g_JobSystemState;
+        thread_local uint32_t g_WorkerIndex = g_InvalidIndex<uint32_t>;
+
+        void WakeSleepingThreads(bool isAllThreads)
+        {
+            {
+                // Orders the wake up after a sleeping thread has checked its condition
+                std::lock_guard lock{ g_JobSystemState->SleepMutex };
+            }
+
+            if (isAllThreads)
+            {
+                g_JobSystemState->SleepCondition.notify_all();
+            }
+            else
+            {
+                g_JobSystemState->SleepCondition.notify_one();
+            }
+        }
+
+        JobQueue& GetSubmissionQueue()
+        {
+            return IsValidIndex(g_WorkerIndex) ? *g_JobSystemState->WorkerQueues[g_WorkerIndex] : g_JobSystemState->SharedQueue;
+        }
+
+        void QueueJobs(std::span<Job> jobs)
+        {
+            if (jobs.empty())
+            {
+                return;
+            }
+
+            JobQueue& queue = GetSubmissionQueue();
+
+            {
+                std::lock_guard lock{ queue.Mutex };
+
+                for (Job& job : jobs)
+                {
+                    queue.PushBack(std::move(job));
+                }
+
+                g_JobSystemState->QueuedJobCount.fetch_add((uint32_t)jobs.size(), std::memory_order_release);
+            }
+
+            WakeSleepingThreads(jobs.size() != 1);
+        }
+
+        // Copies are queued with a single lock. Copying a job with a small capture doesn't allocate
+        void QueueJobCopies(const Job& job, uint32_t copyCount)
+        {
+            if (copyCount == 0)
+            {
+                return;
+            }
+
+            JobQueue& queue = GetSubmissionQueue();
+
+            {
+                std::lock_guard lock{ queue.Mutex };
+
+                for (uint32_t i = 0; i < copyCount; ++i)
+                {
+                    queue.PushBack(Job{ job });
+                }
+
+                g_JobSystemState->QueuedJobCount.fetch_add(copyCount, std::memory_order_release);
+            }
+
+            WakeSleepingThreads(copyCount != 1);
+        }
+
+        std::optional<Job> TryPopJob(JobQueue& queue, bool isOwner)
+        {
+            std::lock_guard lock{ queue.Mutex };
+
+            if (queue.JobCount == 0)
+            {
+                return std::nullopt;
+            }
+
+            Job job = isOwner ? queue.PopBack() : queue.PopFront();
+
+            g_JobSystemState->QueuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+
+            return job;
+        }
+
+        std::optional<Job> TryGetJob()
+        {
+            if (g_JobSystemState->QueuedJobCount.load(std::memory_order_acquire) == 0)
+            {
+                return std::nullopt;
+            }
+
+            if (IsValidIndex(g_WorkerIndex))
+            {
+                if (auto job = TryPopJob(*g_JobSystemState->WorkerQueues[g_WorkerIndex], true))
+                {
+                    return job;
+                }
+            }
+
+            if (auto job = TryPopJob(g_JobSystemState->SharedQueue, false))
+            {
+                return job;
+            }
+
+            // Start from the next worker, so thieves don't crowd around the first queue
+            const auto workerCount = (uint32_t)g_JobSystemState->WorkerQueues.size();
+            const uint32_t firstVictimIndex = IsValidIndex(g_WorkerIndex) ? g_WorkerIndex + 1 : 0;
+
+            for (uint32_t i = 0; i < workerCount; ++i)
+            {
+                const uint32_t victimIndex = (firstVictimIndex + i) % workerCount;
+                if (victimIndex == g_WorkerIndex)
+                {
+                    continue;
+                }
+
+                if (auto job = TryPopJob(*g_JobSystemState->WorkerQueues[victimIndex], false))
+                {
+                    return job;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+    } // anonymous namespace
+
+    //
+
+    void JobSystem::Initialize(uint32_t workerCount)
+    {
+        BenzinAssert(!g_JobSystemState);
+
+        if (workerCount == 0)
+        {
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        MakeUniquePtr(g_JobSystemState);
+
+        g_JobSystemState->WorkerQueues.resize(workerCount);
+        for (auto& workerQueue : g_JobSystemState->WorkerQueues)
+        {
+            MakeUniquePtr(workerQueue);
+        }
+
+        g_JobSystemState->Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            g_JobSystemState->Workers.emplace_back([i](std::stop_token stopToken) { RunWorker(stopToken, i); });
+        }
+
+        BenzinTrace("JobSystem: {} workers", workerCount);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        BenzinAssert(g_JobSystemState);
+
+        for (auto& worker : g_JobSystemState->Workers)
+        {
+            worker.request_stop();
+        }
+
+        WakeSleepingThreads(true);
+
+        g_JobSystemState->Workers.clear();
+        g_JobSystemState.reset();
+    }
+
+    uint32_t JobSystem::GetWorkerCount()
+    {
+        return g_JobSystemState ? (uint32_t)g_JobSystemState->Workers.size() : 0;
+    }
+
+    void JobSystem::Run(std::function<void()> function, JobCounter* counter, JobCounter* dependency)
+    {
+        if (counter)
+        {
+            std::lock_guard lock{ counter->m_Mutex };
+            counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Job job
+        {
+            .Function = std::move(function),
+            .Counter = counter,
+        };
+
+        if (dependency)
+        {
+            std::lock_guard lock{ dependency->m_Mutex };
+
+            if (!dependency->IsDone())
+            {
+                dependency->m_DependentJobs.push_back(std::move(job));
+                return;
+            }
+        }
+
+        if (!g_JobSystemState)
+        {
+            ExecuteJob(job);
+            return;
+        }
+
+        QueueJobs(std::span{ &job, 1 });
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            BenzinAssert(g_JobSystemState);
+
+            if (auto job = TryGetJob())
+            {
+                ExecuteJob(*job);
+                continue;
+            }
+
+            // The rest of the jobs run on other threads
+            std::unique_lock lock{ g_JobSystemState->SleepMutex };
+            g_JobSystemState->SleepCondition.wait(lock, [&]
+            {
+                return counter.IsDone() || g_JobSystemState->QueuedJobCount.load(std::memory_order_acquire) != 0;
+            });
+        }
+
+        // Synchronizes with the unlock in the last 'ExecuteJob', after that the counter isn't touched by other threads
+        std::lock_guard lock{ counter.m_Mutex };
+    }
+
+    void JobSystem::ParallelForRanges(uint32_t count, uint32_t grainSize, FunctionRef<void(IndexRangeU32)> function)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        grainSize = std::max(grainSize, 1u);
+
+        const uint32_t rangeCount = (count - 1) / grainSize + 1;
+        const auto GetRange = [&](uint32_t rangeIndex)
+        {
+            const uint32_t startIndex = rangeIndex * grainSize;
+            return IndexRangeU32{ startIndex, std::min(grainSize, count - startIndex) };
+        };
+
+        if (rangeCount == 1 || !g_JobSystemState)
+        {
+            for (uint32_t rangeIndex = 0; rangeIndex < rangeCount; ++rangeIndex)
+            {
+                function(GetRange(rangeIndex));
+            }
+
+            return;
+        }
+
+        std::atomic<uint32_t> nextRangeIndex = 0;
+        const auto RunRanges = [&]
+        {
+            for (uint32_t rangeIndex = nextRangeIndex.fetch_add(1, std::memory_order_relaxed); rangeIndex < rangeCount; rangeIndex = nextRangeIndex.fetch_add(1, std::memory_order_relaxed))
+            {
+                function(GetRange(rangeIndex));
+            }
+        };
+
+        // Helpers that start after all ranges are taken return right away
+        const uint32_t helperJobCount = std::min(rangeCount - 1, GetWorkerCount());
+
+        JobCounter counter;
+        counter.m_Count.store(helperJobCount, std::memory_order_relaxed);
+
+        QueueJobCopies(Job{ .Function = [&RunRanges] { RunRanges(); }, .Counter = &counter }, helperJobCount);
+
+        RunRanges();
+        Wait(counter);
+    }
+
+    void JobSystem::RunWorker(std::stop_token stopToken, uint32_t workerIndex)
+    {
+        g_WorkerIndex = workerIndex;
+
+        while (true)
+        {
+            if (auto job = TryGetJob())
+            {
+                ExecuteJob(*job);
+                continue;
+            }
+
+            // Queues are drained before exiting
+            if (stopToken.stop_requested())
+            {
+                return;
+            }
+
+            std::unique_lock lock{ g_JobSystemState->SleepMutex };
+            g_JobSystemState->SleepCondition.wait(lock, [&]
+            {
+                return stopToken.stop_requested() || g_JobSystemState->QueuedJobCount.load(std::memory_order_acquire) != 0;
+            });
+        }
+    }
+
+    void JobSystem::ExecuteJob(Job& job)
+    {
+        job.Function();
+
+        if (!job.Counter)
+        {
+            return;
+        }
+
+        JobCounter& counter = *job.Counter;
+        std::vector<Job> dependentJobs;
+
+        {
+            // The last decrement is under the lock, so 'Wait' can't return while the counter is still used here
+            std::lock_guard lock{ counter.m_Mutex };
+
+            if (counter.m_Count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+
+            dependentJobs = std::exchange(counter.m_DependentJobs, {});
+        }
+
+        if (!g_JobSystemState)
+        {
+            for (Job& dependentJob : dependentJobs)
+            {
+                ExecuteJob(dependentJob);
+            }
+
+            return;
+        }
+
+        QueueJobs(dependentJobs);
+
+        // Waiters of the counter may sleep
+        WakeSleepingThreads(true);
+    }
+
+} // namespace benzin
@@ -0,0 +1,92 @@
+#pragma once
+
+namespace benzin
+{
+
+    class JobCounter;
+
+    struct Job
+    {
+        std::function<void()> Function;
+        JobCounter* Counter = nullptr; // Decremented when 'Function' returns
+    };
+
+    // Number of unfinished jobs. Jobs that depend on a counter are queued when it drops to zero
+    // A counter can be reused after it's waited for
+    class JobCounter
+    {
+    public:
+        friend class JobSystem;
+
+        BenzinDefineNonCopyable(JobCounter);
+        BenzinDefineNonMoveable(JobCounter);
+
+    public:
+        JobCounter() = default;
+
+    public:
+        bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+
+    private:
+        std::atomic<uint32_t> m_Count = 0;
+
+        std::mutex m_Mutex; // Guards 'm_DependentJobs' and the last decrement
+        std::vector<Job> m_DependentJobs;
+    };
+
+    // Work stealing thread pool shared by the engine. Every worker has its own queue: it pops the newest job of its queue
+    // and steals the oldest jobs of the others when it's empty. Threads outside the pool submit into a shared queue
+    // Waiting threads run queued jobs instead of blocking, so jobs can wait for nested jobs
+    // Without 'Initialize' jobs run right on the submitting thread
+    class JobSystem
+    {
+    public:
+        BenzinDefineNonConstructable(JobSystem);
+
+        // Zero 'workerCount' means one worker per core except the calling thread
+        static void Initialize(uint32_t workerCount = 0);
+        static void Shutdown(); // Queued jobs are finished before workers exit
+
+        static uint32_t GetWorkerCount();
+
+    public:
+        // 'counter' is incremented right away. The job is queued when 'dependency' is done
+        static void Run(std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        // Runs queued jobs on the calling thread until the counter is done
+        static void Wait(JobCounter& counter);
+
+        // Splits '[0, count)' into ranges of 'grainSize' indices and calls 'function' for each of them on all cores.
+        // The calling thread takes part and returns when all ranges are done. Ranges are taken from a shared index
+        // by the calling thread and at most one helper job per worker, so nothing is allocated per range
+        static void ParallelForRanges(uint32_t count, uint32_t grainSize, FunctionRef<void(IndexRangeU32)> function);
+
+    private:
+        static void RunWorker(std::stop_token stopToken, uint32_t workerIndex);
+        static void ExecuteJob(Job& job);
+    };
+
+    // Calls 'function(index)' for every index in '[0, count)'
+    template <typename Function>
+    void ParallelFor(uint32_t count, uint32_t grainSize, Function&& function)
+    {
+        JobSystem::ParallelForRanges(count, grainSize, [&](IndexRangeU32 range)
+        {
+            for (const uint32_t index : IndexRangeToView(range))
+            {
+                function(index);
+            }
+        });
+    }
+
+    // Calls 'function(element)' for every element of a random access range. Elements are passed by reference
+    template <std::ranges::random_access_range Range, typename Function>
+    void ParallelForEach(Range&& range, Function&& function, uint32_t grainSize = 1)
+    {
+        ParallelFor((uint32_t)std::ranges::size(range), grainSize, [&](uint32_t index)
+        {
+            function(std::ranges::begin(range)[index]);
+        });
+    }
+
+} // namespace benzin
@@ -47,9 +47,11 @@ namespace benzin
 
     // ScopedLogTimer
 
-    ScopedLogTimer::ScopedLogTimer(std::string&& scopeName)
-        : ScopedTimer{ [scopeName](std::chrono::microseconds us) { LogScopeTime(scopeName, us); } }
-    {}
+    ScopedLogTimer::~ScopedLogTimer()
+    {
+        const auto endTimePoint = std::chrono::high_resolution_clock::now();
+        LogScopeTime(std::string_view{ m_ScopeName.data(), m_ScopeNameSize }, ToUs(endTimePoint - m_StartTimePoint));
+    }
 
     // ScopedGrabTimer
 
@@ -21,15 +21,26 @@ namespace benzin
         mutable bool m_IsForceDestoyed = false;
     };
 
-    class ScopedLogTimer : public ScopedTimer
+    // The scope name is formatted into an inline buffer and truncated if it doesn't fit, so the timer doesn't allocate
+    class ScopedLogTimer
     {
     public:
         template <typename... Args>
         ScopedLogTimer(std::format_string<Args...> fmt, Args&&... args)
-            : ScopedLogTimer{ std::format(fmt, std::forward<Args>(args)...) }
-        {}
+        {
+            const auto result = std::format_to_n(m_ScopeName.data(), m_ScopeName.size(), fmt, std::forward<Args>(args)...);
+            m_ScopeNameSize = std::min((size_t)result.size, m_ScopeName.size());
+
+            m_StartTimePoint = std::chrono::high_resolution_clock::now();
+        }
+
+        ~ScopedLogTimer();
+
+    private:
+        std::chrono::high_resolution_clock::time_point m_StartTimePoint;
 
-        explicit ScopedLogTimer(std::string&& scopeName);
+        std::array<char, 256> m_ScopeName;
+        size_t m_ScopeNameSize = 0;
     };
 
     class ScopedGrabTimer : public ScopedTimer
@@ -0,0 +1,156 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/asset_loader.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/logger.hpp"
+
+namespace benzin
+{
+
+    // MeshCollectionLoadingTask
+
+    MeshCollectionLoadingTask::MeshCollectionLoadingTask(std::string_view fileName, MeshCollectionLoadingFlags flags)
+        : m_FileName{ fileName }
+        , m_Flags{ flags }
+        , m_FinishedFuture{ m_FinishedPromise.get_future().share() }
+    {}
+
+    MeshCollectionResource MeshCollectionLoadingTask::TakeMeshCollection()
+    {
+        Wait();
+        BenzinAssert(GetStatus() == AssetLoadingStatus::Succeeded);
+
+        return std::move(m_MeshCollection);
+    }
+
+    // AssetLoader
+
+    AssetLoader::AssetLoader(uint32_t workerCount)
+    {
+        m_Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            m_Workers.emplace_back([this](std::stop_token stopToken) { RunWorker(stopToken); });
+        }
+    }
+
+    AssetLoader::~AssetLoader()
+    {
+        for (auto& worker : m_Workers)
+        {
+            worker.request_stop();
+        }
+
+        m_Workers.clear();
+    }
+
+    AssetLoadingProgress AssetLoader::GetProgress() const
+    {
+        std::lock_guard lock{ m_Mutex };
+        return m_Progress;
+    }
+
+    MeshCollectionLoadingHandle AssetLoader::RequestMeshCollection(std::string_view fileName, MeshCollectionLoadingFlags flags)
+    {
+        auto task = std::make_shared<MeshCollectionLoadingTask>(fileName, flags);
+
+        {
+            std::lock_guard lock{ m_Mutex };
+
+            m_Progress.RequestedCount++;
+            m_PendingCount++;
+
+            if (!m_Workers.empty())
+            {
+                m_QueuedTasks.push_back(task);
+            }
+        }
+
+        if (m_Workers.empty())
+        {
+            LoadTask(task);
+        }
+        else
+        {
+            m_QueuedCondition.notify_one();
+        }
+
+        return task;
+    }
+
+    MeshCollectionLoadingHandle AssetLoader::WaitForNextFinished()
+    {
+        std::unique_lock lock{ m_Mutex };
+
+        if (m_PendingCount == 0)
+        {
+            return nullptr;
+        }
+
+        m_FinishedCondition.wait(lock, [&] { return !m_FinishedTasks.empty(); });
+
+        auto task = std::move(m_FinishedTasks.front());
+        m_FinishedTasks.pop_front();
+        m_PendingCount--;
+
+        return task;
+    }
+
+    void AssetLoader::RunWorker(std::stop_token stopToken)
+    {
+        while (true)
+        {
+            MeshCollectionLoadingHandle task;
+
+            {
+                std::unique_lock lock{ m_Mutex };
+
+                // Returns on a stop request too, the queue is drained before exiting
+                m_QueuedCondition.wait(lock, stopToken, [&] { return !m_QueuedTasks.empty(); });
+
+                if (m_QueuedTasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_QueuedTasks.front());
+                m_QueuedTasks.pop_front();
+            }
+
+            LoadTask(task);
+        }
+    }
+
+    void AssetLoader::LoadTask(const MeshCollectionLoadingHandle& task)
+    {
+        task->m_Status.store(AssetLoadingStatus::Loading, std::memory_order_release);
+
+        bool isSucceed = false;
+        {
+            BenzinLogTimeOnScopeExit("Asset Loader: Loading MeshCollection from {}", task->m_FileName);
+            isSucceed = LoadMeshCollectionFromGltfFile(task->m_FileName, task->m_MeshCollection, task->m_Flags);
+        }
+
+        BenzinWarningIf(!isSucceed, "Asset Loader: Failed to load MeshCollection from {}", task->m_FileName);
+
+        task->m_Status.store(isSucceed ? AssetLoadingStatus::Succeeded : AssetLoadingStatus::Failed, std::memory_order_release);
+        task->m_FinishedPromise.set_value();
+
+        {
+            std::lock_guard lock{ m_Mutex };
+
+            m_Progress.FinishedCount++;
+            if (!isSucceed)
+            {
+                m_Progress.FailedCount++;
+            }
+
+            m_FinishedTasks.push_back(task);
+        }
+
+        m_FinishedCondition.notify_all();
+    }
+
+} // namespace benzin
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    enum class AssetLoadingStatus : uint8_t
+    {
+        Queued,
+        Loading,
+        Succeeded,
+        Failed,
+    };
+
+    // Shared between the loader and the requester. The mesh collection is owned by the task until it's taken
+    class MeshCollectionLoadingTask
+    {
+    public:
+        friend class AssetLoader;
+
+    public:
+        MeshCollectionLoadingTask(std::string_view fileName, MeshCollectionLoadingFlags flags);
+
+    public:
+        std::string_view GetFileName() const { return m_FileName; }
+        AssetLoadingStatus GetStatus() const { return m_Status.load(std::memory_order_acquire); }
+        bool IsFinished() const { return GetStatus() == AssetLoadingStatus::Succeeded || GetStatus() == AssetLoadingStatus::Failed; }
+
+    public:
+        void Wait() const { m_FinishedFuture.wait(); }
+
+        // Waits for the task. Must be called once and only if loading succeeded
+        MeshCollectionResource TakeMeshCollection();
+
+    private:
+        std::string m_FileName;
+        MeshCollectionLoadingFlags m_Flags;
+
+        std::atomic<AssetLoadingStatus> m_Status = AssetLoadingStatus::Queued;
+        std::promise<void> m_FinishedPromise;
+        std::shared_future<void> m_FinishedFuture;
+
+        MeshCollectionResource m_MeshCollection;
+    };
+
+    using MeshCollectionLoadingHandle = std::shared_ptr<MeshCollectionLoadingTask>;
+
+    struct AssetLoadingProgress
+    {
+        uint32_t RequestedCount = 0;
+        uint32_t FinishedCount = 0;
+        uint32_t FailedCount = 0;
+    };
+
+    // Loads assets on worker threads. Each load still uses all cores for its own stages, so a few workers are enough
+    // to overlap file IO and the serial parts of the loads. Without workers requests are loaded right on the requesting thread
+    class AssetLoader
+    {
+    public:
+        BenzinDefineNonCopyable(AssetLoader);
+        BenzinDefineNonMoveable(AssetLoader);
+
+    public:
+        explicit AssetLoader(uint32_t workerCount);
+        ~AssetLoader(); // Queued requests are finished before workers exit
+
+    public:
+        AssetLoadingProgress GetProgress() const;
+
+    public:
+        MeshCollectionLoadingHandle RequestMeshCollection(std::string_view fileName, MeshCollectionLoadingFlags flags = {});
+
+        // Returns requests in the order they finish, so results can be consumed as soon as they are ready.
+        // Blocks until a request is finished. Returns nullptr if all finished requests are already returned
+        MeshCollectionLoadingHandle WaitForNextFinished();
+
+    private:
+        void RunWorker(std::stop_token stopToken);
+        void LoadTask(const MeshCollectionLoadingHandle& task);
+
+    private:
+        mutable std::mutex m_Mutex;
+        std::condition_variable_any m_QueuedCondition;
+        std::condition_variable m_FinishedCondition;
+
+        std::deque<MeshCollectionLoadingHandle> m_QueuedTasks;
+        std::deque<MeshCollectionLoadingHandle> m_FinishedTasks; // Not returned by 'WaitForNextFinished' yet
+        uint32_t m_PendingCount = 0; // Requested, but not returned by 'WaitForNextFinished' yet
+
+        AssetLoadingProgress m_Progress;
+
+        std::vector<std::jthread> m_Workers; // Declared last to be joined before the rest is destroyed
+    };
+
+} // namespace benzin
@@ -0,0 +1,179 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/draw_packet_builder.hpp"
+
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // 'D3D_PRIMITIVE_TOPOLOGY' values are small, so they index counters directly
+        constexpr size_t g_PrimitiveTopologyIndexCount = (size_t)D3D_PRIMITIVE_TOPOLOGY_32_CONTROL_POINT_PATCHLIST + 1;
+
+        size_t GetTopologyIndex(PrimitiveTopology primitiveTopology)
+        {
+            return (size_t)primitiveTopology;
+        }
+
+        const MeshData& GetMesh(std::span<const DrawPacketEntity> entities, const VisibleMeshInstance& visibleMeshInstance)
+        {
+            const MeshCollectionResource& meshCollection = *entities[visibleMeshInstance.EntityIndex].MeshCollection;
+            return meshCollection.Meshes[meshCollection.MeshInstances[visibleMeshInstance.MeshInstanceIndex].MeshIndex];
+        }
+
+        DrawPacket MakeDrawPacket(std::span<const DrawPacketEntity> entities, const VisibleMeshInstance& visibleMeshInstance)
+        {
+            const DrawPacketEntity& entity = entities[visibleMeshInstance.EntityIndex];
+            const MeshData& mesh = GetMesh(entities, visibleMeshInstance);
+
+            DrawPacket drawPacket
+            {
+                .Arguments
+                {
+                    .VertexCountPerInstance = (uint32_t)mesh.GetLodIndices(visibleMeshInstance.LodIndex).size(),
+                    .InstanceCount = 1,
+                },
+            };
+
+            std::ranges::copy(entity.Constants, drawPacket.RootConstants.begin());
+            drawPacket.RootConstants[joint::GeometryPassRc_MeshInstanceIndex - g_DrawPacketRootConstantRange.StartIndex] = visibleMeshInstance.MeshInstanceIndex;
+            drawPacket.RootConstants[joint::GeometryPassRc_MeshLodIndexOffset - g_DrawPacketRootConstantRange.StartIndex] = mesh.GetLodIndexOffset(visibleMeshInstance.LodIndex);
+
+            return drawPacket;
+        }
+
+    } // anonymous namespace
+
+    //
+
+    void BuildDrawPackets(std::span<const DrawPacketEntity> entities, std::span<const VisibleMeshInstance> visibleMeshInstances, DrawPacketList& outDrawPacketList)
+    {
+        std::vector<DrawPacket>& drawPackets = outDrawPacketList.DrawPackets;
+        std::vector<DrawPacketGroup>& groups = outDrawPacketList.Groups;
+
+        drawPackets.resize(visibleMeshInstances.size());
+        groups.clear();
+
+        // Counting sort by topology keeps the order of instances inside a group
+        std::array<uint32_t, g_PrimitiveTopologyIndexCount> drawPacketOffsets{};
+        for (const VisibleMeshInstance& visibleMeshInstance : visibleMeshInstances)
+        {
+            drawPacketOffsets[GetTopologyIndex(GetMesh(entities, visibleMeshInstance).PrimitiveTopology)]++;
+        }
+
+        uint32_t drawPacketOffset = 0;
+        for (const size_t topologyIndex : std::views::iota(0u, g_PrimitiveTopologyIndexCount))
+        {
+            const uint32_t drawPacketCount = std::exchange(drawPacketOffsets[topologyIndex], drawPacketOffset);
+            if (drawPacketCount == 0)
+            {
+                continue;
+            }
+
+            groups.push_back(DrawPacketGroup
+            {
+                .PrimitiveTopology = (PrimitiveTopology)topologyIndex,
+                .DrawPacketRange{ drawPacketOffset, drawPacketCount },
+            });
+
+            drawPacketOffset += drawPacketCount;
+        }
+
+        for (const VisibleMeshInstance& visibleMeshInstance : visibleMeshInstances)
+        {
+            const size_t topologyIndex = GetTopologyIndex(GetMesh(entities, visibleMeshInstance).PrimitiveTopology);
+            drawPackets[drawPacketOffsets[topologyIndex]++] = MakeDrawPacket(entities, visibleMeshInstance);
+        }
+    }
+
+    bool ValidateDrawPackets(std::span<const DrawPacketEntity> entities, std::span<const VisibleMeshInstance> visibleMeshInstances, const DrawPacketList& drawPacketList)
+    {
+        if (drawPacketList.DrawPackets.size() != visibleMeshInstances.size())
+        {
+            BenzinWarning("DrawPacketBuilder: {} draw packets for {} visible mesh instances", drawPacketList.DrawPackets.size(), visibleMeshInstances.size());
+            return false;
+        }
+
+        uint32_t drawPacketOffset = 0;
+        for (const auto& [groupIndex, group] : drawPacketList.Groups | std::views::enumerate)
+        {
+            const char* reason = nullptr;
+
+            if (group.PrimitiveTopology == PrimitiveTopology::Unknown)
+            {
+                reason = "Topology is unknown";
+            }
+            else if (group.DrawPacketRange.Count == 0)
+            {
+                reason = "Group is empty";
+            }
+            else if (group.DrawPacketRange.StartIndex != drawPacketOffset)
+            {
+                reason = "Group doesn't start where the previous one ends";
+            }
+            else if (groupIndex != 0 && GetTopologyIndex(group.PrimitiveTopology) <= GetTopologyIndex(drawPacketList.Groups[groupIndex - 1].PrimitiveTopology))
+            {
+                reason = "Groups aren't sorted by topology";
+            }
+
+            if (reason)
+            {
+                BenzinWarning("DrawPacketBuilder: Group {} is invalid. {}", groupIndex, reason);
+                return false;
+            }
+
+            drawPacketOffset += group.DrawPacketRange.Count;
+        }
+
+        if (drawPacketOffset != drawPacketList.DrawPackets.size())
+        {
+            BenzinWarning("DrawPacketBuilder: Groups cover {} of {} draw packets", drawPacketOffset, drawPacketList.DrawPackets.size());
+            return false;
+        }
+
+        // Packets of a group are the visible instances of its topology in the same order
+        for (const DrawPacketGroup& group : drawPacketList.Groups)
+        {
+            uint32_t drawPacketIndex = group.DrawPacketRange.StartIndex;
+
+            for (const auto& [visibleMeshInstanceIndex, visibleMeshInstance] : visibleMeshInstances | std::views::enumerate)
+            {
+                if (GetMesh(entities, visibleMeshInstance).PrimitiveTopology != group.PrimitiveTopology)
+                {
+                    continue;
+                }
+
+                if (drawPacketIndex == group.DrawPacketRange.StartIndex + group.DrawPacketRange.Count)
+                {
+                    BenzinWarning("DrawPacketBuilder: Group of visible mesh instance {} is too small", visibleMeshInstanceIndex);
+                    return false;
+                }
+
+                const DrawPacket& drawPacket = drawPacketList.DrawPackets[drawPacketIndex];
+                const char* reason = nullptr;
+
+                if (drawPacket.Arguments.InstanceCount != 1 || drawPacket.Arguments.StartVertexLocation != 0 || drawPacket.Arguments.StartInstanceLocation != 0)
+                {
+                    reason = "Draw arguments aren't a single instance draw from the start of the index range";
+                }
+                else if (drawPacket != MakeDrawPacket(entities, visibleMeshInstance))
+                {
+                    reason = "Root constants or vertex count don't match the mesh instance";
+                }
+
+                if (reason)
+                {
+                    BenzinWarning("DrawPacketBuilder: Draw packet {} of visible mesh instance {} is invalid. {}", drawPacketIndex, visibleMeshInstanceIndex, reason);
+                    return false;
+                }
+
+                drawPacketIndex++;
+            }
+        }
+
+        return true;
+    }
+
+} // namespace benzin
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "benzin/graphics/common.hpp"
+
+#include <shaders/joint/root_constants.hpp>
+
+namespace benzin
+{
+
+    struct MeshCollectionResource;
+
+    // Same layout as 'D3D12_DRAW_ARGUMENTS'
+    struct DrawArguments
+    {
+        uint32_t VertexCountPerInstance = 0;
+        uint32_t InstanceCount = 0;
+        uint32_t StartVertexLocation = 0;
+        uint32_t StartInstanceLocation = 0;
+
+        bool operator==(const DrawArguments&) const = default;
+    };
+
+    // Values of 'joint::GeometryPassRc_MeshVertexBuffer' .. 'joint::GeometryPassRc_MeshLodIndexOffset'
+    inline constexpr IndexRangeU32 g_DrawPacketRootConstantRange{ joint::GeometryPassRc_MeshVertexBuffer, joint::GeometryPassRc_Count - joint::GeometryPassRc_MeshVertexBuffer };
+
+    // One command of an indirect argument buffer. Root constants are set before the draw
+    struct DrawPacket
+    {
+        std::array<uint32_t, g_DrawPacketRootConstantRange.Count> RootConstants{};
+        DrawArguments Arguments;
+
+        bool operator==(const DrawPacket&) const = default;
+    };
+    static_assert(sizeof(DrawPacket) == sizeof(uint32_t) * g_DrawPacketRootConstantRange.Count + sizeof(DrawArguments));
+
+    // Root constants shared by all draws of an entity, 'joint::GeometryPassRc_MeshVertexBuffer' .. 'joint::GeometryPassRc_MeshTransformConstantBuffer'
+    using DrawPacketEntityConstants = std::array<uint32_t, joint::GeometryPassRc_MeshInstanceIndex - joint::GeometryPassRc_MeshVertexBuffer>;
+
+    struct DrawPacketEntity
+    {
+        const MeshCollectionResource* MeshCollection = nullptr;
+        DrawPacketEntityConstants Constants{};
+    };
+
+    // Output of culling and LOD selection
+    struct VisibleMeshInstance
+    {
+        uint32_t EntityIndex = 0; // Into 'DrawPacketEntity' span
+        uint32_t MeshInstanceIndex = 0;
+        uint32_t LodIndex = 0;
+    };
+
+    // Draws of one topology. Each group is recorded with a single 'ExecuteIndirect'
+    struct DrawPacketGroup
+    {
+        PrimitiveTopology PrimitiveTopology = PrimitiveTopology::Unknown;
+        IndexRangeU32 DrawPacketRange;
+    };
+
+    struct DrawPacketList
+    {
+        std::vector<DrawPacket> DrawPackets; // Sorted by topology, the order of visible instances is kept inside a group
+        std::vector<DrawPacketGroup> Groups;
+    };
+
+    // Writes a draw packet for every visible mesh instance. Memory of 'outDrawPacketList' is reused between frames
+    // Doesn't touch graphics objects, the caller uploads 'DrawPackets' and records 'Groups'
+    void BuildDrawPackets(std::span<const DrawPacketEntity> entities, std::span<const VisibleMeshInstance> visibleMeshInstances, DrawPacketList& outDrawPacketList);
+
+    // Checks that groups cover all packets without overlaps, every packet belongs to the topology of its group,
+    // and packets contain the same root constants and vertex counts as per instance recording would set. It's O(n * groups), so it's run by tests, not per frame
+    bool ValidateDrawPackets(std::span<const DrawPacketEntity> entities, std::span<const VisibleMeshInstance> visibleMeshInstances, const DrawPacketList& drawPacketList);
+
+} // namespace benzin
@@ -0,0 +1,559 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/dynamic_aabb_tree.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/logger.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // Relative to the largest extent of a proxy box
+        constexpr float g_ProxyMarginFactor = 0.1f;
+
+        // A query stack holds at most one entry per depth plus one
+        constexpr uint32_t g_MaxQueryStackSize = 64;
+
+        // Leaves which may cross a frustum plane are collected and tested by 'CullAabbs'
+        class LeafBatch
+        {
+        public:
+            static constexpr uint32_t s_Capacity = 64; // One visibility mask word
+
+        public:
+            bool IsFull() const { return m_Count == s_Capacity; }
+
+            void Push(AabbTreeProxyId proxyId, const Aabb& aabb)
+            {
+                m_ProxyIds[m_Count] = proxyId;
+                m_MinX[m_Count] = aabb.Min.x;
+                m_MinY[m_Count] = aabb.Min.y;
+                m_MinZ[m_Count] = aabb.Min.z;
+                m_MaxX[m_Count] = aabb.Max.x;
+                m_MaxY[m_Count] = aabb.Max.y;
+                m_MaxZ[m_Count] = aabb.Max.z;
+
+                ++m_Count;
+            }
+
+            // Returns the count of visible leaves
+            uint32_t Flush(const FrustumPlanes& frustumPlanes, FunctionRef<void(AabbTreeProxyId)> function)
+            {
+                const AabbSoaView aabbs
+                {
+                    .MinX = m_MinX.data(),
+                    .MinY = m_MinY.data(),
+                    .MinZ = m_MinZ.data(),
+                    .MaxX = m_MaxX.data(),
+                    .MaxY = m_MaxY.data(),
+                    .MaxZ = m_MaxZ.data(),
+                    .Count = m_Count,
+                };
+
+                uint64_t visibilityMask = 0;
+                CullAabbs(frustumPlanes, aabbs, std::span{ &visibilityMask, 1 });
+
+                for (uint64_t bits = visibilityMask; bits != 0; bits &= bits - 1)
+                {
+                    function(m_ProxyIds[std::countr_zero(bits)]);
+                }
+
+                m_Count = 0;
+
+                return (uint32_t)std::popcount(visibilityMask);
+            }
+
+        private:
+            std::array<AabbTreeProxyId, s_Capacity> m_ProxyIds;
+            std::array<float, s_Capacity> m_MinX;
+            std::array<float, s_Capacity> m_MinY;
+            std::array<float, s_Capacity> m_MinZ;
+            std::array<float, s_Capacity> m_MaxX;
+            std::array<float, s_Capacity> m_MaxY;
+            std::array<float, s_Capacity> m_MaxZ;
+
+            uint32_t m_Count = 0;
+        };
+
+        Aabb Union(const Aabb& lhs, const Aabb& rhs)
+        {
+            return Aabb
+            {
+                .Min{ std::min(lhs.Min.x, rhs.Min.x), std::min(lhs.Min.y, rhs.Min.y), std::min(lhs.Min.z, rhs.Min.z) },
+                .Max{ std::max(lhs.Max.x, rhs.Max.x), std::max(lhs.Max.y, rhs.Max.y), std::max(lhs.Max.z, rhs.Max.z) },
+            };
+        }
+
+        bool Contains(const Aabb& outer, const Aabb& inner)
+        {
+            return
+                outer.Min.x <= inner.Min.x && outer.Min.y <= inner.Min.y && outer.Min.z <= inner.Min.z &&
+                outer.Max.x >= inner.Max.x && outer.Max.y >= inner.Max.y && outer.Max.z >= inner.Max.z;
+        }
+
+        // Half of the surface area, only ratios of areas are used
+        float GetArea(const Aabb& aabb)
+        {
+            const float dx = aabb.Max.x - aabb.Min.x;
+            const float dy = aabb.Max.y - aabb.Min.y;
+            const float dz = aabb.Max.z - aabb.Min.z;
+
+            return dx * dy + dy * dz + dz * dx;
+        }
+
+        Aabb Enlarge(const Aabb& aabb)
+        {
+            const float margin = g_ProxyMarginFactor * 0.5f * std::max({ aabb.Max.x - aabb.Min.x, aabb.Max.y - aabb.Min.y, aabb.Max.z - aabb.Min.z });
+
+            return Aabb
+            {
+                .Min{ aabb.Min.x - margin, aabb.Min.y - margin, aabb.Min.z - margin },
+                .Max{ aabb.Max.x + margin, aabb.Max.y + margin, aabb.Max.z + margin },
+            };
+        }
+
+    } // anonymous namespace
+
+    // DynamicAabbTree
+
+    AabbTreeProxyId DynamicAabbTree::CreateProxy(const DirectX::BoundingBox& boundingBox)
+    {
+        const uint32_t leafIndex = AllocateNode();
+
+        Node& leaf = m_Nodes[leafIndex];
+        leaf.ProxyBox = ToAabb(boundingBox);
+        leaf.Box = Enlarge(leaf.ProxyBox);
+
+        InsertLeaf(leafIndex);
+        ++m_ProxyCount;
+
+        return leafIndex;
+    }
+
+    void DynamicAabbTree::DestroyProxy(AabbTreeProxyId proxyId)
+    {
+        BenzinAssert(proxyId < m_Nodes.size() && m_Nodes[proxyId].IsLeaf() && m_Nodes[proxyId].Height == 0);
+
+        RemoveLeaf(proxyId);
+        FreeNode(proxyId);
+        --m_ProxyCount;
+    }
+
+    bool DynamicAabbTree::MoveProxy(AabbTreeProxyId proxyId, const DirectX::BoundingBox& boundingBox)
+    {
+        BenzinAssert(proxyId < m_Nodes.size() && m_Nodes[proxyId].IsLeaf() && m_Nodes[proxyId].Height == 0);
+
+        Node& leaf = m_Nodes[proxyId];
+        leaf.ProxyBox = ToAabb(boundingBox);
+
+        if (Contains(leaf.Box, leaf.ProxyBox))
+        {
+            return false;
+        }
+
+        RemoveLeaf(proxyId);
+        leaf.Box = Enlarge(leaf.ProxyBox);
+        InsertLeaf(proxyId);
+
+        return true;
+    }
+
+    const Aabb& DynamicAabbTree::GetProxyAabb(AabbTreeProxyId proxyId) const
+    {
+        BenzinAssert(proxyId < m_Nodes.size() && m_Nodes[proxyId].IsLeaf() && m_Nodes[proxyId].Height == 0);
+
+        return m_Nodes[proxyId].ProxyBox;
+    }
+
+    AabbTreeStats DynamicAabbTree::GetStats() const
+    {
+        return AabbTreeStats
+        {
+            .ProxyCount = m_ProxyCount,
+            .NodeCount = m_NodeCount,
+            .Height = IsValidIndex(m_RootIndex) ? (uint32_t)m_Nodes[m_RootIndex].Height : 0,
+        };
+    }
+
+    AabbTreeQueryStats DynamicAabbTree::QueryFrustum(const FrustumPlanes& frustumPlanes, FunctionRef<void(AabbTreeProxyId)> function) const
+    {
+        AabbTreeQueryStats stats;
+
+        if (!IsValidIndex(m_RootIndex))
+        {
+            return stats;
+        }
+
+        struct StackEntry
+        {
+            uint32_t NodeIndex = 0;
+            uint32_t PlaneMask = 0; // Planes the node box may cross
+        };
+
+        BenzinAssert(m_Nodes[m_RootIndex].Height < (int32_t)g_MaxQueryStackSize);
+
+        std::array<StackEntry, g_MaxQueryStackSize> stack;
+        uint32_t stackSize = 0;
+
+        LeafBatch leafBatch;
+
+        stack[stackSize++] = StackEntry{ m_RootIndex, g_AllFrustumPlanesMask };
+
+        while (stackSize != 0)
+        {
+            auto [nodeIndex, planeMask] = stack[--stackSize];
+            const Node& node = m_Nodes[nodeIndex];
+
+            if (node.IsLeaf())
+            {
+                if (planeMask == 0)
+                {
+                    ++stats.VisibleProxyCount;
+                    function(nodeIndex);
+
+                    continue;
+                }
+
+                // All planes are tested, the ones skipped by the mask are known to pass
+                ++stats.TestedNodeCount;
+                leafBatch.Push(nodeIndex, node.ProxyBox);
+
+                if (leafBatch.IsFull())
+                {
+                    stats.VisibleProxyCount += leafBatch.Flush(frustumPlanes, function);
+                }
+
+                continue;
+            }
+
+            if (planeMask != 0)
+            {
+                ++stats.TestedNodeCount;
+
+                if (!ClassifyAabb(frustumPlanes, node.Box, planeMask))
+                {
+                    continue;
+                }
+            }
+
+            stack[stackSize++] = StackEntry{ node.ChildIndices[0], planeMask };
+            stack[stackSize++] = StackEntry{ node.ChildIndices[1], planeMask };
+        }
+
+        stats.VisibleProxyCount += leafBatch.Flush(frustumPlanes, function);
+
+        return stats;
+    }
+
+    bool DynamicAabbTree::Validate() const
+    {
+        if (!IsValidIndex(m_RootIndex))
+        {
+            if (m_ProxyCount != 0 || m_NodeCount != 0)
+            {
+                BenzinWarning("DynamicAabbTree: Tree is empty, but has {} proxies and {} nodes", m_ProxyCount, m_NodeCount);
+                return false;
+            }
+
+            return true;
+        }
+
+        if (IsValidIndex(m_Nodes[m_RootIndex].ParentIndex))
+        {
+            BenzinWarning("DynamicAabbTree: Root {} has a parent", m_RootIndex);
+            return false;
+        }
+
+        uint32_t leafCount = 0;
+        uint32_t nodeCount = 0;
+
+        std::vector<uint32_t> stack{ m_RootIndex };
+        while (!stack.empty())
+        {
+            const uint32_t nodeIndex = stack.back();
+            stack.pop_back();
+
+            const Node& node = m_Nodes[nodeIndex];
+            const char* reason = nullptr;
+
+            ++nodeCount;
+
+            if (node.IsLeaf())
+            {
+                ++leafCount;
+
+                if (node.Height != 0 || IsValidIndex(node.ChildIndices[1]))
+                {
+                    reason = "Leaf has a child or a height";
+                }
+                else if (!Contains(node.Box, node.ProxyBox))
+                {
+                    reason = "Enlarged box doesn't contain the proxy box";
+                }
+            }
+            else
+            {
+                const auto [childIndex0, childIndex1] = node.ChildIndices;
+
+                if (!IsValidIndex(childIndex1) || childIndex0 >= m_Nodes.size() || childIndex1 >= m_Nodes.size())
+                {
+                    reason = "Internal node doesn't have two children";
+                }
+                else if (m_Nodes[childIndex0].ParentIndex != nodeIndex || m_Nodes[childIndex1].ParentIndex != nodeIndex)
+                {
+                    reason = "Child doesn't link back to the node";
+                }
+                else if (node.Height != 1 + std::max(m_Nodes[childIndex0].Height, m_Nodes[childIndex1].Height))
+                {
+                    reason = "Height doesn't match the children";
+                }
+                else if (!Contains(node.Box, m_Nodes[childIndex0].Box) || !Contains(node.Box, m_Nodes[childIndex1].Box))
+                {
+                    reason = "Box doesn't contain the boxes of the children";
+                }
+                else
+                {
+                    stack.push_back(childIndex0);
+                    stack.push_back(childIndex1);
+                }
+            }
+
+            if (reason)
+            {
+                BenzinWarning("DynamicAabbTree: Node {} is invalid. {}", nodeIndex, reason);
+                return false;
+            }
+        }
+
+        if (leafCount != m_ProxyCount || nodeCount != m_NodeCount)
+        {
+            BenzinWarning("DynamicAabbTree: Tree has {} leaves and {} nodes, expected {} and {}", leafCount, nodeCount, m_ProxyCount, m_NodeCount);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint32_t DynamicAabbTree::AllocateNode()
+    {
+        uint32_t nodeIndex = m_FreeNodeIndex;
+
+        if (IsValidIndex(nodeIndex))
+        {
+            m_FreeNodeIndex = m_Nodes[nodeIndex].ParentIndex;
+            m_Nodes[nodeIndex] = Node{};
+        }
+        else
+        {
+            nodeIndex = (uint32_t)m_Nodes.size();
+            m_Nodes.emplace_back();
+        }
+
+        ++m_NodeCount;
+
+        return nodeIndex;
+    }
+
+    void DynamicAabbTree::FreeNode(uint32_t nodeIndex)
+    {
+        Node& node = m_Nodes[nodeIndex];
+        node.ParentIndex = m_FreeNodeIndex;
+        node.ChildIndices = { g_InvalidIndex<uint32_t>, g_InvalidIndex<uint32_t> };
+        node.Height = -1;
+
+        m_FreeNodeIndex = nodeIndex;
+        --m_NodeCount;
+    }
+
+    void DynamicAabbTree::InsertLeaf(uint32_t leafIndex)
+    {
+        if (!IsValidIndex(m_RootIndex))
+        {
+            m_RootIndex = leafIndex;
+            m_Nodes[leafIndex].ParentIndex = g_InvalidIndex<uint32_t>;
+
+            return;
+        }
+
+        const Aabb leafBox = m_Nodes[leafIndex].Box;
+
+        // Descends while attaching to a child is cheaper than creating a new parent for the node
+        uint32_t siblingIndex = m_RootIndex;
+        while (!m_Nodes[siblingIndex].IsLeaf())
+        {
+            const Node& node = m_Nodes[siblingIndex];
+
+            const float area = GetArea(node.Box);
+            const float combinedArea = GetArea(Union(node.Box, leafBox));
+
+            const float cost = 2.0f * combinedArea;
+            const float inheritanceCost = 2.0f * (combinedArea - area); // Growth of all ancestors if descended
+
+            const auto GetDescentCost = [&](uint32_t childIndex)
+            {
+                const Node& child = m_Nodes[childIndex];
+                const float childCombinedArea = GetArea(Union(child.Box, leafBox));
+
+                return (child.IsLeaf() ? childCombinedArea : childCombinedArea - GetArea(child.Box)) + inheritanceCost;
+            };
+
+            const std::array<float, 2> childCosts{ GetDescentCost(node.ChildIndices[0]), GetDescentCost(node.ChildIndices[1]) };
+
+            if (cost < childCosts[0] && cost < childCosts[1])
+            {
+                break;
+            }
+
+            siblingIndex = node.ChildIndices[childCosts[0] < childCosts[1] ? 0 : 1];
+        }
+
+        const uint32_t oldParentIndex = m_Nodes[siblingIndex].ParentIndex;
+        const uint32_t newParentIndex = AllocateNode();
+
+        Node& newParent = m_Nodes[newParentIndex];
+        newParent.ParentIndex = oldParentIndex;
+        newParent.ChildIndices = { siblingIndex, leafIndex };
+        newParent.Box = Union(leafBox, m_Nodes[siblingIndex].Box);
+        newParent.Height = m_Nodes[siblingIndex].Height + 1;
+
+        if (IsValidIndex(oldParentIndex))
+        {
+            ReplaceChild(oldParentIndex, siblingIndex, newParentIndex);
+        }
+        else
+        {
+            m_RootIndex = newParentIndex;
+        }
+
+        m_Nodes[siblingIndex].ParentIndex = newParentIndex;
+        m_Nodes[leafIndex].ParentIndex = newParentIndex;
+
+        RefitAncestors(oldParentIndex);
+    }
+
+    void DynamicAabbTree::RemoveLeaf(uint32_t leafIndex)
+    {
+        if (leafIndex == m_RootIndex)
+        {
+            m_RootIndex = g_InvalidIndex<uint32_t>;
+            return;
+        }
+
+        const uint32_t parentIndex = m_Nodes[leafIndex].ParentIndex;
+        const uint32_t grandParentIndex = m_Nodes[parentIndex].ParentIndex;
+
+        const auto& parentChildIndices = m_Nodes[parentIndex].ChildIndices;
+        const uint32_t siblingIndex = parentChildIndices[0] == leafIndex ? parentChildIndices[1] : parentChildIndices[0];
+
+        m_Nodes[siblingIndex].ParentIndex = grandParentIndex;
+
+        if (IsValidIndex(grandParentIndex))
+        {
+            ReplaceChild(grandParentIndex, parentIndex, siblingIndex);
+        }
+        else
+        {
+            m_RootIndex = siblingIndex;
+        }
+
+        FreeNode(parentIndex);
+        m_Nodes[leafIndex].ParentIndex = g_InvalidIndex<uint32_t>;
+
+        RefitAncestors(grandParentIndex);
+    }
+
+    void DynamicAabbTree::RefitAncestors(uint32_t nodeIndex)
+    {
+        while (IsValidIndex(nodeIndex))
+        {
+            nodeIndex = Balance(nodeIndex);
+
+            Node& node = m_Nodes[nodeIndex];
+            const Node& child0 = m_Nodes[node.ChildIndices[0]];
+            const Node& child1 = m_Nodes[node.ChildIndices[1]];
+
+            node.Height = 1 + std::max(child0.Height, child1.Height);
+            node.Box = Union(child0.Box, child1.Box);
+
+            nodeIndex = node.ParentIndex;
+        }
+    }
+
+    // Returns the node which takes the place of the node
+    uint32_t DynamicAabbTree::Balance(uint32_t nodeIndex)
+    {
+        const Node& node = m_Nodes[nodeIndex];
+        if (node.IsLeaf() || node.Height < 2)
+        {
+            return nodeIndex;
+        }
+
+        const int32_t balance = m_Nodes[node.ChildIndices[1]].Height - m_Nodes[node.ChildIndices[0]].Height;
+
+        if (balance > 1)
+        {
+            return RotateUp(nodeIndex, 1);
+        }
+
+        if (balance < -1)
+        {
+            return RotateUp(nodeIndex, 0);
+        }
+
+        return nodeIndex;
+    }
+
+    // The child in 'childSlot' becomes the parent of the node, the node takes the lower child of it
+    uint32_t DynamicAabbTree::RotateUp(uint32_t nodeIndex, uint32_t childSlot)
+    {
+        Node& node = m_Nodes[nodeIndex];
+
+        const uint32_t promotedIndex = node.ChildIndices[childSlot];
+        const uint32_t siblingIndex = node.ChildIndices[1 - childSlot];
+        Node& promoted = m_Nodes[promotedIndex];
+
+        const auto [grandChildIndex0, grandChildIndex1] = promoted.ChildIndices;
+        const bool isFirstHigher = m_Nodes[grandChildIndex0].Height > m_Nodes[grandChildIndex1].Height;
+        const uint32_t higherIndex = isFirstHigher ? grandChildIndex0 : grandChildIndex1;
+        const uint32_t lowerIndex = isFirstHigher ? grandChildIndex1 : grandChildIndex0;
+
+        promoted.ParentIndex = node.ParentIndex;
+        if (IsValidIndex(promoted.ParentIndex))
+        {
+            ReplaceChild(promoted.ParentIndex, nodeIndex, promotedIndex);
+        }
+        else
+        {
+            m_RootIndex = promotedIndex;
+        }
+
+        promoted.ChildIndices = { nodeIndex, higherIndex };
+        node.ParentIndex = promotedIndex;
+
+        node.ChildIndices[childSlot] = lowerIndex;
+        m_Nodes[lowerIndex].ParentIndex = nodeIndex;
+
+        const Node& sibling = m_Nodes[siblingIndex];
+        const Node& lower = m_Nodes[lowerIndex];
+        const Node& higher = m_Nodes[higherIndex];
+
+        node.Box = Union(sibling.Box, lower.Box);
+        node.Height = 1 + std::max(sibling.Height, lower.Height);
+
+        promoted.Box = Union(node.Box, higher.Box);
+        promoted.Height = 1 + std::max(node.Height, higher.Height);
+
+        return promotedIndex;
+    }
+
+    void DynamicAabbTree::ReplaceChild(uint32_t parentIndex, uint32_t oldChildIndex, uint32_t newChildIndex)
+    {
+        auto& childIndices = m_Nodes[parentIndex].ChildIndices;
+        BenzinAssert(childIndices[0] == oldChildIndex || childIndices[1] == oldChildIndex);
+
+        childIndices[childIndices[0] == oldChildIndex ? 0 : 1] = newChildIndex;
+    }
+
+} // namespace benzin
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "benzin/engine/frustum_culling.hpp"
+
+namespace benzin
+{
+
+    // Stays the same while the tree is restructured
+    using AabbTreeProxyId = uint32_t;
+
+    struct AabbTreeStats
+    {
+        uint32_t ProxyCount = 0;
+        uint32_t NodeCount = 0;
+        uint32_t Height = 0;
+    };
+
+    struct AabbTreeQueryStats
+    {
+        uint32_t TestedNodeCount = 0;
+        uint32_t VisibleProxyCount = 0;
+    };
+
+    // Bounding volume hierarchy for moving boxes. Leaves store boxes enlarged by a margin, so small moves don't change the tree.
+    // Insertion descends to the sibling with the smallest surface area cost and rotations keep subtrees balanced
+    class DynamicAabbTree
+    {
+    public:
+        AabbTreeProxyId CreateProxy(const DirectX::BoundingBox& boundingBox);
+        void DestroyProxy(AabbTreeProxyId proxyId);
+
+        // The proxy is reinserted only if the box leaves the enlarged box of the leaf. Returns true if it was reinserted
+        bool MoveProxy(AabbTreeProxyId proxyId, const DirectX::BoundingBox& boundingBox);
+
+        const Aabb& GetProxyAabb(AabbTreeProxyId proxyId) const;
+
+        AabbTreeStats GetStats() const;
+
+    public:
+        // Calls 'function' for every proxy which box isn't outside of the frustum. Nodes inside of a plane skip the plane
+        // for the whole subtree and subtrees inside of the frustum are reported without tests. Leaves that may still cross a plane
+        // are tested in batches by 'CullAabbs', so the result matches 'ClassifyAabb' of every proxy
+        AabbTreeQueryStats QueryFrustum(const FrustumPlanes& frustumPlanes, FunctionRef<void(AabbTreeProxyId)> function) const;
+
+        // Checks links, heights and that every node box contains the boxes of its children
+        bool Validate() const;
+
+    private:
+        struct Node
+        {
+            Aabb Box; // Enlarged for leaves
+            Aabb ProxyBox; // Leaves only
+
+            uint32_t ParentIndex = g_InvalidIndex<uint32_t>; // Next free node for free nodes
+            std::array<uint32_t, 2> ChildIndices{ g_InvalidIndex<uint32_t>, g_InvalidIndex<uint32_t> };
+            int32_t Height = 0; // 0 for leaves, -1 for free nodes
+
+            bool IsLeaf() const { return !IsValidIndex(ChildIndices[0]); }
+        };
+
+    private:
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t nodeIndex);
+
+        void InsertLeaf(uint32_t leafIndex);
+        void RemoveLeaf(uint32_t leafIndex);
+
+        void RefitAncestors(uint32_t nodeIndex);
+        uint32_t Balance(uint32_t nodeIndex);
+        uint32_t RotateUp(uint32_t nodeIndex, uint32_t childSlot);
+        void ReplaceChild(uint32_t parentIndex, uint32_t oldChildIndex, uint32_t newChildIndex);
+
+    private:
+        std::vector<Node> m_Nodes;
+        uint32_t m_RootIndex = g_InvalidIndex<uint32_t>;
+        uint32_t m_FreeNodeIndex = g_InvalidIndex<uint32_t>;
+
+        uint32_t m_ProxyCount = 0;
+        uint32_t m_NodeCount = 0;
+    };
+
+} // namespace benzin
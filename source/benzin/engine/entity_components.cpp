@@ -4,7 +4,6 @@
 #include <shaders/joint/structured_buffer_types.hpp>
 
 #include "benzin/core/asserter.hpp"
-#include "benzin/core/math.hpp"
 #include "benzin/graphics/buffer.hpp"
 #include "benzin/graphics/device.hpp"
 
@@ -13,26 +12,45 @@ namespace benzin
 
     void TransformComponent::SetScale(const DirectX::XMFLOAT3& scale)
     {
-        m_Scale = scale;
-        m_IsDirty = true;
+        LocalTransform localTransform = GetLocalTransform();
+        localTransform.Scale = scale;
+
+        m_TransformHierarchy->SetLocalTransform(m_TransformNodeId, localTransform);
     }
 
     void TransformComponent::SetRotation(const DirectX::XMFLOAT3& rotation)
     {
-        m_Rotation = rotation;
-        m_IsDirty = true;
+        LocalTransform localTransform = GetLocalTransform();
+        localTransform.Rotation = rotation;
+
+        m_TransformHierarchy->SetLocalTransform(m_TransformNodeId, localTransform);
     }
 
     void TransformComponent::SetTranslation(const DirectX::XMFLOAT3& translation)
     {
-        m_Translation = translation;
-        m_IsDirty = true;
+        LocalTransform localTransform = GetLocalTransform();
+        localTransform.Translation = translation;
+
+        m_TransformHierarchy->SetLocalTransform(m_TransformNodeId, localTransform);
+    }
+
+    void TransformComponent::SetParent(const TransformComponent* parent)
+    {
+        BenzinAssert(!parent || parent->m_TransformHierarchy == m_TransformHierarchy);
+        m_TransformHierarchy->SetParent(m_TransformNodeId, parent ? parent->m_TransformNodeId : g_InvalidIndex<TransformNodeId>);
     }
 
     const DirectX::XMMATRIX& TransformComponent::GetWorldMatrix() const
     {
-        BenzinAssert(!m_IsDirty);
-        return m_WorldMatrix;
+        return m_TransformHierarchy->GetWorldMatrix(m_TransformNodeId);
+    }
+
+    DirectX::XMFLOAT3 TransformComponent::GetWorldTranslation() const
+    {
+        DirectX::XMFLOAT3 worldTranslation;
+        DirectX::XMStoreFloat3(&worldTranslation, GetWorldMatrix().r[3]);
+
+        return worldTranslation;
     }
 
     const Descriptor& TransformComponent::GetActiveTransformCbv() const
@@ -40,25 +58,24 @@ namespace benzin
         return m_TransformConstantBuffer->GetActiveCbv();
     }
 
-    void TransformComponent::UpdateMatricesIfNeeded()
+    LocalTransform TransformComponent::GetLocalTransform() const
     {
-        // Force update 'm_PreviousWorldMatrix'
-        m_PreviousWorldMatrix = m_WorldMatrix;
-
-        if (!m_IsDirty)
-        {
-            return;
-        }
+        BenzinAssert(m_TransformHierarchy);
+        return m_TransformHierarchy->GetLocalTransform(m_TransformNodeId);
+    }
 
-        const DirectX::XMMATRIX rotation = DirectX::XMMatrixRotationX(m_Rotation.x) * DirectX::XMMatrixRotationY(m_Rotation.y) * DirectX::XMMatrixRotationZ(m_Rotation.z);
-        const DirectX::XMMATRIX scaling = DirectX::XMMatrixScaling(m_Scale.x, m_Scale.y, m_Scale.z);
-        const DirectX::XMMATRIX translation = DirectX::XMMatrixTranslation(m_Translation.x, m_Translation.y, m_Translation.z);
-        const DirectX::XMMATRIX currentWorldMatrix = scaling * rotation * translation;
+    void TransformComponent::CreateTransformNode(TransformHierarchy& transformHierarchy)
+    {
+        m_TransformHierarchy = &transformHierarchy;
+        m_TransformNodeId = m_TransformHierarchy->CreateNode();
+    }
 
-        m_WorldMatrix = currentWorldMatrix;
-        m_WorldMatrixForNormals = GetMatrixForNormals(m_WorldMatrix);
+    void TransformComponent::DestroyTransformNode()
+    {
+        m_TransformHierarchy->DestroyNode(m_TransformNodeId);
 
-        m_IsDirty = false;
+        m_TransformHierarchy = nullptr;
+        m_TransformNodeId = g_InvalidIndex<TransformNodeId>;
     }
 
     void TransformComponent::CreateTransformConstantBuffer(Device& device, std::string_view debugName)
@@ -68,14 +85,12 @@ namespace benzin
 
     void TransformComponent::UpdateTransformConstantBuffer()
     {
-        UpdateMatricesIfNeeded();
-
         // #TODO: Can skip writing if matrix is not updated
         m_TransformConstantBuffer->UpdateConstants(joint::MeshTransform
         {
-            .WorldMatrix = m_WorldMatrix,
-            .PreviousWorldMatrix = m_PreviousWorldMatrix,
-            .WorldMatrixForNormals = m_WorldMatrixForNormals,
+            .WorldMatrix = m_TransformHierarchy->GetWorldMatrix(m_TransformNodeId),
+            .PreviousWorldMatrix = m_TransformHierarchy->GetPreviousWorldMatrix(m_TransformNodeId),
+            .WorldMatrixForNormals = m_TransformHierarchy->GetWorldMatrixForNormals(m_TransformNodeId),
         });
     }
 
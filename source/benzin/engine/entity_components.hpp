@@ -1,5 +1,7 @@
 #pragma once
 
+#include "benzin/engine/transform_hierarchy.hpp"
+
 namespace joint
 {
 
@@ -22,40 +24,43 @@ namespace benzin
         std::optional<IndexRangeU32> MeshInstanceRange;
     };
 
+    // Node of the scene 'TransformHierarchy'. Scale, rotation and translation are relative to the parent
     class TransformComponent
     {
     public:
         friend class Scene;
 
     public:
-        const auto& GetScale() const { return m_Scale; }
+        DirectX::XMFLOAT3 GetScale() const { return GetLocalTransform().Scale; }
         void SetScale(const DirectX::XMFLOAT3& scale);
 
-        const auto& GetRotation() const { return m_Rotation; }
+        DirectX::XMFLOAT3 GetRotation() const { return GetLocalTransform().Rotation; }
         void SetRotation(const DirectX::XMFLOAT3& rotation);
 
-        const auto& GetTranslation() const { return m_Translation; }
+        DirectX::XMFLOAT3 GetTranslation() const { return GetLocalTransform().Translation; }
         void SetTranslation(const DirectX::XMFLOAT3& translation);
 
+        // Null detaches the transform
+        void SetParent(const TransformComponent* parent);
+
+        // Updated by 'Scene::OnUpdate'
         const DirectX::XMMATRIX& GetWorldMatrix() const;
+        DirectX::XMFLOAT3 GetWorldTranslation() const;
 
         const Descriptor& GetActiveTransformCbv() const;
 
     private:
-        void UpdateMatricesIfNeeded();
+        LocalTransform GetLocalTransform() const;
+
+        void CreateTransformNode(TransformHierarchy& transformHierarchy);
+        void DestroyTransformNode();
 
         void CreateTransformConstantBuffer(Device& device, std::string_view debugName);
         void UpdateTransformConstantBuffer();
 
     private:
-        DirectX::XMFLOAT3 m_Scale{ 1.0f, 1.0f, 1.0f };
-        DirectX::XMFLOAT3 m_Rotation{ 0.0f, 0.0f, 0.0f };
-        DirectX::XMFLOAT3 m_Translation{ 0.0f, 0.0f, 0.0f };
-
-        bool m_IsDirty = true;
-        DirectX::XMMATRIX m_WorldMatrix = DirectX::XMMatrixIdentity();
-        DirectX::XMMATRIX m_PreviousWorldMatrix = DirectX::XMMatrixIdentity();
-        DirectX::XMMATRIX m_WorldMatrixForNormals = DirectX::XMMatrixIdentity();
+        TransformHierarchy* m_TransformHierarchy = nullptr;
+        TransformNodeId m_TransformNodeId = g_InvalidIndex<TransformNodeId>;
 
         std::unique_ptr<ConstantBuffer<joint::MeshTransform>> m_TransformConstantBuffer;
     };
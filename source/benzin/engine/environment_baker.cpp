@@ -0,0 +1,434 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/environment_baker.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/core/logger.hpp"
+#include "benzin/engine/mesh_collection_cache.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // Goes into the cache hash, bump on any change of the baked result
+        constexpr uint32_t g_EnvironmentCacheVersion = 1;
+
+        constexpr uint32_t g_CubeFaceCount = 6;
+        constexpr uint32_t g_ChannelCount = 4;
+
+        // Faces are stored one after another
+        struct FloatCubeMip
+        {
+            uint32_t Size = 0;
+            std::vector<DirectX::XMFLOAT4> Texels;
+
+            DirectX::XMVECTOR Load(uint32_t faceIndex, uint32_t x, uint32_t y) const
+            {
+                return DirectX::XMLoadFloat4(&Texels[((size_t)faceIndex * Size + y) * Size + x]);
+            }
+        };
+
+        // Precomputed GGX sample in the tangent space of the normal. Normal and view directions are the same
+        struct SpecularSample
+        {
+            DirectX::XMFLOAT3 Direction;
+            float Weight = 0.0f; // NdotL
+            float SourceMipIndex = 0.0f;
+        };
+
+        // Inverse of 'GetCubeFaceDirection'
+        uint32_t GetCubeFaceUv(DirectX::XMVECTOR direction, float& outU, float& outV)
+        {
+            DirectX::XMFLOAT3 d;
+            DirectX::XMStoreFloat3(&d, direction);
+
+            const float absX = std::abs(d.x);
+            const float absY = std::abs(d.y);
+            const float absZ = std::abs(d.z);
+
+            uint32_t faceIndex = 0;
+            float faceU = 0.0f;
+            float faceV = 0.0f;
+
+            if (absX >= absY && absX >= absZ)
+            {
+                faceIndex = d.x > 0.0f ? 0 : 1;
+                faceU = (d.x > 0.0f ? -d.z : d.z) / absX;
+                faceV = d.y / absX;
+            }
+            else if (absY >= absZ)
+            {
+                faceIndex = d.y > 0.0f ? 2 : 3;
+                faceU = d.x / absY;
+                faceV = (d.y > 0.0f ? -d.z : d.z) / absY;
+            }
+            else
+            {
+                faceIndex = d.z > 0.0f ? 4 : 5;
+                faceU = (d.z > 0.0f ? d.x : -d.x) / absZ;
+                faceV = d.y / absZ;
+            }
+
+            outU = (faceU + 1.0f) * 0.5f;
+            outV = (1.0f - faceV) * 0.5f;
+
+            return faceIndex;
+        }
+
+        // Bilinear inside the face, texels on face edges are clamped
+        DirectX::XMVECTOR SampleCubeMip(const FloatCubeMip& mip, DirectX::XMVECTOR direction)
+        {
+            float u = 0.0f;
+            float v = 0.0f;
+            const uint32_t faceIndex = GetCubeFaceUv(direction, u, v);
+
+            const float x = std::clamp(u * mip.Size - 0.5f, 0.0f, (float)(mip.Size - 1));
+            const float y = std::clamp(v * mip.Size - 0.5f, 0.0f, (float)(mip.Size - 1));
+
+            const auto x0 = (uint32_t)x;
+            const auto y0 = (uint32_t)y;
+            const uint32_t x1 = std::min(x0 + 1, mip.Size - 1);
+            const uint32_t y1 = std::min(y0 + 1, mip.Size - 1);
+
+            const DirectX::XMVECTOR top = DirectX::XMVectorLerp(mip.Load(faceIndex, x0, y0), mip.Load(faceIndex, x1, y0), x - (float)x0);
+            const DirectX::XMVECTOR bottom = DirectX::XMVectorLerp(mip.Load(faceIndex, x0, y1), mip.Load(faceIndex, x1, y1), x - (float)x0);
+
+            return DirectX::XMVectorLerp(top, bottom, y - (float)y0);
+        }
+
+        // 2x2 box filter on each face
+        FloatCubeMip DownsampleCubeMip(const FloatCubeMip& mip)
+        {
+            FloatCubeMip result{ .Size = std::max(mip.Size / 2, 1u) };
+            result.Texels.resize((size_t)g_CubeFaceCount * result.Size * result.Size);
+
+            for (uint32_t faceIndex = 0; faceIndex < g_CubeFaceCount; ++faceIndex)
+            {
+                for (uint32_t y = 0; y < result.Size; ++y)
+                {
+                    for (uint32_t x = 0; x < result.Size; ++x)
+                    {
+                        const uint32_t sourceX = std::min(2 * x, mip.Size - 1);
+                        const uint32_t sourceY = std::min(2 * y, mip.Size - 1);
+                        const uint32_t nextSourceX = std::min(sourceX + 1, mip.Size - 1);
+                        const uint32_t nextSourceY = std::min(sourceY + 1, mip.Size - 1);
+
+                        DirectX::XMVECTOR sum = mip.Load(faceIndex, sourceX, sourceY);
+                        sum = DirectX::XMVectorAdd(sum, mip.Load(faceIndex, nextSourceX, sourceY));
+                        sum = DirectX::XMVectorAdd(sum, mip.Load(faceIndex, sourceX, nextSourceY));
+                        sum = DirectX::XMVectorAdd(sum, mip.Load(faceIndex, nextSourceX, nextSourceY));
+
+                        DirectX::XMStoreFloat4(&result.Texels[((size_t)faceIndex * result.Size + y) * result.Size + x], DirectX::XMVectorScale(sum, 0.25f));
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        DirectX::XMFLOAT2 GetHammersleyPoint(uint32_t index, uint32_t count)
+        {
+            uint32_t bits = index;
+            bits = (bits << 16) | (bits >> 16);
+            bits = ((bits & 0x5555'5555) << 1) | ((bits & 0xaaaa'aaaa) >> 1);
+            bits = ((bits & 0x3333'3333) << 2) | ((bits & 0xcccc'cccc) >> 2);
+            bits = ((bits & 0x0f0f'0f0f) << 4) | ((bits & 0xf0f0'f0f0) >> 4);
+            bits = ((bits & 0x00ff'00ff) << 8) | ((bits & 0xff00'ff00) >> 8);
+
+            return DirectX::XMFLOAT2{ (float)index / (float)count, (float)bits * 2.3283064365386963e-10f };
+        }
+
+        // Samples with a low PDF read a coarser source mip, which removes fireflies with a few samples
+        // Ref: Colbert, Krivanek, GPU-Based Importance Sampling
+        std::vector<SpecularSample> GetSpecularSamples(float roughness, uint32_t sampleCount, uint32_t sourceTopMipSize, uint32_t sourceMipCount)
+        {
+            const float alpha = roughness * roughness;
+            const float alphaSquared = alpha * alpha;
+            const float texelSolidAngle = 4.0f * DirectX::XM_PI / (g_CubeFaceCount * (float)sourceTopMipSize * (float)sourceTopMipSize);
+
+            std::vector<SpecularSample> samples;
+            samples.reserve(sampleCount);
+
+            for (uint32_t i = 0; i < sampleCount; ++i)
+            {
+                const DirectX::XMFLOAT2 xi = GetHammersleyPoint(i, sampleCount);
+
+                const float phi = DirectX::XM_2PI * xi.x;
+                const float cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (alphaSquared - 1.0f) * xi.y));
+                const float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+                // Reflect the view direction (0, 0, 1) around the half vector
+                const DirectX::XMFLOAT3 direction
+                {
+                    2.0f * cosTheta * sinTheta * std::cos(phi),
+                    2.0f * cosTheta * sinTheta * std::sin(phi),
+                    2.0f * cosTheta * cosTheta - 1.0f,
+                };
+
+                if (direction.z <= 0.0f)
+                {
+                    continue;
+                }
+
+                const float denominator = cosTheta * cosTheta * (alphaSquared - 1.0f) + 1.0f;
+                const float distribution = alphaSquared / (DirectX::XM_PI * denominator * denominator);
+                const float pdf = std::max(distribution * 0.25f, 1e-6f); // D * NdotH / (4 * VdotH), where NdotH == VdotH
+                const float sampleSolidAngle = 1.0f / ((float)sampleCount * pdf);
+
+                samples.push_back(SpecularSample
+                {
+                    .Direction = direction,
+                    .Weight = direction.z,
+                    .SourceMipIndex = std::clamp(0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f, (float)(sourceMipCount - 1)),
+                });
+            }
+
+            return samples;
+        }
+
+        DirectX::XMVECTOR PrefilterSpecular(std::span<const FloatCubeMip> sourceMips, std::span<const SpecularSample> samples, DirectX::XMVECTOR normal)
+        {
+            const DirectX::XMVECTOR up = std::abs(DirectX::XMVectorGetZ(normal)) < 0.999f ? DirectX::g_XMIdentityR2 : DirectX::g_XMIdentityR0;
+            const DirectX::XMVECTOR tangent = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(up, normal));
+            const DirectX::XMVECTOR bitangent = DirectX::XMVector3Cross(normal, tangent);
+
+            DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+            float weightSum = 0.0f;
+
+            for (const auto& sample : samples)
+            {
+                DirectX::XMVECTOR direction = DirectX::XMVectorScale(tangent, sample.Direction.x);
+                direction = DirectX::XMVectorMultiplyAdd(bitangent, DirectX::XMVectorReplicate(sample.Direction.y), direction);
+                direction = DirectX::XMVectorMultiplyAdd(normal, DirectX::XMVectorReplicate(sample.Direction.z), direction);
+
+                const auto mipIndex = (uint32_t)sample.SourceMipIndex;
+                const uint32_t nextMipIndex = std::min(mipIndex + 1, (uint32_t)sourceMips.size() - 1);
+
+                const DirectX::XMVECTOR color = DirectX::XMVectorLerp(
+                    SampleCubeMip(sourceMips[mipIndex], direction),
+                    SampleCubeMip(sourceMips[nextMipIndex], direction),
+                    sample.SourceMipIndex - (float)mipIndex
+                );
+
+                sum = DirectX::XMVectorMultiplyAdd(color, DirectX::XMVectorReplicate(sample.Weight), sum);
+                weightSum += sample.Weight;
+            }
+
+            return weightSum > 0.0f ? DirectX::XMVectorScale(sum, 1.0f / weightSum) : sum;
+        }
+
+        // Runs 'function(faceIndex, x, y, texel)' for every texel of a mip on all cores
+        template <typename Function>
+        void FillCubeMip(FloatCubeMip& mip, Function&& function)
+        {
+            ParallelFor(g_CubeFaceCount * mip.Size, 1, [&](uint32_t rowIndex)
+            {
+                const uint32_t faceIndex = rowIndex / mip.Size;
+                const uint32_t y = rowIndex % mip.Size;
+
+                for (uint32_t x = 0; x < mip.Size; ++x)
+                {
+                    DirectX::XMStoreFloat4(&mip.Texels[((size_t)faceIndex * mip.Size + y) * mip.Size + x], function(faceIndex, x, y));
+                }
+            });
+        }
+
+        DirectX::XMVECTOR GetTexelDirection(uint32_t faceIndex, uint32_t x, uint32_t y, uint32_t size)
+        {
+            return GetCubeFaceDirection(faceIndex, ((float)x + 0.5f) / (float)size, ((float)y + 0.5f) / (float)size);
+        }
+
+    } // anonymous namespace
+
+    //
+
+    DirectX::XMVECTOR GetCubeFaceDirection(uint32_t faceIndex, float u, float v)
+    {
+        const float faceU = 2.0f * u - 1.0f;
+        const float faceV = 1.0f - 2.0f * v;
+
+        DirectX::XMVECTOR direction;
+        switch (faceIndex)
+        {
+            case 0: direction = DirectX::XMVectorSet(1.0f, faceV, -faceU, 0.0f); break;
+            case 1: direction = DirectX::XMVectorSet(-1.0f, faceV, faceU, 0.0f); break;
+            case 2: direction = DirectX::XMVectorSet(faceU, 1.0f, -faceV, 0.0f); break;
+            case 3: direction = DirectX::XMVectorSet(faceU, -1.0f, faceV, 0.0f); break;
+            case 4: direction = DirectX::XMVectorSet(faceU, faceV, 1.0f, 0.0f); break;
+            case 5: direction = DirectX::XMVectorSet(-faceU, faceV, -1.0f, 0.0f); break;
+            default: BenzinAssert(false); direction = DirectX::XMVectorZero(); break;
+        }
+
+        return DirectX::XMVector3Normalize(direction);
+    }
+
+    DirectX::XMVECTOR SampleEquirectangular(const TextureImage& equirectangularImage, DirectX::XMVECTOR direction)
+    {
+        BenzinAssert(equirectangularImage.Format == GraphicsFormat::Rgba32Float);
+
+        DirectX::XMFLOAT3 d;
+        DirectX::XMStoreFloat3(&d, direction);
+
+        const float phi = std::atan2(d.z, d.x); // Azimuthal angle
+        const float theta = std::acos(std::clamp(d.y, -1.0f, 1.0f)); // Polar angle
+
+        const float u = 0.5f - phi / DirectX::XM_2PI;
+        const float v = theta / DirectX::XM_PI;
+
+        const uint32_t width = equirectangularImage.Width;
+        const uint32_t height = equirectangularImage.Height;
+        const auto* texels = reinterpret_cast<const DirectX::XMFLOAT4*>(equirectangularImage.ImageData.data());
+
+        // Wraps horizontally and clamps on the poles
+        const float x = u * width - 0.5f;
+        const float y = std::clamp(v * height - 0.5f, 0.0f, (float)(height - 1));
+
+        const float floorX = std::floor(x);
+        const auto x0 = (uint32_t)(((int64_t)floorX % width + width) % width);
+        const uint32_t x1 = (x0 + 1) % width;
+        const auto y0 = (uint32_t)y;
+        const uint32_t y1 = std::min(y0 + 1, height - 1);
+
+        const auto Load = [&](uint32_t texelX, uint32_t texelY) { return DirectX::XMLoadFloat4(&texels[(size_t)texelY * width + texelX]); };
+
+        const DirectX::XMVECTOR top = DirectX::XMVectorLerp(Load(x0, y0), Load(x1, y0), x - floorX);
+        const DirectX::XMVECTOR bottom = DirectX::XMVectorLerp(Load(x0, y1), Load(x1, y1), x - floorX);
+
+        return DirectX::XMVectorLerp(top, bottom, y - (float)y0);
+    }
+
+    void BakeEnvironmentCubeMap(const TextureImage& equirectangularImage, TextureImage& outCubeMap, const EnvironmentBakeParams& params)
+    {
+        BenzinAssert(equirectangularImage.Format == GraphicsFormat::Rgba32Float);
+        BenzinAssert(params.CubeFaceSize != 0 && params.SpecularMipCount != 0);
+
+        const uint32_t mipCount = std::min(params.SpecularMipCount, (uint32_t)std::bit_width(params.CubeFaceSize));
+
+        // Source mips for the filtered importance sampling
+        std::vector<FloatCubeMip> sourceMips;
+        {
+            FloatCubeMip& topMip = sourceMips.emplace_back(FloatCubeMip{ .Size = params.CubeFaceSize });
+            topMip.Texels.resize((size_t)g_CubeFaceCount * topMip.Size * topMip.Size);
+
+            FillCubeMip(topMip, [&](uint32_t faceIndex, uint32_t x, uint32_t y)
+            {
+                return SampleEquirectangular(equirectangularImage, GetTexelDirection(faceIndex, x, y, topMip.Size));
+            });
+
+            while (sourceMips.back().Size > 1)
+            {
+                sourceMips.push_back(DownsampleCubeMip(sourceMips.back()));
+            }
+        }
+
+        std::vector<FloatCubeMip> specularMips;
+        specularMips.reserve(mipCount);
+        specularMips.push_back(sourceMips[0]);
+
+        for (uint32_t mipIndex = 1; mipIndex < mipCount; ++mipIndex)
+        {
+            const float roughness = (float)mipIndex / (float)(mipCount - 1);
+            const std::vector<SpecularSample> samples = GetSpecularSamples(roughness, params.SpecularSampleCount, params.CubeFaceSize, (uint32_t)sourceMips.size());
+
+            FloatCubeMip& mip = specularMips.emplace_back(FloatCubeMip{ .Size = std::max(params.CubeFaceSize >> mipIndex, 1u) });
+            mip.Texels.resize((size_t)g_CubeFaceCount * mip.Size * mip.Size);
+
+            FillCubeMip(mip, [&](uint32_t faceIndex, uint32_t x, uint32_t y)
+            {
+                return PrefilterSpecular(sourceMips, samples, GetTexelDirection(faceIndex, x, y, mip.Size));
+            });
+        }
+
+        // Down convert to half floats
+        outCubeMap.Format = GraphicsFormat::Rgba16Float;
+        outCubeMap.IsCubeMap = true;
+        outCubeMap.Width = params.CubeFaceSize;
+        outCubeMap.Height = params.CubeFaceSize;
+        outCubeMap.MipCount = mipCount;
+
+        size_t cubeMapSizeInBytes = 0;
+        for (const auto& mip : specularMips)
+        {
+            cubeMapSizeInBytes += mip.Texels.size() * g_ChannelCount * sizeof(DirectX::PackedVector::HALF);
+        }
+
+        outCubeMap.ImageData.resize(cubeMapSizeInBytes);
+
+        auto* halfTexels = reinterpret_cast<DirectX::PackedVector::HALF*>(outCubeMap.ImageData.data());
+        for (uint32_t faceIndex = 0; faceIndex < g_CubeFaceCount; ++faceIndex)
+        {
+            for (const auto& mip : specularMips)
+            {
+                const size_t faceTexelCount = (size_t)mip.Size * mip.Size;
+                const float* faceTexels = &mip.Texels[faceIndex * faceTexelCount].x;
+
+                DirectX::PackedVector::XMConvertFloatToHalfStream(halfTexels, sizeof(DirectX::PackedVector::HALF), faceTexels, sizeof(float), faceTexelCount * g_ChannelCount);
+                halfTexels += faceTexelCount * g_ChannelCount;
+            }
+        }
+
+#if BENZIN_IS_DEBUG_BUILD
+        // The top mip must match the direct sample of the source up to the half precision
+        for (uint32_t faceIndex = 0; faceIndex < g_CubeFaceCount; ++faceIndex)
+        {
+            const uint32_t x = params.CubeFaceSize / 3;
+            const uint32_t y = params.CubeFaceSize / 5;
+
+            const DirectX::XMVECTOR reference = SampleEquirectangular(equirectangularImage, GetTexelDirection(faceIndex, x, y, params.CubeFaceSize));
+
+            const size_t faceSizeInBytes = cubeMapSizeInBytes / g_CubeFaceCount;
+            const size_t texelOffset = faceIndex * faceSizeInBytes + ((size_t)y * params.CubeFaceSize + x) * g_ChannelCount * sizeof(DirectX::PackedVector::HALF);
+            const DirectX::XMVECTOR baked = DirectX::PackedVector::XMLoadHalf4(reinterpret_cast<const DirectX::PackedVector::XMHALF4*>(outCubeMap.ImageData.data() + texelOffset));
+
+            const DirectX::XMVECTOR tolerance = DirectX::XMVectorMultiplyAdd(DirectX::XMVectorAbs(reference), DirectX::XMVectorReplicate(1e-3f), DirectX::XMVectorReplicate(1e-4f));
+            BenzinAssert(DirectX::XMVector4LessOrEqual(DirectX::XMVectorAbs(DirectX::XMVectorSubtract(baked, reference)), tolerance));
+        }
+#endif
+    }
+
+    bool LoadEnvironmentCubeMapFromHdrFile(std::string_view fileName, TextureImage& outCubeMap, const EnvironmentBakeParams& params)
+    {
+        const std::filesystem::path filePath = config::g_TextureDirPath / fileName;
+        if (!std::filesystem::exists(filePath))
+        {
+            return false;
+        }
+
+        std::filesystem::path cacheFilePath = filePath;
+        cacheFilePath += ".env_cache";
+
+        uint64_t sourceHash = 0;
+        sourceHash = HashCombine(sourceHash, g_EnvironmentCacheVersion);
+        sourceHash = HashCombine(sourceHash, std::filesystem::file_size(filePath));
+        sourceHash = HashCombine(sourceHash, std::filesystem::last_write_time(filePath).time_since_epoch().count());
+        sourceHash = HashCombine(sourceHash, params.CubeFaceSize);
+        sourceHash = HashCombine(sourceHash, params.SpecularMipCount);
+        sourceHash = HashCombine(sourceHash, params.SpecularSampleCount);
+
+        if (LoadTextureImageFromCacheFile(cacheFilePath, sourceHash, outCubeMap))
+        {
+            return true;
+        }
+
+        TextureImage equirectangularImage;
+        if (!LoadTextureImageFromHdrFile(fileName, equirectangularImage))
+        {
+            return false;
+        }
+
+        {
+            BenzinLogTimeOnScopeExit("EnvironmentBaker: Bake {}", fileName);
+            BakeEnvironmentCubeMap(equirectangularImage, outCubeMap, params);
+        }
+
+        outCubeMap.DebugName = equirectangularImage.DebugName;
+
+        SaveTextureImageToCacheFile(cacheFilePath, sourceHash, outCubeMap);
+
+        return true;
+    }
+
+} // namespace benzin
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct TextureImage;
+
+    struct EnvironmentBakeParams
+    {
+        uint32_t CubeFaceSize = 1024;
+        uint32_t SpecularMipCount = 6; // Roughness goes linearly from 0 on the top mip to 1 on the last one
+        uint32_t SpecularSampleCount = 64;
+    };
+
+    // Faces follow D3D order: +X, -X, +Y, -Y, +Z, -Z. 'u' and 'v' are texture coordinates on the face
+    DirectX::XMVECTOR GetCubeFaceDirection(uint32_t faceIndex, float u, float v);
+
+    // Bilinear sample of a 'Rgba32Float' equirectangular image in the direction
+    DirectX::XMVECTOR SampleEquirectangular(const TextureImage& equirectangularImage, DirectX::XMVECTOR direction);
+
+    // Converts a 'Rgba32Float' equirectangular image to a 'Rgba16Float' cube map with GGX prefiltered specular mips
+    // Faces are stored one after another, each with all its mips, so it can be uploaded by 'CopyCommandList::UpdateTextureMips'
+    // Ref: Karis, Real Shading in Unreal Engine 4
+    void BakeEnvironmentCubeMap(const TextureImage& equirectangularImage, TextureImage& outCubeMap, const EnvironmentBakeParams& params = {});
+
+    // Loads the HDR file from the texture directory and bakes it. The result is cached next to the source file
+    bool LoadEnvironmentCubeMapFromHdrFile(std::string_view fileName, TextureImage& outCubeMap, const EnvironmentBakeParams& params = {});
+
+} // namespace benzin
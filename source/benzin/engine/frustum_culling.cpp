@@ -0,0 +1,238 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/frustum_culling.hpp"
+
+#include <intrin.h>
+#include <immintrin.h>
+
+#include "benzin/core/asserter.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        bool IsAvxSupported()
+        {
+            std::array<int, 4> cpuInfo;
+            __cpuid(cpuInfo.data(), 1);
+
+            const bool isAvxSupported = (cpuInfo[2] & (1 << 28)) != 0;
+            const bool isXsaveEnabled = (cpuInfo[2] & (1 << 27)) != 0;
+
+            // The OS must save XMM and YMM registers on context switches
+            return isAvxSupported && isXsaveEnabled && (_xgetbv(0) & 0b110) == 0b110;
+        }
+
+        const CullingKernel g_WidestCullingKernel = IsAvxSupported() ? CullingKernel::Avx : CullingKernel::Sse;
+
+        // Component arrays holding the corner nearest to the outside of a plane
+        struct PlaneCorner
+        {
+            const float* X = nullptr;
+            const float* Y = nullptr;
+            const float* Z = nullptr;
+        };
+
+        std::array<PlaneCorner, 6> GetNearestCorners(const FrustumPlanes& frustumPlanes, const AabbSoaView& aabbs)
+        {
+            std::array<PlaneCorner, 6> corners;
+
+            for (uint32_t planeIndex = 0; planeIndex < corners.size(); ++planeIndex)
+            {
+                const DirectX::XMFLOAT4& plane = frustumPlanes.Planes[planeIndex];
+
+                corners[planeIndex] = PlaneCorner
+                {
+                    .X = plane.x >= 0.0f ? aabbs.MinX : aabbs.MaxX,
+                    .Y = plane.y >= 0.0f ? aabbs.MinY : aabbs.MaxY,
+                    .Z = plane.z >= 0.0f ? aabbs.MinZ : aabbs.MaxZ,
+                };
+            }
+
+            return corners;
+        }
+
+        void SetVisibilityBits(std::span<uint64_t> visibilityMask, uint32_t firstIndex, uint64_t bits)
+        {
+            visibilityMask[firstIndex / 64] |= bits << (firstIndex % 64);
+        }
+
+        void CullAabbsScalar(const FrustumPlanes& frustumPlanes, const AabbSoaView& aabbs, IndexRangeU32 aabbRange, std::span<uint64_t> visibilityMask)
+        {
+            for (const uint32_t i : IndexRangeToView(aabbRange))
+            {
+                const Aabb aabb
+                {
+                    .Min{ aabbs.MinX[i], aabbs.MinY[i], aabbs.MinZ[i] },
+                    .Max{ aabbs.MaxX[i], aabbs.MaxY[i], aabbs.MaxZ[i] },
+                };
+
+                uint32_t planeMask = g_AllFrustumPlanesMask;
+                if (ClassifyAabb(frustumPlanes, aabb, planeMask))
+                {
+                    SetVisibilityBits(visibilityMask, i, 1);
+                }
+            }
+        }
+
+        // Returns the index of the first box left for the scalar kernel
+        uint32_t CullAabbsSse(const FrustumPlanes& frustumPlanes, const AabbSoaView& aabbs, std::span<uint64_t> visibilityMask)
+        {
+            const std::array<PlaneCorner, 6> corners = GetNearestCorners(frustumPlanes, aabbs);
+            const __m128 zero = _mm_setzero_ps();
+
+            const uint32_t simdCount = aabbs.Count / 4 * 4;
+            for (uint32_t i = 0; i < simdCount; i += 4)
+            {
+                __m128 isOutside = zero;
+
+                for (uint32_t planeIndex = 0; planeIndex < corners.size(); ++planeIndex)
+                {
+                    const PlaneCorner& corner = corners[planeIndex];
+                    const DirectX::XMFLOAT4& plane = frustumPlanes.Planes[planeIndex];
+
+                    const __m128 x = _mm_mul_ps(_mm_set1_ps(plane.x), _mm_loadu_ps(corner.X + i));
+                    const __m128 y = _mm_mul_ps(_mm_set1_ps(plane.y), _mm_loadu_ps(corner.Y + i));
+                    const __m128 z = _mm_mul_ps(_mm_set1_ps(plane.z), _mm_loadu_ps(corner.Z + i));
+                    const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), _mm_set1_ps(plane.w));
+
+                    isOutside = _mm_or_ps(isOutside, _mm_cmpgt_ps(distance, zero));
+                }
+
+                SetVisibilityBits(visibilityMask, i, ~(uint64_t)_mm_movemask_ps(isOutside) & 0xf);
+            }
+
+            return simdCount;
+        }
+
+        uint32_t CullAabbsAvx(const FrustumPlanes& frustumPlanes, const AabbSoaView& aabbs, std::span<uint64_t> visibilityMask)
+        {
+            const std::array<PlaneCorner, 6> corners = GetNearestCorners(frustumPlanes, aabbs);
+            const __m256 zero = _mm256_setzero_ps();
+
+            const uint32_t simdCount = aabbs.Count / 8 * 8;
+            for (uint32_t i = 0; i < simdCount; i += 8)
+            {
+                __m256 isOutside = zero;
+
+                for (uint32_t planeIndex = 0; planeIndex < corners.size(); ++planeIndex)
+                {
+                    const PlaneCorner& corner = corners[planeIndex];
+                    const DirectX::XMFLOAT4& plane = frustumPlanes.Planes[planeIndex];
+
+                    const __m256 x = _mm256_mul_ps(_mm256_set1_ps(plane.x), _mm256_loadu_ps(corner.X + i));
+                    const __m256 y = _mm256_mul_ps(_mm256_set1_ps(plane.y), _mm256_loadu_ps(corner.Y + i));
+                    const __m256 z = _mm256_mul_ps(_mm256_set1_ps(plane.z), _mm256_loadu_ps(corner.Z + i));
+                    const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(x, y), z), _mm256_set1_ps(plane.w));
+
+                    // Ordered comparison, a NaN distance isn't outside as in 'ClassifyAabb'
+                    isOutside = _mm256_or_ps(isOutside, _mm256_cmp_ps(distance, zero, _CMP_GT_OQ));
+                }
+
+                SetVisibilityBits(visibilityMask, i, ~(uint64_t)_mm256_movemask_ps(isOutside) & 0xff);
+            }
+
+            return simdCount;
+        }
+
+    } // anonymous namespace
+
+    Aabb ToAabb(const DirectX::BoundingBox& boundingBox)
+    {
+        const auto& [center, extents] = boundingBox;
+
+        return Aabb
+        {
+            .Min{ center.x - extents.x, center.y - extents.y, center.z - extents.z },
+            .Max{ center.x + extents.x, center.y + extents.y, center.z + extents.z },
+        };
+    }
+
+    FrustumPlanes GetFrustumPlanes(const DirectX::BoundingFrustum& boundingFrustum)
+    {
+        std::array<DirectX::XMVECTOR, 6> planes;
+        boundingFrustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+
+        FrustumPlanes frustumPlanes;
+        for (const auto& [i, plane] : planes | std::views::enumerate)
+        {
+            DirectX::XMStoreFloat4(&frustumPlanes.Planes[i], plane);
+        }
+
+        return frustumPlanes;
+    }
+
+    bool ClassifyAabb(const FrustumPlanes& frustumPlanes, const Aabb& aabb, uint32_t& planeMask)
+    {
+        for (const auto& [i, plane] : frustumPlanes.Planes | std::views::enumerate)
+        {
+            const uint32_t planeBit = 1 << i;
+            if ((planeMask & planeBit) == 0)
+            {
+                continue;
+            }
+
+            // Distances of the corners nearest to and farthest from the outside. Only products with the same plane factor
+            // are summed in the same order, so a contained box never has a greater distance
+            const float minDistance =
+                plane.x * (plane.x >= 0.0f ? aabb.Min.x : aabb.Max.x) +
+                plane.y * (plane.y >= 0.0f ? aabb.Min.y : aabb.Max.y) +
+                plane.z * (plane.z >= 0.0f ? aabb.Min.z : aabb.Max.z) +
+                plane.w;
+
+            if (minDistance > 0.0f)
+            {
+                return false;
+            }
+
+            const float maxDistance =
+                plane.x * (plane.x >= 0.0f ? aabb.Max.x : aabb.Min.x) +
+                plane.y * (plane.y >= 0.0f ? aabb.Max.y : aabb.Min.y) +
+                plane.z * (plane.z >= 0.0f ? aabb.Max.z : aabb.Min.z) +
+                plane.w;
+
+            if (maxDistance <= 0.0f)
+            {
+                planeMask &= ~planeBit;
+            }
+        }
+
+        return true;
+    }
+
+    CullingKernel GetWidestCullingKernel()
+    {
+        return g_WidestCullingKernel;
+    }
+
+    void CullAabbs(const FrustumPlanes& frustumPlanes, const AabbSoaView& aabbs, std::span<uint64_t> visibilityMask, CullingKernel kernel)
+    {
+        BenzinAssert(visibilityMask.size() * 64 >= aabbs.Count);
+        BenzinAssert(kernel != CullingKernel::Avx || g_WidestCullingKernel == CullingKernel::Avx);
+
+        std::ranges::fill(visibilityMask, 0);
+
+        uint32_t scalarStartIndex = 0;
+        switch (kernel)
+        {
+            case CullingKernel::Scalar:
+            {
+                break;
+            }
+            case CullingKernel::Sse:
+            {
+                scalarStartIndex = CullAabbsSse(frustumPlanes, aabbs, visibilityMask);
+                break;
+            }
+            case CullingKernel::Avx:
+            {
+                scalarStartIndex = CullAabbsAvx(frustumPlanes, aabbs, visibilityMask);
+                break;
+            }
+        }
+
+        CullAabbsScalar(frustumPlanes, aabbs, IndexRangeU32{ scalarStartIndex, aabbs.Count - scalarStartIndex }, visibilityMask);
+    }
+
+} // namespace benzin
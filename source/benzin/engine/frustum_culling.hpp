@@ -0,0 +1,55 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct Aabb
+    {
+        DirectX::XMFLOAT3 Min{ 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 Max{ 0.0f, 0.0f, 0.0f };
+    };
+
+    Aabb ToAabb(const DirectX::BoundingBox& boundingBox);
+
+    // Normals point outside of the frustum, planes are normalized
+    struct FrustumPlanes
+    {
+        std::array<DirectX::XMFLOAT4, 6> Planes; // Near, Far, Right, Left, Top, Bottom
+    };
+
+    inline constexpr uint32_t g_AllFrustumPlanesMask = (1 << 6) - 1;
+
+    FrustumPlanes GetFrustumPlanes(const DirectX::BoundingFrustum& boundingFrustum);
+
+    // Returns false if the box is outside of one of the planes in 'planeMask'. Planes which the box is completely inside
+    // are removed from 'planeMask', so they can be skipped for boxes contained by this one
+    bool ClassifyAabb(const FrustumPlanes& frustumPlanes, const Aabb& aabb, uint32_t& planeMask);
+
+    // Every box component is a separate array, so a single load takes the component of 4 or 8 boxes
+    struct AabbSoaView
+    {
+        const float* MinX = nullptr;
+        const float* MinY = nullptr;
+        const float* MinZ = nullptr;
+        const float* MaxX = nullptr;
+        const float* MaxY = nullptr;
+        const float* MaxZ = nullptr;
+
+        uint32_t Count = 0;
+    };
+
+    enum class CullingKernel : uint8_t
+    {
+        Scalar, // 'ClassifyAabb' for every box
+        Sse, // 4 boxes at once
+        Avx, // 8 boxes at once
+    };
+
+    CullingKernel GetWidestCullingKernel(); // Supported by the CPU
+
+    // Sets bit 'i' of 'visibilityMask' if box 'i' isn't outside of the frustum and clears it otherwise. Every kernel gives the same mask
+    // as 'ClassifyAabb' with all planes, products are summed in the same order and no fused multiply-add is used.
+    // 'visibilityMask' has a word for every 64 boxes
+    void CullAabbs(const FrustumPlanes& frustumPlanes, const AabbSoaView& aabbs, std::span<uint64_t> visibilityMask, CullingKernel kernel = GetWidestCullingKernel());
+
+} // namespace benzin
@@ -4,7 +4,10 @@
 #include <shaders/joint/structured_buffer_types.hpp>
 
 #include "benzin/core/asserter.hpp"
+#include "benzin/core/logger.hpp"
 #include "benzin/core/math.hpp"
+#include "benzin/engine/mesh_optimizer.hpp"
+#include "benzin/engine/mesh_simplifier.hpp"
 #include "benzin/engine/scene.hpp"
 
 namespace benzin
@@ -29,7 +32,7 @@ namespace benzin
         const DirectX::XMVECTOR localNormal = DirectX::XMVector3Normalize(DirectX::XMVectorScale(DirectX::XMVectorAdd(normalLhs, normalRhs), 0.5f));
         const DirectX::XMVECTOR uv = DirectX::XMVectorScale(DirectX::XMVectorAdd(uvLhs, uvRhs), 0.5f);
 
-        MeshVertex middle;
+        MeshVertex middle{};
         DirectX::XMStoreFloat3(&middle.Position, localPosition);
         DirectX::XMStoreFloat3(&middle.Normal, localNormal);
         DirectX::XMStoreFloat2(&middle.Uv, uv);
@@ -89,6 +92,21 @@ namespace benzin
             meshData.Indices.push_back(i * 6 + 1);
             meshData.Indices.push_back(i * 6 + 4);
         }
+
+        // Every triangle gets its own vertices above, shared edges and corners are merged here
+        const VertexWeldingStats stats = WeldVertices(meshData);
+        BenzinTrace("GeometryGenerator: Subdivide, {} -> {} vertices", stats.VertexCountBefore, stats.VertexCountAfter);
+    }
+
+    static MeshData ProcessGeneratedMesh(MeshData&& meshData)
+    {
+        const MeshOptimizationStats stats = OptimizeMesh(meshData);
+        BenzinTrace("GeometryGenerator: OptimizeMesh, ACMR {:.3f} -> {:.3f}", stats.Before.GetAcmr(), stats.After.GetAcmr());
+
+        GenerateMeshLods(meshData);
+        BenzinTrace("GeometryGenerator: GenerateMeshLods, {} LODs", meshData.Lods.size());
+
+        return std::move(meshData);
     }
 
     static void GenerateCylinderTopCap(const CylinderGeometryCreation& creation, MeshData& meshData)
@@ -574,37 +592,37 @@ namespace benzin
 
     const MeshData& GetDefaultGridMesh()
     {
-        static const MeshData meshData = GenerateGrid(GridGeometryCreation
+        static const MeshData meshData = ProcessGeneratedMesh(GenerateGrid(GridGeometryCreation
         {
             .Width = 1.0f,
             .Depth = 1.0f,
             .WidthPointCount = 2,
             .DepthPointCount = 2,
-        });
+        }));
 
         return meshData;
     }
 
     const MeshData& GetDefaultCyliderMesh()
     {
-        static const MeshData meshData = GenerateCylinder(CylinderGeometryCreation
+        static const MeshData meshData = ProcessGeneratedMesh(GenerateCylinder(CylinderGeometryCreation
         {
             .TopRadius = 0.5f,
             .BottomRadius = 0.5f,
             .Height = 1.0f,
             .SliceCount = 10,
             .StackCount = 2,
-        });
+        }));
 
         return meshData;
     }
 
     const MeshData& GetDefaultGeoSphereMesh()
     {
-        static const MeshData meshData = GenerateGeosphere(GeoSphereGeometryCreation
+        static const MeshData meshData = ProcessGeneratedMesh(GenerateGeosphere(GeoSphereGeometryCreation
         {
             .Radius = 1.0f,
-        });
+        }));
 
         return meshData;
     }
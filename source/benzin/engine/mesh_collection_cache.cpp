@@ -0,0 +1,475 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/mesh_collection_cache.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/logger.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    static constexpr uint32_t g_CacheFileMagic = 0x434d'5a42; // "BZMC"
+    static constexpr uint32_t g_TextureCacheFileMagic = 0x4354'5a42; // "BZTC"
+    static constexpr uint32_t g_CacheFileVersion = 10;
+    static constexpr uint32_t g_TextureCacheFileVersion = 1; // Separate, so mesh collection changes don't invalidate baked textures. Bump both on 'WriteTextureImage' changes
+
+    // Arrays are aligned, so that vertices, indices and images are used right from the mapped view
+    static constexpr size_t g_CacheArrayAlignment = 16;
+
+    struct CacheFileHeader
+    {
+        uint32_t Magic = g_CacheFileMagic;
+        uint32_t Version = g_CacheFileVersion;
+        uint64_t SourceHash = 0;
+
+        uint32_t MeshCount = 0;
+        uint32_t MeshInstanceCount = 0;
+        uint32_t MaterialCount = 0;
+        uint32_t TextureImageCount = 0;
+    };
+
+    struct CacheTextureFileHeader
+    {
+        uint32_t Magic = g_TextureCacheFileMagic;
+        uint32_t Version = g_TextureCacheFileVersion;
+        uint64_t SourceHash = 0;
+    };
+
+    struct CacheMeshHeader
+    {
+        uint32_t VertexCount = 0;
+        uint32_t IndexCount = 0;
+        uint32_t LodCount = 0;
+        PrimitiveTopology PrimitiveTopology = PrimitiveTopology::Unknown;
+        uint32_t HasBoundingBox = 0;
+        DirectX::XMFLOAT3 BoundingBoxCenter{ 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 BoundingBoxExtents{ 0.0f, 0.0f, 0.0f };
+    };
+
+    struct CacheMeshInstance
+    {
+        uint32_t MeshIndex = g_InvalidIndex<uint32_t>;
+        uint32_t MaterialIndex = g_InvalidIndex<uint32_t>;
+        uint32_t NodeIndex = g_InvalidIndex<uint32_t>;
+        DirectX::XMFLOAT4X4 Transform;
+    };
+
+    struct CacheTextureImageHeader
+    {
+        GraphicsFormat Format = GraphicsFormat::Unknown;
+        uint32_t IsCubeMap = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t MipCount = 0;
+        uint32_t __UnusedPadding0 = 0;
+        uint64_t ImageDataSize = 0;
+    };
+
+    // Headers are written as raw bytes, so implicit padding would leak uninitialized memory into the file and identical inputs would give different files
+    static_assert(sizeof(CacheFileHeader) == 32);
+    static_assert(sizeof(CacheTextureFileHeader) == 16);
+    static_assert(sizeof(CacheMeshHeader) == 44);
+    static_assert(sizeof(CacheMeshInstance) == 76);
+    static_assert(sizeof(CacheTextureImageHeader) == 32);
+    static_assert(sizeof(Material) == 64);
+    static_assert(sizeof(MeshNode) == 40);
+
+    class CacheWriter
+    {
+    public:
+        auto& GetData() const { return m_Data; }
+
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        void Write(const T& value)
+        {
+            WriteBytes(std::as_bytes(std::span{ &value, 1 }));
+        }
+
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        void WriteArray(std::span<const T> values)
+        {
+            Write((uint64_t)values.size());
+            Align();
+            WriteBytes(std::as_bytes(values));
+        }
+
+        void WriteString(std::string_view string)
+        {
+            WriteArray(std::span{ string.data(), string.size() });
+        }
+
+    private:
+        void WriteBytes(std::span<const std::byte> bytes)
+        {
+            m_Data.insert(m_Data.end(), bytes.begin(), bytes.end());
+        }
+
+        void Align()
+        {
+            m_Data.resize(AlignAbove(m_Data.size(), g_CacheArrayAlignment));
+        }
+
+    private:
+        std::vector<std::byte> m_Data;
+    };
+
+    class CacheReader
+    {
+    public:
+        explicit CacheReader(std::span<const std::byte> data)
+            : m_Data{ data }
+        {}
+
+    public:
+        bool IsFailed() const { return m_IsFailed; }
+        bool IsFinished() const { return m_Offset == m_Data.size(); }
+
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        T Read()
+        {
+            T value{};
+
+            if (const auto bytes = ReadBytes(sizeof(T)); !bytes.empty())
+            {
+                memcpy(&value, bytes.data(), sizeof(T));
+            }
+
+            return value;
+        }
+
+        template <typename T> requires std::is_trivially_copyable_v<T>
+        void ReadArray(std::vector<T>& outValues)
+        {
+            const auto count = Read<uint64_t>();
+            Align();
+
+            if (count > (m_Data.size() - m_Offset) / sizeof(T))
+            {
+                m_IsFailed = true;
+                return;
+            }
+
+            if (const auto bytes = ReadBytes(count * sizeof(T)); !bytes.empty())
+            {
+                outValues.resize(count);
+                memcpy(outValues.data(), bytes.data(), bytes.size());
+            }
+        }
+
+        // Returns a view into the read data without copying, so the data must outlive the result
+        template <typename T> requires std::is_trivially_copyable_v<T> && (alignof(T) <= g_CacheArrayAlignment)
+        std::span<const T> ReadArrayView()
+        {
+            const auto count = Read<uint64_t>();
+            Align();
+
+            if (count > (m_Data.size() - m_Offset) / sizeof(T))
+            {
+                m_IsFailed = true;
+                return {};
+            }
+
+            const auto bytes = ReadBytes(count * sizeof(T));
+            if (bytes.empty())
+            {
+                return {};
+            }
+
+            if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(T) != 0)
+            {
+                m_IsFailed = true;
+                return {};
+            }
+
+            return { reinterpret_cast<const T*>(bytes.data()), (size_t)count };
+        }
+
+        void ReadString(std::string& outString)
+        {
+            const auto count = Read<uint64_t>();
+            Align();
+
+            if (const auto bytes = ReadBytes(count); !bytes.empty())
+            {
+                outString.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            }
+        }
+
+    private:
+        std::span<const std::byte> ReadBytes(size_t sizeInBytes)
+        {
+            if (m_IsFailed || sizeInBytes > m_Data.size() - m_Offset)
+            {
+                m_IsFailed = true;
+                return {};
+            }
+
+            const auto bytes = m_Data.subspan(m_Offset, sizeInBytes);
+            m_Offset += sizeInBytes;
+
+            return bytes;
+        }
+
+        void Align()
+        {
+            m_Offset = std::min(AlignAbove(m_Offset, g_CacheArrayAlignment), m_Data.size());
+        }
+
+    private:
+        std::span<const std::byte> m_Data;
+        size_t m_Offset = 0;
+        bool m_IsFailed = false;
+    };
+
+    static void WriteTextureImage(CacheWriter& writer, const TextureImage& textureImage)
+    {
+        writer.WriteString(textureImage.DebugName);
+        writer.Write(CacheTextureImageHeader
+        {
+            .Format = textureImage.Format,
+            .IsCubeMap = textureImage.IsCubeMap,
+            .Width = textureImage.Width,
+            .Height = textureImage.Height,
+            .MipCount = textureImage.MipCount,
+            .ImageDataSize = textureImage.GetImageData().size(),
+        });
+        writer.WriteArray(textureImage.GetImageData());
+    }
+
+    // Image data is left in the reader data, see 'TextureImage::ExternalImageData'
+    static void ReadTextureImage(CacheReader& reader, TextureImage& outTextureImage)
+    {
+        reader.ReadString(outTextureImage.DebugName);
+
+        const auto textureImageHeader = reader.Read<CacheTextureImageHeader>();
+        outTextureImage.Format = textureImageHeader.Format;
+        outTextureImage.IsCubeMap = textureImageHeader.IsCubeMap;
+        outTextureImage.Width = textureImageHeader.Width;
+        outTextureImage.Height = textureImageHeader.Height;
+        outTextureImage.MipCount = textureImageHeader.MipCount;
+
+        outTextureImage.ExternalImageData = reader.ReadArrayView<std::byte>();
+    }
+
+    static bool WriteCacheFile(const std::filesystem::path& cacheFilePath, const CacheWriter& writer)
+    {
+        // Write to a temporary file first, so a crash in the middle never leaves a truncated cache behind
+        std::filesystem::path temporaryFilePath = cacheFilePath;
+        temporaryFilePath += ".tmp";
+
+        WriteToFile(temporaryFilePath, writer.GetData());
+
+        std::error_code errorCode;
+        std::filesystem::rename(temporaryFilePath, cacheFilePath, errorCode);
+
+        BenzinWarningIf(errorCode, "MeshCollectionCache: Failed to write {}. {}", cacheFilePath.string(), errorCode.message());
+        return !errorCode;
+    }
+
+    //
+
+    bool SaveMeshCollectionToCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, const MeshCollectionResource& meshCollection)
+    {
+        CacheWriter writer;
+
+        writer.Write(CacheFileHeader
+        {
+            .SourceHash = sourceHash,
+            .MeshCount = (uint32_t)meshCollection.Meshes.size(),
+            .MeshInstanceCount = (uint32_t)meshCollection.MeshInstances.size(),
+            .MaterialCount = (uint32_t)meshCollection.Materials.size(),
+            .TextureImageCount = (uint32_t)meshCollection.TextureImages.size(),
+        });
+
+        writer.WriteString(meshCollection.DebugName);
+
+        for (const auto& mesh : meshCollection.Meshes)
+        {
+            CacheMeshHeader meshHeader
+            {
+                .VertexCount = (uint32_t)mesh.GetVertices().size(),
+                .IndexCount = (uint32_t)mesh.GetIndices().size(),
+                .LodCount = (uint32_t)mesh.Lods.size(),
+                .PrimitiveTopology = mesh.PrimitiveTopology,
+                .HasBoundingBox = mesh.BoundingBox.has_value(),
+            };
+
+            if (mesh.BoundingBox)
+            {
+                meshHeader.BoundingBoxCenter = mesh.BoundingBox->Center;
+                meshHeader.BoundingBoxExtents = mesh.BoundingBox->Extents;
+            }
+
+            writer.Write(meshHeader);
+            writer.WriteArray(mesh.GetVertices());
+            writer.WriteArray(mesh.GetIndices());
+            writer.WriteArray(mesh.GetPackedVertices());
+
+            for (const auto& lod : mesh.Lods)
+            {
+                writer.Write(lod.Error);
+                writer.WriteArray(lod.GetIndices());
+            }
+        }
+
+        for (const auto& meshInstance : meshCollection.MeshInstances)
+        {
+            CacheMeshInstance cacheMeshInstance
+            {
+                .MeshIndex = meshInstance.MeshIndex,
+                .MaterialIndex = meshInstance.MaterialIndex,
+                .NodeIndex = meshInstance.NodeIndex,
+            };
+            DirectX::XMStoreFloat4x4(&cacheMeshInstance.Transform, meshInstance.Transform);
+
+            writer.Write(cacheMeshInstance);
+        }
+
+        writer.WriteArray(std::span{ meshCollection.MeshNodes });
+
+        writer.WriteArray(std::span{ meshCollection.Materials });
+
+        for (const auto& textureImage : meshCollection.TextureImages)
+        {
+            WriteTextureImage(writer, textureImage);
+        }
+
+        return WriteCacheFile(cacheFilePath, writer);
+    }
+
+    bool LoadMeshCollectionFromCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, MeshCollectionResource& outMeshCollection)
+    {
+        if (!std::filesystem::exists(cacheFilePath))
+        {
+            return false;
+        }
+
+        // Vertices, indices and images aren't copied, they are used right from the mapping, which lives as long as the collection
+        auto mappedFile = std::make_shared<const MappedFile>(cacheFilePath);
+        if (!mappedFile->IsValid())
+        {
+            return false;
+        }
+
+        CacheReader reader{ mappedFile->GetData() };
+
+        const auto fileHeader = reader.Read<CacheFileHeader>();
+        if (reader.IsFailed() || fileHeader.Magic != g_CacheFileMagic || fileHeader.Version != g_CacheFileVersion || fileHeader.SourceHash != sourceHash)
+        {
+            BenzinTrace("MeshCollectionCache: {} is stale", cacheFilePath.string());
+            return false;
+        }
+
+        MeshCollectionResource meshCollection;
+        reader.ReadString(meshCollection.DebugName);
+
+        meshCollection.Meshes.resize(fileHeader.MeshCount);
+        for (auto& mesh : meshCollection.Meshes)
+        {
+            const auto meshHeader = reader.Read<CacheMeshHeader>();
+
+            mesh.PrimitiveTopology = meshHeader.PrimitiveTopology;
+            if (meshHeader.HasBoundingBox)
+            {
+                mesh.BoundingBox = DirectX::BoundingBox{ meshHeader.BoundingBoxCenter, meshHeader.BoundingBoxExtents };
+            }
+
+            mesh.MappedVertices = reader.ReadArrayView<joint::MeshVertex>();
+            mesh.MappedIndices = reader.ReadArrayView<uint32_t>();
+            mesh.MappedPackedVertices = reader.ReadArrayView<joint::PackedMeshVertex>();
+
+            for (uint32_t i = 0; i < meshHeader.LodCount && !reader.IsFailed(); ++i)
+            {
+                auto& lod = mesh.Lods.emplace_back();
+                lod.Error = reader.Read<float>();
+                lod.MappedIndices = reader.ReadArrayView<uint32_t>();
+            }
+
+            BenzinAssert(reader.IsFailed() || mesh.MappedVertices.size() == meshHeader.VertexCount);
+            BenzinAssert(reader.IsFailed() || mesh.MappedIndices.size() == meshHeader.IndexCount);
+        }
+
+        meshCollection.MeshInstances.resize(fileHeader.MeshInstanceCount);
+        for (auto& meshInstance : meshCollection.MeshInstances)
+        {
+            const auto cacheMeshInstance = reader.Read<CacheMeshInstance>();
+
+            meshInstance.MeshIndex = cacheMeshInstance.MeshIndex;
+            meshInstance.MaterialIndex = cacheMeshInstance.MaterialIndex;
+            meshInstance.NodeIndex = cacheMeshInstance.NodeIndex;
+            meshInstance.Transform = DirectX::XMLoadFloat4x4(&cacheMeshInstance.Transform);
+        }
+
+        reader.ReadArray(meshCollection.MeshNodes);
+
+        reader.ReadArray(meshCollection.Materials);
+
+        meshCollection.TextureImages.resize(fileHeader.TextureImageCount);
+        for (auto& textureImage : meshCollection.TextureImages)
+        {
+            ReadTextureImage(reader, textureImage);
+        }
+
+        if (reader.IsFailed() || !reader.IsFinished() || meshCollection.Materials.size() != fileHeader.MaterialCount)
+        {
+            BenzinWarning("MeshCollectionCache: {} is corrupted", cacheFilePath.string());
+            return false;
+        }
+
+        meshCollection.MappedCacheFile = std::move(mappedFile);
+
+        outMeshCollection = std::move(meshCollection);
+        return true;
+    }
+
+    bool SaveTextureImageToCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, const TextureImage& textureImage)
+    {
+        CacheWriter writer;
+        writer.Write(CacheTextureFileHeader{ .SourceHash = sourceHash });
+        WriteTextureImage(writer, textureImage);
+
+        return WriteCacheFile(cacheFilePath, writer);
+    }
+
+    bool LoadTextureImageFromCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, TextureImage& outTextureImage)
+    {
+        if (!std::filesystem::exists(cacheFilePath))
+        {
+            return false;
+        }
+
+        const MappedFile mappedFile{ cacheFilePath };
+        if (!mappedFile.IsValid())
+        {
+            return false;
+        }
+
+        CacheReader reader{ mappedFile.GetData() };
+
+        const auto fileHeader = reader.Read<CacheTextureFileHeader>();
+        if (reader.IsFailed() || fileHeader.Magic != g_TextureCacheFileMagic || fileHeader.Version != g_TextureCacheFileVersion || fileHeader.SourceHash != sourceHash)
+        {
+            BenzinTrace("MeshCollectionCache: {} is stale", cacheFilePath.string());
+            return false;
+        }
+
+        TextureImage textureImage;
+        ReadTextureImage(reader, textureImage);
+
+        if (reader.IsFailed() || !reader.IsFinished())
+        {
+            BenzinWarning("MeshCollectionCache: {} is corrupted", cacheFilePath.string());
+            return false;
+        }
+
+        // A standalone texture is uploaded once, so it owns a copy instead of keeping the file mapped
+        textureImage.ImageData.assign(textureImage.ExternalImageData.begin(), textureImage.ExternalImageData.end());
+        textureImage.ResetExternalImageData();
+
+        outTextureImage = std::move(textureImage);
+        return true;
+    }
+
+} // namespace benzin
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct MeshCollectionResource;
+    struct TextureImage;
+
+    // Binary snapshot of a finished 'MeshCollectionResource'
+    // The snapshot is only accepted if both format version and 'sourceHash' match, so any change in source assets or in loading flags invalidates it
+
+    bool SaveMeshCollectionToCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, const MeshCollectionResource& meshCollection);
+    bool LoadMeshCollectionFromCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, MeshCollectionResource& outMeshCollection);
+
+    // Same for a standalone baked texture, e.g. an environment cube map
+    bool SaveTextureImageToCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, const TextureImage& textureImage);
+    bool LoadTextureImageFromCacheFile(const std::filesystem::path& cacheFilePath, uint64_t sourceHash, TextureImage& outTextureImage);
+
+} // namespace benzin
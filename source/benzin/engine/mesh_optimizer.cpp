@@ -0,0 +1,653 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/mesh_optimizer.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/engine/resource_loader.hpp"
+#include "benzin/utility/hash_utils.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // FIFO cache simulation. A vertex is in the cache if it was pushed no more than 'cacheSize' pushes ago
+        class FifoCacheSimulator
+        {
+        public:
+            FifoCacheSimulator(size_t vertexCount, uint32_t cacheSize)
+                : m_CacheSize{ cacheSize }
+                , m_Timestamp{ cacheSize + 1 }
+            {
+                m_VertexTimestamps.resize(vertexCount, 0);
+            }
+
+        public:
+            bool IsReferenced(uint32_t vertexIndex) const
+            {
+                return m_VertexTimestamps[vertexIndex] != 0;
+            }
+
+            bool Access(uint32_t vertexIndex)
+            {
+                if (m_Timestamp - m_VertexTimestamps[vertexIndex] <= m_CacheSize)
+                {
+                    return true;
+                }
+
+                m_VertexTimestamps[vertexIndex] = m_Timestamp++;
+                return false;
+            }
+
+            uint32_t AccessTriangle(const uint32_t* triangle)
+            {
+                return (uint32_t)!Access(triangle[0]) + (uint32_t)!Access(triangle[1]) + (uint32_t)!Access(triangle[2]);
+            }
+
+            void Flush()
+            {
+                m_Timestamp += m_CacheSize + 1;
+            }
+
+        private:
+            uint32_t m_CacheSize = 0;
+            uint32_t m_Timestamp = 0;
+            std::vector<uint32_t> m_VertexTimestamps;
+        };
+
+        // Forsyth's scoring. The simulated cache is LRU and bigger than the real FIFO one, that is the way the algorithm is tuned
+        constexpr uint32_t g_ForsythCacheSize = 32;
+        constexpr uint32_t g_ForsythMaxValence = 32;
+
+        constexpr float g_CacheDecayPower = 1.5f;
+        constexpr float g_LastTriangleScore = 0.75f;
+        constexpr float g_ValenceBoostScale = 2.0f;
+        constexpr float g_ValenceBoostPower = 0.5f;
+
+        struct ForsythScoreTable
+        {
+            // [CachePosition + 1][Valence], CachePosition == -1 means the vertex is not in the cache
+            std::array<std::array<float, g_ForsythMaxValence + 1>, g_ForsythCacheSize + 1> Scores;
+
+            ForsythScoreTable()
+            {
+                for (int32_t cachePosition = -1; cachePosition < (int32_t)g_ForsythCacheSize; ++cachePosition)
+                {
+                    for (uint32_t valence = 0; valence <= g_ForsythMaxValence; ++valence)
+                    {
+                        Scores[cachePosition + 1][valence] = ComputeScore(cachePosition, valence);
+                    }
+                }
+            }
+
+            float Get(int32_t cachePosition, uint32_t activeTriangleCount) const
+            {
+                return Scores[cachePosition + 1][std::min(activeTriangleCount, g_ForsythMaxValence)];
+            }
+
+        private:
+            static float ComputeScore(int32_t cachePosition, uint32_t activeTriangleCount)
+            {
+                if (activeTriangleCount == 0)
+                {
+                    return -1.0f;
+                }
+
+                float score = 0.0f;
+
+                if (cachePosition >= 0)
+                {
+                    if (cachePosition < 3)
+                    {
+                        // The vertices of the last added triangle get a fixed score, so the algorithm doesn't prefer strips
+                        score = g_LastTriangleScore;
+                    }
+                    else
+                    {
+                        const float scaler = 1.0f / (g_ForsythCacheSize - 3);
+                        score = std::pow(1.0f - (cachePosition - 3) * scaler, g_CacheDecayPower);
+                    }
+                }
+
+                // Boost vertices with few remaining triangles, so lone triangles are not left behind
+                score += g_ValenceBoostScale * std::pow((float)activeTriangleCount, -g_ValenceBoostPower);
+
+                return score;
+            }
+        };
+
+        // Vertex attributes as integers, either raw float bits or grid cell coordinates
+        using VertexWeldingKey = std::array<uint32_t, sizeof(joint::MeshVertex) / sizeof(float)>;
+
+        struct VertexWeldingKeyHasher
+        {
+            size_t operator()(const VertexWeldingKey& key) const
+            {
+                return HashSpan(std::span<const uint32_t>{ key });
+            }
+        };
+
+    } // anonymous namespace
+
+    VertexCacheStats& VertexCacheStats::operator+=(const VertexCacheStats& other)
+    {
+        VertexCount += other.VertexCount;
+        TriangleCount += other.TriangleCount;
+        CacheMissCount += other.CacheMissCount;
+
+        return *this;
+    }
+
+    MeshOptimizationStats& MeshOptimizationStats::operator+=(const MeshOptimizationStats& other)
+    {
+        Before += other.Before;
+        After += other.After;
+
+        return *this;
+    }
+
+    VertexWeldingStats& VertexWeldingStats::operator+=(const VertexWeldingStats& other)
+    {
+        VertexCountBefore += other.VertexCountBefore;
+        VertexCountAfter += other.VertexCountAfter;
+
+        return *this;
+    }
+
+    VertexWeldingStats WeldVertices(MeshData& mesh, float epsilon)
+    {
+        BenzinAssert(epsilon >= 0.0f);
+        static_assert(sizeof(joint::MeshVertex) == sizeof(VertexWeldingKey)); // Every attribute is a float, there is no padding
+
+        // Meshlets, LODs and packed vertices reference vertices by index, so welding must go first
+        BenzinAssert(mesh.Meshlets.empty() && mesh.Lods.empty() && mesh.PackedVertices.empty());
+
+        VertexWeldingStats stats
+        {
+            .VertexCountBefore = mesh.Vertices.size(),
+            .VertexCountAfter = mesh.Vertices.size(),
+        };
+
+        if (mesh.Vertices.empty())
+        {
+            return stats;
+        }
+
+        const float invEpsilon = epsilon > 0.0f ? 1.0f / epsilon : 0.0f;
+        const auto GetWeldingKey = [&](const joint::MeshVertex& vertex)
+        {
+            std::array<float, std::tuple_size_v<VertexWeldingKey>> attributes;
+            memcpy(attributes.data(), &vertex, sizeof(vertex));
+
+            VertexWeldingKey key;
+            for (size_t i = 0; i < key.size(); ++i)
+            {
+                key[i] = epsilon > 0.0f ? (uint32_t)(int32_t)std::floor(attributes[i] * invEpsilon + 0.5f) : std::bit_cast<uint32_t>(attributes[i]);
+            }
+
+            return key;
+        };
+
+        std::unordered_map<VertexWeldingKey, uint32_t, VertexWeldingKeyHasher> uniqueVertexIndices;
+        uniqueVertexIndices.reserve(mesh.Vertices.size());
+
+        std::vector<uint32_t> remap(mesh.Vertices.size());
+        std::vector<joint::MeshVertex> uniqueVertices;
+        uniqueVertices.reserve(mesh.Vertices.size());
+
+        for (const auto& [i, vertex] : mesh.Vertices | std::views::enumerate)
+        {
+            const auto [it, isInserted] = uniqueVertexIndices.try_emplace(GetWeldingKey(vertex), (uint32_t)uniqueVertices.size());
+            if (isInserted)
+            {
+                uniqueVertices.push_back(vertex);
+            }
+
+            remap[i] = it->second;
+        }
+
+        if (uniqueVertices.size() == mesh.Vertices.size())
+        {
+            return stats;
+        }
+
+        for (uint32_t& index : mesh.Indices)
+        {
+            index = remap[index];
+        }
+
+        // Merged vertices are the first ones of their groups, so the bounds stay the same for the bit identical welding
+        mesh.Vertices = std::move(uniqueVertices);
+        stats.VertexCountAfter = mesh.Vertices.size();
+
+        return stats;
+    }
+
+    VertexWeldingStats WeldVertices(std::span<MeshData> meshes, float epsilon)
+    {
+        std::vector<VertexWeldingStats> meshStats(meshes.size());
+
+        ParallelForEach(meshes, [&](MeshData& mesh)
+        {
+            meshStats[&mesh - meshes.data()] = WeldVertices(mesh, epsilon);
+        });
+
+        VertexWeldingStats stats;
+        for (const VertexWeldingStats& stat : meshStats)
+        {
+            stats += stat;
+        }
+
+        return stats;
+    }
+
+    VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+    {
+        BenzinAssert(indices.size() % 3 == 0);
+
+        VertexCacheStats stats
+        {
+            .TriangleCount = (uint32_t)(indices.size() / 3),
+        };
+
+        FifoCacheSimulator cache{ vertexCount, cacheSize };
+        for (const uint32_t index : indices)
+        {
+            if (!cache.Access(index))
+            {
+                ++stats.CacheMissCount;
+            }
+        }
+
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            if (cache.IsReferenced(i))
+            {
+                ++stats.VertexCount;
+            }
+        }
+
+        return stats;
+    }
+
+    void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount)
+    {
+        BenzinAssert(indices.size() % 3 == 0);
+
+        static const ForsythScoreTable scoreTable;
+
+        const auto triangleCount = (uint32_t)(indices.size() / 3);
+        if (triangleCount == 0)
+        {
+            return;
+        }
+
+        // Vertex to triangles adjacency. Triangles of a vertex are stored in [offset, offset + activeTriangleCount) range,
+        // so added triangles are removed by swapping with the last active one
+        std::vector<uint32_t> activeTriangleCounts(vertexCount, 0);
+        for (const uint32_t index : indices)
+        {
+            BenzinAssert(index < vertexCount);
+            ++activeTriangleCounts[index];
+        }
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            adjacencyOffsets[i + 1] = adjacencyOffsets[i] + activeTriangleCounts[i];
+        }
+
+        std::vector<uint32_t> adjacentTriangles(indices.size());
+        {
+            std::vector<uint32_t> fillCounts(vertexCount, 0);
+
+            for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+            {
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    const uint32_t vertexIndex = indices[triangleIndex * 3 + i];
+                    adjacentTriangles[adjacencyOffsets[vertexIndex] + fillCounts[vertexIndex]++] = triangleIndex;
+                }
+            }
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            vertexScores[i] = scoreTable.Get(-1, activeTriangleCounts[i]);
+        }
+
+        const auto ComputeTriangleScore = [&](uint32_t triangleIndex)
+        {
+            const uint32_t* triangle = &indices[triangleIndex * 3];
+            return vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+        };
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<uint8_t> isTriangleAdded(triangleCount, false);
+
+        uint32_t bestTriangleIndex = 0;
+        for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+        {
+            triangleScores[triangleIndex] = ComputeTriangleScore(triangleIndex);
+
+            if (triangleScores[triangleIndex] > triangleScores[bestTriangleIndex])
+            {
+                bestTriangleIndex = triangleIndex;
+            }
+        }
+
+        std::vector<uint32_t> optimizedIndices;
+        optimizedIndices.reserve(indices.size());
+
+        std::array<uint32_t, g_ForsythCacheSize + 3> cache;
+        std::array<uint32_t, g_ForsythCacheSize + 3> newCache;
+        size_t cacheCount = 0;
+
+        uint32_t deadEndSearchStart = 0;
+
+        for (uint32_t addedTriangleCount = 0; addedTriangleCount < triangleCount; ++addedTriangleCount)
+        {
+            if (!IsValidIndex(bestTriangleIndex))
+            {
+                // Dead end, there is no triangle around cached vertices. Continue from the first not added triangle in input order
+                while (isTriangleAdded[deadEndSearchStart])
+                {
+                    ++deadEndSearchStart;
+                }
+
+                bestTriangleIndex = deadEndSearchStart;
+            }
+
+            const std::array<uint32_t, 3> triangle{ indices[bestTriangleIndex * 3 + 0], indices[bestTriangleIndex * 3 + 1], indices[bestTriangleIndex * 3 + 2] };
+
+            optimizedIndices.append_range(triangle);
+            isTriangleAdded[bestTriangleIndex] = true;
+
+            // Remove the triangle from adjacency of its vertices
+            for (const uint32_t vertexIndex : triangle)
+            {
+                const auto begin = adjacentTriangles.begin() + adjacencyOffsets[vertexIndex];
+                const auto end = begin + activeTriangleCounts[vertexIndex];
+
+                const auto it = std::find(begin, end, bestTriangleIndex);
+                BenzinAssert(it != end);
+
+                std::iter_swap(it, end - 1);
+                --activeTriangleCounts[vertexIndex];
+            }
+
+            // Update LRU cache: the triangle vertices go to the front, the rest are shifted
+            size_t newCacheCount = 0;
+            for (const uint32_t vertexIndex : triangle)
+            {
+                newCache[newCacheCount++] = vertexIndex;
+            }
+
+            for (size_t i = 0; i < cacheCount; ++i)
+            {
+                const uint32_t vertexIndex = cache[i];
+
+                if (vertexIndex != triangle[0] && vertexIndex != triangle[1] && vertexIndex != triangle[2])
+                {
+                    newCache[newCacheCount++] = vertexIndex;
+                }
+            }
+
+            for (size_t i = g_ForsythCacheSize; i < newCacheCount; ++i)
+            {
+                const uint32_t evictedVertexIndex = newCache[i];
+
+                cachePositions[evictedVertexIndex] = -1;
+                vertexScores[evictedVertexIndex] = scoreTable.Get(-1, activeTriangleCounts[evictedVertexIndex]);
+            }
+
+            cacheCount = std::min<size_t>(newCacheCount, g_ForsythCacheSize);
+            std::swap(cache, newCache);
+
+            for (size_t i = 0; i < cacheCount; ++i)
+            {
+                const uint32_t vertexIndex = cache[i];
+
+                cachePositions[vertexIndex] = (int32_t)i;
+                vertexScores[vertexIndex] = scoreTable.Get((int32_t)i, activeTriangleCounts[vertexIndex]);
+            }
+
+            // Only triangles around cached vertices change their scores, the next triangle is picked among them
+            bestTriangleIndex = g_InvalidIndex<uint32_t>;
+            float bestTriangleScore = -std::numeric_limits<float>::max();
+
+            for (size_t i = 0; i < cacheCount; ++i)
+            {
+                const uint32_t vertexIndex = cache[i];
+                const uint32_t adjacencyOffset = adjacencyOffsets[vertexIndex];
+
+                for (uint32_t j = 0; j < activeTriangleCounts[vertexIndex]; ++j)
+                {
+                    const uint32_t triangleIndex = adjacentTriangles[adjacencyOffset + j];
+
+                    triangleScores[triangleIndex] = ComputeTriangleScore(triangleIndex);
+
+                    if (triangleScores[triangleIndex] > bestTriangleScore)
+                    {
+                        bestTriangleScore = triangleScores[triangleIndex];
+                        bestTriangleIndex = triangleIndex;
+                    }
+                }
+            }
+        }
+
+        BenzinAssert(optimizedIndices.size() == indices.size());
+        std::ranges::copy(optimizedIndices, indices.begin());
+    }
+
+    void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const joint::MeshVertex> vertices, float threshold)
+    {
+        BenzinAssert(indices.size() % 3 == 0);
+        BenzinAssert(threshold >= 1.0f);
+
+        static constexpr uint32_t cacheSize = 16;
+
+        const auto triangleCount = (uint32_t)(indices.size() / 3);
+        if (triangleCount == 0)
+        {
+            return;
+        }
+
+        // Hard boundaries: the cache is effectively flushed, all three vertices of the triangle miss
+        // Reordering clusters split by hard boundaries doesn't change ACMR at all
+        std::vector<uint32_t> hardClusterStarts;
+        {
+            FifoCacheSimulator cache{ vertices.size(), cacheSize };
+
+            for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+            {
+                const uint32_t missCount = cache.AccessTriangle(&indices[triangleIndex * 3]);
+
+                if (triangleIndex == 0 || missCount == 3)
+                {
+                    hardClusterStarts.push_back(triangleIndex);
+                }
+            }
+        }
+
+        // Soft boundaries: split hard clusters further as long as ACMR of the split part stays within 'threshold'
+        std::vector<uint32_t> clusterStarts;
+        {
+            FifoCacheSimulator cache{ vertices.size(), cacheSize };
+
+            for (size_t i = 0; i < hardClusterStarts.size(); ++i)
+            {
+                const uint32_t start = hardClusterStarts[i];
+                const uint32_t end = i + 1 < hardClusterStarts.size() ? hardClusterStarts[i + 1] : triangleCount;
+
+                uint32_t clusterMissCount = 0;
+                cache.Flush();
+
+                for (uint32_t triangleIndex = start; triangleIndex < end; ++triangleIndex)
+                {
+                    clusterMissCount += cache.AccessTriangle(&indices[triangleIndex * 3]);
+                }
+
+                const float targetAcmr = threshold * clusterMissCount / (end - start);
+
+                clusterStarts.push_back(start);
+
+                uint32_t runningMissCount = 0;
+                uint32_t runningStart = start;
+                cache.Flush();
+
+                for (uint32_t triangleIndex = start; triangleIndex < end; ++triangleIndex)
+                {
+                    runningMissCount += cache.AccessTriangle(&indices[triangleIndex * 3]);
+
+                    const float runningAcmr = (float)runningMissCount / (triangleIndex - runningStart + 1);
+
+                    if (triangleIndex + 1 < end && runningAcmr <= targetAcmr)
+                    {
+                        runningStart = triangleIndex + 1;
+                        runningMissCount = 0;
+                        cache.Flush();
+
+                        clusterStarts.push_back(runningStart);
+                    }
+                }
+            }
+        }
+
+        const auto clusterCount = (uint32_t)clusterStarts.size();
+        const auto GetClusterEnd = [&](uint32_t clusterIndex)
+        {
+            return clusterIndex + 1 < clusterCount ? clusterStarts[clusterIndex + 1] : triangleCount;
+        };
+
+        // Area weighted centroids and normals
+        struct ClusterInfo
+        {
+            DirectX::XMVECTOR Centroid = DirectX::XMVectorZero();
+            DirectX::XMVECTOR Normal = DirectX::XMVectorZero();
+            float Area = 0.0f;
+        };
+
+        std::vector<ClusterInfo> clusterInfos(clusterCount);
+        DirectX::XMVECTOR meshCentroid = DirectX::XMVectorZero();
+        float meshArea = 0.0f;
+
+        for (uint32_t clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+        {
+            ClusterInfo& clusterInfo = clusterInfos[clusterIndex];
+
+            for (uint32_t triangleIndex = clusterStarts[clusterIndex]; triangleIndex < GetClusterEnd(clusterIndex); ++triangleIndex)
+            {
+                const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[indices[triangleIndex * 3 + 0]].Position);
+                const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&vertices[indices[triangleIndex * 3 + 1]].Position);
+                const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&vertices[indices[triangleIndex * 3 + 2]].Position);
+
+                const DirectX::XMVECTOR doubleAreaNormal = DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+                const float area = 0.5f * DirectX::XMVectorGetX(DirectX::XMVector3Length(doubleAreaNormal));
+                const DirectX::XMVECTOR triangleCentroid = DirectX::XMVectorScale(DirectX::XMVectorAdd(DirectX::XMVectorAdd(p0, p1), p2), 1.0f / 3.0f);
+
+                clusterInfo.Centroid = DirectX::XMVectorAdd(clusterInfo.Centroid, DirectX::XMVectorScale(triangleCentroid, area));
+                clusterInfo.Normal = DirectX::XMVectorAdd(clusterInfo.Normal, doubleAreaNormal);
+                clusterInfo.Area += area;
+            }
+
+            meshCentroid = DirectX::XMVectorAdd(meshCentroid, clusterInfo.Centroid);
+            meshArea += clusterInfo.Area;
+        }
+
+        if (meshArea == 0.0f)
+        {
+            return;
+        }
+
+        meshCentroid = DirectX::XMVectorScale(meshCentroid, 1.0f / meshArea);
+
+        // Clusters that face away from the center are likely to be in front of the others, so they are drawn first
+        std::vector<float> clusterSortKeys(clusterCount, 0.0f);
+        for (uint32_t clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+        {
+            const ClusterInfo& clusterInfo = clusterInfos[clusterIndex];
+
+            if (clusterInfo.Area == 0.0f)
+            {
+                continue;
+            }
+
+            const DirectX::XMVECTOR clusterCentroid = DirectX::XMVectorScale(clusterInfo.Centroid, 1.0f / clusterInfo.Area);
+            const DirectX::XMVECTOR clusterNormal = DirectX::XMVector3Normalize(clusterInfo.Normal);
+
+            clusterSortKeys[clusterIndex] = DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMVectorSubtract(clusterCentroid, meshCentroid), clusterNormal));
+        }
+
+        std::vector<uint32_t> clusterOrder(clusterCount);
+        std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+        std::ranges::stable_sort(clusterOrder, std::greater{}, [&](uint32_t clusterIndex) { return clusterSortKeys[clusterIndex]; });
+
+        std::vector<uint32_t> optimizedIndices;
+        optimizedIndices.reserve(indices.size());
+
+        for (const uint32_t clusterIndex : clusterOrder)
+        {
+            const auto clusterIndices = indices.subspan(clusterStarts[clusterIndex] * 3, (GetClusterEnd(clusterIndex) - clusterStarts[clusterIndex]) * 3);
+            optimizedIndices.append_range(clusterIndices);
+        }
+
+        BenzinAssert(optimizedIndices.size() == indices.size());
+        std::ranges::copy(optimizedIndices, indices.begin());
+    }
+
+    void OptimizeVertexFetch(MeshData& mesh)
+    {
+        std::vector<uint32_t> remap(mesh.Vertices.size(), g_InvalidIndex<uint32_t>);
+
+        std::vector<joint::MeshVertex> optimizedVertices;
+        optimizedVertices.reserve(mesh.Vertices.size());
+
+        for (uint32_t& index : mesh.Indices)
+        {
+            if (!IsValidIndex(remap[index]))
+            {
+                remap[index] = (uint32_t)optimizedVertices.size();
+                optimizedVertices.push_back(mesh.Vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        // Unreferenced vertices are kept at the end, so the vertex count and the bounds stay the same
+        for (const auto& [i, vertex] : mesh.Vertices | std::views::enumerate)
+        {
+            if (!IsValidIndex(remap[i]))
+            {
+                optimizedVertices.push_back(vertex);
+            }
+        }
+
+        mesh.Vertices = std::move(optimizedVertices);
+    }
+
+    MeshOptimizationStats OptimizeMesh(MeshData& mesh)
+    {
+        if (mesh.PrimitiveTopology != PrimitiveTopology::TriangleList)
+        {
+            return {};
+        }
+
+        MeshOptimizationStats stats;
+        stats.Before = AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+
+        OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+        OptimizeOverdraw(mesh.Indices, mesh.Vertices);
+        OptimizeVertexFetch(mesh);
+
+        stats.After = AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+
+        return stats;
+    }
+
+} // namespace benzin
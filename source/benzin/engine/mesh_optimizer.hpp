@@ -0,0 +1,71 @@
+#pragma once
+
+namespace joint
+{
+
+    struct MeshVertex;
+
+} // namespace joint
+
+namespace benzin
+{
+
+    struct MeshData;
+
+    struct VertexCacheStats
+    {
+        uint32_t VertexCount = 0;
+        uint32_t TriangleCount = 0;
+        uint32_t CacheMissCount = 0; // Vertex shader invocations
+
+        // Average cache miss ratio. 3.0 is the worst, 0.5 is the best possible for a regular grid
+        float GetAcmr() const { return TriangleCount != 0 ? (float)CacheMissCount / TriangleCount : 0.0f; }
+
+        // Average transformed vertex ratio. 1.0 is the best, every vertex is shaded once
+        float GetAtvr() const { return VertexCount != 0 ? (float)CacheMissCount / VertexCount : 0.0f; }
+
+        VertexCacheStats& operator+=(const VertexCacheStats& other);
+    };
+
+    struct MeshOptimizationStats
+    {
+        VertexCacheStats Before;
+        VertexCacheStats After;
+
+        MeshOptimizationStats& operator+=(const MeshOptimizationStats& other);
+    };
+
+    struct VertexWeldingStats
+    {
+        size_t VertexCountBefore = 0;
+        size_t VertexCountAfter = 0;
+
+        VertexWeldingStats& operator+=(const VertexWeldingStats& other);
+    };
+
+    // Merges duplicate vertices and remaps indices. With zero 'epsilon' only bit identical vertices are merged,
+    // otherwise attributes are snapped to a grid with 'epsilon' cell size, so close vertices in different cells stay apart
+    VertexWeldingStats WeldVertices(MeshData& mesh, float epsilon = 0.0f);
+
+    // Welds every mesh on all cores
+    VertexWeldingStats WeldVertices(std::span<MeshData> meshes, float epsilon = 0.0f);
+
+    // Simulates FIFO post-transform cache, which is a good approximation of modern hardware
+    VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+    // Reorders triangles for post-transform cache locality
+    // Ref: Tom Forsyth, Linear-Speed Vertex Cache Optimisation: https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+    void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount);
+
+    // Reorders clusters of already cache optimized triangles from outer to inner ones, so the earlier triangles occlude the later ones
+    // 'threshold' limits how much ACMR is allowed to grow because of splitting into smaller clusters
+    // Ref: Sander, Nehab, Barczak, Fast Triangle Reordering for Vertex Locality and Reduced Overdraw
+    void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const joint::MeshVertex> vertices, float threshold = 1.05f);
+
+    // Reorders vertices in order of the first use by indices, so vertex fetch is as linear as possible
+    void OptimizeVertexFetch(MeshData& mesh);
+
+    // Runs all the stages above. Only triangle lists are optimized, other topologies are left as is
+    MeshOptimizationStats OptimizeMesh(MeshData& mesh);
+
+} // namespace benzin
@@ -0,0 +1,539 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/mesh_simplifier.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/math.hpp"
+#include "benzin/engine/mesh_optimizer.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // Symmetric 4x4 matrix of the sum of squared distances to planes. Planes are weighted by triangle area,
+        // so 'Evaluate / Weight' is the average squared distance
+        struct Quadric
+        {
+            double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+            double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+            double C = 0.0;
+            double Weight = 0.0;
+
+            static Quadric FromPlane(const DirectX::XMFLOAT3& normal, float distance, float weight)
+            {
+                const double a = normal.x;
+                const double b = normal.y;
+                const double c = normal.z;
+                const double d = distance;
+
+                return Quadric
+                {
+                    .A00 = weight * a * a, .A01 = weight * a * b, .A02 = weight * a * c,
+                    .A11 = weight * b * b, .A12 = weight * b * c,
+                    .A22 = weight * c * c,
+                    .B0 = weight * a * d, .B1 = weight * b * d, .B2 = weight * c * d,
+                    .C = weight * d * d,
+                    .Weight = weight,
+                };
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                A00 += other.A00; A01 += other.A01; A02 += other.A02;
+                A11 += other.A11; A12 += other.A12;
+                A22 += other.A22;
+                B0 += other.B0; B1 += other.B1; B2 += other.B2;
+                C += other.C;
+                Weight += other.Weight;
+
+                return *this;
+            }
+
+            double Evaluate(const DirectX::XMFLOAT3& position) const
+            {
+                const double x = position.x;
+                const double y = position.y;
+                const double z = position.z;
+
+                const double result =
+                    A00 * x * x + 2.0 * A01 * x * y + 2.0 * A02 * x * z +
+                    A11 * y * y + 2.0 * A12 * y * z +
+                    A22 * z * z +
+                    2.0 * (B0 * x + B1 * y + B2 * z) +
+                    C;
+
+                return std::max(result, 0.0);
+            }
+        };
+
+        struct PositionKey
+        {
+            uint32_t X = 0;
+            uint32_t Y = 0;
+            uint32_t Z = 0;
+
+            bool operator==(const PositionKey&) const = default;
+        };
+
+        struct PositionKeyHasher
+        {
+            size_t operator()(const PositionKey& key) const
+            {
+                size_t hash = 0;
+                hash = HashCombine(hash, key.X);
+                hash = HashCombine(hash, key.Y);
+                hash = HashCombine(hash, key.Z);
+
+                return hash;
+            }
+        };
+
+        struct EdgeCollapse
+        {
+            float Error = 0.0f;
+            uint32_t SourceVertexIndex = 0; // Removed vertex
+            uint32_t TargetVertexIndex = 0;
+        };
+
+        DirectX::XMVECTOR ComputeTriangleNormal(std::span<const joint::MeshVertex> vertices, uint32_t i0, uint32_t i1, uint32_t i2)
+        {
+            const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[i0].Position);
+            const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&vertices[i1].Position);
+            const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&vertices[i2].Position);
+
+            return DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+        }
+
+        // Rejects normal changes over ~75 degrees instead of 90, otherwise a series of collapses close to 90 degrees
+        // folds triangles edge-on along seams and creases
+        // Ref: meshoptimizer, hasTriangleFlip
+        bool IsTriangleFlipped(DirectX::FXMVECTOR oldNormal, DirectX::FXMVECTOR newNormal)
+        {
+            const float dot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(oldNormal, newNormal));
+            const float lengthProduct = DirectX::XMVectorGetX(DirectX::XMVector3Length(oldNormal)) * DirectX::XMVectorGetX(DirectX::XMVector3Length(newNormal));
+
+            return dot <= 0.25f * lengthProduct;
+        }
+
+        uint64_t GetEdgeKey(uint32_t a, uint32_t b)
+        {
+            return (uint64_t)std::min(a, b) << 32 | std::max(a, b);
+        }
+
+    } // anonymous namespace
+
+    float SimplifyMesh(
+        std::span<const joint::MeshVertex> vertices,
+        std::span<const uint32_t> indices,
+        size_t targetIndexCount,
+        float maxError,
+        std::vector<uint32_t>& outIndices
+    )
+    {
+        BenzinAssert(indices.size() % 3 == 0);
+
+        outIndices.assign(indices.begin(), indices.end());
+
+        const auto vertexCount = (uint32_t)vertices.size();
+        if (outIndices.size() <= targetIndexCount || vertexCount == 0)
+        {
+            return 0.0f;
+        }
+
+        // Vertices with equal positions form one position. Quadrics and topology are tracked per position,
+        // so attribute seams don't look like open borders
+        std::vector<uint32_t> positionIndices(vertexCount);
+        std::vector<uint32_t> positionVertexOffsets;
+        std::vector<uint32_t> positionVertices(vertexCount); // Vertices of each position, see 'positionVertexOffsets'
+        {
+            std::unordered_map<PositionKey, uint32_t, PositionKeyHasher> positionMap;
+            positionMap.reserve(vertexCount);
+
+            std::vector<uint32_t> positionVertexCounts;
+
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                const auto& position = vertices[i].Position;
+                const PositionKey key{ std::bit_cast<uint32_t>(position.x), std::bit_cast<uint32_t>(position.y), std::bit_cast<uint32_t>(position.z) };
+
+                const auto [it, isInserted] = positionMap.try_emplace(key, (uint32_t)positionVertexCounts.size());
+                if (isInserted)
+                {
+                    positionVertexCounts.push_back(0);
+                }
+
+                positionIndices[i] = it->second;
+                ++positionVertexCounts[it->second];
+            }
+
+            positionVertexOffsets.resize(positionVertexCounts.size() + 1);
+            for (size_t i = 0; i < positionVertexCounts.size(); ++i)
+            {
+                positionVertexOffsets[i + 1] = positionVertexOffsets[i] + positionVertexCounts[i];
+            }
+
+            std::ranges::fill(positionVertexCounts, 0);
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                positionVertices[positionVertexOffsets[positionIndices[i]] + positionVertexCounts[positionIndices[i]]++] = i;
+            }
+        }
+
+        const size_t positionCount = positionVertexOffsets.size() - 1;
+
+        // Open borders and non-manifold edges are locked. A locked vertex can be a collapse target, but is never removed.
+        // Seams aren't locked, see 'FindSeamCollapse' below
+        std::vector<uint8_t> isPositionLocked(positionCount, false);
+        {
+            std::unordered_map<uint64_t, uint32_t> edgeUsageCounts;
+            edgeUsageCounts.reserve(outIndices.size());
+
+            for (size_t i = 0; i < outIndices.size(); i += 3)
+            {
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t a = positionIndices[outIndices[i + corner]];
+                    const uint32_t b = positionIndices[outIndices[i + (corner + 1) % 3]];
+
+                    ++edgeUsageCounts[GetEdgeKey(a, b)];
+                }
+            }
+
+            for (const auto& [edgeKey, usageCount] : edgeUsageCounts)
+            {
+                if (usageCount != 2)
+                {
+                    isPositionLocked[edgeKey >> 32] = true;
+                    isPositionLocked[edgeKey & 0xffff'ffff] = true;
+                }
+            }
+        }
+
+        std::vector<Quadric> quadrics(positionCount);
+        for (size_t i = 0; i < outIndices.size(); i += 3)
+        {
+            const DirectX::XMVECTOR normal = ComputeTriangleNormal(vertices, outIndices[i + 0], outIndices[i + 1], outIndices[i + 2]);
+            const float doubleArea = DirectX::XMVectorGetX(DirectX::XMVector3Length(normal));
+
+            if (doubleArea <= std::numeric_limits<float>::epsilon())
+            {
+                continue;
+            }
+
+            DirectX::XMFLOAT3 unitNormal;
+            DirectX::XMStoreFloat3(&unitNormal, DirectX::XMVectorScale(normal, 1.0f / doubleArea));
+
+            const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[outIndices[i]].Position);
+            const float distance = -DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMLoadFloat3(&unitNormal), p0));
+
+            const Quadric quadric = Quadric::FromPlane(unitNormal, distance, 0.5f * doubleArea);
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                quadrics[positionIndices[outIndices[i + corner]]] += quadric;
+            }
+        }
+
+        const auto ComputeCollapseError = [&](uint32_t sourceVertexIndex, uint32_t targetVertexIndex)
+        {
+            Quadric quadric = quadrics[positionIndices[sourceVertexIndex]];
+            quadric += quadrics[positionIndices[targetVertexIndex]];
+
+            return quadric.Weight > 0.0 ? (float)std::sqrt(quadric.Evaluate(vertices[targetVertexIndex].Position) / quadric.Weight) : 0.0f;
+        };
+
+        std::vector<uint32_t> triangleCounts(vertexCount);
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+        std::vector<uint32_t> adjacentTriangles;
+
+        std::vector<uint32_t> remap(vertexCount);
+        std::vector<uint8_t> isTouched(vertexCount);
+
+        std::vector<EdgeCollapse> edgeCollapses;
+        std::vector<std::pair<uint32_t, uint32_t>> collapseVertexPairs; // Source and target vertices of one collapse
+
+        // All vertices of the source position move to the target position together, each one to the vertex it shares an edge with.
+        // So both sides of a seam stay connected, and a seam vertex can only slide along the seam, because elsewhere a side has no such vertex.
+        // Fails if a vertex has none or more than one candidate
+        const auto FindSeamCollapse = [&](uint32_t sourcePositionIndex, uint32_t targetPositionIndex)
+        {
+            collapseVertexPairs.clear();
+
+            for (uint32_t i = positionVertexOffsets[sourcePositionIndex]; i < positionVertexOffsets[sourcePositionIndex + 1]; ++i)
+            {
+                const uint32_t sourceVertexIndex = positionVertices[i];
+
+                // Unused vertices are left as they are
+                if (triangleCounts[sourceVertexIndex] == 0)
+                {
+                    continue;
+                }
+
+                uint32_t targetVertexIndex = g_InvalidIndex<uint32_t>;
+
+                for (const uint32_t triangleIndex : std::span{ adjacentTriangles }.subspan(adjacencyOffsets[sourceVertexIndex], triangleCounts[sourceVertexIndex]))
+                {
+                    for (uint32_t corner = 0; corner < 3; ++corner)
+                    {
+                        const uint32_t vertexIndex = outIndices[triangleIndex * 3 + corner];
+                        if (positionIndices[vertexIndex] != targetPositionIndex || vertexIndex == targetVertexIndex)
+                        {
+                            continue;
+                        }
+
+                        if (targetVertexIndex != g_InvalidIndex<uint32_t>)
+                        {
+                            return false;
+                        }
+
+                        targetVertexIndex = vertexIndex;
+                    }
+                }
+
+                if (targetVertexIndex == g_InvalidIndex<uint32_t>)
+                {
+                    return false;
+                }
+
+                collapseVertexPairs.emplace_back(sourceVertexIndex, targetVertexIndex);
+            }
+
+            return !collapseVertexPairs.empty();
+        };
+
+        float resultError = 0.0f;
+
+        // Every pass collapses a set of independent edges in order of increasing error
+        while (outIndices.size() > targetIndexCount)
+        {
+            const auto triangleCount = (uint32_t)(outIndices.size() / 3);
+
+            std::ranges::fill(triangleCounts, 0);
+            for (const uint32_t index : outIndices)
+            {
+                ++triangleCounts[index];
+            }
+
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                adjacencyOffsets[i + 1] = adjacencyOffsets[i] + triangleCounts[i];
+            }
+
+            adjacentTriangles.resize(outIndices.size());
+            std::ranges::fill(triangleCounts, 0);
+
+            for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+            {
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t vertexIndex = outIndices[triangleIndex * 3 + corner];
+                    adjacentTriangles[adjacencyOffsets[vertexIndex] + triangleCounts[vertexIndex]++] = triangleIndex;
+                }
+            }
+
+            edgeCollapses.clear();
+            for (size_t i = 0; i < outIndices.size(); i += 3)
+            {
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t a = outIndices[i + corner];
+                    const uint32_t b = outIndices[i + (corner + 1) % 3];
+
+                    if (positionIndices[a] == positionIndices[b])
+                    {
+                        continue;
+                    }
+
+                    if (!isPositionLocked[positionIndices[a]])
+                    {
+                        edgeCollapses.emplace_back(ComputeCollapseError(a, b), a, b);
+                    }
+
+                    if (!isPositionLocked[positionIndices[b]])
+                    {
+                        edgeCollapses.emplace_back(ComputeCollapseError(b, a), b, a);
+                    }
+                }
+            }
+
+            std::ranges::sort(edgeCollapses, std::less{}, &EdgeCollapse::Error);
+
+            std::iota(remap.begin(), remap.end(), 0);
+            std::ranges::fill(isTouched, false);
+
+            size_t collapseCount = 0;
+            size_t remainingIndexCount = outIndices.size();
+
+            for (const auto& [error, sourceVertexIndex, targetVertexIndex] : edgeCollapses)
+            {
+                if (error > maxError || remainingIndexCount <= targetIndexCount)
+                {
+                    break;
+                }
+
+                if (isTouched[sourceVertexIndex] || isTouched[targetVertexIndex])
+                {
+                    continue;
+                }
+
+                if (!FindSeamCollapse(positionIndices[sourceVertexIndex], positionIndices[targetVertexIndex]))
+                {
+                    continue;
+                }
+
+                const auto GetSourceTriangles = [&](uint32_t vertexIndex)
+                {
+                    return std::span{ adjacentTriangles }.subspan(adjacencyOffsets[vertexIndex], triangleCounts[vertexIndex]);
+                };
+
+                // Reject collapses, which flip or degenerate the remaining triangles
+                bool isRejected = false;
+                size_t removedTriangleCount = 0;
+
+                for (const auto& [pairSourceVertexIndex, pairTargetVertexIndex] : collapseVertexPairs)
+                {
+                    if (isTouched[pairSourceVertexIndex] || isTouched[pairTargetVertexIndex])
+                    {
+                        isRejected = true;
+                        break;
+                    }
+
+                    for (const uint32_t triangleIndex : GetSourceTriangles(pairSourceVertexIndex))
+                    {
+                        std::array<uint32_t, 3> triangle{ outIndices[triangleIndex * 3 + 0], outIndices[triangleIndex * 3 + 1], outIndices[triangleIndex * 3 + 2] };
+
+                        if (std::ranges::contains(triangle, pairTargetVertexIndex))
+                        {
+                            ++removedTriangleCount;
+                            continue;
+                        }
+
+                        const DirectX::XMVECTOR oldNormal = ComputeTriangleNormal(vertices, triangle[0], triangle[1], triangle[2]);
+                        std::ranges::replace(triangle, pairSourceVertexIndex, pairTargetVertexIndex);
+                        const DirectX::XMVECTOR newNormal = ComputeTriangleNormal(vertices, triangle[0], triangle[1], triangle[2]);
+
+                        if (IsTriangleFlipped(oldNormal, newNormal))
+                        {
+                            isRejected = true;
+                            break;
+                        }
+                    }
+
+                    if (isRejected)
+                    {
+                        break;
+                    }
+                }
+
+                if (isRejected)
+                {
+                    continue;
+                }
+
+                quadrics[positionIndices[targetVertexIndex]] += quadrics[positionIndices[sourceVertexIndex]];
+
+                for (const auto& [pairSourceVertexIndex, pairTargetVertexIndex] : collapseVertexPairs)
+                {
+                    remap[pairSourceVertexIndex] = pairTargetVertexIndex;
+
+                    // Triangles around the source vertex change, so their vertices can't take part in other collapses of this pass
+                    for (const uint32_t triangleIndex : GetSourceTriangles(pairSourceVertexIndex))
+                    {
+                        isTouched[outIndices[triangleIndex * 3 + 0]] = true;
+                        isTouched[outIndices[triangleIndex * 3 + 1]] = true;
+                        isTouched[outIndices[triangleIndex * 3 + 2]] = true;
+                    }
+                }
+
+                resultError = std::max(resultError, error);
+                remainingIndexCount -= std::min(remainingIndexCount, removedTriangleCount * 3);
+                ++collapseCount;
+            }
+
+            if (collapseCount == 0)
+            {
+                break;
+            }
+
+            size_t writeOffset = 0;
+            for (size_t i = 0; i < outIndices.size(); i += 3)
+            {
+                const uint32_t a = remap[outIndices[i + 0]];
+                const uint32_t b = remap[outIndices[i + 1]];
+                const uint32_t c = remap[outIndices[i + 2]];
+
+                if (a == b || b == c || c == a)
+                {
+                    continue;
+                }
+
+                outIndices[writeOffset++] = a;
+                outIndices[writeOffset++] = b;
+                outIndices[writeOffset++] = c;
+            }
+
+            outIndices.resize(writeOffset);
+        }
+
+        return resultError;
+    }
+
+    void GenerateMeshLods(MeshData& mesh, const MeshLodParams& params)
+    {
+        BenzinAssert(params.IndexCountRatio > 0.0f && params.IndexCountRatio < 1.0f);
+
+        mesh.Lods.clear();
+
+        if (mesh.PrimitiveTopology != PrimitiveTopology::TriangleList)
+        {
+            return;
+        }
+
+        const DirectX::BoundingBox boundingBox = mesh.BoundingBox.value_or(ComputeBoundingBox(mesh.Vertices));
+        const float maxError = params.MaxRelativeError * 2.0f * DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&boundingBox.Extents)));
+
+        std::span<const uint32_t> previousIndices = mesh.Indices;
+        float previousError = 0.0f;
+
+        while (mesh.Lods.size() < params.MaxLodCount && previousIndices.size() > params.MinIndexCount)
+        {
+            const auto targetIndexCount = (size_t)(previousIndices.size() * params.IndexCountRatio) / 3 * 3;
+
+            MeshLod lod;
+            const float error = SimplifyMesh(mesh.Vertices, previousIndices, targetIndexCount, maxError - previousError, lod.Indices);
+
+            // Stop if seams and the error limit don't let the mesh shrink noticeably
+            if (lod.Indices.empty() || lod.Indices.size() > previousIndices.size() * 0.9f)
+            {
+                break;
+            }
+
+            // Each level is simplified from the previous one, so the errors add up
+            lod.Error = previousError + error;
+            OptimizeVertexCache(lod.Indices, mesh.Vertices.size());
+
+            previousError = lod.Error;
+            mesh.Lods.push_back(std::move(lod));
+            previousIndices = mesh.Lods.back().Indices;
+        }
+    }
+
+    uint32_t SelectMeshLod(const MeshData& mesh, float distance, float meshScale, float pixelsPerUnit, float maxPixelError)
+    {
+        const float pixelsPerMeshUnit = meshScale * pixelsPerUnit / std::max(distance, std::numeric_limits<float>::epsilon());
+
+        for (auto lodIndex = (uint32_t)mesh.Lods.size(); lodIndex > 0; --lodIndex)
+        {
+            if (mesh.Lods[lodIndex - 1].Error * pixelsPerMeshUnit <= maxPixelError)
+            {
+                return lodIndex;
+            }
+        }
+
+        return 0;
+    }
+
+} // namespace benzin
@@ -0,0 +1,44 @@
+#pragma once
+
+namespace joint
+{
+
+    struct MeshVertex;
+
+} // namespace joint
+
+namespace benzin
+{
+
+    struct MeshData;
+
+    struct MeshLodParams
+    {
+        uint32_t MaxLodCount = 4; // Without the base level
+        float IndexCountRatio = 0.5f; // Target index count of a level relative to the previous one
+        float MaxRelativeError = 0.02f; // Relative to the bounding box diagonal
+        uint32_t MinIndexCount = 3 * 32; // Meshes smaller than this are not worth simplifying
+    };
+
+    // Reduces triangle count by quadric error edge collapses down to 'targetIndexCount' or until the error exceeds 'maxError'
+    // Vertices are not changed, so the result references the same vertex buffer. Vertices on open borders are kept,
+    // vertices on UV and normal seams only move along the seam together with their copies on the other side
+    // Returns the geometric error of the result in mesh units
+    // Ref: Garland, Heckbert, Surface Simplification Using Quadric Error Metrics
+    float SimplifyMesh(
+        std::span<const joint::MeshVertex> vertices,
+        std::span<const uint32_t> indices,
+        size_t targetIndexCount,
+        float maxError,
+        std::vector<uint32_t>& outIndices
+    );
+
+    // Fills 'MeshData::Lods' with a chain of simplified levels. Only triangle lists are simplified
+    void GenerateMeshLods(MeshData& mesh, const MeshLodParams& params = {});
+
+    // Picks the coarsest level, which error projected on the screen is not bigger than 'maxPixelError'
+    // 'distance' is from the camera to the mesh bounds, 'meshScale' converts mesh units to world ones
+    // 'pixelsPerUnit' is screen size in pixels of one world unit at distance one
+    uint32_t SelectMeshLod(const MeshData& mesh, float distance, float meshScale, float pixelsPerUnit, float maxPixelError = 1.0f);
+
+} // namespace benzin
@@ -0,0 +1,320 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/meshlet_builder.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/core/logger.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    // D3D12 mesh shader limits. Local vertex indices are packed by 8 bits
+    static constexpr uint32_t g_MaxMeshletVertexCount = 256;
+    static constexpr uint32_t g_MaxMeshletTriangleCount = 256;
+
+    static constexpr uint32_t g_MeshletLocalIndexBitCount = 8;
+    static constexpr uint32_t g_MeshletLocalIndexMask = (1 << g_MeshletLocalIndexBitCount) - 1;
+
+    // Cones wider than this can't cull anything useful, they are disabled
+    static constexpr float g_MinConeNormalDot = 0.1f;
+
+    static uint32_t GetMeshletVertexIndex(const MeshData& mesh, const joint::Meshlet& meshlet, uint32_t triangleIndex, uint32_t cornerIndex)
+    {
+        const uint32_t packedTriangle = mesh.MeshletTriangles[meshlet.TriangleOffset + triangleIndex];
+        const uint32_t localVertexIndex = (packedTriangle >> (cornerIndex * g_MeshletLocalIndexBitCount)) & g_MeshletLocalIndexMask;
+
+        return mesh.MeshletVertexIndices[meshlet.VertexOffset + localVertexIndex];
+    }
+
+    // Geometric normal, oriented the same way as vertex normals. So the cone doesn't depend on winding order convention
+    static bool ComputeTriangleNormal(const MeshData& mesh, const std::array<uint32_t, 3>& triangle, DirectX::XMVECTOR& outNormal)
+    {
+        const auto& v0 = mesh.GetVertices()[triangle[0]];
+        const auto& v1 = mesh.GetVertices()[triangle[1]];
+        const auto& v2 = mesh.GetVertices()[triangle[2]];
+
+        const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&v0.Position);
+        const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&v1.Position);
+        const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&v2.Position);
+
+        const DirectX::XMVECTOR normal = DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+        const float length = DirectX::XMVectorGetX(DirectX::XMVector3Length(normal));
+
+        if (length <= std::numeric_limits<float>::epsilon())
+        {
+            return false;
+        }
+
+        const DirectX::XMVECTOR vertexNormalSum = DirectX::XMVectorAdd(DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&v0.Normal), DirectX::XMLoadFloat3(&v1.Normal)), DirectX::XMLoadFloat3(&v2.Normal));
+        const float sign = DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, vertexNormalSum)) < 0.0f ? -1.0f : 1.0f;
+
+        outNormal = DirectX::XMVectorScale(normal, sign / length);
+        return true;
+    }
+
+    static std::array<uint32_t, 3> GetMeshletTriangle(const MeshData& mesh, const joint::Meshlet& meshlet, uint32_t triangleIndex)
+    {
+        return
+        {
+            GetMeshletVertexIndex(mesh, meshlet, triangleIndex, 0),
+            GetMeshletVertexIndex(mesh, meshlet, triangleIndex, 1),
+            GetMeshletVertexIndex(mesh, meshlet, triangleIndex, 2),
+        };
+    }
+
+    static void ComputeMeshletBounds(const MeshData& mesh, joint::Meshlet& meshlet)
+    {
+        std::array<DirectX::XMFLOAT3, g_MaxMeshletVertexCount> positions;
+        for (uint32_t i = 0; i < meshlet.VertexCount; ++i)
+        {
+            positions[i] = mesh.GetVertices()[mesh.MeshletVertexIndices[meshlet.VertexOffset + i]].Position;
+        }
+
+        DirectX::BoundingSphere boundingSphere;
+        DirectX::BoundingSphere::CreateFromPoints(boundingSphere, meshlet.VertexCount, positions.data(), sizeof(DirectX::XMFLOAT3));
+
+        meshlet.BoundingSphereCenter = boundingSphere.Center;
+        meshlet.BoundingSphereRadius = boundingSphere.Radius;
+
+        // Disabled cone, the test never passes
+        meshlet.ConeApex = boundingSphere.Center;
+        meshlet.ConeAxis = DirectX::XMFLOAT3{ 0.0f, 0.0f, 0.0f };
+        meshlet.ConeCutoff = 1.0f;
+
+        std::array<DirectX::XMVECTOR, g_MaxMeshletTriangleCount> triangleNormals;
+        std::array<DirectX::XMVECTOR, g_MaxMeshletTriangleCount> trianglePoints;
+        uint32_t validTriangleCount = 0;
+
+        DirectX::XMVECTOR normalSum = DirectX::XMVectorZero();
+
+        for (uint32_t i = 0; i < meshlet.TriangleCount; ++i)
+        {
+            const auto triangle = GetMeshletTriangle(mesh, meshlet, i);
+
+            DirectX::XMVECTOR normal;
+            if (!ComputeTriangleNormal(mesh, triangle, normal))
+            {
+                continue;
+            }
+
+            triangleNormals[validTriangleCount] = normal;
+            trianglePoints[validTriangleCount] = DirectX::XMLoadFloat3(&mesh.GetVertices()[triangle[0]].Position);
+            ++validTriangleCount;
+
+            normalSum = DirectX::XMVectorAdd(normalSum, normal);
+        }
+
+        if (validTriangleCount == 0 || DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(normalSum)) <= std::numeric_limits<float>::epsilon())
+        {
+            return;
+        }
+
+        const DirectX::XMVECTOR axis = DirectX::XMVector3Normalize(normalSum);
+
+        float minNormalDot = 1.0f;
+        for (uint32_t i = 0; i < validTriangleCount; ++i)
+        {
+            minNormalDot = std::min(minNormalDot, DirectX::XMVectorGetX(DirectX::XMVector3Dot(axis, triangleNormals[i])));
+        }
+
+        if (minNormalDot <= g_MinConeNormalDot)
+        {
+            return;
+        }
+
+        // The apex is the point on the axis ray through the center, which lies behind all triangle planes
+        // Ref: meshoptimizer, meshopt_computeMeshletBounds: https://github.com/zeux/meshoptimizer/blob/master/src/clusterizer.cpp
+        const DirectX::XMVECTOR center = DirectX::XMLoadFloat3(&meshlet.BoundingSphereCenter);
+
+        float maxT = 0.0f;
+        for (uint32_t i = 0; i < validTriangleCount; ++i)
+        {
+            const float centerDistance = DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMVectorSubtract(center, trianglePoints[i]), triangleNormals[i]));
+            const float axisDot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(axis, triangleNormals[i]));
+
+            maxT = std::max(maxT, centerDistance / axisDot);
+        }
+
+        DirectX::XMStoreFloat3(&meshlet.ConeApex, DirectX::XMVectorSubtract(center, DirectX::XMVectorScale(axis, maxT)));
+        DirectX::XMStoreFloat3(&meshlet.ConeAxis, axis);
+        meshlet.ConeCutoff = std::sqrt(1.0f - minNormalDot * minNormalDot);
+    }
+
+    //
+
+    void BuildMeshlets(MeshData& mesh, const MeshletBuildParams& params)
+    {
+        BenzinAssert(params.MaxVertexCount >= 3 && params.MaxVertexCount <= g_MaxMeshletVertexCount);
+        BenzinAssert(params.MaxTriangleCount >= 1 && params.MaxTriangleCount <= g_MaxMeshletTriangleCount);
+
+        mesh.Meshlets.clear();
+        mesh.MeshletVertexIndices.clear();
+        mesh.MeshletTriangles.clear();
+
+        if (mesh.PrimitiveTopology != PrimitiveTopology::TriangleList)
+        {
+            return;
+        }
+
+        BenzinAssert(mesh.GetIndices().size() % 3 == 0);
+
+        static constexpr uint16_t invalidLocalVertexIndex = g_InvalidIndex<uint16_t>;
+        std::vector<uint16_t> localVertexIndices(mesh.GetVertices().size(), invalidLocalVertexIndex);
+
+        joint::Meshlet meshlet{};
+
+        const auto FinishMeshlet = [&]
+        {
+            if (meshlet.TriangleCount == 0)
+            {
+                return;
+            }
+
+            for (uint32_t i = 0; i < meshlet.VertexCount; ++i)
+            {
+                localVertexIndices[mesh.MeshletVertexIndices[meshlet.VertexOffset + i]] = invalidLocalVertexIndex;
+            }
+
+            ComputeMeshletBounds(mesh, meshlet);
+            mesh.Meshlets.push_back(meshlet);
+
+            meshlet = joint::Meshlet
+            {
+                .VertexOffset = (uint32_t)mesh.MeshletVertexIndices.size(),
+                .TriangleOffset = (uint32_t)mesh.MeshletTriangles.size(),
+            };
+        };
+
+        for (size_t i = 0; i < mesh.GetIndices().size(); i += 3)
+        {
+            const std::array<uint32_t, 3> triangle{ mesh.GetIndices()[i + 0], mesh.GetIndices()[i + 1], mesh.GetIndices()[i + 2] };
+
+            uint32_t newVertexCount = 0;
+            for (const uint32_t vertexIndex : triangle)
+            {
+                newVertexCount += localVertexIndices[vertexIndex] == invalidLocalVertexIndex;
+            }
+
+            if (meshlet.VertexCount + newVertexCount > params.MaxVertexCount || meshlet.TriangleCount + 1 > params.MaxTriangleCount)
+            {
+                FinishMeshlet();
+            }
+
+            uint32_t packedTriangle = 0;
+            for (const auto& [cornerIndex, vertexIndex] : triangle | std::views::enumerate)
+            {
+                if (localVertexIndices[vertexIndex] == invalidLocalVertexIndex)
+                {
+                    localVertexIndices[vertexIndex] = (uint16_t)meshlet.VertexCount++;
+                    mesh.MeshletVertexIndices.push_back(vertexIndex);
+                }
+
+                packedTriangle |= (uint32_t)localVertexIndices[vertexIndex] << (cornerIndex * g_MeshletLocalIndexBitCount);
+            }
+
+            mesh.MeshletTriangles.push_back(packedTriangle);
+            ++meshlet.TriangleCount;
+        }
+
+        FinishMeshlet();
+
+#if BENZIN_IS_DEBUG_BUILD
+        BenzinAssert(ValidateMeshlets(mesh, params));
+#endif
+    }
+
+    void BuildMeshlets(std::span<MeshData> meshes, const MeshletBuildParams& params)
+    {
+        ParallelForEach(meshes, [&](MeshData& mesh)
+        {
+            BuildMeshlets(mesh, params);
+        });
+    }
+
+    bool ValidateMeshlets(const MeshData& mesh, const MeshletBuildParams& params)
+    {
+        static constexpr float tolerance = 1e-4f;
+
+        size_t indexOffset = 0;
+
+        for (const auto& [meshletIndex, meshlet] : mesh.Meshlets | std::views::enumerate)
+        {
+            const auto Fail = [&](std::string_view reason)
+            {
+                BenzinWarning("MeshletBuilder: Meshlet {} is invalid. {}", meshletIndex, reason);
+                return false;
+            };
+
+            if (meshlet.VertexCount > params.MaxVertexCount || meshlet.TriangleCount > params.MaxTriangleCount)
+            {
+                return Fail("Limits are exceeded");
+            }
+
+            if (meshlet.VertexOffset + meshlet.VertexCount > mesh.MeshletVertexIndices.size() || meshlet.TriangleOffset + meshlet.TriangleCount > mesh.MeshletTriangles.size())
+            {
+                return Fail("Ranges are out of bounds");
+            }
+
+            const DirectX::XMVECTOR center = DirectX::XMLoadFloat3(&meshlet.BoundingSphereCenter);
+            const float radius = meshlet.BoundingSphereRadius * (1.0f + tolerance) + tolerance;
+
+            for (uint32_t i = 0; i < meshlet.VertexCount; ++i)
+            {
+                const DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&mesh.GetVertices()[mesh.MeshletVertexIndices[meshlet.VertexOffset + i]].Position);
+
+                if (DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(position, center))) > radius)
+                {
+                    return Fail("Vertex is outside of the bounding sphere");
+                }
+            }
+
+            const bool isConeEnabled = meshlet.ConeCutoff < 1.0f;
+            const DirectX::XMVECTOR coneApex = DirectX::XMLoadFloat3(&meshlet.ConeApex);
+            const DirectX::XMVECTOR coneAxis = DirectX::XMLoadFloat3(&meshlet.ConeAxis);
+            const float minNormalDot = std::sqrt(std::max(0.0f, 1.0f - meshlet.ConeCutoff * meshlet.ConeCutoff));
+
+            for (uint32_t i = 0; i < meshlet.TriangleCount; ++i)
+            {
+                const auto triangle = GetMeshletTriangle(mesh, meshlet, i);
+
+                if (indexOffset + 3 > mesh.GetIndices().size() || !std::ranges::equal(triangle, mesh.GetIndices().subspan(indexOffset, 3)))
+                {
+                    return Fail("Triangles don't match mesh indices");
+                }
+
+                indexOffset += 3;
+
+                DirectX::XMVECTOR normal;
+                if (!isConeEnabled || !ComputeTriangleNormal(mesh, triangle, normal))
+                {
+                    continue;
+                }
+
+                if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(coneAxis, normal)) < minNormalDot - tolerance)
+                {
+                    return Fail("Triangle normal is outside of the normal cone");
+                }
+
+                const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&mesh.GetVertices()[triangle[0]].Position);
+                const float apexDistance = DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMVectorSubtract(coneApex, p0), normal));
+
+                if (apexDistance > tolerance * (1.0f + meshlet.BoundingSphereRadius))
+                {
+                    return Fail("Cone apex is in front of the triangle");
+                }
+            }
+        }
+
+        if (indexOffset != mesh.GetIndices().size() && mesh.PrimitiveTopology == PrimitiveTopology::TriangleList)
+        {
+            BenzinWarning("MeshletBuilder: Meshlets cover {} of {} indices", indexOffset, mesh.GetIndices().size());
+            return false;
+        }
+
+        return true;
+    }
+
+} // namespace benzin
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct MeshData;
+
+    struct MeshletBuildParams
+    {
+        // D3D12 mesh shaders are limited to 256 vertices and 256 primitives. 64 / 124 is the recommended size for NVIDIA hardware
+        uint32_t MaxVertexCount = 64;
+        uint32_t MaxTriangleCount = 124;
+    };
+
+    // Splits triangles into meshlets greedily in index order, so it works best after 'OptimizeVertexCache'
+    // Only triangle lists are split, meshlets of other topologies are left empty
+    void BuildMeshlets(MeshData& mesh, const MeshletBuildParams& params = {});
+
+    // Builds meshlets for every mesh on all cores
+    void BuildMeshlets(std::span<MeshData> meshes, const MeshletBuildParams& params = {});
+
+    // Checks that meshlets respect the limits, reproduce the mesh triangles in order,
+    // every bounding sphere contains its vertices and every normal cone contains its triangle normals
+    bool ValidateMeshlets(const MeshData& mesh, const MeshletBuildParams& params = {});
+
+} // namespace benzin
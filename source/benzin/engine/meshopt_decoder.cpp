@@ -0,0 +1,754 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/meshopt_decoder.hpp"
+
+#include <intrin.h>
+#include <tmmintrin.h>
+
+#include "benzin/core/asserter.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        constexpr uint8_t g_VertexHeader = 0xa0;
+        constexpr uint8_t g_IndexHeader = 0xe0;
+        constexpr uint8_t g_SequenceHeader = 0xd0;
+
+        constexpr size_t g_ByteGroupSize = 16;
+        constexpr size_t g_ByteGroupDecodeLimit = 24; // Max bytes read by a byte group: 8 selector bytes and 16 escaped values
+        constexpr size_t g_VertexBlockSizeBytes = 8192;
+        constexpr size_t g_VertexBlockMaxSize = 256;
+        constexpr size_t g_VertexMaxSize = 256;
+        constexpr size_t g_TailMaxSize = 32;
+
+        // Byte groups
+
+        struct ByteGroupShuffleTables
+        {
+            std::array<std::array<uint8_t, 8>, 256> Shuffles{}; // Gathers escaped values for 8 selectors, 0x80 zeroes the lane
+            std::array<uint8_t, 256> Counts{}; // Escaped values of 8 selectors
+        };
+
+        constexpr ByteGroupShuffleTables BuildByteGroupShuffleTables()
+        {
+            ByteGroupShuffleTables tables;
+
+            for (uint32_t mask = 0; mask < 256; ++mask)
+            {
+                uint8_t count = 0;
+
+                for (uint32_t i = 0; i < 8; ++i)
+                {
+                    const bool isEscaped = (mask >> i) & 1;
+
+                    tables.Shuffles[mask][i] = isEscaped ? count : (uint8_t)0x80;
+                    count += isEscaped;
+                }
+
+                tables.Counts[mask] = count;
+            }
+
+            return tables;
+        }
+
+        constexpr ByteGroupShuffleTables g_ByteGroupShuffleTables = BuildByteGroupShuffleTables();
+
+        bool IsSsse3Supported()
+        {
+            std::array<int, 4> cpuInfo;
+            __cpuid(cpuInfo.data(), 1);
+
+            return (cpuInfo[2] & (1 << 9)) != 0;
+        }
+
+        const MeshoptDecodingKernel g_WidestMeshoptDecodingKernel = IsSsse3Supported() ? MeshoptDecodingKernel::Ssse3 : MeshoptDecodingKernel::Scalar;
+
+        // Selectors are 0, 2, 4 or 8 bits and go from the most significant bits. A selector with all bits set is escaped
+        // and its value is taken from bytes after the selectors
+        const uint8_t* DecodeBytesGroupScalar(const uint8_t* data, uint8_t* buffer, uint32_t bitsLog2)
+        {
+            switch (bitsLog2)
+            {
+                case 0:
+                {
+                    std::memset(buffer, 0, g_ByteGroupSize);
+                    return data;
+                }
+                case 1:
+                case 2:
+                {
+                    const uint32_t bits = 1u << bitsLog2;
+                    const uint32_t selectorsPerByte = 8 / bits;
+                    const auto escape = (uint8_t)((1u << bits) - 1);
+
+                    const uint8_t* escapedValues = data + g_ByteGroupSize / selectorsPerByte;
+
+                    for (uint32_t i = 0; i < g_ByteGroupSize; ++i)
+                    {
+                        const uint32_t shift = 8 - bits * (i % selectorsPerByte + 1);
+                        const auto selector = (uint8_t)((data[i / selectorsPerByte] >> shift) & escape);
+
+                        buffer[i] = selector == escape ? *escapedValues++ : selector;
+                    }
+
+                    return escapedValues;
+                }
+                case 3:
+                {
+                    std::memcpy(buffer, data, g_ByteGroupSize);
+                    return data + g_ByteGroupSize;
+                }
+            }
+
+            BenzinAssert(false);
+            return nullptr;
+        }
+
+        // 16 selectors are unpacked to bytes, then escaped values are gathered in place by a single shuffle
+        const uint8_t* ResolveByteGroupEscapesSsse3(__m128i selectors, __m128i escape, const uint8_t* escapedValues, uint8_t* buffer)
+        {
+            const __m128i rest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(escapedValues));
+
+            const __m128i escapeMask = _mm_cmpeq_epi8(selectors, escape);
+            const auto mask16 = (uint32_t)_mm_movemask_epi8(escapeMask);
+            const auto mask0 = (uint8_t)(mask16 & 0xff);
+            const auto mask1 = (uint8_t)(mask16 >> 8);
+
+            const __m128i shuffle0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(g_ByteGroupShuffleTables.Shuffles[mask0].data()));
+            const __m128i shuffle1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(g_ByteGroupShuffleTables.Shuffles[mask1].data()));
+            const __m128i shuffle = _mm_unpacklo_epi64(shuffle0, _mm_add_epi8(shuffle1, _mm_set1_epi8((char)g_ByteGroupShuffleTables.Counts[mask0])));
+
+            const __m128i result = _mm_or_si128(_mm_shuffle_epi8(rest, shuffle), _mm_andnot_si128(escapeMask, selectors));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), result);
+
+            return escapedValues + g_ByteGroupShuffleTables.Counts[mask0] + g_ByteGroupShuffleTables.Counts[mask1];
+        }
+
+        const uint8_t* DecodeBytesGroupSsse3(const uint8_t* data, uint8_t* buffer, uint32_t bitsLog2)
+        {
+            switch (bitsLog2)
+            {
+                case 0:
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_setzero_si128());
+                    return data;
+                }
+                case 1:
+                {
+                    int packedSelectors;
+                    std::memcpy(&packedSelectors, data, sizeof(packedSelectors));
+
+                    const __m128i selectors2 = _mm_cvtsi32_si128(packedSelectors);
+                    const __m128i selectors22 = _mm_unpacklo_epi8(_mm_srli_epi16(selectors2, 4), selectors2);
+                    const __m128i selectors2222 = _mm_unpacklo_epi8(_mm_srli_epi16(selectors22, 2), selectors22);
+                    const __m128i selectors = _mm_and_si128(selectors2222, _mm_set1_epi8(3));
+
+                    return ResolveByteGroupEscapesSsse3(selectors, _mm_set1_epi8(3), data + 4, buffer);
+                }
+                case 2:
+                {
+                    const __m128i selectors4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+                    const __m128i selectors44 = _mm_unpacklo_epi8(_mm_srli_epi16(selectors4, 4), selectors4);
+                    const __m128i selectors = _mm_and_si128(selectors44, _mm_set1_epi8(15));
+
+                    return ResolveByteGroupEscapesSsse3(selectors, _mm_set1_epi8(15), data + 8, buffer);
+                }
+                case 3:
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+                    return data + g_ByteGroupSize;
+                }
+            }
+
+            BenzinAssert(false);
+            return nullptr;
+        }
+
+        // Vertex codec
+
+        size_t GetVertexBlockSize(size_t vertexSize)
+        {
+            size_t blockSize = g_VertexBlockSizeBytes / vertexSize;
+            blockSize &= ~(g_ByteGroupSize - 1);
+
+            return std::min(blockSize, g_VertexBlockMaxSize);
+        }
+
+        template <auto DecodeBytesGroup>
+        const uint8_t* DecodeBytes(const uint8_t* data, const uint8_t* dataEnd, uint8_t* buffer, size_t bufferSize)
+        {
+            BenzinAssert(bufferSize % g_ByteGroupSize == 0);
+
+            // 2 bits per group for its selector size
+            const uint8_t* header = data;
+            const size_t headerSize = (bufferSize / g_ByteGroupSize + 3) / 4;
+
+            if ((size_t)(dataEnd - data) < headerSize)
+            {
+                return nullptr;
+            }
+
+            data += headerSize;
+
+            for (size_t i = 0; i < bufferSize; i += g_ByteGroupSize)
+            {
+                // The tail guarantees that a valid stream always has enough bytes for unchecked group reads
+                if ((size_t)(dataEnd - data) < g_ByteGroupDecodeLimit)
+                {
+                    return nullptr;
+                }
+
+                const size_t groupIndex = i / g_ByteGroupSize;
+                const uint32_t bitsLog2 = (header[groupIndex / 4] >> ((groupIndex % 4) * 2)) & 3;
+
+                data = DecodeBytesGroup(data, buffer + i, bitsLog2);
+            }
+
+            return data;
+        }
+
+        // Each byte of a vertex is stored as a separate stream of zigzag encoded deltas from the previous vertex
+        template <auto DecodeBytesGroup>
+        const uint8_t* DecodeVertexBlock(const uint8_t* data, const uint8_t* dataEnd, uint8_t* vertexData, size_t vertexCount, size_t vertexSize, std::array<uint8_t, g_VertexMaxSize>& lastVertex)
+        {
+            BenzinAssert(vertexCount > 0 && vertexCount <= g_VertexBlockMaxSize);
+
+            alignas(16) std::array<uint8_t, g_VertexBlockMaxSize> deltas;
+            alignas(16) std::array<uint8_t, g_ByteGroupSize> values;
+
+            const size_t alignedVertexCount = AlignAbove(vertexCount, g_ByteGroupSize);
+
+            for (size_t k = 0; k < vertexSize; ++k)
+            {
+                data = DecodeBytes<DecodeBytesGroup>(data, dataEnd, deltas.data(), alignedVertexCount);
+                if (!data)
+                {
+                    return nullptr;
+                }
+
+                uint8_t previous = lastVertex[k];
+
+                for (size_t i = 0; i < vertexCount; i += g_ByteGroupSize)
+                {
+                    // Unzigzag and prefix sum of 16 deltas
+                    const __m128i encoded = _mm_load_si128(reinterpret_cast<const __m128i*>(deltas.data() + i));
+                    const __m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(encoded, _mm_set1_epi8(1)));
+
+                    __m128i decoded = _mm_xor_si128(sign, _mm_and_si128(_mm_srli_epi16(encoded, 1), _mm_set1_epi8(0x7f)));
+                    decoded = _mm_add_epi8(decoded, _mm_slli_si128(decoded, 1));
+                    decoded = _mm_add_epi8(decoded, _mm_slli_si128(decoded, 2));
+                    decoded = _mm_add_epi8(decoded, _mm_slli_si128(decoded, 4));
+                    decoded = _mm_add_epi8(decoded, _mm_slli_si128(decoded, 8));
+                    decoded = _mm_add_epi8(decoded, _mm_set1_epi8((char)previous));
+
+                    _mm_store_si128(reinterpret_cast<__m128i*>(values.data()), decoded);
+
+                    const size_t groupVertexCount = std::min(g_ByteGroupSize, vertexCount - i);
+                    for (size_t j = 0; j < groupVertexCount; ++j)
+                    {
+                        vertexData[(i + j) * vertexSize + k] = values[j];
+                    }
+
+                    previous = values[g_ByteGroupSize - 1];
+                }
+            }
+
+            std::memcpy(lastVertex.data(), vertexData + (vertexCount - 1) * vertexSize, vertexSize);
+
+            return data;
+        }
+
+        // Index codecs
+
+        uint32_t DecodeVByte(const uint8_t*& data)
+        {
+            const uint8_t lead = *data++;
+            if (lead < 128)
+            {
+                return lead;
+            }
+
+            // At most 4 more bytes, so malformed data can't make it read indefinitely
+            uint32_t result = lead & 127;
+            uint32_t shift = 7;
+
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const uint8_t group = *data++;
+
+                result |= (uint32_t)(group & 127) << shift;
+                shift += 7;
+
+                if (group < 128)
+                {
+                    break;
+                }
+            }
+
+            return result;
+        }
+
+        uint32_t DecodeIndex(const uint8_t*& data, uint32_t last)
+        {
+            const uint32_t v = DecodeVByte(data);
+            const uint32_t delta = (v >> 1) ^ (0u - (v & 1));
+
+            return last + delta;
+        }
+
+        void WriteIndex(std::span<std::byte> destination, size_t indexSize, size_t offset, uint32_t index)
+        {
+            if (indexSize == 2)
+            {
+                reinterpret_cast<uint16_t*>(destination.data())[offset] = (uint16_t)index;
+            }
+            else
+            {
+                reinterpret_cast<uint32_t*>(destination.data())[offset] = index;
+            }
+        }
+
+        // Encoder and decoder must update the FIFOs in exactly the same order
+        class IndexDecoderFifos
+        {
+        public:
+            IndexDecoderFifos()
+            {
+                m_Vertices.fill(g_InvalidIndex<uint32_t>);
+                m_Edges.fill({ g_InvalidIndex<uint32_t>, g_InvalidIndex<uint32_t> });
+            }
+
+        public:
+            uint32_t GetVertex(uint32_t reverseIndex) const { return m_Vertices[(m_VertexOffset - reverseIndex) & 15]; }
+            std::pair<uint32_t, uint32_t> GetEdge(uint32_t reverseIndex) const { return m_Edges[(m_EdgeOffset - 1 - reverseIndex) & 15]; }
+
+            void PushVertex(uint32_t vertex, bool isPushed = true)
+            {
+                m_Vertices[m_VertexOffset] = vertex;
+                m_VertexOffset = (m_VertexOffset + isPushed) & 15;
+            }
+
+            void PushEdge(uint32_t a, uint32_t b)
+            {
+                m_Edges[m_EdgeOffset] = { a, b };
+                m_EdgeOffset = (m_EdgeOffset + 1) & 15;
+            }
+
+        private:
+            std::array<uint32_t, 16> m_Vertices;
+            std::array<std::pair<uint32_t, uint32_t>, 16> m_Edges;
+
+            uint32_t m_VertexOffset = 0;
+            uint32_t m_EdgeOffset = 0;
+        };
+
+        // Filters
+
+        template <typename T>
+        void DecodeOctahedralFilter(T* data, size_t count)
+        {
+            const float max = (float)((1 << (sizeof(T) * 8 - 1)) - 1);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                T* v = data + i * 4;
+
+                // The third component encodes 1.0, z is reconstructed from it
+                float x = (float)v[0];
+                float y = (float)v[1];
+                const float z = (float)v[2] - std::abs(x) - std::abs(y);
+
+                // Unfold the lower hemisphere
+                const float t = std::min(z, 0.0f);
+                x += x >= 0.0f ? t : -t;
+                y += y >= 0.0f ? t : -t;
+
+                const float scale = max / std::sqrt(x * x + y * y + z * z);
+
+                v[0] = (T)std::lround(x * scale);
+                v[1] = (T)std::lround(y * scale);
+                v[2] = (T)std::lround(z * scale);
+            }
+        }
+
+        void DecodeQuaternionFilter(int16_t* data, size_t count)
+        {
+            const float scale = 1.0f / std::numbers::sqrt2_v<float>;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                int16_t* q = data + i * 4;
+
+                // The fourth component stores the index of the largest component and the scale of the rest
+                const float componentScale = scale / (float)(q[3] | 3);
+
+                const float x = (float)q[0] * componentScale;
+                const float y = (float)q[1] * componentScale;
+                const float z = (float)q[2] * componentScale;
+                const float w = std::sqrt(std::max(1.0f - x * x - y * y - z * z, 0.0f));
+
+                const uint32_t maxComponentIndex = q[3] & 3;
+
+                q[(maxComponentIndex + 1) & 3] = (int16_t)std::lround(x * 32767.0f);
+                q[(maxComponentIndex + 2) & 3] = (int16_t)std::lround(y * 32767.0f);
+                q[(maxComponentIndex + 3) & 3] = (int16_t)std::lround(z * 32767.0f);
+                q[(maxComponentIndex + 0) & 3] = (int16_t)std::lround(w * 32767.0f);
+            }
+        }
+
+        // 24 bit signed mantissa and 8 bit signed exponent to float
+        void DecodeExponentialFilter(uint32_t* data, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const int32_t mantissa = (int32_t)(data[i] << 8) >> 8;
+                const int32_t exponent = (int32_t)data[i] >> 24;
+
+                data[i] = std::bit_cast<uint32_t>(std::ldexp((float)mantissa, exponent));
+            }
+        }
+
+    } // anonymous namespace
+
+    //
+
+    MeshoptDecodingKernel GetWidestMeshoptDecodingKernel()
+    {
+        return g_WidestMeshoptDecodingKernel;
+    }
+
+    bool DecodeMeshoptVertexBuffer(std::span<std::byte> destination, size_t vertexCount, size_t vertexSize, std::span<const std::byte> source, MeshoptDecodingKernel kernel)
+    {
+        BenzinAssert(kernel != MeshoptDecodingKernel::Ssse3 || g_WidestMeshoptDecodingKernel == MeshoptDecodingKernel::Ssse3);
+
+        // Sizes come from glTF, so they are checked in release too
+        if (vertexSize == 0 || vertexSize > g_VertexMaxSize || vertexSize % 4 != 0 || destination.size() < vertexCount * vertexSize)
+        {
+            return false;
+        }
+
+        const auto* data = reinterpret_cast<const uint8_t*>(source.data());
+        const auto* dataEnd = data + source.size();
+
+        if (source.size() < 1 + vertexSize)
+        {
+            return false;
+        }
+
+        // Only version 0 is allowed by 'EXT_meshopt_compression'
+        const uint8_t header = *data++;
+        if (header != g_VertexHeader)
+        {
+            return false;
+        }
+
+        // The first vertex is encoded against the last bytes of the stream
+        std::array<uint8_t, g_VertexMaxSize> lastVertex;
+        std::memcpy(lastVertex.data(), dataEnd - vertexSize, vertexSize);
+
+        const size_t blockSize = GetVertexBlockSize(vertexSize);
+        auto* vertexData = reinterpret_cast<uint8_t*>(destination.data());
+
+        for (size_t vertexOffset = 0; vertexOffset < vertexCount; vertexOffset += blockSize)
+        {
+            const size_t blockVertexCount = std::min(blockSize, vertexCount - vertexOffset);
+            uint8_t* blockVertexData = vertexData + vertexOffset * vertexSize;
+
+            data = kernel == MeshoptDecodingKernel::Ssse3
+                ? DecodeVertexBlock<DecodeBytesGroupSsse3>(data, dataEnd, blockVertexData, blockVertexCount, vertexSize, lastVertex)
+                : DecodeVertexBlock<DecodeBytesGroupScalar>(data, dataEnd, blockVertexData, blockVertexCount, vertexSize, lastVertex);
+
+            if (!data)
+            {
+                return false;
+            }
+        }
+
+        const size_t tailSize = std::max(vertexSize, g_TailMaxSize);
+        return (size_t)(dataEnd - data) == tailSize;
+    }
+
+    bool DecodeMeshoptIndexBuffer(std::span<std::byte> destination, size_t indexCount, size_t indexSize, std::span<const std::byte> source)
+    {
+        if (indexCount % 3 != 0 || (indexSize != 2 && indexSize != 4) || destination.size() < indexCount * indexSize)
+        {
+            return false;
+        }
+
+        // The minimal stream is the header, a code byte per triangle and the 16 byte table of aux codes
+        if (source.size() < 1 + indexCount / 3 + 16)
+        {
+            return false;
+        }
+
+        const auto* buffer = reinterpret_cast<const uint8_t*>(source.data());
+
+        if ((buffer[0] & 0xf0) != g_IndexHeader)
+        {
+            return false;
+        }
+
+        const uint32_t version = buffer[0] & 0x0f;
+        if (version > 1)
+        {
+            return false;
+        }
+
+        IndexDecoderFifos fifos;
+
+        uint32_t next = 0;
+        uint32_t last = 0;
+
+        const uint32_t maxCachedVertexCode = version >= 1 ? 13 : 15;
+
+        const uint8_t* codes = buffer + 1;
+        const uint8_t* data = codes + indexCount / 3;
+        const uint8_t* dataSafeEnd = buffer + source.size() - 16;
+        const uint8_t* auxCodes = dataSafeEnd;
+
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            // A triangle reads at most 16 bytes: an aux code and 3 free indices of 5 bytes
+            if (data > dataSafeEnd)
+            {
+                return false;
+            }
+
+            const uint8_t code = *codes++;
+
+            if (code < 0xf0)
+            {
+                // An edge from the FIFO and a third vertex
+                const auto [a, b] = fifos.GetEdge(code >> 4);
+
+                const uint32_t vertexCode = code & 15;
+
+                uint32_t c = 0;
+                bool isPushed = true;
+
+                if (vertexCode == 0)
+                {
+                    c = next++;
+                }
+                else if (vertexCode < maxCachedVertexCode)
+                {
+                    c = fifos.GetVertex(vertexCode + 1);
+                    isPushed = false;
+                }
+                else
+                {
+                    // 13 and 14 are deltas of -1 and 1 from the last free index
+                    c = last = vertexCode != 15 ? last + (vertexCode - (vertexCode ^ 3)) : DecodeIndex(data, last);
+                }
+
+                WriteIndex(destination, indexSize, i + 0, a);
+                WriteIndex(destination, indexSize, i + 1, b);
+                WriteIndex(destination, indexSize, i + 2, c);
+
+                fifos.PushVertex(c, isPushed);
+                fifos.PushEdge(c, b);
+                fifos.PushEdge(a, c);
+            }
+            else
+            {
+                // A triangle without cached edges, its first vertex is always new
+                uint32_t a = 0;
+                uint32_t b = 0;
+                uint32_t c = 0;
+                uint32_t bCode = 0;
+                uint32_t cCode = 0;
+
+                if (code < 0xfe)
+                {
+                    const uint8_t auxCode = auxCodes[code & 15];
+                    bCode = auxCode >> 4;
+                    cCode = auxCode & 15;
+
+                    // 'next' is incremented for all vertices before FIFO lookups, like the encoder does
+                    a = next++;
+
+                    b = bCode == 0 ? next++ : fifos.GetVertex(bCode);
+                    c = cCode == 0 ? next++ : fifos.GetVertex(cCode);
+                }
+                else
+                {
+                    const uint8_t auxCode = *data++;
+                    const uint32_t aCode = code == 0xfe ? 0 : 15;
+                    bCode = auxCode >> 4;
+                    cCode = auxCode & 15;
+
+                    // Zero aux code stored explicitly resets the new vertex counter
+                    if (auxCode == 0)
+                    {
+                        next = 0;
+                    }
+
+                    a = aCode == 0 ? next++ : 0;
+                    b = bCode == 0 ? next++ : (bCode == 15 ? 0 : fifos.GetVertex(bCode));
+                    c = cCode == 0 ? next++ : (cCode == 15 ? 0 : fifos.GetVertex(cCode));
+
+                    if (aCode == 15)
+                    {
+                        a = last = DecodeIndex(data, last);
+                    }
+
+                    if (bCode == 15)
+                    {
+                        b = last = DecodeIndex(data, last);
+                    }
+
+                    if (cCode == 15)
+                    {
+                        c = last = DecodeIndex(data, last);
+                    }
+                }
+
+                WriteIndex(destination, indexSize, i + 0, a);
+                WriteIndex(destination, indexSize, i + 1, b);
+                WriteIndex(destination, indexSize, i + 2, c);
+
+                fifos.PushVertex(a);
+                fifos.PushVertex(b, bCode == 0 || bCode == 15);
+                fifos.PushVertex(c, cCode == 0 || cCode == 15);
+
+                fifos.PushEdge(b, a);
+                fifos.PushEdge(c, b);
+                fifos.PushEdge(a, c);
+            }
+        }
+
+        // All data must be read up to the aux code table
+        return data == dataSafeEnd;
+    }
+
+    bool DecodeMeshoptIndexSequence(std::span<std::byte> destination, size_t indexCount, size_t indexSize, std::span<const std::byte> source)
+    {
+        if ((indexSize != 2 && indexSize != 4) || destination.size() < indexCount * indexSize)
+        {
+            return false;
+        }
+
+        // The minimal stream is the header, a byte per index and a 4 byte tail
+        if (source.size() < 1 + indexCount + 4)
+        {
+            return false;
+        }
+
+        const auto* buffer = reinterpret_cast<const uint8_t*>(source.data());
+
+        if ((buffer[0] & 0xf0) != g_SequenceHeader || (buffer[0] & 0x0f) > 1)
+        {
+            return false;
+        }
+
+        const uint8_t* data = buffer + 1;
+        const uint8_t* dataSafeEnd = buffer + source.size() - 4;
+
+        // Two baselines, so interleaved sequences stay cheap
+        std::array<uint32_t, 2> lasts{};
+
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            // An index reads at most 5 bytes, the tail covers the overrun
+            if (data >= dataSafeEnd)
+            {
+                return false;
+            }
+
+            const uint32_t v = DecodeVByte(data);
+            const uint32_t baseline = v & 1;
+            const uint32_t zigzagDelta = v >> 1;
+            const uint32_t delta = (zigzagDelta >> 1) ^ (0u - (zigzagDelta & 1));
+
+            lasts[baseline] += delta;
+            WriteIndex(destination, indexSize, i, lasts[baseline]);
+        }
+
+        return data == dataSafeEnd;
+    }
+
+    bool ApplyMeshoptFilter(MeshoptCompressionFilter filter, std::span<std::byte> data, size_t count, size_t stride)
+    {
+        if (data.size() < count * stride)
+        {
+            return false;
+        }
+
+        switch (filter)
+        {
+            case MeshoptCompressionFilter::None:
+            {
+                return true;
+            }
+            case MeshoptCompressionFilter::Octahedral:
+            {
+                if (stride != 4 && stride != 8)
+                {
+                    return false;
+                }
+
+                if (stride == 4)
+                {
+                    DecodeOctahedralFilter(reinterpret_cast<int8_t*>(data.data()), count);
+                }
+                else
+                {
+                    DecodeOctahedralFilter(reinterpret_cast<int16_t*>(data.data()), count);
+                }
+
+                return true;
+            }
+            case MeshoptCompressionFilter::Quaternion:
+            {
+                if (stride != 8)
+                {
+                    return false;
+                }
+
+                DecodeQuaternionFilter(reinterpret_cast<int16_t*>(data.data()), count);
+                return true;
+            }
+            case MeshoptCompressionFilter::Exponential:
+            {
+                if (stride % 4 != 0)
+                {
+                    return false;
+                }
+
+                DecodeExponentialFilter(reinterpret_cast<uint32_t*>(data.data()), count * stride / 4);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool DecodeMeshoptBufferView(const MeshoptBufferViewDesc& desc, std::span<const std::byte> source, std::span<std::byte> destination)
+    {
+        if (destination.size() != (size_t)desc.Count * desc.ByteStride)
+        {
+            return false;
+        }
+
+        switch (desc.Mode)
+        {
+            case MeshoptCompressionMode::Attributes:
+            {
+                return DecodeMeshoptVertexBuffer(destination, desc.Count, desc.ByteStride, source) && ApplyMeshoptFilter(desc.Filter, destination, desc.Count, desc.ByteStride);
+            }
+            case MeshoptCompressionMode::Triangles:
+            {
+                return DecodeMeshoptIndexBuffer(destination, desc.Count, desc.ByteStride, source);
+            }
+            case MeshoptCompressionMode::Indices:
+            {
+                return DecodeMeshoptIndexSequence(destination, desc.Count, desc.ByteStride, source);
+            }
+        }
+
+        return false;
+    }
+
+} // namespace benzin
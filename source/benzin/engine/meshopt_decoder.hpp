@@ -0,0 +1,52 @@
+#pragma once
+
+namespace benzin
+{
+
+    // Decoders for buffers compressed by 'meshoptimizer' codecs, as used by 'EXT_meshopt_compression'
+    // Ref: https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+
+    enum class MeshoptCompressionMode : uint8_t
+    {
+        Attributes,
+        Triangles,
+        Indices,
+    };
+
+    enum class MeshoptCompressionFilter : uint8_t
+    {
+        None,
+        Octahedral,
+        Quaternion,
+        Exponential,
+    };
+
+    struct MeshoptBufferViewDesc
+    {
+        MeshoptCompressionMode Mode = MeshoptCompressionMode::Attributes;
+        MeshoptCompressionFilter Filter = MeshoptCompressionFilter::None;
+        uint32_t Count = 0; // Elements, each is 'ByteStride' bytes
+        uint32_t ByteStride = 0;
+    };
+
+    enum class MeshoptDecodingKernel : uint8_t
+    {
+        Scalar, // Byte groups are unpacked a selector at a time
+        Ssse3, // Byte groups are unpacked with a single shuffle
+    };
+
+    MeshoptDecodingKernel GetWidestMeshoptDecodingKernel(); // Supported by the CPU
+
+    // Return false for malformed data or sizes the format doesn't allow, both are checked in release too.
+    // Every kernel gives the same result
+    bool DecodeMeshoptVertexBuffer(std::span<std::byte> destination, size_t vertexCount, size_t vertexSize, std::span<const std::byte> source, MeshoptDecodingKernel kernel = GetWidestMeshoptDecodingKernel());
+    bool DecodeMeshoptIndexBuffer(std::span<std::byte> destination, size_t indexCount, size_t indexSize, std::span<const std::byte> source);
+    bool DecodeMeshoptIndexSequence(std::span<std::byte> destination, size_t indexCount, size_t indexSize, std::span<const std::byte> source);
+
+    // In place, runs after 'DecodeMeshoptVertexBuffer'. Returns false if the filter isn't defined for 'stride'
+    bool ApplyMeshoptFilter(MeshoptCompressionFilter filter, std::span<std::byte> data, size_t count, size_t stride);
+
+    // 'destination' must be 'Count * ByteStride' bytes
+    bool DecodeMeshoptBufferView(const MeshoptBufferViewDesc& desc, std::span<const std::byte> source, std::span<std::byte> destination);
+
+} // namespace benzin
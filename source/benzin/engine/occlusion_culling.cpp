@@ -0,0 +1,654 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/occlusion_culling.hpp"
+
+#include <immintrin.h>
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // Clip space 'x' and 'y' are clipped at this multiple of 'w', so screen coordinates stay small enough for exact edge functions
+        constexpr float g_GuardBandFactor = 2.0f;
+
+        // Triangles smaller than this in pixels squared are dropped, their depth planes are too steep
+        constexpr float g_MinTriangleArea = 1.0e-4f;
+
+        // A box is tested against at most 'g_MaxTestedTexelSpan' texels in both directions of the pyramid level.
+        // With 2 texels a box on a texel border takes the level twice as coarse as its size
+        constexpr uint32_t g_MaxTestedTexelSpan = 4;
+
+        using ClipVertex = DirectX::XMFLOAT4;
+
+        // A vertex is inside if 'dot(plane, vertex) >= 0'
+        constexpr std::array<ClipVertex, 5> g_ClipPlanes
+        {
+            ClipVertex{ 0.0f, 0.0f, 1.0f, 0.0f }, // Near
+            ClipVertex{ 1.0f, 0.0f, 0.0f, g_GuardBandFactor }, // Left
+            ClipVertex{ -1.0f, 0.0f, 0.0f, g_GuardBandFactor }, // Right
+            ClipVertex{ 0.0f, 1.0f, 0.0f, g_GuardBandFactor }, // Bottom
+            ClipVertex{ 0.0f, -1.0f, 0.0f, g_GuardBandFactor }, // Top
+        };
+
+        constexpr uint32_t g_FarOutcode = 1 << g_ClipPlanes.size(); // Used only to reject triangles, depths beyond are never written anyway
+
+        // Each clip plane adds at most one vertex to a triangle
+        constexpr uint32_t g_MaxClippedVertexCount = 3 + (uint32_t)g_ClipPlanes.size();
+
+        using ClipPolygon = std::array<ClipVertex, g_MaxClippedVertexCount>;
+
+        struct ScreenVertex
+        {
+            float X = 0.0f;
+            float Y = 0.0f;
+            float Z = 0.0f;
+        };
+
+        struct ScreenRect
+        {
+            float MinX = std::numeric_limits<float>::max();
+            float MinY = std::numeric_limits<float>::max();
+            float MaxX = std::numeric_limits<float>::lowest();
+            float MaxY = std::numeric_limits<float>::lowest();
+            float MinDepth = std::numeric_limits<float>::max();
+        };
+
+        float GetClipPlaneDistance(const ClipVertex& plane, const ClipVertex& vertex)
+        {
+            return plane.x * vertex.x + plane.y * vertex.y + plane.z * vertex.z + plane.w * vertex.w;
+        }
+
+        uint32_t GetOutcode(const ClipVertex& vertex)
+        {
+            uint32_t outcode = 0;
+
+            for (const auto [i, plane] : g_ClipPlanes | std::views::enumerate)
+            {
+                if (GetClipPlaneDistance(plane, vertex) < 0.0f)
+                {
+                    outcode |= 1 << i;
+                }
+            }
+
+            if (vertex.z > vertex.w)
+            {
+                outcode |= g_FarOutcode;
+            }
+
+            return outcode;
+        }
+
+        ClipVertex LerpClipVertex(const ClipVertex& a, const ClipVertex& b, float t)
+        {
+            return ClipVertex
+            {
+                a.x + (b.x - a.x) * t,
+                a.y + (b.y - a.y) * t,
+                a.z + (b.z - a.z) * t,
+                a.w + (b.w - a.w) * t,
+            };
+        }
+
+        // Sutherland-Hodgman against a single plane. Returns the vertex count of 'outPolygon'
+        uint32_t ClipPolygonByPlane(const ClipVertex& plane, const ClipPolygon& polygon, uint32_t vertexCount, ClipPolygon& outPolygon)
+        {
+            uint32_t outVertexCount = 0;
+
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                const ClipVertex& a = polygon[i];
+                const ClipVertex& b = polygon[(i + 1) % vertexCount];
+
+                const float aDistance = GetClipPlaneDistance(plane, a);
+                const float bDistance = GetClipPlaneDistance(plane, b);
+
+                if (aDistance >= 0.0f)
+                {
+                    outPolygon[outVertexCount++] = a;
+                }
+
+                if ((aDistance >= 0.0f) != (bDistance >= 0.0f))
+                {
+                    outPolygon[outVertexCount++] = LerpClipVertex(a, b, aDistance / (aDistance - bDistance));
+                }
+            }
+
+            return outVertexCount;
+        }
+
+        ScreenVertex ToScreenVertex(const ClipVertex& vertex, float width, float height)
+        {
+            const float inverseW = 1.0f / vertex.w;
+
+            return ScreenVertex
+            {
+                .X = (vertex.x * inverseW * 0.5f + 0.5f) * width,
+                .Y = (0.5f - vertex.y * inverseW * 0.5f) * height,
+                .Z = vertex.z * inverseW,
+            };
+        }
+
+        template <typename RasterTriangle>
+        void SetupTriangle(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2, uint32_t width, uint32_t height, std::vector<RasterTriangle>& outTriangles)
+        {
+            const float dx1 = v1.X - v0.X;
+            const float dy1 = v1.Y - v0.Y;
+            const float dz1 = v1.Z - v0.Z;
+            const float dx2 = v2.X - v0.X;
+            const float dy2 = v2.Y - v0.Y;
+            const float dz2 = v2.Z - v0.Z;
+
+            const float area = dx1 * dy2 - dx2 * dy1;
+            if (!(std::abs(area) >= g_MinTriangleArea))
+            {
+                return;
+            }
+
+            // Pixel centers are at '+0.5'
+            const float minX = std::max(std::ceil(std::min({ v0.X, v1.X, v2.X }) - 0.5f), 0.0f);
+            const float minY = std::max(std::ceil(std::min({ v0.Y, v1.Y, v2.Y }) - 0.5f), 0.0f);
+            const float maxX = std::min(std::floor(std::max({ v0.X, v1.X, v2.X }) - 0.5f), (float)width - 1.0f);
+            const float maxY = std::min(std::floor(std::max({ v0.Y, v1.Y, v2.Y }) - 0.5f), (float)height - 1.0f);
+
+            if (minX > maxX || minY > maxY)
+            {
+                return;
+            }
+
+            auto& triangle = outTriangles.emplace_back();
+
+            // Both faces are rasterized, so edges are flipped for the negative area
+            const float sign = area > 0.0f ? 1.0f : -1.0f;
+            const std::array<const ScreenVertex*, 3> vertices{ &v0, &v1, &v2 };
+
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                const ScreenVertex& a = *vertices[i];
+                const ScreenVertex& b = *vertices[(i + 1) % 3];
+
+                triangle.EdgeA[i] = sign * (a.Y - b.Y);
+                triangle.EdgeB[i] = sign * (b.X - a.X);
+                triangle.EdgeC[i] = sign * (a.X * b.Y - b.X * a.Y);
+            }
+
+            const float inverseArea = 1.0f / area;
+            triangle.DepthA = (dz1 * dy2 - dz2 * dy1) * inverseArea;
+            triangle.DepthB = (dx1 * dz2 - dx2 * dz1) * inverseArea;
+            triangle.DepthC = v0.Z - triangle.DepthA * v0.X - triangle.DepthB * v0.Y;
+
+            triangle.MinX = (uint16_t)minX;
+            triangle.MinY = (uint16_t)minY;
+            triangle.MaxX = (uint16_t)maxX;
+            triangle.MaxY = (uint16_t)maxY;
+        }
+
+        template <typename RasterTriangle>
+        void ClipAndSetupTriangle(const std::array<const ClipVertex*, 3>& vertices, const std::array<uint32_t, 3>& outcodes, uint32_t width, uint32_t height, std::vector<RasterTriangle>& outTriangles)
+        {
+            if ((outcodes[0] & outcodes[1] & outcodes[2]) != 0)
+            {
+                return;
+            }
+
+            const uint32_t clipMask = (outcodes[0] | outcodes[1] | outcodes[2]) & ~g_FarOutcode;
+            if (clipMask == 0)
+            {
+                SetupTriangle(ToScreenVertex(*vertices[0], (float)width, (float)height), ToScreenVertex(*vertices[1], (float)width, (float)height), ToScreenVertex(*vertices[2], (float)width, (float)height), width, height, outTriangles);
+                return;
+            }
+
+            ClipPolygon polygon;
+            ClipPolygon clippedPolygon;
+            polygon[0] = *vertices[0];
+            polygon[1] = *vertices[1];
+            polygon[2] = *vertices[2];
+
+            uint32_t vertexCount = 3;
+            for (const auto [i, plane] : g_ClipPlanes | std::views::enumerate)
+            {
+                if ((clipMask & (1 << i)) == 0)
+                {
+                    continue;
+                }
+
+                vertexCount = ClipPolygonByPlane(plane, polygon, vertexCount, clippedPolygon);
+                std::swap(polygon, clippedPolygon);
+
+                if (vertexCount < 3)
+                {
+                    return;
+                }
+            }
+
+            std::array<ScreenVertex, g_MaxClippedVertexCount> screenVertices;
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                screenVertices[i] = ToScreenVertex(polygon[i], (float)width, (float)height);
+            }
+
+            for (uint32_t i = 1; i + 1 < vertexCount; ++i)
+            {
+                SetupTriangle(screenVertices[0], screenVertices[i], screenVertices[i + 1], width, height, outTriangles);
+            }
+        }
+
+        // Moves edges inwards by half a pixel diagonal projected on their normals, so a pixel center passes only if the whole pixel
+        // is inside. Depth is moved to the farthest corner of the pixel
+        template <typename RasterTriangle>
+        void ShrinkToWholePixels(RasterTriangle& triangle)
+        {
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                triangle.EdgeC[i] -= 0.5f * (std::abs(triangle.EdgeA[i]) + std::abs(triangle.EdgeB[i]));
+            }
+
+            triangle.DepthC += 0.5f * (std::abs(triangle.DepthA) + std::abs(triangle.DepthB));
+        }
+
+        // Returns false if the box crosses the near plane
+        bool ProjectAabb(const Aabb& aabb, const DirectX::XMMATRIX& viewProjection, float width, float height, ScreenRect& outRect)
+        {
+            outRect = ScreenRect{};
+
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                const DirectX::XMVECTOR corner = DirectX::XMVectorSet(
+                    (i & 0b001) != 0 ? aabb.Max.x : aabb.Min.x,
+                    (i & 0b010) != 0 ? aabb.Max.y : aabb.Min.y,
+                    (i & 0b100) != 0 ? aabb.Max.z : aabb.Min.z,
+                    1.0f
+                );
+
+                ClipVertex clipCorner;
+                DirectX::XMStoreFloat4(&clipCorner, DirectX::XMVector3Transform(corner, viewProjection));
+
+                if (clipCorner.z < 0.0f)
+                {
+                    return false;
+                }
+
+                const ScreenVertex screenCorner = ToScreenVertex(clipCorner, width, height);
+                outRect.MinX = std::min(outRect.MinX, screenCorner.X);
+                outRect.MinY = std::min(outRect.MinY, screenCorner.Y);
+                outRect.MaxX = std::max(outRect.MaxX, screenCorner.X);
+                outRect.MaxY = std::max(outRect.MaxY, screenCorner.Y);
+                outRect.MinDepth = std::min(outRect.MinDepth, screenCorner.Z);
+            }
+
+            return true;
+        }
+
+    } // anonymous namespace
+
+    // OcclusionCuller
+
+    OcclusionCuller::OcclusionCuller(const OcclusionCullerCreation& creation)
+        : m_Creation{ creation }
+        , m_TileCountX{ creation.Width / g_OcclusionTileSize }
+        , m_TileCountY{ creation.Height / g_OcclusionTileSize }
+        , m_TileLevelCount{ (uint32_t)std::countr_zero(g_OcclusionTileSize) + 1 }
+    {
+        static_assert(std::has_single_bit(g_OcclusionTileSize) && g_OcclusionTileSize % 4 == 0);
+
+        BenzinAssert(creation.Width != 0 && creation.Width % g_OcclusionTileSize == 0);
+        BenzinAssert(creation.Height != 0 && creation.Height % g_OcclusionTileSize == 0);
+        BenzinAssert(creation.Width <= std::numeric_limits<uint16_t>::max() && creation.Height <= std::numeric_limits<uint16_t>::max());
+
+        // Levels reduced by tiles are exact halves, coarser levels round up
+        uint32_t width = creation.Width;
+        uint32_t height = creation.Height;
+        while (true)
+        {
+            m_DepthLevels.push_back(DepthLevel
+            {
+                .Width = width,
+                .Height = height,
+                .Depths = std::vector<float>(width * height, 1.0f),
+            });
+
+            if (width == 1 && height == 1)
+            {
+                break;
+            }
+
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+        }
+
+        m_TileLevelCount = std::min(m_TileLevelCount, (uint32_t)m_DepthLevels.size());
+    }
+
+    void OcclusionCuller::Render(const DirectX::XMMATRIX& viewProjection, std::span<const Occluder> candidates)
+    {
+        m_ViewProjection = viewProjection;
+        m_Stats = OcclusionCullingStats{};
+
+        {
+            BenzinGrabTimeOnScopeExit(m_Stats.SetupTime);
+
+            SelectOccluders(candidates);
+            SetupTriangles(candidates);
+        }
+
+        {
+            BenzinGrabTimeOnScopeExit(m_Stats.RasterizationTime);
+
+            BinTriangles();
+
+            ParallelFor(m_TileCountX * m_TileCountY, 1, [&](uint32_t tileIndex)
+            {
+                RasterizeTile(tileIndex);
+                ReduceTile(tileIndex);
+            });
+
+            BuildCoarseDepthLevels();
+        }
+    }
+
+    bool OcclusionCuller::IsOccluded(const Aabb& worldAabb) const
+    {
+        if (m_Stats.OccluderCount == 0)
+        {
+            return false;
+        }
+
+        const DepthLevel& depthLevel0 = m_DepthLevels[0];
+
+        ScreenRect rect;
+        if (!ProjectAabb(worldAabb, m_ViewProjection, (float)depthLevel0.Width, (float)depthLevel0.Height, rect))
+        {
+            return false;
+        }
+
+        if (rect.MaxX < 0.0f || rect.MaxY < 0.0f || rect.MinX >= (float)depthLevel0.Width || rect.MinY >= (float)depthLevel0.Height)
+        {
+            return false;
+        }
+
+        // Every pixel the rectangle touches, not only covered pixel centers
+        const auto minX = (uint32_t)std::max(rect.MinX, 0.0f);
+        const auto minY = (uint32_t)std::max(rect.MinY, 0.0f);
+        const auto maxX = (uint32_t)std::min(rect.MaxX, (float)depthLevel0.Width - 1.0f);
+        const auto maxY = (uint32_t)std::min(rect.MaxY, (float)depthLevel0.Height - 1.0f);
+
+        uint32_t levelIndex = 0;
+        while (levelIndex + 1 < (uint32_t)m_DepthLevels.size() && ((maxX >> levelIndex) - (minX >> levelIndex) >= g_MaxTestedTexelSpan || (maxY >> levelIndex) - (minY >> levelIndex) >= g_MaxTestedTexelSpan))
+        {
+            ++levelIndex;
+        }
+
+        const DepthLevel& depthLevel = m_DepthLevels[levelIndex];
+
+        float maxDepth = 0.0f;
+        for (uint32_t y = minY >> levelIndex; y <= maxY >> levelIndex; ++y)
+        {
+            for (uint32_t x = minX >> levelIndex; x <= maxX >> levelIndex; ++x)
+            {
+                maxDepth = std::max(maxDepth, depthLevel.Depths[y * depthLevel.Width + x]);
+            }
+        }
+
+        return rect.MinDepth > maxDepth;
+    }
+
+    void OcclusionCuller::SelectOccluders(std::span<const Occluder> candidates)
+    {
+        const auto width = (float)GetWidth();
+        const auto height = (float)GetHeight();
+
+        m_CandidateScreenSizes.resize(candidates.size());
+        m_OccluderIndices.clear();
+
+        for (const auto [i, candidate] : candidates | std::views::enumerate)
+        {
+            ScreenRect rect;
+            if (!ProjectAabb(candidate.WorldAabb, m_ViewProjection, width, height, rect))
+            {
+                // The camera is inside or close to the box
+                m_CandidateScreenSizes[i] = std::numeric_limits<float>::infinity();
+            }
+            else
+            {
+                const float visibleWidth = std::min(rect.MaxX, width) - std::max(rect.MinX, 0.0f);
+                const float visibleHeight = std::min(rect.MaxY, height) - std::max(rect.MinY, 0.0f);
+
+                m_CandidateScreenSizes[i] = std::max(visibleWidth / width, visibleHeight / height);
+            }
+
+            if (m_CandidateScreenSizes[i] >= m_Creation.MinOccluderScreenSize)
+            {
+                m_OccluderIndices.push_back((uint32_t)i);
+            }
+        }
+
+        std::ranges::sort(m_OccluderIndices, std::greater{}, [&](uint32_t candidateIndex) { return m_CandidateScreenSizes[candidateIndex]; });
+
+        // Smaller occluders may still fit after a larger one is skipped
+        uint32_t occluderCount = 0;
+        for (const uint32_t candidateIndex : m_OccluderIndices)
+        {
+            const auto triangleCount = (uint32_t)candidates[candidateIndex].Indices.size() / 3;
+            if (m_Stats.OccluderTriangleCount + triangleCount > m_Creation.MaxOccluderTriangleCount)
+            {
+                continue;
+            }
+
+            m_Stats.OccluderTriangleCount += triangleCount;
+            m_OccluderIndices[occluderCount++] = candidateIndex;
+        }
+
+        m_OccluderIndices.resize(occluderCount);
+        m_Stats.OccluderCount = occluderCount;
+    }
+
+    void OcclusionCuller::SetupTriangles(std::span<const Occluder> candidates)
+    {
+        if (m_OccluderScratches.size() < m_OccluderIndices.size())
+        {
+            m_OccluderScratches.resize(m_OccluderIndices.size());
+        }
+
+        ParallelFor((uint32_t)m_OccluderIndices.size(), 1, [&](uint32_t occluderIndex)
+        {
+            const Occluder& occluder = candidates[m_OccluderIndices[occluderIndex]];
+            const DirectX::XMMATRIX worldViewProjection = occluder.WorldMatrix * m_ViewProjection;
+
+            auto& scratch = m_OccluderScratches[occluderIndex];
+            scratch.ClipVertices.resize(occluder.Vertices.size());
+            scratch.Outcodes.resize(occluder.Vertices.size());
+            scratch.Triangles.clear();
+
+            for (size_t i = 0; i < occluder.Vertices.size(); ++i)
+            {
+                DirectX::XMStoreFloat4(&scratch.ClipVertices[i], DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&occluder.Vertices[i].Position), worldViewProjection));
+                scratch.Outcodes[i] = (uint8_t)GetOutcode(scratch.ClipVertices[i]);
+            }
+
+            for (size_t i = 0; i + 2 < occluder.Indices.size(); i += 3)
+            {
+                const std::array<uint32_t, 3> indices{ occluder.Indices[i], occluder.Indices[i + 1], occluder.Indices[i + 2] };
+
+                ClipAndSetupTriangle(
+                    { &scratch.ClipVertices[indices[0]], &scratch.ClipVertices[indices[1]], &scratch.ClipVertices[indices[2]] },
+                    { scratch.Outcodes[indices[0]], scratch.Outcodes[indices[1]], scratch.Outcodes[indices[2]] },
+                    GetWidth(),
+                    GetHeight(),
+                    scratch.Triangles
+                );
+            }
+
+            if (m_Creation.IsCoverageConservative)
+            {
+                std::ranges::for_each(scratch.Triangles, [](auto& triangle) { ShrinkToWholePixels(triangle); });
+            }
+        });
+
+        for (uint32_t i = 0; i < (uint32_t)m_OccluderIndices.size(); ++i)
+        {
+            m_Stats.RasterizedTriangleCount += (uint32_t)m_OccluderScratches[i].Triangles.size();
+        }
+    }
+
+    void OcclusionCuller::BinTriangles()
+    {
+        const uint32_t tileCount = m_TileCountX * m_TileCountY;
+        const std::span<const OccluderScratch> occluderScratches{ m_OccluderScratches.data(), m_OccluderIndices.size() };
+
+        const auto forEachTriangleTile = [&](const auto& function)
+        {
+            for (const auto& scratch : occluderScratches)
+            {
+                for (const auto& triangle : scratch.Triangles)
+                {
+                    for (uint32_t tileY = triangle.MinY / g_OcclusionTileSize; tileY <= triangle.MaxY / g_OcclusionTileSize; ++tileY)
+                    {
+                        for (uint32_t tileX = triangle.MinX / g_OcclusionTileSize; tileX <= triangle.MaxX / g_OcclusionTileSize; ++tileX)
+                        {
+                            function(triangle, tileY * m_TileCountX + tileX);
+                        }
+                    }
+                }
+            }
+        };
+
+        // Counts are turned into range ends, then every triangle decrements the end of its tile, which leaves range starts
+        m_TileTriangleOffsets.assign(tileCount + 1, 0);
+        forEachTriangleTile([&](const RasterTriangle&, uint32_t tileIndex) { ++m_TileTriangleOffsets[tileIndex]; });
+
+        std::inclusive_scan(m_TileTriangleOffsets.begin(), m_TileTriangleOffsets.end() - 1, m_TileTriangleOffsets.begin());
+        m_TileTriangleOffsets[tileCount] = tileCount != 0 ? m_TileTriangleOffsets[tileCount - 1] : 0;
+
+        m_TileTriangles.resize(m_TileTriangleOffsets[tileCount]);
+        forEachTriangleTile([&](const RasterTriangle& triangle, uint32_t tileIndex) { m_TileTriangles[--m_TileTriangleOffsets[tileIndex]] = &triangle; });
+    }
+
+    void OcclusionCuller::RasterizeTile(uint32_t tileIndex)
+    {
+        const uint32_t width = GetWidth();
+        float* depths = m_DepthLevels[0].Depths.data();
+
+        const uint32_t tileMinX = tileIndex % m_TileCountX * g_OcclusionTileSize;
+        const uint32_t tileMinY = tileIndex / m_TileCountX * g_OcclusionTileSize;
+        const uint32_t tileMaxX = tileMinX + g_OcclusionTileSize - 1;
+        const uint32_t tileMaxY = tileMinY + g_OcclusionTileSize - 1;
+
+        for (uint32_t y = tileMinY; y <= tileMaxY; ++y)
+        {
+            std::fill_n(depths + y * width + tileMinX, g_OcclusionTileSize, 1.0f);
+        }
+
+        const __m128 pixelCenterOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+
+        for (uint32_t i = m_TileTriangleOffsets[tileIndex]; i < m_TileTriangleOffsets[tileIndex + 1]; ++i)
+        {
+            const RasterTriangle& triangle = *m_TileTriangles[i];
+
+            // Tiles are aligned to 4 pixels, columns left of the triangle fail the edge tests
+            const uint32_t minX = std::max<uint32_t>(triangle.MinX, tileMinX) & ~3u;
+            const uint32_t minY = std::max<uint32_t>(triangle.MinY, tileMinY);
+            const uint32_t maxX = std::min<uint32_t>(triangle.MaxX, tileMaxX);
+            const uint32_t maxY = std::min<uint32_t>(triangle.MaxY, tileMaxY);
+
+            const __m128 edgeA0 = _mm_set1_ps(triangle.EdgeA[0]);
+            const __m128 edgeA1 = _mm_set1_ps(triangle.EdgeA[1]);
+            const __m128 edgeA2 = _mm_set1_ps(triangle.EdgeA[2]);
+            const __m128 depthA = _mm_set1_ps(triangle.DepthA);
+
+            for (uint32_t y = minY; y <= maxY; ++y)
+            {
+                const float pixelCenterY = (float)y + 0.5f;
+
+                // Row parts of edge functions and depth, 'A * x + (B * y + C)'
+                const __m128 edgeRow0 = _mm_set1_ps(triangle.EdgeB[0] * pixelCenterY + triangle.EdgeC[0]);
+                const __m128 edgeRow1 = _mm_set1_ps(triangle.EdgeB[1] * pixelCenterY + triangle.EdgeC[1]);
+                const __m128 edgeRow2 = _mm_set1_ps(triangle.EdgeB[2] * pixelCenterY + triangle.EdgeC[2]);
+                const __m128 depthRow = _mm_set1_ps(triangle.DepthB * pixelCenterY + triangle.DepthC);
+
+                float* rowDepths = depths + y * width;
+
+                for (uint32_t x = minX; x <= maxX; x += 4)
+                {
+                    const __m128 pixelCenterX = _mm_add_ps(_mm_set1_ps((float)x), pixelCenterOffsets);
+
+                    const __m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeA0, pixelCenterX), edgeRow0);
+                    const __m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeA1, pixelCenterX), edgeRow1);
+                    const __m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeA2, pixelCenterX), edgeRow2);
+
+                    const __m128 isInside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+                    if (_mm_movemask_ps(isInside) == 0)
+                    {
+                        continue;
+                    }
+
+                    const __m128 depth = _mm_add_ps(_mm_mul_ps(depthA, pixelCenterX), depthRow);
+
+                    const __m128 oldDepths = _mm_loadu_ps(rowDepths + x);
+                    const __m128 newDepths = _mm_min_ps(oldDepths, depth);
+                    _mm_storeu_ps(rowDepths + x, _mm_or_ps(_mm_and_ps(isInside, newDepths), _mm_andnot_ps(isInside, oldDepths)));
+                }
+            }
+        }
+    }
+
+    void OcclusionCuller::ReduceTile(uint32_t tileIndex)
+    {
+        const uint32_t tileX = tileIndex % m_TileCountX;
+        const uint32_t tileY = tileIndex / m_TileCountX;
+
+        for (uint32_t levelIndex = 1; levelIndex < m_TileLevelCount; ++levelIndex)
+        {
+            const DepthLevel& sourceLevel = m_DepthLevels[levelIndex - 1];
+            DepthLevel& level = m_DepthLevels[levelIndex];
+
+            const uint32_t levelTileSize = g_OcclusionTileSize >> levelIndex;
+
+            for (uint32_t y = tileY * levelTileSize; y < (tileY + 1) * levelTileSize; ++y)
+            {
+                const float* sourceRow0 = sourceLevel.Depths.data() + 2 * y * sourceLevel.Width;
+                const float* sourceRow1 = sourceRow0 + sourceLevel.Width;
+
+                for (uint32_t x = tileX * levelTileSize; x < (tileX + 1) * levelTileSize; ++x)
+                {
+                    level.Depths[y * level.Width + x] = std::max({ sourceRow0[2 * x], sourceRow0[2 * x + 1], sourceRow1[2 * x], sourceRow1[2 * x + 1] });
+                }
+            }
+        }
+    }
+
+    void OcclusionCuller::BuildCoarseDepthLevels()
+    {
+        for (uint32_t levelIndex = m_TileLevelCount; levelIndex < (uint32_t)m_DepthLevels.size(); ++levelIndex)
+        {
+            const DepthLevel& sourceLevel = m_DepthLevels[levelIndex - 1];
+            DepthLevel& level = m_DepthLevels[levelIndex];
+
+            // Odd sizes are rounded up, the last texel takes the clamped source texels
+            for (uint32_t y = 0; y < level.Height; ++y)
+            {
+                const uint32_t sourceY0 = 2 * y;
+                const uint32_t sourceY1 = std::min(2 * y + 1, sourceLevel.Height - 1);
+
+                for (uint32_t x = 0; x < level.Width; ++x)
+                {
+                    const uint32_t sourceX0 = 2 * x;
+                    const uint32_t sourceX1 = std::min(2 * x + 1, sourceLevel.Width - 1);
+
+                    level.Depths[y * level.Width + x] = std::max({
+                        sourceLevel.Depths[sourceY0 * sourceLevel.Width + sourceX0],
+                        sourceLevel.Depths[sourceY0 * sourceLevel.Width + sourceX1],
+                        sourceLevel.Depths[sourceY1 * sourceLevel.Width + sourceX0],
+                        sourceLevel.Depths[sourceY1 * sourceLevel.Width + sourceX1],
+                    });
+                }
+            }
+        }
+    }
+
+} // namespace benzin
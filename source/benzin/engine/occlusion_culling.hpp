@@ -0,0 +1,140 @@
+#pragma once
+
+#include "benzin/engine/frustum_culling.hpp"
+
+namespace joint
+{
+
+    struct MeshVertex;
+
+} // namespace joint
+
+namespace benzin
+{
+
+    inline constexpr uint32_t g_OcclusionTileSize = 32; // Pixels of a tile side, every tile is rasterized by a separate job
+
+    struct OcclusionCullerCreation
+    {
+        uint32_t Width = 320; // Multiple of 'g_OcclusionTileSize'
+        uint32_t Height = 192; // Multiple of 'g_OcclusionTileSize'
+
+        uint32_t MaxOccluderTriangleCount = 32 * 1024;
+        float MinOccluderScreenSize = 0.1f; // Larger side of the projected bounding box relative to the screen side
+
+        // Only pixels covered whole by a triangle are written, with the farthest depth of the pixel. Occluders never hide what is seen
+        // through gaps narrower than a pixel, but every edge loses up to a pixel, including edges shared by triangles of one surface
+        bool IsCoverageConservative = false;
+    };
+
+    // Triangle list in local space, every vertex is transformed once
+    struct Occluder
+    {
+        std::span<const joint::MeshVertex> Vertices;
+        std::span<const uint32_t> Indices;
+
+        DirectX::XMMATRIX WorldMatrix = DirectX::XMMatrixIdentity();
+        Aabb WorldAabb;
+    };
+
+    struct OcclusionCullingStats
+    {
+        uint32_t OccluderCount = 0;
+        uint32_t OccluderTriangleCount = 0;
+        uint32_t RasterizedTriangleCount = 0; // After clipping, triangles which cover no pixel center are dropped
+
+        std::chrono::microseconds SetupTime{ 0 }; // Occluder selection, transformation and clipping
+        std::chrono::microseconds RasterizationTime{ 0 }; // Binning, tiles and the depth pyramid
+    };
+
+    // Depth only software rasterizer for CPU occlusion culling. The occluders that are the largest on screen are rasterized
+    // into a low resolution depth buffer, tiles are rasterized in parallel 4 pixels at once. Every tile reduces its depths
+    // into a max depth pyramid, so a box is tested against at most 4x4 texels of the level where its screen rectangle spans 4 texels.
+    // Depths are sampled at pixel centers like the hardware rasterizer, so the test is conservative only up to the coverage of pixel centers.
+    // At the default 320x192 a pixel is several screen pixels wide: an object seen only through a gap between occluders that is
+    // narrower than a pixel, e.g. between two walls or through a grate, contains no pixel center and can be wrongly culled.
+    // 'OcclusionCullerCreation::IsCoverageConservative' removes that case at the cost of less culling
+    class OcclusionCuller
+    {
+    public:
+        explicit OcclusionCuller(const OcclusionCullerCreation& creation = {});
+
+    public:
+        uint32_t GetWidth() const { return m_DepthLevels[0].Width; }
+        uint32_t GetHeight() const { return m_DepthLevels[0].Height; }
+        uint32_t GetDepthLevelCount() const { return (uint32_t)m_DepthLevels.size(); }
+
+        std::span<const float> GetDepths(uint32_t levelIndex = 0) const { return m_DepthLevels[levelIndex].Depths; } // Row major, cleared to 1.0
+
+        const auto& GetStats() const { return m_Stats; }
+
+    public:
+        // Picks occluders from 'candidates' by screen size until the triangle budget is spent and rasterizes them.
+        // 'viewProjection' has to map depth to [0, 1], both faces of triangles are rasterized
+        void Render(const DirectX::XMMATRIX& viewProjection, std::span<const Occluder> candidates);
+
+        // Tests against the depths of the last 'Render'. Boxes crossing the near plane or outside of the screen are never occluded
+        bool IsOccluded(const Aabb& worldAabb) const;
+
+    private:
+        struct DepthLevel
+        {
+            uint32_t Width = 0;
+            uint32_t Height = 0;
+            std::vector<float> Depths;
+        };
+
+        struct RasterTriangle
+        {
+            std::array<float, 3> EdgeA; // Edge functions 'A * x + B * y + C' are positive inside
+            std::array<float, 3> EdgeB;
+            std::array<float, 3> EdgeC;
+
+            float DepthA = 0.0f; // Depth plane 'DepthA * x + DepthB * y + DepthC'
+            float DepthB = 0.0f;
+            float DepthC = 0.0f;
+
+            uint16_t MinX = 0; // Covered pixels, inclusive
+            uint16_t MinY = 0;
+            uint16_t MaxX = 0;
+            uint16_t MaxY = 0;
+        };
+
+        // Kept between frames, so vectors don't allocate
+        struct OccluderScratch
+        {
+            std::vector<DirectX::XMFLOAT4> ClipVertices;
+            std::vector<uint8_t> Outcodes; // Clip planes which vertices are outside of
+            std::vector<RasterTriangle> Triangles;
+        };
+
+    private:
+        void SelectOccluders(std::span<const Occluder> candidates);
+        void SetupTriangles(std::span<const Occluder> candidates);
+        void BinTriangles();
+        void RasterizeTile(uint32_t tileIndex);
+        void ReduceTile(uint32_t tileIndex);
+        void BuildCoarseDepthLevels();
+
+    private:
+        OcclusionCullerCreation m_Creation;
+
+        uint32_t m_TileCountX = 0;
+        uint32_t m_TileCountY = 0;
+        uint32_t m_TileLevelCount = 0; // Levels reduced by tiles, the last one has a texel per tile
+
+        DirectX::XMMATRIX m_ViewProjection = DirectX::XMMatrixIdentity();
+
+        std::vector<float> m_CandidateScreenSizes;
+        std::vector<uint32_t> m_OccluderIndices; // Into candidates
+        std::vector<OccluderScratch> m_OccluderScratches; // By selected occluder, grow on demand
+
+        std::vector<uint32_t> m_TileTriangleOffsets; // 'm_TileTriangles' range of every tile and the total count at the end
+        std::vector<const RasterTriangle*> m_TileTriangles;
+
+        std::vector<DepthLevel> m_DepthLevels;
+
+        OcclusionCullingStats m_Stats;
+    };
+
+} // namespace benzin
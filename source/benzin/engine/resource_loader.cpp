@@ -1,22 +1,237 @@
 #include "benzin/config/bootstrap.hpp"
 #include "benzin/engine/resource_loader.hpp"
 
+#include <third_party/tinygltf/json.hpp>
 #include <third_party/tinygltf/stb_image.h>
 #include <third_party/tinygltf/tiny_gltf.h>
 
 #include <shaders/joint/structured_buffer_types.hpp>
 
 #include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
 #include "benzin/core/logger.hpp"
 #include "benzin/core/math.hpp"
+#include "benzin/engine/mesh_collection_cache.hpp"
+#include "benzin/engine/mesh_optimizer.hpp"
+#include "benzin/engine/meshopt_decoder.hpp"
+#include "benzin/engine/mesh_simplifier.hpp"
+#include "benzin/engine/meshlet_builder.hpp"
+#include "benzin/engine/static_batcher.hpp"
+#include "benzin/engine/tangent_generator.hpp"
+#include "benzin/engine/texture_compressor.hpp"
+#include "benzin/engine/texture_mip_generator.hpp"
+#include "benzin/engine/vertex_packing.hpp"
+#include "benzin/utility/hash_utils.hpp"
+#include "benzin/utility/time_utils.hpp"
 
 namespace benzin
 {
 
+    // Image loader for 'tinygltf', which only records encoded bytes. Decoding is done later by 'ParseTextures' on all cores
+    static bool RecordEncodedImage(tinygltf::Image* gltfImage, const int gltfImageIndex, std::string* error, std::string* warning, int requiredWidth, int requiredHeight, const unsigned char* bytes, int size, void* userData)
+    {
+        gltfImage->image.assign(bytes, bytes + size);
+        gltfImage->as_is = true;
+
+        return true;
+    }
+
+    // Decoded Rgba8 pixels, 'Owner' keeps 'Data' alive
+    struct DecodedImage
+    {
+        std::shared_ptr<const void> Owner;
+        std::span<const std::byte> Data;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+    };
+
+    static DecodedImage DecodeGltfImage(tinygltf::Image& gltfImage)
+    {
+        DecodedImage decodedImage;
+
+        if (gltfImage.as_is)
+        {
+            int width = 0;
+            int height = 0;
+            int componentCount = 0;
+            stbi_uc* decodedImageData = stbi_load_from_memory(gltfImage.image.data(), (int)gltfImage.image.size(), &width, &height, &componentCount, 4);
+            BenzinAssert(decodedImageData);
+
+            decodedImage.Owner = std::shared_ptr<stbi_uc>{ decodedImageData, stbi_image_free };
+            decodedImage.Data = std::as_bytes(std::span{ decodedImageData, (size_t)width * height * 4 });
+            decodedImage.Width = (uint32_t)width;
+            decodedImage.Height = (uint32_t)height;
+        }
+        else
+        {
+            BenzinAssert(gltfImage.bits == 8);
+            BenzinAssert(gltfImage.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE);
+
+            // 'tinygltf' has already decoded the image, its buffer is moved out of the model
+            auto pixels = std::make_shared<std::vector<unsigned char>>(std::move(gltfImage.image));
+
+            decodedImage.Data = std::as_bytes(std::span{ *pixels });
+            decodedImage.Owner = std::move(pixels);
+            decodedImage.Width = (uint32_t)gltfImage.width;
+            decodedImage.Height = (uint32_t)gltfImage.height;
+        }
+
+        return decodedImage;
+    }
+
+    // File reader for 'tinygltf' that copies external images straight from a mapping instead of going through 'std::ifstream'.
+    // Buffers aren't copied, they are mapped by 'GltfReader'
+    static bool ReadWholeMappedFile(std::vector<unsigned char>* outData, std::string* error, const std::string& filePath, void* userData)
+    {
+        const MappedFile mappedFile{ filePath };
+        if (!mappedFile.IsValid())
+        {
+            if (error)
+            {
+                *error += std::format("Failed to map file {}\n", filePath);
+            }
+
+            return false;
+        }
+
+        const auto data = mappedFile.GetData();
+        outData->resize(data.size());
+        std::memcpy(outData->data(), data.data(), data.size());
+
+        return true;
+    }
+
+    // glTF rules for normalized integers: 'c / max' for unsigned and 'max(c / max, -1)' for signed types
+    template <typename T>
+    static float DequantizeGltfComponent(T value, bool isNormalized)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            return value;
+        }
+        else
+        {
+            if (!isNormalized)
+            {
+                return (float)value;
+            }
+
+            const float normalized = (float)value / (float)std::numeric_limits<T>::max();
+            return std::is_signed_v<T> ? std::max(normalized, -1.0f) : normalized;
+        }
+    }
+
+    // Fields are validated here, because the decoder only checks the encoded stream.
+    // 'EXT_meshopt_compression' limits: attribute strides are multiples of 4 up to 256, index strides are 2 or 4,
+    // triangle counts are multiples of 3 and filters apply only to attributes with the sizes they are defined for
+    static std::optional<MeshoptBufferViewDesc> ParseMeshoptBufferViewDesc(const tinygltf::Value& gltfExtension)
+    {
+        static const std::unordered_map<std::string, MeshoptCompressionMode> modes
+        {
+            { "ATTRIBUTES", MeshoptCompressionMode::Attributes },
+            { "TRIANGLES", MeshoptCompressionMode::Triangles },
+            { "INDICES", MeshoptCompressionMode::Indices },
+        };
+
+        static const std::unordered_map<std::string, MeshoptCompressionFilter> filters
+        {
+            { "NONE", MeshoptCompressionFilter::None },
+            { "OCTAHEDRAL", MeshoptCompressionFilter::Octahedral },
+            { "QUATERNION", MeshoptCompressionFilter::Quaternion },
+            { "EXPONENTIAL", MeshoptCompressionFilter::Exponential },
+        };
+
+        if (!gltfExtension.Get("count").IsNumber() || !gltfExtension.Get("byteStride").IsNumber())
+        {
+            return std::nullopt;
+        }
+
+        const auto modeIt = modes.find(gltfExtension.Get("mode").Get<std::string>());
+        const auto filterIt = filters.find(gltfExtension.Has("filter") ? gltfExtension.Get("filter").Get<std::string>() : "NONE");
+
+        if (modeIt == modes.end() || filterIt == filters.end())
+        {
+            return std::nullopt;
+        }
+
+        const int count = gltfExtension.Get("count").GetNumberAsInt();
+        const int byteStride = gltfExtension.Get("byteStride").GetNumberAsInt();
+
+        if (count < 0)
+        {
+            return std::nullopt;
+        }
+
+        const MeshoptCompressionMode mode = modeIt->second;
+        const MeshoptCompressionFilter filter = filterIt->second;
+
+        if (mode == MeshoptCompressionMode::Attributes)
+        {
+            if (byteStride < 4 || byteStride > 256 || byteStride % 4 != 0)
+            {
+                return std::nullopt;
+            }
+
+            const bool isFilterValid =
+                filter == MeshoptCompressionFilter::None ||
+                filter == MeshoptCompressionFilter::Exponential ||
+                (filter == MeshoptCompressionFilter::Octahedral && (byteStride == 4 || byteStride == 8)) ||
+                (filter == MeshoptCompressionFilter::Quaternion && byteStride == 8);
+
+            if (!isFilterValid)
+            {
+                return std::nullopt;
+            }
+        }
+        else
+        {
+            if ((byteStride != 2 && byteStride != 4) || filter != MeshoptCompressionFilter::None)
+            {
+                return std::nullopt;
+            }
+
+            if (mode == MeshoptCompressionMode::Triangles && count % 3 != 0)
+            {
+                return std::nullopt;
+            }
+        }
+
+        return MeshoptBufferViewDesc
+        {
+            .Mode = mode,
+            .Filter = filter,
+            .Count = (uint32_t)count,
+            .ByteStride = (uint32_t)byteStride,
+        };
+    }
+
+    static std::span<const std::byte> GetGltfBufferData(const tinygltf::Buffer& gltfBuffer)
+    {
+        return std::as_bytes(std::span{ gltfBuffer.GetData(), gltfBuffer.GetSize() });
+    }
+
     class GltfReader
     {
     public:
-        bool ReadFromFile(std::string_view fileName, MeshCollectionResource& outMeshCollection)
+        BenzinDefineNonCopyable(GltfReader);
+        BenzinDefineNonMoveable(GltfReader);
+
+    public:
+        GltfReader()
+        {
+            m_Context.SetFsCallbacks(tinygltf::FsCallbacks
+            {
+                .FileExists = tinygltf::FileExists,
+                .ExpandFilePath = tinygltf::ExpandFilePath,
+                .ReadWholeFile = ReadWholeMappedFile,
+                .WriteWholeFile = tinygltf::WriteWholeFile,
+                .user_data = this,
+                .MapWholeFile = MapWholeFile,
+            });
+        }
+
+    public:
+        bool ReadFromFile(std::string_view fileName, MeshCollectionLoadingFlags flags, MeshCollectionResource& outMeshCollection)
         {
             const std::filesystem::path filePath = config::g_ModelDirPath / fileName;
             BenzinAssert(std::filesystem::exists(filePath));
@@ -28,16 +243,38 @@ namespace benzin
 
             const std::string filePathStr = filePath.string();
 
+            // The model stays partially loaded on failure, so it's reset on every exit
+            BenzinExecuteOnScopeExit([&] { ResetState(); });
+
+            if (flags.IsSet(MeshCollectionLoadingFlag::DeferImageDecoding))
+            {
+                m_Context.SetImageLoader(RecordEncodedImage, nullptr);
+            }
+            else
+            {
+                m_Context.RemoveImageLoader();
+            }
+
             {
                 BenzinLogTimeOnScopeExit("GLTF Reader: LoadFromFile {}", filePathStr);
 
+                // 'tinygltf' parses JSON right from the mapping and buffers reference the GLB binary chunk in it,
+                // so the file is never copied. The mapping is kept until the model is parsed
+                const MappedFile& mappedFile = *m_MappedFiles.emplace_back(std::make_unique<MappedFile>(filePath));
+                BenzinAssert(mappedFile.IsValid());
+
+                const auto fileData = mappedFile.GetData();
+                BenzinAssert(fileData.size() <= std::numeric_limits<unsigned int>::max());
+
+                const std::string baseDirectory = filePath.parent_path().string();
+
                 if (filePath.extension() == ".glb")
                 {
-                    isFileLoadingSucceed = m_Context.LoadBinaryFromFile(&m_CurrentModel, &error, &warning, filePathStr);
+                    isFileLoadingSucceed = m_Context.LoadBinaryFromMemory(&m_CurrentModel, &error, &warning, reinterpret_cast<const unsigned char*>(fileData.data()), (unsigned int)fileData.size(), baseDirectory);
                 }
                 else if (filePath.extension() == ".gltf")
                 {
-                    isFileLoadingSucceed = m_Context.LoadASCIIFromFile(&m_CurrentModel, &error, &warning, filePathStr);
+                    isFileLoadingSucceed = m_Context.LoadASCIIFromString(&m_CurrentModel, &error, &warning, reinterpret_cast<const char*>(fileData.data()), (unsigned int)fileData.size(), baseDirectory);
                 }
             }
 
@@ -48,7 +285,7 @@ namespace benzin
             }
             else if (!error.empty())
             {
-                BenzinWarning("GLTF Reader: {}", warning);
+                BenzinError("GLTF Reader: {}", error);
                 return false;
             }
             else if (!isFileLoadingSucceed)
@@ -59,9 +296,15 @@ namespace benzin
 
             outMeshCollection.DebugName = CutExtension(fileName);
 
+            if (!DecodeMeshoptBufferViews(outMeshCollection.DebugName))
+            {
+                BenzinWarning("GLTF Reader: Failed to decode EXT_meshopt_compression buffers of {}", filePathStr);
+                return false;
+            }
+
             {
                 BenzinLogTimeOnScopeExit("GLTF Reader: {} ParseMeshPrimitives", outMeshCollection.DebugName);
-                ParseMeshPrimitives(outMeshCollection);
+                ParseMeshPrimitives(flags, outMeshCollection);
             }
 
             {
@@ -69,6 +312,21 @@ namespace benzin
                 ParseNodes(outMeshCollection);
             }
 
+            if (flags.IsSet(MeshCollectionLoadingFlag::BatchStaticMeshes))
+            {
+                BenzinLogTimeOnScopeExit("GLTF Reader: {} BatchStaticMeshes", outMeshCollection.DebugName);
+
+                const StaticBatchingStats stats = BatchStaticMeshInstances(outMeshCollection);
+                BenzinTrace(
+                    "GLTF Reader: {} BatchStaticMeshes, {} batches, {} -> {} instances, {} -> {} meshes, {} -> {} vertices",
+                    outMeshCollection.DebugName,
+                    stats.BatchCount,
+                    stats.MeshInstanceCountBefore, stats.MeshInstanceCountAfter,
+                    stats.MeshCountBefore, stats.MeshCountAfter,
+                    stats.VertexCountBefore, stats.VertexCountAfter
+                );
+            }
+
             {
                 BenzinLogTimeOnScopeExit("GLTF Reader: {} ParseMaterials", outMeshCollection.DebugName);
                 ParseMaterials(outMeshCollection);
@@ -76,15 +334,125 @@ namespace benzin
 
             {
                 BenzinLogTimeOnScopeExit("GLTF Reader: {} ParseTextures", outMeshCollection.DebugName);
-                ParseTextures(outMeshCollection);
+                ParseTextures(flags, outMeshCollection);
             }
 
-            ResetState();
-
             return true;
         }
 
     private:
+        // Compressed buffer views are decoded up front, so primitives can be parsed in parallel without locking
+        bool DecodeMeshoptBufferViews(std::string_view debugName)
+        {
+            struct CompressedBufferView
+            {
+                size_t BufferViewIndex = 0;
+                MeshoptBufferViewDesc Desc;
+                std::span<const std::byte> Source;
+            };
+
+            std::vector<CompressedBufferView> compressedBufferViews;
+            m_DecodedBufferViews.resize(m_CurrentModel.bufferViews.size());
+
+            for (const auto& [i, gltfBufferView] : m_CurrentModel.bufferViews | std::views::enumerate)
+            {
+                const auto extensionIt = gltfBufferView.extensions.find("EXT_meshopt_compression");
+                if (extensionIt == gltfBufferView.extensions.end())
+                {
+                    continue;
+                }
+
+                const tinygltf::Value& gltfExtension = extensionIt->second;
+
+                const std::optional<MeshoptBufferViewDesc> desc = ParseMeshoptBufferViewDesc(gltfExtension);
+                if (!desc)
+                {
+                    return false;
+                }
+
+                const tinygltf::Value& gltfBufferIndex = gltfExtension.Get("buffer");
+                const tinygltf::Value& gltfByteOffset = gltfExtension.Get("byteOffset");
+                const tinygltf::Value& gltfByteLength = gltfExtension.Get("byteLength");
+
+                if (!gltfBufferIndex.IsNumber() || !gltfByteLength.IsNumber() || (gltfExtension.Has("byteOffset") && !gltfByteOffset.IsNumber()))
+                {
+                    return false;
+                }
+
+                const int bufferIndex = gltfBufferIndex.GetNumberAsInt();
+                const int64_t byteOffset = gltfExtension.Has("byteOffset") ? (int64_t)gltfByteOffset.GetNumberAsDouble() : 0;
+                const auto byteLength = (int64_t)gltfByteLength.GetNumberAsDouble();
+
+                if (bufferIndex < 0 || bufferIndex >= (int)m_CurrentModel.buffers.size())
+                {
+                    return false;
+                }
+
+                const tinygltf::Buffer& gltfBuffer = m_CurrentModel.buffers[bufferIndex];
+
+                if (byteOffset < 0 || byteLength < 0 || (uint64_t)(byteOffset + byteLength) > gltfBuffer.GetSize())
+                {
+                    return false;
+                }
+
+                m_DecodedBufferViews[i].resize((size_t)desc->Count * desc->ByteStride);
+
+                compressedBufferViews.push_back(CompressedBufferView
+                {
+                    .BufferViewIndex = (size_t)i,
+                    .Desc = *desc,
+                    .Source = GetGltfBufferData(gltfBuffer).subspan((size_t)byteOffset, (size_t)byteLength),
+                });
+            }
+
+            if (compressedBufferViews.empty())
+            {
+                return true;
+            }
+
+            std::vector<uint8_t> isDecoded(compressedBufferViews.size(), false);
+
+            const auto decodingTime = ProfileFunction([&]
+            {
+                ParallelForEach(compressedBufferViews, [&](const CompressedBufferView& compressedBufferView)
+                {
+                    const size_t index = &compressedBufferView - compressedBufferViews.data();
+                    isDecoded[index] = DecodeMeshoptBufferView(compressedBufferView.Desc, compressedBufferView.Source, m_DecodedBufferViews[compressedBufferView.BufferViewIndex]);
+                });
+            });
+
+            size_t compressedSizeInBytes = 0;
+            size_t decodedSizeInBytes = 0;
+            for (const CompressedBufferView& compressedBufferView : compressedBufferViews)
+            {
+                compressedSizeInBytes += compressedBufferView.Source.size();
+                decodedSizeInBytes += m_DecodedBufferViews[compressedBufferView.BufferViewIndex].size();
+            }
+
+            BenzinTrace(
+                "GLTF Reader: {} DecodeMeshoptBuffers, {} buffer views, {:.3f}Mb -> {:.3f}Mb, {:.3f}ms, {:.1f}Mb/s",
+                debugName, compressedBufferViews.size(),
+                BytesToFloatMb(compressedSizeInBytes), BytesToFloatMb(decodedSizeInBytes),
+                ToFloatMs(decodingTime), BytesToFloatMb(decodedSizeInBytes) / std::max(ToFloatSec(decodingTime), 1e-6f)
+            );
+
+            return std::ranges::all_of(isDecoded, [](uint8_t value) { return value != 0; });
+        }
+
+        // Decoded data for 'EXT_meshopt_compression' buffer views, the referenced buffer otherwise
+        std::span<const std::byte> GetBufferViewData(int bufferViewIndex) const
+        {
+            if (!m_DecodedBufferViews[bufferViewIndex].empty())
+            {
+                return m_DecodedBufferViews[bufferViewIndex];
+            }
+
+            const tinygltf::BufferView& gltfBufferView = m_CurrentModel.bufferViews[bufferViewIndex];
+            const tinygltf::Buffer& gltfBuffer = m_CurrentModel.buffers[gltfBufferView.buffer];
+
+            return GetGltfBufferData(gltfBuffer).subspan(gltfBufferView.byteOffset, gltfBufferView.byteLength);
+        }
+
         template <typename T>
         std::span<const T> GetBufferFromGLTFAccessor(int accessorIndex)
         {
@@ -94,23 +462,97 @@ namespace benzin
             }
 
             const tinygltf::Accessor& gltfAccessor = m_CurrentModel.accessors[accessorIndex];
-            const tinygltf::BufferView& gltfBufferView = m_CurrentModel.bufferViews[gltfAccessor.bufferView];
-            const tinygltf::Buffer& gltfBuffer = m_CurrentModel.buffers[gltfBufferView.buffer];
+            BenzinAssert(gltfAccessor.ByteStride(m_CurrentModel.bufferViews[gltfAccessor.bufferView]) == sizeof(T));
 
-            const size_t offsetInBytes = gltfBufferView.byteOffset + gltfAccessor.byteOffset;
+            const std::span<const std::byte> bufferViewData = GetBufferViewData(gltfAccessor.bufferView);
 
             return std::span
             {
-                reinterpret_cast<const T*>(gltfBuffer.data.data() + offsetInBytes),
+                reinterpret_cast<const T*>(bufferViewData.data() + gltfAccessor.byteOffset),
                 gltfAccessor.count
             };
         };
 
-        template <std::integral IndexType>
-        void ParseMeshPrimitive(const tinygltf::Primitive& gltfPrimitive, MeshCollectionResource& outMeshCollection)
+        // Accepts float and all integer component types allowed by 'KHR_mesh_quantization', both normalized and not.
+        // Positions stored as plain integers are left in quantized space, their dequantization is in node transforms
+        template <typename T>
+        std::vector<T> ReadFloatsFromGLTFAccessor(int accessorIndex)
         {
-            MeshData mesh;
+            constexpr size_t componentCount = sizeof(T) / sizeof(float);
+
+            if (accessorIndex == -1)
+            {
+                return {};
+            }
+
+            const tinygltf::Accessor& gltfAccessor = m_CurrentModel.accessors[accessorIndex];
+            BenzinAssert(!gltfAccessor.sparse.isSparse);
+            BenzinAssert((size_t)tinygltf::GetNumComponentsInType(gltfAccessor.type) == componentCount);
+
+            const int byteStride = gltfAccessor.ByteStride(m_CurrentModel.bufferViews[gltfAccessor.bufferView]);
+            BenzinAssert(byteStride > 0);
+
+            const std::byte* elements = GetBufferViewData(gltfAccessor.bufferView).data() + gltfAccessor.byteOffset;
+
+            std::vector<T> result(gltfAccessor.count);
+            auto* resultComponents = reinterpret_cast<float*>(result.data());
+
+            const auto ReadComponents = [&]<typename ComponentType>()
+            {
+                for (size_t i = 0; i < gltfAccessor.count; ++i)
+                {
+                    const std::byte* element = elements + i * byteStride;
+
+                    for (size_t j = 0; j < componentCount; ++j)
+                    {
+                        ComponentType component;
+                        std::memcpy(&component, element + j * sizeof(ComponentType), sizeof(ComponentType));
 
+                        resultComponents[i * componentCount + j] = DequantizeGltfComponent(component, gltfAccessor.normalized);
+                    }
+                }
+            };
+
+            switch (gltfAccessor.componentType)
+            {
+                case TINYGLTF_COMPONENT_TYPE_FLOAT:
+                {
+                    ReadComponents.template operator()<float>();
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_BYTE:
+                {
+                    ReadComponents.template operator()<int8_t>();
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                {
+                    ReadComponents.template operator()<uint8_t>();
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_SHORT:
+                {
+                    ReadComponents.template operator()<int16_t>();
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                {
+                    ReadComponents.template operator()<uint16_t>();
+                    break;
+                }
+                default:
+                {
+                    BenzinAssert(false);
+                    break;
+                }
+            }
+
+            return result;
+        }
+
+        template <std::integral IndexType>
+        void ParseMeshPrimitive(const tinygltf::Primitive& gltfPrimitive, MeshData& mesh)
+        {
             switch (gltfPrimitive.mode)
             {
                 case TINYGLTF_MODE_TRIANGLES:
@@ -133,14 +575,34 @@ namespace benzin
             const int positionAccessorIndex = gltfPrimitive.attributes.contains("POSITION") ? gltfPrimitive.attributes.at("POSITION") : -1;
             const int normalAccessorIndex = gltfPrimitive.attributes.contains("NORMAL") ? gltfPrimitive.attributes.at("NORMAL") : -1;
             const int uvAccessorIndex = gltfPrimitive.attributes.contains("TEXCOORD_0") ? gltfPrimitive.attributes.at("TEXCOORD_0") : -1;
+            const int tangentAccessorIndex = gltfPrimitive.attributes.contains("TANGENT") ? gltfPrimitive.attributes.at("TANGENT") : -1;
             const int indexAccessorIndex = gltfPrimitive.indices;
             BenzinAssert(!gltfPrimitive.attributes.contains("TEXCOORD_1")); // #TODO
 
-            const auto positions = GetBufferFromGLTFAccessor<DirectX::XMFLOAT3>(positionAccessorIndex);
-            const auto normals = GetBufferFromGLTFAccessor<DirectX::XMFLOAT3>(normalAccessorIndex);
-            const auto uvs = GetBufferFromGLTFAccessor<DirectX::XMFLOAT2>(uvAccessorIndex);
+            const auto positions = ReadFloatsFromGLTFAccessor<DirectX::XMFLOAT3>(positionAccessorIndex);
+            auto normals = ReadFloatsFromGLTFAccessor<DirectX::XMFLOAT3>(normalAccessorIndex);
+            const auto uvs = ReadFloatsFromGLTFAccessor<DirectX::XMFLOAT2>(uvAccessorIndex);
+            auto tangents = ReadFloatsFromGLTFAccessor<DirectX::XMFLOAT4>(tangentAccessorIndex);
             const auto indices = GetBufferFromGLTFAccessor<IndexType>(indexAccessorIndex);
 
+            // Quantized normals are only close to unit length
+            if (normalAccessorIndex != -1 && m_CurrentModel.accessors[normalAccessorIndex].componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+            {
+                for (DirectX::XMFLOAT3& normal : normals)
+                {
+                    DirectX::XMStoreFloat3(&normal, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&normal)));
+                }
+            }
+
+            if (tangentAccessorIndex != -1 && m_CurrentModel.accessors[tangentAccessorIndex].componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+            {
+                for (DirectX::XMFLOAT4& tangent : tangents)
+                {
+                    const DirectX::XMVECTOR normalizedTangent = DirectX::XMVector3Normalize(DirectX::XMLoadFloat4(&tangent));
+                    DirectX::XMStoreFloat4(&tangent, DirectX::XMVectorSetW(normalizedTangent, tangent.w < 0.0f ? -1.0f : 1.0f));
+                }
+            }
+
             BenzinAssert(!positions.empty());
 
             if (!normals.empty())
@@ -153,6 +615,11 @@ namespace benzin
                 BenzinAssert(uvs.size() == positions.size());
             }
 
+            if (!tangents.empty())
+            {
+                BenzinAssert(tangents.size() == positions.size());
+            }
+
             // Fill vertices
             mesh.Vertices.resize(positions.size());
             for (const auto& [i, meshVertex] : mesh.Vertices | std::views::enumerate)
@@ -168,13 +635,18 @@ namespace benzin
                 {
                     meshVertex.Uv = uvs[i];
                 }
+
+                if (!tangents.empty())
+                {
+                    meshVertex.Tangent = tangents[i];
+                }
             }
 
             // Fill indices
             mesh.Indices.resize(indices.size());
             if constexpr (std::is_same_v<IndexType, uint32_t>)
             {
-                memcpy(mesh.Indices.data(), indices.data(), indices.size());
+                memcpy(mesh.Indices.data(), indices.data(), indices.size_bytes());
             }
             else
             {
@@ -182,55 +654,213 @@ namespace benzin
             }
 
             mesh.BoundingBox = ComputeBoundingBox(mesh.Vertices);
-
-            outMeshCollection.Meshes.push_back(std::move(mesh));
         }
 
-        void ParseMesh(const tinygltf::Mesh& gltfMesh, MeshCollectionResource& outMeshCollection)
+        void ParseMeshPrimitive(const tinygltf::Primitive& gltfPrimitive, MeshData& outMesh)
         {
-            for (const tinygltf::Primitive& gltfPrimitive : gltfMesh.primitives)
-            {
-                BenzinAssert(gltfPrimitive.indices != -1);
-                const tinygltf::Accessor& indexBufferAccessor = m_CurrentModel.accessors[gltfPrimitive.indices];
+            BenzinAssert(gltfPrimitive.indices != -1);
+            const tinygltf::Accessor& indexBufferAccessor = m_CurrentModel.accessors[gltfPrimitive.indices];
 
-                switch (indexBufferAccessor.componentType)
+            switch (indexBufferAccessor.componentType)
+            {
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
                 {
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                    {
-                        ParseMeshPrimitive<uint8_t>(gltfPrimitive, outMeshCollection);
-                        break;
-                    }
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                    {
-                        ParseMeshPrimitive<uint16_t>(gltfPrimitive, outMeshCollection);
-                        break;
-                    }
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                    {
-                        ParseMeshPrimitive<uint32_t>(gltfPrimitive, outMeshCollection);
-                        break;
-                    }
-                    default:
-                    {
-                        BenzinAssert(false);
-                        break;
-                    }
+                    ParseMeshPrimitive<uint8_t>(gltfPrimitive, outMesh);
+                    break;
                 }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                {
+                    ParseMeshPrimitive<uint16_t>(gltfPrimitive, outMesh);
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                {
+                    ParseMeshPrimitive<uint32_t>(gltfPrimitive, outMesh);
+                    break;
+                }
+                default:
+                {
+                    BenzinAssert(false);
+                    break;
+                }
+            }
+        }
+
+        // Tangents are only used for normal mapping. The glTF spec asks for MikkTSpace tangents if they aren't provided
+        bool IsTangentGenerationNeeded(const tinygltf::Primitive& gltfPrimitive) const
+        {
+            if (gltfPrimitive.material == -1 || m_CurrentModel.materials[gltfPrimitive.material].normalTexture.index == -1)
+            {
+                return false;
             }
+
+            return !gltfPrimitive.attributes.contains("TANGENT") && gltfPrimitive.attributes.contains("NORMAL") && gltfPrimitive.attributes.contains("TEXCOORD_0");
         }
 
-        void ParseMeshPrimitives(MeshCollectionResource& outMeshCollection)
+        void ParseMeshPrimitives(MeshCollectionLoadingFlags flags, MeshCollectionResource& outMeshCollection)
         {
-            const size_t totalMeshCount = std::ranges::fold_left(m_CurrentModel.meshes, 0, [](size_t sum, const auto& gltfMesh) { return sum + gltfMesh.primitives.size(); });
-            outMeshCollection.Meshes.reserve(totalMeshCount);
+            // Every glTF primitive becomes a separate 'MeshData'. Flatten them first, so each primitive knows its output slot
+            std::vector<const tinygltf::Primitive*> gltfPrimitives;
+            m_MeshPrimitiveOffsets.reserve(m_CurrentModel.meshes.size());
 
             for (const tinygltf::Mesh& gltfMesh : m_CurrentModel.meshes)
             {
-                ParseMesh(gltfMesh, outMeshCollection);
+                m_MeshPrimitiveOffsets.push_back((uint32_t)gltfPrimitives.size());
+
+                for (const tinygltf::Primitive& gltfPrimitive : gltfMesh.primitives)
+                {
+                    gltfPrimitives.push_back(&gltfPrimitive);
+                }
+            }
+
+            outMeshCollection.Meshes.resize(gltfPrimitives.size());
+
+            const bool isWeldVertices = flags.IsSet(MeshCollectionLoadingFlag::WeldVertices);
+            std::vector<VertexWeldingStats> vertexWeldingStats(isWeldVertices ? gltfPrimitives.size() : 0);
+
+            const bool isGenerateTangents = flags.IsSet(MeshCollectionLoadingFlag::GenerateTangents);
+            std::vector<TangentGenerationStats> tangentGenerationStats(isGenerateTangents ? gltfPrimitives.size() : 0);
+
+            const bool isOptimizeMeshes = flags.IsSet(MeshCollectionLoadingFlag::OptimizeMeshes);
+            std::vector<MeshOptimizationStats> meshOptimizationStats(isOptimizeMeshes ? gltfPrimitives.size() : 0);
+            const bool isGenerateLods = flags.IsSet(MeshCollectionLoadingFlag::GenerateLods);
+            const bool isBuildMeshlets = flags.IsSet(MeshCollectionLoadingFlag::BuildMeshlets);
+
+            const bool isPackVertices = flags.IsSet(MeshCollectionLoadingFlag::PackVertices);
+            std::vector<VertexPackingStats> vertexPackingStats(isPackVertices ? gltfPrimitives.size() : 0);
+
+            const auto ParseMeshPrimitiveToSlot = [&](const tinygltf::Primitive* const& gltfPrimitive)
+            {
+                const size_t meshIndex = &gltfPrimitive - gltfPrimitives.data();
+                ParseMeshPrimitive(*gltfPrimitive, outMeshCollection.Meshes[meshIndex]);
+
+                if (isWeldVertices)
+                {
+                    vertexWeldingStats[meshIndex] = WeldVertices(outMeshCollection.Meshes[meshIndex]);
+                }
+
+                if (isGenerateTangents && IsTangentGenerationNeeded(*gltfPrimitive))
+                {
+                    tangentGenerationStats[meshIndex] = GenerateTangents(outMeshCollection.Meshes[meshIndex]);
+                }
+
+                if (isOptimizeMeshes)
+                {
+                    meshOptimizationStats[meshIndex] = OptimizeMesh(outMeshCollection.Meshes[meshIndex]);
+                }
+
+                if (isGenerateLods)
+                {
+                    GenerateMeshLods(outMeshCollection.Meshes[meshIndex]);
+                }
+
+                if (isBuildMeshlets)
+                {
+                    BuildMeshlets(outMeshCollection.Meshes[meshIndex]);
+                }
+
+                if (isPackVertices)
+                {
+                    vertexPackingStats[meshIndex] = PackMeshVertices(outMeshCollection.Meshes[meshIndex]);
+                }
+            };
+
+            if (flags.IsSet(MeshCollectionLoadingFlag::ParallelMeshParsing))
+            {
+                ParallelForEach(gltfPrimitives, ParseMeshPrimitiveToSlot);
+            }
+            else
+            {
+                std::for_each(std::execution::seq, gltfPrimitives.begin(), gltfPrimitives.end(), ParseMeshPrimitiveToSlot);
+            }
+
+            if (isWeldVertices)
+            {
+                VertexWeldingStats stats;
+                for (const VertexWeldingStats& meshStats : vertexWeldingStats)
+                {
+                    stats += meshStats;
+                }
+
+                BenzinTrace("GLTF Reader: {} WeldVertices, {} -> {} vertices", outMeshCollection.DebugName, stats.VertexCountBefore, stats.VertexCountAfter);
+            }
+
+            if (isGenerateTangents)
+            {
+                TangentGenerationStats stats;
+                for (const TangentGenerationStats& meshStats : tangentGenerationStats)
+                {
+                    stats += meshStats;
+                }
+
+                BenzinTrace("GLTF Reader: {} GenerateTangents, {} meshes, {} -> {} vertices", outMeshCollection.DebugName, stats.MeshCount, stats.VertexCountBefore, stats.VertexCountAfter);
+            }
+
+            if (isOptimizeMeshes)
+            {
+                MeshOptimizationStats stats;
+                for (const MeshOptimizationStats& meshStats : meshOptimizationStats)
+                {
+                    stats += meshStats;
+                }
+
+                BenzinTrace(
+                    "GLTF Reader: {} OptimizeMeshes, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+                    outMeshCollection.DebugName,
+                    stats.Before.GetAcmr(), stats.After.GetAcmr(),
+                    stats.Before.GetAtvr(), stats.After.GetAtvr()
+                );
+            }
+
+            if (isGenerateLods)
+            {
+                size_t baseIndexCount = 0;
+                size_t totalIndexCount = 0;
+                for (const MeshData& mesh : outMeshCollection.Meshes)
+                {
+                    baseIndexCount += mesh.Indices.size();
+                    totalIndexCount += mesh.GetTotalIndexCount();
+                }
+
+                BenzinTrace("GLTF Reader: {} GenerateLods, {} indices, {} with LODs", outMeshCollection.DebugName, baseIndexCount, totalIndexCount);
+            }
+
+            if (isBuildMeshlets)
+            {
+                size_t meshletCount = 0;
+                for (const MeshData& mesh : outMeshCollection.Meshes)
+                {
+                    meshletCount += mesh.Meshlets.size();
+                }
+
+                BenzinTrace("GLTF Reader: {} BuildMeshlets, {} meshlets", outMeshCollection.DebugName, meshletCount);
+            }
+
+            if (isPackVertices)
+            {
+                VertexPackingStats stats;
+                for (const VertexPackingStats& meshStats : vertexPackingStats)
+                {
+                    stats += meshStats;
+                }
+
+                BenzinTrace(
+                    "GLTF Reader: {} PackVertices, {:.3f}Mb -> {:.3f}Mb, saved {:.3f}Mb",
+                    outMeshCollection.DebugName,
+                    BytesToFloatMb(stats.UnpackedSizeInBytes), BytesToFloatMb(stats.PackedSizeInBytes), BytesToFloatMb(stats.GetSavedSizeInBytes())
+                );
+                BenzinTrace(
+                    "GLTF Reader: {} PackVertices, max errors: position {:.7f}, normal {:.3f}deg, tangent {:.3f}deg, uv {:.5f}",
+                    outMeshCollection.DebugName,
+                    stats.MaxPositionError, stats.MaxNormalError, stats.MaxTangentError, stats.MaxUvError
+                );
+
+                // The format limits are covered by tests, so going over them here means the source data is off, e.g. tangents aren't orthogonal to normals
+                BenzinWarningIf(!IsVertexPackingErrorAcceptable(stats), "GLTF Reader: {} PackVertices, round trip errors are over the format limits", outMeshCollection.DebugName);
             }
         }
 
-        static DirectX::XMMATRIX ParseNodeTransform(const tinygltf::Node& gltfNode, const DirectX::XMMATRIX& parentNodeTransform)
+        static DirectX::XMMATRIX ParseNodeTransform(const tinygltf::Node& gltfNode)
         {
             DirectX::XMMATRIX nodeTransform = DirectX::XMMatrixIdentity();
 
@@ -296,13 +926,22 @@ namespace benzin
                 }
             }
 
-            return nodeTransform * parentNodeTransform;
+            return nodeTransform;
         }
 
-        void ParseNode(int gltfNodeIndex, int gltfParentNodeIndex, const DirectX::XMMATRIX& parentNodeTransform, MeshCollectionResource& outMeshCollection)
+        // Nodes keep their parent links, so they can be spawned as a hierarchy. Instances also get the whole transform for drawing the collection as a whole
+        void ParseNode(int gltfNodeIndex, uint32_t parentNodeIndex, const DirectX::XMMATRIX& parentNodeTransform, MeshCollectionResource& outMeshCollection)
         {
             const tinygltf::Node& gltfNode = m_CurrentModel.nodes[gltfNodeIndex];
-            const DirectX::XMMATRIX nodeTransform = ParseNodeTransform(gltfNode, parentNodeTransform);
+            const DirectX::XMMATRIX localNodeTransform = ParseNodeTransform(gltfNode);
+            const DirectX::XMMATRIX nodeTransform = localNodeTransform * parentNodeTransform;
+
+            const auto nodeIndex = (uint32_t)outMeshCollection.MeshNodes.size();
+            outMeshCollection.MeshNodes.push_back(MeshNode
+            {
+                .ParentNodeIndex = parentNodeIndex,
+                .Transform = DecomposeLocalMatrix(localNodeTransform),
+            });
 
             if (const int meshIndex = gltfNode.mesh; meshIndex != -1)
             {
@@ -312,8 +951,9 @@ namespace benzin
 
                     outMeshCollection.MeshInstances.push_back(MeshInstance
                     {
-                        .MeshIndex = (uint32_t)(meshIndex + primitiveIndex),
+                        .MeshIndex = m_MeshPrimitiveOffsets[meshIndex] + (uint32_t)primitiveIndex,
                         .MaterialIndex = (uint32_t)gltfPrimitive.material,
+                        .NodeIndex = nodeIndex,
                         .Transform = nodeTransform,
                     });
                 }
@@ -321,23 +961,25 @@ namespace benzin
 
             for (const int gltfChildNodeIndex : gltfNode.children)
             {
-                ParseNode(gltfChildNodeIndex, gltfNodeIndex, nodeTransform, outMeshCollection);
+                ParseNode(gltfChildNodeIndex, nodeIndex, nodeTransform, outMeshCollection);
             }
         }
 
         void ParseNodes(MeshCollectionResource& outMeshCollection)
         {
-            const int gltfParentNodeIndex = -1;
-
             // Convert from right-handed to left-handed
             // Must be used with TriangleOrder::CounterClockwise in rasterizer state
-            const DirectX::XMMATRIX parentNodeTransform = DirectX::XMMatrixScaling(1.0f, 1.0f, -1.0f);
+            const LocalTransform rootNodeTransform{ .Scale{ 1.0f, 1.0f, -1.0f } };
+
+            // Roots of all scenes are attached to a single node, which does the conversion
+            const auto rootNodeIndex = (uint32_t)outMeshCollection.MeshNodes.size();
+            outMeshCollection.MeshNodes.push_back(MeshNode{ .Transform = rootNodeTransform });
 
             for (const tinygltf::Scene& gltfScene : m_CurrentModel.scenes)
             {
                 for (const int gltfNodeIndex : gltfScene.nodes)
                 {
-                    ParseNode(gltfNodeIndex, gltfParentNodeIndex, parentNodeTransform, outMeshCollection);
+                    ParseNode(gltfNodeIndex, rootNodeIndex, GetLocalMatrix(rootNodeTransform), outMeshCollection);
                 }
             }
         }
@@ -354,7 +996,7 @@ namespace benzin
 
                 // Albedo
                 {
-                    material.AlbedoTextureIndex = PushTextureMapping(gltfPbrMetallicRoughness.baseColorTexture.index);
+                    material.AlbedoTextureIndex = PushTextureMapping(gltfPbrMetallicRoughness.baseColorTexture.index, TextureUsage::Albedo);
 
                     BenzinAssert(gltfPbrMetallicRoughness.baseColorFactor.size() == 4);
                     material.AlbedoFactor.x = (float)gltfPbrMetallicRoughness.baseColorFactor[0];
@@ -362,25 +1004,26 @@ namespace benzin
                     material.AlbedoFactor.z = (float)gltfPbrMetallicRoughness.baseColorFactor[2];
                     material.AlbedoFactor.w = (float)gltfPbrMetallicRoughness.baseColorFactor[3];
 
-                    material.AlphaCutoff = (float)gltfMaterial.alphaCutoff;
+                    // glTF ignores the cutoff of opaque materials, so they are never discarded
+                    material.AlphaCutoff = gltfMaterial.alphaMode != "OPAQUE" ? (float)gltfMaterial.alphaCutoff : 0.0f;
                 }
 
                 // Normal
                 {
-                    material.NormalTextureIndex = PushTextureMapping(gltfMaterial.normalTexture.index);
+                    material.NormalTextureIndex = PushTextureMapping(gltfMaterial.normalTexture.index, TextureUsage::Normal);
                     material.NormalScale = (float)gltfMaterial.normalTexture.scale;
                 }
 
                 // MetalRoughness
                 {
-                    material.MetallicRoughnessTextureIndex = PushTextureMapping(gltfPbrMetallicRoughness.metallicRoughnessTexture.index);
+                    material.MetallicRoughnessTextureIndex = PushTextureMapping(gltfPbrMetallicRoughness.metallicRoughnessTexture.index, TextureUsage::MetallicRoughness);
                     material.MetalnessFactor = (float)gltfPbrMetallicRoughness.metallicFactor;
                     material.RoughnessFactor = (float)gltfPbrMetallicRoughness.roughnessFactor;
                 }
 
                 // Emissive
                 {
-                    material.EmissiveTextureIndex = PushTextureMapping(gltfMaterial.emissiveTexture.index);
+                    material.EmissiveTextureIndex = PushTextureMapping(gltfMaterial.emissiveTexture.index, TextureUsage::Emissive);
 
                     BenzinAssert(gltfMaterial.emissiveFactor.size() == 3);
                     material.EmissiveFactor.x = (float)gltfMaterial.emissiveFactor[0];
@@ -392,49 +1035,107 @@ namespace benzin
             }
         }
 
-        void ParseTextures(MeshCollectionResource& outMeshCollection)
+        void ParseTextures(MeshCollectionLoadingFlags flags, MeshCollectionResource& outMeshCollection)
         {
             outMeshCollection.TextureImages.resize(m_TextureMappings.size());
 
-            std::for_each(std::execution::par, m_TextureMappings.begin(), m_TextureMappings.end(), [&](const auto textureMappingEntry)
-            {
-                const uint32_t gltfTextureIndex = textureMappingEntry.first;
-                const uint32_t mappedIndex = textureMappingEntry.second;
+            std::vector<TextureCompressionStats> compressionStats(m_TextureMappings.size());
 
-                const tinygltf::Texture gltfTexture = m_CurrentModel.textures[gltfTextureIndex];
-                const tinygltf::Image& gltfImage = m_CurrentModel.images[gltfTexture.source];
-                BenzinAssert(gltfImage.bits == 8);
-                BenzinAssert(gltfImage.pixel_type == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE);
+            // Entries are sorted by image and copied to a vector for random access.
+            // Textures of one image are parsed by one job, so the image is decoded once and its decoder output is freed right after
+            const auto GetGltfImageIndex = [&](const auto& textureMappingEntry) { return m_CurrentModel.textures[textureMappingEntry.first].source; };
 
-                TextureImage textureImage
-                {
-                    .Format = GraphicsFormat::Rgba8Unorm,
-                    .Width = (uint32_t)gltfImage.width,
-                    .Height = (uint32_t)gltfImage.height,
-                };
+            std::vector<std::pair<uint32_t, uint32_t>> textureMappings{ m_TextureMappings.begin(), m_TextureMappings.end() };
+            std::ranges::sort(textureMappings, {}, GetGltfImageIndex);
 
-                if (!gltfTexture.name.empty())
+            std::vector<std::span<const std::pair<uint32_t, uint32_t>>> textureMappingGroups;
+            for (size_t groupBegin = 0, groupEnd = 0; groupBegin < textureMappings.size(); groupBegin = groupEnd)
+            {
+                while (groupEnd < textureMappings.size() && GetGltfImageIndex(textureMappings[groupEnd]) == GetGltfImageIndex(textureMappings[groupBegin]))
                 {
-                    textureImage.DebugName = gltfTexture.name;
+                    ++groupEnd;
                 }
-                else if (!gltfImage.name.empty())
+
+                textureMappingGroups.push_back(std::span{ textureMappings }.subspan(groupBegin, groupEnd - groupBegin));
+            }
+
+            ParallelForEach(textureMappingGroups, [&](const auto& textureMappingGroup)
+            {
+                tinygltf::Image& gltfImage = m_CurrentModel.images[GetGltfImageIndex(textureMappingGroup.front())];
+                const DecodedImage decodedImage = DecodeGltfImage(gltfImage);
+
+                for (const auto [gltfTextureIndex, mappedIndex] : textureMappingGroup)
                 {
-                    textureImage.DebugName = gltfImage.name;
+                    const tinygltf::Texture& gltfTexture = m_CurrentModel.textures[gltfTextureIndex];
+
+                    // Pixels stay in the decoder output, textures of the same image share it
+                    TextureImage textureImage
+                    {
+                        .Format = GraphicsFormat::Rgba8Unorm,
+                        .Width = decodedImage.Width,
+                        .Height = decodedImage.Height,
+                        .ExternalImageData = decodedImage.Data,
+                        .ExternalImageDataOwner = decodedImage.Owner,
+                    };
+
+                    if (!gltfTexture.name.empty())
+                    {
+                        textureImage.DebugName = gltfTexture.name;
+                    }
+                    else if (!gltfImage.name.empty())
+                    {
+                        textureImage.DebugName = gltfImage.name;
+                    }
+                    else if (!gltfImage.uri.empty())
+                    {
+                        textureImage.DebugName = gltfImage.uri;
+                    }
+
+                    const TextureUsage usage = m_TextureUsages[mappedIndex];
+
+                    if (flags.IsSet(MeshCollectionLoadingFlag::GenerateTextureMips))
+                    {
+                        GenerateTextureMips(textureImage, TextureMipParams
+                        {
+                            .IsSrgb = usage == TextureUsage::Albedo || usage == TextureUsage::Emissive,
+                            .IsNormalMap = usage == TextureUsage::Normal,
+                        });
+                    }
+
+                    if (flags.IsSet(MeshCollectionLoadingFlag::CompressTextures))
+                    {
+                        if (const GraphicsFormat format = SelectBlockCompressionFormat(usage, textureImage); format != GraphicsFormat::Unknown)
+                        {
+                            const TextureCompressionStats textureStats = CompressTexture(textureImage, format);
+                            BenzinWarningIf(textureStats.MinPsnr < GetMinAcceptablePsnr(format), "GLTF Reader: {} is compressed with low PSNR {:.1f}dB", textureImage.DebugName, textureStats.MinPsnr);
+
+                            compressionStats[mappedIndex] = textureStats;
+                        }
+                    }
+
+                    outMeshCollection.TextureImages[mappedIndex] = std::move(textureImage);
                 }
-                else if (!gltfImage.uri.empty())
+            });
+
+            if (flags.IsSet(MeshCollectionLoadingFlag::CompressTextures))
+            {
+                TextureCompressionStats stats;
+                for (const TextureCompressionStats& textureStats : compressionStats)
                 {
-                    textureImage.DebugName = gltfImage.uri;
+                    stats += textureStats;
                 }
 
-                // Fill image
-                textureImage.ImageData.resize(gltfImage.image.size());
-                memcpy(textureImage.ImageData.data(), gltfImage.image.data(), gltfImage.image.size());
-
-                outMeshCollection.TextureImages[mappedIndex] = std::move(textureImage);
-            });
+                BenzinTrace(
+                    "GLTF Reader: {} CompressTextures, {} of {} textures, {:.3f}Mb -> {:.3f}Mb, min PSNR {:.1f}dB",
+                    outMeshCollection.DebugName,
+                    stats.TextureCount, outMeshCollection.TextureImages.size(),
+                    BytesToFloatMb(stats.UncompressedSizeInBytes), BytesToFloatMb(stats.CompressedSizeInBytes), stats.MinPsnr
+                );
+            }
         }
 
-        uint32_t PushTextureMapping(int gltfTextureIndex)
+        // Color space and format of a texture follow its first use in materials
+        uint32_t PushTextureMapping(int gltfTextureIndex, TextureUsage usage)
         {
             if (gltfTextureIndex == -1)
             {
@@ -444,25 +1145,212 @@ namespace benzin
             if (!m_TextureMappings.contains(gltfTextureIndex))
             {
                 m_TextureMappings[gltfTextureIndex] = (uint32_t)m_TextureMappings.size();
+                m_TextureUsages.push_back(usage);
             }
 
             return m_TextureMappings[gltfTextureIndex];
         }
 
+        // External buffers are mapped instead of copied to 'tinygltf::Buffer::data'. Mappings live until 'ResetState'
+        static bool MapWholeFile(const unsigned char** outData, size_t* outSize, std::string* error, const std::string& filePath, void* userData)
+        {
+            auto& gltfReader = *static_cast<GltfReader*>(userData);
+
+            const MappedFile& mappedFile = *gltfReader.m_MappedFiles.emplace_back(std::make_unique<MappedFile>(filePath));
+            if (!mappedFile.IsValid())
+            {
+                if (error)
+                {
+                    *error += std::format("Failed to map file {}\n", filePath);
+                }
+
+                return false;
+            }
+
+            *outData = reinterpret_cast<const unsigned char*>(mappedFile.GetData().data());
+            *outSize = mappedFile.GetData().size();
+
+            return true;
+        }
+
         void ResetState()
         {
-            new (&m_CurrentModel) tinygltf::Model{}; // Reset current model because 'tinygltf' don't reset before loading from file
+            m_CurrentModel = tinygltf::Model{}; // Reset current model because 'tinygltf' don't reset before loading from file
+            m_MappedFiles.clear(); // After the model, buffers reference mappings
+            m_DecodedBufferViews.clear();
+            m_MeshPrimitiveOffsets.clear();
             m_TextureMappings.clear();
+            m_TextureUsages.clear();
         }
 
     private:
         tinygltf::TinyGLTF m_Context;
         tinygltf::Model m_CurrentModel;
+        std::vector<std::unique_ptr<MappedFile>> m_MappedFiles; // The glTF file and external buffers referenced by 'm_CurrentModel'
+        std::vector<std::vector<std::byte>> m_DecodedBufferViews; // Indexed by glTF buffer view, empty if the view isn't compressed
+        std::vector<uint32_t> m_MeshPrimitiveOffsets; // First 'MeshData' index of each glTF mesh
         std::unordered_map<uint32_t, uint32_t> m_TextureMappings;
+        std::vector<TextureUsage> m_TextureUsages; // Indexed by mapped texture index
     };
 
     //
 
+    static bool ReadMeshCollectionFromGltfFile(std::string_view fileName, MeshCollectionLoadingFlags flags, MeshCollectionResource& outMeshCollection)
+    {
+        static thread_local GltfReader gltfReader;
+
+        return gltfReader.ReadFromFile(fileName, flags, outMeshCollection);
+    }
+
+    static std::filesystem::path GetMeshCollectionCacheFilePath(const std::filesystem::path& filePath)
+    {
+        std::filesystem::path cacheFilePath = filePath;
+        cacheFilePath += ".mesh_cache";
+
+        return cacheFilePath;
+    }
+
+    // Returns the JSON part of a '.gltf' or a '.glb' file
+    static std::string_view GetGltfJson(std::span<const std::byte> fileData)
+    {
+        static constexpr uint32_t glbMagic = 0x46546C67; // "glTF"
+        static constexpr uint32_t glbJsonChunkType = 0x4E4F534A; // "JSON"
+        static constexpr size_t glbJsonChunkOffset = 20;
+
+        const auto ReadUint32 = [&](size_t offset)
+        {
+            uint32_t value = 0;
+            memcpy(&value, fileData.data() + offset, sizeof(value));
+            return value;
+        };
+
+        const auto* chars = reinterpret_cast<const char*>(fileData.data());
+
+        if (fileData.size() < glbJsonChunkOffset || ReadUint32(0) != glbMagic)
+        {
+            return { chars, fileData.size() };
+        }
+
+        const uint32_t jsonChunkSize = ReadUint32(12);
+        if (ReadUint32(16) != glbJsonChunkType || jsonChunkSize > fileData.size() - glbJsonChunkOffset)
+        {
+            return {};
+        }
+
+        return { chars + glbJsonChunkOffset, jsonChunkSize };
+    }
+
+    // External buffers and images referenced by the glTF file, sorted and without duplicates
+    static std::vector<std::filesystem::path> GetGltfDependencyFilePaths(const std::filesystem::path& filePath, std::string_view json)
+    {
+        const auto document = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+        if (document.is_discarded())
+        {
+            return {};
+        }
+
+        std::vector<std::filesystem::path> dependencyFilePaths;
+
+        for (const char* arrayName : { "buffers", "images" })
+        {
+            const auto it = document.find(arrayName);
+            if (it == document.end() || !it->is_array())
+            {
+                continue;
+            }
+
+            for (const auto& element : *it)
+            {
+                const auto uriIt = element.find("uri");
+                if (uriIt == element.end() || !uriIt->is_string())
+                {
+                    continue;
+                }
+
+                const auto& uri = uriIt->get_ref<const std::string&>();
+                if (tinygltf::IsDataURI(uri))
+                {
+                    continue;
+                }
+
+                std::string decodedUri;
+                tinygltf::URIDecode(uri, &decodedUri, nullptr);
+
+                dependencyFilePaths.push_back(filePath.parent_path() / decodedUri);
+            }
+        }
+
+        std::ranges::sort(dependencyFilePaths);
+        const auto duplicates = std::ranges::unique(dependencyFilePaths);
+        dependencyFilePaths.erase(duplicates.begin(), duplicates.end());
+
+        return dependencyFilePaths;
+    }
+
+    uint64_t ComputeGltfSourceHash(const std::filesystem::path& filePath, MeshCollectionLoadingFlags flags)
+    {
+        // The glTF file itself is hashed by content. Only buffers and images it references are taken into account,
+        // by names, sizes and write times, which is much cheaper than hashing every image
+
+        const MappedFile mappedFile{ filePath };
+        BenzinAssert(mappedFile.IsValid());
+
+        uint64_t sourceHash = HashBytes(mappedFile.GetData());
+
+        // Flags that don't change the result must not invalidate the cache. Meshlets aren't cached, they are built after loading
+        const auto resultIndependentFlags = MeshCollectionLoadingFlag::ParallelMeshParsing | MeshCollectionLoadingFlag::UseBakedCache | MeshCollectionLoadingFlag::DeferImageDecoding | MeshCollectionLoadingFlag::BuildMeshlets;
+        sourceHash = HashCombine(sourceHash, flags.GetRawBits() & ~resultIndependentFlags.GetRawBits());
+
+        for (const auto& dependencyFilePath : GetGltfDependencyFilePaths(filePath, GetGltfJson(mappedFile.GetData())))
+        {
+            // A missing file is hashed too, so the cache is invalidated once it appears
+            std::error_code fileSizeErrorCode;
+            std::error_code lastWriteTimeErrorCode;
+            const uintmax_t fileSize = std::filesystem::file_size(dependencyFilePath, fileSizeErrorCode);
+            const auto lastWriteTime = std::filesystem::last_write_time(dependencyFilePath, lastWriteTimeErrorCode);
+
+            sourceHash = HashCombine(sourceHash, dependencyFilePath.filename().string());
+            sourceHash = HashCombine(sourceHash, fileSizeErrorCode ? 0 : fileSize);
+            sourceHash = HashCombine(sourceHash, lastWriteTimeErrorCode ? 0 : lastWriteTime.time_since_epoch().count());
+        }
+
+        return sourceHash;
+    }
+
+    //
+
+    std::span<const joint::MeshVertex> MeshData::GetVertices() const
+    {
+        return MappedVertices.empty() ? std::span{ Vertices } : MappedVertices;
+    }
+
+    std::span<const joint::PackedMeshVertex> MeshData::GetPackedVertices() const
+    {
+        return MappedPackedVertices.empty() ? std::span{ PackedVertices } : MappedPackedVertices;
+    }
+
+    uint64_t HashTextureImage(const TextureImage& textureImage)
+    {
+        uint64_t hash = HashBytes(textureImage.GetImageData());
+        hash = HashCombine(hash, textureImage.Format);
+        hash = HashCombine(hash, textureImage.IsCubeMap);
+        hash = HashCombine(hash, textureImage.Width);
+        hash = HashCombine(hash, textureImage.Height);
+        hash = HashCombine(hash, textureImage.MipCount);
+
+        return hash;
+    }
+
+    bool IsSameTextureImage(const TextureImage& left, const TextureImage& right)
+    {
+        return left.Format == right.Format
+            && left.IsCubeMap == right.IsCubeMap
+            && left.Width == right.Width
+            && left.Height == right.Height
+            && left.MipCount == right.MipCount
+            && std::ranges::equal(left.GetImageData(), right.GetImageData());
+    }
+
     bool LoadTextureImageFromHdrFile(std::string_view fileName, TextureImage& textureImage)
     {
         const std::filesystem::path filePath = config::g_TextureDirPath / fileName;
@@ -493,11 +1381,54 @@ namespace benzin
         return true;
     }
 
-    bool LoadMeshCollectionFromGltfFile(std::string_view fileName, MeshCollectionResource& outMeshCollection)
+    bool LoadMeshCollectionFromGltfFile(std::string_view fileName, MeshCollectionResource& outMeshCollection, MeshCollectionLoadingFlags flags)
     {
-        static thread_local GltfReader gltfReader;
+        if (!flags.IsSet(MeshCollectionLoadingFlag::UseBakedCache))
+        {
+            return ReadMeshCollectionFromGltfFile(fileName, flags, outMeshCollection);
+        }
+
+        const std::filesystem::path filePath = config::g_ModelDirPath / fileName;
+        const std::filesystem::path cacheFilePath = GetMeshCollectionCacheFilePath(filePath);
+        const uint64_t sourceHash = ComputeGltfSourceHash(filePath, flags);
 
-        return gltfReader.ReadFromFile(fileName, outMeshCollection);
+        std::chrono::microseconds warmLoadingTime;
+        bool isLoadedFromCache = false;
+        {
+            BenzinGrabTimeOnScopeExit(warmLoadingTime);
+            isLoadedFromCache = LoadMeshCollectionFromCacheFile(cacheFilePath, sourceHash, outMeshCollection);
+        }
+
+        if (isLoadedFromCache)
+        {
+            BenzinTrace("MeshCollectionCache: Warm load of {} takes {:.3f}ms", fileName, ToFloatMs(warmLoadingTime));
+
+            if (flags.IsSet(MeshCollectionLoadingFlag::BuildMeshlets))
+            {
+                BuildMeshlets(outMeshCollection.Meshes);
+            }
+
+            return true;
+        }
+
+        std::chrono::microseconds coldLoadingTime;
+        {
+            BenzinGrabTimeOnScopeExit(coldLoadingTime);
+
+            if (!ReadMeshCollectionFromGltfFile(fileName, flags, outMeshCollection))
+            {
+                return false;
+            }
+        }
+
+        BenzinTrace("MeshCollectionCache: Cold load of {} takes {:.3f}ms", fileName, ToFloatMs(coldLoadingTime));
+
+        if (SaveMeshCollectionToCacheFile(cacheFilePath, sourceHash, outMeshCollection))
+        {
+            BenzinTrace("MeshCollectionCache: {} is baked to {} ({:.3f}Mb)", fileName, cacheFilePath.string(), BytesToFloatMb(std::filesystem::file_size(cacheFilePath)));
+        }
+
+        return true;
     }
 
 } // namespace benzin
@@ -1,17 +1,32 @@
 #pragma once
 
+#include "benzin/core/enum_flags.hpp"
+#include "benzin/engine/transform_hierarchy.hpp"
 #include "benzin/graphics/common.hpp"
 
 namespace joint
 {
 
     struct MeshVertex;
+    struct Meshlet;
+    struct PackedMeshVertex;
 
 } // namespace joint
 
 namespace benzin
 {
 
+    class MappedFile;
+
+    struct MeshLod
+    {
+        std::vector<uint32_t> Indices; // References the same vertices as the base level
+        std::span<const uint32_t> MappedIndices; // Used instead of 'Indices' for meshes loaded from the baked cache
+        float Error = 0.0f; // Geometric deviation from the base level in mesh units
+
+        std::span<const uint32_t> GetIndices() const { return MappedIndices.empty() ? Indices : MappedIndices; }
+    };
+
     struct MeshData
     {
         std::vector<joint::MeshVertex> Vertices;
@@ -20,14 +35,61 @@ namespace benzin
         PrimitiveTopology PrimitiveTopology = PrimitiveTopology::Unknown;
 
         std::optional<DirectX::BoundingBox> BoundingBox;
+
+        // Compact copy of 'Vertices' for rasterization. Empty if vertices are not packed, see 'PackMeshVertices'
+        std::vector<joint::PackedMeshVertex> PackedVertices;
+
+        // Clusters for the cluster level culling. Empty if meshlets are not built, see 'BuildMeshlets'
+        // Nothing renders them yet, so they aren't uploaded to the GPU and aren't stored in the baked cache
+        std::vector<joint::Meshlet> Meshlets;
+        std::vector<uint32_t> MeshletVertexIndices; // Meshlet local vertex to 'Vertices' index
+        std::vector<uint32_t> MeshletTriangles; // Packed meshlet local vertex indices
+
+        // Coarser levels of detail, the level 0 is 'Indices'. Empty if LODs are not generated, see 'GenerateMeshLods'
+        std::vector<MeshLod> Lods;
+
+        // Meshes loaded from the baked cache keep their arrays in the mapped file and leave the vectors above empty,
+        // see 'MeshCollectionResource::MappedCacheFile'. Code that runs after loading reads arrays through the getters below
+        std::span<const joint::MeshVertex> MappedVertices;
+        std::span<const uint32_t> MappedIndices;
+        std::span<const joint::PackedMeshVertex> MappedPackedVertices;
+
+        std::span<const joint::MeshVertex> GetVertices() const;
+        std::span<const uint32_t> GetIndices() const { return MappedIndices.empty() ? Indices : MappedIndices; }
+        std::span<const joint::PackedMeshVertex> GetPackedVertices() const;
+
+        uint32_t GetLodCount() const { return 1 + (uint32_t)Lods.size(); }
+        std::span<const uint32_t> GetLodIndices(uint32_t lodIndex) const { return lodIndex == 0 ? GetIndices() : Lods[lodIndex - 1].GetIndices(); }
+
+        // Levels are stored one after another in the index buffer
+        uint32_t GetLodIndexOffset(uint32_t lodIndex) const
+        {
+            uint32_t indexOffset = 0;
+            for (uint32_t i = 0; i < lodIndex; ++i)
+            {
+                indexOffset += (uint32_t)GetLodIndices(i).size();
+            }
+
+            return indexOffset;
+        }
+
+        uint32_t GetTotalIndexCount() const { return GetLodIndexOffset(GetLodCount()); }
+    };
+
+    // Node of the source file hierarchy, a parent is before its children
+    struct MeshNode
+    {
+        uint32_t ParentNodeIndex = g_InvalidIndex<uint32_t>;
+        LocalTransform Transform; // Relative to the parent
     };
 
     struct MeshInstance
     {
         uint32_t MeshIndex = g_InvalidIndex<uint32_t>;
         uint32_t MaterialIndex = g_InvalidIndex<uint32_t>;
+        uint32_t NodeIndex = g_InvalidIndex<uint32_t>; // Invalid for instances which belong to no node, e.g. static batches
 
-        DirectX::XMMATRIX Transform = DirectX::XMMatrixIdentity();
+        DirectX::XMMATRIX Transform = DirectX::XMMatrixIdentity(); // Includes transforms of the node and its ancestors
     };
 
     struct TextureImage
@@ -38,8 +100,22 @@ namespace benzin
         bool IsCubeMap = false;
         uint32_t Width = 0;
         uint32_t Height = 0;
+        uint32_t MipCount = 1;
+
+        std::vector<std::byte> ImageData; // Mips are stored one after another without padding, see 'GenerateTextureMips'
+
+        // Used instead of 'ImageData' for pixels left where they were produced: the baked cache mapping or the image decoder output.
+        // 'ExternalImageDataOwner' keeps decoder output alive, the mapping is kept by 'MeshCollectionResource::MappedCacheFile'
+        std::span<const std::byte> ExternalImageData;
+        std::shared_ptr<const void> ExternalImageDataOwner;
+
+        std::span<const std::byte> GetImageData() const { return ExternalImageData.empty() ? ImageData : ExternalImageData; }
 
-        std::vector<std::byte> ImageData;
+        void ResetExternalImageData()
+        {
+            ExternalImageData = {};
+            ExternalImageDataOwner.reset();
+        }
     };
 
     struct Material
@@ -50,7 +126,7 @@ namespace benzin
         uint32_t EmissiveTextureIndex = g_InvalidIndex<uint32_t>;
 
         DirectX::XMFLOAT4 AlbedoFactor{ 1.0f, 1.0f, 1.0f, 1.0f };
-        float AlphaCutoff = 0.0f;
+        float AlphaCutoff = 0.0f; // Zero for opaque materials
         float NormalScale = 1.0f;
         float MetalnessFactor = 1.0f;
         float RoughnessFactor = 1.0f;
@@ -64,12 +140,41 @@ namespace benzin
 
         std::vector<MeshData> Meshes;
         std::vector<MeshInstance> MeshInstances;
+        std::vector<MeshNode> MeshNodes;
 
         std::vector<TextureImage> TextureImages;
         std::vector<Material> Materials;
+
+        // Set if the collection is loaded from the baked cache. Mapped arrays of meshes and textures point into it
+        std::shared_ptr<const MappedFile> MappedCacheFile;
+    };
+
+    enum class MeshCollectionLoadingFlag : uint16_t
+    {
+        ParallelMeshParsing, // Parse mesh primitives on all cores. Output is the same as for serial parsing
+        UseBakedCache, // Load from a binary snapshot next to the source file. The snapshot is created on the first load
+        DeferImageDecoding, // Keep images encoded while the file is parsed and decode them on all cores. Output is the same
+        WeldVertices, // Merge bit identical vertices. Runs before all other stages
+        GenerateTangents, // Generate MikkTSpace tangents for normal mapped primitives without the 'TANGENT' attribute. Runs after 'WeldVertices'
+        OptimizeMeshes, // Reorder triangles and vertices for vertex cache, overdraw and vertex fetch. Rendered result is the same
+        GenerateLods, // Build a chain of simplified levels of detail for every mesh. Runs after 'OptimizeMeshes'
+        BuildMeshlets, // Split meshes into meshlets with bounds for the cluster level culling. Runs after 'OptimizeMeshes' and after a cache load
+        PackVertices, // Emit 16 byte packed vertices next to the full ones. Runs after all stages that change vertices
+        BatchStaticMeshes, // Merge nearby instances sharing a material into pre-transformed meshes, see 'BatchStaticMeshInstances'. Runs after all mesh stages
+        GenerateTextureMips, // Build full mip chains for textures. Albedo and emissive textures are filtered in linear space
+        CompressTextures, // Encode textures into BC1, BC3 or BC7 picked by material usage. Runs after 'GenerateTextureMips'
     };
+    BenzinEnableFlagsForEnum(MeshCollectionLoadingFlag);
 
     bool LoadTextureImageFromHdrFile(std::string_view fileName, TextureImage& textureImage);
-    bool LoadMeshCollectionFromGltfFile(std::string_view fileName, MeshCollectionResource& outMeshCollection);
+    bool LoadMeshCollectionFromGltfFile(std::string_view fileName, MeshCollectionResource& outMeshCollection, MeshCollectionLoadingFlags flags = {});
+
+    // Identifies the source of a baked cache: the glTF file, the buffers and images it references and flags that change the result
+    uint64_t ComputeGltfSourceHash(const std::filesystem::path& filePath, MeshCollectionLoadingFlags flags);
+
+    // Content identity of a texture. Debug names don't take part, the same image is often named differently in different models.
+    // Format, size and mips do, so the same image filtered or compressed for different usages stays a different texture
+    uint64_t HashTextureImage(const TextureImage& textureImage);
+    bool IsSameTextureImage(const TextureImage& left, const TextureImage& right);
 
 } // namespace benzin
@@ -4,6 +4,7 @@
 #include <shaders/joint/structured_buffer_types.hpp>
 
 #include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
 #include "benzin/core/logger.hpp"
 #include "benzin/core/math.hpp"
 #include "benzin/engine/entity_components.hpp"
@@ -22,10 +23,12 @@ namespace benzin
     {
         size_t totalVertexCount = 0;
         size_t totalIndexCount = 0;
+        bool isAllVerticesPacked = !meshCollection.Meshes.empty();
         for (const auto& mesh : meshCollection.Meshes)
         {
-            totalVertexCount += mesh.Vertices.size();
-            totalIndexCount += mesh.Indices.size();
+            totalVertexCount += mesh.GetVertices().size();
+            totalIndexCount += mesh.GetTotalIndexCount();
+            isAllVerticesPacked &= mesh.GetPackedVertices().size() == mesh.GetVertices().size();
         }
 
         auto vertexBuffer = std::make_unique<Buffer>(device, BufferCreation
@@ -36,6 +39,18 @@ namespace benzin
             .Flags = BufferFlag::StructuredBuffer,
         });
 
+        std::unique_ptr<Buffer> packedVertexBuffer;
+        if (isAllVerticesPacked)
+        {
+            packedVertexBuffer = std::make_unique<Buffer>(device, BufferCreation
+            {
+                .DebugName = std::format("{}_PackedVertexBuffer", debugName),
+                .ElementSize = sizeof(joint::PackedMeshVertex),
+                .ElementCount = (uint32_t)totalVertexCount,
+                .Flags = BufferFlag::StructuredBuffer,
+            });
+        }
+
         auto indexBuffer = std::make_unique<Buffer>(device, BufferCreation
         {
             .DebugName = std::format("{}_IndexBuffer", debugName),
@@ -70,6 +85,7 @@ namespace benzin
 
         BenzinTrace("MeshCollectionGpuStorage created for '{}' mesh", debugName);
         BenzinTrace("VertexCount: {}, VertexSize: {}, VertexBufferSize: {}", totalVertexCount, sizeof(joint::MeshVertex), vertexBuffer->GetSizeInBytes());
+        BenzinTraceIf(packedVertexBuffer, "PackedVertexSize: {}, PackedVertexBufferSize: {}", sizeof(joint::PackedMeshVertex), packedVertexBuffer->GetSizeInBytes());
         BenzinTrace("IndexCount: {}, IndexSize: {}, IndexBufferSize: {}", totalIndexCount, sizeof(uint32_t), indexBuffer->GetSizeInBytes());
         BenzinTrace("MeshInfoCount: {}, MeshInfoSize: {}, MeshInfoBufferSize: {}", meshCollection.Meshes.size(), sizeof(joint::MeshInfo), meshInfoBuffer->GetSizeInBytes());
         BenzinTrace("MeshInstanceCount: {}, MeshInstanceSize: {}, MeshInstanceBufferSize: {}", meshCollection.MeshInstances.size(), sizeof(joint::MeshInstance), meshInstanceBuffer->GetSizeInBytes());
@@ -78,6 +94,7 @@ namespace benzin
         return MeshCollectionGpuStorage
         {
             .VertexBuffer = std::move(vertexBuffer),
+            .PackedVertexBuffer = std::move(packedVertexBuffer),
             .IndexBuffer = std::move(indexBuffer),
             .MeshInfoBuffer = std::move(meshInfoBuffer),
             .MeshInstanceBuffer = std::move(meshInstanceBuffer),
@@ -85,12 +102,78 @@ namespace benzin
         };
     }
 
+    // Instance transforms include transforms of their nodes. Those are taken out, so nodes spawned as entities can be moved on their own
+    static void AttachMeshInstancesToNodes(MeshCollection& meshCollection)
+    {
+        if (meshCollection.MeshNodes.empty())
+        {
+            return;
+        }
+
+        std::vector<DirectX::XMMATRIX> nodeMatrices;
+        nodeMatrices.reserve(meshCollection.MeshNodes.size());
+
+        for (const MeshNode& meshNode : meshCollection.MeshNodes)
+        {
+            BenzinAssert(!IsValidIndex(meshNode.ParentNodeIndex) || meshNode.ParentNodeIndex < nodeMatrices.size());
+
+            DirectX::XMMATRIX nodeMatrix = GetLocalMatrix(meshNode.Transform);
+            if (IsValidIndex(meshNode.ParentNodeIndex))
+            {
+                nodeMatrix *= nodeMatrices[meshNode.ParentNodeIndex];
+            }
+
+            nodeMatrices.push_back(nodeMatrix);
+        }
+
+        for (MeshInstance& meshInstance : meshCollection.MeshInstances)
+        {
+            if (!IsValidIndex(meshInstance.NodeIndex))
+            {
+                continue;
+            }
+
+            DirectX::XMVECTOR determinant;
+            const DirectX::XMMATRIX inverseNodeMatrix = DirectX::XMMatrixInverse(&determinant, nodeMatrices[meshInstance.NodeIndex]);
+
+            // A node with a zero scale can't be taken out, so its instances stay in the collection space
+            if (std::abs(DirectX::XMVectorGetX(determinant)) < std::numeric_limits<float>::min())
+            {
+                meshInstance.NodeIndex = g_InvalidIndex<uint32_t>;
+                continue;
+            }
+
+            meshInstance.Transform *= inverseNodeMatrix;
+        }
+
+        // The invalid index is the largest one, so instances without a node go last
+        std::ranges::stable_sort(meshCollection.MeshInstances, {}, &MeshInstance::NodeIndex);
+
+        meshCollection.NodeMeshInstanceRanges.assign(meshCollection.MeshNodes.size(), IndexRangeU32{});
+
+        uint32_t meshInstanceIndex = 0;
+        for (const auto& [nodeIndex, meshInstanceRange] : meshCollection.NodeMeshInstanceRanges | std::views::enumerate)
+        {
+            meshInstanceRange.StartIndex = meshInstanceIndex;
+
+            while (meshInstanceIndex < meshCollection.MeshInstances.size() && meshCollection.MeshInstances[meshInstanceIndex].NodeIndex == (uint32_t)nodeIndex)
+            {
+                ++meshInstanceIndex;
+            }
+
+            meshInstanceRange.Count = meshInstanceIndex - meshInstanceRange.StartIndex;
+        }
+    }
+
     // Scene
 
     Scene::Scene(Device& device)
         : m_Device{ device }
     {
         m_EntityRegistry.on_construct<TransformComponent>().connect<&Scene::OnTransformComponentConstuct>(this);
+        m_EntityRegistry.on_destroy<TransformComponent>().connect<&Scene::OnTransformComponentDestroy>(this);
+        m_EntityRegistry.on_destroy<MeshInstanceComponent>().connect<&Scene::OnMeshInstanceComponentDestroy>(this);
+        m_EntityRegistry.on_destroy<MeshInstanceProxiesComponent>().connect<&Scene::OnMeshInstanceProxiesComponentDestroy>(this);
 
         m_TopLevelAss.resize(CommandLineArgs::GetFrameInFlightCount());
 
@@ -141,6 +224,9 @@ namespace benzin
             }
         }
 
+        m_TransformHierarchy.Update();
+        UpdateMeshInstanceProxies();
+
         {
             const auto view = m_EntityRegistry.view<TransformComponent>();
             for (const auto entityHandle : view)
@@ -187,7 +273,7 @@ namespace benzin
                 {
                     .Color = plc.Color,
                     .Intensity = plc.Intensity,
-                    .WorldPosition = tc.GetTranslation(),
+                    .WorldPosition = tc.GetWorldTranslation(),
                     .ConstantAttenuation = 1.0f,
                     .LinearAttenuation = 4.5f / plc.Range,
                     .ExponentialAttenuation = 75.0f / (plc.Range * plc.Range),
@@ -208,14 +294,13 @@ namespace benzin
         BenzinAssert(!meshCollectionResource.MeshInstances.empty());
         BenzinAssert(!meshCollectionResource.Materials.empty());
 
-        const auto textureOffset = (uint32_t)m_Textures.size();
-        PushTextures(meshCollectionResource.TextureImages);
+        const std::vector<uint32_t> textureIndices = PushTextures(meshCollectionResource.TextureImages);
 
         const auto UpdateTextureIndexIfNeeded = [&](uint32_t& outTextureIndex)
         {
             if (IsValidIndex(outTextureIndex))
             {
-                outTextureIndex = m_Textures[textureOffset + outTextureIndex]->GetSrv().GetHeapIndex();
+                outTextureIndex = m_Textures[textureIndices[outTextureIndex]]->GetSrv().GetHeapIndex();
             }
         };
 
@@ -231,20 +316,61 @@ namespace benzin
         meshUnion.DebugName = std::move(meshCollectionResource.DebugName);
         meshUnion.Collection.Meshes = std::move(meshCollectionResource.Meshes);
         meshUnion.Collection.MeshInstances = std::move(meshCollectionResource.MeshInstances);
+        meshUnion.Collection.MeshNodes = std::move(meshCollectionResource.MeshNodes);
         meshUnion.Collection.Materials = std::move(meshCollectionResource.Materials);
+        meshUnion.Collection.MappedCacheFile = std::move(meshCollectionResource.MappedCacheFile);
+        AttachMeshInstancesToNodes(meshUnion.Collection);
         meshUnion.GpuStorage = CreateMeshCollectionGpuStorage(m_Device, meshUnion.DebugName, meshUnion.Collection);
 
         PushBottomLevelAs(meshUnion);
 
         for (const auto& mesh : meshUnion.Collection.Meshes)
         {
-            m_Stats.VertexCount += (uint32_t)mesh.Vertices.size();
-            m_Stats.TriangleCount += (uint32_t)mesh.Indices.size() / 3;
+            m_Stats.VertexCount += (uint32_t)mesh.GetVertices().size();
+            m_Stats.TriangleCount += (uint32_t)mesh.GetIndices().size() / 3;
         }
 
         return (uint32_t)m_MeshUnions.size() - 1;
     }
 
+    entt::entity Scene::SpawnMeshCollection(uint32_t meshUnionIndex)
+    {
+        const MeshCollection& meshCollection = m_MeshUnions[meshUnionIndex].Collection;
+
+        const auto AddMeshInstanceComponent = [&](entt::entity entityHandle, IndexRangeU32 meshInstanceRange)
+        {
+            if (meshInstanceRange.Count != 0)
+            {
+                auto& mic = m_EntityRegistry.emplace<MeshInstanceComponent>(entityHandle);
+                mic.MeshUnionIndex = meshUnionIndex;
+                mic.MeshInstanceRange = meshInstanceRange;
+            }
+        };
+
+        const entt::entity rootEntityHandle = m_EntityRegistry.create();
+        m_EntityRegistry.emplace<TransformComponent>(rootEntityHandle);
+
+        std::vector<entt::entity> nodeEntityHandles;
+        nodeEntityHandles.reserve(meshCollection.MeshNodes.size());
+
+        for (const auto& [meshNode, meshInstanceRange] : std::views::zip(meshCollection.MeshNodes, meshCollection.NodeMeshInstanceRanges))
+        {
+            const entt::entity nodeEntityHandle = m_EntityRegistry.create();
+            nodeEntityHandles.push_back(nodeEntityHandle);
+
+            auto& tc = m_EntityRegistry.emplace<TransformComponent>(nodeEntityHandle);
+            m_TransformHierarchy.SetLocalTransform(tc.m_TransformNodeId, meshNode.Transform);
+            tc.SetParent(&m_EntityRegistry.get<TransformComponent>(IsValidIndex(meshNode.ParentNodeIndex) ? nodeEntityHandles[meshNode.ParentNodeIndex] : rootEntityHandle));
+
+            AddMeshInstanceComponent(nodeEntityHandle, meshInstanceRange);
+        }
+
+        const uint32_t firstUnattachedMeshInstanceIndex = meshCollection.NodeMeshInstanceRanges.empty() ? 0 : meshCollection.NodeMeshInstanceRanges.back().StartIndex + meshCollection.NodeMeshInstanceRanges.back().Count;
+        AddMeshInstanceComponent(rootEntityHandle, IndexRangeU32{ firstUnattachedMeshInstanceIndex, (uint32_t)meshCollection.MeshInstances.size() - firstUnattachedMeshInstanceIndex });
+
+        return rootEntityHandle;
+    }
+
     void Scene::UploadMeshCollections()
     {
         UploadAllMeshData();
@@ -279,7 +405,7 @@ namespace benzin
 
     void Scene::BuildTopLevelAccelerationStructure()
     {
-        CreateTopLevelAs();
+        UpdateTopLevelAs();
 
         auto& graphicsCommandQueue = m_Device.GetGraphicsCommandQueue();
         auto& commandList = graphicsCommandQueue.GetCommandList();
@@ -290,6 +416,23 @@ namespace benzin
         commandList.SetResourceBarrier(UnorderedAccessBarrier{ activeTopLevelAs->GetBuffer() });
     }
 
+    AabbTreeQueryStats Scene::ForEachVisibleMeshInstance(FunctionRef<void(const SceneMeshInstance&)> function) const
+    {
+        const auto worldSpaceFrustum = m_Camera.GetProjection().GetTransformedBoundingFrustum(m_Camera.GetInverseViewMatrix());
+
+        const AabbTreeQueryStats stats = m_MeshInstanceTree.QueryFrustum(GetFrustumPlanes(worldSpaceFrustum), [&](AabbTreeProxyId proxyId)
+        {
+            function(m_MeshInstancesByProxyId[proxyId]);
+        });
+
+        for (const auto& sceneMeshInstance : m_UnboundedMeshInstances)
+        {
+            function(sceneMeshInstance);
+        }
+
+        return stats;
+    }
+
     std::unique_ptr<TopLevelAccelerationStructure>& Scene::GetActiveTopLevelAs()
     {
         return m_TopLevelAss[m_Device.GetActiveFrameIndex()];
@@ -298,22 +441,169 @@ namespace benzin
     void Scene::OnTransformComponentConstuct(entt::registry& registry, entt::entity entityHandle)
     {
         auto& tc = registry.get<TransformComponent>(entityHandle);
+        tc.CreateTransformNode(m_TransformHierarchy);
         tc.CreateTransformConstantBuffer(m_Device, std::format("TransformBuffer_{}", magic_enum::enum_integer(entityHandle)));
     }
 
-    void Scene::PushTextures(std::span<const TextureImage> textureImages)
+    void Scene::OnTransformComponentDestroy(entt::registry& registry, entt::entity entityHandle)
+    {
+        auto& tc = registry.get<TransformComponent>(entityHandle);
+        tc.DestroyTransformNode();
+
+        registry.remove<MeshInstanceProxiesComponent>(entityHandle);
+    }
+
+    void Scene::OnMeshInstanceComponentDestroy(entt::registry& registry, entt::entity entityHandle)
+    {
+        registry.remove<MeshInstanceProxiesComponent>(entityHandle);
+    }
+
+    void Scene::OnMeshInstanceProxiesComponentDestroy(entt::registry& registry, entt::entity entityHandle)
+    {
+        const auto& mipc = registry.get<MeshInstanceProxiesComponent>(entityHandle);
+
+        for (const AabbTreeProxyId proxyId : mipc.ProxyIds)
+        {
+            if (IsValidIndex(proxyId))
+            {
+                m_MeshInstanceTree.DestroyProxy(proxyId);
+            }
+        }
+
+        std::erase_if(m_UnboundedMeshInstances, [&](const SceneMeshInstance& sceneMeshInstance) { return sceneMeshInstance.EntityHandle == entityHandle; });
+    }
+
+    // Proxies are recreated when the mesh instances of an entity change and moved when its world matrix is rebuilt
+    void Scene::UpdateMeshInstanceProxies()
+    {
+        // Moves inside of enlarged boxes only refit the leaf, so the tree is validated only after it was restructured
+        [[maybe_unused]] bool isTreeRestructured = false;
+
+        const auto view = m_EntityRegistry.view<TransformComponent, MeshInstanceComponent>();
+        for (const auto entityHandle : view)
+        {
+            const auto& tc = view.get<TransformComponent>(entityHandle);
+            const auto& mic = view.get<MeshInstanceComponent>(entityHandle);
+
+            const auto& meshCollection = m_MeshUnions[mic.MeshUnionIndex].Collection;
+            const auto meshInstanceRange = mic.MeshInstanceRange.value_or(meshCollection.GetFullMeshInstanceRange());
+
+            const auto* mipc = m_EntityRegistry.try_get<MeshInstanceProxiesComponent>(entityHandle);
+            const bool isMeshInstancesChanged =
+                !mipc ||
+                mipc->MeshUnionIndex != mic.MeshUnionIndex ||
+                mipc->MeshInstanceRange.StartIndex != meshInstanceRange.StartIndex ||
+                mipc->MeshInstanceRange.Count != meshInstanceRange.Count;
+
+            if (isMeshInstancesChanged)
+            {
+                m_EntityRegistry.remove<MeshInstanceProxiesComponent>(entityHandle);
+                CreateMeshInstanceProxies(entityHandle, tc, mic);
+                isTreeRestructured = true;
+
+                continue;
+            }
+
+            if (!m_TransformHierarchy.IsWorldMatrixUpdated(tc.m_TransformNodeId))
+            {
+                continue;
+            }
+
+            for (const auto& [proxyId, meshInstanceIndex] : std::views::zip(mipc->ProxyIds, IndexRangeToView(meshInstanceRange)))
+            {
+                if (!IsValidIndex(proxyId))
+                {
+                    continue;
+                }
+
+                const auto& meshInstance = meshCollection.MeshInstances[meshInstanceIndex];
+                const auto& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
+
+                isTreeRestructured |= m_MeshInstanceTree.MoveProxy(proxyId, TransformBoundingBox(*mesh.BoundingBox, meshInstance.Transform * tc.GetWorldMatrix()));
+            }
+        }
+
+#if BENZIN_IS_DEBUG_BUILD
+        if (isTreeRestructured)
+        {
+            BenzinAssert(m_MeshInstanceTree.Validate());
+        }
+#endif
+    }
+
+    void Scene::CreateMeshInstanceProxies(entt::entity entityHandle, const TransformComponent& tc, const MeshInstanceComponent& mic)
+    {
+        const auto& meshCollection = m_MeshUnions[mic.MeshUnionIndex].Collection;
+        const auto meshInstanceRange = mic.MeshInstanceRange.value_or(meshCollection.GetFullMeshInstanceRange());
+
+        // Instance transforms of such collections are relative to their nodes
+        BenzinAssert(mic.MeshInstanceRange || meshCollection.MeshNodes.empty(), "Scene: Collections with nodes are placed by 'SpawnMeshCollection'");
+
+        auto& mipc = m_EntityRegistry.emplace<MeshInstanceProxiesComponent>(entityHandle);
+        mipc.MeshUnionIndex = mic.MeshUnionIndex;
+        mipc.MeshInstanceRange = meshInstanceRange;
+        mipc.ProxyIds.reserve(meshInstanceRange.Count);
+
+        for (const uint32_t meshInstanceIndex : IndexRangeToView(meshInstanceRange))
+        {
+            const auto& meshInstance = meshCollection.MeshInstances[meshInstanceIndex];
+            const auto& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
+
+            SceneMeshInstance sceneMeshInstance
+            {
+                .EntityHandle = entityHandle,
+                .MeshInstanceIndex = meshInstanceIndex,
+            };
+
+            if (!mesh.BoundingBox)
+            {
+                mipc.ProxyIds.push_back(g_InvalidIndex<AabbTreeProxyId>);
+                m_UnboundedMeshInstances.push_back(sceneMeshInstance);
+
+                continue;
+            }
+
+            const AabbTreeProxyId proxyId = m_MeshInstanceTree.CreateProxy(TransformBoundingBox(*mesh.BoundingBox, meshInstance.Transform * tc.GetWorldMatrix()));
+            if (proxyId >= m_MeshInstancesByProxyId.size())
+            {
+                m_MeshInstancesByProxyId.resize(proxyId + 1);
+            }
+
+            sceneMeshInstance.ProxyId = proxyId;
+            m_MeshInstancesByProxyId[proxyId] = sceneMeshInstance;
+            mipc.ProxyIds.push_back(proxyId);
+        }
+    }
+
+    std::vector<uint32_t> Scene::PushTextures(std::span<TextureImage> textureImages)
     {
         if (textureImages.empty())
         {
-            return;
+            return {};
         }
 
-        m_TexturesData.reserve(m_TexturesData.size() + textureImages.size());
-        m_Textures.reserve(m_Textures.size() + textureImages.size());
+        std::vector<uint64_t> hashes(textureImages.size());
+        ParallelFor((uint32_t)textureImages.size(), 1, [&](uint32_t i) { hashes[i] = HashTextureImage(textureImages[i]); });
 
-        for (const auto& textureImage : textureImages)
+        std::vector<uint32_t> textureIndices;
+        textureIndices.reserve(textureImages.size());
+
+        for (const auto& [textureImage, hash] : std::views::zip(textureImages, hashes))
         {
-            m_TexturesData.push_back(std::move(textureImage.ImageData));
+            // Textures are compared on a hash match, so a collision can't merge different textures
+            if (const auto it = m_TextureIndicesByHash.find(hash); it != m_TextureIndicesByHash.end() && IsSameTextureImage(m_TextureImages[it->second], textureImage))
+            {
+                textureIndices.push_back(it->second);
+
+                m_Stats.DeduplicatedTextureCount++;
+                m_Stats.DeduplicatedTextureSizeInBytes += textureImage.GetImageData().size();
+
+                continue;
+            }
+
+            const auto textureIndex = (uint32_t)m_Textures.size();
+            m_TextureIndicesByHash.try_emplace(hash, textureIndex);
+            textureIndices.push_back(textureIndex);
 
             m_Textures.push_back(std::make_unique<Texture>(m_Device, TextureCreation
             {
@@ -321,9 +611,20 @@ namespace benzin
                 .Format = textureImage.Format,
                 .Width = textureImage.Width,
                 .Height = textureImage.Height,
-                .MipCount = 1, // #TODO: Mip generation
+                .MipCount = (uint16_t)textureImage.MipCount,
             }));
+
+            m_TextureImages.push_back(std::move(textureImage));
         }
+
+        m_Stats.TextureCount = (uint32_t)m_Textures.size();
+
+        BenzinTrace(
+            "Scene: {} textures, {} deduplicated so far, {:.3f}Mb saved",
+            m_Stats.TextureCount, m_Stats.DeduplicatedTextureCount, BytesToFloatMb(m_Stats.DeduplicatedTextureSizeInBytes)
+        );
+
+        return textureIndices;
     }
 
     void Scene::PushBottomLevelAs(MeshUnion& meshUnion)
@@ -332,8 +633,8 @@ namespace benzin
         uint32_t indexOffset = 0;
         for (const auto& mesh : meshUnion.Collection.Meshes)
         {
-            const auto vertexCount = (uint32_t)mesh.Vertices.size();
-            const auto indexCount = (uint32_t)mesh.Indices.size();
+            const auto vertexCount = (uint32_t)mesh.GetVertices().size();
+            const auto indexCount = (uint32_t)mesh.GetIndices().size();
 
             const RtGeometryVariant meshGeometryDesc = RtTriangledGeometry
             {
@@ -352,13 +653,13 @@ namespace benzin
             }));
 
             vertexOffset += vertexCount;
-            indexOffset += indexCount;
+            indexOffset += mesh.GetTotalIndexCount();
         }
     }
 
-    void Scene::CreateTopLevelAs()
+    void Scene::UpdateTopLevelAs()
     {
-        std::vector<TopLevelInstance> topLevelInstances;
+        FrameVector<TopLevelInstance> topLevelInstances;
 
         const auto view = m_EntityRegistry.view<TransformComponent, MeshInstanceComponent>(entt::exclude<PointLightComponent>);
         for (const auto entityHandle : view)
@@ -384,7 +685,16 @@ namespace benzin
         }
 
         BenzinAssert(!topLevelInstances.empty());
-        MakeUniquePtr(GetActiveTopLevelAs(), m_Device, TopLevelAccelerationStructureCreation
+
+        // Buffers of the active frame are free after the frame fence wait, so they're reused while instances fit
+        auto& activeTopLevelAs = GetActiveTopLevelAs();
+        if (activeTopLevelAs && topLevelInstances.size() <= activeTopLevelAs->GetInstanceCapacity())
+        {
+            activeTopLevelAs->UpdateInstances(topLevelInstances);
+            return;
+        }
+
+        MakeUniquePtr(activeTopLevelAs, m_Device, TopLevelAccelerationStructureCreation
         {
             .DebugName = "SceneTopLevelAS",
             .Instances = topLevelInstances,
@@ -397,6 +707,7 @@ namespace benzin
         for (const auto& meshUnion : m_MeshUnions)
         {
             uploadBufferSize += meshUnion.GpuStorage.VertexBuffer->GetSizeInBytes();
+            uploadBufferSize += meshUnion.GpuStorage.PackedVertexBuffer ? meshUnion.GpuStorage.PackedVertexBuffer->GetSizeInBytes() : 0;
             uploadBufferSize += meshUnion.GpuStorage.IndexBuffer->GetSizeInBytes();
             uploadBufferSize += meshUnion.GpuStorage.MeshInfoBuffer->GetSizeInBytes();
         }
@@ -412,18 +723,31 @@ namespace benzin
             uint32_t indexOffset = 0;
             for (const auto [i, mesh] : meshUnion.Collection.Meshes | std::views::enumerate)
             {
+                const auto meshBoundingBox = mesh.BoundingBox.value_or(DirectX::BoundingBox{});
+
                 const joint::MeshInfo meshInfo
                 {
                     .VertexOffset = vertexOffset,
                     .IndexOffset = indexOffset,
+                    .BoundingBoxCenter = meshBoundingBox.Center,
+                    .BoundingBoxExtents = meshBoundingBox.Extents,
                 };
 
-                copyCommandList.UpdateBuffer(*meshUnion.GpuStorage.VertexBuffer, std::span<const joint::MeshVertex>{ mesh.Vertices }, vertexOffset);
-                copyCommandList.UpdateBuffer(*meshUnion.GpuStorage.IndexBuffer, std::span<const uint32_t>{ mesh.Indices }, indexOffset);
+                copyCommandList.UpdateBuffer(*meshUnion.GpuStorage.VertexBuffer, mesh.GetVertices(), vertexOffset);
+                if (meshUnion.GpuStorage.PackedVertexBuffer)
+                {
+                    copyCommandList.UpdateBuffer(*meshUnion.GpuStorage.PackedVertexBuffer, mesh.GetPackedVertices(), vertexOffset);
+                }
+
                 copyCommandList.UpdateBuffer(*meshUnion.GpuStorage.MeshInfoBuffer, std::span{ &meshInfo, 1 }, i);
 
-                vertexOffset += (uint32_t)mesh.Vertices.size();
-                indexOffset += (uint32_t)mesh.Indices.size();
+                for (uint32_t lodIndex = 0; lodIndex < mesh.GetLodCount(); ++lodIndex)
+                {
+                    copyCommandList.UpdateBuffer(*meshUnion.GpuStorage.IndexBuffer, mesh.GetLodIndices(lodIndex), indexOffset + mesh.GetLodIndexOffset(lodIndex));
+                }
+
+                vertexOffset += (uint32_t)mesh.GetVertices().size();
+                indexOffset += mesh.GetTotalIndexCount();
             }
         }
     }
@@ -475,9 +799,9 @@ namespace benzin
         BenzinFlushCommandQueueOnScopeExit(copyCommandQueue);
 
         auto& copyCommandList = copyCommandQueue.GetCommandList(uploadBufferSize);
-        for (const auto& [textureData, texture] : std::views::zip(m_TexturesData, m_Textures))
+        for (const auto& [textureImage, texture] : std::views::zip(m_TextureImages, m_Textures))
         {
-            copyCommandList.UpdateTextureTopMip(*texture, textureData);
+            copyCommandList.UpdateTextureMips(*texture, textureImage.GetImageData());
         }
     }
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "benzin/engine/camera.hpp"
+#include "benzin/engine/dynamic_aabb_tree.hpp"
 #include "benzin/engine/resource_loader.hpp"
+#include "benzin/engine/transform_hierarchy.hpp"
 
 #include <shaders/joint/constant_buffer_types.hpp>
 
@@ -19,11 +21,19 @@ namespace benzin
     template <typename ConstantsT>
     class ConstantBuffer;
 
+    class TransformComponent;
+    struct MeshInstanceComponent;
+
     struct MeshCollection
     {
         std::vector<MeshData> Meshes;
         std::vector<Material> Materials;
-        std::vector<MeshInstance> MeshInstances;
+        std::vector<MeshInstance> MeshInstances; // Sorted by node, transforms are relative to the node. Instances without a node go last
+
+        std::vector<MeshNode> MeshNodes;
+        std::vector<IndexRangeU32> NodeMeshInstanceRanges; // By node
+
+        std::shared_ptr<const MappedFile> MappedCacheFile; // Keeps arrays of meshes loaded from the baked cache alive
 
         auto GetFullMeshInstanceRange() const
         {
@@ -34,6 +44,7 @@ namespace benzin
     struct MeshCollectionGpuStorage
     {
         std::unique_ptr<Buffer> VertexBuffer;
+        std::unique_ptr<Buffer> PackedVertexBuffer; // Only if all meshes have packed vertices
         std::unique_ptr<Buffer> IndexBuffer;
         std::unique_ptr<Buffer> MeshInfoBuffer;
         std::unique_ptr<Buffer> MeshInstanceBuffer;
@@ -45,9 +56,20 @@ namespace benzin
         uint32_t VertexCount = 0;
         uint32_t TriangleCount = 0;
 
+        uint32_t TextureCount = 0; // Unique textures, see 'Scene::PushTextures'
+        uint32_t DeduplicatedTextureCount = 0;
+        uint64_t DeduplicatedTextureSizeInBytes = 0;
+
         uint32_t PointLightCount = 0;
     };
 
+    struct SceneMeshInstance
+    {
+        entt::entity EntityHandle = entt::null;
+        uint32_t MeshInstanceIndex = 0;
+        AabbTreeProxyId ProxyId = g_InvalidIndex<AabbTreeProxyId>; // Invalid for meshes without a bounding box
+    };
+
     class Scene
     {
     private:
@@ -60,6 +82,14 @@ namespace benzin
             std::vector<std::unique_ptr<BottomLevelAccelerationStructure>> BottomLevelASs;
         };
 
+        // Added by 'OnUpdate' to entities with 'TransformComponent' and 'MeshInstanceComponent'
+        struct MeshInstanceProxiesComponent
+        {
+            uint32_t MeshUnionIndex = g_InvalidIndex<uint32_t>;
+            IndexRangeU32 MeshInstanceRange;
+            std::vector<AabbTreeProxyId> ProxyIds; // By mesh instance of the range, invalid for meshes without a bounding box
+        };
+
     public:
         explicit Scene(Device& device);
         ~Scene();
@@ -71,6 +101,9 @@ namespace benzin
         const auto& GetCamera() const { return m_Camera; }
 
         const auto& GetStats() const { return m_Stats; }
+        const auto& GetTransformHierarchyStats() const { return m_TransformHierarchy.GetStats(); }
+        auto GetMeshInstanceTreeStats() const { return m_MeshInstanceTree.GetStats(); }
+        const auto& GetMeshInstanceWorldAabb(AabbTreeProxyId proxyId) const { return m_MeshInstanceTree.GetProxyAabb(proxyId); }
 
         const auto& GetMeshCollection(uint32_t index) const { return m_MeshUnions[index].Collection; };
         const auto& GetMeshCollectionGpuStorage(uint32_t index) const { return m_MeshUnions[index].GpuStorage; }
@@ -88,19 +121,34 @@ namespace benzin
 
         uint32_t PushMeshCollection(MeshCollectionResource&& meshCollectionResource);
 
+        // Creates an entity for every node of the collection, parented like the nodes, under a new root entity, which is returned.
+        // Mesh instances of a node are drawn by its entity, instances without a node by the root. Collections with nodes are placed only this way
+        entt::entity SpawnMeshCollection(uint32_t meshUnionIndex);
+
         void UploadMeshCollections();
         void BuildBottomLevelAccelerationStructures();
         void BuildTopLevelAccelerationStructure();
 
+        // Calls 'function' for every mesh instance which world bounding box isn't outside of the camera frustum.
+        // Mesh instances without a bounding box are always visible
+        AabbTreeQueryStats ForEachVisibleMeshInstance(FunctionRef<void(const SceneMeshInstance&)> function) const;
+
     private:
         std::unique_ptr<TopLevelAccelerationStructure>& GetActiveTopLevelAs();
 
         void OnTransformComponentConstuct(entt::registry& registry, entt::entity entityHandle);
+        void OnTransformComponentDestroy(entt::registry& registry, entt::entity entityHandle);
+        void OnMeshInstanceComponentDestroy(entt::registry& registry, entt::entity entityHandle);
+        void OnMeshInstanceProxiesComponentDestroy(entt::registry& registry, entt::entity entityHandle);
 
-        void PushTextures(std::span<const TextureImage> textureImages);
+        void UpdateMeshInstanceProxies();
+        void CreateMeshInstanceProxies(entt::entity entityHandle, const TransformComponent& tc, const MeshInstanceComponent& mic);
+
+        // Identical textures are created once for the whole scene. Returns scene texture index for every image
+        std::vector<uint32_t> PushTextures(std::span<TextureImage> textureImages);
         void PushBottomLevelAs(MeshUnion& meshUnion);
 
-        void CreateTopLevelAs();
+        void UpdateTopLevelAs();
 
         void UploadAllMeshData();
         void UploadAllMeshInstances();
@@ -119,14 +167,21 @@ namespace benzin
 
         std::vector<std::unique_ptr<TopLevelAccelerationStructure>> m_TopLevelAss;
 
-        std::vector<std::vector<std::byte>> m_TexturesData;
+        std::vector<TextureImage> m_TextureImages; // Image data of mapped ones is kept alive by 'MeshCollection::MappedCacheFile'
         std::vector<std::unique_ptr<Texture>> m_Textures;
+        std::unordered_map<uint64_t, uint32_t> m_TextureIndicesByHash; // Content hash to 'm_Textures' index
 
         std::optional<joint::CameraConstants> m_PreviousCameraConstants;
         std::unique_ptr<ConstantBuffer<joint::DoubleFrameCameraConstants>> m_CameraConstantBuffer;
 
         std::unique_ptr<Buffer> m_PointLightBuffer;
 
+        TransformHierarchy m_TransformHierarchy; // Outlives 'm_EntityRegistry'
+
+        DynamicAabbTree m_MeshInstanceTree; // Outlives 'm_EntityRegistry'
+        std::vector<SceneMeshInstance> m_MeshInstancesByProxyId;
+        std::vector<SceneMeshInstance> m_UnboundedMeshInstances; // Meshes without a bounding box
+
         entt::registry m_EntityRegistry;
     };
 
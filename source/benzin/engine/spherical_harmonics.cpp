@@ -0,0 +1,180 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/spherical_harmonics.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/engine/environment_baker.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        constexpr uint32_t g_CubeFaceCount = 6;
+
+        constexpr std::array<float, SphericalHarmonicsL2::CoefficientCount> g_ShBasisConstants
+        {
+            0.282095f,
+            0.488603f, 0.488603f, 0.488603f,
+            1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f,
+        };
+
+        // Cosine lobe convolution per band
+        constexpr std::array<float, SphericalHarmonicsL2::CoefficientCount> g_ShCosineLobe
+        {
+            DirectX::XM_PI,
+            DirectX::XM_2PI / 3.0f, DirectX::XM_2PI / 3.0f, DirectX::XM_2PI / 3.0f,
+            DirectX::XM_PI / 4.0f, DirectX::XM_PI / 4.0f, DirectX::XM_PI / 4.0f, DirectX::XM_PI / 4.0f, DirectX::XM_PI / 4.0f,
+        };
+
+        using ShAccumulator = std::array<DirectX::XMVECTOR, SphericalHarmonicsL2::CoefficientCount>;
+
+        // Signed area of the projection of [0, x] x [0, y] of the face on the unit sphere
+        float GetCubeFaceAreaElement(float x, float y)
+        {
+            return std::atan2(x * y, std::sqrt(x * x + y * y + 1.0f));
+        }
+
+        float GetCubeTexelSolidAngle(uint32_t x, uint32_t y, uint32_t faceSize)
+        {
+            const float invFaceSize = 1.0f / (float)faceSize;
+
+            const float x0 = 2.0f * (float)x * invFaceSize - 1.0f;
+            const float y0 = 2.0f * (float)y * invFaceSize - 1.0f;
+            const float x1 = x0 + 2.0f * invFaceSize;
+            const float y1 = y0 + 2.0f * invFaceSize;
+
+            return GetCubeFaceAreaElement(x0, y0) - GetCubeFaceAreaElement(x0, y1) - GetCubeFaceAreaElement(x1, y0) + GetCubeFaceAreaElement(x1, y1);
+        }
+
+    } // anonymous namespace
+
+    //
+
+    std::array<float, SphericalHarmonicsL2::CoefficientCount> EvaluateShBasis(DirectX::XMVECTOR direction)
+    {
+        DirectX::XMFLOAT3 d;
+        DirectX::XMStoreFloat3(&d, direction);
+
+        const std::array<float, SphericalHarmonicsL2::CoefficientCount> polynomials
+        {
+            1.0f,
+            d.y, d.z, d.x,
+            d.x * d.y, d.y * d.z, 3.0f * d.z * d.z - 1.0f, d.x * d.z, d.x * d.x - d.y * d.y,
+        };
+
+        std::array<float, SphericalHarmonicsL2::CoefficientCount> basis;
+        for (uint32_t i = 0; i < basis.size(); ++i)
+        {
+            basis[i] = g_ShBasisConstants[i] * polynomials[i];
+        }
+
+        return basis;
+    }
+
+    SphericalHarmonicsL2 ProjectCubeMapToSh(const TextureImage& cubeMap)
+    {
+        BenzinAssert(cubeMap.IsCubeMap);
+        BenzinAssert(cubeMap.Width == cubeMap.Height);
+        BenzinAssert(cubeMap.Format == GraphicsFormat::Rgba16Float || cubeMap.Format == GraphicsFormat::Rgba32Float);
+
+        const uint32_t faceSize = cubeMap.Width;
+        const uint32_t pixelSizeInBytes = GetFormatSizeInBytes(cubeMap.Format);
+
+        // Each face is stored with all its mips
+        const size_t faceSizeInBytes = cubeMap.ImageData.size() / g_CubeFaceCount;
+
+        const auto LoadTexel = [&](uint32_t faceIndex, uint32_t x, uint32_t y)
+        {
+            const std::byte* texel = cubeMap.ImageData.data() + faceIndex * faceSizeInBytes + ((size_t)y * faceSize + x) * pixelSizeInBytes;
+
+            if (cubeMap.Format == GraphicsFormat::Rgba16Float)
+            {
+                return DirectX::PackedVector::XMLoadHalf4(reinterpret_cast<const DirectX::PackedVector::XMHALF4*>(texel));
+            }
+
+            return DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(texel));
+        };
+
+        // Rows are accumulated on all cores and reduced in order, so the result doesn't depend on scheduling
+        const uint32_t rowCount = g_CubeFaceCount * faceSize;
+
+        std::vector<ShAccumulator> rowAccumulators(rowCount);
+        std::vector<float> rowSolidAngles(rowCount, 0.0f);
+
+        ParallelFor(rowCount, 1, [&](uint32_t rowIndex)
+        {
+            const uint32_t faceIndex = rowIndex / faceSize;
+            const uint32_t y = rowIndex % faceSize;
+
+            ShAccumulator& accumulator = rowAccumulators[rowIndex];
+            accumulator.fill(DirectX::XMVectorZero());
+
+            for (uint32_t x = 0; x < faceSize; ++x)
+            {
+                const DirectX::XMVECTOR direction = GetCubeFaceDirection(faceIndex, ((float)x + 0.5f) / (float)faceSize, ((float)y + 0.5f) / (float)faceSize);
+                const float solidAngle = GetCubeTexelSolidAngle(x, y, faceSize);
+
+                const DirectX::XMVECTOR radiance = DirectX::XMVectorScale(LoadTexel(faceIndex, x, y), solidAngle);
+                const auto basis = EvaluateShBasis(direction);
+
+                for (uint32_t i = 0; i < basis.size(); ++i)
+                {
+                    accumulator[i] = DirectX::XMVectorMultiplyAdd(radiance, DirectX::XMVectorReplicate(basis[i]), accumulator[i]);
+                }
+
+                rowSolidAngles[rowIndex] += solidAngle;
+            }
+        });
+
+        ShAccumulator sum;
+        sum.fill(DirectX::XMVectorZero());
+
+        for (const auto& accumulator : rowAccumulators)
+        {
+            for (uint32_t i = 0; i < sum.size(); ++i)
+            {
+                sum[i] = DirectX::XMVectorAdd(sum[i], accumulator[i]);
+            }
+        }
+
+        // Texel solid angles must cover the whole sphere
+        BenzinAssert(std::abs(std::reduce(rowSolidAngles.begin(), rowSolidAngles.end()) - 4.0f * DirectX::XM_PI) < 1e-2f);
+
+        SphericalHarmonicsL2 sh;
+        for (uint32_t i = 0; i < sum.size(); ++i)
+        {
+            DirectX::XMStoreFloat3(&sh.Coefficients[i], sum[i]);
+        }
+
+        return sh;
+    }
+
+    DirectX::XMVECTOR EvaluateShIrradiance(const SphericalHarmonicsL2& radiance, DirectX::XMVECTOR normal)
+    {
+        const auto basis = EvaluateShBasis(normal);
+
+        DirectX::XMVECTOR irradiance = DirectX::XMVectorZero();
+        for (uint32_t i = 0; i < basis.size(); ++i)
+        {
+            irradiance = DirectX::XMVectorMultiplyAdd(DirectX::XMLoadFloat3(&radiance.Coefficients[i]), DirectX::XMVectorReplicate(g_ShCosineLobe[i] * basis[i]), irradiance);
+        }
+
+        return irradiance;
+    }
+
+    std::array<DirectX::XMFLOAT4, SphericalHarmonicsL2::CoefficientCount> GetShDiffuseCoefficients(const SphericalHarmonicsL2& radiance, float intensity)
+    {
+        std::array<DirectX::XMFLOAT4, SphericalHarmonicsL2::CoefficientCount> coefficients;
+        for (uint32_t i = 0; i < coefficients.size(); ++i)
+        {
+            const float scale = intensity * g_ShCosineLobe[i] * g_ShBasisConstants[i] / DirectX::XM_PI;
+            DirectX::XMStoreFloat4(&coefficients[i], DirectX::XMVectorScale(DirectX::XMLoadFloat3(&radiance.Coefficients[i]), scale));
+        }
+
+        return coefficients;
+    }
+
+} // namespace benzin
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct TextureImage;
+
+    // Order 3 (bands up to L2) RGB spherical harmonics. Coefficients go in the order: L00, L1-1, L10, L11, L2-2, L2-1, L20, L21, L22
+    struct SphericalHarmonicsL2
+    {
+        static constexpr uint32_t CoefficientCount = 9;
+
+        std::array<DirectX::XMFLOAT3, CoefficientCount> Coefficients{};
+    };
+
+    std::array<float, SphericalHarmonicsL2::CoefficientCount> EvaluateShBasis(DirectX::XMVECTOR direction);
+
+    // Projects radiance of the top mip of a 'Rgba16Float' or 'Rgba32Float' cube map, every texel is weighted by its solid angle
+    SphericalHarmonicsL2 ProjectCubeMapToSh(const TextureImage& cubeMap);
+
+    // Irradiance for the normal, the radiance is convolved with the clamped cosine lobe
+    // Ref: Ramamoorthi, Hanrahan, An Efficient Representation for Irradiance Environment Maps
+    DirectX::XMVECTOR EvaluateShIrradiance(const SphericalHarmonicsL2& radiance, DirectX::XMVECTOR normal);
+
+    // Coefficients of the Lambertian diffuse for shaders with the cosine lobe, the basis constants and 1 / Pi folded in
+    // Diffuse radiance is the sum of coefficients multiplied by 1, y, z, x, xy, yz, 3z^2 - 1, xz, x^2 - y^2 of the normal
+    std::array<DirectX::XMFLOAT4, SphericalHarmonicsL2::CoefficientCount> GetShDiffuseCoefficients(const SphericalHarmonicsL2& radiance, float intensity = 1.0f);
+
+} // namespace benzin
@@ -0,0 +1,299 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/static_batcher.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/core/math.hpp"
+#include "benzin/engine/meshlet_builder.hpp"
+#include "benzin/engine/resource_loader.hpp"
+#include "benzin/engine/vertex_packing.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        struct StaticBatch
+        {
+            uint32_t MaterialIndex = 0;
+            std::vector<uint32_t> MeshInstanceIndices;
+
+            uint32_t VertexCount = 0;
+            uint32_t IndexCount = 0;
+        };
+
+        // Material and the cell of the instance bounds center
+        using StaticBatchKey = std::tuple<uint32_t, int32_t, int32_t, int32_t>;
+
+        StaticBatchKey GetStaticBatchKey(const MeshInstance& meshInstance, const MeshData& mesh, float maxBatchExtent)
+        {
+            if (maxBatchExtent <= 0.0f)
+            {
+                return StaticBatchKey{ meshInstance.MaterialIndex, 0, 0, 0 };
+            }
+
+            DirectX::BoundingBox boundingBox;
+            mesh.BoundingBox.value_or(ComputeBoundingBox(mesh.GetVertices())).Transform(boundingBox, meshInstance.Transform);
+
+            const auto GetCell = [&](float coordinate) { return (int32_t)std::floor(coordinate / maxBatchExtent); };
+
+            return StaticBatchKey{ meshInstance.MaterialIndex, GetCell(boundingBox.Center.x), GetCell(boundingBox.Center.y), GetCell(boundingBox.Center.z) };
+        }
+
+        // Converts errors and distances from mesh units to the units of the transformed mesh
+        float GetMaxScale(const DirectX::XMMATRIX& transform)
+        {
+            float maxScale = 0.0f;
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                maxScale = std::max(maxScale, DirectX::XMVectorGetX(DirectX::XMVector3Length(transform.r[i])));
+            }
+
+            return maxScale;
+        }
+
+        void AppendTransformedVertices(const MeshData& mesh, const DirectX::XMMATRIX& transform, std::vector<joint::MeshVertex>& outVertices)
+        {
+            const DirectX::XMMATRIX transformForNormals = GetMatrixForNormals(transform);
+
+            // Mirroring transforms flip 'cross(Normal, Tangent)'
+            const float handedness = DirectX::XMVectorGetX(DirectX::XMMatrixDeterminant(transform)) < 0.0f ? -1.0f : 1.0f;
+
+            for (joint::MeshVertex vertex : mesh.GetVertices())
+            {
+                DirectX::XMStoreFloat3(&vertex.Position, DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&vertex.Position), transform));
+                DirectX::XMStoreFloat3(&vertex.Normal, DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&vertex.Normal), transformForNormals)));
+
+                if (vertex.Tangent.w != 0.0f)
+                {
+                    const DirectX::XMVECTOR tangent = DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat4(&vertex.Tangent), transform));
+                    DirectX::XMStoreFloat4(&vertex.Tangent, DirectX::XMVectorSetW(tangent, vertex.Tangent.w * handedness));
+                }
+
+                outVertices.push_back(vertex);
+            }
+        }
+
+        MeshData BuildBatchMesh(const MeshCollectionResource& meshCollection, const StaticBatch& batch)
+        {
+            MeshData batchMesh
+            {
+                .PrimitiveTopology = PrimitiveTopology::TriangleList,
+            };
+
+            batchMesh.Vertices.reserve(batch.VertexCount);
+            batchMesh.Indices.reserve(batch.IndexCount);
+
+            uint32_t lodCount = 1;
+            bool hasMeshlets = false;
+            bool hasPackedVertices = false;
+
+            for (const uint32_t meshInstanceIndex : batch.MeshInstanceIndices)
+            {
+                const MeshData& mesh = meshCollection.Meshes[meshCollection.MeshInstances[meshInstanceIndex].MeshIndex];
+
+                lodCount = std::max(lodCount, mesh.GetLodCount());
+                hasMeshlets |= !mesh.Meshlets.empty();
+                hasPackedVertices |= !mesh.GetPackedVertices().empty();
+            }
+
+            batchMesh.Lods.resize(lodCount - 1);
+
+            for (const uint32_t meshInstanceIndex : batch.MeshInstanceIndices)
+            {
+                const MeshInstance& meshInstance = meshCollection.MeshInstances[meshInstanceIndex];
+                const MeshData& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
+
+                const auto vertexOffset = (uint32_t)batchMesh.Vertices.size();
+                AppendTransformedVertices(mesh, meshInstance.Transform, batchMesh.Vertices);
+
+                const auto AppendIndices = [&](std::span<const uint32_t> indices, std::vector<uint32_t>& outIndices)
+                {
+                    std::ranges::transform(indices, std::back_inserter(outIndices), [&](uint32_t index) { return index + vertexOffset; });
+                };
+
+                AppendIndices(mesh.GetIndices(), batchMesh.Indices);
+
+                // Meshes with fewer levels contribute their coarsest level to the rest
+                const float scale = GetMaxScale(meshInstance.Transform);
+                for (const auto& [i, batchLod] : batchMesh.Lods | std::views::enumerate)
+                {
+                    const uint32_t lodIndex = std::min((uint32_t)i + 1, mesh.GetLodCount() - 1);
+
+                    AppendIndices(mesh.GetLodIndices(lodIndex), batchLod.Indices);
+
+                    if (lodIndex != 0)
+                    {
+                        batchLod.Error = std::max(batchLod.Error, mesh.Lods[lodIndex - 1].Error * scale);
+                    }
+                }
+            }
+
+            batchMesh.BoundingBox = ComputeBoundingBox(batchMesh.Vertices);
+
+            if (hasMeshlets)
+            {
+                BuildMeshlets(batchMesh);
+            }
+
+            if (hasPackedVertices)
+            {
+                PackMeshVertices(batchMesh);
+            }
+
+            return batchMesh;
+        }
+
+        // Removes meshes which are not referenced by instances
+        void RemoveUnusedMeshes(MeshCollectionResource& meshCollection)
+        {
+            std::vector<uint32_t> newMeshIndices(meshCollection.Meshes.size(), g_InvalidIndex<uint32_t>);
+            for (const MeshInstance& meshInstance : meshCollection.MeshInstances)
+            {
+                newMeshIndices[meshInstance.MeshIndex] = 0;
+            }
+
+            std::vector<MeshData> usedMeshes;
+            for (size_t meshIndex = 0; meshIndex < meshCollection.Meshes.size(); ++meshIndex)
+            {
+                if (newMeshIndices[meshIndex] != g_InvalidIndex<uint32_t>)
+                {
+                    newMeshIndices[meshIndex] = (uint32_t)usedMeshes.size();
+                    usedMeshes.push_back(std::move(meshCollection.Meshes[meshIndex]));
+                }
+            }
+
+            for (MeshInstance& meshInstance : meshCollection.MeshInstances)
+            {
+                meshInstance.MeshIndex = newMeshIndices[meshInstance.MeshIndex];
+            }
+
+            meshCollection.Meshes = std::move(usedMeshes);
+        }
+
+        size_t GetTotalVertexCount(const MeshCollectionResource& meshCollection)
+        {
+            size_t vertexCount = 0;
+            for (const MeshData& mesh : meshCollection.Meshes)
+            {
+                vertexCount += mesh.GetVertices().size();
+            }
+
+            return vertexCount;
+        }
+
+    } // anonymous namespace
+
+    //
+
+    StaticBatchingStats& StaticBatchingStats::operator+=(const StaticBatchingStats& other)
+    {
+        MeshInstanceCountBefore += other.MeshInstanceCountBefore;
+        MeshInstanceCountAfter += other.MeshInstanceCountAfter;
+        MeshCountBefore += other.MeshCountBefore;
+        MeshCountAfter += other.MeshCountAfter;
+        VertexCountBefore += other.VertexCountBefore;
+        VertexCountAfter += other.VertexCountAfter;
+        BatchCount += other.BatchCount;
+
+        return *this;
+    }
+
+    StaticBatchingStats BatchStaticMeshInstances(MeshCollectionResource& meshCollection, const StaticBatchingParams& params)
+    {
+        StaticBatchingStats stats
+        {
+            .MeshInstanceCountBefore = meshCollection.MeshInstances.size(),
+            .MeshCountBefore = meshCollection.Meshes.size(),
+            .VertexCountBefore = GetTotalVertexCount(meshCollection),
+        };
+
+        // Fill batches greedily in instance order, one open batch per material and cell
+        std::vector<StaticBatch> batches;
+        std::map<StaticBatchKey, size_t> openBatchIndices;
+
+        for (const auto& [meshInstanceIndex, meshInstance] : meshCollection.MeshInstances | std::views::enumerate)
+        {
+            const MeshData& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
+
+            const auto vertexCount = (uint32_t)mesh.GetVertices().size();
+            const auto indexCount = (uint32_t)mesh.GetIndices().size();
+
+            if (mesh.PrimitiveTopology != PrimitiveTopology::TriangleList || vertexCount > params.MaxVertexCount || indexCount > params.MaxIndexCount)
+            {
+                continue;
+            }
+
+            const StaticBatchKey batchKey = GetStaticBatchKey(meshInstance, mesh, params.MaxBatchExtent);
+
+            const auto openBatchIt = openBatchIndices.find(batchKey);
+            const bool isOpenBatchFull = openBatchIt != openBatchIndices.end()
+                && (batches[openBatchIt->second].VertexCount + vertexCount > params.MaxVertexCount || batches[openBatchIt->second].IndexCount + indexCount > params.MaxIndexCount);
+
+            if (openBatchIt == openBatchIndices.end() || isOpenBatchFull)
+            {
+                openBatchIndices[batchKey] = batches.size();
+                batches.push_back(StaticBatch{ .MaterialIndex = meshInstance.MaterialIndex });
+            }
+
+            StaticBatch& batch = batches[openBatchIndices[batchKey]];
+            batch.MeshInstanceIndices.push_back((uint32_t)meshInstanceIndex);
+            batch.VertexCount += vertexCount;
+            batch.IndexCount += indexCount;
+        }
+
+        // A single instance is already one draw
+        std::erase_if(batches, [](const StaticBatch& batch) { return batch.MeshInstanceIndices.size() < 2; });
+
+        std::vector<MeshData> batchMeshes(batches.size());
+        ParallelForEach(batches, [&](const StaticBatch& batch)
+        {
+            batchMeshes[&batch - batches.data()] = BuildBatchMesh(meshCollection, batch);
+        });
+
+        // Instances which are not batched keep their order, batches go after them
+        std::vector<bool> isBatched(meshCollection.MeshInstances.size(), false);
+        for (const StaticBatch& batch : batches)
+        {
+            for (const uint32_t meshInstanceIndex : batch.MeshInstanceIndices)
+            {
+                isBatched[meshInstanceIndex] = true;
+            }
+        }
+
+        std::vector<MeshInstance> meshInstances;
+        for (const auto& [meshInstanceIndex, meshInstance] : meshCollection.MeshInstances | std::views::enumerate)
+        {
+            if (!isBatched[meshInstanceIndex])
+            {
+                meshInstances.push_back(meshInstance);
+            }
+        }
+
+        for (const auto& [batchIndex, batch] : batches | std::views::enumerate)
+        {
+            meshInstances.push_back(MeshInstance
+            {
+                .MeshIndex = (uint32_t)(meshCollection.Meshes.size() + batchIndex),
+                .MaterialIndex = batch.MaterialIndex,
+                .Transform = DirectX::XMMatrixIdentity(),
+            });
+        }
+
+        meshCollection.MeshInstances = std::move(meshInstances);
+        std::ranges::move(batchMeshes, std::back_inserter(meshCollection.Meshes));
+
+        RemoveUnusedMeshes(meshCollection);
+
+        stats.MeshInstanceCountAfter = meshCollection.MeshInstances.size();
+        stats.MeshCountAfter = meshCollection.Meshes.size();
+        stats.VertexCountAfter = GetTotalVertexCount(meshCollection);
+        stats.BatchCount = batches.size();
+
+        return stats;
+    }
+
+} // namespace benzin
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct MeshCollectionResource;
+
+    struct StaticBatchingParams
+    {
+        // Caps of a combined mesh. Instances of bigger meshes are drawn as is
+        uint32_t MaxVertexCount = 1 << 16;
+        uint32_t MaxIndexCount = 3 << 16;
+
+        // Instances are batched together only if centers of their bounds fall into the same cell of this size, in units of instance transforms.
+        // Keeps batches local, so they can still be culled and get their LOD by distance. Zero batches the whole collection per material
+        float MaxBatchExtent = 8.0f;
+    };
+
+    struct StaticBatchingStats
+    {
+        size_t MeshInstanceCountBefore = 0; // Draws of the collection
+        size_t MeshInstanceCountAfter = 0;
+        size_t MeshCountBefore = 0;
+        size_t MeshCountAfter = 0;
+        size_t VertexCountBefore = 0; // Batching copies shared meshes for every instance
+        size_t VertexCountAfter = 0;
+        size_t BatchCount = 0;
+
+        StaticBatchingStats& operator+=(const StaticBatchingStats& other);
+    };
+
+    // Merges mesh instances which share a material into combined meshes. Instance transforms are baked into vertices,
+    // so batches are drawn with the identity transform and belong to no node. Bounds are recomputed per batch, LOD levels are merged level by level,
+    // meshlets and packed vertices are rebuilt if the collection has them. Meshes that are not referenced anymore are removed
+    // Instance indices change, so it's meant for static collections which are drawn as a whole
+    StaticBatchingStats BatchStaticMeshInstances(MeshCollectionResource& meshCollection, const StaticBatchingParams& params = {});
+
+} // namespace benzin
@@ -0,0 +1,520 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/tangent_generator.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/core/logger.hpp"
+#include "benzin/engine/resource_loader.hpp"
+#include "benzin/utility/hash_utils.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // Position, normal and UV. MikkTSpace treats vertices with equal attributes as one vertex, whatever their indices are
+        using TangentSpaceVertexKey = std::array<uint32_t, 8>;
+
+        struct TangentSpaceVertexKeyHasher
+        {
+            size_t operator()(const TangentSpaceVertexKey& key) const
+            {
+                return HashSpan(std::span<const uint32_t>{ key });
+            }
+        };
+
+        struct TriangleTangentInfo
+        {
+            DirectX::XMFLOAT3 Tangent{ 0.0f, 0.0f, 0.0f }; // Unit UV gradient along U
+            std::array<uint32_t, 3> Neighbors; // Triangle across the edge from the corner 'i' to the corner 'i + 1'
+            std::array<uint32_t, 3> Groups; // Per corner
+
+            bool IsOrientationPreserving = false; // Positive UV area
+            bool IsGroupWithAny = false; // Zero UV gradient. Joins the first group that reaches it and doesn't contribute to it
+            bool IsDegenerate = false; // Two corners are the same vertex. Corners take tangents from other triangles of the vertex
+        };
+
+        // Triangles around a vertex connected by edges and with the same UV orientation, they share one tangent
+        struct TangentSpaceGroup
+        {
+            uint32_t VertexIndex = 0;
+            bool IsOrientationPreserving = false;
+
+            DirectX::XMFLOAT3 Tangent{ 0.0f, 0.0f, 0.0f };
+        };
+
+        TangentSpaceVertexKey GetTangentSpaceVertexKey(const joint::MeshVertex& vertex)
+        {
+            return TangentSpaceVertexKey
+            {
+                std::bit_cast<uint32_t>(vertex.Position.x), std::bit_cast<uint32_t>(vertex.Position.y), std::bit_cast<uint32_t>(vertex.Position.z),
+                std::bit_cast<uint32_t>(vertex.Normal.x), std::bit_cast<uint32_t>(vertex.Normal.y), std::bit_cast<uint32_t>(vertex.Normal.z),
+                std::bit_cast<uint32_t>(vertex.Uv.x), std::bit_cast<uint32_t>(vertex.Uv.y),
+            };
+        }
+
+        uint64_t GetDirectedEdgeKey(uint32_t vertexIndex0, uint32_t vertexIndex1)
+        {
+            return (uint64_t)vertexIndex0 << 32 | vertexIndex1;
+        }
+
+        bool IsNotZero(float value)
+        {
+            return std::abs(value) > FLT_MIN;
+        }
+
+        // Zero vectors are left as is
+        DirectX::XMVECTOR NormalizeIfNotZero(DirectX::XMVECTOR vector)
+        {
+            return IsNotZero(DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(vector))) ? DirectX::XMVector3Normalize(vector) : vector;
+        }
+
+        // Removes the component along 'normal' and normalizes the rest. Zero vectors are left as is
+        // Source normals aren't always unit length, e.g. after quantization or with a scale baked into the data, so 'normal' is normalized first
+        DirectX::XMVECTOR ProjectOnPlane(DirectX::XMVECTOR vector, DirectX::XMVECTOR normal)
+        {
+            normal = NormalizeIfNotZero(normal);
+            vector = DirectX::XMVectorSubtract(vector, DirectX::XMVectorScale(normal, DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, vector))));
+
+            return NormalizeIfNotZero(vector);
+        }
+
+        // Any unit vector orthogonal to 'normal', for vertices without a usable UV gradient
+        DirectX::XMVECTOR GetAnyOrthogonalVector(DirectX::XMVECTOR normal)
+        {
+            normal = NormalizeIfNotZero(normal);
+
+            const DirectX::XMVECTOR axis = std::abs(DirectX::XMVectorGetX(normal)) < 0.9f ? DirectX::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+            const DirectX::XMVECTOR tangent = ProjectOnPlane(axis, normal);
+
+            return IsNotZero(DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(tangent))) ? tangent : axis;
+        }
+
+        // Returns the unnormalized gradient along U and the doubled signed UV area
+        DirectX::XMVECTOR ComputeTriangleUvGradient(const joint::MeshVertex& v0, const joint::MeshVertex& v1, const joint::MeshVertex& v2, float& outSignedUvAreaX2, bool& outIsGradientValid)
+        {
+            const float u10 = v1.Uv.x - v0.Uv.x;
+            const float v10 = v1.Uv.y - v0.Uv.y;
+            const float u20 = v2.Uv.x - v0.Uv.x;
+            const float v20 = v2.Uv.y - v0.Uv.y;
+
+            const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&v0.Position);
+            const DirectX::XMVECTOR d10 = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&v1.Position), p0);
+            const DirectX::XMVECTOR d20 = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&v2.Position), p0);
+
+            outSignedUvAreaX2 = u10 * v20 - v10 * u20;
+
+            const DirectX::XMVECTOR gradientU = DirectX::XMVectorSubtract(DirectX::XMVectorScale(d10, v20), DirectX::XMVectorScale(d20, v10));
+            const DirectX::XMVECTOR gradientV = DirectX::XMVectorAdd(DirectX::XMVectorScale(d10, -u20), DirectX::XMVectorScale(d20, u10));
+
+            outIsGradientValid = IsNotZero(outSignedUvAreaX2)
+                && IsNotZero(DirectX::XMVectorGetX(DirectX::XMVector3Length(gradientU)))
+                && IsNotZero(DirectX::XMVectorGetX(DirectX::XMVector3Length(gradientV)));
+
+            return gradientU;
+        }
+
+    } // anonymous namespace
+
+    //
+
+    TangentGenerationStats& TangentGenerationStats::operator+=(const TangentGenerationStats& other)
+    {
+        MeshCount += other.MeshCount;
+        VertexCountBefore += other.VertexCountBefore;
+        VertexCountAfter += other.VertexCountAfter;
+
+        return *this;
+    }
+
+    TangentGenerationStats GenerateTangents(MeshData& mesh)
+    {
+        TangentGenerationStats stats
+        {
+            .VertexCountBefore = mesh.Vertices.size(),
+            .VertexCountAfter = mesh.Vertices.size(),
+        };
+
+        if (mesh.PrimitiveTopology != PrimitiveTopology::TriangleList || mesh.Indices.empty())
+        {
+            return stats;
+        }
+
+        BenzinAssert(mesh.Indices.size() % 3 == 0);
+
+        const size_t triangleCount = mesh.Indices.size() / 3;
+        static constexpr uint32_t invalidIndex = g_InvalidIndex<uint32_t>;
+
+        // Map vertices with equal attributes to the first of them
+        std::vector<uint32_t> cornerVertexIndices(mesh.Indices.size());
+        {
+            std::vector<uint32_t> sharedVertexIndices(mesh.Vertices.size());
+            std::unordered_map<TangentSpaceVertexKey, uint32_t, TangentSpaceVertexKeyHasher> sharedVertexIndicesByKey;
+            sharedVertexIndicesByKey.reserve(mesh.Vertices.size());
+
+            for (const auto& [vertexIndex, vertex] : mesh.Vertices | std::views::enumerate)
+            {
+                sharedVertexIndices[vertexIndex] = sharedVertexIndicesByKey.try_emplace(GetTangentSpaceVertexKey(vertex), (uint32_t)vertexIndex).first->second;
+            }
+
+            std::ranges::transform(mesh.Indices, cornerVertexIndices.begin(), [&](uint32_t vertexIndex) { return sharedVertexIndices[vertexIndex]; });
+        }
+
+        const auto GetCornerVertex = [&](size_t triangleIndex, size_t cornerIndex) -> const joint::MeshVertex&
+        {
+            return mesh.Vertices[cornerVertexIndices[triangleIndex * 3 + cornerIndex]];
+        };
+
+        // Per triangle UV gradients
+        std::vector<TriangleTangentInfo> triangleInfos(triangleCount);
+        for (const auto& [triangleIndex, triangleInfo] : triangleInfos | std::views::enumerate)
+        {
+            const uint32_t i0 = cornerVertexIndices[triangleIndex * 3 + 0];
+            const uint32_t i1 = cornerVertexIndices[triangleIndex * 3 + 1];
+            const uint32_t i2 = cornerVertexIndices[triangleIndex * 3 + 2];
+
+            triangleInfo.Neighbors.fill(invalidIndex);
+            triangleInfo.Groups.fill(invalidIndex);
+            triangleInfo.IsDegenerate = i0 == i1 || i1 == i2 || i0 == i2;
+
+            if (triangleInfo.IsDegenerate)
+            {
+                continue;
+            }
+
+            float signedUvAreaX2 = 0.0f;
+            bool isGradientValid = false;
+            const DirectX::XMVECTOR gradientU = ComputeTriangleUvGradient(mesh.Vertices[i0], mesh.Vertices[i1], mesh.Vertices[i2], signedUvAreaX2, isGradientValid);
+
+            triangleInfo.IsOrientationPreserving = signedUvAreaX2 > 0.0f;
+            triangleInfo.IsGroupWithAny = !isGradientValid;
+
+            if (isGradientValid)
+            {
+                // Dividing by the signed area turns the gradient to +U for mirrored UVs
+                DirectX::XMStoreFloat3(&triangleInfo.Tangent, DirectX::XMVector3Normalize(DirectX::XMVectorScale(gradientU, 1.0f / signedUvAreaX2)));
+            }
+        }
+
+        // Neighbors across edges with the opposite direction. For non-manifold edges the first triangle wins
+        {
+            std::unordered_map<uint64_t, uint32_t> trianglesByEdge;
+            trianglesByEdge.reserve(mesh.Indices.size());
+
+            for (const auto& [triangleIndex, triangleInfo] : triangleInfos | std::views::enumerate)
+            {
+                if (triangleInfo.IsDegenerate)
+                {
+                    continue;
+                }
+
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    const uint64_t edgeKey = GetDirectedEdgeKey(cornerVertexIndices[triangleIndex * 3 + i], cornerVertexIndices[triangleIndex * 3 + (i + 1) % 3]);
+                    trianglesByEdge.try_emplace(edgeKey, (uint32_t)triangleIndex);
+                }
+            }
+
+            for (const auto& [triangleIndex, triangleInfo] : triangleInfos | std::views::enumerate)
+            {
+                if (triangleInfo.IsDegenerate)
+                {
+                    continue;
+                }
+
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    const uint64_t oppositeEdgeKey = GetDirectedEdgeKey(cornerVertexIndices[triangleIndex * 3 + (i + 1) % 3], cornerVertexIndices[triangleIndex * 3 + i]);
+
+                    if (const auto it = trianglesByEdge.find(oppositeEdgeKey); it != trianglesByEdge.end())
+                    {
+                        triangleInfo.Neighbors[i] = it->second;
+                    }
+                }
+            }
+        }
+
+        // Grow groups from every unassigned corner over the edges adjacent to the corner vertex
+        std::vector<TangentSpaceGroup> groups;
+        std::vector<uint32_t> triangleStack;
+
+        const auto AssignGroup = [&](uint32_t startTriangleIndex, uint32_t groupIndex)
+        {
+            const TangentSpaceGroup& group = groups[groupIndex];
+
+            triangleStack.clear();
+            triangleStack.push_back(startTriangleIndex);
+
+            while (!triangleStack.empty())
+            {
+                const uint32_t triangleIndex = triangleStack.back();
+                triangleStack.pop_back();
+
+                TriangleTangentInfo& triangleInfo = triangleInfos[triangleIndex];
+
+                const auto triangleVertexIndices = std::span{ cornerVertexIndices }.subspan(triangleIndex * 3, 3);
+                const size_t cornerIndex = std::ranges::find(triangleVertexIndices, group.VertexIndex) - triangleVertexIndices.begin();
+                BenzinAssert(cornerIndex < 3);
+
+                if (triangleInfo.Groups[cornerIndex] != invalidIndex)
+                {
+                    continue;
+                }
+
+                if (triangleInfo.IsGroupWithAny && std::ranges::all_of(triangleInfo.Groups, [](uint32_t index) { return index == invalidIndex; }))
+                {
+                    triangleInfo.IsOrientationPreserving = group.IsOrientationPreserving;
+                }
+
+                if (triangleInfo.IsOrientationPreserving != group.IsOrientationPreserving)
+                {
+                    continue;
+                }
+
+                triangleInfo.Groups[cornerIndex] = groupIndex;
+
+                // Reversed, so the left neighbor is visited first as in the reference implementation
+                for (const uint32_t neighborIndex : { triangleInfo.Neighbors[(cornerIndex + 2) % 3], triangleInfo.Neighbors[cornerIndex] })
+                {
+                    if (neighborIndex != invalidIndex)
+                    {
+                        triangleStack.push_back(neighborIndex);
+                    }
+                }
+            }
+        };
+
+        for (const auto& [triangleIndex, triangleInfo] : triangleInfos | std::views::enumerate)
+        {
+            if (triangleInfo.IsDegenerate || triangleInfo.IsGroupWithAny)
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                if (triangleInfo.Groups[i] == invalidIndex)
+                {
+                    groups.push_back(TangentSpaceGroup
+                    {
+                        .VertexIndex = cornerVertexIndices[triangleIndex * 3 + i],
+                        .IsOrientationPreserving = triangleInfo.IsOrientationPreserving,
+                    });
+
+                    AssignGroup((uint32_t)triangleIndex, (uint32_t)groups.size() - 1);
+                }
+            }
+        }
+
+        // Corners of degenerate triangles and of unreached zero gradient triangles use the first group of their vertex
+        {
+            std::vector<uint32_t> firstGroupIndices(mesh.Vertices.size(), invalidIndex);
+            for (const auto& [groupIndex, group] : groups | std::views::enumerate)
+            {
+                if (firstGroupIndices[group.VertexIndex] == invalidIndex)
+                {
+                    firstGroupIndices[group.VertexIndex] = (uint32_t)groupIndex;
+                }
+            }
+
+            for (const auto& [triangleIndex, triangleInfo] : triangleInfos | std::views::enumerate)
+            {
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    if (triangleInfo.Groups[i] != invalidIndex)
+                    {
+                        continue;
+                    }
+
+                    uint32_t& groupIndex = firstGroupIndices[cornerVertexIndices[triangleIndex * 3 + i]];
+                    if (groupIndex == invalidIndex)
+                    {
+                        groups.push_back(TangentSpaceGroup{ .VertexIndex = cornerVertexIndices[triangleIndex * 3 + i], .IsOrientationPreserving = true });
+                        groupIndex = (uint32_t)groups.size() - 1;
+                    }
+
+                    triangleInfo.Groups[i] = groupIndex;
+                }
+            }
+        }
+
+        // Average the tangents of groups, weighted by corner angles in the tangent plane
+        for (const auto& [triangleIndex, triangleInfo] : triangleInfos | std::views::enumerate)
+        {
+            if (triangleInfo.IsDegenerate || triangleInfo.IsGroupWithAny)
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                TangentSpaceGroup& group = groups[triangleInfo.Groups[i]];
+
+                const DirectX::XMVECTOR normal = DirectX::XMLoadFloat3(&GetCornerVertex(triangleIndex, i).Normal);
+                const DirectX::XMVECTOR tangent = ProjectOnPlane(DirectX::XMLoadFloat3(&triangleInfo.Tangent), normal);
+
+                const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&GetCornerVertex(triangleIndex, (i + 2) % 3).Position);
+                const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&GetCornerVertex(triangleIndex, i).Position);
+                const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&GetCornerVertex(triangleIndex, (i + 1) % 3).Position);
+
+                const DirectX::XMVECTOR edge0 = ProjectOnPlane(DirectX::XMVectorSubtract(p0, p1), normal);
+                const DirectX::XMVECTOR edge1 = ProjectOnPlane(DirectX::XMVectorSubtract(p2, p1), normal);
+                const float angle = std::acos(std::clamp(DirectX::XMVectorGetX(DirectX::XMVector3Dot(edge0, edge1)), -1.0f, 1.0f));
+
+                DirectX::XMStoreFloat3(&group.Tangent, DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&group.Tangent), DirectX::XMVectorScale(tangent, angle)));
+            }
+        }
+
+        for (TangentSpaceGroup& group : groups)
+        {
+            const DirectX::XMVECTOR tangent = DirectX::XMLoadFloat3(&group.Tangent);
+
+            DirectX::XMStoreFloat3(
+                &group.Tangent,
+                IsNotZero(DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(tangent)))
+                    ? DirectX::XMVector3Normalize(tangent)
+                    : GetAnyOrthogonalVector(DirectX::XMLoadFloat3(&mesh.Vertices[group.VertexIndex].Normal))
+            );
+        }
+
+        // Write tangents. Vertices which are used by different groups are split
+        std::vector<uint32_t> vertexGroupIndices(mesh.Vertices.size(), invalidIndex);
+        std::unordered_map<uint64_t, uint32_t> splitVertexIndices;
+
+        for (const auto& [triangleIndex, triangleInfo] : triangleInfos | std::views::enumerate)
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                uint32_t& vertexIndex = mesh.Indices[triangleIndex * 3 + i];
+
+                const uint32_t groupIndex = triangleInfo.Groups[i];
+                const TangentSpaceGroup& group = groups[groupIndex];
+
+                const DirectX::XMFLOAT4 tangent{ group.Tangent.x, group.Tangent.y, group.Tangent.z, group.IsOrientationPreserving ? 1.0f : -1.0f };
+                const auto IsSameTangent = [&](const DirectX::XMFLOAT4& other) { return memcmp(&tangent, &other, sizeof(tangent)) == 0; };
+
+                if (vertexGroupIndices[vertexIndex] == invalidIndex)
+                {
+                    vertexGroupIndices[vertexIndex] = groupIndex;
+                    mesh.Vertices[vertexIndex].Tangent = tangent;
+
+                    continue;
+                }
+
+                if (vertexGroupIndices[vertexIndex] == groupIndex || IsSameTangent(mesh.Vertices[vertexIndex].Tangent))
+                {
+                    continue;
+                }
+
+                const auto [it, isInserted] = splitVertexIndices.try_emplace((uint64_t)vertexIndex << 32 | groupIndex, (uint32_t)mesh.Vertices.size());
+                if (isInserted)
+                {
+                    joint::MeshVertex splitVertex = mesh.Vertices[vertexIndex];
+                    splitVertex.Tangent = tangent;
+
+                    mesh.Vertices.push_back(splitVertex);
+                }
+
+                vertexIndex = it->second;
+            }
+        }
+
+        stats.MeshCount = 1;
+        stats.VertexCountAfter = mesh.Vertices.size();
+
+#if BENZIN_IS_DEBUG_BUILD
+        BenzinAssert(ValidateTangents(mesh));
+#endif
+
+        return stats;
+    }
+
+    TangentGenerationStats GenerateTangents(std::span<MeshData> meshes)
+    {
+        std::vector<TangentGenerationStats> meshStats(meshes.size());
+
+        ParallelForEach(meshes, [&](MeshData& mesh)
+        {
+            meshStats[&mesh - meshes.data()] = GenerateTangents(mesh);
+        });
+
+        TangentGenerationStats stats;
+        for (const TangentGenerationStats& stat : meshStats)
+        {
+            stats += stat;
+        }
+
+        return stats;
+    }
+
+    bool ValidateTangents(const MeshData& mesh)
+    {
+        static constexpr float tolerance = 1e-3f;
+
+        for (const auto& [vertexIndex, vertex] : mesh.Vertices | std::views::enumerate)
+        {
+            const auto Fail = [&](std::string_view reason)
+            {
+                BenzinWarning("TangentGenerator: Tangent of vertex {} is invalid. {}", vertexIndex, reason);
+                return false;
+            };
+
+            const DirectX::XMVECTOR normal = NormalizeIfNotZero(DirectX::XMLoadFloat3(&vertex.Normal));
+            const DirectX::XMVECTOR tangent = DirectX::XMLoadFloat4(&vertex.Tangent);
+
+            if (vertex.Tangent.w == 0.0f && DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(tangent)) == 0.0f)
+            {
+                continue; // Unused vertex
+            }
+
+            if (vertex.Tangent.w != 1.0f && vertex.Tangent.w != -1.0f)
+            {
+                return Fail("Bitangent sign is not +-1");
+            }
+
+            if (std::abs(DirectX::XMVectorGetX(DirectX::XMVector3Length(tangent)) - 1.0f) > tolerance)
+            {
+                return Fail("Tangent is not unit length");
+            }
+
+            if (std::abs(DirectX::XMVectorGetX(DirectX::XMVector3Dot(tangent, normal))) > tolerance)
+            {
+                return Fail("Tangent is not orthogonal to the normal");
+            }
+        }
+
+        if (mesh.PrimitiveTopology != PrimitiveTopology::TriangleList)
+        {
+            return true;
+        }
+
+        for (size_t triangleIndex = 0; triangleIndex < mesh.Indices.size() / 3; ++triangleIndex)
+        {
+            const joint::MeshVertex& v0 = mesh.Vertices[mesh.Indices[triangleIndex * 3 + 0]];
+            const joint::MeshVertex& v1 = mesh.Vertices[mesh.Indices[triangleIndex * 3 + 1]];
+            const joint::MeshVertex& v2 = mesh.Vertices[mesh.Indices[triangleIndex * 3 + 2]];
+
+            float signedUvAreaX2 = 0.0f;
+            bool isGradientValid = false;
+            ComputeTriangleUvGradient(v0, v1, v2, signedUvAreaX2, isGradientValid);
+
+            if (!isGradientValid)
+            {
+                continue;
+            }
+
+            const float sign = signedUvAreaX2 > 0.0f ? 1.0f : -1.0f;
+            if (v0.Tangent.w != sign || v1.Tangent.w != sign || v2.Tangent.w != sign)
+            {
+                BenzinWarning("TangentGenerator: Bitangent sign of triangle {} doesn't match its UV winding", triangleIndex);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+} // namespace benzin
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct MeshData;
+
+    struct TangentGenerationStats
+    {
+        size_t MeshCount = 0;
+        size_t VertexCountBefore = 0;
+        size_t VertexCountAfter = 0; // Vertices are split where their triangles have different tangent frames
+
+        TangentGenerationStats& operator+=(const TangentGenerationStats& other);
+    };
+
+    // Fills 'joint::MeshVertex::Tangent' the same way as the MikkTSpace reference implementation with default settings does.
+    // Triangles around a vertex are grouped by UV winding and averaged with corner angle weights. The sign of the bitangent is in 'w'
+    // Only triangle lists with normals and UVs are processed
+    // Ref: Morten Mikkelsen, Simulation of Wrinkled Surfaces Revisited: http://image.diku.dk/projects/media/morten.mikkelsen.08.pdf
+    // Ref: MikkTSpace: https://github.com/mmikk/MikkTSpace
+    TangentGenerationStats GenerateTangents(MeshData& mesh);
+
+    // Generates tangents for every mesh on all cores
+    TangentGenerationStats GenerateTangents(std::span<MeshData> meshes);
+
+    // Checks that tangents are unit length, orthogonal to normals, have a valid bitangent sign
+    // and point along the UV gradient of every triangle which uses them
+    bool ValidateTangents(const MeshData& mesh);
+
+} // namespace benzin
@@ -0,0 +1,848 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/texture_compressor.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        constexpr uint32_t g_BlockDimension = 4;
+        constexpr uint32_t g_BlockTexelCount = g_BlockDimension * g_BlockDimension;
+        constexpr uint32_t g_Rgba8PixelSizeInBytes = 4;
+        constexpr uint32_t g_BlockTexelsSizeInBytes = g_BlockTexelCount * g_Rgba8PixelSizeInBytes;
+
+        constexpr uint32_t g_Bc1BlockSizeInBytes = 8;
+        constexpr uint32_t g_Bc4BlockSizeInBytes = 8;
+
+        constexpr std::array<uint32_t, 16> g_Bc7Weights4{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        // Channels are in [0, 255]
+        using BlockTexels = std::array<DirectX::XMVECTOR, g_BlockTexelCount>;
+
+        const DirectX::XMVECTOR g_RgbMask = DirectX::XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f);
+        const DirectX::XMVECTOR g_RgbaMask = DirectX::XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f);
+        const DirectX::XMVECTOR g_MaxChannelValue = DirectX::XMVectorReplicate(255.0f);
+
+        BlockTexels LoadBlockTexels(std::span<const std::byte, g_BlockTexelsSizeInBytes> texels)
+        {
+            BlockTexels blockTexels;
+            for (uint32_t i = 0; i < g_BlockTexelCount; ++i)
+            {
+                blockTexels[i] = DirectX::PackedVector::XMLoadUByte4(reinterpret_cast<const DirectX::PackedVector::XMUBYTE4*>(texels.data() + i * g_Rgba8PixelSizeInBytes));
+            }
+
+            return blockTexels;
+        }
+
+        void StoreTexel(std::span<std::byte, g_BlockTexelsSizeInBytes> texels, uint32_t texelIndex, uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+        {
+            std::byte* texel = texels.data() + texelIndex * g_Rgba8PixelSizeInBytes;
+            texel[0] = (std::byte)r;
+            texel[1] = (std::byte)g;
+            texel[2] = (std::byte)b;
+            texel[3] = (std::byte)a;
+        }
+
+        DirectX::XMVECTOR ClampEndpoint(DirectX::XMVECTOR endpoint)
+        {
+            return DirectX::XMVectorClamp(endpoint, DirectX::XMVectorZero(), g_MaxChannelValue);
+        }
+
+        float GetSquaredError(DirectX::XMVECTOR a, DirectX::XMVECTOR b, DirectX::XMVECTOR channelMask)
+        {
+            const DirectX::XMVECTOR difference = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(a, b), channelMask);
+            return DirectX::XMVectorGetX(DirectX::XMVector4LengthSq(difference));
+        }
+
+        // Fits a line through texels: the mean and the principal axis found by the power iteration
+        // Endpoints are the extreme projections of texels on the line
+        void FitEndpoints(const BlockTexels& texels, DirectX::XMVECTOR channelMask, DirectX::XMVECTOR& outEndpoint0, DirectX::XMVECTOR& outEndpoint1)
+        {
+            DirectX::XMVECTOR mean = DirectX::XMVectorZero();
+            DirectX::XMVECTOR minTexel = texels[0];
+            DirectX::XMVECTOR maxTexel = texels[0];
+
+            for (const auto& texel : texels)
+            {
+                mean = DirectX::XMVectorAdd(mean, texel);
+                minTexel = DirectX::XMVectorMin(minTexel, texel);
+                maxTexel = DirectX::XMVectorMax(maxTexel, texel);
+            }
+
+            mean = DirectX::XMVectorScale(mean, 1.0f / g_BlockTexelCount);
+
+            DirectX::XMVECTOR axis = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(maxTexel, minTexel), channelMask);
+            if (DirectX::XMVectorGetX(DirectX::XMVector4LengthSq(axis)) == 0.0f)
+            {
+                outEndpoint0 = mean;
+                outEndpoint1 = mean;
+                return;
+            }
+
+            for (uint32_t iteration = 0; iteration < 8; ++iteration)
+            {
+                DirectX::XMVECTOR nextAxis = DirectX::XMVectorZero();
+                for (const auto& texel : texels)
+                {
+                    const DirectX::XMVECTOR offset = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(texel, mean), channelMask);
+                    nextAxis = DirectX::XMVectorMultiplyAdd(offset, DirectX::XMVector4Dot(offset, axis), nextAxis);
+                }
+
+                if (DirectX::XMVectorGetX(DirectX::XMVector4LengthSq(nextAxis)) < 1e-8f)
+                {
+                    break;
+                }
+
+                axis = DirectX::XMVector4Normalize(nextAxis);
+            }
+
+            axis = DirectX::XMVector4Normalize(axis);
+
+            float minProjection = std::numeric_limits<float>::max();
+            float maxProjection = std::numeric_limits<float>::lowest();
+            for (const auto& texel : texels)
+            {
+                const float projection = DirectX::XMVectorGetX(DirectX::XMVector4Dot(DirectX::XMVectorSubtract(texel, mean), axis));
+                minProjection = std::min(minProjection, projection);
+                maxProjection = std::max(maxProjection, projection);
+            }
+
+            outEndpoint0 = ClampEndpoint(DirectX::XMVectorMultiplyAdd(axis, DirectX::XMVectorReplicate(minProjection), mean));
+            outEndpoint1 = ClampEndpoint(DirectX::XMVectorMultiplyAdd(axis, DirectX::XMVectorReplicate(maxProjection), mean));
+        }
+
+        // Least squares endpoints for fixed indices. 'weights' is a weight of the second endpoint for each texel
+        bool RefineEndpoints(const BlockTexels& texels, std::span<const float, g_BlockTexelCount> weights, DirectX::XMVECTOR& outEndpoint0, DirectX::XMVECTOR& outEndpoint1)
+        {
+            float a = 0.0f;
+            float b = 0.0f;
+            float c = 0.0f;
+            DirectX::XMVECTOR x0 = DirectX::XMVectorZero();
+            DirectX::XMVECTOR x1 = DirectX::XMVectorZero();
+
+            for (const auto& [texel, weight] : std::views::zip(texels, weights))
+            {
+                const float inverseWeight = 1.0f - weight;
+
+                a += inverseWeight * inverseWeight;
+                b += inverseWeight * weight;
+                c += weight * weight;
+                x0 = DirectX::XMVectorMultiplyAdd(texel, DirectX::XMVectorReplicate(inverseWeight), x0);
+                x1 = DirectX::XMVectorMultiplyAdd(texel, DirectX::XMVectorReplicate(weight), x1);
+            }
+
+            const float determinant = a * c - b * b;
+            if (std::abs(determinant) < 1e-6f)
+            {
+                return false;
+            }
+
+            const float inverseDeterminant = 1.0f / determinant;
+
+            outEndpoint0 = ClampEndpoint(DirectX::XMVectorScale(DirectX::XMVectorSubtract(DirectX::XMVectorScale(x0, c), DirectX::XMVectorScale(x1, b)), inverseDeterminant));
+            outEndpoint1 = ClampEndpoint(DirectX::XMVectorScale(DirectX::XMVectorSubtract(DirectX::XMVectorScale(x1, a), DirectX::XMVectorScale(x0, b)), inverseDeterminant));
+
+            return true;
+        }
+
+        // 128 bit little endian stream, BC7 fields are written from the lowest bit
+        class BlockBitWriter
+        {
+        public:
+            void Write(uint32_t value, uint32_t bitCount)
+            {
+                for (uint32_t i = 0; i < bitCount; ++i, ++m_BitOffset)
+                {
+                    BenzinAssert(m_BitOffset < 128);
+                    m_Words[m_BitOffset / 64] |= (uint64_t)((value >> i) & 1) << (m_BitOffset % 64);
+                }
+            }
+
+            void Store(std::span<std::byte, 16> block) const
+            {
+                BenzinAssert(m_BitOffset == 128);
+                memcpy(block.data(), m_Words.data(), block.size());
+            }
+
+        private:
+            std::array<uint64_t, 2> m_Words{};
+            uint32_t m_BitOffset = 0;
+        };
+
+        class BlockBitReader
+        {
+        public:
+            explicit BlockBitReader(std::span<const std::byte, 16> block)
+            {
+                memcpy(m_Words.data(), block.data(), block.size());
+            }
+
+            uint32_t Read(uint32_t bitCount)
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < bitCount; ++i, ++m_BitOffset)
+                {
+                    BenzinAssert(m_BitOffset < 128);
+                    value |= (uint32_t)((m_Words[m_BitOffset / 64] >> (m_BitOffset % 64)) & 1) << i;
+                }
+
+                return value;
+            }
+
+        private:
+            std::array<uint64_t, 2> m_Words{};
+            uint32_t m_BitOffset = 0;
+        };
+
+        // BC1
+
+        uint16_t QuantizeRgb565(DirectX::XMVECTOR color)
+        {
+            DirectX::XMFLOAT3 rgb;
+            DirectX::XMStoreFloat3(&rgb, color);
+
+            const auto r = (uint32_t)std::round(rgb.x * 31.0f / 255.0f);
+            const auto g = (uint32_t)std::round(rgb.y * 63.0f / 255.0f);
+            const auto b = (uint32_t)std::round(rgb.z * 31.0f / 255.0f);
+
+            return (uint16_t)(r << 11 | g << 5 | b);
+        }
+
+        std::array<uint32_t, 3> ExpandRgb565(uint16_t color)
+        {
+            const uint32_t r = color >> 11 & 0x1f;
+            const uint32_t g = color >> 5 & 0x3f;
+            const uint32_t b = color & 0x1f;
+
+            return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2 };
+        }
+
+        std::array<std::array<uint32_t, 3>, 4> GetBc1Palette(uint16_t color0, uint16_t color1, bool isFourColorMode)
+        {
+            const auto c0 = ExpandRgb565(color0);
+            const auto c1 = ExpandRgb565(color1);
+
+            std::array<std::array<uint32_t, 3>, 4> palette{ c0, c1 };
+            for (uint32_t channel = 0; channel < 3; ++channel)
+            {
+                if (isFourColorMode)
+                {
+                    palette[2][channel] = (2 * c0[channel] + c1[channel] + 1) / 3;
+                    palette[3][channel] = (c0[channel] + 2 * c1[channel] + 1) / 3;
+                }
+                else
+                {
+                    palette[2][channel] = (c0[channel] + c1[channel]) / 2;
+                    palette[3][channel] = 0;
+                }
+            }
+
+            return palette;
+        }
+
+        void EncodeBc1ColorBlock(const BlockTexels& texels, std::byte* block)
+        {
+            constexpr std::array<float, 4> indexWeights{ 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+            struct Candidate
+            {
+                uint16_t Color0 = 0;
+                uint16_t Color1 = 0;
+                std::array<uint32_t, g_BlockTexelCount> Indices{};
+                float Error = std::numeric_limits<float>::max();
+            };
+
+            const auto Evaluate = [&](DirectX::XMVECTOR endpoint0, DirectX::XMVECTOR endpoint1)
+            {
+                Candidate candidate
+                {
+                    .Color0 = QuantizeRgb565(endpoint0),
+                    .Color1 = QuantizeRgb565(endpoint1),
+                    .Error = 0.0f,
+                };
+
+                std::array<DirectX::XMVECTOR, 4> palette;
+                for (auto&& [paletteColor, color] : std::views::zip(palette, GetBc1Palette(candidate.Color0, candidate.Color1, true)))
+                {
+                    paletteColor = DirectX::XMVectorSet((float)color[0], (float)color[1], (float)color[2], 0.0f);
+                }
+
+                for (auto&& [texel, index] : std::views::zip(texels, candidate.Indices))
+                {
+                    float bestError = std::numeric_limits<float>::max();
+                    for (uint32_t paletteIndex = 0; paletteIndex < palette.size(); ++paletteIndex)
+                    {
+                        const float error = GetSquaredError(texel, palette[paletteIndex], g_RgbMask);
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            index = paletteIndex;
+                        }
+                    }
+
+                    candidate.Error += bestError;
+                }
+
+                return candidate;
+            };
+
+            DirectX::XMVECTOR endpoint0;
+            DirectX::XMVECTOR endpoint1;
+            FitEndpoints(texels, g_RgbMask, endpoint0, endpoint1);
+
+            Candidate best = Evaluate(endpoint0, endpoint1);
+
+            for (uint32_t iteration = 0; iteration < 2; ++iteration)
+            {
+                std::array<float, g_BlockTexelCount> weights;
+                for (auto&& [weight, index] : std::views::zip(weights, best.Indices))
+                {
+                    weight = indexWeights[index];
+                }
+
+                if (!RefineEndpoints(texels, weights, endpoint0, endpoint1))
+                {
+                    break;
+                }
+
+                const Candidate candidate = Evaluate(endpoint0, endpoint1);
+                if (candidate.Error >= best.Error)
+                {
+                    break;
+                }
+
+                best = candidate;
+            }
+
+            // The four color mode requires 'Color0 > Color1'. Swapping endpoints swaps pairs of palette entries
+            if (best.Color0 < best.Color1)
+            {
+                std::swap(best.Color0, best.Color1);
+                for (auto& index : best.Indices)
+                {
+                    index ^= 1;
+                }
+            }
+            else if (best.Color0 == best.Color1)
+            {
+                best.Indices.fill(0);
+            }
+
+            uint32_t packedIndices = 0;
+            for (const auto& [i, index] : best.Indices | std::views::enumerate)
+            {
+                packedIndices |= index << (2 * i);
+            }
+
+            memcpy(block + 0, &best.Color0, sizeof(best.Color0));
+            memcpy(block + 2, &best.Color1, sizeof(best.Color1));
+            memcpy(block + 4, &packedIndices, sizeof(packedIndices));
+        }
+
+        void DecodeBc1ColorBlock(const std::byte* block, bool isFourColorModeForced, std::span<std::byte, g_BlockTexelsSizeInBytes> texels)
+        {
+            uint16_t color0 = 0;
+            uint16_t color1 = 0;
+            uint32_t packedIndices = 0;
+
+            memcpy(&color0, block + 0, sizeof(color0));
+            memcpy(&color1, block + 2, sizeof(color1));
+            memcpy(&packedIndices, block + 4, sizeof(packedIndices));
+
+            const bool isFourColorMode = isFourColorModeForced || color0 > color1;
+            const auto palette = GetBc1Palette(color0, color1, isFourColorMode);
+
+            for (uint32_t i = 0; i < g_BlockTexelCount; ++i)
+            {
+                const uint32_t index = packedIndices >> (2 * i) & 0x3;
+                const uint32_t alpha = !isFourColorMode && index == 3 ? 0 : 255;
+
+                StoreTexel(texels, i, palette[index][0], palette[index][1], palette[index][2], alpha);
+            }
+        }
+
+        // BC4 stores the alpha of BC3
+
+        std::array<uint32_t, 8> GetBc4Palette(uint32_t alpha0, uint32_t alpha1)
+        {
+            std::array<uint32_t, 8> palette{ alpha0, alpha1 };
+            for (uint32_t i = 2; i < palette.size(); ++i)
+            {
+                if (alpha0 > alpha1)
+                {
+                    palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1 + 3) / 7;
+                }
+                else
+                {
+                    palette[i] = i < 6 ? ((6 - i) * alpha0 + (i - 1) * alpha1 + 2) / 5 : (i == 6 ? 0 : 255);
+                }
+            }
+
+            return palette;
+        }
+
+        void EncodeBc4AlphaBlock(const BlockTexels& texels, std::byte* block)
+        {
+            float minAlpha = 255.0f;
+            float maxAlpha = 0.0f;
+            for (const auto& texel : texels)
+            {
+                minAlpha = std::min(minAlpha, DirectX::XMVectorGetW(texel));
+                maxAlpha = std::max(maxAlpha, DirectX::XMVectorGetW(texel));
+            }
+
+            const auto alpha0 = (uint32_t)maxAlpha;
+            const auto alpha1 = (uint32_t)minAlpha;
+            const auto palette = GetBc4Palette(alpha0, alpha1);
+
+            uint64_t packedIndices = 0;
+            if (alpha0 != alpha1)
+            {
+                for (const auto& [i, texel] : texels | std::views::enumerate)
+                {
+                    const float alpha = DirectX::XMVectorGetW(texel);
+
+                    uint64_t bestIndex = 0;
+                    float bestError = std::numeric_limits<float>::max();
+                    for (uint32_t paletteIndex = 0; paletteIndex < palette.size(); ++paletteIndex)
+                    {
+                        const float error = std::abs(alpha - (float)palette[paletteIndex]);
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            bestIndex = paletteIndex;
+                        }
+                    }
+
+                    packedIndices |= bestIndex << (3 * i);
+                }
+            }
+
+            block[0] = (std::byte)alpha0;
+            block[1] = (std::byte)alpha1;
+            memcpy(block + 2, &packedIndices, 6);
+        }
+
+        void DecodeBc4AlphaBlock(const std::byte* block, std::span<std::byte, g_BlockTexelsSizeInBytes> texels)
+        {
+            const auto palette = GetBc4Palette((uint32_t)block[0], (uint32_t)block[1]);
+
+            uint64_t packedIndices = 0;
+            memcpy(&packedIndices, block + 2, 6);
+
+            for (uint32_t i = 0; i < g_BlockTexelCount; ++i)
+            {
+                texels[i * g_Rgba8PixelSizeInBytes + 3] = (std::byte)palette[packedIndices >> (3 * i) & 0x7];
+            }
+        }
+
+        // BC7 mode 6: one subset, 7 bit RGBA endpoints with unique P-bits, 4 bit indices
+
+        uint32_t InterpolateBc7(uint32_t endpoint0, uint32_t endpoint1, uint32_t weight)
+        {
+            return ((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6;
+        }
+
+        struct Bc7Mode6Endpoint
+        {
+            std::array<uint32_t, 4> Components{}; // 7 bit
+            uint32_t PBit = 0;
+
+            uint32_t GetExpanded(uint32_t channel) const { return Components[channel] << 1 | PBit; }
+        };
+
+        Bc7Mode6Endpoint QuantizeBc7Mode6Endpoint(DirectX::XMVECTOR endpoint, uint32_t pBit)
+        {
+            DirectX::XMFLOAT4 rgba;
+            DirectX::XMStoreFloat4(&rgba, endpoint);
+
+            const auto Quantize = [&](float value)
+            {
+                return (uint32_t)std::clamp(std::round((value - (float)pBit) * 0.5f), 0.0f, 127.0f);
+            };
+
+            return Bc7Mode6Endpoint
+            {
+                .Components{ Quantize(rgba.x), Quantize(rgba.y), Quantize(rgba.z), Quantize(rgba.w) },
+                .PBit = pBit,
+            };
+        }
+
+    } // anonymous namespace
+
+    //
+
+    TextureCompressionStats& TextureCompressionStats::operator+=(const TextureCompressionStats& other)
+    {
+        TextureCount += other.TextureCount;
+        UncompressedSizeInBytes += other.UncompressedSizeInBytes;
+        CompressedSizeInBytes += other.CompressedSizeInBytes;
+        MinPsnr = std::min(MinPsnr, other.MinPsnr);
+
+        return *this;
+    }
+
+    void EncodeBc1Block(std::span<const std::byte, 64> texels, std::span<std::byte, 8> block)
+    {
+        EncodeBc1ColorBlock(LoadBlockTexels(texels), block.data());
+    }
+
+    void EncodeBc3Block(std::span<const std::byte, 64> texels, std::span<std::byte, 16> block)
+    {
+        const BlockTexels blockTexels = LoadBlockTexels(texels);
+
+        EncodeBc4AlphaBlock(blockTexels, block.data());
+        EncodeBc1ColorBlock(blockTexels, block.data() + g_Bc4BlockSizeInBytes);
+    }
+
+    void EncodeBc7Block(std::span<const std::byte, 64> texels, std::span<std::byte, 16> block)
+    {
+        const BlockTexels blockTexels = LoadBlockTexels(texels);
+
+        struct Candidate
+        {
+            Bc7Mode6Endpoint Endpoint0;
+            Bc7Mode6Endpoint Endpoint1;
+            std::array<uint32_t, g_BlockTexelCount> Indices{};
+            float Error = std::numeric_limits<float>::max();
+        };
+
+        const auto Evaluate = [&](DirectX::XMVECTOR endpoint0, DirectX::XMVECTOR endpoint1)
+        {
+            Candidate best;
+
+            // P-bits are picked by the brute force, there are only four combinations
+            for (uint32_t pBits = 0; pBits < 4; ++pBits)
+            {
+                Candidate candidate
+                {
+                    .Endpoint0 = QuantizeBc7Mode6Endpoint(endpoint0, pBits & 1),
+                    .Endpoint1 = QuantizeBc7Mode6Endpoint(endpoint1, pBits >> 1),
+                    .Error = 0.0f,
+                };
+
+                std::array<DirectX::XMVECTOR, g_Bc7Weights4.size()> palette;
+                for (auto&& [paletteColor, weight] : std::views::zip(palette, g_Bc7Weights4))
+                {
+                    paletteColor = DirectX::XMVectorSet(
+                        (float)InterpolateBc7(candidate.Endpoint0.GetExpanded(0), candidate.Endpoint1.GetExpanded(0), weight),
+                        (float)InterpolateBc7(candidate.Endpoint0.GetExpanded(1), candidate.Endpoint1.GetExpanded(1), weight),
+                        (float)InterpolateBc7(candidate.Endpoint0.GetExpanded(2), candidate.Endpoint1.GetExpanded(2), weight),
+                        (float)InterpolateBc7(candidate.Endpoint0.GetExpanded(3), candidate.Endpoint1.GetExpanded(3), weight)
+                    );
+                }
+
+                for (auto&& [texel, index] : std::views::zip(blockTexels, candidate.Indices))
+                {
+                    float bestError = std::numeric_limits<float>::max();
+                    for (uint32_t paletteIndex = 0; paletteIndex < palette.size(); ++paletteIndex)
+                    {
+                        const float error = GetSquaredError(texel, palette[paletteIndex], g_RgbaMask);
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            index = paletteIndex;
+                        }
+                    }
+
+                    candidate.Error += bestError;
+                }
+
+                if (candidate.Error < best.Error)
+                {
+                    best = candidate;
+                }
+            }
+
+            return best;
+        };
+
+        DirectX::XMVECTOR endpoint0;
+        DirectX::XMVECTOR endpoint1;
+        FitEndpoints(blockTexels, g_RgbaMask, endpoint0, endpoint1);
+
+        Candidate best = Evaluate(endpoint0, endpoint1);
+
+        for (uint32_t iteration = 0; iteration < 2; ++iteration)
+        {
+            std::array<float, g_BlockTexelCount> weights;
+            for (auto&& [weight, index] : std::views::zip(weights, best.Indices))
+            {
+                weight = (float)g_Bc7Weights4[index] / 64.0f;
+            }
+
+            if (!RefineEndpoints(blockTexels, weights, endpoint0, endpoint1))
+            {
+                break;
+            }
+
+            const Candidate candidate = Evaluate(endpoint0, endpoint1);
+            if (candidate.Error >= best.Error)
+            {
+                break;
+            }
+
+            best = candidate;
+        }
+
+        // The most significant bit of the anchor index is implicitly zero
+        if (best.Indices[0] >= g_Bc7Weights4.size() / 2)
+        {
+            std::swap(best.Endpoint0, best.Endpoint1);
+            for (auto& index : best.Indices)
+            {
+                index = (uint32_t)g_Bc7Weights4.size() - 1 - index;
+            }
+        }
+
+        BlockBitWriter writer;
+        writer.Write(1 << 6, 7); // Mode 6
+
+        for (uint32_t channel = 0; channel < 4; ++channel)
+        {
+            writer.Write(best.Endpoint0.Components[channel], 7);
+            writer.Write(best.Endpoint1.Components[channel], 7);
+        }
+
+        writer.Write(best.Endpoint0.PBit, 1);
+        writer.Write(best.Endpoint1.PBit, 1);
+
+        for (const auto& [i, index] : best.Indices | std::views::enumerate)
+        {
+            writer.Write(index, i == 0 ? 3 : 4);
+        }
+
+        writer.Store(block);
+    }
+
+    void DecodeBc1Block(std::span<const std::byte, 8> block, std::span<std::byte, 64> texels)
+    {
+        DecodeBc1ColorBlock(block.data(), false, texels);
+    }
+
+    void DecodeBc3Block(std::span<const std::byte, 16> block, std::span<std::byte, 64> texels)
+    {
+        DecodeBc1ColorBlock(block.data() + g_Bc4BlockSizeInBytes, true, texels);
+        DecodeBc4AlphaBlock(block.data(), texels);
+    }
+
+    void DecodeBc7Block(std::span<const std::byte, 16> block, std::span<std::byte, 64> texels)
+    {
+        BlockBitReader reader{ block };
+        BenzinAssert(reader.Read(7) == 1 << 6);
+
+        std::array<Bc7Mode6Endpoint, 2> endpoints;
+        for (uint32_t channel = 0; channel < 4; ++channel)
+        {
+            endpoints[0].Components[channel] = reader.Read(7);
+            endpoints[1].Components[channel] = reader.Read(7);
+        }
+
+        endpoints[0].PBit = reader.Read(1);
+        endpoints[1].PBit = reader.Read(1);
+
+        for (uint32_t i = 0; i < g_BlockTexelCount; ++i)
+        {
+            const uint32_t weight = g_Bc7Weights4[reader.Read(i == 0 ? 3 : 4)];
+
+            StoreTexel(
+                texels,
+                i,
+                InterpolateBc7(endpoints[0].GetExpanded(0), endpoints[1].GetExpanded(0), weight),
+                InterpolateBc7(endpoints[0].GetExpanded(1), endpoints[1].GetExpanded(1), weight),
+                InterpolateBc7(endpoints[0].GetExpanded(2), endpoints[1].GetExpanded(2), weight),
+                InterpolateBc7(endpoints[0].GetExpanded(3), endpoints[1].GetExpanded(3), weight)
+            );
+        }
+    }
+
+    GraphicsFormat SelectBlockCompressionFormat(TextureUsage usage, const TextureImage& textureImage)
+    {
+        // Dimensions of the top mip of block compressed textures must be multiple of the block size
+        if (textureImage.Format != GraphicsFormat::Rgba8Unorm || textureImage.IsCubeMap || textureImage.Width % g_BlockDimension != 0 || textureImage.Height % g_BlockDimension != 0)
+        {
+            return GraphicsFormat::Unknown;
+        }
+
+        switch (usage)
+        {
+            case TextureUsage::Albedo:
+            {
+                const size_t topMipSizeInBytes = (size_t)textureImage.Width * textureImage.Height * g_Rgba8PixelSizeInBytes;
+                const auto topMipData = textureImage.GetImageData().first(topMipSizeInBytes);
+
+                bool isOpaque = true;
+                for (size_t i = 3; i < topMipData.size() && isOpaque; i += g_Rgba8PixelSizeInBytes)
+                {
+                    isOpaque = topMipData[i] == std::byte{ 255 };
+                }
+
+                return isOpaque ? GraphicsFormat::Bc1Unorm : GraphicsFormat::Bc3Unorm;
+            }
+            case TextureUsage::Emissive:
+            {
+                return GraphicsFormat::Bc1Unorm;
+            }
+            case TextureUsage::Normal:
+            case TextureUsage::MetallicRoughness:
+            {
+                return GraphicsFormat::Bc7Unorm;
+            }
+            default:
+            {
+                BenzinAssert(false);
+                break;
+            }
+        }
+
+        return GraphicsFormat::Unknown;
+    }
+
+    TextureCompressionStats CompressTexture(TextureImage& textureImage, GraphicsFormat format)
+    {
+        BenzinAssert(textureImage.Format == GraphicsFormat::Rgba8Unorm);
+        BenzinAssert(!textureImage.IsCubeMap);
+        BenzinAssert(IsBlockCompressedFormat(format));
+
+        const uint32_t blockSizeInBytes = GetFormatRowPitch(format, g_BlockDimension);
+        const bool isAlphaStored = format != GraphicsFormat::Bc1Unorm;
+
+        // BC1 blocks are half of the size, so they use the first half of the scratch block
+        const auto EncodeBlock = [&](std::span<const std::byte, 64> texels, std::span<std::byte, 16> block)
+        {
+            switch (format)
+            {
+                case GraphicsFormat::Bc1Unorm: EncodeBc1Block(texels, block.first<g_Bc1BlockSizeInBytes>()); break;
+                case GraphicsFormat::Bc3Unorm: EncodeBc3Block(texels, block); break;
+                case GraphicsFormat::Bc7Unorm: EncodeBc7Block(texels, block); break;
+                default: BenzinAssert(false); break;
+            }
+        };
+
+        const auto DecodeBlock = [&](std::span<const std::byte, 16> block, std::span<std::byte, 64> texels)
+        {
+            switch (format)
+            {
+                case GraphicsFormat::Bc1Unorm: DecodeBc1Block(block.first<g_Bc1BlockSizeInBytes>(), texels); break;
+                case GraphicsFormat::Bc3Unorm: DecodeBc3Block(block, texels); break;
+                case GraphicsFormat::Bc7Unorm: DecodeBc7Block(block, texels); break;
+                default: BenzinAssert(false); break;
+            }
+        };
+
+        size_t compressedSizeInBytes = 0;
+        for (uint32_t mipIndex = 0; mipIndex < textureImage.MipCount; ++mipIndex)
+        {
+            const uint32_t mipWidth = std::max(textureImage.Width >> mipIndex, 1u);
+            const uint32_t mipHeight = std::max(textureImage.Height >> mipIndex, 1u);
+
+            compressedSizeInBytes += (size_t)GetFormatRowPitch(format, mipWidth) * GetFormatRowCount(format, mipHeight);
+        }
+
+        const std::span<const std::byte> sourceData = textureImage.GetImageData();
+        std::vector<std::byte> compressedData(compressedSizeInBytes);
+
+        double squaredError = 0.0;
+        size_t channelSampleCount = 0;
+
+        size_t sourceOffset = 0;
+        size_t destinationOffset = 0;
+        for (uint32_t mipIndex = 0; mipIndex < textureImage.MipCount; ++mipIndex)
+        {
+            const uint32_t mipWidth = std::max(textureImage.Width >> mipIndex, 1u);
+            const uint32_t mipHeight = std::max(textureImage.Height >> mipIndex, 1u);
+            const uint32_t blockRowPitch = GetFormatRowPitch(format, mipWidth);
+            const uint32_t blockRowCount = GetFormatRowCount(format, mipHeight);
+            const uint32_t blockColumnCount = blockRowPitch / blockSizeInBytes;
+
+            const std::byte* mipTexels = sourceData.data() + sourceOffset;
+            std::byte* mipBlocks = compressedData.data() + destinationOffset;
+
+            std::vector<double> blockRowSquaredErrors(blockRowCount, 0.0);
+
+            ParallelFor(blockRowCount, 1, [&](uint32_t blockRowIndex)
+            {
+                std::array<std::byte, g_BlockTexelsSizeInBytes> texels;
+                std::array<std::byte, g_BlockTexelsSizeInBytes> decodedTexels;
+                std::array<std::byte, 16> block;
+
+                for (uint32_t blockColumnIndex = 0; blockColumnIndex < blockColumnCount; ++blockColumnIndex)
+                {
+                    // Blocks of mips smaller than a block repeat edge texels
+                    for (uint32_t y = 0; y < g_BlockDimension; ++y)
+                    {
+                        const uint32_t sourceY = std::min(blockRowIndex * g_BlockDimension + y, mipHeight - 1);
+
+                        for (uint32_t x = 0; x < g_BlockDimension; ++x)
+                        {
+                            const uint32_t sourceX = std::min(blockColumnIndex * g_BlockDimension + x, mipWidth - 1);
+                            memcpy(texels.data() + (y * g_BlockDimension + x) * g_Rgba8PixelSizeInBytes, mipTexels + ((size_t)sourceY * mipWidth + sourceX) * g_Rgba8PixelSizeInBytes, g_Rgba8PixelSizeInBytes);
+                        }
+                    }
+
+                    EncodeBlock(texels, block);
+                    memcpy(mipBlocks + (size_t)blockRowIndex * blockRowPitch + blockColumnIndex * blockSizeInBytes, block.data(), blockSizeInBytes);
+
+                    DecodeBlock(block, decodedTexels);
+
+                    for (uint32_t y = 0; y < g_BlockDimension && blockRowIndex * g_BlockDimension + y < mipHeight; ++y)
+                    {
+                        for (uint32_t x = 0; x < g_BlockDimension && blockColumnIndex * g_BlockDimension + x < mipWidth; ++x)
+                        {
+                            const size_t texelOffset = (y * g_BlockDimension + x) * g_Rgba8PixelSizeInBytes;
+                            for (uint32_t channel = 0; channel < (isAlphaStored ? 4u : 3u); ++channel)
+                            {
+                                const double difference = (double)texels[texelOffset + channel] - (double)decodedTexels[texelOffset + channel];
+                                blockRowSquaredErrors[blockRowIndex] += difference * difference;
+                            }
+                        }
+                    }
+                }
+            });
+
+            squaredError += std::reduce(blockRowSquaredErrors.begin(), blockRowSquaredErrors.end());
+            channelSampleCount += (size_t)mipWidth * mipHeight * (isAlphaStored ? 4 : 3);
+
+            sourceOffset += (size_t)mipWidth * mipHeight * g_Rgba8PixelSizeInBytes;
+            destinationOffset += (size_t)blockRowPitch * blockRowCount;
+        }
+
+        BenzinAssert(sourceOffset == sourceData.size());
+        BenzinAssert(destinationOffset == compressedData.size());
+
+        const double meanSquaredError = squaredError / (double)channelSampleCount;
+
+        TextureCompressionStats stats
+        {
+            .TextureCount = 1,
+            .UncompressedSizeInBytes = sourceData.size(),
+            .CompressedSizeInBytes = compressedData.size(),
+            .MinPsnr = meanSquaredError > 0.0 ? (float)(10.0 * std::log10(255.0 * 255.0 / meanSquaredError)) : std::numeric_limits<float>::infinity(),
+        };
+
+        textureImage.Format = format;
+        textureImage.ImageData = std::move(compressedData);
+        textureImage.ResetExternalImageData();
+
+        return stats;
+    }
+
+    float GetMinAcceptablePsnr(GraphicsFormat format)
+    {
+        switch (format)
+        {
+            case GraphicsFormat::Bc1Unorm:
+            case GraphicsFormat::Bc3Unorm: return 30.0f;
+            case GraphicsFormat::Bc7Unorm: return 35.0f;
+            default: BenzinAssert(false); break;
+        }
+
+        return 0.0f;
+    }
+
+} // namespace benzin
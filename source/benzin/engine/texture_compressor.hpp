@@ -0,0 +1,49 @@
+#pragma once
+
+#include "benzin/graphics/format.hpp"
+
+namespace benzin
+{
+
+    struct TextureImage;
+
+    enum class TextureUsage : uint8_t
+    {
+        Albedo,
+        Normal,
+        MetallicRoughness,
+        Emissive,
+    };
+
+    struct TextureCompressionStats
+    {
+        size_t TextureCount = 0;
+        size_t UncompressedSizeInBytes = 0;
+        size_t CompressedSizeInBytes = 0;
+
+        float MinPsnr = std::numeric_limits<float>::infinity(); // In dB over all mips, the worst texture
+
+        TextureCompressionStats& operator+=(const TextureCompressionStats& other);
+    };
+
+    // Block encoders and decoders work on 4x4 'Rgba8' texels in row order. Layouts follow the D3D11 functional spec
+    // BC1 is always encoded in the four color mode, BC7 is encoded in the mode 6 only
+    void EncodeBc1Block(std::span<const std::byte, 64> texels, std::span<std::byte, 8> block);
+    void EncodeBc3Block(std::span<const std::byte, 64> texels, std::span<std::byte, 16> block);
+    void EncodeBc7Block(std::span<const std::byte, 64> texels, std::span<std::byte, 16> block);
+
+    void DecodeBc1Block(std::span<const std::byte, 8> block, std::span<std::byte, 64> texels);
+    void DecodeBc3Block(std::span<const std::byte, 16> block, std::span<std::byte, 64> texels);
+    void DecodeBc7Block(std::span<const std::byte, 16> block, std::span<std::byte, 64> texels); // Only the mode 6
+
+    // Returns 'GraphicsFormat::Unknown' if the image can't be block compressed
+    // BC1 for opaque albedo and emissive, BC3 for albedo with alpha, BC7 for data textures, which channels are not correlated
+    GraphicsFormat SelectBlockCompressionFormat(TextureUsage usage, const TextureImage& textureImage);
+
+    // Replaces 'Rgba8Unorm' data of all mips with blocks of 'format'. Blocks are encoded on all cores
+    TextureCompressionStats CompressTexture(TextureImage& textureImage, GraphicsFormat format);
+
+    // Lower bound of the expected quality for natural images
+    float GetMinAcceptablePsnr(GraphicsFormat format);
+
+} // namespace benzin
@@ -0,0 +1,324 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/texture_mip_generator.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        // Same defaults as in NVIDIA Texture Tools
+        constexpr float g_KaiserWidth = 3.0f; // In destination texels
+        constexpr float g_KaiserAlpha = 4.0f;
+
+        constexpr uint32_t g_Rgba8PixelSizeInBytes = 4;
+
+        // Modified Bessel function of the first kind of order zero
+        float BesselI0(float x)
+        {
+            float sum = 1.0f;
+            float term = 1.0f;
+
+            for (uint32_t k = 1; k < 32; ++k)
+            {
+                const float factor = x / (2.0f * k);
+                term *= factor * factor;
+                sum += term;
+
+                if (term < sum * 1e-7f)
+                {
+                    break;
+                }
+            }
+
+            return sum;
+        }
+
+        float Sinc(float x)
+        {
+            if (std::abs(x) < 1e-4f)
+            {
+                return 1.0f;
+            }
+
+            const float piX = DirectX::XM_PI * x;
+            return std::sin(piX) / piX;
+        }
+
+        float GetKaiserWeight(float x)
+        {
+            static const float invBesselI0Alpha = 1.0f / BesselI0(g_KaiserAlpha);
+
+            const float t = x / g_KaiserWidth;
+            if (std::abs(t) >= 1.0f)
+            {
+                return 0.0f;
+            }
+
+            return Sinc(x) * BesselI0(g_KaiserAlpha * std::sqrt(1.0f - t * t)) * invBesselI0Alpha;
+        }
+
+        // Material samplers wrap, so the filter does the same on the borders
+        uint32_t WrapIndex(int index, uint32_t size)
+        {
+            const int signedSize = (int)size;
+            return (uint32_t)(((index % signedSize) + signedSize) % signedSize);
+        }
+
+        // Normalized weights of source texels for every destination texel along one axis
+        struct FilterTaps
+        {
+            uint32_t TapCount = 0;
+            std::vector<int> FirstSourceIndices; // Not wrapped
+            std::vector<float> Weights;
+
+            std::span<const float> GetWeights(uint32_t destinationIndex) const { return std::span{ Weights }.subspan(destinationIndex * TapCount, TapCount); }
+        };
+
+        FilterTaps BuildFilterTaps(uint32_t sourceSize, uint32_t destinationSize, TextureMipFilter filter)
+        {
+            BenzinAssert(destinationSize != 0 && destinationSize <= sourceSize);
+
+            const float scale = (float)sourceSize / (float)destinationSize;
+            const float radius = (filter == TextureMipFilter::Box ? 0.5f : g_KaiserWidth) * scale; // In source texels
+
+            FilterTaps taps;
+            taps.TapCount = (uint32_t)std::ceil(2.0f * radius) + 1;
+            taps.FirstSourceIndices.resize(destinationSize);
+            taps.Weights.resize(destinationSize * taps.TapCount);
+
+            for (uint32_t destinationIndex = 0; destinationIndex < destinationSize; ++destinationIndex)
+            {
+                const float center = ((float)destinationIndex + 0.5f) * scale;
+                const int firstSourceIndex = (int)std::floor(center - radius);
+
+                taps.FirstSourceIndices[destinationIndex] = firstSourceIndex;
+
+                float* weights = taps.Weights.data() + destinationIndex * taps.TapCount;
+                float weightSum = 0.0f;
+
+                for (uint32_t tapIndex = 0; tapIndex < taps.TapCount; ++tapIndex)
+                {
+                    const auto sourceIndex = (float)(firstSourceIndex + (int)tapIndex);
+
+                    float weight = 0.0f;
+                    if (filter == TextureMipFilter::Box)
+                    {
+                        // Coverage of the source texel by the destination footprint
+                        weight = std::max(std::min(sourceIndex + 1.0f, center + radius) - std::max(sourceIndex, center - radius), 0.0f);
+                    }
+                    else
+                    {
+                        weight = GetKaiserWeight((sourceIndex + 0.5f - center) / scale);
+                    }
+
+                    weights[tapIndex] = weight;
+                    weightSum += weight;
+                }
+
+                BenzinAssert(weightSum > 0.0f);
+
+                for (uint32_t tapIndex = 0; tapIndex < taps.TapCount; ++tapIndex)
+                {
+                    weights[tapIndex] /= weightSum;
+                }
+            }
+
+            return taps;
+        }
+
+        DirectX::XMVECTOR LoadTexel(const std::byte* texel, bool isSrgb)
+        {
+            const DirectX::XMVECTOR color = DirectX::PackedVector::XMLoadUByteN4(reinterpret_cast<const DirectX::PackedVector::XMUBYTEN4*>(texel));
+            return isSrgb ? DirectX::XMColorSRGBToRGB(color) : color;
+        }
+
+        void StoreTexel(std::byte* texel, DirectX::XMVECTOR color, const TextureMipParams& params)
+        {
+            if (params.IsNormalMap)
+            {
+                const DirectX::XMVECTOR normal = DirectX::XMVector3Normalize(DirectX::XMVectorMultiplyAdd(color, DirectX::g_XMTwo, DirectX::g_XMNegativeOne));
+                color = DirectX::XMVectorSelect(color, DirectX::XMVectorMultiplyAdd(normal, DirectX::g_XMOneHalf, DirectX::g_XMOneHalf), DirectX::g_XMSelect1110);
+            }
+
+            // Kaiser filter has negative lobes
+            color = DirectX::XMVectorSaturate(color);
+
+            if (params.IsSrgb)
+            {
+                color = DirectX::XMColorRGBToSRGB(color);
+            }
+
+            DirectX::PackedVector::XMStoreUByteN4(reinterpret_cast<DirectX::PackedVector::XMUBYTEN4*>(texel), color);
+        }
+
+    } // anonymous namespace
+
+    //
+
+    uint32_t GetFullMipCount(uint32_t width, uint32_t height)
+    {
+        return (uint32_t)std::bit_width(std::max(width, height));
+    }
+
+    size_t GetRgba8MipChainSizeInBytes(uint32_t width, uint32_t height, uint32_t mipCount)
+    {
+        size_t sizeInBytes = 0;
+        for (uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+        {
+            sizeInBytes += (size_t)std::max(width >> mipIndex, 1u) * std::max(height >> mipIndex, 1u) * g_Rgba8PixelSizeInBytes;
+        }
+
+        return sizeInBytes;
+    }
+
+    void DownsampleRgba8(
+        std::span<const std::byte> source,
+        uint32_t sourceWidth,
+        uint32_t sourceHeight,
+        std::span<std::byte> destination,
+        uint32_t destinationWidth,
+        uint32_t destinationHeight,
+        const TextureMipParams& params
+    )
+    {
+        BenzinAssert(source.size() == (size_t)sourceWidth * sourceHeight * g_Rgba8PixelSizeInBytes);
+        BenzinAssert(destination.size() == (size_t)destinationWidth * destinationHeight * g_Rgba8PixelSizeInBytes);
+
+        const FilterTaps horizontalTaps = BuildFilterTaps(sourceWidth, destinationWidth, params.Filter);
+        const FilterTaps verticalTaps = BuildFilterTaps(sourceHeight, destinationHeight, params.Filter);
+
+        // The filter is separable. Horizontally filtered source rows are kept in a ring, which fits all rows of one destination row
+        // Destination rows go in order, so every source row is filtered horizontally once
+        const uint32_t ringRowCount = verticalTaps.TapCount;
+
+        std::vector<DirectX::XMVECTOR> linearSourceRow(sourceWidth);
+        std::vector<DirectX::XMVECTOR> filteredRows((size_t)ringRowCount * destinationWidth);
+        std::vector<int> filteredRowIndices(ringRowCount, std::numeric_limits<int>::min());
+
+        const auto GetFilteredRow = [&](int rowIndex)
+        {
+            const auto ringIndex = (uint32_t)WrapIndex(rowIndex, ringRowCount);
+            DirectX::XMVECTOR* filteredRow = filteredRows.data() + (size_t)ringIndex * destinationWidth;
+
+            if (filteredRowIndices[ringIndex] == rowIndex)
+            {
+                return filteredRow;
+            }
+
+            filteredRowIndices[ringIndex] = rowIndex;
+
+            const std::byte* sourceRow = source.data() + (size_t)WrapIndex(rowIndex, sourceHeight) * sourceWidth * g_Rgba8PixelSizeInBytes;
+            for (uint32_t x = 0; x < sourceWidth; ++x)
+            {
+                linearSourceRow[x] = LoadTexel(sourceRow + x * g_Rgba8PixelSizeInBytes, params.IsSrgb);
+            }
+
+            for (uint32_t x = 0; x < destinationWidth; ++x)
+            {
+                const int firstSourceIndex = horizontalTaps.FirstSourceIndices[x];
+                const std::span<const float> weights = horizontalTaps.GetWeights(x);
+
+                DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+                for (const auto& [tapIndex, weight] : weights | std::views::enumerate)
+                {
+                    sum = DirectX::XMVectorMultiplyAdd(linearSourceRow[WrapIndex(firstSourceIndex + (int)tapIndex, sourceWidth)], DirectX::XMVectorReplicate(weight), sum);
+                }
+
+                filteredRow[x] = sum;
+            }
+
+            return filteredRow;
+        };
+
+        std::vector<const DirectX::XMVECTOR*> tapRows(verticalTaps.TapCount);
+
+        for (uint32_t y = 0; y < destinationHeight; ++y)
+        {
+            const int firstSourceIndex = verticalTaps.FirstSourceIndices[y];
+            const std::span<const float> weights = verticalTaps.GetWeights(y);
+
+            for (uint32_t tapIndex = 0; tapIndex < verticalTaps.TapCount; ++tapIndex)
+            {
+                tapRows[tapIndex] = GetFilteredRow(firstSourceIndex + (int)tapIndex);
+            }
+
+            std::byte* destinationRow = destination.data() + (size_t)y * destinationWidth * g_Rgba8PixelSizeInBytes;
+
+            for (uint32_t x = 0; x < destinationWidth; ++x)
+            {
+                DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+                for (const auto& [tapIndex, weight] : weights | std::views::enumerate)
+                {
+                    sum = DirectX::XMVectorMultiplyAdd(tapRows[tapIndex][x], DirectX::XMVectorReplicate(weight), sum);
+                }
+
+                StoreTexel(destinationRow + x * g_Rgba8PixelSizeInBytes, sum, params);
+            }
+        }
+    }
+
+    void GenerateTextureMips(TextureImage& textureImage, const TextureMipParams& params)
+    {
+        BenzinAssert(textureImage.Format == GraphicsFormat::Rgba8Unorm);
+        BenzinAssert(!textureImage.IsCubeMap);
+        BenzinAssert(textureImage.MipCount == 1);
+        BenzinAssert(textureImage.GetImageData().size() == GetRgba8MipChainSizeInBytes(textureImage.Width, textureImage.Height, 1));
+
+        const uint32_t mipCount = GetFullMipCount(textureImage.Width, textureImage.Height);
+        const size_t mipChainSizeInBytes = GetRgba8MipChainSizeInBytes(textureImage.Width, textureImage.Height, mipCount);
+
+        textureImage.ImageData.resize(mipChainSizeInBytes);
+
+        // External storage can't grow, so its top mip is copied into the chain once
+        if (!textureImage.ExternalImageData.empty())
+        {
+            std::ranges::copy(textureImage.ExternalImageData, textureImage.ImageData.begin());
+            textureImage.ResetExternalImageData();
+        }
+
+        textureImage.MipCount = mipCount;
+
+        const std::span<std::byte> imageData = textureImage.ImageData;
+
+        size_t sourceOffset = 0;
+        for (uint32_t mipIndex = 1; mipIndex < mipCount; ++mipIndex)
+        {
+            const uint32_t sourceWidth = std::max(textureImage.Width >> (mipIndex - 1), 1u);
+            const uint32_t sourceHeight = std::max(textureImage.Height >> (mipIndex - 1), 1u);
+            const uint32_t destinationWidth = std::max(textureImage.Width >> mipIndex, 1u);
+            const uint32_t destinationHeight = std::max(textureImage.Height >> mipIndex, 1u);
+
+            const size_t sourceSize = (size_t)sourceWidth * sourceHeight * g_Rgba8PixelSizeInBytes;
+            const size_t destinationSize = (size_t)destinationWidth * destinationHeight * g_Rgba8PixelSizeInBytes;
+
+            DownsampleRgba8(
+                imageData.subspan(sourceOffset, sourceSize),
+                sourceWidth,
+                sourceHeight,
+                imageData.subspan(sourceOffset + sourceSize, destinationSize),
+                destinationWidth,
+                destinationHeight,
+                params
+            );
+
+            sourceOffset += sourceSize;
+        }
+    }
+
+    void GenerateTextureMips(std::span<TextureImage> textureImages, std::span<const TextureMipParams> params)
+    {
+        BenzinAssert(params.empty() || params.size() == textureImages.size());
+
+        ParallelForEach(textureImages, [&](TextureImage& textureImage)
+        {
+            const size_t i = &textureImage - textureImages.data();
+            GenerateTextureMips(textureImage, params.empty() ? TextureMipParams{} : params[i]);
+        });
+    }
+
+} // namespace benzin
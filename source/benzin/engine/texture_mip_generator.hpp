@@ -0,0 +1,45 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct TextureImage;
+
+    enum class TextureMipFilter : uint8_t
+    {
+        Box, // Averages the covered texels. Cheap, but blurs and aliases
+        Kaiser, // Kaiser windowed sinc. Keeps details sharper on distant surfaces
+    };
+
+    struct TextureMipParams
+    {
+        TextureMipFilter Filter = TextureMipFilter::Kaiser;
+        bool IsSrgb = false; // Color channels are filtered in linear space, alpha is always linear
+        bool IsNormalMap = false; // Filtered normals are renormalized
+    };
+
+    uint32_t GetFullMipCount(uint32_t width, uint32_t height);
+
+    // Size of the first 'mipCount' levels stored one after another without padding
+    size_t GetRgba8MipChainSizeInBytes(uint32_t width, uint32_t height, uint32_t mipCount);
+
+    // Resamples 'Rgba8' texels to the destination size, which is not bigger than the source one
+    // Doesn't depend on the GPU, so the filter can be checked on the CPU side
+    void DownsampleRgba8(
+        std::span<const std::byte> source,
+        uint32_t sourceWidth,
+        uint32_t sourceHeight,
+        std::span<std::byte> destination,
+        uint32_t destinationWidth,
+        uint32_t destinationHeight,
+        const TextureMipParams& params = {}
+    );
+
+    // Appends the full mip chain to 'TextureImage::ImageData', each level is filtered from the previous one
+    // Only 2D 'Rgba8Unorm' images are supported
+    void GenerateTextureMips(TextureImage& textureImage, const TextureMipParams& params = {});
+
+    // Runs 'GenerateTextureMips' on all cores. 'params' is either empty or has an entry per image
+    void GenerateTextureMips(std::span<TextureImage> textureImages, std::span<const TextureMipParams> params);
+
+} // namespace benzin
@@ -0,0 +1,619 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/transform_hierarchy.hpp"
+
+#include <immintrin.h>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/job_system.hpp"
+#include "benzin/core/logger.hpp"
+#include "benzin/core/math.hpp"
+
+namespace benzin
+{
+
+    namespace
+    {
+
+        enum NodeFlag : uint8_t
+        {
+            NodeFlag_Dirty = 1 << 0, // World matrix is rebuilt by the next 'Update'
+            NodeFlag_ChangedLastUpdate = 1 << 1, // Previous world matrix differs from the world matrix
+        };
+
+        // Smaller depths are updated on the calling thread
+        constexpr uint32_t g_NodeCountPerJob = 1024;
+
+        using LocalTransformComponents = std::array<std::vector<float>, 9>;
+        static_assert(sizeof(LocalTransform) == sizeof(float) * std::tuple_size_v<LocalTransformComponents>);
+
+        LocalTransform LoadLocalTransform(const LocalTransformComponents& components, uint32_t nodeIndex)
+        {
+            std::array<float, std::tuple_size_v<LocalTransformComponents>> values;
+            for (const auto& [value, component] : std::views::zip(values, components))
+            {
+                value = component[nodeIndex];
+            }
+
+            return std::bit_cast<LocalTransform>(values);
+        }
+
+        void StoreLocalTransform(LocalTransformComponents& components, uint32_t nodeIndex, const LocalTransform& localTransform)
+        {
+            const auto values = std::bit_cast<std::array<float, std::tuple_size_v<LocalTransformComponents>>>(localTransform);
+            for (const auto& [value, component] : std::views::zip(values, components))
+            {
+                component[nodeIndex] = value;
+            }
+        }
+
+        // 'GetLocalMatrix' for 4 nodes at once, every component is a lane. Missing nodes of a shorter range get the identity
+        void GetLocalMatrices(const LocalTransformComponents& components, IndexRangeU32 nodeRange, std::array<DirectX::XMMATRIX, 4>& outLocalMatrices)
+        {
+            BenzinAssert(nodeRange.Count != 0 && nodeRange.Count <= 4);
+
+            std::array<__m128, std::tuple_size_v<LocalTransformComponents>> lanes;
+            if (nodeRange.Count == 4)
+            {
+                for (const auto& [lane, component] : std::views::zip(lanes, components))
+                {
+                    lane = _mm_loadu_ps(&component[nodeRange.StartIndex]);
+                }
+            }
+            else
+            {
+                const auto identityValues = std::bit_cast<std::array<float, std::tuple_size_v<LocalTransformComponents>>>(LocalTransform{});
+                for (uint32_t componentIndex = 0; componentIndex < components.size(); ++componentIndex)
+                {
+                    std::array<float, 4> values;
+                    values.fill(identityValues[componentIndex]);
+                    std::copy_n(&components[componentIndex][nodeRange.StartIndex], nodeRange.Count, values.data());
+
+                    lanes[componentIndex] = _mm_loadu_ps(values.data());
+                }
+            }
+
+            const auto& [scaleX, scaleY, scaleZ, rotationX, rotationY, rotationZ, translationX, translationY, translationZ] = lanes;
+
+            __m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+            DirectX::XMVectorSinCos(&sinX, &cosX, rotationX);
+            DirectX::XMVectorSinCos(&sinY, &cosY, rotationY);
+            DirectX::XMVectorSinCos(&sinZ, &cosZ, rotationZ);
+
+            // 'RotationX * RotationY * RotationZ' element by element
+            const __m128 sinXSinY = _mm_mul_ps(sinX, sinY);
+            const __m128 cosXSinY = _mm_mul_ps(cosX, sinY);
+
+            const __m128 m00 = _mm_mul_ps(cosY, cosZ);
+            const __m128 m01 = _mm_mul_ps(cosY, sinZ);
+            const __m128 m02 = _mm_sub_ps(_mm_setzero_ps(), sinY);
+            const __m128 m10 = _mm_sub_ps(_mm_mul_ps(sinXSinY, cosZ), _mm_mul_ps(cosX, sinZ));
+            const __m128 m11 = _mm_add_ps(_mm_mul_ps(sinXSinY, sinZ), _mm_mul_ps(cosX, cosZ));
+            const __m128 m12 = _mm_mul_ps(sinX, cosY);
+            const __m128 m20 = _mm_add_ps(_mm_mul_ps(cosXSinY, cosZ), _mm_mul_ps(sinX, sinZ));
+            const __m128 m21 = _mm_sub_ps(_mm_mul_ps(cosXSinY, sinZ), _mm_mul_ps(sinX, cosZ));
+            const __m128 m22 = _mm_mul_ps(cosX, cosY);
+
+            // Scaling goes first, so it scales rows of the rotation. A transpose turns lanes of a row into the row of every node
+            std::array<std::array<__m128, 4>, 4> rows
+            {{
+                { _mm_mul_ps(m00, scaleX), _mm_mul_ps(m01, scaleX), _mm_mul_ps(m02, scaleX), _mm_setzero_ps() },
+                { _mm_mul_ps(m10, scaleY), _mm_mul_ps(m11, scaleY), _mm_mul_ps(m12, scaleY), _mm_setzero_ps() },
+                { _mm_mul_ps(m20, scaleZ), _mm_mul_ps(m21, scaleZ), _mm_mul_ps(m22, scaleZ), _mm_setzero_ps() },
+                { translationX, translationY, translationZ, _mm_set1_ps(1.0f) },
+            }};
+
+            for (auto& row : rows)
+            {
+                _MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+            }
+
+            for (const auto& [nodeOffset, localMatrix] : outLocalMatrices | std::views::enumerate)
+            {
+                for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex)
+                {
+                    localMatrix.r[rowIndex] = rows[rowIndex][nodeOffset];
+                }
+            }
+        }
+
+        // 'scratch' gets the old buffer back, so arrays are only swapped once both have grown to the node count
+        template <typename T>
+        void ReorderNodeData(std::vector<T>& nodeData, std::span<const uint32_t> oldNodeIndices, std::vector<T>& scratch)
+        {
+            scratch.clear();
+
+            for (const uint32_t oldNodeIndex : oldNodeIndices)
+            {
+                scratch.push_back(nodeData[oldNodeIndex]);
+            }
+
+            std::swap(nodeData, scratch);
+        }
+
+        bool IsMatrixNearEqual(const DirectX::XMMATRIX& lhs, const DirectX::XMMATRIX& rhs)
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                const DirectX::XMVECTOR epsilon = DirectX::XMVectorMultiplyAdd(DirectX::XMVectorAbs(lhs.r[i]), DirectX::XMVectorReplicate(1e-4f), DirectX::XMVectorReplicate(1e-4f));
+                if (!DirectX::XMVector4NearEqual(lhs.r[i], rhs.r[i], epsilon))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    } // anonymous namespace
+
+    //
+
+    DirectX::XMMATRIX GetLocalMatrix(const LocalTransform& localTransform)
+    {
+        const DirectX::XMMATRIX rotation = DirectX::XMMatrixRotationX(localTransform.Rotation.x) * DirectX::XMMatrixRotationY(localTransform.Rotation.y) * DirectX::XMMatrixRotationZ(localTransform.Rotation.z);
+        const DirectX::XMMATRIX scaling = DirectX::XMMatrixScaling(localTransform.Scale.x, localTransform.Scale.y, localTransform.Scale.z);
+        const DirectX::XMMATRIX translation = DirectX::XMMatrixTranslation(localTransform.Translation.x, localTransform.Translation.y, localTransform.Translation.z);
+
+        return scaling * rotation * translation;
+    }
+
+    LocalTransform DecomposeLocalMatrix(const DirectX::XMMATRIX& localMatrix)
+    {
+        DirectX::XMVECTOR scale;
+        DirectX::XMVECTOR rotationQuaternion;
+        DirectX::XMVECTOR translation;
+        if (!DirectX::XMMatrixDecompose(&scale, &rotationQuaternion, &translation, localMatrix))
+        {
+            LocalTransform localTransform{ .Scale{ 0.0f, 0.0f, 0.0f } };
+            DirectX::XMStoreFloat3(&localTransform.Translation, localMatrix.r[3]);
+
+            return localTransform;
+        }
+
+        DirectX::XMFLOAT3X3 rotation;
+        DirectX::XMStoreFloat3x3(&rotation, DirectX::XMMatrixRotationQuaternion(rotationQuaternion));
+
+        // Elements of 'RotationX(x) * RotationY(y) * RotationZ(z)': _13 is -sin(y), _23 / _33 give x. Z is taken from rows 2 and 3 rotated back by x,
+        // so it makes up for the error of x, which is only defined as 'x - z' or 'x + z' when cos(y) is zero
+        LocalTransform localTransform;
+        localTransform.Rotation.x = std::atan2(rotation._23, rotation._33);
+        localTransform.Rotation.y = std::atan2(-rotation._13, std::sqrt(rotation._11 * rotation._11 + rotation._12 * rotation._12));
+
+        const float sinX = std::sin(localTransform.Rotation.x);
+        const float cosX = std::cos(localTransform.Rotation.x);
+        localTransform.Rotation.z = std::atan2(sinX * rotation._31 - cosX * rotation._21, cosX * rotation._22 - sinX * rotation._32);
+
+        DirectX::XMStoreFloat3(&localTransform.Scale, scale);
+        DirectX::XMStoreFloat3(&localTransform.Translation, translation);
+
+        return localTransform;
+    }
+
+    //
+
+    TransformNodeId TransformHierarchy::CreateNode(TransformNodeId parentId)
+    {
+        BenzinAssert(!IsValidIndex(parentId) || IsNodeAlive(parentId));
+
+        TransformNodeId nodeId = g_InvalidIndex<TransformNodeId>;
+        if (!m_FreeNodeIds.empty())
+        {
+            nodeId = m_FreeNodeIds.back();
+            m_FreeNodeIds.pop_back();
+        }
+        else
+        {
+            nodeId = (TransformNodeId)m_NodeIndices.size();
+            m_NodeIndices.push_back(g_InvalidIndex<uint32_t>);
+            m_ParentIds.push_back(g_InvalidIndex<TransformNodeId>);
+        }
+
+        m_NodeIndices[nodeId] = (uint32_t)m_NodeIds.size();
+        m_ParentIds[nodeId] = parentId;
+
+        // Appended nodes are moved to their depth by 'SortByDepth'
+        m_NodeIds.push_back(nodeId);
+        m_ParentIndices.push_back(g_InvalidIndex<uint32_t>);
+        for (const auto& [component, value] : std::views::zip(m_LocalTransformComponents, std::bit_cast<std::array<float, std::tuple_size_v<LocalTransformComponents>>>(LocalTransform{})))
+        {
+            component.push_back(value);
+        }
+        m_Flags.push_back(NodeFlag_Dirty);
+        m_WorldMatrices.push_back(DirectX::XMMatrixIdentity());
+        m_PreviousWorldMatrices.push_back(DirectX::XMMatrixIdentity());
+        m_WorldMatricesForNormals.push_back(DirectX::XMMatrixIdentity());
+
+        m_IsSortNeeded = true;
+        m_IsUpdateNeeded = true;
+
+        return nodeId;
+    }
+
+    void TransformHierarchy::DestroyNode(TransformNodeId nodeId)
+    {
+        const uint32_t nodeIndex = GetNodeIndex(nodeId);
+
+        // The slot is removed and children are attached to the parent by 'SortByDepth'
+        // Until then the id isn't reused, so the parent link of the destroyed node is kept
+        m_NodeIds[nodeIndex] = g_InvalidIndex<TransformNodeId>;
+        m_NodeIndices[nodeId] = g_InvalidIndex<uint32_t>;
+        m_DestroyedNodeIds.push_back(nodeId);
+
+        m_IsSortNeeded = true;
+        m_IsUpdateNeeded = true;
+    }
+
+    TransformNodeId TransformHierarchy::GetParent(TransformNodeId nodeId) const
+    {
+        BenzinAssert(IsNodeAlive(nodeId));
+        return m_ParentIds[nodeId];
+    }
+
+    void TransformHierarchy::SetParent(TransformNodeId nodeId, TransformNodeId parentId)
+    {
+        BenzinAssert(IsNodeAlive(nodeId));
+        BenzinAssert(!IsValidIndex(parentId) || IsNodeAlive(parentId));
+
+#if BENZIN_IS_DEBUG_BUILD
+        for (TransformNodeId ancestorId = parentId; IsValidIndex(ancestorId); ancestorId = m_ParentIds[ancestorId])
+        {
+            BenzinAssert(ancestorId != nodeId, "TransformHierarchy: Parent links can't form a cycle");
+        }
+#endif
+
+        if (m_ParentIds[nodeId] == parentId)
+        {
+            return;
+        }
+
+        m_ParentIds[nodeId] = parentId;
+        MarkDirty(nodeId);
+
+        m_IsSortNeeded = true;
+    }
+
+    LocalTransform TransformHierarchy::GetLocalTransform(TransformNodeId nodeId) const
+    {
+        return LoadLocalTransform(m_LocalTransformComponents, GetNodeIndex(nodeId));
+    }
+
+    void TransformHierarchy::SetLocalTransform(TransformNodeId nodeId, const LocalTransform& localTransform)
+    {
+        StoreLocalTransform(m_LocalTransformComponents, GetNodeIndex(nodeId), localTransform);
+        MarkDirty(nodeId);
+    }
+
+    const DirectX::XMMATRIX& TransformHierarchy::GetWorldMatrix(TransformNodeId nodeId) const
+    {
+        return m_WorldMatrices[GetNodeIndex(nodeId)];
+    }
+
+    const DirectX::XMMATRIX& TransformHierarchy::GetPreviousWorldMatrix(TransformNodeId nodeId) const
+    {
+        return m_PreviousWorldMatrices[GetNodeIndex(nodeId)];
+    }
+
+    const DirectX::XMMATRIX& TransformHierarchy::GetWorldMatrixForNormals(TransformNodeId nodeId) const
+    {
+        return m_WorldMatricesForNormals[GetNodeIndex(nodeId)];
+    }
+
+    bool TransformHierarchy::IsWorldMatrixUpdated(TransformNodeId nodeId) const
+    {
+        return (m_Flags[GetNodeIndex(nodeId)] & NodeFlag_ChangedLastUpdate) != 0;
+    }
+
+    void TransformHierarchy::Update()
+    {
+        m_Stats.UpdatedNodeCount = 0;
+
+        if (m_IsSortNeeded)
+        {
+            SortByDepth();
+        }
+
+        if (!m_IsUpdateNeeded)
+        {
+            return;
+        }
+
+        const auto nodeCount = (uint32_t)m_NodeIds.size();
+
+        // A parent is before its children, so a single pass marks whole subtrees
+        const uint32_t firstChildIndex = m_DepthRanges.size() > 1 ? m_DepthRanges[1].StartIndex : nodeCount;
+        for (uint32_t i = firstChildIndex; i < nodeCount; ++i)
+        {
+            m_Flags[i] |= m_Flags[m_ParentIndices[i]] & NodeFlag_Dirty;
+        }
+
+        m_Stats.UpdatedNodeCount = (uint32_t)std::ranges::count_if(m_Flags, [](uint8_t flags) { return (flags & NodeFlag_Dirty) != 0; });
+
+        // Nodes of a depth depend only on the previous depths
+        for (const IndexRangeU32 depthRange : m_DepthRanges)
+        {
+            if (depthRange.Count <= g_NodeCountPerJob)
+            {
+                UpdateNodes(depthRange);
+                continue;
+            }
+
+            JobSystem::ParallelForRanges(depthRange.Count, g_NodeCountPerJob, [&](IndexRangeU32 range)
+            {
+                UpdateNodes(IndexRangeU32{ depthRange.StartIndex + range.StartIndex, range.Count });
+            });
+        }
+
+        // Previous world matrices of updated nodes are synced by the next update
+        m_IsUpdateNeeded = m_Stats.UpdatedNodeCount != 0;
+    }
+
+    bool TransformHierarchy::Validate() const
+    {
+        if (m_IsSortNeeded)
+        {
+            BenzinWarning("TransformHierarchy: Nodes aren't sorted, 'Update' wasn't called after the last change");
+            return false;
+        }
+
+        uint32_t nodeIndex = 0;
+        for (const auto& [depth, depthRange] : m_DepthRanges | std::views::enumerate)
+        {
+            if (depthRange.StartIndex != nodeIndex || depthRange.Count == 0)
+            {
+                BenzinWarning("TransformHierarchy: Depth {} is invalid. Node ranges of depths must be contiguous and not empty", depth);
+                return false;
+            }
+
+            nodeIndex += depthRange.Count;
+        }
+
+        if (nodeIndex != m_NodeIds.size())
+        {
+            BenzinWarning("TransformHierarchy: Depths cover {} of {} nodes", nodeIndex, m_NodeIds.size());
+            return false;
+        }
+
+        for (const auto& [depth, depthRange] : m_DepthRanges | std::views::enumerate)
+        {
+            for (const uint32_t i : IndexRangeToView(depthRange))
+            {
+                const TransformNodeId nodeId = m_NodeIds[i];
+                const uint32_t parentIndex = m_ParentIndices[i];
+                const char* reason = nullptr;
+
+                if (!IsValidIndex(nodeId) || nodeId >= m_NodeIndices.size() || m_NodeIndices[nodeId] != i)
+                {
+                    reason = "Node id doesn't map back to the node";
+                }
+                else if (depth == 0 ? IsValidIndex(parentIndex) : !IsValidIndex(parentIndex))
+                {
+                    reason = "Only nodes of depth 0 are roots";
+                }
+                else if (depth != 0 && (parentIndex < m_DepthRanges[depth - 1].StartIndex || parentIndex >= depthRange.StartIndex || m_NodeIds[parentIndex] != m_ParentIds[nodeId]))
+                {
+                    reason = "Parent isn't the parent node of the previous depth";
+                }
+                else if ((m_Flags[i] & NodeFlag_Dirty) != 0)
+                {
+                    reason = "Node is dirty, 'Update' wasn't called after the last change";
+                }
+                else if (!IsMatrixNearEqual(m_WorldMatrices[i], GetLocalMatrix(LoadLocalTransform(m_LocalTransformComponents, i)) * (depth == 0 ? DirectX::XMMatrixIdentity() : m_WorldMatrices[parentIndex])))
+                {
+                    reason = "World matrix doesn't match the parent chain";
+                }
+                else if (!IsMatrixNearEqual(m_WorldMatricesForNormals[i], GetMatrixForNormals(m_WorldMatrices[i])))
+                {
+                    reason = "World matrix for normals doesn't match the world matrix";
+                }
+
+                if (reason)
+                {
+                    BenzinWarning("TransformHierarchy: Node {} is invalid. {}", i, reason);
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool TransformHierarchy::IsNodeAlive(TransformNodeId nodeId) const
+    {
+        return nodeId < m_NodeIndices.size() && IsValidIndex(m_NodeIndices[nodeId]);
+    }
+
+    uint32_t TransformHierarchy::GetNodeIndex(TransformNodeId nodeId) const
+    {
+        BenzinAssert(IsNodeAlive(nodeId));
+        return m_NodeIndices[nodeId];
+    }
+
+    void TransformHierarchy::MarkDirty(TransformNodeId nodeId)
+    {
+        m_Flags[GetNodeIndex(nodeId)] |= NodeFlag_Dirty;
+        m_IsUpdateNeeded = true;
+    }
+
+    void TransformHierarchy::SortByDepth()
+    {
+        const auto oldNodeCount = (uint32_t)m_NodeIds.size();
+
+        // Children of destroyed nodes go to the closest alive ancestor
+        for (uint32_t i = 0; i < oldNodeCount; ++i)
+        {
+            const TransformNodeId nodeId = m_NodeIds[i];
+            if (!IsValidIndex(nodeId))
+            {
+                continue;
+            }
+
+            TransformNodeId parentId = m_ParentIds[nodeId];
+            bool isParentDestroyed = false;
+
+            while (IsValidIndex(parentId) && !IsValidIndex(m_NodeIndices[parentId]))
+            {
+                parentId = m_ParentIds[parentId];
+                isParentDestroyed = true;
+            }
+
+            if (isParentDestroyed)
+            {
+                m_ParentIds[nodeId] = parentId;
+                m_Flags[i] |= NodeFlag_Dirty;
+            }
+        }
+
+        // Destroyed ids can be reused from now on
+        for (const TransformNodeId destroyedNodeId : m_DestroyedNodeIds)
+        {
+            m_ParentIds[destroyedNodeId] = g_InvalidIndex<TransformNodeId>;
+        }
+
+        m_FreeNodeIds.append_range(m_DestroyedNodeIds);
+        m_DestroyedNodeIds.clear();
+
+        // Depths are found by walking up to the first ancestor with a known depth
+        std::vector<uint32_t>& depths = m_SortScratch.Depths;
+        depths.assign(m_NodeIndices.size(), g_InvalidIndex<uint32_t>);
+
+        std::vector<TransformNodeId>& unknownDepthNodeIds = m_SortScratch.UnknownDepthNodeIds;
+        uint32_t depthCount = 0;
+
+        for (const TransformNodeId nodeId : m_NodeIds)
+        {
+            if (!IsValidIndex(nodeId))
+            {
+                continue;
+            }
+
+            TransformNodeId currentId = nodeId;
+            while (IsValidIndex(currentId) && !IsValidIndex(depths[currentId]))
+            {
+                unknownDepthNodeIds.push_back(currentId);
+                currentId = m_ParentIds[currentId];
+            }
+
+            uint32_t depth = IsValidIndex(currentId) ? depths[currentId] + 1 : 0;
+            for (const TransformNodeId unknownDepthNodeId : unknownDepthNodeIds | std::views::reverse)
+            {
+                depths[unknownDepthNodeId] = depth++;
+            }
+            unknownDepthNodeIds.clear();
+
+            depthCount = std::max(depthCount, depths[nodeId] + 1);
+        }
+
+        // Counting sort by depth keeps the order of nodes inside a depth
+        m_DepthRanges.assign(depthCount, IndexRangeU32{});
+        for (const TransformNodeId nodeId : m_NodeIds)
+        {
+            if (IsValidIndex(nodeId))
+            {
+                m_DepthRanges[depths[nodeId]].Count++;
+            }
+        }
+
+        uint32_t nodeCount = 0;
+        for (IndexRangeU32& depthRange : m_DepthRanges)
+        {
+            depthRange.StartIndex = nodeCount;
+            nodeCount += depthRange.Count;
+        }
+
+        std::vector<uint32_t>& oldNodeIndices = m_SortScratch.OldNodeIndices;
+        oldNodeIndices.resize(nodeCount);
+
+        std::vector<uint32_t>& depthOffsets = m_SortScratch.DepthOffsets;
+        depthOffsets.assign(depthCount, 0);
+
+        for (uint32_t i = 0; i < oldNodeCount; ++i)
+        {
+            const TransformNodeId nodeId = m_NodeIds[i];
+            if (!IsValidIndex(nodeId))
+            {
+                continue;
+            }
+
+            const uint32_t depth = depths[nodeId];
+            oldNodeIndices[m_DepthRanges[depth].StartIndex + depthOffsets[depth]++] = i;
+        }
+
+        ReorderNodeData(m_NodeIds, oldNodeIndices, m_SortScratch.NodeIds);
+        for (std::vector<float>& component : m_LocalTransformComponents)
+        {
+            ReorderNodeData(component, oldNodeIndices, m_SortScratch.LocalTransformComponents);
+        }
+        ReorderNodeData(m_Flags, oldNodeIndices, m_SortScratch.Flags);
+        ReorderNodeData(m_WorldMatrices, oldNodeIndices, m_SortScratch.Matrices);
+        ReorderNodeData(m_PreviousWorldMatrices, oldNodeIndices, m_SortScratch.Matrices);
+        ReorderNodeData(m_WorldMatricesForNormals, oldNodeIndices, m_SortScratch.Matrices);
+
+        for (const auto [nodeIndex, nodeId] : m_NodeIds | std::views::enumerate)
+        {
+            m_NodeIndices[nodeId] = (uint32_t)nodeIndex;
+        }
+
+        m_ParentIndices.resize(nodeCount);
+        for (const auto [nodeIndex, nodeId] : m_NodeIds | std::views::enumerate)
+        {
+            const TransformNodeId parentId = m_ParentIds[nodeId];
+            m_ParentIndices[nodeIndex] = IsValidIndex(parentId) ? m_NodeIndices[parentId] : g_InvalidIndex<uint32_t>;
+        }
+
+        m_Stats.NodeCount = nodeCount;
+        m_Stats.DepthCount = depthCount;
+
+        m_IsSortNeeded = false;
+    }
+
+    void TransformHierarchy::UpdateNodes(IndexRangeU32 nodeRange)
+    {
+        std::array<DirectX::XMMATRIX, 4> localMatrices;
+
+        for (uint32_t i = nodeRange.StartIndex; i < nodeRange.StartIndex + nodeRange.Count; i += 4)
+        {
+            const IndexRangeU32 groupRange{ i, std::min(4u, nodeRange.StartIndex + nodeRange.Count - i) };
+
+            // Clean groups only sync previous world matrices
+            const bool isAnyNodeDirty = std::ranges::any_of(IndexRangeToView(groupRange), [&](uint32_t nodeIndex) { return (m_Flags[nodeIndex] & NodeFlag_Dirty) != 0; });
+            if (isAnyNodeDirty)
+            {
+                GetLocalMatrices(m_LocalTransformComponents, groupRange, localMatrices);
+            }
+
+            for (uint32_t nodeOffset = 0; nodeOffset < groupRange.Count; ++nodeOffset)
+            {
+                UpdateNode(i + nodeOffset, localMatrices[nodeOffset]);
+            }
+        }
+    }
+
+    void TransformHierarchy::UpdateNode(uint32_t nodeIndex, const DirectX::XMMATRIX& localMatrix)
+    {
+        uint8_t& flags = m_Flags[nodeIndex];
+
+        if ((flags & NodeFlag_Dirty) != 0)
+        {
+            const uint32_t parentIndex = m_ParentIndices[nodeIndex];
+
+            DirectX::XMMATRIX worldMatrix = localMatrix;
+            if (IsValidIndex(parentIndex))
+            {
+                worldMatrix *= m_WorldMatrices[parentIndex];
+            }
+
+            m_PreviousWorldMatrices[nodeIndex] = m_WorldMatrices[nodeIndex];
+            m_WorldMatrices[nodeIndex] = worldMatrix;
+            m_WorldMatricesForNormals[nodeIndex] = GetMatrixForNormals(worldMatrix);
+
+            flags = NodeFlag_ChangedLastUpdate;
+        }
+        else if ((flags & NodeFlag_ChangedLastUpdate) != 0)
+        {
+            m_PreviousWorldMatrices[nodeIndex] = m_WorldMatrices[nodeIndex];
+
+            flags = 0;
+        }
+    }
+
+} // namespace benzin
@@ -0,0 +1,110 @@
+#pragma once
+
+namespace benzin
+{
+
+    // Stays the same while nodes are reordered
+    using TransformNodeId = uint32_t;
+
+    struct LocalTransform
+    {
+        DirectX::XMFLOAT3 Scale{ 1.0f, 1.0f, 1.0f };
+        DirectX::XMFLOAT3 Rotation{ 0.0f, 0.0f, 0.0f }; // Euler angles, applied in X, Y, Z order
+        DirectX::XMFLOAT3 Translation{ 0.0f, 0.0f, 0.0f };
+    };
+
+    // Scaling, then rotation, then translation
+    DirectX::XMMATRIX GetLocalMatrix(const LocalTransform& localTransform);
+
+    // Inverse of 'GetLocalMatrix'. Shear can't be represented and is dropped, a matrix with a zero scale axis gives the zero scale
+    LocalTransform DecomposeLocalMatrix(const DirectX::XMMATRIX& localMatrix);
+
+    struct TransformHierarchyStats
+    {
+        uint32_t NodeCount = 0;
+        uint32_t DepthCount = 0;
+        uint32_t UpdatedNodeCount = 0; // World matrices rebuilt by the last 'Update'
+    };
+
+    // Parent links between transforms. Node data is stored as separate arrays sorted by depth, so a parent is always
+    // before its children and nodes of one depth are contiguous. 'Update' pushes dirty flags down to children in a single pass
+    // and rebuilds matrices only of changed subtrees, depth by depth, splitting every depth between job workers.
+    // Every component of local transforms is a separate array too, so local matrices are built for 4 nodes at once
+    class TransformHierarchy
+    {
+    public:
+        TransformNodeId CreateNode(TransformNodeId parentId = g_InvalidIndex<TransformNodeId>);
+
+        // Children are attached to the parent of the node, their local transforms are kept
+        void DestroyNode(TransformNodeId nodeId);
+
+        TransformNodeId GetParent(TransformNodeId nodeId) const;
+        void SetParent(TransformNodeId nodeId, TransformNodeId parentId);
+
+        LocalTransform GetLocalTransform(TransformNodeId nodeId) const;
+        void SetLocalTransform(TransformNodeId nodeId, const LocalTransform& localTransform);
+
+        // Valid after 'Update'
+        const DirectX::XMMATRIX& GetWorldMatrix(TransformNodeId nodeId) const;
+        const DirectX::XMMATRIX& GetPreviousWorldMatrix(TransformNodeId nodeId) const; // World matrix before the last 'Update'
+        const DirectX::XMMATRIX& GetWorldMatrixForNormals(TransformNodeId nodeId) const;
+        bool IsWorldMatrixUpdated(TransformNodeId nodeId) const; // World matrix was rebuilt by the last 'Update'
+
+        const auto& GetStats() const { return m_Stats; }
+
+        // Called once per frame
+        void Update();
+
+        // Checks the depth order, parent links and that world matrices match the local transforms of the parent chain
+        bool Validate() const;
+
+    private:
+        bool IsNodeAlive(TransformNodeId nodeId) const;
+        uint32_t GetNodeIndex(TransformNodeId nodeId) const;
+        void MarkDirty(TransformNodeId nodeId);
+
+        void SortByDepth();
+        void UpdateNodes(IndexRangeU32 nodeRange);
+        void UpdateNode(uint32_t nodeIndex, const DirectX::XMMATRIX& localMatrix);
+
+    private:
+        // By node index
+        std::vector<TransformNodeId> m_NodeIds;
+        std::vector<uint32_t> m_ParentIndices;
+        std::array<std::vector<float>, 9> m_LocalTransformComponents; // Scale, rotation and translation, XYZ each
+        std::vector<uint8_t> m_Flags; // 'NodeFlag' bits
+        std::vector<DirectX::XMMATRIX> m_WorldMatrices;
+        std::vector<DirectX::XMMATRIX> m_PreviousWorldMatrices;
+        std::vector<DirectX::XMMATRIX> m_WorldMatricesForNormals;
+
+        std::vector<IndexRangeU32> m_DepthRanges; // Node index ranges of every depth
+
+        // By node id, parents are kept here while the order is invalid
+        std::vector<uint32_t> m_NodeIndices;
+        std::vector<TransformNodeId> m_ParentIds;
+        std::vector<TransformNodeId> m_DestroyedNodeIds; // Parent links are needed until the next sort
+        std::vector<TransformNodeId> m_FreeNodeIds;
+
+        // Kept between sorts, so structural changes don't allocate once the hierarchy has reached its size
+        struct SortScratch
+        {
+            std::vector<uint32_t> Depths; // By node id
+            std::vector<TransformNodeId> UnknownDepthNodeIds;
+            std::vector<uint32_t> OldNodeIndices;
+            std::vector<uint32_t> DepthOffsets;
+
+            std::vector<TransformNodeId> NodeIds;
+            std::vector<float> LocalTransformComponents; // Shared by the component arrays like 'Matrices'
+            std::vector<uint8_t> Flags;
+            std::vector<DirectX::XMMATRIX> Matrices; // Shared by the three matrix arrays, which are swapped through it one by one
+        };
+
+        SortScratch m_SortScratch;
+
+        bool m_IsSortNeeded = false;
+        bool m_IsUpdateNeeded = false;
+
+        TransformHierarchyStats m_Stats;
+    };
+
+} // namespace benzin
@@ -0,0 +1,120 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/engine/vertex_packing.hpp"
+
+#include <shaders/joint/vertex_packing.hpp>
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/core/math.hpp"
+#include "benzin/engine/resource_loader.hpp"
+
+namespace benzin
+{
+
+    // Half of the unorm16 step, float rounding of the normalization adds a bit on top
+    static constexpr float g_MaxPositionError = 0.5f / 65535.0f + 1e-6f;
+
+    // Octahedral snorm16 normals are off by up to 0.004 degrees
+    static constexpr float g_MaxNormalErrorInDegrees = 0.01f;
+
+    // The unorm14 angle step is 0.022 degrees, and the tangent also follows the error of the decoded normal
+    static constexpr float g_MaxTangentErrorInDegrees = 0.02f;
+
+    // Halfs keep 11 significant bits
+    static constexpr float g_MaxUvError = 1.0f / 2048.0f;
+
+    // 'XMVector3AngleBetweenVectors' goes through acos, which loses about 0.03 degrees for small angles in float
+    static float GetAngleInDegrees(const DirectX::XMVECTOR& v0, const DirectX::XMVECTOR& v1)
+    {
+        const float sinAngle = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVector3Cross(v0, v1)));
+        const float cosAngle = DirectX::XMVectorGetX(DirectX::XMVector3Dot(v0, v1));
+
+        return DirectX::XMConvertToDegrees(std::atan2(sinAngle, cosAngle));
+    }
+
+    VertexPackingStats& VertexPackingStats::operator+=(const VertexPackingStats& other)
+    {
+        VertexCount += other.VertexCount;
+        UnpackedSizeInBytes += other.UnpackedSizeInBytes;
+        PackedSizeInBytes += other.PackedSizeInBytes;
+
+        MaxPositionError = std::max(MaxPositionError, other.MaxPositionError);
+        MaxNormalError = std::max(MaxNormalError, other.MaxNormalError);
+        MaxTangentError = std::max(MaxTangentError, other.MaxTangentError);
+        MaxUvError = std::max(MaxUvError, other.MaxUvError);
+
+        return *this;
+    }
+
+    VertexPackingStats PackMeshVertices(MeshData& mesh)
+    {
+        if (!mesh.BoundingBox)
+        {
+            mesh.BoundingBox = ComputeBoundingBox(mesh.Vertices);
+        }
+
+        const DirectX::XMFLOAT3& center = mesh.BoundingBox->Center;
+        const DirectX::XMFLOAT3& extents = mesh.BoundingBox->Extents;
+
+        VertexPackingStats stats
+        {
+            .VertexCount = mesh.Vertices.size(),
+            .UnpackedSizeInBytes = mesh.Vertices.size() * sizeof(joint::MeshVertex),
+            .PackedSizeInBytes = mesh.Vertices.size() * sizeof(joint::PackedMeshVertex),
+        };
+
+        mesh.PackedVertices.resize(mesh.Vertices.size());
+
+        for (const auto& [i, vertex] : mesh.Vertices | std::views::enumerate)
+        {
+            const joint::PackedMeshVertex packedVertex = joint::PackMeshVertex(vertex, center, extents);
+            mesh.PackedVertices[i] = packedVertex;
+
+            const joint::MeshVertex unpackedVertex = joint::UnpackMeshVertex(packedVertex, center, extents);
+
+            const auto UpdatePositionError = [&](float original, float unpacked, float extent)
+            {
+                if (extent > 0.0f)
+                {
+                    stats.MaxPositionError = std::max(stats.MaxPositionError, std::abs(unpacked - original) / (2.0f * extent));
+                }
+            };
+
+            UpdatePositionError(vertex.Position.x, unpackedVertex.Position.x, extents.x);
+            UpdatePositionError(vertex.Position.y, unpackedVertex.Position.y, extents.y);
+            UpdatePositionError(vertex.Position.z, unpackedVertex.Position.z, extents.z);
+
+            const DirectX::XMVECTOR originalNormal = DirectX::XMLoadFloat3(&vertex.Normal);
+            if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(originalNormal)) > 0.0f)
+            {
+                const float normalError = GetAngleInDegrees(DirectX::XMVector3Normalize(originalNormal), DirectX::XMLoadFloat3(&unpackedVertex.Normal));
+                stats.MaxNormalError = std::max(stats.MaxNormalError, normalError);
+            }
+
+            if (vertex.Tangent.w != 0.0f)
+            {
+                const DirectX::XMVECTOR originalTangent = DirectX::XMVector3Normalize(DirectX::XMLoadFloat4(&vertex.Tangent));
+                const float tangentError = GetAngleInDegrees(originalTangent, DirectX::XMLoadFloat4(&unpackedVertex.Tangent));
+                stats.MaxTangentError = std::max(stats.MaxTangentError, vertex.Tangent.w == unpackedVertex.Tangent.w ? tangentError : 180.0f);
+            }
+
+            const auto UpdateUvError = [&](float original, float unpacked)
+            {
+                stats.MaxUvError = std::max(stats.MaxUvError, std::abs(unpacked - original) / std::max(std::abs(original), 1.0f));
+            };
+
+            UpdateUvError(vertex.Uv.x, unpackedVertex.Uv.x);
+            UpdateUvError(vertex.Uv.y, unpackedVertex.Uv.y);
+        }
+
+        return stats;
+    }
+
+    bool IsVertexPackingErrorAcceptable(const VertexPackingStats& stats)
+    {
+        return stats.MaxPositionError <= g_MaxPositionError
+            && stats.MaxNormalError <= g_MaxNormalErrorInDegrees
+            && stats.MaxTangentError <= g_MaxTangentErrorInDegrees
+            && stats.MaxUvError <= g_MaxUvError;
+    }
+
+} // namespace benzin
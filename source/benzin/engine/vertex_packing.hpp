@@ -0,0 +1,32 @@
+#pragma once
+
+namespace benzin
+{
+
+    struct MeshData;
+
+    struct VertexPackingStats
+    {
+        size_t VertexCount = 0;
+        size_t UnpackedSizeInBytes = 0;
+        size_t PackedSizeInBytes = 0;
+
+        // Round trip errors
+        float MaxPositionError = 0.0f; // Relative to the bounding box size
+        float MaxNormalError = 0.0f; // Angle in degrees
+        float MaxTangentError = 0.0f; // Angle in degrees, 180 if the bitangent sign is lost
+        float MaxUvError = 0.0f; // Relative to the UV magnitude
+
+        size_t GetSavedSizeInBytes() const { return UnpackedSizeInBytes - PackedSizeInBytes; }
+
+        VertexPackingStats& operator+=(const VertexPackingStats& other);
+    };
+
+    // Fills 'MeshData::PackedVertices' with the packed copy of 'MeshData::Vertices', see 'joint::PackedMeshVertex'
+    // Positions are quantized relative to 'MeshData::BoundingBox', which is computed if it is missing
+    VertexPackingStats PackMeshVertices(MeshData& mesh);
+
+    // Checks that the round trip errors are within the limits of the packed format
+    bool IsVertexPackingErrorAcceptable(const VertexPackingStats& stats);
+
+} // namespace benzin
@@ -3,6 +3,7 @@
 
 #include "benzin/core/asserter.hpp"
 #include "benzin/graphics/buffer.hpp"
+#include "benzin/graphics/command_signature.hpp"
 #include "benzin/graphics/descriptor_manager.hpp"
 #include "benzin/graphics/device.hpp"
 #include "benzin/graphics/pipeline_state.hpp"
@@ -91,9 +92,9 @@ namespace benzin
         }
     }
 
-    void CommandList::SetResourceBarriers(const std::vector<ResourceBarrierVariant>& resourceBarriers)
+    void CommandList::SetResourceBarriers(std::span<const ResourceBarrierVariant> resourceBarriers)
     {
-        const auto d3d12ResourceBarriers = resourceBarriers | std::views::transform(ToD3D12ResourceBarrierVariant) | std::ranges::to<std::vector>();
+        const auto d3d12ResourceBarriers = resourceBarriers | std::views::transform(ToD3D12ResourceBarrierVariant) | std::ranges::to<FrameVector<D3D12_RESOURCE_BARRIER>>();
         m_D3D12GraphicsCommandList->ResourceBarrier((uint32_t)d3d12ResourceBarriers.size(), d3d12ResourceBarriers.data());
 
         for (const auto& resourceBarrier : resourceBarriers)
@@ -267,6 +268,36 @@ namespace benzin
         UpdateTexture(texture, { topMipSubResource });
     }
 
+    void CopyCommandList::UpdateTextureMips(Texture& texture, std::span<const std::byte> data)
+    {
+        std::vector<SubResourceData> mipSubResources;
+        mipSubResources.reserve(texture.GetSubResourceCount());
+
+        size_t offset = 0;
+        for (uint32_t arrayIndex = 0; arrayIndex < texture.GetDepth(); ++arrayIndex)
+        {
+            for (uint32_t mipIndex = 0; mipIndex < texture.GetMipCount(); ++mipIndex)
+            {
+                const uint32_t mipWidth = std::max(texture.GetWidth() >> mipIndex, 1u);
+                const uint32_t mipHeight = std::max(texture.GetHeight() >> mipIndex, 1u);
+
+                const uint32_t rowPitch = GetFormatRowPitch(texture.GetFormat(), mipWidth);
+
+                const SubResourceData& mipSubResource = mipSubResources.emplace_back(SubResourceData
+                {
+                    .Data = data.data() + offset,
+                    .RowPitch = rowPitch,
+                    .SlicePitch = (size_t)rowPitch * GetFormatRowCount(texture.GetFormat(), mipHeight),
+                });
+
+                offset += mipSubResource.SlicePitch;
+            }
+        }
+
+        BenzinAssert(offset == data.size_bytes());
+        UpdateTexture(texture, mipSubResources);
+    }
+
     void CopyCommandList::CreateUploadBuffer(Device& device, uint32_t size)
     {
         MakeUniquePtr(m_UploadBuffer, device, BufferCreation
@@ -453,6 +484,24 @@ namespace benzin
         m_D3D12GraphicsCommandList->DrawIndexedInstanced(indexCount, instanceCount, startIndexLocation, baseVertexLocation, 0);
     }
 
+    void GraphicsCommandList::ExecuteIndirect(const CommandSignature& commandSignature, const Buffer& argumentBuffer, IndexRangeU32 commandRange)
+    {
+        BenzinAssert(commandSignature.GetD3D12CommandSignature());
+        BenzinAssert(argumentBuffer.GetD3D12Resource());
+
+        const uint64_t argumentBufferOffset = (uint64_t)commandRange.StartIndex * commandSignature.GetCommandSizeInBytes();
+        BenzinAssert(argumentBufferOffset + (uint64_t)commandRange.Count * commandSignature.GetCommandSizeInBytes() <= argumentBuffer.GetSizeInBytes());
+
+        m_D3D12GraphicsCommandList->ExecuteIndirect(
+            commandSignature.GetD3D12CommandSignature(),
+            commandRange.Count,
+            argumentBuffer.GetD3D12Resource(),
+            argumentBufferOffset,
+            nullptr,
+            0
+        );
+    }
+
     void GraphicsCommandList::Dispatch(const DirectX::XMUINT3& dimension, const DirectX::XMUINT3& threadPerGroupCount)
     {
         BenzinAssert(threadPerGroupCount.x != 0);
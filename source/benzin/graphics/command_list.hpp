@@ -6,6 +6,7 @@ namespace benzin
 {
 
     class Buffer;
+    class CommandSignature;
     class Descriptor;
     class PipelineState;
     class Resource;
@@ -49,7 +50,8 @@ namespace benzin
 
     public:
         void SetResourceBarrier(const ResourceBarrierVariant& resourceBarrier);
-        void SetResourceBarriers(const std::vector<ResourceBarrierVariant>& resourceBarriers);
+        void SetResourceBarriers(std::span<const ResourceBarrierVariant> resourceBarriers);
+        void SetResourceBarriers(std::initializer_list<ResourceBarrierVariant> resourceBarriers) { SetResourceBarriers(std::span{ resourceBarriers.begin(), resourceBarriers.size() }); }
 
         void CopyResource(Resource& to, Resource& from);
 
@@ -76,6 +78,7 @@ namespace benzin
         void UpdateTexture(Texture& texture, const std::vector<SubResourceData>& subResources);
 
         void UpdateTextureTopMip(Texture& texture, std::span<const std::byte> data);
+        void UpdateTextureMips(Texture& texture, std::span<const std::byte> data); // All subresources are stored one after another without padding, mips of each array slice go together
 
     private:
         bool IsValid() const { return m_UploadBuffer == nullptr; }
@@ -130,6 +133,9 @@ namespace benzin
         void DrawVertexed(uint32_t vertexCount, uint32_t instanceCount = 1);
         void DrawIndexed(uint32_t indexCount, uint32_t startIndexLocation, uint32_t baseVertexLocation, uint32_t instanceCount = 1);
 
+        // 'argumentBuffer' is an array of commands laid out by 'commandSignature'
+        void ExecuteIndirect(const CommandSignature& commandSignature, const Buffer& argumentBuffer, IndexRangeU32 commandRange);
+
         void Dispatch(const DirectX::XMUINT3& dimension, const DirectX::XMUINT3& threadPerGroupCount); // #TODO: Duplication
 
         void BuildRayTracingAccelerationStructure(const RtAccelerationStructure& accelerationStructure);
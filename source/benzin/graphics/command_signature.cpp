@@ -0,0 +1,60 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/graphics/command_signature.hpp"
+
+#include "benzin/core/asserter.hpp"
+#include "benzin/graphics/device.hpp"
+
+namespace benzin
+{
+
+    CommandSignature::CommandSignature(Device& device, const CommandSignatureCreation& creation)
+    {
+        BenzinAssert(device.GetD3D12Device());
+        BenzinAssert(device.GetD3D12BindlessRootSignature());
+
+        const uint32_t rootParameterIndex = 0;
+
+        std::vector<D3D12_INDIRECT_ARGUMENT_DESC> d3d12IndirectArgumentDescs;
+
+        if (creation.RootConstantRange.Count != 0)
+        {
+            d3d12IndirectArgumentDescs.push_back(D3D12_INDIRECT_ARGUMENT_DESC
+            {
+                .Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT,
+                .Constant
+                {
+                    .RootParameterIndex = rootParameterIndex,
+                    .DestOffsetIn32BitValues = creation.RootConstantRange.StartIndex,
+                    .Num32BitValuesToSet = creation.RootConstantRange.Count,
+                },
+            });
+        }
+
+        d3d12IndirectArgumentDescs.push_back(D3D12_INDIRECT_ARGUMENT_DESC
+        {
+            .Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW,
+        });
+
+        m_CommandSizeInBytes = creation.RootConstantRange.Count * sizeof(uint32_t) + sizeof(D3D12_DRAW_ARGUMENTS);
+
+        const D3D12_COMMAND_SIGNATURE_DESC d3d12CommandSignatureDesc
+        {
+            .ByteStride = m_CommandSizeInBytes,
+            .NumArgumentDescs = (UINT)d3d12IndirectArgumentDescs.size(),
+            .pArgumentDescs = d3d12IndirectArgumentDescs.data(),
+            .NodeMask = 0,
+        };
+
+        // Root signature is required only if commands change root arguments
+        ID3D12RootSignature* d3d12RootSignature = creation.RootConstantRange.Count != 0 ? device.GetD3D12BindlessRootSignature() : nullptr;
+
+        BenzinAssert(device.GetD3D12Device()->CreateCommandSignature(&d3d12CommandSignatureDesc, d3d12RootSignature, IID_PPV_ARGS(&m_D3D12CommandSignature)));
+        SetD3D12ObjectDebugName(m_D3D12CommandSignature, creation.DebugName);
+    }
+
+    CommandSignature::~CommandSignature()
+    {
+        SafeUnknownRelease(m_D3D12CommandSignature);
+    }
+
+} // namespace benzin
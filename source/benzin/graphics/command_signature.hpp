@@ -0,0 +1,37 @@
+#pragma once
+
+namespace benzin
+{
+
+    class Device;
+
+    struct CommandSignatureCreation
+    {
+        std::string_view DebugName;
+
+        IndexRangeU32 RootConstantRange; // Set by every command before its 'D3D12_DRAW_ARGUMENTS'. Empty range sets nothing
+    };
+
+    // Layout of one command of an indirect argument buffer for 'GraphicsCommandList::ExecuteIndirect'
+    class CommandSignature
+    {
+    public:
+        BenzinDefineNonCopyable(CommandSignature);
+        BenzinDefineNonMoveable(CommandSignature);
+
+    public:
+        CommandSignature(Device& device, const CommandSignatureCreation& creation);
+        ~CommandSignature();
+
+    public:
+        ID3D12CommandSignature* GetD3D12CommandSignature() const { return m_D3D12CommandSignature; }
+
+        auto GetCommandSizeInBytes() const { return m_CommandSizeInBytes; }
+
+    private:
+        ID3D12CommandSignature* m_D3D12CommandSignature = nullptr;
+
+        uint32_t m_CommandSizeInBytes = 0;
+    };
+
+} // namespace benzin
@@ -37,4 +37,29 @@ namespace benzin
         std::unreachable();
     }
 
+    bool IsBlockCompressedFormat(GraphicsFormat format)
+    {
+        return format == GraphicsFormat::Bc1Unorm || format == GraphicsFormat::Bc3Unorm || format == GraphicsFormat::Bc7Unorm;
+    }
+
+    uint32_t GetFormatRowPitch(GraphicsFormat format, uint32_t width)
+    {
+        switch (format)
+        {
+            using enum GraphicsFormat;
+
+            case Bc1Unorm: return std::max((width + 3) / 4, 1u) * 8;
+
+            case Bc3Unorm:
+            case Bc7Unorm: return std::max((width + 3) / 4, 1u) * 16;
+
+            default: return width * GetFormatSizeInBytes(format);
+        }
+    }
+
+    uint32_t GetFormatRowCount(GraphicsFormat format, uint32_t height)
+    {
+        return IsBlockCompressedFormat(format) ? std::max((height + 3) / 4, 1u) : height;
+    }
+
 } // namespace benzin
@@ -33,4 +33,10 @@ namespace benzin
 
     uint32_t GetFormatSizeInBytes(GraphicsFormat format);
 
+    bool IsBlockCompressedFormat(GraphicsFormat format);
+
+    // Block compressed formats are stored by rows of 4x4 texel blocks
+    uint32_t GetFormatRowPitch(GraphicsFormat format, uint32_t width);
+    uint32_t GetFormatRowCount(GraphicsFormat format, uint32_t height);
+
 } // namespace benzin
@@ -160,15 +160,13 @@ namespace benzin
 
     TopLevelAccelerationStructure::TopLevelAccelerationStructure(Device& device, const TopLevelAccelerationStructureCreation& creation)
         : RtAccelerationStructure{ device }
-        , m_D3D12InstanceDescs{ std::from_range, creation.Instances | std::views::transform(ToD3D12RaytracingInstanceDesc) }
         , m_InstanceBuffer{ device }
     {
         m_InstanceBuffer.Create(BufferCreation
         {
             .ElementSize = sizeof(D3D12_RAYTRACING_INSTANCE_DESC),
-            .ElementCount = (uint32_t)m_D3D12InstanceDescs.size(),
+            .ElementCount = (uint32_t)creation.Instances.size(),
             .Flags = BufferFlag::UploadBuffer, // #TODO: Remove UploadBuffer
-            .InitialData = std::as_bytes(std::span{ m_D3D12InstanceDescs }),
         });
 
         if (!creation.DebugName.empty())
@@ -180,7 +178,7 @@ namespace benzin
         {
             .Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL,
             .Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD,
-            .NumDescs = (uint32_t)m_D3D12InstanceDescs.size(),
+            .NumDescs = (uint32_t)creation.Instances.size(),
             .DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY,
             .InstanceDescs = m_InstanceBuffer.GetGpuVirtualAddress(),
         };
@@ -190,6 +188,18 @@ namespace benzin
             .DebugName = creation.DebugName,
             .D3D12BuildInputs = d3d12BuildInputs,
         });
+
+        UpdateInstances(creation.Instances);
+    }
+
+    void TopLevelAccelerationStructure::UpdateInstances(std::span<const TopLevelInstance> instances)
+    {
+        BenzinAssert(instances.size() <= GetInstanceCapacity());
+
+        auto* d3d12InstanceDescs = reinterpret_cast<D3D12_RAYTRACING_INSTANCE_DESC*>(m_InstanceBuffer.GetMappedData());
+        std::ranges::transform(instances, d3d12InstanceDescs, ToD3D12RaytracingInstanceDesc);
+
+        m_D3D12BuildInputs.NumDescs = (uint32_t)instances.size();
     }
 
 } // namespace benzin
@@ -88,8 +88,13 @@ namespace benzin
     public:
         TopLevelAccelerationStructure(Device& device, const TopLevelAccelerationStructureCreation& creation);
 
+    public:
+        uint32_t GetInstanceCapacity() const { return m_InstanceBuffer.GetElementCount(); }
+
+        // Rewrites instances of the next build. Buffers are sized for the creation instance count, so it's the maximum
+        void UpdateInstances(std::span<const TopLevelInstance> instances);
+
     private:
-        std::vector<D3D12_RAYTRACING_INSTANCE_DESC> m_D3D12InstanceDescs;
         Buffer m_InstanceBuffer;
     };
 
@@ -130,6 +130,9 @@ namespace benzin
         m_Device.m_CpuFrameIndex = cpuFrameIndex;
         m_Device.m_GpuFrameIndex = gpuFrameIndex;
         m_Device.m_ActiveFrameIndex = m_DxgiSwapChain->GetCurrentBackBufferIndex();
+
+        // The frame that used the arena of the active frame before is finished after the wait above
+        FrameArena::BeginFrame(m_Device.m_ActiveFrameIndex);
     }
 
     void SwapChain::RequestResize(uint32_t width, uint32_t height)
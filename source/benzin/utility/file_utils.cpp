@@ -48,19 +48,62 @@ namespace benzin
 
     std::vector<std::byte> ReadFromFile(const fs::path& filePath)
     {
-        std::ifstream file{ filePath.c_str(), std::ios::binary | std::ios::ate };
-        BenzinAssert(file.good());
+        const MappedFile mappedFile{ filePath };
+        BenzinAssert(mappedFile.IsValid());
 
-        const auto fileSize = file.tellg();
-        file.seekg(0, std::ios::beg);
+        const auto data = mappedFile.GetData();
+        return { data.begin(), data.end() };
+    }
 
-        std::vector<std::byte> data;
-        data.resize(fileSize);
+    MappedFile::MappedFile(const fs::path& filePath)
+    {
+        m_FileHandle = ::CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_FileHandle == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
 
-        file.read(reinterpret_cast<char*>(data.data()), fileSize);
-        file.close();
+        LARGE_INTEGER fileSize;
+        if (!::GetFileSizeEx(m_FileHandle, &fileSize))
+        {
+            return;
+        }
+
+        m_SizeInBytes = (size_t)fileSize.QuadPart;
+
+        // 'CreateFileMapping' fails for empty files, but an empty view is still a valid one
+        if (m_SizeInBytes == 0)
+        {
+            m_IsValid = true;
+            return;
+        }
 
-        return data;
+        m_FileMappingHandle = ::CreateFileMappingW(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_FileMappingHandle)
+        {
+            return;
+        }
+
+        m_Data = reinterpret_cast<const std::byte*>(::MapViewOfFile(m_FileMappingHandle, FILE_MAP_READ, 0, 0, 0));
+        m_IsValid = m_Data != nullptr;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_Data)
+        {
+            ::UnmapViewOfFile(m_Data);
+        }
+
+        if (m_FileMappingHandle)
+        {
+            ::CloseHandle(m_FileMappingHandle);
+        }
+
+        if (m_FileHandle != INVALID_HANDLE_VALUE)
+        {
+            ::CloseHandle(m_FileHandle);
+        }
     }
 
     void ClearDirectory(const fs::path& directoryPath)
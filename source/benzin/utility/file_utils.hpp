@@ -13,6 +13,30 @@ namespace benzin
 
     std::vector<std::byte> ReadFromFile(const std::filesystem::path& filePath);
 
+    // Read-only view of a whole file. The data is paged in by the OS on access, nothing is copied
+    class MappedFile
+    {
+    public:
+        BenzinDefineNonCopyable(MappedFile);
+        BenzinDefineNonMoveable(MappedFile);
+
+    public:
+        explicit MappedFile(const std::filesystem::path& filePath);
+        ~MappedFile();
+
+    public:
+        bool IsValid() const { return m_IsValid; }
+        std::span<const std::byte> GetData() const { return { m_Data, m_SizeInBytes }; }
+
+    private:
+        HANDLE m_FileHandle = INVALID_HANDLE_VALUE;
+        HANDLE m_FileMappingHandle = nullptr;
+
+        bool m_IsValid = false;
+        const std::byte* m_Data = nullptr;
+        size_t m_SizeInBytes = 0;
+    };
+
     void ClearDirectory(const std::filesystem::path& directoryPath);
 
     bool IsDestinationFileOlder(const std::filesystem::path& sourceFilePath, const std::filesystem::path& destinationFilePath);
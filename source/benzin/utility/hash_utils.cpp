@@ -0,0 +1,112 @@
+#include "benzin/config/bootstrap.hpp"
+#include "benzin/utility/hash_utils.hpp"
+
+namespace benzin
+{
+
+    // Ref: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+    static constexpr uint64_t g_Prime0 = 0x9e37'79b1'85eb'ca87;
+    static constexpr uint64_t g_Prime1 = 0xc2b2'ae3d'27d4'eb4f;
+    static constexpr uint64_t g_Prime2 = 0x1656'67b1'9e37'79f9;
+    static constexpr uint64_t g_Prime3 = 0x85eb'ca77'c2b2'ae63;
+    static constexpr uint64_t g_Prime4 = 0x27d4'eb2f'1656'67c5;
+
+    template <typename T>
+    static T ReadUnaligned(const std::byte* data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(T));
+
+        return value;
+    }
+
+    static uint64_t Round(uint64_t accumulator, uint64_t lane)
+    {
+        accumulator += lane * g_Prime1;
+        accumulator = std::rotl(accumulator, 31);
+        accumulator *= g_Prime0;
+
+        return accumulator;
+    }
+
+    static uint64_t MergeAccumulator(uint64_t hash, uint64_t accumulator)
+    {
+        hash ^= Round(0, accumulator);
+        hash = hash * g_Prime0 + g_Prime3;
+
+        return hash;
+    }
+
+    //
+
+    uint64_t HashBytes(std::span<const std::byte> data, uint64_t seed)
+    {
+        const std::byte* current = data.data();
+        const std::byte* const end = current + data.size();
+
+        uint64_t hash = 0;
+
+        if (data.size() >= 32)
+        {
+            // Four independent lanes so the multiplications can be pipelined
+            uint64_t accumulator0 = seed + g_Prime0 + g_Prime1;
+            uint64_t accumulator1 = seed + g_Prime1;
+            uint64_t accumulator2 = seed;
+            uint64_t accumulator3 = seed - g_Prime0;
+
+            const std::byte* const stripeEnd = end - 32;
+            while (current <= stripeEnd)
+            {
+                accumulator0 = Round(accumulator0, ReadUnaligned<uint64_t>(current + 0));
+                accumulator1 = Round(accumulator1, ReadUnaligned<uint64_t>(current + 8));
+                accumulator2 = Round(accumulator2, ReadUnaligned<uint64_t>(current + 16));
+                accumulator3 = Round(accumulator3, ReadUnaligned<uint64_t>(current + 24));
+
+                current += 32;
+            }
+
+            hash = std::rotl(accumulator0, 1) + std::rotl(accumulator1, 7) + std::rotl(accumulator2, 12) + std::rotl(accumulator3, 18);
+            hash = MergeAccumulator(hash, accumulator0);
+            hash = MergeAccumulator(hash, accumulator1);
+            hash = MergeAccumulator(hash, accumulator2);
+            hash = MergeAccumulator(hash, accumulator3);
+        }
+        else
+        {
+            hash = seed + g_Prime4;
+        }
+
+        hash += data.size();
+
+        for (; current + 8 <= end; current += 8)
+        {
+            hash ^= Round(0, ReadUnaligned<uint64_t>(current));
+            hash = std::rotl(hash, 27) * g_Prime0 + g_Prime3;
+        }
+
+        if (current + 4 <= end)
+        {
+            hash ^= ReadUnaligned<uint32_t>(current) * g_Prime0;
+            hash = std::rotl(hash, 23) * g_Prime1 + g_Prime2;
+
+            current += 4;
+        }
+
+        for (; current < end; ++current)
+        {
+            hash ^= (uint64_t)*current * g_Prime4;
+            hash = std::rotl(hash, 11) * g_Prime0;
+        }
+
+        // Avalanche
+        hash ^= hash >> 33;
+        hash *= g_Prime1;
+        hash ^= hash >> 29;
+        hash *= g_Prime2;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+} // namespace benzin
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace benzin
+{
+
+    // XXH64 compatible hash. Fast enough to hash whole images and vertex buffers
+    uint64_t HashBytes(std::span<const std::byte> data, uint64_t seed = 0);
+
+    template <typename T> requires std::is_trivially_copyable_v<T>
+    uint64_t HashSpan(std::span<const T> data, uint64_t seed = 0)
+    {
+        return HashBytes(std::as_bytes(data), seed);
+    }
+
+} // namespace benzin
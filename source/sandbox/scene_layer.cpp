@@ -3,12 +3,18 @@
 
 #include <benzin/core/math.hpp>
 #include <benzin/core/logger.hpp>
+#include <benzin/engine/asset_loader.hpp>
 #include <benzin/engine/entity_components.hpp>
+#include <benzin/engine/environment_baker.hpp>
 #include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/mesh_simplifier.hpp>
+#include <benzin/engine/occlusion_culling.hpp>
 #include <benzin/engine/resource_loader.hpp>
 #include <benzin/engine/scene.hpp>
+#include <benzin/graphics/buffer.hpp>
 #include <benzin/graphics/command_list.hpp>
 #include <benzin/graphics/command_queue.hpp>
+#include <benzin/graphics/command_signature.hpp>
 #include <benzin/graphics/device.hpp>
 #include <benzin/graphics/gpu_timer.hpp>
 #include <benzin/graphics/pipeline_state.hpp>
@@ -31,6 +37,7 @@ namespace sandbox
     {
         _BuildTopLevelAs,
         _GeometryPass,
+        _OcclusionCulling,
         _RtShadowPass,
         _RtShadowDenoisingPass,
         _DeferredLightingPass,
@@ -116,20 +123,33 @@ namespace sandbox
         };
     }
 
-    static bool IsMeshCulled(const benzin::Camera& camera, const benzin::MeshCollection& meshCollection, uint32_t meshInstanceIndex, const DirectX::XMMATRIX& worldMatrix)
+    static uint32_t SelectMeshLod(const benzin::Camera& camera, const benzin::MeshCollection& meshCollection, uint32_t meshInstanceIndex, const DirectX::XMMATRIX& worldMatrix, float viewportHeight)
     {
         const auto& meshInstance = meshCollection.MeshInstances[meshInstanceIndex];
         const auto& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
 
-        if (!mesh.BoundingBox)
+        if (mesh.Lods.empty() || !mesh.BoundingBox)
         {
-            return false;
+            return 0;
         }
 
-        const auto localToViewSpaceTransformMatrix = meshInstance.Transform * worldMatrix * camera.GetViewMatrix();
-        const auto viewSpaceMeshBoundingBox = benzin::TransformBoundingBox(*mesh.BoundingBox, localToViewSpaceTransformMatrix);
+        const auto localToWorldTransformMatrix = meshInstance.Transform * worldMatrix;
+        const auto viewSpaceMeshBoundingBox = benzin::TransformBoundingBox(*mesh.BoundingBox, localToWorldTransformMatrix * camera.GetViewMatrix());
 
-        return camera.GetProjection().GetBoundingFrustum().Contains(viewSpaceMeshBoundingBox) == DirectX::DISJOINT;
+        const float centerDistance = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&viewSpaceMeshBoundingBox.Center)));
+        const float boundsRadius = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&viewSpaceMeshBoundingBox.Extents)));
+        const float distance = std::max(centerDistance - boundsRadius, 0.0f);
+
+        float meshScale = 0.0f;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            meshScale = std::max(meshScale, DirectX::XMVectorGetX(DirectX::XMVector3Length(localToWorldTransformMatrix.r[i])));
+        }
+
+        // Projection matrix [1][1] is 'cot(fovY / 2)', so it maps one unit at distance one to the half of the viewport
+        const float pixelsPerUnit = 0.5f * viewportHeight * DirectX::XMVectorGetY(camera.GetProjectionMatrix().r[1]);
+
+        return benzin::SelectMeshLod(mesh, distance, meshScale, pixelsPerUnit);
     }
 
     struct GBufferConfig
@@ -162,6 +182,7 @@ namespace sandbox
         float SunIntensity = 0.0f;
         DirectX::XMFLOAT3 SunColor{ 1.0f, 1.0f, 1.0f };
         DirectX::XMFLOAT3 SunDirection{ -0.5f, -0.5f, -0.5f };
+        float AmbientIntensity = 1.0f;
     };
 
     struct FullScreenDebugParams
@@ -169,15 +190,23 @@ namespace sandbox
         joint::DebugOutputType OutputType = joint::DebugOutputType_None;
     };
 
+    struct OcclusionCullingParams
+    {
+        bool IsEnabled = true;
+    };
+
     static constexpr GBufferConfig g_GBufferConfig;
     static constexpr RtShadowConfig g_RtShadowConfig;
 
     static RtShadowParams g_RtShadowParams;
     static DeferredLightingParams g_DeferredLightingParams;
     static FullScreenDebugParams g_FullScreenDebugParams;
+    static OcclusionCullingParams g_OcclusionCullingParams;
 
     static magic_enum::containers::array<CpuTiming, std::chrono::microseconds> g_CpuTimings;
 
+    static const benzin::MeshCollectionLoadingFlags g_MeshCollectionLoadingFlags = benzin::MeshCollectionLoadingFlag::ParallelMeshParsing | benzin::MeshCollectionLoadingFlag::UseBakedCache | benzin::MeshCollectionLoadingFlag::DeferImageDecoding | benzin::MeshCollectionLoadingFlag::WeldVertices | benzin::MeshCollectionLoadingFlag::GenerateTangents | benzin::MeshCollectionLoadingFlag::OptimizeMeshes | benzin::MeshCollectionLoadingFlag::GenerateLods | benzin::MeshCollectionLoadingFlag::PackVertices | benzin::MeshCollectionLoadingFlag::GenerateTextureMips | benzin::MeshCollectionLoadingFlag::CompressTextures;
+
     // GeometryPass
 
     GeometryPass::GeometryPass(benzin::Device& device, benzin::SwapChain& swapChain)
@@ -206,6 +235,14 @@ namespace sandbox
             .DepthStencilFormat = g_GBufferConfig.DepthStencilFormat,
         });
 
+        benzin::MakeUniquePtr(m_CommandSignature, m_Device, benzin::CommandSignatureCreation
+        {
+            .DebugName = "GeometryPass",
+            .RootConstantRange = benzin::g_DrawPacketRootConstantRange,
+        });
+
+        m_DrawPacketBuffers.resize(benzin::CommandLineArgs::GetFrameInFlightCount());
+
         OnResize(m_SwapChain.GetViewportWidth(), m_SwapChain.GetViewportHeight());
     }
 
@@ -259,38 +296,19 @@ namespace sandbox
 
         commandList.SetPipelineState(*m_Pso);
 
-        const auto view = scene.GetEntityRegistry().view<benzin::TransformComponent, benzin::MeshInstanceComponent>();
-        for (const auto entityHandle : view)
-        {
-            const auto& tc = view.get<benzin::TransformComponent>(entityHandle);
-            const auto& mic = view.get<benzin::MeshInstanceComponent>(entityHandle);
-
-            const auto& meshCollection = scene.GetMeshCollection(mic.MeshUnionIndex);
-            const auto& meshCollectionGpuStorage = scene.GetMeshCollectionGpuStorage(mic.MeshUnionIndex);
-
-            commandList.SetRootResource(joint::GeometryPassRc_MeshVertexBuffer, meshCollectionGpuStorage.VertexBuffer->GetStructuredSrv());
-            commandList.SetRootResource(joint::GeometryPassRc_MeshIndexBuffer, meshCollectionGpuStorage.IndexBuffer->GetStructuredSrv());
-            commandList.SetRootResource(joint::GeometryPassRc_MeshInfoBuffer, meshCollectionGpuStorage.MeshInfoBuffer->GetStructuredSrv());
-            commandList.SetRootResource(joint::GeometryPassRc_MeshInstanceBuffer, meshCollectionGpuStorage.MeshInstanceBuffer->GetStructuredSrv());
-            commandList.SetRootResource(joint::GeometryPassRc_MaterialBuffer, meshCollectionGpuStorage.MaterialBuffer->GetStructuredSrv());
-            commandList.SetRootResource(joint::GeometryPassRc_MeshTransformConstantBuffer, tc.GetActiveTransformCbv());
-
-            const auto meshInstanceRange = mic.MeshInstanceRange.value_or(meshCollection.GetFullMeshInstanceRange());
-            for (const auto i : benzin::IndexRangeToView(meshInstanceRange))
-            {
-                if (IsMeshCulled(scene.GetCamera(), meshCollection, i, tc.GetWorldMatrix()))
-                {
-                    continue;
-                }
+        BuildDrawPackets(scene);
 
-                commandList.SetRootConstant(joint::GeometryPassRc_MeshInstanceIndex, i);
+        if (m_DrawPacketList.DrawPackets.empty())
+        {
+            return;
+        }
 
-                const auto& meshInstance = meshCollection.MeshInstances[i];
-                const auto& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
+        const benzin::Buffer& drawPacketBuffer = UploadDrawPackets();
 
-                commandList.SetPrimitiveTopology(mesh.PrimitiveTopology);
-                commandList.DrawVertexed((uint32_t)mesh.Indices.size());
-            }
+        for (const auto& group : m_DrawPacketList.Groups)
+        {
+            commandList.SetPrimitiveTopology(group.PrimitiveTopology);
+            commandList.ExecuteIndirect(*m_CommandSignature, drawPacketBuffer, group.DrawPacketRange);
         }
     }
 
@@ -333,6 +351,144 @@ namespace sandbox
         });
     }
 
+    void GeometryPass::BuildDrawPackets(const benzin::Scene& scene) const
+    {
+        m_DrawPacketEntities.clear();
+        m_VisibleMeshInstances.clear();
+
+        const auto& entityRegistry = scene.GetEntityRegistry();
+
+        const auto view = entityRegistry.view<benzin::TransformComponent, benzin::MeshInstanceComponent>();
+        for (const auto entityHandle : view)
+        {
+            const auto& tc = view.get<benzin::TransformComponent>(entityHandle);
+            const auto& mic = view.get<benzin::MeshInstanceComponent>(entityHandle);
+
+            const auto& meshCollection = scene.GetMeshCollection(mic.MeshUnionIndex);
+            const auto& meshCollectionGpuStorage = scene.GetMeshCollectionGpuStorage(mic.MeshUnionIndex);
+
+            const auto entityIndex = (uint32_t)m_DrawPacketEntities.size();
+            m_DrawPacketEntities.push_back(benzin::DrawPacketEntity
+            {
+                .MeshCollection = &meshCollection,
+                .Constants
+                {
+                    meshCollectionGpuStorage.VertexBuffer->GetStructuredSrv().GetHeapIndex(),
+                    meshCollectionGpuStorage.PackedVertexBuffer ? meshCollectionGpuStorage.PackedVertexBuffer->GetStructuredSrv().GetHeapIndex() : benzin::g_InvalidIndex<uint32_t>,
+                    meshCollectionGpuStorage.IndexBuffer->GetStructuredSrv().GetHeapIndex(),
+                    meshCollectionGpuStorage.MeshInfoBuffer->GetStructuredSrv().GetHeapIndex(),
+                    meshCollectionGpuStorage.MeshInstanceBuffer->GetStructuredSrv().GetHeapIndex(),
+                    meshCollectionGpuStorage.MaterialBuffer->GetStructuredSrv().GetHeapIndex(),
+                    tc.GetActiveTransformCbv().GetHeapIndex(),
+                },
+            });
+
+            const auto entityId = (uint32_t)entt::to_entity(entityHandle);
+            if (entityId >= m_DrawPacketEntityIndices.size())
+            {
+                m_DrawPacketEntityIndices.resize(entityId + 1, benzin::g_InvalidIndex<uint32_t>);
+            }
+
+            m_DrawPacketEntityIndices[entityId] = entityIndex;
+        }
+
+        m_OccluderCandidates.clear();
+        m_VisibleMeshInstanceProxyIds.clear();
+
+        // Proxies of the scene exist only for entities of the view above
+        m_CullingStats = scene.ForEachVisibleMeshInstance([&](const benzin::SceneMeshInstance& sceneMeshInstance)
+        {
+            const uint32_t entityIndex = m_DrawPacketEntityIndices[(uint32_t)entt::to_entity(sceneMeshInstance.EntityHandle)];
+            const auto& meshCollection = *m_DrawPacketEntities[entityIndex].MeshCollection;
+            const auto& tc = entityRegistry.get<benzin::TransformComponent>(sceneMeshInstance.EntityHandle);
+
+            m_VisibleMeshInstances.push_back(benzin::VisibleMeshInstance
+            {
+                .EntityIndex = entityIndex,
+                .MeshInstanceIndex = sceneMeshInstance.MeshInstanceIndex,
+                .LodIndex = SelectMeshLod(scene.GetCamera(), meshCollection, sceneMeshInstance.MeshInstanceIndex, tc.GetWorldMatrix(), (float)m_GBuffer.DepthStencil->GetHeight()),
+            });
+            m_VisibleMeshInstanceProxyIds.push_back(sceneMeshInstance.ProxyId);
+
+            if (!benzin::IsValidIndex(sceneMeshInstance.ProxyId))
+            {
+                return;
+            }
+
+            const auto& meshInstance = meshCollection.MeshInstances[sceneMeshInstance.MeshInstanceIndex];
+            const auto& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
+
+            // Alpha tested surfaces have holes. The full detail level is used, coarser levels may stick out of the surface
+            if (mesh.PrimitiveTopology != benzin::PrimitiveTopology::TriangleList || meshCollection.Materials[meshInstance.MaterialIndex].AlphaCutoff != 0.0f)
+            {
+                return;
+            }
+
+            m_OccluderCandidates.push_back(benzin::Occluder
+            {
+                .Vertices = mesh.GetVertices(),
+                .Indices = mesh.GetIndices(),
+                .WorldMatrix = meshInstance.Transform * tc.GetWorldMatrix(),
+                .WorldAabb = scene.GetMeshInstanceWorldAabb(sceneMeshInstance.ProxyId),
+            });
+        });
+
+        CullOccludedMeshInstances(scene);
+
+        benzin::BuildDrawPackets(m_DrawPacketEntities, m_VisibleMeshInstances, m_DrawPacketList);
+    }
+
+    void GeometryPass::CullOccludedMeshInstances(const benzin::Scene& scene) const
+    {
+        BenzinGrabTimeOnScopeExit(g_CpuTimings[CpuTiming::_OcclusionCulling]);
+
+        m_OccludedMeshInstanceCount = 0;
+
+        if (!g_OcclusionCullingParams.IsEnabled)
+        {
+            return;
+        }
+
+        m_OcclusionCuller.Render(scene.GetCamera().GetViewProjectionMatrix(), m_OccluderCandidates);
+
+        uint32_t visibleMeshInstanceCount = 0;
+        for (const auto& [visibleMeshInstance, proxyId] : std::views::zip(m_VisibleMeshInstances, m_VisibleMeshInstanceProxyIds))
+        {
+            if (benzin::IsValidIndex(proxyId) && m_OcclusionCuller.IsOccluded(scene.GetMeshInstanceWorldAabb(proxyId)))
+            {
+                continue;
+            }
+
+            m_VisibleMeshInstances[visibleMeshInstanceCount++] = visibleMeshInstance;
+        }
+
+        m_OccludedMeshInstanceCount = (uint32_t)m_VisibleMeshInstances.size() - visibleMeshInstanceCount;
+        m_VisibleMeshInstances.resize(visibleMeshInstanceCount);
+    }
+
+    const benzin::Buffer& GeometryPass::UploadDrawPackets() const
+    {
+        const auto drawPacketCount = (uint32_t)m_DrawPacketList.DrawPackets.size();
+
+        // Buffer of the active frame isn't used by the GPU anymore, so it can be recreated
+        auto& drawPacketBuffer = m_DrawPacketBuffers[m_Device.GetActiveFrameIndex()];
+        if (!drawPacketBuffer || drawPacketBuffer->GetElementCount() < drawPacketCount)
+        {
+            benzin::MakeUniquePtr(drawPacketBuffer, m_Device, benzin::BufferCreation
+            {
+                .DebugName = "GeometryPassDrawPacketBuffer",
+                .ElementSize = sizeof(benzin::DrawPacket),
+                .ElementCount = std::bit_ceil(drawPacketCount),
+                .Flags = benzin::BufferFlag::UploadBuffer,
+            });
+        }
+
+        const benzin::MemoryWriter writer{ drawPacketBuffer->GetMappedData(), drawPacketBuffer->GetSizeInBytes() };
+        writer.WriteBytes(std::as_bytes(std::span{ m_DrawPacketList.DrawPackets }));
+
+        return *drawPacketBuffer;
+    }
+
     // RtShadowPass
 
     RtShadowPass::RtShadowPass(benzin::Device& device, benzin::SwapChain& swapChain)
@@ -680,15 +836,19 @@ namespace sandbox
         OnResize(m_SwapChain.GetViewportWidth(), m_SwapChain.GetViewportHeight());
     }
 
-    void DeferredLightingPass::OnUpdate(const benzin::Scene& scene)
+    void DeferredLightingPass::OnUpdate(const benzin::Scene& scene, const benzin::SphericalHarmonicsL2& ambientSh)
     {
-        m_PassConstantBuffer->UpdateConstants(joint::DeferredLightingPassConstants
+        joint::DeferredLightingPassConstants constants
         {
             .SunColor = g_DeferredLightingParams.SunColor,
             .SunIntensity = g_DeferredLightingParams.SunIntensity,
             .SunDirection = g_DeferredLightingParams.SunDirection,
             .ActivePointLightCount = scene.GetStats().PointLightCount,
-        });
+        };
+
+        std::ranges::copy(benzin::GetShDiffuseCoefficients(ambientSh, g_DeferredLightingParams.AmbientIntensity), constants.AmbientShCoefficients);
+
+        m_PassConstantBuffer->UpdateConstants(constants);
     }
 
     void DeferredLightingPass::OnRender(const benzin::Scene& scene, const GeometryPass::GBuffer& gbuffer, benzin::Texture& shadowVisiblityBuffer) const
@@ -759,66 +919,27 @@ namespace sandbox
         });
 
         {
-            // Load environment texture
+            benzin::TextureImage cubeMapImage;
+            BenzinAssert(benzin::LoadEnvironmentCubeMapFromHdrFile("scythian_tombs_2_4k.hdr", cubeMapImage));
 
-            benzin::TextureImage equirectangularTextureImage;
-            BenzinAssert(benzin::LoadTextureImageFromHdrFile("scythian_tombs_2_4k.hdr", equirectangularTextureImage));
+            m_AmbientSh = benzin::ProjectCubeMapToSh(cubeMapImage);
 
-            const auto equirectangularTexture = std::make_unique<benzin::Texture>(m_Device, benzin::TextureCreation
-            {
-                .DebugName = equirectangularTextureImage.DebugName,
-                .Format = equirectangularTextureImage.Format,
-                .Width = equirectangularTextureImage.Width,
-                .Height = equirectangularTextureImage.Height,
-                .MipCount = 1,
-            });
-
-            {
-                auto& copyCommandQueue = m_Device.GetCopyCommandQueue();
-                BenzinFlushCommandQueueOnScopeExit(copyCommandQueue);
-
-                auto& commandList = copyCommandQueue.GetCommandList(equirectangularTexture->GetSizeInBytes());
-                commandList.UpdateTextureTopMip(*equirectangularTexture, std::as_bytes(std::span{ equirectangularTextureImage.ImageData }));
-            }
-
-            // Convert equirectangular to cube map texture
-
-            const auto equirectangularToCubePipelineState = std::make_unique<benzin::PipelineState>(m_Device, benzin::ComputePipelineStateCreation
-            {
-                .DebugName = "EquirectangularToCube",
-                .ComputeShader{ "equirectangular_to_cube.hlsl", "CS_Main" },
-            });
-
-            const uint32_t cubeMapSize = 1024;
             benzin::MakeUniquePtr(m_CubeTexture, m_Device, benzin::TextureCreation
             {
-                .DebugName = equirectangularTextureImage.DebugName,
+                .DebugName = cubeMapImage.DebugName,
                 .IsCubeMap = true,
-                .Format = benzin::GraphicsFormat::Rgba32Float,
-                .Width = cubeMapSize,
-                .Height = cubeMapSize,
+                .Format = cubeMapImage.Format,
+                .Width = cubeMapImage.Width,
+                .Height = cubeMapImage.Height,
                 .Depth = 6,
-                .MipCount = 1,
-                .Flags = benzin::TextureFlag::AllowUnorderedAccess,
+                .MipCount = (uint16_t)cubeMapImage.MipCount,
             });
 
-            {
-                auto& computeCommandQueue = m_Device.GetComputeCommandQueue();
-                BenzinFlushCommandQueueOnScopeExit(computeCommandQueue);
-
-                auto& commandList = computeCommandQueue.GetCommandList();
-
-                commandList.SetPipelineState(*equirectangularToCubePipelineState);
-
-                commandList.SetRootResource(joint::EquirectangularToCubePassRc_EquirectangularTexture, equirectangularTexture->GetSrv());
-                commandList.SetRootResource(joint::EquirectangularToCubePassRc_OutCubeTexture, m_CubeTexture->GetUav());
-
-                commandList.SetResourceBarrier(benzin::TransitionBarrier{ *m_CubeTexture, benzin::ResourceState::UnorderedAccess });
-
-                commandList.Dispatch({ cubeMapSize, cubeMapSize, m_CubeTexture->GetDepth() }, { 8, 8, 1 });
+            auto& copyCommandQueue = m_Device.GetCopyCommandQueue();
+            BenzinFlushCommandQueueOnScopeExit(copyCommandQueue);
 
-                commandList.SetResourceBarrier(benzin::TransitionBarrier{ *m_CubeTexture, benzin::ResourceState::Common });
-            }
+            auto& commandList = copyCommandQueue.GetCommandList(m_CubeTexture->GetSizeInBytes());
+            commandList.UpdateTextureMips(*m_CubeTexture, cubeMapImage.ImageData);
         }
     }
 
@@ -999,7 +1120,7 @@ namespace sandbox
         m_GeometryPass.OnUpdate();
         m_RtShadowPass.OnUpdate(dt, elapsedTime);
         m_RtShadowDenoisingPass.OnUpdate();
-        m_DeferredLightingPass.OnUpdate(m_Scene);
+        m_DeferredLightingPass.OnUpdate(m_Scene, m_EnvironmentPass.GetAmbientSh());
         m_FullScreenDebugPass.OnUpdate();
     }
 
@@ -1141,6 +1262,17 @@ namespace sandbox
                     DirectX::XMStoreFloat3(&g_DeferredLightingParams.SunDirection, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&g_DeferredLightingParams.SunDirection)));
                 }
 
+                ImGui::DragFloat("AmbientIntensity", &g_DeferredLightingParams.AmbientIntensity, 0.01f, 0.0f, 10.0f);
+
+                ImGui::Separator();
+                ImGui::NewLine();
+            }
+
+            {
+                ImGui::TextColored(titleColor, "OcclusionCullingParams");
+
+                ImGui::Checkbox("IsOcclusionCullingEnabled", &g_OcclusionCullingParams.IsEnabled);
+
                 ImGui::Separator();
                 ImGui::NewLine();
             }
@@ -1187,9 +1319,22 @@ namespace sandbox
             BenzinExecuteOnScopeExit([]{ std::locale::global(std::locale::classic()); });
 
             const auto& sceneStats = m_Scene.GetStats();
-            ImGui::Text(BenzinFormatCstr("VertexCount: {:L}", sceneStats.VertexCount));
-            ImGui::Text(BenzinFormatCstr("TriangleCount: {:L}", sceneStats.TriangleCount));
-            ImGui::Text(BenzinFormatCstr("PointLightCount: {:L}", sceneStats.PointLightCount));
+            ImGui::Text(BenzinFrameFormatCstr("VertexCount: {:L}", sceneStats.VertexCount));
+            ImGui::Text(BenzinFrameFormatCstr("TriangleCount: {:L}", sceneStats.TriangleCount));
+            ImGui::Text(BenzinFrameFormatCstr("TextureCount: {:L} ({:L} deduplicated, {:.3f}Mb saved)", sceneStats.TextureCount, sceneStats.DeduplicatedTextureCount, benzin::BytesToFloatMb(sceneStats.DeduplicatedTextureSizeInBytes)));
+            ImGui::Text(BenzinFrameFormatCstr("PointLightCount: {:L}", sceneStats.PointLightCount));
+
+            const auto& transformHierarchyStats = m_Scene.GetTransformHierarchyStats();
+            ImGui::Text(BenzinFrameFormatCstr("TransformNodeCount: {:L} ({:L} depths, {:L} updated)", transformHierarchyStats.NodeCount, transformHierarchyStats.DepthCount, transformHierarchyStats.UpdatedNodeCount));
+
+            const auto meshInstanceTreeStats = m_Scene.GetMeshInstanceTreeStats();
+            const auto& cullingStats = m_GeometryPass.GetCullingStats();
+            ImGui::Text(BenzinFrameFormatCstr("MeshInstanceProxyCount: {:L} (height {}), Visible: {:L} ({:L} nodes tested)", meshInstanceTreeStats.ProxyCount, meshInstanceTreeStats.Height, cullingStats.VisibleProxyCount, cullingStats.TestedNodeCount));
+
+            const auto& occlusionCullingStats = m_GeometryPass.GetOcclusionCullingStats();
+            ImGui::Text(BenzinFrameFormatCstr("Occluders: {:L} ({:L} triangles, {:L} rasterized), Occluded: {:L}", occlusionCullingStats.OccluderCount, occlusionCullingStats.OccluderTriangleCount, occlusionCullingStats.RasterizedTriangleCount, m_GeometryPass.GetOccludedMeshInstanceCount()));
+
+            ImGui::Text(BenzinFrameFormatCstr("GeometryPassDrawCount: {:L} ({:L} ExecuteIndirect)", m_GeometryPass.GetDrawCount(), m_GeometryPass.GetExecuteIndirectCount()));
         }
         ImGui::End();
 
@@ -1204,7 +1349,7 @@ namespace sandbox
 
             for (const auto [i, timing] : cpuTimings | std::views::enumerate)
             {
-                ImGui::Text(BenzinFormatCstr("{}: {:.4f} ms", magic_enum::enum_name((CpuTiming)i).substr(1), benzin::ToFloatMs(timing)));
+                ImGui::Text(BenzinFrameFormatCstr("{}: {:.4f} ms", magic_enum::enum_name((CpuTiming)i).substr(1), benzin::ToFloatMs(timing)));
             }
         }
         ImGui::End();
@@ -1223,86 +1368,63 @@ namespace sandbox
 
             for (const auto [i, timing] : gpuTimings | std::views::enumerate)
             {
-                ImGui::Text(BenzinFormatCstr("{}: {:.4f} ms", magic_enum::enum_name((GpuTiming)i).substr(1), benzin::ToFloatMs(timing)));
+                ImGui::Text(BenzinFrameFormatCstr("{}: {:.4f} ms", magic_enum::enum_name((GpuTiming)i).substr(1), benzin::ToFloatMs(timing)));
             }
         }
         ImGui::End();
     }
 
-// #TODO: Application is hang when using std::async
+// #TODO: Application is hang when loading on worker threads
 #define SANDBOX_IS_PIX_WORKAROUND_ENABLED 0
 
     void SceneLayer::CreateEntities()
     {
         auto& entityRegistry = m_Scene.GetEntityRegistry();
 
-        benzin::MeshCollectionResource sponzaMeshCollection;
 #if !SANDBOX_IS_PIX_WORKAROUND_ENABLED
-        const auto sponzaFuture = std::async(std::launch::async, [&]
-        {
-            const std::string_view fileName = "Sponza/glTF/Sponza.gltf";
-
-            BenzinLogTimeOnScopeExit("Loading MeshCollection from {}", fileName);
-            BenzinAssert(LoadMeshCollectionFromGltfFile(fileName, sponzaMeshCollection));
-        });
+        benzin::MakeUniquePtr(m_AssetLoader, 4);
 #else
-        {
-            const std::string_view fileName = "Sponza/glTF/Sponza.gltf";
-
-            BenzinLogTimeOnScopeExit("Loading MeshCollection from {}", fileName);
-            BenzinAssert(LoadMeshCollectionFromGltfFile(fileName, sponzaMeshCollection));
-        }
+        benzin::MakeUniquePtr(m_AssetLoader, 0);
 #endif
 
-        benzin::MeshCollectionResource boomBooxMeshCollection;
-        {
-            const std::string_view fileName = "BoomBox/glTF/BoomBox.gltf";
+        const auto sponzaHandle = m_AssetLoader->RequestMeshCollection("Sponza/glTF/Sponza.gltf", g_MeshCollectionLoadingFlags);
+        const auto boomBoxHandle = m_AssetLoader->RequestMeshCollection("BoomBox/glTF/BoomBox.gltf", g_MeshCollectionLoadingFlags);
+        const auto damagedHelmetHandle = m_AssetLoader->RequestMeshCollection("DamagedHelmet/glTF/DamagedHelmet.gltf", g_MeshCollectionLoadingFlags);
 
-            BenzinLogTimeOnScopeExit("Loading MeshCollection from {}", fileName);
-            BenzinAssert(LoadMeshCollectionFromGltfFile(fileName, boomBooxMeshCollection));
-        }
+        // Procedural collections are pushed while glTF files are loading
+        const uint32_t cylinderMeshUnionIndex = m_Scene.PushMeshCollection(CreateCylinderMeshCollection());
+        const uint32_t sphereLightMeshUnionIndex = m_Scene.PushMeshCollection(CreateSphereLightMeshCollection());
 
-        benzin::MeshCollectionResource damagedHelmetMeshCollection;
+        std::unordered_map<const benzin::MeshCollectionLoadingTask*, uint32_t> meshUnionIndices;
         {
-            const std::string_view fileName = "DamagedHelmet/glTF/DamagedHelmet.gltf";
+            BenzinLogTimeOnScopeExit("Waiting for MeshCollections");
 
-            BenzinLogTimeOnScopeExit("Loading MeshCollection from {}", fileName);
-            BenzinAssert(LoadMeshCollectionFromGltfFile(fileName, damagedHelmetMeshCollection));
+            // Push collections as they finish, so pushing overlaps loading of the rest
+            while (const auto handle = m_AssetLoader->WaitForNextFinished())
+            {
+                BenzinEnsure(handle->GetStatus() == benzin::AssetLoadingStatus::Succeeded);
+                meshUnionIndices[handle.get()] = m_Scene.PushMeshCollection(handle->TakeMeshCollection());
+            }
         }
 
-        benzin::MeshCollectionResource cylinderMeshCollection = CreateCylinderMeshCollection();
-        benzin::MeshCollectionResource sphereLightMeshCollection = CreateSphereLightMeshCollection();
-
-#if !SANDBOX_IS_PIX_WORKAROUND_ENABLED
-        sponzaFuture.wait();
-#endif
-
-        const uint32_t sponzaMeshUnionIndex = m_Scene.PushMeshCollection(std::move(sponzaMeshCollection));
-        const uint32_t boomBooxMeshUnionIndex = m_Scene.PushMeshCollection(std::move(boomBooxMeshCollection));
-        const uint32_t damagedHelmetMeshUnionIndex = m_Scene.PushMeshCollection(std::move(damagedHelmetMeshCollection));
-        const uint32_t cylinderMeshUnionIndex = m_Scene.PushMeshCollection(std::move(cylinderMeshCollection));
-        const uint32_t sphereLightMeshUnionIndex = m_Scene.PushMeshCollection(std::move(sphereLightMeshCollection));
+        const uint32_t sponzaMeshUnionIndex = meshUnionIndices.at(sponzaHandle.get());
+        const uint32_t boomBooxMeshUnionIndex = meshUnionIndices.at(boomBoxHandle.get());
+        const uint32_t damagedHelmetMeshUnionIndex = meshUnionIndices.at(damagedHelmetHandle.get());
 
         // Sponza
         {
-            const auto entity = entityRegistry.create();
-
-            auto& mic = entityRegistry.emplace<benzin::MeshInstanceComponent>(entity);
-            mic.MeshUnionIndex = sponzaMeshUnionIndex;
+            const auto entity = m_Scene.SpawnMeshCollection(sponzaMeshUnionIndex);
 
-            auto& tc = entityRegistry.emplace<benzin::TransformComponent>(entity);
+            auto& tc = entityRegistry.get<benzin::TransformComponent>(entity);
             tc.SetRotation({ 0.0f, DirectX::XM_PI, 0.0f });
             tc.SetTranslation({ 5.0f, 0.0f, 0.0f });
         }
 
         // BoomBox
         {
-            const auto entity = entityRegistry.create();
+            const auto entity = m_Scene.SpawnMeshCollection(boomBooxMeshUnionIndex);
 
-            auto& mic = entityRegistry.emplace<benzin::MeshInstanceComponent>(entity);
-            mic.MeshUnionIndex = boomBooxMeshUnionIndex;
-
-            auto& tc = entityRegistry.emplace<benzin::TransformComponent>(entity);
+            auto& tc = entityRegistry.get<benzin::TransformComponent>(entity);
             tc.SetRotation({ 0.0f, DirectX::XMConvertToRadians(-135.0f), 0.0f });
             tc.SetScale({ 30.0f, 30.0f, 30.0f });
             tc.SetTranslation({ 0.0f, 0.6f, 0.0f });
@@ -1327,12 +1449,9 @@ namespace sandbox
 
         // DamagedHelmet
         {
-            const auto entity = entityRegistry.create();
-
-            auto& mic = entityRegistry.emplace<benzin::MeshInstanceComponent>(entity);
-            mic.MeshUnionIndex = damagedHelmetMeshUnionIndex;
+            const auto entity = m_Scene.SpawnMeshCollection(damagedHelmetMeshUnionIndex);
 
-            auto& tc = entityRegistry.emplace<benzin::TransformComponent>(entity);
+            auto& tc = entityRegistry.get<benzin::TransformComponent>(entity);
             tc.SetRotation({ 0.0f, DirectX::XMConvertToRadians(-135.0f), 0.0f });
             tc.SetScale({ 0.4f, 0.4f, 0.4f });
             tc.SetTranslation({ 1.0f, 0.5f, -0.5f });
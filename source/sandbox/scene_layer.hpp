@@ -1,14 +1,19 @@
 #pragma once
 
 #include <benzin/core/layer.hpp>
+#include <benzin/engine/draw_packet_builder.hpp>
+#include <benzin/engine/occlusion_culling.hpp>
 #include <benzin/engine/scene.hpp>
+#include <benzin/engine/spherical_harmonics.hpp>
 
 #include <shaders/joint/enum_types.hpp>
 
 namespace benzin
 {
     
+    class AssetLoader;
     class Buffer;
+    class CommandSignature;
     class Device;
     class GpuTimer;
     class PipelineState;
@@ -80,6 +85,11 @@ namespace sandbox
 
     public:
         auto& GetGBuffer() { return m_GBuffer; }
+        auto GetDrawCount() const { return (uint32_t)m_DrawPacketList.DrawPackets.size(); }
+        auto GetExecuteIndirectCount() const { return (uint32_t)m_DrawPacketList.Groups.size(); }
+        const auto& GetCullingStats() const { return m_CullingStats; }
+        const auto& GetOcclusionCullingStats() const { return m_OcclusionCuller.GetStats(); }
+        auto GetOccludedMeshInstanceCount() const { return m_OccludedMeshInstanceCount; }
 
     public:
         void OnUpdate();
@@ -87,12 +97,31 @@ namespace sandbox
 
         void OnResize(uint32_t width, uint32_t height);
 
+    private:
+        void BuildDrawPackets(const benzin::Scene& scene) const;
+        void CullOccludedMeshInstances(const benzin::Scene& scene) const;
+        const benzin::Buffer& UploadDrawPackets() const;
+
     private:
         benzin::Device& m_Device;
         benzin::SwapChain& m_SwapChain;
 
         std::unique_ptr<benzin::PipelineState> m_Pso;
+        std::unique_ptr<benzin::CommandSignature> m_CommandSignature;
         GBuffer m_GBuffer;
+
+        // Of the last 'OnRender'
+        mutable std::vector<benzin::DrawPacketEntity> m_DrawPacketEntities;
+        mutable std::vector<benzin::VisibleMeshInstance> m_VisibleMeshInstances;
+        mutable std::vector<uint32_t> m_DrawPacketEntityIndices; // By entity id, valid only for entities of the last 'OnRender'
+        mutable benzin::AabbTreeQueryStats m_CullingStats;
+        mutable std::vector<benzin::AabbTreeProxyId> m_VisibleMeshInstanceProxyIds; // By 'm_VisibleMeshInstances' before occlusion culling
+        mutable std::vector<benzin::Occluder> m_OccluderCandidates;
+        mutable benzin::OcclusionCuller m_OcclusionCuller;
+        mutable uint32_t m_OccludedMeshInstanceCount = 0;
+        mutable benzin::DrawPacketList m_DrawPacketList;
+
+        mutable std::vector<std::unique_ptr<benzin::Buffer>> m_DrawPacketBuffers; // Per frame in flight, grow on demand
     };
 
     class RtShadowPass
@@ -165,7 +194,7 @@ namespace sandbox
         auto& GetOutputTexture() { return *m_OutputTexture; }
 
     public:
-        void OnUpdate(const benzin::Scene& scene);
+        void OnUpdate(const benzin::Scene& scene, const benzin::SphericalHarmonicsL2& ambientSh);
         void OnRender(const benzin::Scene& scene, const GeometryPass::GBuffer& gbuffer, benzin::Texture& shadowVisiblityBuffer) const;
 
         void OnResize(uint32_t width, uint32_t height);
@@ -186,6 +215,9 @@ namespace sandbox
     public:
         EnvironmentPass(benzin::Device& device, benzin::SwapChain& swapChain);
 
+    public:
+        const auto& GetAmbientSh() const { return m_AmbientSh; }
+
     public:
         void OnRender(const benzin::Scene& scene, benzin::Texture& deferredLightingOutputTexture, benzin::Texture& gbufferDepthStecil) const;
 
@@ -195,6 +227,7 @@ namespace sandbox
 
         std::unique_ptr<benzin::PipelineState> m_Pso;
         std::unique_ptr<benzin::Texture> m_CubeTexture;
+        benzin::SphericalHarmonicsL2 m_AmbientSh;
     };
 
     class FullScreenDebugPass
@@ -242,6 +275,7 @@ namespace sandbox
 
         std::unique_ptr<benzin::GpuTimer> m_GpuTimer;
         std::unique_ptr<FrameConstantBuffer> m_FrameConstantBuffer;
+        std::unique_ptr<benzin::AssetLoader> m_AssetLoader;
 
         GeometryPass m_GeometryPass;
         RtShadowPass m_RtShadowPass;
@@ -43,6 +43,21 @@ float3 GetLitColorForPointLight(joint::PointLight pointLight, PbrMaterial materi
     return attenuation * pbr;
 }
 
+float3 EvaluateAmbientSh(float4 coefficients[9], float3 n)
+{
+    float3 result = coefficients[0].rgb;
+    result += coefficients[1].rgb * n.y;
+    result += coefficients[2].rgb * n.z;
+    result += coefficients[3].rgb * n.x;
+    result += coefficients[4].rgb * n.x * n.y;
+    result += coefficients[5].rgb * n.y * n.z;
+    result += coefficients[6].rgb * (3.0f * n.z * n.z - 1.0f);
+    result += coefficients[7].rgb * n.x * n.z;
+    result += coefficients[8].rgb * (n.x * n.x - n.y * n.y);
+
+    return max(result, 0.0f);
+}
+
 UnpackedGBuffer FetchGBuffer(float2 uv)
 {
     Texture2D<float4> albedoAndRoughnessTexture = ResourceDescriptorHeap[GetRootConstant(joint::DeferredLightingPassRc_AlbedoAndRoughnessTexture)];
@@ -88,7 +103,7 @@ float4 PS_Main(VS_FullScreenTriangleOutput input) : SV_Target
     material.Metallic = gbuffer.Metallic;
     material.F0 = GetF0(gbuffer.Albedo.rgb, gbuffer.Metallic);
 
-    const float3 ambientColor = 0.3f * gbuffer.Albedo.rgb;
+    const float3 ambientColor = EvaluateAmbientSh(passConstants.AmbientShCoefficients, gbuffer.WorldNormal) * gbuffer.Albedo.rgb;
 
     float3 directColor = 0.0f;
 
@@ -9,7 +9,7 @@ float4 PS_Main(VS_FullScreenTriangleOutput input) : SV_Target
     const float4 worldPosition = mul(input.ClipPosition, cameraConstants.InverseViewDirectionProjection);
     const float3 direction = normalize(worldPosition.xyz);
 
-    const float4 color = cubeMap.Sample(g_LinearWrapSampler, direction);
+    const float4 color = cubeMap.SampleLevel(g_LinearWrapSampler, direction, 0.0f); // Lower mips are prefiltered for rough reflections
 
     return LinearToGamma(color);
 }
@@ -1,6 +1,8 @@
 #include "common.hlsli"
 #include "gbuffer.hlsli"
 
+#include "joint/vertex_packing.hpp"
+
 float3 ClipPositionToNdcPosition(float4 clipPosition)
 {
     return clipPosition.xyz / clipPosition.w;
@@ -40,20 +42,14 @@ float3x3 CotangentFrame(float3 N, float3 p, float2 uv)
     return float3x3(T * invmax, B * invmax, N);
 }
 
-float3x3 GetTBNBasis(float3 position, float3 normal, float2 uv)
+// Vertex tangents are MikkTSpace ones, so the basis matches the one normal maps are baked with
+float3x3 GetTBNBasis(float3 normal, float4 tangent)
 {
-    float3 dp1 = ddx(position);
-    float3 dp2 = ddy(position);
-    float2 duv1 = ddx(uv);
-    float2 duv2 = ddy(uv);
-
-    float det = duv1.x * duv2.y - duv2.x * duv1.y;
-    float invdet = 1.0 / det;
+    // Interpolated vectors are not orthonormal anymore
+    const float3 T = normalize(tangent.xyz - normal * dot(normal, tangent.xyz));
+    const float3 B = cross(normal, T) * tangent.w;
 
-    float3 tangent = normalize((dp1 * duv2.y - dp2 * duv1.y) * invdet);
-    float3 bitangent = normalize((-dp1 * duv2.x + dp2 * duv1.x) * invdet);
-
-    return float3x3(tangent, bitangent, normal);
+    return float3x3(T, B, normal);
 }
 
 joint::MeshInstance FetchMeshInstance()
@@ -66,16 +62,23 @@ joint::MeshInstance FetchMeshInstance()
 
 joint::MeshVertex FetchVertex(uint indexIndex, uint meshIndex)
 {
-    StructuredBuffer<joint::MeshVertex> vertexBuffer = ResourceDescriptorHeap[GetRootConstant(joint::GeometryPassRc_MeshVertexBuffer)];
     Buffer<uint> indexBuffer = ResourceDescriptorHeap[GetRootConstant(joint::GeometryPassRc_MeshIndexBuffer)];
     StructuredBuffer<joint::MeshInfo> meshInfoBuffer = ResourceDescriptorHeap[GetRootConstant(joint::GeometryPassRc_MeshInfoBuffer)];
 
     const joint::MeshInfo meshInfo = meshInfoBuffer[meshIndex];
+    const uint lodIndexOffset = GetRootConstant(joint::GeometryPassRc_MeshLodIndexOffset);
 
-    const uint vertexIndex = indexBuffer[meshInfo.IndexOffset + indexIndex];
-    const joint::MeshVertex vertex = vertexBuffer[meshInfo.VertexOffset + vertexIndex];
+    const uint vertexIndex = indexBuffer[meshInfo.IndexOffset + lodIndexOffset + indexIndex];
+
+    const uint packedVertexBufferIndex = GetRootConstant(joint::GeometryPassRc_MeshPackedVertexBuffer);
+    if (packedVertexBufferIndex != g_InvalidIndex)
+    {
+        StructuredBuffer<joint::PackedMeshVertex> packedVertexBuffer = ResourceDescriptorHeap[packedVertexBufferIndex];
+        return joint::UnpackMeshVertex(packedVertexBuffer[meshInfo.VertexOffset + vertexIndex], meshInfo.BoundingBoxCenter, meshInfo.BoundingBoxExtents);
+    }
 
-    return vertex;
+    StructuredBuffer<joint::MeshVertex> vertexBuffer = ResourceDescriptorHeap[GetRootConstant(joint::GeometryPassRc_MeshVertexBuffer)];
+    return vertexBuffer[meshInfo.VertexOffset + vertexIndex];
 }
 
 joint::MeshTransform FetchMeshTransform()
@@ -98,6 +101,7 @@ struct VS_Output
     float3 WorldPosition : WorldPosition;
     float ViewDepth : ViewDepth;
     float3 WorldNormal : WorldNormal;
+    float4 WorldTangent : WorldTangent; // Zero if the mesh has no tangents
     float2 Uv : Uv;
 };
 
@@ -111,10 +115,15 @@ VS_Output VS_Main(uint indexIndex : SV_VertexID)
     
     const float4 objectPosition = mul(float4(vertex.Position, 1.0f), meshInstance.Transform);
     const float3 objectNormal = mul(vertex.Normal, (float3x3)meshInstance.Transform);
+    const float3 objectTangent = mul(vertex.Tangent.xyz, (float3x3)meshInstance.Transform);
 
     const float4 worldPosition = mul(objectPosition, transform.WorldMatrix);
     const float4 previousWorldPosition = mul(objectPosition, transform.PreviousWorldMatrix);
     const float3 worldNormal = mul(objectNormal, (float3x3)transform.WorldMatrixForNormals);
+    const float3 worldTangent = mul(objectTangent, (float3x3)transform.WorldMatrix);
+
+    // Mirroring transforms flip 'cross(Normal, Tangent)', so the bitangent sign is flipped too
+    const float handedness = determinant((float3x3)meshInstance.Transform) * determinant((float3x3)transform.WorldMatrix) < 0.0f ? -1.0f : 1.0f;
 
     const float4 viewPosition = mul(worldPosition, cameraConstants.CurrentFrame.View);
 
@@ -125,6 +134,7 @@ VS_Output VS_Main(uint indexIndex : SV_VertexID)
     output.WorldPosition = worldPosition.xyz;
     output.ViewDepth = viewPosition.z;
     output.WorldNormal = worldNormal;
+    output.WorldTangent = float4(worldTangent, vertex.Tangent.w * handedness);
     output.Uv = vertex.Uv;
 
     return output;
@@ -175,10 +185,17 @@ PS_Output PS_Main(VS_Output input)
         normalSample = normalize(normalSample * float3(material.NormalScale, material.NormalScale, 1.0));
         normalSample = ExpandNormal(normalSample.xy);
 
-        const float3 worldViewDirection = normalize(cameraConstants.WorldPosition - input.WorldPosition);
-
-        const float3x3 tbn = CotangentFrame(gbuffer.WorldNormal, -worldViewDirection, input.Uv);
-        //const float3x3 tbn = GetTBNBasis(worldPosition, input.WorldNormal, input.TexCoord);
+        float3x3 tbn;
+        if (input.WorldTangent.w != 0.0f)
+        {
+            tbn = GetTBNBasis(gbuffer.WorldNormal, input.WorldTangent);
+        }
+        else
+        {
+            // Fallback for meshes without tangents, the basis is rebuilt from screen space derivatives
+            const float3 worldViewDirection = normalize(cameraConstants.WorldPosition - input.WorldPosition);
+            tbn = CotangentFrame(gbuffer.WorldNormal, -worldViewDirection, input.Uv);
+        }
 
         gbuffer.WorldNormal = normalize(mul(normalSample, tbn));
     }
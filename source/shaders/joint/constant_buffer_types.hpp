@@ -51,6 +51,8 @@ namespace joint
         float3 SunDirection;
         uint ActivePointLightCount;
         uint OutputType;
+        float3 __UnusedPadding0;
+        float4 AmbientShCoefficients[9]; // Diffuse SH of the environment, see 'GetShDiffuseCoefficients'
     };
 
     struct FullScreenDebugConstants
@@ -13,12 +13,14 @@ namespace joint
     enum GeometryPassRc : uint32_t
     {
         GeometryPassRc_MeshVertexBuffer = GlobalRc_Count,
+        GeometryPassRc_MeshPackedVertexBuffer,
         GeometryPassRc_MeshIndexBuffer,
         GeometryPassRc_MeshInfoBuffer,
         GeometryPassRc_MeshInstanceBuffer,
         GeometryPassRc_MaterialBuffer,
         GeometryPassRc_MeshTransformConstantBuffer,
         GeometryPassRc_MeshInstanceIndex,
+        GeometryPassRc_MeshLodIndexOffset,
         GeometryPassRc_Count,
     };
 
@@ -78,11 +80,4 @@ namespace joint
         FullScreenDebugRc_Count,
     };
 
-    enum EquirectangularToCubePassRc : uint32_t
-    {
-        EquirectangularToCubePassRc_EquirectangularTexture = GlobalRc_Count,
-        EquirectangularToCubePassRc_OutCubeTexture,
-        EquirectangularToCubePassRc_Count,
-    };
-
 } // namespace joint
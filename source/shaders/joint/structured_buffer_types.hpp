@@ -12,12 +12,46 @@ namespace joint
         float3 Position;
         float3 Normal;
         float2 Uv;
+        float4 Tangent; // Bitangent is 'cross(Normal, Tangent.xyz) * Tangent.w'. Zero if the mesh has no tangents
+    };
+
+    // 16 bytes instead of 48, see 'vertex_packing.hpp'
+    struct PackedMeshVertex
+    {
+        uint PositionXY; // Two unorm16, relative to the mesh bounding box
+        uint PositionZAndTangent; // Unorm16, then the tangent angle around the normal as unorm14 and the bitangent sign in 2 bits: 1 is positive, 2 is negative, 0 if there is no tangent
+        uint Normal; // Octahedral normal as two snorm16
+        uint Uv; // Two halfs
     };
 
     struct MeshInfo
     {
         uint VertexOffset;
         uint IndexOffset;
+
+        // Mesh bounds, which packed vertex positions are relative to
+        float3 BoundingBoxCenter;
+        float3 BoundingBoxExtents;
+    };
+
+    // Cluster of a mesh, triangles are 'TriangleCount' packed uints starting from 'TriangleOffset'
+    // Each packed triangle stores three 8-bit meshlet local vertex indices, which are mapped to mesh vertices through 'VertexOffset'
+    struct Meshlet
+    {
+        uint VertexOffset;
+        uint VertexCount;
+        uint TriangleOffset;
+        uint TriangleCount;
+
+        // Bounding sphere in mesh local space
+        float3 BoundingSphereCenter;
+        float BoundingSphereRadius;
+
+        // Backface culling: the meshlet is invisible if dot(normalize(ConeApex - CameraPosition), ConeAxis) >= ConeCutoff
+        float3 ConeApex;
+        float ConeCutoff;
+        float3 ConeAxis;
+        float __UnusedPadding0;
     };
 
     struct MeshInstance
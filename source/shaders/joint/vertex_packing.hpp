@@ -0,0 +1,183 @@
+#pragma once
+
+#include "structured_buffer_types.hpp"
+
+namespace joint
+{
+
+#ifdef __cplusplus
+
+    // HLSL intrinsics, which are used by the shared code below
+    inline float abs(float value) { return std::abs(value); }
+    inline float round(float value) { return std::round(value); }
+    inline float sqrt(float value) { return std::sqrt(value); }
+    inline float sin(float value) { return std::sin(value); }
+    inline float cos(float value) { return std::cos(value); }
+    inline float atan2(float y, float x) { return std::atan2(y, x); }
+    inline float saturate(float value) { return std::clamp(value, 0.0f, 1.0f); }
+    inline uint f32tof16(float value) { return DirectX::PackedVector::XMConvertFloatToHalf(value); }
+    inline float f16tof32(uint value) { return DirectX::PackedVector::XMConvertHalfToFloat((DirectX::PackedVector::HALF)(value & 0xffff)); }
+
+#endif
+
+    inline uint PackUnorm16(float value)
+    {
+        return (uint)round(saturate(value) * 65535.0f);
+    }
+
+    inline float UnpackUnorm16(uint value)
+    {
+        return (float)(value & 0xffff) / 65535.0f;
+    }
+
+    inline uint PackSnorm16(float value)
+    {
+        return PackUnorm16(value * 0.5f + 0.5f);
+    }
+
+    inline float UnpackSnorm16(uint value)
+    {
+        return UnpackUnorm16(value) * 2.0f - 1.0f;
+    }
+
+    inline float SignNotZero(float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // Ref: Cigolle et al., A Survey of Efficient Representations for Independent Unit Vectors: https://jcgt.org/published/0003/02/01/
+    inline float2 EncodeOctahedralNormal(float3 normal)
+    {
+        const float l1Norm = abs(normal.x) + abs(normal.y) + abs(normal.z);
+        if (l1Norm <= 0.0f)
+        {
+            return float2(0.0f, 0.0f);
+        }
+
+        float2 result = float2(normal.x / l1Norm, normal.y / l1Norm);
+
+        if (normal.z < 0.0f)
+        {
+            const float x = (1.0f - abs(result.y)) * SignNotZero(result.x);
+            const float y = (1.0f - abs(result.x)) * SignNotZero(result.y);
+
+            result = float2(x, y);
+        }
+
+        return result;
+    }
+
+    inline float3 DecodeOctahedralNormal(float2 encoded)
+    {
+        float3 normal = float3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+
+        const float t = saturate(-normal.z);
+        normal.x += normal.x >= 0.0f ? -t : t;
+        normal.y += normal.y >= 0.0f ? -t : t;
+
+        const float invLength = 1.0f / sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+
+        return float3(normal.x * invLength, normal.y * invLength, normal.z * invLength);
+    }
+
+    // Ref: Duff et al., Building an Orthonormal Basis, Revisited: https://jcgt.org/published/0006/01/01/
+    inline float3 GetOrthonormalBasisX(float3 normal)
+    {
+        const float zSign = SignNotZero(normal.z);
+        const float a = -1.0f / (zSign + normal.z);
+
+        return float3(1.0f + zSign * normal.x * normal.x * a, zSign * normal.x * normal.y * a, -zSign * normal.x);
+    }
+
+    inline float3 GetOrthonormalBasisY(float3 normal)
+    {
+        const float zSign = SignNotZero(normal.z);
+        const float a = -1.0f / (zSign + normal.z);
+
+        return float3(normal.x * normal.y * a, zSign + normal.y * normal.y * a, -normal.y);
+    }
+
+    static const float g_TwoPi = 6.28318530718f;
+
+    // Tangent is orthogonal to the normal, so it's stored as an angle in the basis built from the decoded normal
+    inline uint PackTangentAngle(float3 tangent, float3 decodedNormal)
+    {
+        const float3 basisX = GetOrthonormalBasisX(decodedNormal);
+        const float3 basisY = GetOrthonormalBasisY(decodedNormal);
+
+        const float x = tangent.x * basisX.x + tangent.y * basisX.y + tangent.z * basisX.z;
+        const float y = tangent.x * basisY.x + tangent.y * basisY.y + tangent.z * basisY.z;
+
+        return (uint)round(saturate(atan2(y, x) / g_TwoPi + 0.5f) * 16383.0f);
+    }
+
+    inline float3 UnpackTangentAngle(uint packedAngle, float3 decodedNormal)
+    {
+        const float3 basisX = GetOrthonormalBasisX(decodedNormal);
+        const float3 basisY = GetOrthonormalBasisY(decodedNormal);
+
+        const float angle = ((float)(packedAngle & 0x3fff) / 16383.0f - 0.5f) * g_TwoPi;
+        const float c = cos(angle);
+        const float s = sin(angle);
+
+        return float3(basisX.x * c + basisY.x * s, basisX.y * c + basisY.y * s, basisX.z * c + basisY.z * s);
+    }
+
+    // Maps position from [center - extents, center + extents] to [0, 1]
+    inline float NormalizePositionComponent(float position, float center, float extents)
+    {
+        return extents > 0.0f ? (position - center) / (2.0f * extents) + 0.5f : 0.5f;
+    }
+
+    inline float DenormalizePositionComponent(float normalized, float center, float extents)
+    {
+        return center + (normalized * 2.0f - 1.0f) * extents;
+    }
+
+    inline PackedMeshVertex PackMeshVertex(MeshVertex vertex, float3 boundingBoxCenter, float3 boundingBoxExtents)
+    {
+        const uint x = PackUnorm16(NormalizePositionComponent(vertex.Position.x, boundingBoxCenter.x, boundingBoxExtents.x));
+        const uint y = PackUnorm16(NormalizePositionComponent(vertex.Position.y, boundingBoxCenter.y, boundingBoxExtents.y));
+        const uint z = PackUnorm16(NormalizePositionComponent(vertex.Position.z, boundingBoxCenter.z, boundingBoxExtents.z));
+
+        const float2 octahedralNormal = EncodeOctahedralNormal(vertex.Normal);
+        const uint normal = PackSnorm16(octahedralNormal.x) | PackSnorm16(octahedralNormal.y) << 16;
+
+        // The unpacker only sees the decoded normal, so the tangent angle is measured against it
+        const float3 decodedNormal = DecodeOctahedralNormal(float2(UnpackSnorm16(normal), UnpackSnorm16(normal >> 16)));
+
+        const uint tangentSign = vertex.Tangent.w > 0.0f ? 1 : (vertex.Tangent.w < 0.0f ? 2 : 0);
+        const uint tangent = tangentSign != 0 ? PackTangentAngle(float3(vertex.Tangent.x, vertex.Tangent.y, vertex.Tangent.z), decodedNormal) | tangentSign << 14 : 0;
+
+        PackedMeshVertex packedVertex;
+        packedVertex.PositionXY = x | y << 16;
+        packedVertex.PositionZAndTangent = z | tangent << 16;
+        packedVertex.Normal = normal;
+        packedVertex.Uv = f32tof16(vertex.Uv.x) | f32tof16(vertex.Uv.y) << 16;
+
+        return packedVertex;
+    }
+
+    inline MeshVertex UnpackMeshVertex(PackedMeshVertex packedVertex, float3 boundingBoxCenter, float3 boundingBoxExtents)
+    {
+        MeshVertex vertex;
+
+        vertex.Position = float3(
+            DenormalizePositionComponent(UnpackUnorm16(packedVertex.PositionXY), boundingBoxCenter.x, boundingBoxExtents.x),
+            DenormalizePositionComponent(UnpackUnorm16(packedVertex.PositionXY >> 16), boundingBoxCenter.y, boundingBoxExtents.y),
+            DenormalizePositionComponent(UnpackUnorm16(packedVertex.PositionZAndTangent), boundingBoxCenter.z, boundingBoxExtents.z)
+        );
+
+        vertex.Normal = DecodeOctahedralNormal(float2(UnpackSnorm16(packedVertex.Normal), UnpackSnorm16(packedVertex.Normal >> 16)));
+
+        vertex.Uv = float2(f16tof32(packedVertex.Uv), f16tof32(packedVertex.Uv >> 16));
+
+        const uint tangent = packedVertex.PositionZAndTangent >> 16;
+        const uint tangentSign = tangent >> 14;
+        const float3 tangentDirection = UnpackTangentAngle(tangent, vertex.Normal);
+        vertex.Tangent = tangentSign != 0 ? float4(tangentDirection.x, tangentDirection.y, tangentDirection.z, tangentSign == 1 ? 1.0f : -1.0f) : float4(0.0f, 0.0f, 0.0f, 0.0f);
+
+        return vertex;
+    }
+
+} // namespace joint
@@ -0,0 +1,137 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/asset_loader.hpp>
+#include <benzin/utility/file_utils.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        class TemporaryGltfFiles
+        {
+        public:
+            explicit TemporaryGltfFiles(std::string_view directoryName)
+                : m_DirectoryPath{ std::filesystem::temp_directory_path() / std::format("benzin_tests_{}", directoryName) }
+            {
+                std::filesystem::create_directories(m_DirectoryPath);
+            }
+
+            ~TemporaryGltfFiles()
+            {
+                std::filesystem::remove_all(m_DirectoryPath);
+            }
+
+        public:
+            std::string WriteValid(std::string_view fileName)
+            {
+                return Write(fileName, R"({ "asset": { "version": "2.0" }, "scene": 0, "scenes": [ { "nodes": [ 0 ] } ], "nodes": [ { "name": "Root" } ] })");
+            }
+
+            std::string WriteCorrupted(std::string_view fileName)
+            {
+                return Write(fileName, R"({ "asset": { "version": )");
+            }
+
+        private:
+            std::string Write(std::string_view fileName, std::string_view text)
+            {
+                const std::filesystem::path filePath = m_DirectoryPath / fileName;
+                benzin::WriteToFile(filePath, std::as_bytes(std::span{ text }));
+
+                return filePath.string();
+            }
+
+        private:
+            std::filesystem::path m_DirectoryPath;
+        };
+
+    } // anonymous namespace
+
+    BenzinTest(AssetLoaderReturnsEveryRequestOnce)
+    {
+        TemporaryGltfFiles files{ "asset_loader_requests" };
+
+        std::vector<std::string> filePaths;
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            filePaths.push_back(files.WriteValid(std::format("model_{}.gltf", i)));
+        }
+
+        // Requested last, so a worker doesn't load anything after the failure
+        filePaths.push_back(files.WriteCorrupted("corrupted.gltf"));
+
+        benzin::AssetLoader assetLoader{ 2 };
+
+        std::vector<benzin::MeshCollectionLoadingHandle> handles;
+        for (const std::string& filePath : filePaths)
+        {
+            handles.push_back(assetLoader.RequestMeshCollection(filePath));
+        }
+
+        std::vector<benzin::MeshCollectionLoadingHandle> finishedHandles;
+        while (auto handle = assetLoader.WaitForNextFinished())
+        {
+            BenzinCheck(handle->IsFinished());
+            finishedHandles.push_back(std::move(handle));
+        }
+
+        BenzinCheck(!assetLoader.WaitForNextFinished());
+        BenzinCheck(finishedHandles.size() == handles.size());
+
+        std::ranges::sort(handles);
+        std::ranges::sort(finishedHandles);
+        BenzinCheck(finishedHandles == handles);
+
+        for (const benzin::MeshCollectionLoadingHandle& handle : handles)
+        {
+            const bool isCorrupted = handle->GetFileName() == filePaths.back();
+            BenzinCheck(handle->GetStatus() == (isCorrupted ? benzin::AssetLoadingStatus::Failed : benzin::AssetLoadingStatus::Succeeded));
+
+            if (!isCorrupted)
+            {
+                BenzinCheck(handle->TakeMeshCollection().DebugName.starts_with("model_"));
+            }
+        }
+
+        const benzin::AssetLoadingProgress progress = assetLoader.GetProgress();
+        BenzinCheck(progress.RequestedCount == filePaths.size());
+        BenzinCheck(progress.FinishedCount == filePaths.size());
+        BenzinCheck(progress.FailedCount == 1);
+    }
+
+    BenzinTest(AssetLoaderWithoutWorkersLoadsOnRequestingThread)
+    {
+        TemporaryGltfFiles files{ "asset_loader_synchronous" };
+
+        benzin::AssetLoader assetLoader{ 0 };
+
+        const auto handle = assetLoader.RequestMeshCollection(files.WriteValid("model.gltf"));
+        BenzinCheck(handle->GetStatus() == benzin::AssetLoadingStatus::Succeeded);
+        BenzinCheck(assetLoader.GetProgress().FinishedCount == 1);
+
+        BenzinCheck(assetLoader.WaitForNextFinished() == handle);
+        BenzinCheck(!assetLoader.WaitForNextFinished());
+    }
+
+    BenzinTest(AssetLoaderFinishesQueuedRequestsOnDestruction)
+    {
+        TemporaryGltfFiles files{ "asset_loader_destruction" };
+
+        std::vector<benzin::MeshCollectionLoadingHandle> handles;
+        {
+            benzin::AssetLoader assetLoader{ 1 };
+
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                handles.push_back(assetLoader.RequestMeshCollection(files.WriteValid(std::format("model_{}.gltf", i))));
+            }
+        }
+
+        BenzinCheck(std::ranges::all_of(handles, [](const auto& handle) { return handle->GetStatus() == benzin::AssetLoadingStatus::Succeeded; }));
+    }
+
+} // namespace tests
@@ -0,0 +1 @@
+#include "bootstrap.hpp"
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <benzin/config/bootstrap.hpp>
+
+#include "test_runner.hpp"
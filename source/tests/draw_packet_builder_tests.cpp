@@ -0,0 +1,171 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/draw_packet_builder.hpp>
+#include <benzin/engine/resource_loader.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        constexpr uint32_t g_MeshInstanceIndexSlot = joint::GeometryPassRc_MeshInstanceIndex - benzin::g_DrawPacketRootConstantRange.StartIndex;
+        constexpr uint32_t g_MeshLodIndexOffsetSlot = joint::GeometryPassRc_MeshLodIndexOffset - benzin::g_DrawPacketRootConstantRange.StartIndex;
+
+        benzin::MeshData CreateMesh(benzin::PrimitiveTopology primitiveTopology, uint32_t indexCount, std::initializer_list<uint32_t> lodIndexCounts = {})
+        {
+            benzin::MeshData mesh
+            {
+                .Indices = std::vector<uint32_t>(indexCount, 0),
+                .PrimitiveTopology = primitiveTopology,
+            };
+
+            for (const uint32_t lodIndexCount : lodIndexCounts)
+            {
+                mesh.Lods.push_back(benzin::MeshLod{ .Indices = std::vector<uint32_t>(lodIndexCount, 0) });
+            }
+
+            return mesh;
+        }
+
+        // Instances 0 and 2 are triangle meshes with two levels of detail, the instance 1 is a line mesh
+        benzin::MeshCollectionResource CreateMeshCollection()
+        {
+            benzin::MeshCollectionResource meshCollection;
+            meshCollection.Meshes.push_back(CreateMesh(benzin::PrimitiveTopology::TriangleList, 36, { 12 }));
+            meshCollection.Meshes.push_back(CreateMesh(benzin::PrimitiveTopology::LineList, 4));
+
+            meshCollection.MeshInstances.push_back(benzin::MeshInstance{ .MeshIndex = 0 });
+            meshCollection.MeshInstances.push_back(benzin::MeshInstance{ .MeshIndex = 1 });
+            meshCollection.MeshInstances.push_back(benzin::MeshInstance{ .MeshIndex = 0 });
+
+            return meshCollection;
+        }
+
+        benzin::DrawPacketEntityConstants CreateEntityConstants(uint32_t firstValue)
+        {
+            benzin::DrawPacketEntityConstants constants;
+            std::iota(constants.begin(), constants.end(), firstValue);
+
+            return constants;
+        }
+
+        bool HasEntityConstants(const benzin::DrawPacket& drawPacket, const benzin::DrawPacketEntity& entity)
+        {
+            return std::ranges::equal(std::span{ drawPacket.RootConstants }.first(entity.Constants.size()), entity.Constants);
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(DrawPacketsAreGroupedByTopologyInVisibleOrder)
+    {
+        const benzin::MeshCollectionResource meshCollection = CreateMeshCollection();
+
+        const std::array entities
+        {
+            benzin::DrawPacketEntity{ .MeshCollection = &meshCollection, .Constants = CreateEntityConstants(10) },
+            benzin::DrawPacketEntity{ .MeshCollection = &meshCollection, .Constants = CreateEntityConstants(20) },
+        };
+
+        const std::array visibleMeshInstances
+        {
+            benzin::VisibleMeshInstance{ .EntityIndex = 0, .MeshInstanceIndex = 0, .LodIndex = 0 },
+            benzin::VisibleMeshInstance{ .EntityIndex = 0, .MeshInstanceIndex = 1, .LodIndex = 0 },
+            benzin::VisibleMeshInstance{ .EntityIndex = 1, .MeshInstanceIndex = 2, .LodIndex = 1 },
+            benzin::VisibleMeshInstance{ .EntityIndex = 0, .MeshInstanceIndex = 2, .LodIndex = 1 },
+            benzin::VisibleMeshInstance{ .EntityIndex = 1, .MeshInstanceIndex = 1, .LodIndex = 0 },
+        };
+
+        benzin::DrawPacketList drawPacketList;
+        benzin::BuildDrawPackets(entities, visibleMeshInstances, drawPacketList);
+
+        BenzinCheck(benzin::ValidateDrawPackets(entities, visibleMeshInstances, drawPacketList));
+
+        // 'D3D_PRIMITIVE_TOPOLOGY_LINELIST' goes before 'D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST'
+        BenzinCheck(drawPacketList.Groups.size() == 2);
+        BenzinCheck(drawPacketList.Groups[0].PrimitiveTopology == benzin::PrimitiveTopology::LineList);
+        BenzinCheck(drawPacketList.Groups[0].DrawPacketRange.StartIndex == 0 && drawPacketList.Groups[0].DrawPacketRange.Count == 2);
+        BenzinCheck(drawPacketList.Groups[1].PrimitiveTopology == benzin::PrimitiveTopology::TriangleList);
+        BenzinCheck(drawPacketList.Groups[1].DrawPacketRange.StartIndex == 2 && drawPacketList.Groups[1].DrawPacketRange.Count == 3);
+
+        // Entity, mesh instance, vertex count and index offset of the level, in the expected order
+        const std::array<std::array<uint32_t, 4>, 5> expectedDrawPackets
+        {{
+            { 0, 1, 4, 0 },
+            { 1, 1, 4, 0 },
+            { 0, 0, 36, 0 },
+            { 1, 2, 12, 36 },
+            { 0, 2, 12, 36 },
+        }};
+
+        BenzinCheck(drawPacketList.DrawPackets.size() == expectedDrawPackets.size());
+
+        for (const auto& [drawPacket, expected] : std::views::zip(drawPacketList.DrawPackets, expectedDrawPackets))
+        {
+            const auto [entityIndex, meshInstanceIndex, vertexCount, lodIndexOffset] = expected;
+
+            BenzinCheck(HasEntityConstants(drawPacket, entities[entityIndex]));
+            BenzinCheck(drawPacket.RootConstants[g_MeshInstanceIndexSlot] == meshInstanceIndex);
+            BenzinCheck(drawPacket.RootConstants[g_MeshLodIndexOffsetSlot] == lodIndexOffset);
+
+            const benzin::DrawArguments expectedArguments{ .VertexCountPerInstance = vertexCount, .InstanceCount = 1 };
+            BenzinCheck(drawPacket.Arguments == expectedArguments);
+        }
+    }
+
+    BenzinTest(DrawPacketListIsReusedBetweenFrames)
+    {
+        const benzin::MeshCollectionResource meshCollection = CreateMeshCollection();
+        const std::array entities{ benzin::DrawPacketEntity{ .MeshCollection = &meshCollection, .Constants = CreateEntityConstants(1) } };
+
+        const std::array firstFrame
+        {
+            benzin::VisibleMeshInstance{ .MeshInstanceIndex = 0 },
+            benzin::VisibleMeshInstance{ .MeshInstanceIndex = 1 },
+            benzin::VisibleMeshInstance{ .MeshInstanceIndex = 2 },
+        };
+        const std::array secondFrame{ benzin::VisibleMeshInstance{ .MeshInstanceIndex = 2, .LodIndex = 1 } };
+
+        benzin::DrawPacketList drawPacketList;
+        benzin::BuildDrawPackets(entities, firstFrame, drawPacketList);
+        benzin::BuildDrawPackets(entities, secondFrame, drawPacketList);
+
+        BenzinCheck(benzin::ValidateDrawPackets(entities, secondFrame, drawPacketList));
+        BenzinCheck(drawPacketList.DrawPackets.size() == 1);
+        BenzinCheck(drawPacketList.Groups.size() == 1);
+
+        benzin::BuildDrawPackets(entities, {}, drawPacketList);
+        BenzinCheck(drawPacketList.DrawPackets.empty());
+        BenzinCheck(drawPacketList.Groups.empty());
+    }
+
+    BenzinTest(ValidateDrawPacketsDetectsMismatches)
+    {
+        const benzin::MeshCollectionResource meshCollection = CreateMeshCollection();
+        const std::array entities{ benzin::DrawPacketEntity{ .MeshCollection = &meshCollection, .Constants = CreateEntityConstants(1) } };
+
+        const std::array visibleMeshInstances
+        {
+            benzin::VisibleMeshInstance{ .MeshInstanceIndex = 0 },
+            benzin::VisibleMeshInstance{ .MeshInstanceIndex = 2, .LodIndex = 1 },
+        };
+
+        benzin::DrawPacketList drawPacketList;
+        benzin::BuildDrawPackets(entities, visibleMeshInstances, drawPacketList);
+
+        benzin::DrawPacketList wrongLod = drawPacketList;
+        wrongLod.DrawPackets[1].RootConstants[g_MeshLodIndexOffsetSlot] = 0;
+        BenzinCheck(!benzin::ValidateDrawPackets(entities, visibleMeshInstances, wrongLod));
+
+        benzin::DrawPacketList wrongArguments = drawPacketList;
+        wrongArguments.DrawPackets[0].Arguments.InstanceCount = 2;
+        BenzinCheck(!benzin::ValidateDrawPackets(entities, visibleMeshInstances, wrongArguments));
+
+        benzin::DrawPacketList wrongGroup = drawPacketList;
+        wrongGroup.Groups[0].DrawPacketRange.Count = 1;
+        BenzinCheck(!benzin::ValidateDrawPackets(entities, visibleMeshInstances, wrongGroup));
+    }
+
+} // namespace tests
@@ -0,0 +1,136 @@
+#include "bootstrap.hpp"
+
+#include <benzin/engine/dynamic_aabb_tree.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        DirectX::BoundingBox GetRandomBox(std::mt19937& randomEngine)
+        {
+            std::uniform_real_distribution<float> center{ -100.0f, 100.0f };
+            std::uniform_real_distribution<float> extent{ 0.05f, 4.0f };
+
+            return DirectX::BoundingBox{ { center(randomEngine), center(randomEngine), center(randomEngine) }, { extent(randomEngine), extent(randomEngine), extent(randomEngine) } };
+        }
+
+        // A perspective camera somewhere around the boxes, looking in a random direction
+        benzin::FrustumPlanes GetRandomFrustumPlanes(std::mt19937& randomEngine)
+        {
+            std::uniform_real_distribution<float> position{ -120.0f, 120.0f };
+            std::uniform_real_distribution<float> fov{ 0.3f, 2.0f };
+            std::uniform_real_distribution<float> farZ{ 20.0f, 300.0f };
+
+            const DirectX::XMVECTOR eye = DirectX::XMVectorSet(position(randomEngine), position(randomEngine), position(randomEngine), 1.0f);
+            const DirectX::XMVECTOR target = DirectX::XMVectorSet(position(randomEngine), position(randomEngine), position(randomEngine), 1.0f);
+
+            const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(eye, target, DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            const DirectX::XMMATRIX projection = DirectX::XMMatrixPerspectiveFovLH(fov(randomEngine), 16.0f / 9.0f, 0.1f, farZ(randomEngine));
+
+            DirectX::BoundingFrustum viewSpaceFrustum;
+            DirectX::BoundingFrustum::CreateFromMatrix(viewSpaceFrustum, projection);
+
+            DirectX::BoundingFrustum worldSpaceFrustum;
+            viewSpaceFrustum.Transform(worldSpaceFrustum, DirectX::XMMatrixInverse(nullptr, view));
+
+            return benzin::GetFrustumPlanes(worldSpaceFrustum);
+        }
+
+    } // anonymous namespace
+
+    // Skipped planes, subtrees reported without tests and batched leaf tests must not change the result of testing every proxy alone
+    BenzinTest(TreeQueryMatchesBruteForce)
+    {
+        std::mt19937 randomEngine{ 23 };
+        std::uniform_real_distribution<float> chance{ 0.0f, 1.0f };
+        std::uniform_real_distribution<float> smallMove{ -0.2f, 0.2f };
+
+        benzin::DynamicAabbTree tree;
+        std::vector<benzin::AabbTreeProxyId> proxyIds;
+
+        for (uint32_t i = 0; i < 3000; ++i)
+        {
+            proxyIds.push_back(tree.CreateProxy(GetRandomBox(randomEngine)));
+        }
+
+        // Small moves stay inside of enlarged boxes, big ones reinsert leaves
+        uint32_t reinsertedProxyCount = 0;
+
+        for (const benzin::AabbTreeProxyId proxyId : proxyIds)
+        {
+            const benzin::Aabb& aabb = tree.GetProxyAabb(proxyId);
+
+            DirectX::BoundingBox box
+            {
+                { (aabb.Min.x + aabb.Max.x) * 0.5f, (aabb.Min.y + aabb.Max.y) * 0.5f, (aabb.Min.z + aabb.Max.z) * 0.5f },
+                { (aabb.Max.x - aabb.Min.x) * 0.5f, (aabb.Max.y - aabb.Min.y) * 0.5f, (aabb.Max.z - aabb.Min.z) * 0.5f },
+            };
+
+            if (chance(randomEngine) < 0.2f)
+            {
+                box = GetRandomBox(randomEngine);
+            }
+            else
+            {
+                box.Center.x += smallMove(randomEngine);
+            }
+
+            reinsertedProxyCount += tree.MoveProxy(proxyId, box) ? 1 : 0;
+        }
+
+        for (size_t i = 0; i < proxyIds.size(); i += 7)
+        {
+            tree.DestroyProxy(proxyIds[i]);
+            proxyIds[i] = benzin::g_InvalidIndex<benzin::AabbTreeProxyId>;
+        }
+
+        std::erase(proxyIds, benzin::g_InvalidIndex<benzin::AabbTreeProxyId>);
+
+        BenzinCheck(reinsertedProxyCount != 0);
+        BenzinCheck(tree.Validate());
+        BenzinCheck(tree.GetStats().ProxyCount == proxyIds.size());
+
+        std::vector<benzin::AabbTreeProxyId> visibleProxyIds;
+        std::vector<benzin::AabbTreeProxyId> expectedVisibleProxyIds;
+
+        uint32_t mismatchCount = 0;
+        uint32_t visibleProxyCount = 0;
+        uint32_t maxTestedNodeCount = 0;
+
+        for (uint32_t frustumIndex = 0; frustumIndex < 64; ++frustumIndex)
+        {
+            const benzin::FrustumPlanes frustumPlanes = GetRandomFrustumPlanes(randomEngine);
+
+            visibleProxyIds.clear();
+            const benzin::AabbTreeQueryStats stats = tree.QueryFrustum(frustumPlanes, [&](benzin::AabbTreeProxyId proxyId) { visibleProxyIds.push_back(proxyId); });
+
+            expectedVisibleProxyIds.clear();
+            for (const benzin::AabbTreeProxyId proxyId : proxyIds)
+            {
+                uint32_t planeMask = benzin::g_AllFrustumPlanesMask;
+                if (benzin::ClassifyAabb(frustumPlanes, tree.GetProxyAabb(proxyId), planeMask))
+                {
+                    expectedVisibleProxyIds.push_back(proxyId);
+                }
+            }
+
+            std::ranges::sort(visibleProxyIds);
+            std::ranges::sort(expectedVisibleProxyIds);
+
+            mismatchCount += visibleProxyIds != expectedVisibleProxyIds ? 1 : 0;
+            visibleProxyCount += (uint32_t)visibleProxyIds.size();
+            maxTestedNodeCount = std::max(maxTestedNodeCount, stats.TestedNodeCount);
+
+            BenzinCheck(stats.VisibleProxyCount == visibleProxyIds.size());
+        }
+
+        BenzinCheck(mismatchCount == 0);
+
+        // Frustums see some of the boxes and the query doesn't degrade to testing every node
+        BenzinCheck(visibleProxyCount != 0);
+        BenzinCheck(maxTestedNodeCount < tree.GetStats().NodeCount);
+    }
+
+} // namespace tests
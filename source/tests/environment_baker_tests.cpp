@@ -0,0 +1,168 @@
+#include "bootstrap.hpp"
+
+#include <benzin/engine/environment_baker.hpp>
+#include <benzin/engine/resource_loader.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        // Smooth sky with a bright spot, so a prefiltered value depends on the roughness
+        DirectX::XMVECTOR GetSkyRadiance(const DirectX::XMFLOAT3& direction)
+        {
+            const float spot = std::pow(std::max(direction.x * 0.6f + direction.y * 0.8f, 0.0f), 8.0f);
+
+            return DirectX::XMVectorSet(0.2f + 0.1f * direction.x + 4.0f * spot, 0.3f + 0.2f * direction.y + 2.0f * spot, 0.5f - 0.1f * direction.z, 1.0f);
+        }
+
+        benzin::TextureImage CreateEquirectangularImage(uint32_t width, uint32_t height)
+        {
+            benzin::TextureImage image
+            {
+                .Format = benzin::GraphicsFormat::Rgba32Float,
+                .Width = width,
+                .Height = height,
+            };
+
+            image.ImageData.resize((size_t)width * height * sizeof(DirectX::XMFLOAT4));
+            auto* texels = reinterpret_cast<DirectX::XMFLOAT4*>(image.ImageData.data());
+
+            // Inverse of the mapping of 'SampleEquirectangular'
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    const float phi = (0.5f - ((float)x + 0.5f) / (float)width) * DirectX::XM_2PI;
+                    const float theta = ((float)y + 0.5f) / (float)height * DirectX::XM_PI;
+
+                    const DirectX::XMFLOAT3 direction{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+                    DirectX::XMStoreFloat4(&texels[(size_t)y * width + x], GetSkyRadiance(direction));
+                }
+            }
+
+            return image;
+        }
+
+        DirectX::XMVECTOR LoadBakedTexel(const benzin::TextureImage& cubeMap, uint32_t faceIndex, uint32_t mipIndex, uint32_t x, uint32_t y)
+        {
+            size_t faceTexelCount = 0;
+            size_t mipTexelOffset = 0;
+
+            for (uint32_t i = 0; i < cubeMap.MipCount; ++i)
+            {
+                const uint32_t mipSize = std::max(cubeMap.Width >> i, 1u);
+                mipTexelOffset += i < mipIndex ? (size_t)mipSize * mipSize : 0;
+                faceTexelCount += (size_t)mipSize * mipSize;
+            }
+
+            const size_t texelIndex = faceIndex * faceTexelCount + mipTexelOffset + (size_t)y * std::max(cubeMap.Width >> mipIndex, 1u) + x;
+            return DirectX::PackedVector::XMLoadHalf4(reinterpret_cast<const DirectX::PackedVector::XMHALF4*>(cubeMap.ImageData.data()) + texelIndex);
+        }
+
+        // GGX prefiltered radiance with 'N == V == R' integrated over every texel of a cube map made from the image
+        // Ref: Karis, Real Shading in Unreal Engine 4
+        DirectX::XMVECTOR PrefilterReference(const benzin::TextureImage& equirectangularImage, DirectX::XMVECTOR normal, float roughness, uint32_t faceSize)
+        {
+            const float alphaSquared = roughness * roughness * roughness * roughness;
+
+            DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+            float weightSum = 0.0f;
+
+            for (uint32_t faceIndex = 0; faceIndex < 6; ++faceIndex)
+            {
+                for (uint32_t y = 0; y < faceSize; ++y)
+                {
+                    for (uint32_t x = 0; x < faceSize; ++x)
+                    {
+                        const float u = ((float)x + 0.5f) / (float)faceSize;
+                        const float v = ((float)y + 0.5f) / (float)faceSize;
+
+                        const DirectX::XMVECTOR direction = benzin::GetCubeFaceDirection(faceIndex, u, v);
+
+                        const float nDotL = DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, direction));
+                        if (nDotL <= 0.0f)
+                        {
+                            continue;
+                        }
+
+                        // Solid angle of the texel on the face at distance 1
+                        const float faceU = 2.0f * u - 1.0f;
+                        const float faceV = 1.0f - 2.0f * v;
+                        const float solidAngle = 4.0f / ((float)faceSize * (float)faceSize) / std::pow(1.0f + faceU * faceU + faceV * faceV, 1.5f);
+
+                        const DirectX::XMVECTOR halfVector = DirectX::XMVector3Normalize(DirectX::XMVectorAdd(normal, direction));
+                        const float nDotH = DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, halfVector));
+                        const float denominator = nDotH * nDotH * (alphaSquared - 1.0f) + 1.0f;
+                        const float distribution = alphaSquared / (DirectX::XM_PI * denominator * denominator);
+
+                        const float weight = distribution * nDotL * solidAngle;
+
+                        sum = DirectX::XMVectorMultiplyAdd(benzin::SampleEquirectangular(equirectangularImage, direction), DirectX::XMVectorReplicate(weight), sum);
+                        weightSum += weight;
+                    }
+                }
+            }
+
+            return DirectX::XMVectorScale(sum, 1.0f / weightSum);
+        }
+
+    } // anonymous namespace
+
+    // Filtered importance sampling trades accuracy for few samples, so the baked mips are compared with a tolerance
+    BenzinTest(BakedSpecularMipsMatchBruteForceConvolution)
+    {
+        const benzin::TextureImage equirectangularImage = CreateEquirectangularImage(128, 64);
+
+        const benzin::EnvironmentBakeParams params
+        {
+            .CubeFaceSize = 16,
+            .SpecularMipCount = 5,
+            .SpecularSampleCount = 256,
+        };
+
+        benzin::TextureImage cubeMap;
+        benzin::BakeEnvironmentCubeMap(equirectangularImage, cubeMap, params);
+
+        BenzinCheck(cubeMap.Format == benzin::GraphicsFormat::Rgba16Float && cubeMap.IsCubeMap);
+        BenzinCheck(cubeMap.MipCount == params.SpecularMipCount);
+        BenzinCheck(cubeMap.Width == params.CubeFaceSize && cubeMap.Height == params.CubeFaceSize);
+
+        float maxRelativeError = 0.0f;
+
+        for (uint32_t mipIndex = 1; mipIndex < cubeMap.MipCount; ++mipIndex)
+        {
+            const float roughness = (float)mipIndex / (float)(cubeMap.MipCount - 1);
+            const uint32_t mipSize = std::max(params.CubeFaceSize >> mipIndex, 1u);
+
+            for (uint32_t faceIndex = 0; faceIndex < 6; ++faceIndex)
+            {
+                for (uint32_t y = 0; y < mipSize; ++y)
+                {
+                    for (uint32_t x = 0; x < mipSize; ++x)
+                    {
+                        const DirectX::XMVECTOR normal = benzin::GetCubeFaceDirection(faceIndex, ((float)x + 0.5f) / (float)mipSize, ((float)y + 0.5f) / (float)mipSize);
+
+                        const DirectX::XMVECTOR reference = PrefilterReference(equirectangularImage, normal, roughness, 32);
+                        const DirectX::XMVECTOR baked = LoadBakedTexel(cubeMap, faceIndex, mipIndex, x, y);
+
+                        DirectX::XMFLOAT3 error;
+                        DirectX::XMStoreFloat3(&error, DirectX::XMVectorAbs(DirectX::XMVectorSubtract(baked, reference)));
+
+                        DirectX::XMFLOAT3 referenceColor;
+                        DirectX::XMStoreFloat3(&referenceColor, reference);
+
+                        // Relative to the brightest channel, so a dim channel next to the bright spot isn't judged alone
+                        const float relativeError = std::max({ error.x, error.y, error.z }) / std::max({ referenceColor.x, referenceColor.y, referenceColor.z });
+                        maxRelativeError = std::max(maxRelativeError, relativeError);
+                    }
+                }
+            }
+        }
+
+        BenzinTrace("BakedSpecularMipsMatchBruteForceConvolution: Max relative error {}", maxRelativeError);
+        BenzinCheck(maxRelativeError < 0.1f);
+    }
+
+} // namespace tests
@@ -0,0 +1,181 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/core/command_line_args.hpp>
+#include <benzin/core/heap_allocation_counter.hpp>
+#include <benzin/core/job_system.hpp>
+#include <benzin/engine/draw_packet_builder.hpp>
+#include <benzin/engine/dynamic_aabb_tree.hpp>
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/occlusion_culling.hpp>
+#include <benzin/engine/resource_loader.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        DirectX::BoundingBox GetRandomBox(std::mt19937& randomEngine)
+        {
+            std::uniform_real_distribution<float> center{ -50.0f, 50.0f };
+            std::uniform_real_distribution<float> extent{ 0.1f, 2.0f };
+
+            return DirectX::BoundingBox{ { center(randomEngine), center(randomEngine), center(randomEngine) }, { extent(randomEngine), extent(randomEngine), extent(randomEngine) } };
+        }
+
+    } // anonymous namespace
+
+    // Per frame CPU work of the geometry pass: frustum culling by the tree, occlusion culling, building draw packets and
+    // UI strings. Once containers and queues have grown, frames must not touch the heap
+    BenzinTest(FrameHotPathsDontAllocateInSteadyState)
+    {
+        std::mt19937 randomEngine{ 21 };
+
+        benzin::DynamicAabbTree meshInstanceTree;
+        std::vector<benzin::AabbTreeProxyId> proxyIds;
+        std::vector<DirectX::BoundingBox> boxes;
+
+        for (uint32_t i = 0; i < 2000; ++i)
+        {
+            boxes.push_back(GetRandomBox(randomEngine));
+            proxyIds.push_back(meshInstanceTree.CreateProxy(boxes.back()));
+        }
+
+        const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 0.0f, -80.0f, 1.0f), DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        const DirectX::XMMATRIX projection = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 500.0f);
+
+        DirectX::BoundingFrustum viewSpaceFrustum;
+        DirectX::BoundingFrustum::CreateFromMatrix(viewSpaceFrustum, projection);
+
+        DirectX::BoundingFrustum worldSpaceFrustum;
+        viewSpaceFrustum.Transform(worldSpaceFrustum, DirectX::XMMatrixInverse(nullptr, view));
+
+        const benzin::FrustumPlanes frustumPlanes = benzin::GetFrustumPlanes(worldSpaceFrustum);
+
+        // A wall in front of the camera
+        const benzin::MeshData wall = benzin::GenerateBox(benzin::BoxGeometryCreation{ .Width = 10.0f, .Height = 10.0f, .Depth = 1.0f });
+        const DirectX::XMMATRIX wallWorldMatrix = DirectX::XMMatrixTranslation(0.0f, 0.0f, -60.0f);
+        const std::array occluderCandidates
+        {
+            benzin::Occluder
+            {
+                .Vertices = wall.Vertices,
+                .Indices = wall.Indices,
+                .WorldMatrix = wallWorldMatrix,
+                .WorldAabb{ { -5.0f, -5.0f, -60.5f }, { 5.0f, 5.0f, -59.5f } },
+            },
+        };
+
+        benzin::OcclusionCuller occlusionCuller;
+
+        benzin::MeshCollectionResource meshCollection;
+        meshCollection.Meshes.push_back(benzin::GenerateBox(benzin::BoxGeometryCreation{ .Width = 1.0f, .Height = 1.0f, .Depth = 1.0f }));
+        // Visible instances are indexed by proxy ids
+        meshCollection.MeshInstances.resize(std::ranges::max(proxyIds) + 1, benzin::MeshInstance{ .MeshIndex = 0 });
+
+        const std::array entities{ benzin::DrawPacketEntity{ .MeshCollection = &meshCollection } };
+
+        std::vector<benzin::VisibleMeshInstance> visibleMeshInstances;
+        benzin::DrawPacketList drawPacketList;
+        std::vector<float> rowSums(256);
+
+        uint32_t drawCount = 0;
+        uint32_t occludedMeshInstanceCount = 0;
+
+        const auto RunFrame = [&](uint32_t frameIndex)
+        {
+            benzin::FrameArena::BeginFrame(frameIndex % benzin::CommandLineArgs::GetFrameInFlightCount());
+
+            // Proxies move a bit every frame, most moves stay inside of the enlarged boxes
+            for (const auto& [proxyId, box] : std::views::zip(proxyIds, boxes))
+            {
+                box.Center.x += (frameIndex % 2 == 0 ? 0.01f : -0.01f);
+                meshInstanceTree.MoveProxy(proxyId, box);
+            }
+
+            visibleMeshInstances.clear();
+            meshInstanceTree.QueryFrustum(frustumPlanes, [&](benzin::AabbTreeProxyId proxyId)
+            {
+                visibleMeshInstances.push_back(benzin::VisibleMeshInstance{ .MeshInstanceIndex = proxyId });
+            });
+
+            occlusionCuller.Render(view * projection, occluderCandidates);
+            occludedMeshInstanceCount = (uint32_t)std::erase_if(visibleMeshInstances, [&](const benzin::VisibleMeshInstance& visibleMeshInstance)
+            {
+                return occlusionCuller.IsOccluded(meshInstanceTree.GetProxyAabb(visibleMeshInstance.MeshInstanceIndex));
+            });
+
+            benzin::BuildDrawPackets(entities, visibleMeshInstances, drawPacketList);
+
+            benzin::ParallelFor((uint32_t)rowSums.size(), 4, [&](uint32_t rowIndex)
+            {
+                rowSums[rowIndex] = (float)(rowIndex * frameIndex);
+            });
+
+            benzin::FrameVector<uint32_t> frameIndices(64, frameIndex);
+            const char* text = BenzinFrameFormatCstr("Frame {}: {} draws", frameIndex, drawPacketList.DrawPackets.size());
+
+            drawCount = (uint32_t)drawPacketList.DrawPackets.size();
+
+            BenzinCheck(frameIndices.back() == frameIndex && text[0] == 'F');
+        };
+
+        for (uint32_t frameIndex = 0; frameIndex < 8; ++frameIndex)
+        {
+            RunFrame(frameIndex);
+        }
+
+        const uint64_t heapAllocationCount = benzin::GetHeapAllocationCount();
+
+        for (uint32_t frameIndex = 8; frameIndex < 32; ++frameIndex)
+        {
+            RunFrame(frameIndex);
+        }
+
+        BenzinCheck(benzin::GetHeapAllocationCount() == heapAllocationCount);
+        BenzinCheck(benzin::FrameArena::GetLastFrameStats().HeapAllocationCount == 0);
+
+        // The scene isn't empty, otherwise the test proves nothing
+        BenzinCheck(drawCount != 0);
+        BenzinCheck(occludedMeshInstanceCount != 0);
+    }
+
+    BenzinTest(FrameArenaStatsCountHeapAllocationsAfterWarmUp)
+    {
+#if BENZIN_IS_HEAP_ALLOCATION_COUNTING_ENABLED
+        uint32_t frameIndex = 0;
+        const auto BeginFrame = [&] { benzin::FrameArena::BeginFrame(frameIndex++ % benzin::CommandLineArgs::GetFrameInFlightCount()); };
+
+        // Other tests may have begun frames already
+        while (benzin::FrameArena::GetLastFrameStats().SteadyFrameCount == 0 && frameIndex < 1000)
+        {
+            BeginFrame();
+        }
+
+        const benzin::FrameArenaStats warmStats = benzin::FrameArena::GetLastFrameStats();
+        BenzinCheck(warmStats.SteadyFrameCount != 0);
+
+        // A frame without allocations and a frame with them
+        BeginFrame();
+
+        const uint64_t heapAllocationCount = benzin::GetHeapAllocationCount();
+        {
+            const std::string text(256, 'x');
+            BenzinCheck(text.back() == 'x');
+        }
+        const uint64_t frameHeapAllocationCount = benzin::GetHeapAllocationCount() - heapAllocationCount;
+
+        BeginFrame();
+
+        const benzin::FrameArenaStats& stats = benzin::FrameArena::GetLastFrameStats();
+        BenzinCheck(frameHeapAllocationCount != 0);
+        BenzinCheck(stats.HeapAllocationCount == frameHeapAllocationCount);
+        BenzinCheck(stats.SteadyFrameCount == warmStats.SteadyFrameCount + 2);
+        BenzinCheck(stats.SteadyAllocatingFrameCount == warmStats.SteadyAllocatingFrameCount + 1);
+        BenzinCheck(stats.SteadyHeapAllocationCount == warmStats.SteadyHeapAllocationCount + frameHeapAllocationCount);
+#endif
+    }
+
+} // namespace tests
@@ -0,0 +1,235 @@
+#include "bootstrap.hpp"
+
+#include <benzin/engine/frustum_culling.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        struct AabbSoa
+        {
+            std::vector<float> MinX;
+            std::vector<float> MinY;
+            std::vector<float> MinZ;
+            std::vector<float> MaxX;
+            std::vector<float> MaxY;
+            std::vector<float> MaxZ;
+
+            void PushBack(const benzin::Aabb& aabb)
+            {
+                MinX.push_back(aabb.Min.x);
+                MinY.push_back(aabb.Min.y);
+                MinZ.push_back(aabb.Min.z);
+                MaxX.push_back(aabb.Max.x);
+                MaxY.push_back(aabb.Max.y);
+                MaxZ.push_back(aabb.Max.z);
+            }
+
+            benzin::AabbSoaView GetView() const
+            {
+                return benzin::AabbSoaView
+                {
+                    .MinX = MinX.data(),
+                    .MinY = MinY.data(),
+                    .MinZ = MinZ.data(),
+                    .MaxX = MaxX.data(),
+                    .MaxY = MaxY.data(),
+                    .MaxZ = MaxZ.data(),
+                    .Count = (uint32_t)MinX.size(),
+                };
+            }
+        };
+
+        benzin::FrustumPlanes GetRandomFrustumPlanes(std::mt19937& randomEngine)
+        {
+            std::uniform_real_distribution<float> position{ -60.0f, 60.0f };
+            std::uniform_real_distribution<float> fov{ 0.3f, 2.0f };
+
+            const DirectX::XMVECTOR eye = DirectX::XMVectorSet(position(randomEngine), position(randomEngine), position(randomEngine), 1.0f);
+            const DirectX::XMVECTOR target = DirectX::XMVectorSet(position(randomEngine), position(randomEngine), position(randomEngine), 1.0f);
+
+            const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(eye, target, DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            const DirectX::XMMATRIX projection = DirectX::XMMatrixPerspectiveFovLH(fov(randomEngine), 16.0f / 9.0f, 0.1f, 100.0f);
+
+            DirectX::BoundingFrustum viewSpaceFrustum;
+            DirectX::BoundingFrustum::CreateFromMatrix(viewSpaceFrustum, projection);
+
+            DirectX::BoundingFrustum worldSpaceFrustum;
+            viewSpaceFrustum.Transform(worldSpaceFrustum, DirectX::XMMatrixInverse(nullptr, view));
+
+            return benzin::GetFrustumPlanes(worldSpaceFrustum);
+        }
+
+        // Box '[-10, 10]^3', so distances of boxes with integer corners are exact. Zero components are negative on some planes,
+        // '-0.0f >= 0.0f' picks the same corner as '0.0f'
+        benzin::FrustumPlanes GetAxisAlignedFrustumPlanes()
+        {
+            return benzin::FrustumPlanes
+            {
+                .Planes
+                {
+                    DirectX::XMFLOAT4{ 0.0f, 0.0f, -1.0f, -10.0f },
+                    DirectX::XMFLOAT4{ 0.0f, -0.0f, 1.0f, -10.0f },
+                    DirectX::XMFLOAT4{ 1.0f, 0.0f, 0.0f, -10.0f },
+                    DirectX::XMFLOAT4{ -1.0f, -0.0f, 0.0f, -10.0f },
+                    DirectX::XMFLOAT4{ 0.0f, 1.0f, -0.0f, -10.0f },
+                    DirectX::XMFLOAT4{ 0.0f, -1.0f, 0.0f, -10.0f },
+                },
+            };
+        }
+
+        std::array<float*, 6> GetComponents(benzin::Aabb& aabb)
+        {
+            return { &aabb.Min.x, &aabb.Min.y, &aabb.Min.z, &aabb.Max.x, &aabb.Max.y, &aabb.Max.z };
+        }
+
+        // Random boxes, boxes with corners exactly on the planes of 'GetAxisAlignedFrustumPlanes', boxes with NaN and infinite corners
+        AabbSoa CreateAabbs(std::mt19937& randomEngine, uint32_t count)
+        {
+            std::uniform_real_distribution<float> center{ -70.0f, 70.0f };
+            std::uniform_real_distribution<float> extent{ 0.0f, 8.0f };
+            std::uniform_int_distribution<int> corner{ -12, 12 };
+            std::uniform_int_distribution<uint32_t> kind{ 0, 9 };
+            std::uniform_int_distribution<uint32_t> component{ 0, 5 };
+
+            const float nan = std::numeric_limits<float>::quiet_NaN();
+            const float infinity = std::numeric_limits<float>::infinity();
+
+            AabbSoa aabbs;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                benzin::Aabb aabb;
+
+                const uint32_t aabbKind = kind(randomEngine);
+                if (aabbKind < 5)
+                {
+                    aabb = benzin::ToAabb(DirectX::BoundingBox{ { center(randomEngine), center(randomEngine), center(randomEngine) }, { extent(randomEngine), extent(randomEngine), extent(randomEngine) } });
+                }
+                else
+                {
+                    // Integer corners, some of them are at exactly 10 or -10
+                    for (uint32_t axis = 0; axis < 3; ++axis)
+                    {
+                        const auto [min, max] = std::minmax(corner(randomEngine), corner(randomEngine));
+
+                        *GetComponents(aabb)[axis] = (float)min;
+                        *GetComponents(aabb)[axis + 3] = (float)max;
+                    }
+                }
+
+                if (aabbKind == 8)
+                {
+                    *GetComponents(aabb)[component(randomEngine)] = nan;
+                }
+                else if (aabbKind == 9)
+                {
+                    *GetComponents(aabb)[component(randomEngine)] = component(randomEngine) % 2 == 0 ? infinity : -infinity;
+                }
+
+                aabbs.PushBack(aabb);
+            }
+
+            return aabbs;
+        }
+
+        // Returns the count of boxes which visibility differs from 'ClassifyAabb'
+        uint32_t GetMismatchCount(const benzin::FrustumPlanes& frustumPlanes, const AabbSoa& aabbs, benzin::CullingKernel kernel)
+        {
+            const benzin::AabbSoaView view = aabbs.GetView();
+
+            std::vector<uint64_t> visibilityMask((view.Count + 63) / 64, ~uint64_t{ 0 });
+            benzin::CullAabbs(frustumPlanes, view, visibilityMask, kernel);
+
+            uint32_t mismatchCount = 0;
+
+            for (uint32_t i = 0; i < view.Count; ++i)
+            {
+                const benzin::Aabb aabb
+                {
+                    .Min{ view.MinX[i], view.MinY[i], view.MinZ[i] },
+                    .Max{ view.MaxX[i], view.MaxY[i], view.MaxZ[i] },
+                };
+
+                uint32_t planeMask = benzin::g_AllFrustumPlanesMask;
+                const bool isVisible = benzin::ClassifyAabb(frustumPlanes, aabb, planeMask);
+                const bool isMaskVisible = (visibilityMask[i / 64] & (uint64_t{ 1 } << (i % 64))) != 0;
+
+                mismatchCount += isVisible != isMaskVisible ? 1 : 0;
+            }
+
+            // Bits after the last box stay cleared
+            if (view.Count % 64 != 0)
+            {
+                mismatchCount += (visibilityMask.back() >> (view.Count % 64)) != 0 ? 1 : 0;
+            }
+
+            return mismatchCount;
+        }
+
+        std::vector<benzin::CullingKernel> GetSupportedKernels()
+        {
+            std::vector<benzin::CullingKernel> kernels{ benzin::CullingKernel::Scalar, benzin::CullingKernel::Sse };
+            if (benzin::GetWidestCullingKernel() == benzin::CullingKernel::Avx)
+            {
+                kernels.push_back(benzin::CullingKernel::Avx);
+            }
+
+            return kernels;
+        }
+
+    } // anonymous namespace
+
+    // SIMD kernels must give exactly the mask of 'ClassifyAabb', including boxes touching planes and boxes with NaN distances.
+    // The count isn't a multiple of 8, so the scalar tail after the SIMD part is covered too
+    BenzinTest(CullingKernelsMatchClassifyAabb)
+    {
+        std::mt19937 randomEngine{ 24 };
+
+        const AabbSoa aabbs = CreateAabbs(randomEngine, 4099);
+
+        uint32_t mismatchCount = 0;
+        for (const benzin::CullingKernel kernel : GetSupportedKernels())
+        {
+            mismatchCount += GetMismatchCount(GetAxisAlignedFrustumPlanes(), aabbs, kernel);
+
+            for (uint32_t frustumIndex = 0; frustumIndex < 32; ++frustumIndex)
+            {
+                mismatchCount += GetMismatchCount(GetRandomFrustumPlanes(randomEngine), aabbs, kernel);
+            }
+        }
+
+        BenzinCheck(mismatchCount == 0);
+    }
+
+    // A box touching a plane from the inside or the outside has a zero distance and is visible, a NaN distance isn't outside
+    BenzinTest(TouchingAndNanBoxesAreVisible)
+    {
+        const benzin::FrustumPlanes frustumPlanes = GetAxisAlignedFrustumPlanes();
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+
+        AabbSoa aabbs;
+        aabbs.PushBack(benzin::Aabb{ .Min{ 10.0f, 0.0f, 0.0f }, .Max{ 12.0f, 1.0f, 1.0f } }); // Touches the right plane from the outside
+        aabbs.PushBack(benzin::Aabb{ .Min{ 8.0f, 0.0f, 0.0f }, .Max{ 10.0f, 1.0f, 1.0f } }); // Touches the right plane from the inside
+        aabbs.PushBack(benzin::Aabb{ .Min{ -12.0f, -12.0f, -12.0f }, .Max{ -10.0f, -10.0f, -10.0f } }); // Touches a corner of the frustum
+        aabbs.PushBack(benzin::Aabb{ .Min{ nan, 0.0f, 0.0f }, .Max{ nan, 1.0f, 1.0f } });
+        aabbs.PushBack(benzin::Aabb{ .Min{ 10.5f, 0.0f, 0.0f }, .Max{ 12.0f, 1.0f, 1.0f } }); // Outside
+
+        // Fills a whole AVX batch, so every kernel tests the boxes above with SIMD
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            aabbs.PushBack(benzin::Aabb{ .Min{ -1.0f, -1.0f, -1.0f }, .Max{ 1.0f, 1.0f, 1.0f } });
+        }
+
+        for (const benzin::CullingKernel kernel : GetSupportedKernels())
+        {
+            std::array<uint64_t, 1> visibilityMask{};
+            benzin::CullAabbs(frustumPlanes, aabbs.GetView(), visibilityMask, kernel);
+
+            BenzinCheck(visibilityMask[0] == 0b1110'1111);
+        }
+    }
+
+} // namespace tests
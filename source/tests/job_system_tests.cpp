@@ -0,0 +1,150 @@
+#include "bootstrap.hpp"
+
+#include <benzin/core/job_system.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        // Counts how many times 'ParallelFor' visits each index
+        bool IsEveryIndexVisitedOnce(uint32_t count, uint32_t grainSize)
+        {
+            std::vector<std::atomic<uint32_t>> visitCounts(count);
+
+            benzin::ParallelFor(count, grainSize, [&](uint32_t index)
+            {
+                visitCounts[index].fetch_add(1, std::memory_order_relaxed);
+            });
+
+            return std::ranges::all_of(visitCounts, [](const std::atomic<uint32_t>& visitCount) { return visitCount.load() == 1; });
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(ParallelForVisitsEveryIndexOnce)
+    {
+        for (const uint32_t count : { 0u, 1u, 7u, 64u, 1000u, 100'003u })
+        {
+            for (const uint32_t grainSize : { 1u, 3u, 64u, 4096u })
+            {
+                BenzinCheck(IsEveryIndexVisitedOnce(count, grainSize));
+            }
+        }
+    }
+
+    BenzinTest(ParallelForEachPassesElementsByReference)
+    {
+        std::vector<uint32_t> values(10'000);
+        std::iota(values.begin(), values.end(), 0u);
+
+        benzin::ParallelForEach(values, [](uint32_t& value) { value *= 2; }, 16);
+
+        bool isDoubled = true;
+        for (const auto& [index, value] : values | std::views::enumerate)
+        {
+            isDoubled &= value == (uint32_t)index * 2;
+        }
+
+        BenzinCheck(isDoubled);
+    }
+
+    BenzinTest(WaitReturnsAfterAllJobsOfCounter)
+    {
+        std::atomic<uint32_t> sum = 0;
+        benzin::JobCounter counter;
+
+        // The counter is reused after every wait
+        for (uint32_t round = 0; round < 3; ++round)
+        {
+            for (uint32_t i = 1; i <= 100; ++i)
+            {
+                benzin::JobSystem::Run([&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); }, &counter);
+            }
+
+            benzin::JobSystem::Wait(counter);
+
+            BenzinCheck(counter.IsDone());
+            BenzinCheck(sum.load() == 5050 * (round + 1));
+        }
+    }
+
+    BenzinTest(DependentJobsRunAfterDependency)
+    {
+        constexpr uint32_t producerCount = 64;
+
+        std::atomic<uint32_t> producedCount = 0;
+        std::atomic<uint32_t> producedCountSeenByConsumers = 0;
+
+        benzin::JobCounter producerCounter;
+        benzin::JobCounter consumerCounter;
+
+        for (uint32_t i = 0; i < producerCount; ++i)
+        {
+            benzin::JobSystem::Run([&]
+            {
+                std::this_thread::yield();
+                producedCount.fetch_add(1, std::memory_order_relaxed);
+            }, &producerCounter);
+        }
+
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            benzin::JobSystem::Run([&] { producedCountSeenByConsumers.fetch_add(producedCount.load(), std::memory_order_relaxed); }, &consumerCounter, &producerCounter);
+        }
+
+        benzin::JobSystem::Wait(consumerCounter);
+
+        BenzinCheck(producerCounter.IsDone());
+        BenzinCheck(producedCountSeenByConsumers.load() == producerCount * 8);
+    }
+
+    // Jobs which wait for nested jobs run queued jobs meanwhile, so nesting deeper than the number of workers doesn't deadlock
+    BenzinTest(NestedParallelForDoesNotDeadlock)
+    {
+        std::atomic<uint32_t> leafCount = 0;
+
+        benzin::ParallelFor(16, 1, [&](uint32_t)
+        {
+            benzin::ParallelFor(16, 1, [&](uint32_t)
+            {
+                benzin::ParallelFor(16, 4, [&](uint32_t) { leafCount.fetch_add(1, std::memory_order_relaxed); });
+            });
+        });
+
+        BenzinCheck(leafCount.load() == 16 * 16 * 16);
+    }
+
+    // Threads outside the pool submit into the shared queue
+    BenzinTest(JobsCanBeSubmittedFromOutsideThreads)
+    {
+        constexpr uint32_t threadCount = 4;
+        constexpr uint32_t jobCountPerThread = 256;
+
+        std::atomic<uint32_t> jobCount = 0;
+        std::array<bool, threadCount> isEveryIndexVisited{};
+
+        {
+            std::vector<std::jthread> threads;
+            for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+            {
+                threads.emplace_back([&, threadIndex]
+                {
+                    benzin::JobCounter counter;
+                    for (uint32_t i = 0; i < jobCountPerThread; ++i)
+                    {
+                        benzin::JobSystem::Run([&] { jobCount.fetch_add(1, std::memory_order_relaxed); }, &counter);
+                    }
+                    benzin::JobSystem::Wait(counter);
+
+                    isEveryIndexVisited[threadIndex] = IsEveryIndexVisitedOnce(1000, 8);
+                });
+            }
+        }
+
+        BenzinCheck(jobCount.load() == threadCount * jobCountPerThread);
+        BenzinCheck(std::ranges::all_of(isEveryIndexVisited, std::identity{}));
+    }
+
+} // namespace tests
@@ -0,0 +1,9 @@
+#include "bootstrap.hpp"
+
+#include <benzin/core/entry_point.hpp>
+
+int benzin::ClientMain()
+{
+    // The entry point of the engine initializes the job system and the frame arena, so tests run on the same setup as the sandbox
+    return tests::RunTests() == 0 ? 0 : 1;
+}
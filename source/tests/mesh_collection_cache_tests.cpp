@@ -0,0 +1,233 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/mesh_collection_cache.hpp>
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/utility/file_utils.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        std::filesystem::path GetTemporaryCacheFilePath(std::string_view fileName)
+        {
+            return std::filesystem::temp_directory_path() / std::format("benzin_tests_{}", fileName);
+        }
+
+        benzin::TextureImage CreateTextureImage()
+        {
+            benzin::TextureImage textureImage
+            {
+                .DebugName = "Texture",
+                .Format = benzin::GraphicsFormat::Rgba8Unorm,
+                .Width = 4,
+                .Height = 2,
+            };
+
+            for (uint32_t i = 0; i < 4 * 2 * 4; ++i)
+            {
+                textureImage.ImageData.push_back((std::byte)(i * 7));
+            }
+
+            return textureImage;
+        }
+
+        benzin::MeshCollectionResource CreateMeshCollection()
+        {
+            benzin::MeshCollectionResource meshCollection
+            {
+                .DebugName = "MeshCollection",
+            };
+
+            benzin::MeshData& mesh = meshCollection.Meshes.emplace_back(benzin::GenerateBox(benzin::BoxGeometryCreation{ .Width = 1.0f, .Height = 1.0f, .Depth = 1.0f }));
+            mesh.BoundingBox = DirectX::BoundingBox{ DirectX::XMFLOAT3{ 0.0f, 0.0f, 0.0f }, DirectX::XMFLOAT3{ 0.5f, 0.5f, 0.5f } };
+            mesh.Lods.push_back(benzin::MeshLod{ .Indices{ 0, 1, 2 }, .Error = 0.25f });
+
+            meshCollection.MeshInstances.push_back(benzin::MeshInstance
+            {
+                .MeshIndex = 0,
+                .MaterialIndex = 0,
+                .NodeIndex = 1,
+                .Transform = DirectX::XMMatrixTranslation(1.0f, 2.0f, 3.0f),
+            });
+
+            meshCollection.MeshNodes.push_back(benzin::MeshNode{ .Transform{ .Scale{ 1.0f, 1.0f, -1.0f } } });
+            meshCollection.MeshNodes.push_back(benzin::MeshNode{ .ParentNodeIndex = 0, .Transform{ .Translation{ 1.0f, 2.0f, -3.0f } } });
+
+            meshCollection.Materials.push_back(benzin::Material{ .AlbedoTextureIndex = 0, .AlphaCutoff = 0.5f });
+            meshCollection.TextureImages.push_back(CreateTextureImage());
+
+            return meshCollection;
+        }
+
+        bool IsEqual(const benzin::TextureImage& left, const benzin::TextureImage& right)
+        {
+            return left.DebugName == right.DebugName
+                && left.Format == right.Format
+                && left.IsCubeMap == right.IsCubeMap
+                && left.Width == right.Width
+                && left.Height == right.Height
+                && left.MipCount == right.MipCount
+                && std::ranges::equal(left.GetImageData(), right.GetImageData());
+        }
+
+        template <typename T>
+        bool IsInside(std::span<const T> values, std::span<const std::byte> data)
+        {
+            const auto* begin = reinterpret_cast<const std::byte*>(values.data());
+            return !values.empty() && begin >= data.data() && begin + values.size_bytes() <= data.data() + data.size();
+        }
+
+    } // anonymous namespace
+
+    // Headers are written as raw bytes, the same input must give the same file, otherwise the cache can't be compared or deduplicated
+    BenzinTest(CacheFilesAreDeterministic)
+    {
+        const benzin::MeshCollectionResource meshCollection = CreateMeshCollection();
+        const std::filesystem::path firstFilePath = GetTemporaryCacheFilePath("first.bin");
+        const std::filesystem::path secondFilePath = GetTemporaryCacheFilePath("second.bin");
+
+        BenzinCheck(benzin::SaveMeshCollectionToCacheFile(firstFilePath, 1, meshCollection));
+        BenzinCheck(benzin::SaveMeshCollectionToCacheFile(secondFilePath, 1, meshCollection));
+        BenzinCheck(benzin::ReadFromFile(firstFilePath) == benzin::ReadFromFile(secondFilePath));
+
+        BenzinCheck(benzin::SaveTextureImageToCacheFile(firstFilePath, 2, meshCollection.TextureImages[0]));
+        BenzinCheck(benzin::SaveTextureImageToCacheFile(secondFilePath, 2, meshCollection.TextureImages[0]));
+        BenzinCheck(benzin::ReadFromFile(firstFilePath) == benzin::ReadFromFile(secondFilePath));
+
+        std::filesystem::remove(firstFilePath);
+        std::filesystem::remove(secondFilePath);
+    }
+
+    BenzinTest(CacheFileRoundTripKeepsMeshCollection)
+    {
+        const benzin::MeshCollectionResource meshCollection = CreateMeshCollection();
+        const std::filesystem::path cacheFilePath = GetTemporaryCacheFilePath("mesh_collection.bin");
+
+        BenzinCheck(benzin::SaveMeshCollectionToCacheFile(cacheFilePath, 3, meshCollection));
+
+        benzin::MeshCollectionResource staleMeshCollection;
+        BenzinCheck(!benzin::LoadMeshCollectionFromCacheFile(cacheFilePath, 4, staleMeshCollection));
+
+        benzin::MeshCollectionResource loadedMeshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromCacheFile(cacheFilePath, 3, loadedMeshCollection));
+        BenzinCheck(loadedMeshCollection.MappedCacheFile != nullptr);
+
+        BenzinCheck(loadedMeshCollection.DebugName == meshCollection.DebugName);
+        BenzinCheck(loadedMeshCollection.Meshes.size() == 1);
+        BenzinCheck(loadedMeshCollection.MeshInstances.size() == 1);
+        BenzinCheck(loadedMeshCollection.MeshNodes.size() == 2);
+        BenzinCheck(loadedMeshCollection.Materials.size() == 1);
+        BenzinCheck(loadedMeshCollection.TextureImages.size() == 1);
+
+        if (!loadedMeshCollection.Meshes.empty())
+        {
+            const benzin::MeshData& mesh = meshCollection.Meshes[0];
+            const benzin::MeshData& loadedMesh = loadedMeshCollection.Meshes[0];
+
+            BenzinCheck(loadedMesh.GetVertices().size() == mesh.Vertices.size());
+            BenzinCheck(memcmp(loadedMesh.GetVertices().data(), mesh.Vertices.data(), mesh.Vertices.size() * sizeof(joint::MeshVertex)) == 0);
+            BenzinCheck(std::ranges::equal(loadedMesh.GetIndices(), mesh.Indices));
+            BenzinCheck(loadedMesh.PrimitiveTopology == mesh.PrimitiveTopology);
+            BenzinCheck(loadedMesh.BoundingBox && loadedMesh.BoundingBox->Extents.x == 0.5f);
+            BenzinCheck(loadedMesh.Lods.size() == 1 && std::ranges::equal(loadedMesh.GetLodIndices(1), mesh.Lods[0].Indices) && loadedMesh.Lods[0].Error == 0.25f);
+
+            // Arrays are used right from the mapping instead of being copied
+            if (loadedMeshCollection.MappedCacheFile)
+            {
+                const std::span<const std::byte> mappedData = loadedMeshCollection.MappedCacheFile->GetData();
+
+                BenzinCheck(loadedMesh.Vertices.empty() && loadedMesh.Indices.empty());
+                BenzinCheck(IsInside(loadedMesh.GetVertices(), mappedData));
+                BenzinCheck(IsInside(loadedMesh.GetIndices(), mappedData));
+                BenzinCheck(IsInside(loadedMesh.GetLodIndices(1), mappedData));
+            }
+        }
+
+        if (!loadedMeshCollection.MeshInstances.empty())
+        {
+            DirectX::XMFLOAT4X4 transform;
+            DirectX::XMStoreFloat4x4(&transform, loadedMeshCollection.MeshInstances[0].Transform);
+
+            BenzinCheck(transform.m[3][0] == 1.0f && transform.m[3][1] == 2.0f && transform.m[3][2] == 3.0f);
+            BenzinCheck(loadedMeshCollection.MeshInstances[0].NodeIndex == 1);
+        }
+
+        if (loadedMeshCollection.MeshNodes.size() == 2)
+        {
+            BenzinCheck(!benzin::IsValidIndex(loadedMeshCollection.MeshNodes[0].ParentNodeIndex) && loadedMeshCollection.MeshNodes[0].Transform.Scale.z == -1.0f);
+            BenzinCheck(loadedMeshCollection.MeshNodes[1].ParentNodeIndex == 0 && loadedMeshCollection.MeshNodes[1].Transform.Translation.z == -3.0f);
+        }
+
+        if (!loadedMeshCollection.Materials.empty())
+        {
+            BenzinCheck(loadedMeshCollection.Materials[0].AlbedoTextureIndex == 0);
+            BenzinCheck(loadedMeshCollection.Materials[0].AlphaCutoff == 0.5f);
+        }
+
+        if (!loadedMeshCollection.TextureImages.empty())
+        {
+            BenzinCheck(IsEqual(loadedMeshCollection.TextureImages[0], meshCollection.TextureImages[0]));
+            BenzinCheck(loadedMeshCollection.TextureImages[0].ImageData.empty());
+        }
+
+        // A mapped file can't be removed on Windows
+        loadedMeshCollection = {};
+        std::filesystem::remove(cacheFilePath);
+    }
+
+    // A standalone texture owns its data, nothing keeps the file mapped
+    BenzinTest(CacheFileRoundTripKeepsTextureImage)
+    {
+        const benzin::TextureImage textureImage = CreateTextureImage();
+        const std::filesystem::path cacheFilePath = GetTemporaryCacheFilePath("texture_image.bin");
+
+        BenzinCheck(benzin::SaveTextureImageToCacheFile(cacheFilePath, 5, textureImage));
+
+        benzin::TextureImage loadedTextureImage;
+        BenzinCheck(benzin::LoadTextureImageFromCacheFile(cacheFilePath, 5, loadedTextureImage));
+        BenzinCheck(IsEqual(loadedTextureImage, textureImage));
+        BenzinCheck(loadedTextureImage.ExternalImageData.empty());
+
+        std::filesystem::remove(cacheFilePath);
+    }
+
+    // Only buffers and images referenced by the glTF file invalidate the cache, not every file next to it
+    BenzinTest(GltfSourceHashDependsOnReferencedFilesOnly)
+    {
+        const std::filesystem::path directoryPath = GetTemporaryCacheFilePath("source_hash");
+        std::filesystem::create_directories(directoryPath);
+
+        const auto WriteTextFile = [&](std::string_view fileName, std::string_view text)
+        {
+            benzin::WriteToFile(directoryPath / fileName, std::as_bytes(std::span{ text }));
+        };
+
+        const std::filesystem::path gltfFilePath = directoryPath / "model.gltf";
+        WriteTextFile("model.gltf", R"({ "asset": { "version": "2.0" }, "buffers": [ { "uri": "mesh%20data.bin", "byteLength": 4 } ], "images": [ { "uri": "albedo.png" }, { "uri": "data:image/png;base64,AAAA" } ] })");
+        WriteTextFile("mesh data.bin", "1234");
+        WriteTextFile("albedo.png", "png");
+
+        const uint64_t sourceHash = benzin::ComputeGltfSourceHash(gltfFilePath, {});
+
+        WriteTextFile("unrelated.bin", "unrelated");
+        BenzinCheck(benzin::ComputeGltfSourceHash(gltfFilePath, {}) == sourceHash);
+
+        BenzinCheck(benzin::ComputeGltfSourceHash(gltfFilePath, benzin::MeshCollectionLoadingFlag::ParallelMeshParsing) == sourceHash);
+        BenzinCheck(benzin::ComputeGltfSourceHash(gltfFilePath, benzin::MeshCollectionLoadingFlag::GenerateLods) != sourceHash);
+
+        WriteTextFile("mesh data.bin", "123456");
+        const uint64_t changedBufferSourceHash = benzin::ComputeGltfSourceHash(gltfFilePath, {});
+        BenzinCheck(changedBufferSourceHash != sourceHash);
+
+        std::filesystem::remove(directoryPath / "albedo.png");
+        BenzinCheck(benzin::ComputeGltfSourceHash(gltfFilePath, {}) != changedBufferSourceHash);
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+} // namespace tests
@@ -0,0 +1,211 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/mesh_optimizer.hpp>
+#include <benzin/engine/resource_loader.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        using TrianglePositions = std::array<float, 9>;
+
+        // Triangles by positions, rotated to start from the smallest vertex, so the winding is kept and the order of vertices doesn't matter
+        std::vector<TrianglePositions> GetSortedTriangles(const benzin::MeshData& mesh)
+        {
+            std::vector<TrianglePositions> triangles;
+            triangles.reserve(mesh.Indices.size() / 3);
+
+            for (size_t i = 0; i < mesh.Indices.size(); i += 3)
+            {
+                std::array<std::array<float, 3>, 3> trianglePositions;
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    const auto& position = mesh.Vertices[mesh.Indices[i + j]].Position;
+                    trianglePositions[j] = { position.x, position.y, position.z };
+                }
+
+                std::ranges::rotate(trianglePositions, std::ranges::min_element(trianglePositions));
+
+                TrianglePositions& triangle = triangles.emplace_back();
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    std::ranges::copy(trianglePositions[j], triangle.begin() + j * 3);
+                }
+            }
+
+            std::ranges::sort(triangles);
+
+            return triangles;
+        }
+
+        // Every triangle gets its own vertices, like meshes exported without an index buffer
+        benzin::MeshData Unweld(const benzin::MeshData& mesh)
+        {
+            benzin::MeshData unweldedMesh
+            {
+                .PrimitiveTopology = mesh.PrimitiveTopology,
+            };
+
+            for (const uint32_t index : mesh.Indices)
+            {
+                unweldedMesh.Indices.push_back((uint32_t)unweldedMesh.Vertices.size());
+                unweldedMesh.Vertices.push_back(mesh.Vertices[index]);
+            }
+
+            return unweldedMesh;
+        }
+
+        void ShuffleTriangles(benzin::MeshData& mesh, uint32_t seed)
+        {
+            std::vector<std::array<uint32_t, 3>> triangles(mesh.Indices.size() / 3);
+            memcpy(triangles.data(), mesh.Indices.data(), mesh.Indices.size() * sizeof(uint32_t));
+
+            std::ranges::shuffle(triangles, std::mt19937{ seed });
+
+            memcpy(mesh.Indices.data(), triangles.data(), mesh.Indices.size() * sizeof(uint32_t));
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(OptimizeMeshImprovesAcmrOfShuffledMesh)
+    {
+        benzin::MeshData mesh = benzin::GenerateSphere(benzin::SphereGeometryCreation
+        {
+            .Radius = 1.0f,
+            .SliceCount = 64,
+            .StackCount = 64,
+        });
+        ShuffleTriangles(mesh, 1);
+
+        const auto trianglesBefore = GetSortedTriangles(mesh);
+        const size_t vertexCountBefore = mesh.Vertices.size();
+
+        const benzin::MeshOptimizationStats stats = benzin::OptimizeMesh(mesh);
+
+        // Random order misses the cache almost for every vertex, Forsyth gets close to 0.7 on regular meshes
+        BenzinCheck(stats.Before.GetAcmr() > 2.0f);
+        BenzinCheck(stats.After.GetAcmr() < 0.8f);
+        BenzinCheck(stats.After.GetAcmr() < stats.Before.GetAcmr());
+
+        // Triangles and their winding are kept, only the order changes
+        BenzinCheck(mesh.Vertices.size() == vertexCountBefore);
+        BenzinCheck(GetSortedTriangles(mesh) == trianglesBefore);
+
+        // 'OptimizeVertexFetch' puts vertices in order of the first use
+        uint32_t nextVertexIndex = 0;
+        bool isFetchLinear = true;
+        for (const uint32_t index : mesh.Indices)
+        {
+            isFetchLinear &= index <= nextVertexIndex;
+            nextVertexIndex = std::max(nextVertexIndex, index + 1);
+        }
+        BenzinCheck(isFetchLinear);
+    }
+
+    BenzinTest(OptimizeVertexCacheKeepsOptimizedOrder)
+    {
+        benzin::MeshData mesh = benzin::GenerateGrid(benzin::GridGeometryCreation
+        {
+            .Width = 1.0f,
+            .Depth = 1.0f,
+            .WidthPointCount = 32,
+            .DepthPointCount = 32,
+        });
+        ShuffleTriangles(mesh, 2);
+
+        benzin::OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+        const float acmr = benzin::AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size()).GetAcmr();
+
+        // A second pass starts from a good order and must not make it worse
+        benzin::OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+        BenzinCheck(benzin::AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size()).GetAcmr() <= acmr * 1.01f);
+    }
+
+    BenzinTest(WeldVerticesIsIdempotent)
+    {
+        const benzin::MeshData sphere = benzin::GenerateSphere(benzin::SphereGeometryCreation
+        {
+            .Radius = 1.0f,
+            .SliceCount = 16,
+            .StackCount = 16,
+        });
+
+        benzin::MeshData mesh = Unweld(sphere);
+        const auto trianglesBefore = GetSortedTriangles(mesh);
+
+        const benzin::VertexWeldingStats firstStats = benzin::WeldVertices(mesh);
+        BenzinCheck(firstStats.VertexCountBefore == sphere.Indices.size());
+        BenzinCheck(firstStats.VertexCountAfter <= sphere.Vertices.size());
+        BenzinCheck(GetSortedTriangles(mesh) == trianglesBefore);
+
+        const std::vector<uint32_t> weldedIndices = mesh.Indices;
+
+        const benzin::VertexWeldingStats secondStats = benzin::WeldVertices(mesh);
+        BenzinCheck(secondStats.VertexCountBefore == firstStats.VertexCountAfter);
+        BenzinCheck(secondStats.VertexCountAfter == firstStats.VertexCountAfter);
+        BenzinCheck(mesh.Indices == weldedIndices);
+    }
+
+    BenzinTest(WeldVerticesMergesCloseVerticesWithEpsilon)
+    {
+        benzin::MeshData mesh = Unweld(benzin::GenerateGrid(benzin::GridGeometryCreation
+        {
+            .Width = 1.0f,
+            .Depth = 1.0f,
+            .WidthPointCount = 8,
+            .DepthPointCount = 8,
+        }));
+
+        // Noise far below the epsilon, the copies of a vertex stay in the same cell
+        std::mt19937 randomEngine{ 3 };
+        std::uniform_real_distribution<float> noise{ -1e-6f, 1e-6f };
+        for (joint::MeshVertex& vertex : mesh.Vertices)
+        {
+            vertex.Position.x += noise(randomEngine);
+            vertex.Position.z += noise(randomEngine);
+        }
+
+        benzin::MeshData exactlyWeldedMesh = mesh;
+        BenzinCheck(benzin::WeldVertices(exactlyWeldedMesh).VertexCountAfter > 8 * 8);
+
+        const benzin::VertexWeldingStats stats = benzin::WeldVertices(mesh, 1e-3f);
+        BenzinCheck(stats.VertexCountAfter == 8 * 8);
+    }
+
+    BenzinTest(SubdividedGeometryHasNoDuplicateVertices)
+    {
+        for (uint32_t subdivisionCount = 0; subdivisionCount <= 3; ++subdivisionCount)
+        {
+            const uint32_t edgePointCount = (1 << subdivisionCount) + 1;
+
+            // Faces of the box don't share vertices because of different normals
+            benzin::MeshData box = benzin::GenerateBox(benzin::BoxGeometryCreation
+            {
+                .Width = 1.0f,
+                .Height = 2.0f,
+                .Depth = 3.0f,
+                .SubdivisionCount = subdivisionCount,
+            });
+            BenzinCheck(box.Vertices.size() == 6 * edgePointCount * edgePointCount);
+
+            // Subdivided icosahedron has '10 * 4^n + 2' vertices, UVs are computed after welding
+            benzin::MeshData geosphere = benzin::GenerateGeosphere(benzin::GeoSphereGeometryCreation
+            {
+                .Radius = 1.0f,
+                .SubdivisionCount = subdivisionCount,
+            });
+
+            const benzin::VertexWeldingStats boxStats = benzin::WeldVertices(box);
+            const benzin::VertexWeldingStats geosphereStats = benzin::WeldVertices(geosphere);
+            BenzinCheck(boxStats.VertexCountAfter == boxStats.VertexCountBefore);
+            BenzinCheck(geosphereStats.VertexCountAfter == geosphereStats.VertexCountBefore);
+            BenzinCheck(geosphere.Vertices.size() == 10 * (1u << 2 * subdivisionCount) + 2);
+        }
+    }
+
+} // namespace tests
@@ -0,0 +1,238 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/core/math.hpp>
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/mesh_optimizer.hpp>
+#include <benzin/engine/mesh_simplifier.hpp>
+#include <benzin/engine/resource_loader.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        constexpr uint32_t g_SeamGridCellCount = 16;
+        constexpr float g_SeamGridRightUvOffset = 10.0f;
+
+        // Slightly curved square grid in the XY plane, facing +Z. Its open border is the square outline.
+        // The middle column of vertices is duplicated with a UV offset, like a texture seam
+        benzin::MeshData GenerateSeamGrid()
+        {
+            const uint32_t pointCount = g_SeamGridCellCount + 1;
+            const uint32_t seamColumn = g_SeamGridCellCount / 2;
+
+            benzin::MeshData mesh;
+
+            const auto AddVertex = [&](uint32_t column, uint32_t row, float uvOffset)
+            {
+                const float x = (float)column;
+                const float y = (float)row;
+
+                mesh.Vertices.push_back(joint::MeshVertex
+                {
+                    .Position{ x, y, 0.01f * (x * x + y * y) / (float)g_SeamGridCellCount },
+                    .Normal{ 0.0f, 0.0f, 1.0f },
+                    .Uv{ x / (float)g_SeamGridCellCount + uvOffset, y / (float)g_SeamGridCellCount },
+                });
+
+                return (uint32_t)mesh.Vertices.size() - 1;
+            };
+
+            std::vector<uint32_t> leftVertexIndices(pointCount * pointCount, benzin::g_InvalidIndex<uint32_t>);
+            std::vector<uint32_t> rightVertexIndices(pointCount * pointCount, benzin::g_InvalidIndex<uint32_t>);
+
+            for (uint32_t row = 0; row < pointCount; ++row)
+            {
+                for (uint32_t column = 0; column < pointCount; ++column)
+                {
+                    if (column <= seamColumn)
+                    {
+                        leftVertexIndices[row * pointCount + column] = AddVertex(column, row, 0.0f);
+                    }
+
+                    if (column >= seamColumn)
+                    {
+                        rightVertexIndices[row * pointCount + column] = AddVertex(column, row, g_SeamGridRightUvOffset);
+                    }
+                }
+            }
+
+            for (uint32_t row = 0; row < g_SeamGridCellCount; ++row)
+            {
+                for (uint32_t column = 0; column < g_SeamGridCellCount; ++column)
+                {
+                    const auto& vertexIndices = column < seamColumn ? leftVertexIndices : rightVertexIndices;
+
+                    const uint32_t bottomLeft = vertexIndices[row * pointCount + column];
+                    const uint32_t bottomRight = vertexIndices[row * pointCount + column + 1];
+                    const uint32_t topLeft = vertexIndices[(row + 1) * pointCount + column];
+                    const uint32_t topRight = vertexIndices[(row + 1) * pointCount + column + 1];
+
+                    mesh.Indices.insert(mesh.Indices.end(), { bottomLeft, bottomRight, topRight });
+                    mesh.Indices.insert(mesh.Indices.end(), { bottomLeft, topRight, topLeft });
+                }
+            }
+
+            return mesh;
+        }
+
+        DirectX::XMVECTOR ComputeTriangleNormal(const benzin::MeshData& mesh, std::span<const uint32_t> indices, size_t indexOffset)
+        {
+            const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&mesh.Vertices[indices[indexOffset + 0]].Position);
+            const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&mesh.Vertices[indices[indexOffset + 1]].Position);
+            const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&mesh.Vertices[indices[indexOffset + 2]].Position);
+
+            return DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+        }
+
+        // Grid positions are integers, so they are packed exactly
+        uint32_t GetSeamGridPositionKey(const joint::MeshVertex& vertex)
+        {
+            return (uint32_t)vertex.Position.x << 16 | (uint32_t)vertex.Position.y;
+        }
+
+        bool IsOnSeamGridBorder(uint32_t positionKey)
+        {
+            const uint32_t x = positionKey >> 16;
+            const uint32_t y = positionKey & 0xffff;
+
+            return x == 0 || y == 0 || x == g_SeamGridCellCount || y == g_SeamGridCellCount;
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(SimplifyMeshKeepsBordersAndSeams)
+    {
+        const benzin::MeshData mesh = GenerateSeamGrid();
+
+        std::vector<uint32_t> indices;
+        benzin::SimplifyMesh(mesh.Vertices, mesh.Indices, mesh.Indices.size() / 4 / 3 * 3, 1.0f, indices);
+
+        BenzinCheck(!indices.empty() && indices.size() <= mesh.Indices.size() / 2);
+        BenzinCheck(indices.size() % 3 == 0);
+
+        std::unordered_map<uint32_t, uint32_t> positionUsageCounts;
+        std::unordered_map<uint64_t, uint32_t> edgeUsageCounts;
+
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            // Triangles don't mix vertices of different sides of the seam
+            const auto IsRightSide = [&](uint32_t corner) { return mesh.Vertices[indices[i + corner]].Uv.x >= g_SeamGridRightUvOffset; };
+            BenzinCheck(IsRightSide(0) == IsRightSide(1) && IsRightSide(1) == IsRightSide(2));
+
+            // The grid faces +Z, so a flipped triangle has a negative Z normal
+            BenzinCheck(DirectX::XMVectorGetZ(ComputeTriangleNormal(mesh, indices, i)) > 0.0f);
+
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t keyA = GetSeamGridPositionKey(mesh.Vertices[indices[i + corner]]);
+                const uint32_t keyB = GetSeamGridPositionKey(mesh.Vertices[indices[i + (corner + 1) % 3]]);
+
+                ++positionUsageCounts[keyA];
+                ++edgeUsageCounts[(uint64_t)std::min(keyA, keyB) << 32 | std::max(keyA, keyB)];
+            }
+        }
+
+        // Border positions are never removed
+        for (const joint::MeshVertex& vertex : mesh.Vertices)
+        {
+            const uint32_t positionKey = GetSeamGridPositionKey(vertex);
+            BenzinCheck(!IsOnSeamGridBorder(positionKey) || positionUsageCounts.contains(positionKey));
+        }
+
+        // Open edges are only on the square outline, so there are no cracks along the seam
+        for (const auto& [edgeKey, usageCount] : edgeUsageCounts)
+        {
+            BenzinCheck(usageCount <= 2);
+
+            if (usageCount == 1)
+            {
+                const auto keyA = (uint32_t)(edgeKey >> 32);
+                const auto keyB = (uint32_t)(edgeKey & 0xffff'ffff);
+                BenzinCheck(IsOnSeamGridBorder(keyA) && IsOnSeamGridBorder(keyB) && ((keyA >> 16) == (keyB >> 16) || (keyA & 0xffff) == (keyB & 0xffff)));
+            }
+        }
+
+        // Seam vertices slide along the seam instead of being locked
+        const auto seamPositionCount = std::ranges::count_if(positionUsageCounts | std::views::keys, [](uint32_t positionKey) { return positionKey >> 16 == g_SeamGridCellCount / 2; });
+        BenzinCheck(seamPositionCount < g_SeamGridCellCount + 1);
+    }
+
+    BenzinTest(GenerateMeshLodsErrorIsMonotonicAndBounded)
+    {
+        benzin::MeshData mesh = benzin::GenerateSphere(benzin::SphereGeometryCreation
+        {
+            .Radius = 2.0f,
+            .SliceCount = 64,
+            .StackCount = 64,
+        });
+        benzin::OptimizeMesh(mesh);
+
+        const benzin::MeshLodParams params;
+        benzin::GenerateMeshLods(mesh, params);
+
+        const DirectX::BoundingBox boundingBox = benzin::ComputeBoundingBox(mesh.Vertices);
+        const float maxError = params.MaxRelativeError * 2.0f * DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&boundingBox.Extents)));
+
+        BenzinCheck(mesh.Lods.size() >= 2);
+
+        for (uint32_t lodIndex = 1; lodIndex < mesh.GetLodCount(); ++lodIndex)
+        {
+            const std::span<const uint32_t> indices = mesh.GetLodIndices(lodIndex);
+            const float error = mesh.Lods[lodIndex - 1].Error;
+            const float previousError = lodIndex == 1 ? 0.0f : mesh.Lods[lodIndex - 2].Error;
+
+            BenzinCheck(!indices.empty() && indices.size() < mesh.GetLodIndices(lodIndex - 1).size());
+            BenzinCheck(error >= previousError);
+            BenzinCheck(error <= maxError);
+
+            // The sphere is centered at the origin, so an outward facing triangle has a positive dot product with its vertex positions
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                BenzinCheck(std::ranges::all_of(indices.subspan(i, 3), [&](uint32_t index) { return index < mesh.Vertices.size(); }));
+
+                const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&mesh.Vertices[indices[i]].Position);
+                BenzinCheck(DirectX::XMVectorGetX(DirectX::XMVector3Dot(ComputeTriangleNormal(mesh, indices, i), p0)) > 0.0f);
+            }
+        }
+
+        // Farther meshes never get a finer level
+        uint32_t previousLodIndex = 0;
+        for (float distance = 1.0f; distance < 10000.0f; distance *= 1.5f)
+        {
+            const uint32_t lodIndex = benzin::SelectMeshLod(mesh, distance, 1.0f, 1000.0f);
+            BenzinCheck(lodIndex >= previousLodIndex);
+
+            previousLodIndex = lodIndex;
+        }
+
+        BenzinCheck(previousLodIndex == mesh.Lods.size());
+    }
+
+    BenzinTest(SelectMeshLodFollowsErrorThresholds)
+    {
+        benzin::MeshData mesh;
+        BenzinCheck(benzin::SelectMeshLod(mesh, 1000.0f, 1.0f, 1000.0f) == 0);
+
+        mesh.Lods.push_back(benzin::MeshLod{ .Error = 0.01f });
+        mesh.Lods.push_back(benzin::MeshLod{ .Error = 0.1f });
+        mesh.Lods.push_back(benzin::MeshLod{ .Error = 1.0f });
+
+        // A level is allowed from the distance, where its error projects to 'maxPixelError' pixels: 'Error * pixelsPerUnit / maxPixelError'
+        BenzinCheck(benzin::SelectMeshLod(mesh, 9.0f, 1.0f, 1000.0f) == 0);
+        BenzinCheck(benzin::SelectMeshLod(mesh, 11.0f, 1.0f, 1000.0f) == 1);
+        BenzinCheck(benzin::SelectMeshLod(mesh, 99.0f, 1.0f, 1000.0f) == 1);
+        BenzinCheck(benzin::SelectMeshLod(mesh, 101.0f, 1.0f, 1000.0f) == 2);
+        BenzinCheck(benzin::SelectMeshLod(mesh, 999.0f, 1.0f, 1000.0f) == 2);
+        BenzinCheck(benzin::SelectMeshLod(mesh, 1001.0f, 1.0f, 1000.0f) == 3);
+
+        // Scaled up meshes switch later, a bigger pixel error lets them switch earlier
+        BenzinCheck(benzin::SelectMeshLod(mesh, 11.0f, 2.0f, 1000.0f) == 0);
+        BenzinCheck(benzin::SelectMeshLod(mesh, 21.0f, 2.0f, 1000.0f) == 1);
+        BenzinCheck(benzin::SelectMeshLod(mesh, 6.0f, 1.0f, 1000.0f, 2.0f) == 1);
+    }
+
+} // namespace tests
@@ -0,0 +1,167 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/mesh_optimizer.hpp>
+#include <benzin/engine/meshlet_builder.hpp>
+#include <benzin/engine/resource_loader.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        benzin::MeshData GenerateOptimizedSphere()
+        {
+            benzin::MeshData mesh = benzin::GenerateSphere(benzin::SphereGeometryCreation
+            {
+                .Radius = 2.0f,
+                .SliceCount = 48,
+                .StackCount = 48,
+            });
+            benzin::OptimizeMesh(mesh);
+
+            return mesh;
+        }
+
+        // Points outwards of a sphere centered at the origin
+        DirectX::XMVECTOR GetOuterTriangleNormal(const benzin::MeshData& mesh, size_t indexOffset)
+        {
+            const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&mesh.Vertices[mesh.Indices[indexOffset + 0]].Position);
+            const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&mesh.Vertices[mesh.Indices[indexOffset + 1]].Position);
+            const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&mesh.Vertices[mesh.Indices[indexOffset + 2]].Position);
+
+            const DirectX::XMVECTOR normal = DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+            return DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, p0)) < 0.0f ? DirectX::XMVectorNegate(normal) : normal;
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(BuildMeshletsRespectsLimits)
+    {
+        const benzin::MeshData sourceMesh = GenerateOptimizedSphere();
+        const auto triangleCount = (uint32_t)(sourceMesh.Indices.size() / 3);
+
+        const auto paramsList = std::to_array<benzin::MeshletBuildParams>(
+        {
+            {},
+            { .MaxVertexCount = 32, .MaxTriangleCount = 40 },
+            { .MaxVertexCount = 256, .MaxTriangleCount = 256 },
+            { .MaxVertexCount = 3, .MaxTriangleCount = 1 },
+        });
+
+        for (const benzin::MeshletBuildParams& params : paramsList)
+        {
+            benzin::MeshData mesh = sourceMesh;
+            benzin::BuildMeshlets(mesh, params);
+
+            BenzinCheck(!mesh.Meshlets.empty());
+            BenzinCheck(benzin::ValidateMeshlets(mesh, params));
+
+            uint32_t meshletTriangleCount = 0;
+            bool isWithinLimits = true;
+            bool isLocalIndexValid = true;
+
+            for (const joint::Meshlet& meshlet : mesh.Meshlets)
+            {
+                isWithinLimits &= meshlet.VertexCount <= params.MaxVertexCount && meshlet.TriangleCount <= params.MaxTriangleCount;
+                meshletTriangleCount += meshlet.TriangleCount;
+
+                for (uint32_t i = 0; i < meshlet.TriangleCount; ++i)
+                {
+                    const uint32_t packedTriangle = mesh.MeshletTriangles[meshlet.TriangleOffset + i];
+
+                    for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                    {
+                        isLocalIndexValid &= ((packedTriangle >> (cornerIndex * 8)) & 0xff) < meshlet.VertexCount;
+                    }
+                }
+            }
+
+            BenzinCheck(isWithinLimits);
+            BenzinCheck(isLocalIndexValid);
+            BenzinCheck(meshletTriangleCount == triangleCount);
+            BenzinCheck(mesh.Meshlets.size() >= (triangleCount - 1) / params.MaxTriangleCount + 1);
+        }
+    }
+
+    BenzinTest(BuildMeshletsSkipsNonTriangleLists)
+    {
+        benzin::MeshData mesh = GenerateOptimizedSphere();
+        mesh.PrimitiveTopology = benzin::PrimitiveTopology::LineList;
+
+        benzin::BuildMeshlets(mesh);
+
+        BenzinCheck(mesh.Meshlets.empty());
+        BenzinCheck(mesh.MeshletVertexIndices.empty());
+        BenzinCheck(mesh.MeshletTriangles.empty());
+    }
+
+    BenzinTest(MeshletConeOfFlatGridIsNarrow)
+    {
+        benzin::MeshData mesh = benzin::GenerateGrid(benzin::GridGeometryCreation
+        {
+            .Width = 4.0f,
+            .Depth = 4.0f,
+            .WidthPointCount = 33,
+            .DepthPointCount = 33,
+        });
+        benzin::BuildMeshlets(mesh);
+
+        BenzinCheck(benzin::ValidateMeshlets(mesh));
+
+        for (const joint::Meshlet& meshlet : mesh.Meshlets)
+        {
+            BenzinCheck(meshlet.ConeCutoff < 1e-3f);
+            BenzinCheck(meshlet.ConeAxis.y > 0.999f);
+        }
+    }
+
+    // A meshlet rejected by the cone test must have only back facing triangles for the camera, otherwise visible triangles are lost
+    BenzinTest(MeshletConeCullingIsConservative)
+    {
+        benzin::MeshData mesh = GenerateOptimizedSphere();
+        benzin::BuildMeshlets(mesh);
+
+        std::mt19937 randomEngine{ 4 };
+        std::uniform_real_distribution<float> coordinate{ -10.0f, 10.0f };
+
+        uint32_t culledMeshletCount = 0;
+        uint32_t visibleCulledTriangleCount = 0;
+
+        for (uint32_t cameraIndex = 0; cameraIndex < 64; ++cameraIndex)
+        {
+            const DirectX::XMVECTOR cameraPosition = DirectX::XMVectorSet(coordinate(randomEngine), coordinate(randomEngine), coordinate(randomEngine), 1.0f);
+
+            for (const joint::Meshlet& meshlet : mesh.Meshlets)
+            {
+                const DirectX::XMVECTOR apexDirection = DirectX::XMVector3Normalize(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&meshlet.ConeApex), cameraPosition));
+                if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(apexDirection, DirectX::XMLoadFloat3(&meshlet.ConeAxis))) < meshlet.ConeCutoff)
+                {
+                    continue;
+                }
+
+                ++culledMeshletCount;
+
+                // Triangles of the meshlet go in the order of mesh indices
+                const size_t firstIndexOffset = (size_t)meshlet.TriangleOffset * 3;
+                for (uint32_t i = 0; i < meshlet.TriangleCount; ++i)
+                {
+                    const size_t indexOffset = firstIndexOffset + i * 3;
+                    const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&mesh.Vertices[mesh.Indices[indexOffset]].Position);
+
+                    // The camera sees a triangle when it's on the outer side of its plane
+                    const float cameraDistance = DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMVectorSubtract(cameraPosition, p0), GetOuterTriangleNormal(mesh, indexOffset)));
+                    visibleCulledTriangleCount += cameraDistance > 1e-4f;
+                }
+            }
+        }
+
+        // About a half of the sphere faces away from every camera outside of it
+        BenzinCheck(culledMeshletCount > 0);
+        BenzinCheck(visibleCulledTriangleCount == 0);
+    }
+
+} // namespace tests
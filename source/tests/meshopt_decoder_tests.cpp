@@ -0,0 +1,440 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/meshopt_decoder.hpp>
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/utility/file_utils.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        // Streams from the 'meshoptimizer' test suite, encoded by 'meshopt_encodeIndexBuffer' and 'meshopt_encodeIndexSequence'
+        // Ref: https://github.com/zeux/meshoptimizer/blob/master/demo/tests.cpp
+
+        constexpr std::array<uint32_t, 12> g_IndexBuffer{ 0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9 };
+
+        constexpr std::array<uint8_t, 27> g_IndexDataV0
+        {
+            0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00, 0x76, 0x87, 0x56, 0x67,
+            0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00,
+        };
+
+        // Restarts and deltas from the last free index are only in version 1
+        constexpr std::array<uint32_t, 15> g_IndexBufferV1{ 0, 1, 2, 2, 1, 3, 0, 1, 2, 2, 1, 5, 2, 1, 4 };
+
+        constexpr std::array<uint8_t, 24> g_IndexDataV1
+        {
+            0xe1, 0xf0, 0x10, 0xfe, 0x1f, 0x3d, 0x00, 0x0a, 0x00, 0x76, 0x87, 0x56, 0x67, 0x78, 0xa9, 0x86,
+            0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00,
+        };
+
+        constexpr std::array<uint32_t, 6> g_IndexSequence{ 0, 1, 51, 2, 49, 1000 };
+
+        constexpr std::array<uint8_t, 13> g_IndexSequenceData
+        {
+            0xd1, 0x00, 0x04, 0xcd, 0x01, 0x04, 0x07, 0x98, 0x1f, 0x00, 0x00, 0x00, 0x00,
+        };
+
+        // Vertex codec v0 encoder, the same layout as 'meshopt_encodeVertexBuffer' writes.
+        // Every byte group uses the narrowest selectors, unless 'forcedBitsLog2' is set
+        class MeshoptVertexEncoder
+        {
+        public:
+            explicit MeshoptVertexEncoder(std::optional<uint32_t> forcedBitsLog2 = std::nullopt)
+                : m_ForcedBitsLog2{ forcedBitsLog2 }
+            {}
+
+        public:
+            std::vector<std::byte> Encode(std::span<const uint8_t> vertices, size_t vertexSize)
+            {
+                const size_t vertexCount = vertices.size() / vertexSize;
+
+                size_t blockSize = std::min<size_t>(8192 / vertexSize & ~15, 256);
+
+                m_Data.clear();
+                m_Data.push_back(0xa0);
+
+                std::vector<uint8_t> lastVertex{ vertices.begin(), vertices.begin() + vertexSize };
+                const std::vector<uint8_t> firstVertex = lastVertex;
+
+                for (size_t vertexOffset = 0; vertexOffset < vertexCount; vertexOffset += blockSize)
+                {
+                    const size_t blockVertexCount = std::min(blockSize, vertexCount - vertexOffset);
+                    const size_t alignedVertexCount = (blockVertexCount + 15) & ~15;
+
+                    for (size_t k = 0; k < vertexSize; ++k)
+                    {
+                        std::vector<uint8_t> deltas(alignedVertexCount, 0);
+
+                        uint8_t previous = lastVertex[k];
+                        for (size_t i = 0; i < blockVertexCount; ++i)
+                        {
+                            const uint8_t value = vertices[(vertexOffset + i) * vertexSize + k];
+                            const auto delta = (uint8_t)(value - previous);
+
+                            deltas[i] = (uint8_t)((delta << 1) ^ (uint8_t)((int8_t)delta >> 7));
+                            previous = value;
+                        }
+
+                        EncodeBytes(deltas);
+                    }
+
+                    std::memcpy(lastVertex.data(), &vertices[(vertexOffset + blockVertexCount - 1) * vertexSize], vertexSize);
+                }
+
+                // The tail holds the first vertex, which the first block is encoded against
+                const size_t tailSize = std::max<size_t>(vertexSize, 32);
+                m_Data.insert(m_Data.end(), tailSize - vertexSize, 0);
+                m_Data.insert(m_Data.end(), firstVertex.begin(), firstVertex.end());
+
+                const auto bytes = std::as_bytes(std::span{ m_Data });
+                return { bytes.begin(), bytes.end() };
+            }
+
+        private:
+            void EncodeBytes(std::span<const uint8_t> buffer)
+            {
+                const size_t groupCount = buffer.size() / 16;
+                const size_t headerOffset = m_Data.size();
+                m_Data.insert(m_Data.end(), (groupCount + 3) / 4, 0);
+
+                for (size_t groupIndex = 0; groupIndex < groupCount; ++groupIndex)
+                {
+                    const std::span<const uint8_t> group = buffer.subspan(groupIndex * 16, 16);
+
+                    uint32_t bestBitsLog2 = 3;
+                    size_t bestSize = 16;
+
+                    for (uint32_t bitsLog2 = 0; bitsLog2 < 3 && !m_ForcedBitsLog2; ++bitsLog2)
+                    {
+                        const size_t size = GetEncodedGroupSize(group, bitsLog2);
+                        if (size < bestSize)
+                        {
+                            bestBitsLog2 = bitsLog2;
+                            bestSize = size;
+                        }
+                    }
+
+                    if (m_ForcedBitsLog2 && (*m_ForcedBitsLog2 != 0 || std::ranges::all_of(group, [](uint8_t value) { return value == 0; })))
+                    {
+                        bestBitsLog2 = *m_ForcedBitsLog2;
+                    }
+
+                    m_Data[headerOffset + groupIndex / 4] |= (uint8_t)(bestBitsLog2 << (groupIndex % 4 * 2));
+                    EncodeGroup(group, bestBitsLog2);
+                }
+            }
+
+            static size_t GetEncodedGroupSize(std::span<const uint8_t> group, uint32_t bitsLog2)
+            {
+                if (bitsLog2 == 0)
+                {
+                    return std::ranges::all_of(group, [](uint8_t value) { return value == 0; }) ? 0 : std::numeric_limits<size_t>::max();
+                }
+
+                const uint32_t bits = 1u << bitsLog2;
+                const uint32_t escape = (1u << bits) - 1;
+
+                return 16 * bits / 8 + std::ranges::count_if(group, [&](uint8_t value) { return value >= escape; });
+            }
+
+            void EncodeGroup(std::span<const uint8_t> group, uint32_t bitsLog2)
+            {
+                if (bitsLog2 == 0)
+                {
+                    return;
+                }
+
+                if (bitsLog2 == 3)
+                {
+                    m_Data.insert(m_Data.end(), group.begin(), group.end());
+                    return;
+                }
+
+                const uint32_t bits = 1u << bitsLog2;
+                const uint32_t selectorsPerByte = 8 / bits;
+                const uint32_t escape = (1u << bits) - 1;
+
+                std::vector<uint8_t> escapedValues;
+
+                for (uint32_t i = 0; i < 16; i += selectorsPerByte)
+                {
+                    uint8_t packedSelectors = 0;
+
+                    for (uint32_t j = 0; j < selectorsPerByte; ++j)
+                    {
+                        const uint8_t value = group[i + j];
+                        const uint32_t selector = value >= escape ? escape : value;
+
+                        packedSelectors |= (uint8_t)(selector << (8 - bits * (j + 1)));
+
+                        if (value >= escape)
+                        {
+                            escapedValues.push_back(value);
+                        }
+                    }
+
+                    m_Data.push_back(packedSelectors);
+                }
+
+                m_Data.insert(m_Data.end(), escapedValues.begin(), escapedValues.end());
+            }
+
+        private:
+            std::optional<uint32_t> m_ForcedBitsLog2;
+            std::vector<uint8_t> m_Data;
+        };
+
+        // Smooth attributes with occasional jumps, so deltas need every selector width
+        std::vector<uint8_t> GenerateVertices(size_t vertexCount, size_t vertexSize, uint32_t seed)
+        {
+            std::mt19937 random{ seed };
+            std::uniform_int_distribution<uint32_t> jumpDistribution{ 0, 15 };
+            std::uniform_int_distribution<uint32_t> byteDistribution{ 0, 255 };
+
+            std::vector<uint8_t> vertices(vertexCount * vertexSize);
+
+            for (size_t i = 0; i < vertexCount; ++i)
+            {
+                for (size_t k = 0; k < vertexSize; ++k)
+                {
+                    const uint8_t previous = i == 0 ? 0 : vertices[(i - 1) * vertexSize + k];
+
+                    switch (k % 4)
+                    {
+                        case 0: vertices[i * vertexSize + k] = previous; break;
+                        case 1: vertices[i * vertexSize + k] = (uint8_t)(previous + 1); break;
+                        case 2: vertices[i * vertexSize + k] = (uint8_t)(previous + (jumpDistribution(random) == 0 ? 50 : 3)); break;
+                        case 3: vertices[i * vertexSize + k] = (uint8_t)byteDistribution(random); break;
+                    }
+                }
+            }
+
+            return vertices;
+        }
+
+        template <typename T>
+        std::vector<uint32_t> DecodeIndices(bool (*Decode)(std::span<std::byte>, size_t, size_t, std::span<const std::byte>), size_t indexCount, std::span<const uint8_t> data)
+        {
+            std::vector<T> indices(indexCount);
+            if (!Decode(std::as_writable_bytes(std::span{ indices }), indexCount, sizeof(T), std::as_bytes(data)))
+            {
+                return {};
+            }
+
+            return { indices.begin(), indices.end() };
+        }
+
+        // A buffer with the index sequence stream and a single compressed buffer view over it
+        std::string WriteMeshoptGltf(const std::filesystem::path& directoryPath, std::string_view fileName, std::string_view extensionFields)
+        {
+            benzin::WriteToFile(directoryPath / "sequence.bin", std::as_bytes(std::span{ g_IndexSequenceData }));
+
+            const std::string gltf = std::format(R"({{
+                "asset": {{ "version": "2.0" }},
+                "extensionsUsed": [ "EXT_meshopt_compression" ],
+                "scene": 0,
+                "scenes": [ {{ "nodes": [ 0 ] }} ],
+                "nodes": [ {{ "name": "Root" }} ],
+                "buffers": [ {{ "uri": "sequence.bin", "byteLength": {} }} ],
+                "bufferViews": [ {{
+                    "buffer": 0, "byteLength": 24,
+                    "extensions": {{ "EXT_meshopt_compression": {{ "byteLength": {}, {} }} }}
+                }} ]
+            }})", g_IndexSequenceData.size(), g_IndexSequenceData.size(), extensionFields);
+
+            const std::filesystem::path filePath = directoryPath / fileName;
+            benzin::WriteToFile(filePath, std::as_bytes(std::span{ gltf }));
+
+            return filePath.string();
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(MeshoptIndexStreamsDecodeToReference)
+    {
+        for (const auto Decode : { DecodeIndices<uint16_t>, DecodeIndices<uint32_t> })
+        {
+            BenzinCheck(std::ranges::equal(Decode(benzin::DecodeMeshoptIndexBuffer, g_IndexBuffer.size(), g_IndexDataV0), g_IndexBuffer));
+            BenzinCheck(std::ranges::equal(Decode(benzin::DecodeMeshoptIndexBuffer, g_IndexBufferV1.size(), g_IndexDataV1), g_IndexBufferV1));
+            BenzinCheck(std::ranges::equal(Decode(benzin::DecodeMeshoptIndexSequence, g_IndexSequence.size(), g_IndexSequenceData), g_IndexSequence));
+        }
+    }
+
+    BenzinTest(MeshoptVertexBufferRoundTripsWithEveryKernel)
+    {
+        const std::vector<benzin::MeshoptDecodingKernel> kernels = benzin::GetWidestMeshoptDecodingKernel() == benzin::MeshoptDecodingKernel::Ssse3
+            ? std::vector{ benzin::MeshoptDecodingKernel::Scalar, benzin::MeshoptDecodingKernel::Ssse3 }
+            : std::vector{ benzin::MeshoptDecodingKernel::Scalar };
+
+        // A single vertex, a partial byte group, several blocks and the largest vertex
+        const std::array<std::pair<size_t, size_t>, 5> sizes{ { { 1, 4 }, { 13, 8 }, { 1000, 16 }, { 777, 48 }, { 70, 256 } } };
+
+        for (const auto [vertexCount, vertexSize] : sizes)
+        {
+            const std::vector<uint8_t> vertices = GenerateVertices(vertexCount, vertexSize, (uint32_t)(vertexCount + vertexSize));
+
+            for (const std::optional<uint32_t> forcedBitsLog2 : { std::optional<uint32_t>{}, std::optional<uint32_t>{ 1 }, std::optional<uint32_t>{ 2 }, std::optional<uint32_t>{ 3 } })
+            {
+                const std::vector<std::byte> encoded = MeshoptVertexEncoder{ forcedBitsLog2 }.Encode(vertices, vertexSize);
+
+                for (const benzin::MeshoptDecodingKernel kernel : kernels)
+                {
+                    std::vector<uint8_t> decoded(vertices.size());
+                    BenzinCheck(benzin::DecodeMeshoptVertexBuffer(std::as_writable_bytes(std::span{ decoded }), vertexCount, vertexSize, encoded, kernel));
+                    BenzinCheck(decoded == vertices);
+                }
+            }
+        }
+    }
+
+    BenzinTest(MeshoptTruncatedStreamsAreRejected)
+    {
+        const size_t vertexCount = 300;
+        const size_t vertexSize = 12;
+
+        const std::vector<uint8_t> vertices = GenerateVertices(vertexCount, vertexSize, 7);
+        const std::vector<std::byte> encoded = MeshoptVertexEncoder{}.Encode(vertices, vertexSize);
+
+        std::vector<std::byte> decoded(vertices.size());
+        std::array<std::byte, 15 * 4> indices;
+
+        // Decoders never read past the source, so sanitizers catch a missing bound check here
+        for (size_t size = 0; size < encoded.size(); ++size)
+        {
+            const std::vector<std::byte> truncated{ encoded.begin(), encoded.begin() + size };
+            BenzinCheck(!benzin::DecodeMeshoptVertexBuffer(decoded, vertexCount, vertexSize, truncated, benzin::MeshoptDecodingKernel::Scalar));
+            BenzinCheck(!benzin::DecodeMeshoptVertexBuffer(decoded, vertexCount, vertexSize, truncated));
+        }
+
+        for (size_t size = 0; size < g_IndexDataV1.size(); ++size)
+        {
+            const std::vector<uint8_t> truncated{ g_IndexDataV1.begin(), g_IndexDataV1.begin() + size };
+            BenzinCheck(!benzin::DecodeMeshoptIndexBuffer(indices, g_IndexBufferV1.size(), 4, std::as_bytes(std::span{ truncated })));
+        }
+
+        for (size_t size = 0; size < g_IndexSequenceData.size(); ++size)
+        {
+            const std::vector<uint8_t> truncated{ g_IndexSequenceData.begin(), g_IndexSequenceData.begin() + size };
+            BenzinCheck(!benzin::DecodeMeshoptIndexSequence(indices, g_IndexSequence.size(), 4, std::as_bytes(std::span{ truncated })));
+        }
+
+        // Sizes the format doesn't allow
+        BenzinCheck(!benzin::DecodeMeshoptVertexBuffer(decoded, vertexCount / 2, 6, encoded));
+        BenzinCheck(!benzin::DecodeMeshoptIndexBuffer(indices, 14, 4, std::as_bytes(std::span{ g_IndexDataV1 })));
+        BenzinCheck(!benzin::DecodeMeshoptIndexBuffer(indices, 15, 1, std::as_bytes(std::span{ g_IndexDataV1 })));
+        BenzinCheck(!benzin::DecodeMeshoptIndexBuffer(std::span{ indices }.first(15 * 2 - 1), 15, 2, std::as_bytes(std::span{ g_IndexDataV1 })));
+    }
+
+    BenzinTest(MeshoptFiltersDecodeEncodedValues)
+    {
+        // Octahedral: 'meshopt_encodeFilterOct' layout, the third component stores 1.0
+        const std::array<DirectX::XMFLOAT3, 6> directions{ { { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.6f, -0.8f, 0.0f }, { 0.48f, 0.6f, -0.64f }, { -0.36f, 0.48f, 0.8f } } };
+
+        std::vector<int16_t> octahedral;
+        for (const DirectX::XMFLOAT3& direction : directions)
+        {
+            const float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+            const float x = direction.x / length;
+            const float y = direction.y / length;
+
+            const float u = direction.z >= 0.0f ? x : (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float v = direction.z >= 0.0f ? y : (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+            octahedral.insert(octahedral.end(), { (int16_t)std::lround(u * 32767.0f), (int16_t)std::lround(v * 32767.0f), 32767, 0 });
+        }
+
+        BenzinCheck(benzin::ApplyMeshoptFilter(benzin::MeshoptCompressionFilter::Octahedral, std::as_writable_bytes(std::span{ octahedral }), directions.size(), 8));
+
+        for (const auto& [i, direction] : directions | std::views::enumerate)
+        {
+            BenzinCheck(std::abs(octahedral[i * 4 + 0] - direction.x * 32767.0f) <= 4.0f);
+            BenzinCheck(std::abs(octahedral[i * 4 + 1] - direction.y * 32767.0f) <= 4.0f);
+            BenzinCheck(std::abs(octahedral[i * 4 + 2] - direction.z * 32767.0f) <= 4.0f);
+        }
+
+        // Quaternion: 'meshopt_encodeFilterQuat' layout, the largest component is dropped and its index is in the low bits
+        const DirectX::XMFLOAT4 rotation{ 0.1f, -0.7f, 0.5f, 0.5f };
+        const std::array<float, 4> components{ rotation.x, rotation.y, rotation.z, rotation.w };
+
+        const uint32_t maxComponentIndex = 1;
+        const float sign = components[maxComponentIndex] < 0.0f ? -1.0f : 1.0f;
+
+        std::array<int16_t, 4> quaternion;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            quaternion[i] = (int16_t)std::lround(components[(maxComponentIndex + 1 + i) & 3] * std::numbers::sqrt2_v<float> * sign * 32767.0f);
+        }
+        quaternion[3] = (int16_t)((32767 & ~3) | maxComponentIndex);
+
+        BenzinCheck(benzin::ApplyMeshoptFilter(benzin::MeshoptCompressionFilter::Quaternion, std::as_writable_bytes(std::span{ quaternion }), 1, 8));
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            BenzinCheck(std::abs(quaternion[i] - components[i] * sign * 32767.0f) <= 4.0f);
+        }
+
+        // Exponential: 24 bit mantissa and 8 bit exponent
+        const auto EncodeExponential = [](int32_t mantissa, int32_t exponent) { return (uint32_t)(mantissa & 0xff'ffff) | (uint32_t)exponent << 24; };
+
+        std::array<uint32_t, 4> exponential{ EncodeExponential(3, -1), EncodeExponential(-5, 2), EncodeExponential(0x7f'ffff, 0), EncodeExponential(0, 10) };
+        BenzinCheck(benzin::ApplyMeshoptFilter(benzin::MeshoptCompressionFilter::Exponential, std::as_writable_bytes(std::span{ exponential }), 2, 8));
+
+        BenzinCheck(std::bit_cast<float>(exponential[0]) == 1.5f);
+        BenzinCheck(std::bit_cast<float>(exponential[1]) == -20.0f);
+        BenzinCheck(std::bit_cast<float>(exponential[2]) == 8388607.0f);
+        BenzinCheck(std::bit_cast<float>(exponential[3]) == 0.0f);
+
+        // Filters are only defined for some strides
+        BenzinCheck(!benzin::ApplyMeshoptFilter(benzin::MeshoptCompressionFilter::Octahedral, std::as_writable_bytes(std::span{ exponential }), 1, 12));
+        BenzinCheck(!benzin::ApplyMeshoptFilter(benzin::MeshoptCompressionFilter::Quaternion, std::as_writable_bytes(std::span{ exponential }), 1, 4));
+    }
+
+    BenzinTest(MeshoptBufferViewFieldsAreValidated)
+    {
+        const std::filesystem::path directoryPath = std::filesystem::temp_directory_path() / "benzin_tests_meshopt_fields";
+        std::filesystem::create_directories(directoryPath);
+
+        const auto Load = [&](std::string_view extensionFields)
+        {
+            benzin::MeshCollectionResource meshCollection;
+            return benzin::LoadMeshCollectionFromGltfFile(WriteMeshoptGltf(directoryPath, "model.gltf", extensionFields), meshCollection);
+        };
+
+        BenzinCheck(Load(R"("buffer": 0, "byteStride": 4, "count": 6, "mode": "INDICES")"));
+        BenzinCheck(Load(R"("buffer": 0, "byteStride": 2, "count": 6, "mode": "INDICES")"));
+
+        // Index strides are 2 or 4
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 8, "count": 6, "mode": "INDICES")"));
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 1, "count": 6, "mode": "INDICES")"));
+
+        // Attribute strides are multiples of 4 in 4..256
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 6, "count": 1, "mode": "ATTRIBUTES")"));
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 260, "count": 1, "mode": "ATTRIBUTES")"));
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 0, "count": 1, "mode": "ATTRIBUTES")"));
+
+        // Triangle counts are multiples of 3
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 4, "count": 4, "mode": "TRIANGLES")"));
+
+        // Filters only apply to attributes with the sizes they are defined for
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 4, "count": 6, "mode": "INDICES", "filter": "EXPONENTIAL")"));
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 12, "count": 1, "mode": "ATTRIBUTES", "filter": "OCTAHEDRAL")"));
+        BenzinCheck(!Load(R"("buffer": 0, "byteStride": 4, "count": 1, "mode": "ATTRIBUTES", "filter": "QUATERNION")"));
+
+        // The buffer exists and the compressed range is inside of it
+        BenzinCheck(!Load(R"("buffer": 1, "byteStride": 4, "count": 6, "mode": "INDICES")"));
+        BenzinCheck(!Load(R"("buffer": -1, "byteStride": 4, "count": 6, "mode": "INDICES")"));
+        BenzinCheck(!Load(R"("byteStride": 4, "count": 6, "mode": "INDICES")"));
+        BenzinCheck(!Load(R"("buffer": 0, "byteOffset": 1, "byteStride": 4, "count": 6, "mode": "INDICES")"));
+
+        // A failed load doesn't affect the next one
+        BenzinCheck(Load(R"("buffer": 0, "byteStride": 4, "count": 6, "mode": "INDICES")"));
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+} // namespace tests
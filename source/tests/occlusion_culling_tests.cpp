@@ -0,0 +1,288 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/core/math.hpp>
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/occlusion_culling.hpp>
+#include <benzin/engine/resource_loader.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        struct ReferenceVertex
+        {
+            double X = 0.0;
+            double Y = 0.0;
+            double Z = 0.0;
+            double W = 0.0;
+        };
+
+        ReferenceVertex ToReferenceVertex(const DirectX::XMFLOAT3& position, const DirectX::XMMATRIX& transform, uint32_t width, uint32_t height)
+        {
+            DirectX::XMFLOAT4 clipVertex;
+            DirectX::XMStoreFloat4(&clipVertex, DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&position), transform));
+
+            const double inverseW = 1.0 / (double)clipVertex.w;
+
+            return ReferenceVertex
+            {
+                .X = ((double)clipVertex.x * inverseW * 0.5 + 0.5) * width,
+                .Y = (0.5 - (double)clipVertex.y * inverseW * 0.5) * height,
+                .Z = (double)clipVertex.z * inverseW,
+                .W = (double)clipVertex.w,
+            };
+        }
+
+        // Nearest depth of occluders at every pixel center in double precision. Occluders are in front of the near plane,
+        // so triangles aren't clipped. Coverage is slightly widened, it can only hide more than the culler
+        std::vector<double> RasterizeReferenceDepths(std::span<const benzin::Occluder> occluders, const DirectX::XMMATRIX& viewProjection, uint32_t width, uint32_t height)
+        {
+            std::vector<double> depths((size_t)width * height, 1.0);
+
+            for (const benzin::Occluder& occluder : occluders)
+            {
+                const DirectX::XMMATRIX transform = occluder.WorldMatrix * viewProjection;
+
+                for (size_t i = 0; i < occluder.Indices.size(); i += 3)
+                {
+                    std::array<ReferenceVertex, 3> v;
+                    for (uint32_t j = 0; j < 3; ++j)
+                    {
+                        v[j] = ToReferenceVertex(occluder.Vertices[occluder.Indices[i + j]].Position, transform, width, height);
+                    }
+
+                    BenzinCheck(v[0].W > 0.0 && v[1].W > 0.0 && v[2].W > 0.0);
+
+                    const double area = (v[1].X - v[0].X) * (v[2].Y - v[0].Y) - (v[2].X - v[0].X) * (v[1].Y - v[0].Y);
+                    if (std::abs(area) < 1e-9)
+                    {
+                        continue;
+                    }
+
+                    for (uint32_t y = 0; y < height; ++y)
+                    {
+                        for (uint32_t x = 0; x < width; ++x)
+                        {
+                            const double px = x + 0.5;
+                            const double py = y + 0.5;
+
+                            std::array<double, 3> weights;
+                            for (uint32_t j = 0; j < 3; ++j)
+                            {
+                                const ReferenceVertex& a = v[(j + 1) % 3];
+                                const ReferenceVertex& b = v[(j + 2) % 3];
+
+                                weights[j] = ((b.X - a.X) * (py - a.Y) - (px - a.X) * (b.Y - a.Y)) / area;
+                            }
+
+                            if (weights[0] < -1e-4 || weights[1] < -1e-4 || weights[2] < -1e-4)
+                            {
+                                continue;
+                            }
+
+                            double& depth = depths[(size_t)y * width + x];
+                            depth = std::min(depth, weights[0] * v[0].Z + weights[1] * v[1].Z + weights[2] * v[2].Z);
+                        }
+                    }
+                }
+            }
+
+            return depths;
+        }
+
+        enum class ReferenceVisibility : uint8_t
+        {
+            NoPixelCenters, // The box covers no pixel center on the screen or crosses the near plane
+            Visible,
+            Occluded,
+        };
+
+        // The box is visible if a pixel center inside of its screen rectangle has a farther occluder depth than the nearest box corner
+        ReferenceVisibility GetReferenceVisibility(const benzin::Aabb& aabb, const DirectX::XMMATRIX& viewProjection, std::span<const double> depths, uint32_t width, uint32_t height)
+        {
+            double minX = std::numeric_limits<double>::max();
+            double minY = std::numeric_limits<double>::max();
+            double maxX = std::numeric_limits<double>::lowest();
+            double maxY = std::numeric_limits<double>::lowest();
+            double minDepth = std::numeric_limits<double>::max();
+
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                const DirectX::XMFLOAT3 corner
+                {
+                    (i & 0b001) != 0 ? aabb.Max.x : aabb.Min.x,
+                    (i & 0b010) != 0 ? aabb.Max.y : aabb.Min.y,
+                    (i & 0b100) != 0 ? aabb.Max.z : aabb.Min.z,
+                };
+
+                const ReferenceVertex vertex = ToReferenceVertex(corner, viewProjection, width, height);
+                if (vertex.Z < 0.0)
+                {
+                    return ReferenceVisibility::NoPixelCenters;
+                }
+
+                minX = std::min(minX, vertex.X);
+                minY = std::min(minY, vertex.Y);
+                maxX = std::max(maxX, vertex.X);
+                maxY = std::max(maxY, vertex.Y);
+                minDepth = std::min(minDepth, vertex.Z);
+            }
+
+            const auto firstX = (int64_t)std::max(std::ceil(minX - 0.5), 0.0);
+            const auto firstY = (int64_t)std::max(std::ceil(minY - 0.5), 0.0);
+            const auto lastX = (int64_t)std::min(std::floor(maxX - 0.5), (double)width - 1.0);
+            const auto lastY = (int64_t)std::min(std::floor(maxY - 0.5), (double)height - 1.0);
+
+            if (firstX > lastX || firstY > lastY)
+            {
+                return ReferenceVisibility::NoPixelCenters;
+            }
+
+            for (int64_t y = firstY; y <= lastY; ++y)
+            {
+                for (int64_t x = firstX; x <= lastX; ++x)
+                {
+                    if (depths[(size_t)y * width + x] > minDepth + 1e-5)
+                    {
+                        return ReferenceVisibility::Visible;
+                    }
+                }
+            }
+
+            return ReferenceVisibility::Occluded;
+        }
+
+        benzin::Aabb GetWorldAabb(const benzin::MeshData& mesh, const DirectX::XMMATRIX& worldMatrix)
+        {
+            DirectX::BoundingBox boundingBox;
+            DirectX::BoundingBox::CreateFromPoints(boundingBox, mesh.Vertices.size(), &mesh.Vertices[0].Position, sizeof(joint::MeshVertex));
+
+            return benzin::ToAabb(benzin::TransformBoundingBox(boundingBox, worldMatrix));
+        }
+
+    } // anonymous namespace
+
+    // The culler samples depths at pixel centers like the hardware rasterizer, so it's conservative only there: a box it reports
+    // as occluded must not have a pixel center inside of its screen rectangle where a double precision reference sees it
+    BenzinTest(OcclusionCullingIsConservativeAtPixelCenters)
+    {
+        std::mt19937 randomEngine{ 25 };
+        std::uniform_real_distribution<float> occluderSize{ 4.0f, 14.0f };
+        std::uniform_real_distribution<float> occluderDepth{ 0.5f, 3.0f };
+        std::uniform_real_distribution<float> occluderCenter{ -14.0f, 14.0f };
+        std::uniform_real_distribution<float> occluderZ{ -30.0f, -10.0f };
+        std::uniform_real_distribution<float> angle{ -0.6f, 0.6f };
+        std::uniform_real_distribution<float> boxCenter{ -40.0f, 40.0f };
+        std::uniform_real_distribution<float> boxZ{ -35.0f, 80.0f };
+        std::uniform_real_distribution<float> boxExtent{ 0.1f, 3.0f };
+        std::uniform_real_distribution<float> eyeOffset{ -10.0f, 10.0f };
+
+        const benzin::OcclusionCullerCreation creation;
+
+        std::vector<benzin::MeshData> occluderMeshes;
+        std::vector<benzin::Occluder> occluders;
+
+        for (uint32_t i = 0; i < 12; ++i)
+        {
+            occluderMeshes.push_back(benzin::GenerateBox(benzin::BoxGeometryCreation{ .Width = occluderSize(randomEngine), .Height = occluderSize(randomEngine), .Depth = occluderDepth(randomEngine) }));
+        }
+
+        for (const benzin::MeshData& mesh : occluderMeshes)
+        {
+            const DirectX::XMMATRIX worldMatrix =
+                DirectX::XMMatrixRotationX(angle(randomEngine)) *
+                DirectX::XMMatrixRotationY(angle(randomEngine)) *
+                DirectX::XMMatrixTranslation(occluderCenter(randomEngine), occluderCenter(randomEngine), occluderZ(randomEngine));
+
+            occluders.push_back(benzin::Occluder
+            {
+                .Vertices = mesh.Vertices,
+                .Indices = mesh.Indices,
+                .WorldMatrix = worldMatrix,
+                .WorldAabb = GetWorldAabb(mesh, worldMatrix),
+            });
+        }
+
+        benzin::OcclusionCuller occlusionCuller{ creation };
+
+        uint32_t violationCount = 0;
+        uint32_t occludedCount = 0;
+        uint32_t referenceOccludedCount = 0;
+
+        for (uint32_t viewIndex = 0; viewIndex < 4; ++viewIndex)
+        {
+            const DirectX::XMVECTOR eye = DirectX::XMVectorSet(eyeOffset(randomEngine), eyeOffset(randomEngine), -60.0f, 1.0f);
+            const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(eye, DirectX::XMVectorZero(), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            const DirectX::XMMATRIX projection = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PI / 3.0f, (float)creation.Width / (float)creation.Height, 0.5f, 200.0f);
+            const DirectX::XMMATRIX viewProjection = view * projection;
+
+            occlusionCuller.Render(viewProjection, occluders);
+            BenzinCheck(occlusionCuller.GetStats().OccluderCount == occluders.size());
+
+            const std::vector<double> referenceDepths = RasterizeReferenceDepths(occluders, viewProjection, creation.Width, creation.Height);
+
+            for (uint32_t i = 0; i < 5000; ++i)
+            {
+                const benzin::Aabb aabb = benzin::ToAabb(DirectX::BoundingBox
+                {
+                    { boxCenter(randomEngine), boxCenter(randomEngine), boxZ(randomEngine) },
+                    { boxExtent(randomEngine), boxExtent(randomEngine), boxExtent(randomEngine) },
+                });
+
+                const bool isOccluded = occlusionCuller.IsOccluded(aabb);
+                const ReferenceVisibility referenceVisibility = GetReferenceVisibility(aabb, viewProjection, referenceDepths, creation.Width, creation.Height);
+
+                violationCount += isOccluded && referenceVisibility == ReferenceVisibility::Visible ? 1 : 0;
+                occludedCount += isOccluded && referenceVisibility == ReferenceVisibility::Occluded ? 1 : 0;
+                referenceOccludedCount += referenceVisibility == ReferenceVisibility::Occluded ? 1 : 0;
+            }
+        }
+
+        BenzinCheck(violationCount == 0);
+
+        // The max depth pyramid and rectangles rounded out to whole texels lose some of the boxes, but not most of them
+        BenzinCheck(referenceOccludedCount != 0);
+        BenzinCheck(occludedCount * 2 >= referenceOccludedCount);
+    }
+
+    // Orthographic with a world unit per pixel. Two walls leave a gap between pixel centers, a box behind the gap is visible
+    BenzinTest(ConservativeCoverageKeepsObjectsSeenThroughSubpixelGaps)
+    {
+        const benzin::MeshData leftWallMesh = benzin::GenerateBox(benzin::BoxGeometryCreation{ .Width = 100.0f, .Height = 100.0f, .Depth = 1.0f });
+        const benzin::MeshData rightWallMesh = benzin::GenerateBox(benzin::BoxGeometryCreation{ .Width = 60.0f, .Height = 100.0f, .Depth = 1.0f });
+
+        // Screen 'x' is world 'x' plus 160, the gap is [170.6, 171.4] and contains no pixel center
+        const DirectX::XMMATRIX leftWallMatrix = DirectX::XMMatrixTranslation(10.6f - 50.0f, 0.0f, 10.0f);
+        const DirectX::XMMATRIX rightWallMatrix = DirectX::XMMatrixTranslation(11.4f + 30.0f, 0.0f, 10.0f);
+
+        const std::array occluders
+        {
+            benzin::Occluder{ .Vertices = leftWallMesh.Vertices, .Indices = leftWallMesh.Indices, .WorldMatrix = leftWallMatrix, .WorldAabb = GetWorldAabb(leftWallMesh, leftWallMatrix) },
+            benzin::Occluder{ .Vertices = rightWallMesh.Vertices, .Indices = rightWallMesh.Indices, .WorldMatrix = rightWallMatrix, .WorldAabb = GetWorldAabb(rightWallMesh, rightWallMatrix) },
+        };
+
+        const DirectX::XMMATRIX viewProjection = DirectX::XMMatrixOrthographicLH(320.0f, 192.0f, 0.5f, 200.0f);
+
+        const auto behindGapAabb = benzin::ToAabb(DirectX::BoundingBox{ { 11.0f, 10.0f, 50.0f }, { 0.2f, 0.2f, 0.2f } });
+
+        // Away from the diagonals of the front face, which conservative coverage leaves uncovered
+        const auto behindWallAabb = benzin::ToAabb(DirectX::BoundingBox{ { -40.0f, 35.0f, 50.0f }, { 2.0f, 2.0f, 2.0f } });
+
+        benzin::OcclusionCuller pixelCenterCuller;
+        pixelCenterCuller.Render(viewProjection, occluders);
+
+        BenzinCheck(pixelCenterCuller.IsOccluded(behindWallAabb));
+        BenzinCheck(pixelCenterCuller.IsOccluded(behindGapAabb));
+
+        benzin::OcclusionCuller conservativeCuller{ benzin::OcclusionCullerCreation{ .IsCoverageConservative = true } };
+        conservativeCuller.Render(viewProjection, occluders);
+
+        BenzinCheck(conservativeCuller.IsOccluded(behindWallAabb));
+        BenzinCheck(!conservativeCuller.IsOccluded(behindGapAabb));
+    }
+
+} // namespace tests
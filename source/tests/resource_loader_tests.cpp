@@ -0,0 +1,387 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/utility/file_utils.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        // Four textures over two images, the first image is shared by the albedo, emissive and metallic roughness textures.
+        // Images are binary PPMs, which 'stb_image' decodes without an encoder on the test side
+        std::filesystem::path WriteTexturedGltf(std::string_view directoryName)
+        {
+            const std::filesystem::path directoryPath = std::filesystem::temp_directory_path() / std::format("benzin_tests_{}", directoryName);
+            std::filesystem::create_directories(directoryPath);
+
+            const auto WriteTextFile = [&](std::string_view fileName, std::string_view text)
+            {
+                benzin::WriteToFile(directoryPath / fileName, std::as_bytes(std::span{ text }));
+            };
+
+            const auto WritePpmFile = [&](std::string_view fileName, uint32_t width, uint32_t height, uint8_t seed)
+            {
+                std::string ppm = std::format("P6\n{} {}\n255\n", width, height);
+                for (uint32_t i = 0; i < width * height * 3; ++i)
+                {
+                    ppm.push_back((char)(uint8_t)(seed + i * 37));
+                }
+
+                WriteTextFile(fileName, ppm);
+            };
+
+            WritePpmFile("albedo.ppm", 8, 4, 11);
+            WritePpmFile("normal.ppm", 4, 4, 97);
+
+            WriteTextFile("model.gltf", R"({
+                "asset": { "version": "2.0" },
+                "scene": 0,
+                "scenes": [ { "nodes": [ 0 ] } ],
+                "nodes": [ { "name": "Root" } ],
+                "images": [ { "uri": "albedo.ppm" }, { "uri": "normal.ppm" } ],
+                "textures": [ { "source": 0 }, { "source": 1 }, { "source": 0 }, { "source": 0 } ],
+                "materials": [ {
+                    "pbrMetallicRoughness": { "baseColorTexture": { "index": 0 }, "metallicRoughnessTexture": { "index": 3 } },
+                    "normalTexture": { "index": 1 },
+                    "emissiveTexture": { "index": 2 }
+                } ]
+            })");
+
+            return directoryPath;
+        }
+
+        // A quad in a binary buffer, written as '.gltf' with an external '.bin' and as '.glb' with the same buffer in its BIN chunk.
+        // 'nodesJson' gives scenes and nodes, which draw mesh 0
+        std::filesystem::path WriteQuadGltfAndGlb(std::string_view directoryName, std::string_view nodesJson = R"("scenes": [ { "nodes": [ 0 ] } ], "nodes": [ { "mesh": 0 } ])")
+        {
+            const std::filesystem::path directoryPath = std::filesystem::temp_directory_path() / std::format("benzin_tests_{}", directoryName);
+            std::filesystem::create_directories(directoryPath);
+
+            const std::array<float, 12> positions{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+            const std::array<uint16_t, 6> indices{ 0, 1, 2, 0, 2, 3 };
+
+            std::vector<std::byte> buffer;
+            buffer.append_range(std::as_bytes(std::span{ positions }));
+            buffer.append_range(std::as_bytes(std::span{ indices }));
+
+            const auto GetJson = [&](std::string_view bufferUri)
+            {
+                return std::format(R"({{
+                    "asset": {{ "version": "2.0" }},
+                    "scene": 0,
+                    {},
+                    "meshes": [ {{ "primitives": [ {{ "attributes": {{ "POSITION": 0 }}, "indices": 1, "material": 0 }} ] }} ],
+                    "materials": [ {{ "name": "Quad" }} ],
+                    "buffers": [ {{ {}"byteLength": {} }} ],
+                    "bufferViews": [ {{ "buffer": 0, "byteLength": 48 }}, {{ "buffer": 0, "byteOffset": 48, "byteLength": 12 }} ],
+                    "accessors": [
+                        {{ "bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3", "min": [ 0, 0, 0 ], "max": [ 1, 1, 0 ] }},
+                        {{ "bufferView": 1, "componentType": 5123, "count": 6, "type": "SCALAR" }}
+                    ]
+                }})", nodesJson, bufferUri, buffer.size());
+            };
+
+            const std::string gltfJson = GetJson(R"("uri": "quad.bin", )");
+            benzin::WriteToFile(directoryPath / "quad.gltf", std::as_bytes(std::span{ gltfJson }));
+            benzin::WriteToFile(directoryPath / "quad.bin", buffer);
+
+            // GLB chunks are 4 byte aligned, JSON is padded with spaces and the binary chunk with zeros
+            std::string glbJson = GetJson("");
+            glbJson.resize(benzin::AlignAbove(glbJson.size(), 4), ' ');
+
+            std::vector<std::byte> binaryChunk = buffer;
+            binaryChunk.resize(benzin::AlignAbove(binaryChunk.size(), 4), std::byte{ 0 });
+
+            const auto AppendUint32 = [](std::vector<std::byte>& data, uint32_t value) { data.append_range(std::as_bytes(std::span{ &value, 1 })); };
+
+            std::vector<std::byte> glb;
+            AppendUint32(glb, 0x46546c67); // "glTF"
+            AppendUint32(glb, 2);
+            AppendUint32(glb, (uint32_t)(12 + 8 + glbJson.size() + 8 + binaryChunk.size()));
+            AppendUint32(glb, (uint32_t)glbJson.size());
+            AppendUint32(glb, 0x4e4f534a); // "JSON"
+            glb.append_range(std::as_bytes(std::span{ glbJson }));
+            AppendUint32(glb, (uint32_t)binaryChunk.size());
+            AppendUint32(glb, 0x004e4942); // "BIN"
+            glb.append_range(binaryChunk);
+
+            benzin::WriteToFile(directoryPath / "quad.glb", glb);
+
+            return directoryPath;
+        }
+
+        const benzin::TextureImage& GetTextureImage(const benzin::MeshCollectionResource& meshCollection, uint32_t textureIndex)
+        {
+            BenzinAssert(textureIndex < meshCollection.TextureImages.size());
+            return meshCollection.TextureImages[textureIndex];
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(DecodedTexturesKeepDecoderOutputWithoutCopying)
+    {
+        const std::filesystem::path directoryPath = WriteTexturedGltf("decoded_textures");
+        const std::string gltfFilePath = (directoryPath / "model.gltf").string();
+
+        benzin::MeshCollectionResource meshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, meshCollection));
+
+        benzin::MeshCollectionResource deferredMeshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, deferredMeshCollection, benzin::MeshCollectionLoadingFlag::DeferImageDecoding));
+
+        BenzinCheck(meshCollection.TextureImages.size() == 4);
+        BenzinCheck(deferredMeshCollection.TextureImages.size() == 4);
+        BenzinCheck(meshCollection.Materials.size() == 1);
+
+        const benzin::Material& material = meshCollection.Materials[0];
+
+        for (const benzin::MeshCollectionResource* collection : { &meshCollection, &deferredMeshCollection })
+        {
+            const benzin::TextureImage& albedo = GetTextureImage(*collection, material.AlbedoTextureIndex);
+            const benzin::TextureImage& normal = GetTextureImage(*collection, material.NormalTextureIndex);
+            const benzin::TextureImage& emissive = GetTextureImage(*collection, material.EmissiveTextureIndex);
+            const benzin::TextureImage& metallicRoughness = GetTextureImage(*collection, material.MetallicRoughnessTextureIndex);
+
+            BenzinCheck(albedo.Width == 8 && albedo.Height == 4 && albedo.GetImageData().size() == 8 * 4 * 4);
+            BenzinCheck(normal.Width == 4 && normal.Height == 4 && normal.GetImageData().size() == 4 * 4 * 4);
+
+            // Pixels aren't copied out of the decoder output, textures of the same image share them
+            for (const benzin::TextureImage* textureImage : { &albedo, &normal, &emissive, &metallicRoughness })
+            {
+                BenzinCheck(textureImage->ImageData.empty());
+                BenzinCheck(textureImage->ExternalImageDataOwner != nullptr);
+            }
+
+            BenzinCheck(albedo.GetImageData().data() == emissive.GetImageData().data());
+            BenzinCheck(albedo.GetImageData().data() == metallicRoughness.GetImageData().data());
+
+            // RGB is expanded with opaque alpha
+            const std::span<const std::byte> albedoPixels = albedo.GetImageData();
+            BenzinCheck(albedoPixels[0] == std::byte{ 11 } && albedoPixels[1] == std::byte{ 11 + 37 } && albedoPixels[3] == std::byte{ 255 });
+        }
+
+        // Deferred decoding gives the same result as decoding inside 'tinygltf'
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            BenzinCheck(std::ranges::equal(GetTextureImage(meshCollection, i).GetImageData(), GetTextureImage(deferredMeshCollection, i).GetImageData()));
+        }
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+    BenzinTest(TextureMipsAreGeneratedFromDecoderOutput)
+    {
+        const std::filesystem::path directoryPath = WriteTexturedGltf("texture_mips");
+        const std::string gltfFilePath = (directoryPath / "model.gltf").string();
+
+        benzin::MeshCollectionResource meshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, meshCollection));
+
+        auto flags = benzin::MeshCollectionLoadingFlags{ benzin::MeshCollectionLoadingFlag::DeferImageDecoding };
+        flags.Set(benzin::MeshCollectionLoadingFlag::GenerateTextureMips);
+
+        benzin::MeshCollectionResource mipMeshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, mipMeshCollection, flags));
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            const benzin::TextureImage& textureImage = GetTextureImage(meshCollection, i);
+            const benzin::TextureImage& mipTextureImage = GetTextureImage(mipMeshCollection, i);
+
+            // The mip chain can't grow in the decoder output, so it's owned by the texture with the top mip copied as is
+            BenzinCheck(mipTextureImage.MipCount > 1);
+            BenzinCheck(mipTextureImage.ExternalImageData.empty() && !mipTextureImage.ExternalImageDataOwner);
+            BenzinCheck(mipTextureImage.ImageData.size() > textureImage.GetImageData().size());
+            BenzinCheck(std::ranges::equal(std::span{ mipTextureImage.ImageData }.first(textureImage.GetImageData().size()), textureImage.GetImageData()));
+        }
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+    BenzinTest(FailedLoadDoesntLeaveStateForNextLoad)
+    {
+        const std::filesystem::path directoryPath = WriteTexturedGltf("failed_load");
+        const std::string gltfFilePath = (directoryPath / "model.gltf").string();
+
+        // A missing image is a 'tinygltf' warning, the other image is already decoded by then
+        const std::string_view missingImageGltf = R"({
+            "asset": { "version": "2.0" },
+            "scene": 0,
+            "scenes": [ { "nodes": [ 0 ] } ],
+            "nodes": [ { "name": "Root" } ],
+            "images": [ { "uri": "albedo.ppm" }, { "uri": "missing.ppm" } ],
+            "textures": [ { "source": 0 }, { "source": 1 } ],
+            "materials": [ { "pbrMetallicRoughness": { "baseColorTexture": { "index": 0 } }, "normalTexture": { "index": 1 } } ]
+        })";
+        benzin::WriteToFile(directoryPath / "missing_image.gltf", std::as_bytes(std::span{ missingImageGltf }));
+
+        const std::string_view corruptedGltf = R"({ "asset": { "version": )";
+        benzin::WriteToFile(directoryPath / "corrupted.gltf", std::as_bytes(std::span{ corruptedGltf }));
+
+        for (const std::string_view failingFileName : { "missing_image.gltf", "corrupted.gltf" })
+        {
+            benzin::MeshCollectionResource failedMeshCollection;
+            BenzinCheck(!benzin::LoadMeshCollectionFromGltfFile((directoryPath / failingFileName).string(), failedMeshCollection));
+
+            benzin::MeshCollectionResource meshCollection;
+            BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, meshCollection, benzin::MeshCollectionLoadingFlag::DeferImageDecoding));
+            BenzinCheck(meshCollection.TextureImages.size() == 4);
+            BenzinCheck(meshCollection.Materials.size() == 1);
+        }
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+    BenzinTest(GlbAndExternalBuffersAreReadInPlace)
+    {
+        const std::filesystem::path directoryPath = WriteQuadGltfAndGlb("buffers_in_place");
+
+        // Buffers reference the GLB mapping and the mapped '.bin', the result is the same for both
+        benzin::MeshCollectionResource gltfMeshCollection;
+        benzin::MeshCollectionResource glbMeshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile((directoryPath / "quad.gltf").string(), gltfMeshCollection));
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile((directoryPath / "quad.glb").string(), glbMeshCollection));
+
+        for (const benzin::MeshCollectionResource* meshCollection : { &gltfMeshCollection, &glbMeshCollection })
+        {
+            BenzinCheck(meshCollection->Meshes.size() == 1);
+
+            const benzin::MeshData& mesh = meshCollection->Meshes[0];
+            BenzinCheck(mesh.Vertices.size() == 4);
+            BenzinCheck(std::ranges::equal(mesh.Indices, std::array{ 0u, 1u, 2u, 0u, 2u, 3u }));
+            BenzinCheck(mesh.Vertices[2].Position.x == 1.0f && mesh.Vertices[2].Position.y == 1.0f);
+        }
+
+        // The mapped '.bin' is still checked against the declared size
+        benzin::WriteToFile(directoryPath / "quad.bin", std::vector<std::byte>(59, std::byte{ 0 }));
+
+        benzin::MeshCollectionResource truncatedMeshCollection;
+        BenzinCheck(!benzin::LoadMeshCollectionFromGltfFile((directoryPath / "quad.gltf").string(), truncatedMeshCollection));
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+    // Composing local transforms along the parent links gives the whole transform of every instance
+    BenzinTest(GltfNodesKeepParentLinks)
+    {
+        const std::filesystem::path directoryPath = WriteQuadGltfAndGlb("node_parent_links", R"(
+            "scenes": [ { "nodes": [ 0, 2 ] } ],
+            "nodes": [
+                { "mesh": 0, "children": [ 1 ], "translation": [ 1, 2, 3 ], "rotation": [ 0, 0.7071068, 0, 0.7071068 ] },
+                { "mesh": 0, "scale": [ 2, 3, 4 ], "translation": [ 0, 1, 0 ] },
+                { "mesh": 0, "matrix": [ 0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 5, 6, 7, 1 ] }
+            ])");
+
+        benzin::MeshCollectionResource meshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile((directoryPath / "quad.gltf").string(), meshCollection));
+
+        // The first node converts the whole collection to left-handed coordinates
+        const std::span<const benzin::MeshNode> meshNodes = meshCollection.MeshNodes;
+        BenzinCheck(meshNodes.size() == 4);
+        BenzinCheck(meshCollection.MeshInstances.size() == 3);
+
+        if (meshNodes.size() == 4)
+        {
+            BenzinCheck(!benzin::IsValidIndex(meshNodes[0].ParentNodeIndex) && meshNodes[0].Transform.Scale.z == -1.0f);
+            BenzinCheck(meshNodes[1].ParentNodeIndex == 0);
+            BenzinCheck(meshNodes[2].ParentNodeIndex == 1);
+            BenzinCheck(meshNodes[3].ParentNodeIndex == 0);
+        }
+
+        for (const auto& [instanceIndex, meshInstance] : meshCollection.MeshInstances | std::views::enumerate)
+        {
+            BenzinCheck(meshInstance.NodeIndex == instanceIndex + 1);
+            if (meshInstance.NodeIndex >= meshNodes.size())
+            {
+                continue;
+            }
+
+            DirectX::XMMATRIX transform = DirectX::XMMatrixIdentity();
+            for (uint32_t nodeIndex = meshInstance.NodeIndex; benzin::IsValidIndex(nodeIndex); nodeIndex = meshNodes[nodeIndex].ParentNodeIndex)
+            {
+                transform *= benzin::GetLocalMatrix(meshNodes[nodeIndex].Transform);
+            }
+
+            for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex)
+            {
+                BenzinCheck(DirectX::XMVector4NearEqual(transform.r[rowIndex], meshInstance.Transform.r[rowIndex], DirectX::XMVectorReplicate(1e-4f)));
+            }
+        }
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+    BenzinTest(IdenticalTexturesHaveSameIdentity)
+    {
+        const std::filesystem::path directoryPath = WriteTexturedGltf("texture_identity");
+        const std::string gltfFilePath = (directoryPath / "model.gltf").string();
+
+        // Mips of sRGB textures are filtered in linear space, compression format follows usage
+        auto flags = benzin::MeshCollectionLoadingFlags{ benzin::MeshCollectionLoadingFlag::GenerateTextureMips };
+        flags.Set(benzin::MeshCollectionLoadingFlag::CompressTextures);
+
+        // Two models with the same textures
+        benzin::MeshCollectionResource firstMeshCollection;
+        benzin::MeshCollectionResource secondMeshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, firstMeshCollection, flags));
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, secondMeshCollection, flags));
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            benzin::TextureImage& firstTextureImage = firstMeshCollection.TextureImages[i];
+            benzin::TextureImage& secondTextureImage = secondMeshCollection.TextureImages[i];
+            secondTextureImage.DebugName = "Renamed";
+
+            BenzinCheck(benzin::IsSameTextureImage(firstTextureImage, secondTextureImage));
+            BenzinCheck(benzin::HashTextureImage(firstTextureImage) == benzin::HashTextureImage(secondTextureImage));
+        }
+
+        const benzin::Material& material = firstMeshCollection.Materials[0];
+        const benzin::TextureImage& albedo = GetTextureImage(firstMeshCollection, material.AlbedoTextureIndex);
+        const benzin::TextureImage& emissive = GetTextureImage(firstMeshCollection, material.EmissiveTextureIndex);
+        const benzin::TextureImage& metallicRoughness = GetTextureImage(firstMeshCollection, material.MetallicRoughnessTextureIndex);
+
+        // The same image under different glTF textures with the same usage is the same texture
+        BenzinCheck(albedo.Format == benzin::GraphicsFormat::Bc1Unorm);
+        BenzinCheck(benzin::IsSameTextureImage(albedo, emissive));
+
+        // The same image used as linear data is compressed to another format
+        BenzinCheck(metallicRoughness.Format == benzin::GraphicsFormat::Bc7Unorm);
+        BenzinCheck(!benzin::IsSameTextureImage(albedo, metallicRoughness));
+        BenzinCheck(benzin::HashTextureImage(albedo) != benzin::HashTextureImage(metallicRoughness));
+
+        // Without compression mips still differ, sRGB mips are filtered in linear space
+        benzin::MeshCollectionResource uncompressedMeshCollection;
+        BenzinCheck(benzin::LoadMeshCollectionFromGltfFile(gltfFilePath, uncompressedMeshCollection, benzin::MeshCollectionLoadingFlag::GenerateTextureMips));
+
+        const benzin::TextureImage& uncompressedAlbedo = GetTextureImage(uncompressedMeshCollection, material.AlbedoTextureIndex);
+        const benzin::TextureImage& uncompressedMetallicRoughness = GetTextureImage(uncompressedMeshCollection, material.MetallicRoughnessTextureIndex);
+        BenzinCheck(uncompressedAlbedo.Format == uncompressedMetallicRoughness.Format);
+        BenzinCheck(!benzin::IsSameTextureImage(uncompressedAlbedo, uncompressedMetallicRoughness));
+
+        std::filesystem::remove_all(directoryPath);
+    }
+
+    BenzinTest(TexturesWithSameBytesButDifferentFormatsDiffer)
+    {
+        benzin::TextureImage bc3TextureImage
+        {
+            .Format = benzin::GraphicsFormat::Bc3Unorm,
+            .Width = 4,
+            .Height = 4,
+            .ImageData = std::vector<std::byte>(16, std::byte{ 7 }),
+        };
+
+        benzin::TextureImage bc7TextureImage = bc3TextureImage;
+        bc7TextureImage.Format = benzin::GraphicsFormat::Bc7Unorm;
+
+        BenzinCheck(benzin::IsSameTextureImage(bc3TextureImage, bc3TextureImage));
+        BenzinCheck(!benzin::IsSameTextureImage(bc3TextureImage, bc7TextureImage));
+        BenzinCheck(benzin::HashTextureImage(bc3TextureImage) != benzin::HashTextureImage(bc7TextureImage));
+    }
+
+} // namespace tests
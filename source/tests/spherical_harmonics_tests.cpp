@@ -0,0 +1,174 @@
+#include "bootstrap.hpp"
+
+#include <benzin/engine/environment_baker.hpp>
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/engine/spherical_harmonics.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        using RadianceFunction = std::function<float(const DirectX::XMFLOAT3&)>;
+
+        // Gray radiance, which is a function of the direction of the texel center
+        benzin::TextureImage CreateCubeMap(uint32_t faceSize, benzin::GraphicsFormat format, const RadianceFunction& getRadiance)
+        {
+            benzin::TextureImage cubeMap
+            {
+                .Format = format,
+                .IsCubeMap = true,
+                .Width = faceSize,
+                .Height = faceSize,
+            };
+
+            const bool isHalf = format == benzin::GraphicsFormat::Rgba16Float;
+            const size_t pixelSizeInBytes = isHalf ? sizeof(DirectX::PackedVector::XMHALF4) : sizeof(DirectX::XMFLOAT4);
+
+            cubeMap.ImageData.resize(6 * faceSize * faceSize * pixelSizeInBytes);
+
+            for (uint32_t faceIndex = 0; faceIndex < 6; ++faceIndex)
+            {
+                for (uint32_t y = 0; y < faceSize; ++y)
+                {
+                    for (uint32_t x = 0; x < faceSize; ++x)
+                    {
+                        DirectX::XMFLOAT3 direction;
+                        DirectX::XMStoreFloat3(&direction, benzin::GetCubeFaceDirection(faceIndex, ((float)x + 0.5f) / (float)faceSize, ((float)y + 0.5f) / (float)faceSize));
+
+                        const float radiance = getRadiance(direction);
+                        std::byte* texel = cubeMap.ImageData.data() + (((size_t)faceIndex * faceSize + y) * faceSize + x) * pixelSizeInBytes;
+
+                        const DirectX::XMVECTOR value = DirectX::XMVectorSet(radiance, radiance, radiance, 1.0f);
+
+                        if (isHalf)
+                        {
+                            DirectX::PackedVector::XMStoreHalf4(reinterpret_cast<DirectX::PackedVector::XMHALF4*>(texel), value);
+                        }
+                        else
+                        {
+                            DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(texel), value);
+                        }
+                    }
+                }
+            }
+
+            return cubeMap;
+        }
+
+        std::vector<DirectX::XMFLOAT3> GetRandomDirections(uint32_t count, uint32_t seed)
+        {
+            std::mt19937 randomEngine{ seed };
+            std::normal_distribution<float> coordinate;
+
+            std::vector<DirectX::XMFLOAT3> directions(count);
+            for (DirectX::XMFLOAT3& direction : directions)
+            {
+                DirectX::XMStoreFloat3(&direction, DirectX::XMVector3Normalize(DirectX::XMVectorSet(coordinate(randomEngine), coordinate(randomEngine), coordinate(randomEngine), 0.0f)));
+            }
+
+            return directions;
+        }
+
+        // Max relative error of the red channel of 'EvaluateShIrradiance' against the analytic irradiance
+        float GetMaxIrradianceError(const benzin::SphericalHarmonicsL2& sh, const RadianceFunction& getExpectedIrradiance)
+        {
+            float maxError = 0.0f;
+
+            for (const DirectX::XMFLOAT3& normal : GetRandomDirections(256, 14))
+            {
+                const float irradiance = DirectX::XMVectorGetX(benzin::EvaluateShIrradiance(sh, DirectX::XMLoadFloat3(&normal)));
+                const float expectedIrradiance = getExpectedIrradiance(normal);
+
+                maxError = std::max(maxError, std::abs(irradiance - expectedIrradiance) / expectedIrradiance);
+            }
+
+            return maxError;
+        }
+
+    } // anonymous namespace
+
+    // A uniform environment lights every normal with Pi times its radiance, and only the L00 coefficient is left
+    BenzinTest(ConstantCubeMapHasOnlyAmbientTerm)
+    {
+        for (const benzin::GraphicsFormat format : { benzin::GraphicsFormat::Rgba32Float, benzin::GraphicsFormat::Rgba16Float })
+        {
+            const benzin::SphericalHarmonicsL2 sh = benzin::ProjectCubeMapToSh(CreateCubeMap(32, format, [](const DirectX::XMFLOAT3&) { return 2.0f; }));
+
+            // Integral of the L00 basis over the sphere is 2 * sqrt(Pi)
+            BenzinCheck(std::abs(sh.Coefficients[0].x - 2.0f * 2.0f * std::sqrt(DirectX::XM_PI)) < 1e-3f);
+
+            float maxHigherBand = 0.0f;
+            for (uint32_t i = 1; i < benzin::SphericalHarmonicsL2::CoefficientCount; ++i)
+            {
+                maxHigherBand = std::max(maxHigherBand, std::abs(sh.Coefficients[i].x));
+            }
+            BenzinCheck(maxHigherBand < 1e-4f);
+
+            BenzinCheck(GetMaxIrradianceError(sh, [](const DirectX::XMFLOAT3&) { return 2.0f * DirectX::XM_PI; }) < 1e-3f);
+        }
+    }
+
+    // Radiance from the L1 and L2 bands only checks the order of coefficients, the cube face orientation and the cosine lobe factors
+    BenzinTest(ProjectedBandsMatchAnalyticIrradiance)
+    {
+        // The cosine lobe scales the L1 band by 2 * Pi / 3
+        const benzin::SphericalHarmonicsL2 linearSh = benzin::ProjectCubeMapToSh(CreateCubeMap(32, benzin::GraphicsFormat::Rgba32Float, [](const DirectX::XMFLOAT3& d)
+        {
+            return 1.0f + 0.5f * d.z - 0.25f * d.x;
+        }));
+
+        BenzinCheck(GetMaxIrradianceError(linearSh, [](const DirectX::XMFLOAT3& n)
+        {
+            return DirectX::XM_PI + DirectX::XM_2PI / 3.0f * (0.5f * n.z - 0.25f * n.x);
+        }) < 1e-3f);
+
+        // The cosine lobe scales the L2 band by Pi / 4
+        const benzin::SphericalHarmonicsL2 quadraticSh = benzin::ProjectCubeMapToSh(CreateCubeMap(32, benzin::GraphicsFormat::Rgba32Float, [](const DirectX::XMFLOAT3& d)
+        {
+            return 1.0f + d.x * d.y + 0.5f * (d.x * d.x - d.y * d.y);
+        }));
+
+        BenzinCheck(GetMaxIrradianceError(quadraticSh, [](const DirectX::XMFLOAT3& n)
+        {
+            return DirectX::XM_PI + DirectX::XM_PI / 4.0f * (n.x * n.y + 0.5f * (n.x * n.x - n.y * n.y));
+        }) < 1e-3f);
+    }
+
+    // Shaders get coefficients with the basis constants folded in and evaluate them with the plain polynomials
+    BenzinTest(ShDiffuseCoefficientsMatchIrradiance)
+    {
+        const benzin::SphericalHarmonicsL2 sh = benzin::ProjectCubeMapToSh(CreateCubeMap(16, benzin::GraphicsFormat::Rgba32Float, [](const DirectX::XMFLOAT3& d)
+        {
+            return std::max(d.y, 0.0f) * 4.0f + 0.1f;
+        }));
+
+        const float intensity = 0.7f;
+        const auto coefficients = benzin::GetShDiffuseCoefficients(sh, intensity);
+
+        float maxError = 0.0f;
+
+        for (const DirectX::XMFLOAT3& n : GetRandomDirections(64, 15))
+        {
+            const std::array<float, benzin::SphericalHarmonicsL2::CoefficientCount> polynomials
+            {
+                1.0f,
+                n.y, n.z, n.x,
+                n.x * n.y, n.y * n.z, 3.0f * n.z * n.z - 1.0f, n.x * n.z, n.x * n.x - n.y * n.y,
+            };
+
+            float diffuse = 0.0f;
+            for (uint32_t i = 0; i < polynomials.size(); ++i)
+            {
+                diffuse += coefficients[i].x * polynomials[i];
+            }
+
+            const float expectedDiffuse = intensity * DirectX::XMVectorGetX(benzin::EvaluateShIrradiance(sh, DirectX::XMLoadFloat3(&n))) / DirectX::XM_PI;
+            maxError = std::max(maxError, std::abs(diffuse - expectedDiffuse));
+        }
+
+        BenzinCheck(maxError < 1e-4f);
+    }
+
+} // namespace tests
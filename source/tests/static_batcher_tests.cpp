@@ -0,0 +1,78 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/core/math.hpp>
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/engine/static_batcher.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        // A row of unit boxes along X, one every 'spacing' units, all with the same material
+        benzin::MeshCollectionResource CreateBoxRow(uint32_t boxCount, float spacing)
+        {
+            benzin::MeshCollectionResource meshCollection;
+
+            benzin::MeshData& mesh = meshCollection.Meshes.emplace_back(benzin::GenerateBox(benzin::BoxGeometryCreation{ .Width = 1.0f, .Height = 1.0f, .Depth = 1.0f }));
+            mesh.BoundingBox = benzin::ComputeBoundingBox(mesh.Vertices);
+
+            for (uint32_t i = 0; i < boxCount; ++i)
+            {
+                meshCollection.MeshInstances.push_back(benzin::MeshInstance
+                {
+                    .MeshIndex = 0,
+                    .MaterialIndex = 0,
+                    .Transform = DirectX::XMMatrixTranslation(0.5f + (float)i * spacing, 0.5f, 0.5f),
+                });
+            }
+
+            return meshCollection;
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(StaticBatchesStayWithinCells)
+    {
+        // 16 boxes 1 unit apart, centers fall into 4 cells of 4 units
+        benzin::MeshCollectionResource meshCollection = CreateBoxRow(16, 1.0f);
+        const benzin::StaticBatchingStats stats = benzin::BatchStaticMeshInstances(meshCollection, benzin::StaticBatchingParams{ .MaxBatchExtent = 4.0f });
+
+        BenzinCheck(stats.MeshInstanceCountBefore == 16);
+        BenzinCheck(stats.MeshInstanceCountAfter == 4);
+        BenzinCheck(stats.BatchCount == 4);
+
+        for (const benzin::MeshInstance& meshInstance : meshCollection.MeshInstances)
+        {
+            const benzin::MeshData& mesh = meshCollection.Meshes[meshInstance.MeshIndex];
+
+            BenzinCheck(mesh.BoundingBox.has_value());
+            BenzinCheck(mesh.BoundingBox && mesh.BoundingBox->Extents.x <= 2.0f + 1e-5f);
+        }
+    }
+
+    BenzinTest(ZeroMaxBatchExtentBatchesWholeMaterial)
+    {
+        benzin::MeshCollectionResource meshCollection = CreateBoxRow(16, 10.0f);
+        const benzin::StaticBatchingStats stats = benzin::BatchStaticMeshInstances(meshCollection, benzin::StaticBatchingParams{ .MaxBatchExtent = 0.0f });
+
+        BenzinCheck(stats.MeshInstanceCountAfter == 1);
+        BenzinCheck(stats.VertexCountAfter == stats.VertexCountBefore * 16);
+    }
+
+    // Instances alone in their cells are drawn as is
+    BenzinTest(SparseInstancesAreNotBatched)
+    {
+        benzin::MeshCollectionResource meshCollection = CreateBoxRow(8, 10.0f);
+        const benzin::StaticBatchingStats stats = benzin::BatchStaticMeshInstances(meshCollection);
+
+        BenzinCheck(stats.BatchCount == 0);
+        BenzinCheck(stats.MeshInstanceCountAfter == 8);
+        BenzinCheck(stats.MeshCountAfter == 1);
+    }
+
+} // namespace tests
@@ -0,0 +1,124 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/structured_buffer_types.hpp>
+
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/engine/tangent_generator.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        // Two clockwise quads in the XY plane facing -Z, which share the edge at x = 1. U of the right quad is mirrored, like on symmetric models which reuse a half of the texture
+        benzin::MeshData CreateMirroredUvQuads(const DirectX::XMFLOAT3& normal)
+        {
+            benzin::MeshData mesh
+            {
+                .PrimitiveTopology = benzin::PrimitiveTopology::TriangleList,
+            };
+
+            for (uint32_t y = 0; y < 2; ++y)
+            {
+                for (uint32_t x = 0; x < 3; ++x)
+                {
+                    mesh.Vertices.push_back(joint::MeshVertex
+                    {
+                        .Position{ (float)x, (float)y, 0.0f },
+                        .Normal = normal,
+                        .Uv{ x <= 1 ? (float)x : 2.0f - (float)x, (float)y },
+                    });
+                }
+            }
+
+            for (uint32_t x = 0; x < 2; ++x)
+            {
+                const uint32_t bottomLeft = x;
+                const uint32_t topLeft = x + 3;
+
+                mesh.Indices.insert(mesh.Indices.end(), { bottomLeft, topLeft, bottomLeft + 1 });
+                mesh.Indices.insert(mesh.Indices.end(), { bottomLeft + 1, topLeft, topLeft + 1 });
+            }
+
+            return mesh;
+        }
+
+        DirectX::XMVECTOR GetBitangent(const joint::MeshVertex& vertex)
+        {
+            const DirectX::XMVECTOR normal = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&vertex.Normal));
+            return DirectX::XMVectorScale(DirectX::XMVector3Cross(normal, DirectX::XMLoadFloat4(&vertex.Tangent)), vertex.Tangent.w);
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(MirroredUvsFlipBitangentSign)
+    {
+        benzin::MeshData mesh = CreateMirroredUvQuads(DirectX::XMFLOAT3{ 0.0f, 0.0f, -1.0f });
+
+        const benzin::TangentGenerationStats stats = benzin::GenerateTangents(mesh);
+        BenzinCheck(benzin::ValidateTangents(mesh));
+
+        // Vertices on the mirror seam are used by both tangent frames, so they are split
+        BenzinCheck(stats.VertexCountBefore == 6);
+        BenzinCheck(stats.VertexCountAfter == 8);
+
+        const float sign = mesh.Vertices[mesh.Indices[0]].Tangent.w;
+
+        for (size_t triangleIndex = 0; triangleIndex < mesh.Indices.size() / 3; ++triangleIndex)
+        {
+            const bool isMirrored = triangleIndex >= 2;
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const joint::MeshVertex& vertex = mesh.Vertices[mesh.Indices[triangleIndex * 3 + i]];
+
+                // Tangent follows +U, which goes along -X on the mirrored quad, and the bitangent follows +V on both
+                BenzinCheck(vertex.Tangent.x * (isMirrored ? -1.0f : 1.0f) > 0.999f);
+                BenzinCheck(vertex.Tangent.w == (isMirrored ? -sign : sign));
+                BenzinCheck(DirectX::XMVectorGetY(GetBitangent(vertex)) > 0.999f);
+            }
+        }
+    }
+
+    // Normals, which aren't unit length, must not tilt tangents out of the tangent plane
+    BenzinTest(TangentsAreOrthogonalToNonUnitNormals)
+    {
+        const DirectX::XMFLOAT3 normal{ 0.6f, 0.0f, -2.4f };
+        benzin::MeshData mesh = CreateMirroredUvQuads(normal);
+
+        benzin::GenerateTangents(mesh);
+        BenzinCheck(benzin::ValidateTangents(mesh));
+
+        const DirectX::XMVECTOR unitNormal = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&normal));
+
+        float maxNormalDot = 0.0f;
+        float maxLengthError = 0.0f;
+
+        for (const joint::MeshVertex& vertex : mesh.Vertices)
+        {
+            const DirectX::XMVECTOR tangent = DirectX::XMLoadFloat4(&vertex.Tangent);
+
+            maxNormalDot = std::max(maxNormalDot, std::abs(DirectX::XMVectorGetX(DirectX::XMVector3Dot(tangent, unitNormal))));
+            maxLengthError = std::max(maxLengthError, std::abs(DirectX::XMVectorGetX(DirectX::XMVector3Length(tangent)) - 1.0f));
+        }
+
+        BenzinCheck(maxNormalDot < 1e-5f);
+        BenzinCheck(maxLengthError < 1e-5f);
+    }
+
+    BenzinTest(GeneratedSphereTangentsAreValid)
+    {
+        benzin::MeshData mesh = benzin::GenerateSphere(benzin::SphereGeometryCreation
+        {
+            .Radius = 3.0f,
+            .SliceCount = 24,
+            .StackCount = 24,
+        });
+
+        benzin::GenerateTangents(mesh);
+        BenzinCheck(benzin::ValidateTangents(mesh));
+    }
+
+} // namespace tests
@@ -0,0 +1,75 @@
+#include "bootstrap.hpp"
+#include "test_runner.hpp"
+
+#include <benzin/core/logger.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        struct RegisteredTest
+        {
+            std::string_view Name;
+            TestFunction Function = nullptr;
+        };
+
+        // Function local, so registrations don't depend on the initialization order of translation units
+        std::vector<RegisteredTest>& GetRegisteredTests()
+        {
+            static std::vector<RegisteredTest> registeredTests;
+            return registeredTests;
+        }
+
+        uint32_t g_FailedCheckCount = 0;
+
+    } // anonymous namespace
+
+    //
+
+    TestRegistration::TestRegistration(std::string_view name, TestFunction function)
+    {
+        GetRegisteredTests().emplace_back(name, function);
+    }
+
+    void ReportFailedCheck(std::string_view conditionString, const std::source_location& sourceLocation)
+    {
+        const std::string_view filePath = sourceLocation.file_name();
+
+        BenzinError("Check '{}' failed at {}:{}", conditionString, filePath.substr(filePath.find_last_of("\\/") + 1), sourceLocation.line());
+        g_FailedCheckCount++;
+    }
+
+    uint32_t RunTests()
+    {
+        auto& registeredTests = GetRegisteredTests();
+        std::ranges::sort(registeredTests, {}, &RegisteredTest::Name);
+
+        uint32_t failedTestCount = 0;
+
+        for (const auto& [name, function] : registeredTests)
+        {
+            g_FailedCheckCount = 0;
+
+            const auto startTimePoint = std::chrono::steady_clock::now();
+            function();
+            const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTimePoint);
+
+            if (g_FailedCheckCount != 0)
+            {
+                BenzinError("[FAILED] {} ({} checks, {} ms)", name, g_FailedCheckCount, duration.count());
+                failedTestCount++;
+            }
+            else
+            {
+                BenzinTrace("[PASSED] {} ({} ms)", name, duration.count());
+            }
+        }
+
+        BenzinTrace("{} of {} tests passed", registeredTests.size() - failedTestCount, registeredTests.size());
+
+        return failedTestCount;
+    }
+
+} // namespace tests
@@ -0,0 +1,28 @@
+#pragma once
+
+namespace tests
+{
+
+    using TestFunction = void (*)();
+
+    // Adds a test to the list run by 'RunTests'. Created before 'main' by 'BenzinTest'
+    class TestRegistration
+    {
+    public:
+        TestRegistration(std::string_view name, TestFunction function);
+    };
+
+    // Marks the running test as failed, the test keeps running to report the rest of failed checks
+    void ReportFailedCheck(std::string_view conditionString, const std::source_location& sourceLocation = std::source_location::current());
+
+    // Runs every registered test, returns the number of failed ones
+    uint32_t RunTests();
+
+} // namespace tests
+
+#define BenzinTest(testName) \
+    static void testName(); \
+    static const ::tests::TestRegistration BenzinStringConcatenate2(g_TestRegistration, testName){ #testName, testName }; \
+    static void testName()
+
+#define BenzinCheck(condition) if (!(condition)) { ::tests::ReportFailedCheck(#condition); }
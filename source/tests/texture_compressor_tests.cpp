@@ -0,0 +1,213 @@
+#include "bootstrap.hpp"
+
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/engine/texture_compressor.hpp>
+#include <benzin/engine/texture_mip_generator.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        using BlockTexels = std::array<uint8_t, 64>;
+
+        // Smooth gradients with a bit of noise, like most of material textures
+        benzin::TextureImage CreateNaturalImage(uint32_t width, uint32_t height, bool hasAlpha, uint32_t seed)
+        {
+            std::mt19937 randomEngine{ seed };
+            std::uniform_real_distribution<float> noise{ -6.0f, 6.0f };
+
+            benzin::TextureImage textureImage
+            {
+                .Format = benzin::GraphicsFormat::Rgba8Unorm,
+                .Width = width,
+                .Height = height,
+            };
+
+            textureImage.ImageData.resize((size_t)width * height * 4);
+
+            const auto ToByte = [](float value) { return (std::byte)std::clamp((int)std::round(value), 0, 255); };
+
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    const float u = (float)x / (float)width;
+                    const float v = (float)y / (float)height;
+
+                    std::byte* texel = textureImage.ImageData.data() + ((size_t)y * width + x) * 4;
+                    texel[0] = ToByte(128.0f + 100.0f * std::sin(u * 6.0f + v * 2.0f) + noise(randomEngine));
+                    texel[1] = ToByte(40.0f + 160.0f * v + noise(randomEngine));
+                    texel[2] = ToByte(200.0f - 120.0f * u * v + noise(randomEngine));
+                    texel[3] = hasAlpha ? ToByte(255.0f * std::abs(std::cos(u * 3.0f + v * 5.0f))) : std::byte{ 255 };
+                }
+            }
+
+            return textureImage;
+        }
+
+        double GetPsnr(double squaredError, size_t sampleCount)
+        {
+            const double meanSquaredError = squaredError / (double)sampleCount;
+            return meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : std::numeric_limits<double>::infinity();
+        }
+
+        // Encodes and decodes every block of the top mip with the public block functions, independently of 'CompressTexture'
+        double GetBlockRoundTripPsnr(const benzin::TextureImage& textureImage, benzin::GraphicsFormat format)
+        {
+            const uint32_t channelCount = format == benzin::GraphicsFormat::Bc1Unorm ? 3 : 4;
+
+            double squaredError = 0.0;
+
+            for (uint32_t blockY = 0; blockY < textureImage.Height; blockY += 4)
+            {
+                for (uint32_t blockX = 0; blockX < textureImage.Width; blockX += 4)
+                {
+                    BlockTexels texels;
+                    for (uint32_t y = 0; y < 4; ++y)
+                    {
+                        memcpy(texels.data() + y * 16, textureImage.ImageData.data() + ((size_t)(blockY + y) * textureImage.Width + blockX) * 4, 16);
+                    }
+
+                    const auto texelBytes = std::as_bytes(std::span{ texels });
+
+                    std::array<std::byte, 16> block;
+                    BlockTexels decodedTexels;
+                    const auto decodedTexelBytes = std::as_writable_bytes(std::span{ decodedTexels });
+
+                    switch (format)
+                    {
+                        case benzin::GraphicsFormat::Bc1Unorm:
+                        {
+                            benzin::EncodeBc1Block(texelBytes, std::span{ block }.first<8>());
+                            benzin::DecodeBc1Block(std::span{ block }.first<8>(), decodedTexelBytes);
+                            break;
+                        }
+                        case benzin::GraphicsFormat::Bc3Unorm:
+                        {
+                            benzin::EncodeBc3Block(texelBytes, block);
+                            benzin::DecodeBc3Block(block, decodedTexelBytes);
+                            break;
+                        }
+                        case benzin::GraphicsFormat::Bc7Unorm:
+                        {
+                            benzin::EncodeBc7Block(texelBytes, block);
+                            benzin::DecodeBc7Block(block, decodedTexelBytes);
+                            break;
+                        }
+                        default:
+                        {
+                            BenzinCheck(false);
+                            break;
+                        }
+                    }
+
+                    for (size_t i = 0; i < texels.size(); ++i)
+                    {
+                        if (i % 4 < channelCount)
+                        {
+                            const double difference = (double)texels[i] - (double)decodedTexels[i];
+                            squaredError += difference * difference;
+                        }
+                    }
+                }
+            }
+
+            return GetPsnr(squaredError, (size_t)textureImage.Width * textureImage.Height * channelCount);
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(BlockRoundTripPsnrIsAcceptable)
+    {
+        const benzin::TextureImage opaqueImage = CreateNaturalImage(64, 64, false, 7);
+        const benzin::TextureImage translucentImage = CreateNaturalImage(64, 64, true, 8);
+
+        BenzinCheck(GetBlockRoundTripPsnr(opaqueImage, benzin::GraphicsFormat::Bc1Unorm) >= benzin::GetMinAcceptablePsnr(benzin::GraphicsFormat::Bc1Unorm));
+        BenzinCheck(GetBlockRoundTripPsnr(translucentImage, benzin::GraphicsFormat::Bc3Unorm) >= benzin::GetMinAcceptablePsnr(benzin::GraphicsFormat::Bc3Unorm));
+        BenzinCheck(GetBlockRoundTripPsnr(translucentImage, benzin::GraphicsFormat::Bc7Unorm) >= benzin::GetMinAcceptablePsnr(benzin::GraphicsFormat::Bc7Unorm));
+
+        // Mode 6 of BC7 has 7-bit endpoints and 4-bit indices, it must beat 5:6:5 endpoints with 2-bit indices
+        BenzinCheck(GetBlockRoundTripPsnr(opaqueImage, benzin::GraphicsFormat::Bc7Unorm) > GetBlockRoundTripPsnr(opaqueImage, benzin::GraphicsFormat::Bc1Unorm));
+    }
+
+    BenzinTest(SolidBlocksAreNearlyLossless)
+    {
+        std::mt19937 randomEngine{ 9 };
+        std::uniform_int_distribution<uint32_t> channel{ 0, 255 };
+
+        uint32_t maxBc1Error = 0;
+        uint32_t maxBc7Error = 0;
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            const std::array<uint8_t, 4> color{ (uint8_t)channel(randomEngine), (uint8_t)channel(randomEngine), (uint8_t)channel(randomEngine), (uint8_t)channel(randomEngine) };
+
+            BlockTexels texels;
+            for (size_t j = 0; j < texels.size(); ++j)
+            {
+                texels[j] = color[j % 4];
+            }
+
+            std::array<std::byte, 16> block;
+            BlockTexels decodedTexels;
+
+            benzin::EncodeBc1Block(std::as_bytes(std::span{ texels }), std::span{ block }.first<8>());
+            benzin::DecodeBc1Block(std::span{ block }.first<8>(), std::as_writable_bytes(std::span{ decodedTexels }));
+
+            for (size_t j = 0; j < texels.size(); ++j)
+            {
+                maxBc1Error = std::max(maxBc1Error, j % 4 == 3 ? 0u : (uint32_t)std::abs(texels[j] - decodedTexels[j]));
+            }
+
+            benzin::EncodeBc7Block(std::as_bytes(std::span{ texels }), block);
+            benzin::DecodeBc7Block(block, std::as_writable_bytes(std::span{ decodedTexels }));
+
+            for (size_t j = 0; j < texels.size(); ++j)
+            {
+                maxBc7Error = std::max(maxBc7Error, (uint32_t)std::abs(texels[j] - decodedTexels[j]));
+            }
+        }
+
+        // Interpolated BC1 colors fall between 5-bit steps, mode 6 of BC7 has 8 bits with the shared bit
+        BenzinCheck(maxBc1Error <= 4);
+        BenzinCheck(maxBc7Error <= 1);
+    }
+
+    BenzinTest(CompressTextureEncodesEveryMip)
+    {
+        benzin::TextureImage textureImage = CreateNaturalImage(64, 64, true, 10);
+        benzin::GenerateTextureMips(textureImage);
+
+        BenzinCheck(benzin::SelectBlockCompressionFormat(benzin::TextureUsage::Albedo, textureImage) == benzin::GraphicsFormat::Bc3Unorm);
+
+        const size_t uncompressedSizeInBytes = textureImage.ImageData.size();
+        const benzin::TextureCompressionStats stats = benzin::CompressTexture(textureImage, benzin::GraphicsFormat::Bc3Unorm);
+
+        // Mips smaller than a block still take a whole block: 16x16 + 8x8 + 4x4 + 2x2 + 1 + 1 + 1 blocks
+        BenzinCheck(textureImage.Format == benzin::GraphicsFormat::Bc3Unorm);
+        BenzinCheck(textureImage.MipCount == 7);
+        BenzinCheck(textureImage.ImageData.size() == (256 + 64 + 16 + 4 + 1 + 1 + 1) * 16);
+
+        BenzinCheck(stats.TextureCount == 1);
+        BenzinCheck(stats.UncompressedSizeInBytes == uncompressedSizeInBytes);
+        BenzinCheck(stats.CompressedSizeInBytes == textureImage.ImageData.size());
+        BenzinCheck(stats.MinPsnr >= benzin::GetMinAcceptablePsnr(benzin::GraphicsFormat::Bc3Unorm));
+    }
+
+    BenzinTest(SelectBlockCompressionFormatFollowsUsage)
+    {
+        const benzin::TextureImage opaqueImage = CreateNaturalImage(16, 8, false, 11);
+        const benzin::TextureImage translucentImage = CreateNaturalImage(16, 8, true, 12);
+        const benzin::TextureImage unalignedImage = CreateNaturalImage(18, 8, false, 13);
+
+        BenzinCheck(benzin::SelectBlockCompressionFormat(benzin::TextureUsage::Albedo, opaqueImage) == benzin::GraphicsFormat::Bc1Unorm);
+        BenzinCheck(benzin::SelectBlockCompressionFormat(benzin::TextureUsage::Albedo, translucentImage) == benzin::GraphicsFormat::Bc3Unorm);
+        BenzinCheck(benzin::SelectBlockCompressionFormat(benzin::TextureUsage::Emissive, translucentImage) == benzin::GraphicsFormat::Bc1Unorm);
+        BenzinCheck(benzin::SelectBlockCompressionFormat(benzin::TextureUsage::Normal, opaqueImage) == benzin::GraphicsFormat::Bc7Unorm);
+        BenzinCheck(benzin::SelectBlockCompressionFormat(benzin::TextureUsage::MetallicRoughness, opaqueImage) == benzin::GraphicsFormat::Bc7Unorm);
+        BenzinCheck(benzin::SelectBlockCompressionFormat(benzin::TextureUsage::Albedo, unalignedImage) == benzin::GraphicsFormat::Unknown);
+    }
+
+} // namespace tests
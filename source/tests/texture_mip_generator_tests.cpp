@@ -0,0 +1,187 @@
+#include "bootstrap.hpp"
+
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/engine/texture_mip_generator.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        using Rgba8 = std::array<uint8_t, 4>;
+
+        benzin::TextureImage CreateRgba8Image(uint32_t width, uint32_t height, const std::function<Rgba8(uint32_t, uint32_t)>& getTexel)
+        {
+            benzin::TextureImage textureImage
+            {
+                .Format = benzin::GraphicsFormat::Rgba8Unorm,
+                .Width = width,
+                .Height = height,
+            };
+
+            textureImage.ImageData.resize((size_t)width * height * 4);
+
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    const Rgba8 texel = getTexel(x, y);
+                    memcpy(textureImage.ImageData.data() + ((size_t)y * width + x) * 4, texel.data(), texel.size());
+                }
+            }
+
+            return textureImage;
+        }
+
+        // Texels of the mip as bytes, mips are stored one after another
+        std::span<const uint8_t> GetMipTexels(const benzin::TextureImage& textureImage, uint32_t mipIndex)
+        {
+            const size_t offset = benzin::GetRgba8MipChainSizeInBytes(textureImage.Width, textureImage.Height, mipIndex);
+            const size_t size = benzin::GetRgba8MipChainSizeInBytes(textureImage.Width, textureImage.Height, mipIndex + 1) - offset;
+
+            return std::span{ reinterpret_cast<const uint8_t*>(textureImage.ImageData.data()) + offset, size };
+        }
+
+        // Max difference between a channel of mip texels and the expected value
+        uint32_t GetMaxChannelDeviation(std::span<const uint8_t> texels, uint32_t channelIndex, uint32_t expectedValue)
+        {
+            uint32_t maxDeviation = 0;
+            for (size_t i = channelIndex; i < texels.size(); i += 4)
+            {
+                maxDeviation = std::max(maxDeviation, (uint32_t)std::abs((int)texels[i] - (int)expectedValue));
+            }
+
+            return maxDeviation;
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(MipChainSizesMatchFullChain)
+    {
+        BenzinCheck(benzin::GetFullMipCount(1, 1) == 1);
+        BenzinCheck(benzin::GetFullMipCount(2, 1) == 2);
+        BenzinCheck(benzin::GetFullMipCount(256, 256) == 9);
+        BenzinCheck(benzin::GetFullMipCount(256, 1) == 9);
+        BenzinCheck(benzin::GetFullMipCount(300, 17) == 9);
+        BenzinCheck(benzin::GetFullMipCount(1024, 512) == 11);
+
+        BenzinCheck(benzin::GetRgba8MipChainSizeInBytes(4, 4, 0) == 0);
+        BenzinCheck(benzin::GetRgba8MipChainSizeInBytes(4, 4, 3) == (16 + 4 + 1) * 4);
+        BenzinCheck(benzin::GetRgba8MipChainSizeInBytes(8, 2, 4) == (16 + 4 + 2 + 1) * 4);
+
+        // A full square chain is (4^n - 1) / 3 texels
+        BenzinCheck(benzin::GetRgba8MipChainSizeInBytes(256, 256, 9) == (262'144 - 1) / 3 * 4);
+    }
+
+    BenzinTest(GenerateTextureMipsBuildsFullChainOfNonPowerOfTwoImage)
+    {
+        for (const benzin::TextureMipFilter filter : { benzin::TextureMipFilter::Box, benzin::TextureMipFilter::Kaiser })
+        {
+            benzin::TextureImage textureImage = CreateRgba8Image(37, 12, [](uint32_t x, uint32_t y) { return Rgba8{ (uint8_t)(x * 6), (uint8_t)(y * 20), 77, 255 }; });
+            const std::vector<std::byte> topMip = textureImage.ImageData;
+
+            benzin::GenerateTextureMips(textureImage, benzin::TextureMipParams{ .Filter = filter });
+
+            BenzinCheck(textureImage.MipCount == 6);
+            BenzinCheck(textureImage.ImageData.size() == benzin::GetRgba8MipChainSizeInBytes(37, 12, 6));
+            BenzinCheck(std::ranges::equal(std::span{ textureImage.ImageData }.first(topMip.size()), topMip));
+
+            // 37x12 -> 18x6 -> 9x3 -> 4x1 -> 2x1 -> 1x1
+            BenzinCheck(GetMipTexels(textureImage, 3).size() == 4 * 1 * 4);
+            BenzinCheck(GetMipTexels(textureImage, 5).size() == 4);
+
+            // A channel constant in the source stays constant in every mip
+            for (uint32_t mipIndex = 1; mipIndex < textureImage.MipCount; ++mipIndex)
+            {
+                BenzinCheck(GetMaxChannelDeviation(GetMipTexels(textureImage, mipIndex), 2, 77) == 0);
+                BenzinCheck(GetMaxChannelDeviation(GetMipTexels(textureImage, mipIndex), 3, 255) == 0);
+            }
+        }
+    }
+
+    BenzinTest(DownsampleRgba8FiltersColorInLinearSpace)
+    {
+        // Black and white texels average to 0.5 in linear space, which is 188 in sRGB
+        const benzin::TextureImage checker = CreateRgba8Image(2, 2, [](uint32_t x, uint32_t y)
+        {
+            const auto value = (uint8_t)((x + y) % 2 == 0 ? 0 : 255);
+            return Rgba8{ value, value, value, value };
+        });
+
+        const auto Downsample = [&](bool isSrgb)
+        {
+            Rgba8 texel;
+            benzin::DownsampleRgba8(checker.ImageData, 2, 2, std::as_writable_bytes(std::span{ texel }), 1, 1, benzin::TextureMipParams{ .Filter = benzin::TextureMipFilter::Box, .IsSrgb = isSrgb });
+
+            return texel;
+        };
+
+        const Rgba8 linearTexel = Downsample(false);
+        const Rgba8 srgbTexel = Downsample(true);
+
+        BenzinCheck(std::abs(linearTexel[0] - 128) <= 1);
+        BenzinCheck(std::abs(srgbTexel[0] - 188) <= 1);
+
+        // Alpha is always linear
+        BenzinCheck(std::abs(srgbTexel[3] - 128) <= 1);
+    }
+
+    // A one texel checker is above the Nyquist limit of every mip, the filter must average it out instead of aliasing
+    BenzinTest(KaiserFilterRemovesFrequenciesAboveNyquist)
+    {
+        benzin::TextureImage textureImage = CreateRgba8Image(64, 64, [](uint32_t x, uint32_t y)
+        {
+            const auto value = (uint8_t)((x + y) % 2 == 0 ? 0 : 255);
+            return Rgba8{ value, value, value, 255 };
+        });
+
+        benzin::GenerateTextureMips(textureImage, benzin::TextureMipParams{ .Filter = benzin::TextureMipFilter::Kaiser });
+
+        for (uint32_t mipIndex = 1; mipIndex < textureImage.MipCount; ++mipIndex)
+        {
+            BenzinCheck(GetMaxChannelDeviation(GetMipTexels(textureImage, mipIndex), 0, 128) <= 2);
+        }
+    }
+
+    BenzinTest(NormalMapMipsStayNormalized)
+    {
+        std::mt19937 randomEngine{ 6 };
+        std::uniform_int_distribution<uint32_t> tangentComponent{ 0, 255 };
+
+        // Random normals of the upper hemisphere in tangent space
+        benzin::TextureImage textureImage = CreateRgba8Image(32, 32, [&](uint32_t x, uint32_t y)
+        {
+            const float nx = (float)tangentComponent(randomEngine) / 255.0f * 1.2f - 0.6f;
+            const float ny = (float)tangentComponent(randomEngine) / 255.0f * 1.2f - 0.6f;
+            const float nz = std::sqrt(1.0f - nx * nx - ny * ny);
+
+            const auto Encode = [](float value) { return (uint8_t)std::round((value * 0.5f + 0.5f) * 255.0f); };
+            return Rgba8{ Encode(nx), Encode(ny), Encode(nz), 255 };
+        });
+
+        benzin::GenerateTextureMips(textureImage, benzin::TextureMipParams{ .IsNormalMap = true });
+
+        float maxLengthError = 0.0f;
+
+        for (uint32_t mipIndex = 1; mipIndex < textureImage.MipCount; ++mipIndex)
+        {
+            const std::span<const uint8_t> texels = GetMipTexels(textureImage, mipIndex);
+
+            for (size_t i = 0; i < texels.size(); i += 4)
+            {
+                const auto Decode = [](uint8_t value) { return (float)value / 255.0f * 2.0f - 1.0f; };
+
+                const float nx = Decode(texels[i + 0]);
+                const float ny = Decode(texels[i + 1]);
+                const float nz = Decode(texels[i + 2]);
+
+                maxLengthError = std::max(maxLengthError, std::abs(std::sqrt(nx * nx + ny * ny + nz * nz) - 1.0f));
+            }
+        }
+
+        // Averaged normals get shorter, renormalization brings them back up to 8-bit quantization
+        BenzinCheck(maxLengthError < 0.015f);
+    }
+
+} // namespace tests
@@ -0,0 +1,238 @@
+#include "bootstrap.hpp"
+
+#include <benzin/core/heap_allocation_counter.hpp>
+#include <benzin/engine/transform_hierarchy.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        benzin::LocalTransform GetRandomLocalTransform(std::mt19937& randomEngine)
+        {
+            std::uniform_real_distribution<float> scale{ 0.5f, 2.0f };
+            std::uniform_real_distribution<float> angle{ -DirectX::XM_PI, DirectX::XM_PI };
+            std::uniform_real_distribution<float> offset{ -10.0f, 10.0f };
+
+            return benzin::LocalTransform
+            {
+                .Scale{ scale(randomEngine), scale(randomEngine), scale(randomEngine) },
+                .Rotation{ angle(randomEngine), angle(randomEngine), angle(randomEngine) },
+                .Translation{ offset(randomEngine), offset(randomEngine), offset(randomEngine) },
+            };
+        }
+
+        bool IsNearEqual(const DirectX::XMFLOAT3& lhs, const DirectX::XMFLOAT3& rhs)
+        {
+            return DirectX::XMVector3NearEqual(DirectX::XMLoadFloat3(&lhs), DirectX::XMLoadFloat3(&rhs), DirectX::XMVectorReplicate(1e-4f));
+        }
+
+        // Every node of the tree is rebuilt on every update, so the time is spent only on matrices
+        void BenchmarkFullUpdates(std::string_view treeName, uint32_t rootCount, uint32_t depthCount, uint32_t childCount)
+        {
+            std::mt19937 randomEngine{ 22 };
+
+            benzin::TransformHierarchy transformHierarchy;
+            std::vector<benzin::TransformNodeId> rootIds;
+
+            for (uint32_t rootIndex = 0; rootIndex < rootCount; ++rootIndex)
+            {
+                benzin::TransformNodeId parentId = transformHierarchy.CreateNode();
+                rootIds.push_back(parentId);
+
+                // Only the first child of a depth has children
+                for (uint32_t depth = 1; depth < depthCount; ++depth)
+                {
+                    const benzin::TransformNodeId firstChildId = transformHierarchy.CreateNode(parentId);
+                    transformHierarchy.SetLocalTransform(firstChildId, GetRandomLocalTransform(randomEngine));
+
+                    for (uint32_t i = 1; i < childCount; ++i)
+                    {
+                        transformHierarchy.SetLocalTransform(transformHierarchy.CreateNode(parentId), GetRandomLocalTransform(randomEngine));
+                    }
+
+                    parentId = firstChildId;
+                }
+            }
+
+            transformHierarchy.Update();
+
+            constexpr uint32_t updateCount = 32;
+            {
+                BenzinLogTimeOnScopeExit("TransformHierarchy: {} tree, {} updates of {} nodes in {} depths", treeName, updateCount, transformHierarchy.GetStats().NodeCount, transformHierarchy.GetStats().DepthCount);
+
+                for (uint32_t updateIndex = 0; updateIndex < updateCount; ++updateIndex)
+                {
+                    for (const benzin::TransformNodeId rootId : rootIds)
+                    {
+                        transformHierarchy.SetLocalTransform(rootId, GetRandomLocalTransform(randomEngine));
+                    }
+
+                    transformHierarchy.Update();
+                }
+            }
+
+            BenzinCheck(transformHierarchy.GetStats().UpdatedNodeCount == transformHierarchy.GetStats().NodeCount);
+            BenzinCheck(transformHierarchy.Validate());
+        }
+
+    } // anonymous namespace
+
+    // Parents are always created before their children, so random links can't form a cycle
+    BenzinTest(RandomStructuralChangesKeepHierarchyValid)
+    {
+        std::mt19937 randomEngine{ 22 };
+        std::uniform_real_distribution<float> chance{ 0.0f, 1.0f };
+
+        benzin::TransformHierarchy transformHierarchy;
+        std::vector<benzin::TransformNodeId> nodeIds;
+
+        const auto GetRandomParent = [&](size_t nodeCount)
+        {
+            return nodeCount == 0 || chance(randomEngine) < 0.1f ? benzin::g_InvalidIndex<benzin::TransformNodeId> : nodeIds[std::uniform_int_distribution<size_t>{ 0, nodeCount - 1 }(randomEngine)];
+        };
+
+        for (uint32_t i = 0; i < 500; ++i)
+        {
+            nodeIds.push_back(transformHierarchy.CreateNode(GetRandomParent(nodeIds.size())));
+            transformHierarchy.SetLocalTransform(nodeIds.back(), GetRandomLocalTransform(randomEngine));
+        }
+
+        transformHierarchy.Update();
+        BenzinCheck(transformHierarchy.Validate());
+        BenzinCheck(transformHierarchy.GetStats().NodeCount == 500);
+
+        for (uint32_t frameIndex = 0; frameIndex < 16; ++frameIndex)
+        {
+            for (uint32_t i = 0; i < 20; ++i)
+            {
+                const size_t index = std::uniform_int_distribution<size_t>{ 1, nodeIds.size() - 1 }(randomEngine);
+                transformHierarchy.SetParent(nodeIds[index], GetRandomParent(index));
+                transformHierarchy.SetLocalTransform(nodeIds[std::uniform_int_distribution<size_t>{ 0, nodeIds.size() - 1 }(randomEngine)], GetRandomLocalTransform(randomEngine));
+            }
+
+            // Children of a destroyed node go to its parent, which is still before them
+            for (uint32_t i = 0; i < 5; ++i)
+            {
+                const size_t index = std::uniform_int_distribution<size_t>{ 0, nodeIds.size() - 1 }(randomEngine);
+                transformHierarchy.DestroyNode(nodeIds[index]);
+                nodeIds.erase(nodeIds.begin() + index);
+            }
+
+            for (uint32_t i = 0; i < 5; ++i)
+            {
+                nodeIds.push_back(transformHierarchy.CreateNode(GetRandomParent(nodeIds.size())));
+            }
+
+            transformHierarchy.Update();
+            BenzinCheck(transformHierarchy.Validate());
+        }
+
+        BenzinCheck(transformHierarchy.GetStats().NodeCount == 500);
+    }
+
+    // Sort scratch buffers are kept, so reparenting every frame doesn't allocate once they have grown
+    BenzinTest(ReparentingDoesntAllocateInSteadyState)
+    {
+        benzin::TransformHierarchy transformHierarchy;
+        std::vector<benzin::TransformNodeId> nodeIds;
+
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            nodeIds.push_back(transformHierarchy.CreateNode(i == 0 ? benzin::g_InvalidIndex<benzin::TransformNodeId> : nodeIds[(i - 1) / 4]));
+        }
+
+        const auto RunFrame = [&](uint32_t frameIndex)
+        {
+            for (uint32_t i = 500; i < 1000; i += 50)
+            {
+                transformHierarchy.SetParent(nodeIds[i], frameIndex % 2 == 0 ? nodeIds[0] : nodeIds[(i - 1) / 4]);
+            }
+
+            transformHierarchy.Update();
+        };
+
+        for (uint32_t frameIndex = 0; frameIndex < 4; ++frameIndex)
+        {
+            RunFrame(frameIndex);
+        }
+
+        const uint64_t heapAllocationCount = benzin::GetHeapAllocationCount();
+
+        for (uint32_t frameIndex = 4; frameIndex < 20; ++frameIndex)
+        {
+            RunFrame(frameIndex);
+        }
+
+        BenzinCheck(benzin::GetHeapAllocationCount() == heapAllocationCount);
+        BenzinCheck(transformHierarchy.Validate());
+    }
+
+    // Rotations near the gimbal lock and negative scales come from glTF nodes
+    BenzinTest(DecomposedLocalMatrixGivesSameMatrix)
+    {
+        std::mt19937 randomEngine{ 22 };
+
+        std::vector<benzin::LocalTransform> localTransforms;
+        for (uint32_t i = 0; i < 200; ++i)
+        {
+            localTransforms.push_back(GetRandomLocalTransform(randomEngine));
+        }
+
+        localTransforms.push_back(benzin::LocalTransform{ .Rotation{ 0.3f, DirectX::XM_PIDIV2, 0.2f } });
+        localTransforms.push_back(benzin::LocalTransform{ .Rotation{ -0.3f, -DirectX::XM_PIDIV2, 0.6f } });
+        localTransforms.push_back(benzin::LocalTransform{ .Scale{ 1.0f, 1.0f, -1.0f } });
+        localTransforms.push_back(benzin::LocalTransform{ .Scale{ -2.0f, 0.5f, 3.0f }, .Rotation{ 1.0f, 0.5f, -2.0f }, .Translation{ 1.0f, 2.0f, 3.0f } });
+
+        for (const benzin::LocalTransform& localTransform : localTransforms)
+        {
+            const DirectX::XMMATRIX localMatrix = benzin::GetLocalMatrix(localTransform);
+            const DirectX::XMMATRIX decomposedLocalMatrix = benzin::GetLocalMatrix(benzin::DecomposeLocalMatrix(localMatrix));
+
+            for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex)
+            {
+                BenzinCheck(DirectX::XMVector4NearEqual(localMatrix.r[rowIndex], decomposedLocalMatrix.r[rowIndex], DirectX::XMVectorReplicate(1e-4f)));
+            }
+        }
+    }
+
+    // Local transforms are stored by component, the node gets back what was set
+    BenzinTest(LocalTransformsSurviveReordering)
+    {
+        std::mt19937 randomEngine{ 22 };
+
+        benzin::TransformHierarchy transformHierarchy;
+        std::vector<benzin::TransformNodeId> nodeIds;
+        std::vector<benzin::LocalTransform> localTransforms;
+
+        for (uint32_t i = 0; i < 37; ++i)
+        {
+            nodeIds.push_back(transformHierarchy.CreateNode(i == 0 ? benzin::g_InvalidIndex<benzin::TransformNodeId> : nodeIds[(i * 7 + 3) % i]));
+            localTransforms.push_back(GetRandomLocalTransform(randomEngine));
+            transformHierarchy.SetLocalTransform(nodeIds.back(), localTransforms.back());
+        }
+
+        transformHierarchy.SetParent(nodeIds[1], nodeIds[36]);
+        transformHierarchy.Update();
+        BenzinCheck(transformHierarchy.Validate());
+
+        for (const auto& [nodeId, localTransform] : std::views::zip(nodeIds, localTransforms))
+        {
+            const benzin::LocalTransform storedLocalTransform = transformHierarchy.GetLocalTransform(nodeId);
+
+            BenzinCheck(IsNearEqual(storedLocalTransform.Scale, localTransform.Scale));
+            BenzinCheck(IsNearEqual(storedLocalTransform.Rotation, localTransform.Rotation));
+            BenzinCheck(IsNearEqual(storedLocalTransform.Translation, localTransform.Translation));
+        }
+    }
+
+    // Timings are logged. A deep tree has few nodes per depth, so it's updated on the calling thread, a wide one is split between workers
+    BenzinTest(TransformHierarchyUpdateOfDeepAndWideTrees)
+    {
+        BenchmarkFullUpdates("Deep", 16, 4096, 1);
+        BenchmarkFullUpdates("Wide", 1, 2, 65535);
+        BenchmarkFullUpdates("Bushy", 64, 8, 128);
+    }
+
+} // namespace tests
@@ -0,0 +1,160 @@
+#include "bootstrap.hpp"
+
+#include <shaders/joint/vertex_packing.hpp>
+
+#include <benzin/engine/geometry_generator.hpp>
+#include <benzin/engine/resource_loader.hpp>
+#include <benzin/engine/vertex_packing.hpp>
+
+namespace tests
+{
+
+    namespace
+    {
+
+        DirectX::XMFLOAT3 GetRandomUnitVector(std::mt19937& randomEngine)
+        {
+            std::normal_distribution<float> coordinate;
+
+            DirectX::XMFLOAT3 result;
+            DirectX::XMStoreFloat3(&result, DirectX::XMVector3Normalize(DirectX::XMVectorSet(coordinate(randomEngine), coordinate(randomEngine), coordinate(randomEngine), 0.0f)));
+
+            return result;
+        }
+
+        // Random positions in a box away from the origin, unit normals, tangents orthogonal to them and UVs with tiling
+        benzin::MeshData GenerateRandomVertices(uint32_t vertexCount, uint32_t seed)
+        {
+            std::mt19937 randomEngine{ seed };
+            std::uniform_real_distribution<float> position{ -50.0f, 150.0f };
+            std::uniform_real_distribution<float> uv{ -4.0f, 4.0f };
+            std::bernoulli_distribution isTangentFlipped;
+
+            benzin::MeshData mesh;
+            mesh.Vertices.resize(vertexCount);
+
+            for (joint::MeshVertex& vertex : mesh.Vertices)
+            {
+                vertex.Position = DirectX::XMFLOAT3{ position(randomEngine), position(randomEngine) * 0.1f, position(randomEngine) * 0.01f };
+                vertex.Normal = GetRandomUnitVector(randomEngine);
+                vertex.Uv = DirectX::XMFLOAT2{ uv(randomEngine), uv(randomEngine) };
+
+                const DirectX::XMVECTOR normal = DirectX::XMLoadFloat3(&vertex.Normal);
+                const DirectX::XMFLOAT3 randomDirection = GetRandomUnitVector(randomEngine);
+                const DirectX::XMVECTOR tangent = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(normal, DirectX::XMLoadFloat3(&randomDirection)));
+
+                DirectX::XMStoreFloat4(&vertex.Tangent, DirectX::XMVectorSetW(tangent, isTangentFlipped(randomEngine) ? -1.0f : 1.0f));
+            }
+
+            return mesh;
+        }
+
+    } // anonymous namespace
+
+    BenzinTest(PackMeshVerticesRoundTripIsWithinLimits)
+    {
+        benzin::MeshData mesh = GenerateRandomVertices(100'000, 5);
+
+        const benzin::VertexPackingStats stats = benzin::PackMeshVertices(mesh);
+
+        BenzinCheck(stats.VertexCount == mesh.Vertices.size());
+        BenzinCheck(mesh.PackedVertices.size() == mesh.Vertices.size());
+        BenzinCheck(stats.PackedSizeInBytes == mesh.Vertices.size() * 16);
+        BenzinCheck(stats.GetSavedSizeInBytes() == mesh.Vertices.size() * (sizeof(joint::MeshVertex) - 16));
+
+        BenzinCheck(benzin::IsVertexPackingErrorAcceptable(stats));
+
+        // 'PackMeshVertices' computes the stats itself, so check them against an independent decode
+        const DirectX::XMFLOAT3& center = mesh.BoundingBox->Center;
+        const DirectX::XMFLOAT3& extents = mesh.BoundingBox->Extents;
+
+        bool isTangentSignKept = true;
+        bool isTangentOrthogonal = true;
+        float maxPositionError = 0.0f;
+
+        for (const auto& [i, vertex] : mesh.Vertices | std::views::enumerate)
+        {
+            const joint::MeshVertex unpackedVertex = joint::UnpackMeshVertex(mesh.PackedVertices[i], center, extents);
+
+            maxPositionError = std::max(maxPositionError, std::abs(unpackedVertex.Position.x - vertex.Position.x) / (2.0f * extents.x));
+            isTangentSignKept &= unpackedVertex.Tangent.w == vertex.Tangent.w;
+
+            const float tangentDotNormal = DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMLoadFloat4(&unpackedVertex.Tangent), DirectX::XMLoadFloat3(&unpackedVertex.Normal)));
+            isTangentOrthogonal &= std::abs(tangentDotNormal) < 1e-5f;
+        }
+
+        BenzinCheck(maxPositionError <= stats.MaxPositionError);
+        BenzinCheck(isTangentSignKept);
+        BenzinCheck(isTangentOrthogonal);
+    }
+
+    BenzinTest(PackMeshVerticesKeepsMissingTangentsAndFlatBounds)
+    {
+        // The grid is flat, its bounding box has zero extent along Y
+        benzin::MeshData mesh = benzin::GenerateGrid(benzin::GridGeometryCreation
+        {
+            .Width = 10.0f,
+            .Depth = 4.0f,
+            .WidthPointCount = 16,
+            .DepthPointCount = 16,
+        });
+
+        const benzin::VertexPackingStats stats = benzin::PackMeshVertices(mesh);
+        BenzinCheck(benzin::IsVertexPackingErrorAcceptable(stats));
+        BenzinCheck(stats.MaxTangentError == 0.0f);
+
+        bool isFlatAxisExact = true;
+        bool isTangentZero = true;
+
+        for (const joint::PackedMeshVertex& packedVertex : mesh.PackedVertices)
+        {
+            const joint::MeshVertex unpackedVertex = joint::UnpackMeshVertex(packedVertex, mesh.BoundingBox->Center, mesh.BoundingBox->Extents);
+
+            isFlatAxisExact &= unpackedVertex.Position.y == mesh.BoundingBox->Center.y;
+            isTangentZero &= unpackedVertex.Tangent.x == 0.0f && unpackedVertex.Tangent.y == 0.0f && unpackedVertex.Tangent.z == 0.0f && unpackedVertex.Tangent.w == 0.0f;
+        }
+
+        BenzinCheck(isFlatAxisExact);
+        BenzinCheck(isTangentZero);
+    }
+
+    // Axis aligned normals hit the octahedron corners and the seam of the orthonormal basis at -Z
+    BenzinTest(PackMeshVerticesHandlesAxisAlignedFrames)
+    {
+        const auto axes = std::to_array<DirectX::XMFLOAT3>(
+        {
+            { 1.0f, 0.0f, 0.0f },
+            { -1.0f, 0.0f, 0.0f },
+            { 0.0f, 1.0f, 0.0f },
+            { 0.0f, -1.0f, 0.0f },
+            { 0.0f, 0.0f, 1.0f },
+            { 0.0f, 0.0f, -1.0f },
+        });
+
+        benzin::MeshData mesh;
+
+        for (const DirectX::XMFLOAT3& normal : axes)
+        {
+            for (const DirectX::XMFLOAT3& tangent : axes)
+            {
+                if (normal.x * tangent.x + normal.y * tangent.y + normal.z * tangent.z != 0.0f)
+                {
+                    continue;
+                }
+
+                mesh.Vertices.push_back(joint::MeshVertex
+                {
+                    .Position{ tangent.x, tangent.y, tangent.z },
+                    .Normal = normal,
+                    .Uv{ 0.5f, 0.5f },
+                    .Tangent{ tangent.x, tangent.y, tangent.z, -1.0f },
+                });
+            }
+        }
+
+        const benzin::VertexPackingStats stats = benzin::PackMeshVertices(mesh);
+        BenzinCheck(mesh.Vertices.size() == 24);
+        BenzinCheck(benzin::IsVertexPackingErrorAcceptable(stats));
+    }
+
+} // namespace tests
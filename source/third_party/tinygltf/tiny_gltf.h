@@ -1077,6 +1077,11 @@ class Node {
 struct Buffer {
   std::string name;
   std::vector<unsigned char> data;
+  // Set instead of `data` when the buffer references memory owned by the
+  // application: a file mapped by `FsCallbacks::MapWholeFile` or the GLB BIN
+  // chunk. Use `GetData()` and `GetSize()` to read either of them.
+  const unsigned char *mapped_data = nullptr;
+  size_t mapped_size = 0;
   std::string
       uri;  // considered as required here but not in the spec (need to clarify)
             // uri is not decoded(e.g. whitespace may be represented as %20)
@@ -1090,6 +1095,11 @@ struct Buffer {
   Buffer() = default;
   DEFAULT_METHODS(Buffer)
   bool operator==(const Buffer &) const;
+
+  const unsigned char *GetData() const {
+    return mapped_data ? mapped_data : data.data();
+  }
+  size_t GetSize() const { return mapped_data ? mapped_size : data.size(); }
 };
 
 struct Asset {
@@ -1301,6 +1311,15 @@ typedef bool (*WriteWholeFileFunction)(std::string *, const std::string &,
                                        const std::vector<unsigned char> &,
                                        void *);
 
+///
+/// MapWholeFileFunction type. Signature for an optional filesystem callback,
+/// which maps a file and returns a pointer to its contents. The mapping is
+/// owned by the application and must stay valid as long as the model is used.
+///
+typedef bool (*MapWholeFileFunction)(const unsigned char **, size_t *,
+                                     std::string *, const std::string &,
+                                     void *);
+
 ///
 /// A structure containing all required filesystem callbacks and a pointer to
 /// their user data.
@@ -1312,6 +1331,12 @@ struct FsCallbacks {
   WriteWholeFileFunction WriteWholeFile;
 
   void *user_data;  // An argument that is passed to all fs callbacks
+
+  // Optional. When set, external buffers are mapped instead of read and the
+  // GLB BIN chunk is referenced in the memory passed to
+  // `LoadBinaryFromMemory`, which then must outlive the model as well.
+  // Buffers set `mapped_data` instead of `data` in both cases.
+  MapWholeFileFunction MapWholeFile;
 };
 
 #ifndef TINYGLTF_NO_FS
@@ -1899,7 +1924,10 @@ bool Asset::operator==(const Asset &other) const {
          this->minVersion == other.minVersion && this->version == other.version;
 }
 bool Buffer::operator==(const Buffer &other) const {
-  return this->data == other.data && this->extensions == other.extensions &&
+  return this->GetSize() == other.GetSize() &&
+         std::equal(this->GetData(), this->GetData() + this->GetSize(),
+                    other.GetData()) &&
+         this->extensions == other.extensions &&
          this->extras == other.extras && this->name == other.name &&
          this->uri == other.uri;
 }
@@ -4173,6 +4201,56 @@ static bool ParseOcclusionTextureInfo(
   return true;
 }
 
+// Maps the file with `FsCallbacks::MapWholeFile` if it's set, reads it
+// into `Buffer::data` otherwise
+static bool LoadExternalBuffer(Buffer *buffer, std::string *err,
+                               const std::string &filename,
+                               const std::string &basedir, size_t reqBytes,
+                               FsCallbacks *fs) {
+  if (fs == nullptr || fs->MapWholeFile == nullptr) {
+    return LoadExternalFile(&buffer->data, err, /* warn */ nullptr, filename,
+                            basedir, /* required */ true, reqBytes,
+                            /* checkSize */ true, fs);
+  }
+
+  std::vector<std::string> paths;
+  paths.push_back(basedir);
+  paths.push_back(".");
+
+  std::string filepath = FindFile(paths, filename, fs);
+  if (filepath.empty() || filename.empty()) {
+    if (err) {
+      (*err) += "File not found : " + filename + "\n";
+    }
+    return false;
+  }
+
+  const unsigned char *mapped_data = nullptr;
+  size_t mapped_size = 0;
+  std::string fileMapErr;
+  if (!fs->MapWholeFile(&mapped_data, &mapped_size, &fileMapErr, filepath,
+                        fs->user_data)) {
+    if (err) {
+      (*err) += "File map error : " + filepath + " : " + fileMapErr + "\n";
+    }
+    return false;
+  }
+
+  if (mapped_size != reqBytes) {
+    if (err) {
+      std::stringstream ss;
+      ss << "File size mismatch : " << filepath << ", requestedBytes "
+         << reqBytes << ", but got " << mapped_size << std::endl;
+      (*err) += ss.str();
+    }
+    return false;
+  }
+
+  buffer->mapped_data = mapped_data;
+  buffer->mapped_size = mapped_size;
+  return true;
+}
+
 static bool ParseBuffer(Buffer *buffer, std::string *err, const detail::json &o,
                         bool store_original_json_for_extras_and_extensions,
                         FsCallbacks *fs, const URICallbacks *uri_cb,
@@ -4189,6 +4267,27 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const detail::json &o,
   buffer->uri.clear();
   ParseStringProperty(&buffer->uri, err, o, "uri", false, "Buffer");
 
+  // Fallback buffers of EXT_meshopt_compression may have no data at all.
+  // Buffer views that reference them are decoded by the application from
+  // compressed buffers, so leave such buffers empty.
+  if (buffer->uri.empty()) {
+    detail::json_const_iterator extensionsIt;
+    detail::json_const_iterator meshoptIt;
+    if (detail::FindMember(o, "extensions", extensionsIt) &&
+        detail::FindMember(detail::GetValue(extensionsIt),
+                           "EXT_meshopt_compression", meshoptIt)) {
+      bool isFallback = false;
+      ParseBooleanProperty(&isFallback, err, detail::GetValue(meshoptIt),
+                           "fallback", false);
+      if (isFallback) {
+        ParseStringProperty(&buffer->name, err, o, "name", false);
+        ParseExtensionsProperty(&buffer->extensions, err, o);
+        ParseExtrasProperty(&buffer->extras, o);
+        return true;
+      }
+    }
+  }
+
   // having an empty uri for a non embedded image should not be valid
   if (!is_binary && buffer->uri.empty()) {
     if (err) {
@@ -4226,9 +4325,8 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const detail::json &o,
         if (!uri_cb->decode(buffer->uri, &decoded_uri, uri_cb->user_data)) {
           return false;
         }
-        if (!LoadExternalFile(&buffer->data, err, /* warn */ nullptr,
-                              decoded_uri, basedir, /* required */ true,
-                              byteLength, /* checkSize */ true, fs)) {
+        if (!LoadExternalBuffer(buffer, err, decoded_uri, basedir, byteLength,
+                                fs)) {
           return false;
         }
       }
@@ -4253,9 +4351,16 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const detail::json &o,
         return false;
       }
 
-      // Read buffer data
-      buffer->data.resize(static_cast<size_t>(byteLength));
-      memcpy(&(buffer->data.at(0)), bin_data, static_cast<size_t>(byteLength));
+      if (fs->MapWholeFile) {
+        // Memory passed to `LoadBinaryFromMemory` is owned by the application
+        buffer->mapped_data = bin_data;
+        buffer->mapped_size = static_cast<size_t>(byteLength);
+      } else {
+        // Read buffer data
+        buffer->data.resize(static_cast<size_t>(byteLength));
+        memcpy(&(buffer->data.at(0)), bin_data,
+               static_cast<size_t>(byteLength));
+      }
     }
 
   } else {
@@ -4274,9 +4379,8 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const detail::json &o,
       if (!uri_cb->decode(buffer->uri, &decoded_uri, uri_cb->user_data)) {
         return false;
       }
-      if (!LoadExternalFile(&buffer->data, err, /* warn */ nullptr, decoded_uri,
-                            basedir, /* required */ true, byteLength,
-                            /* checkSize */ true, fs)) {
+      if (!LoadExternalBuffer(buffer, err, decoded_uri, basedir, byteLength,
+                              fs)) {
         return false;
       }
     }
@@ -4655,7 +4759,7 @@ static bool ParseDracoExtension(Primitive *primitive, Model *model,
   view.dracoDecoded = true;
 
   const char *bufferViewData =
-      reinterpret_cast<const char *>(buffer.data.data() + view.byteOffset);
+      reinterpret_cast<const char *>(buffer.GetData() + view.byteOffset);
   size_t bufferViewSize = view.byteLength;
 
   // decode draco
@@ -6111,6 +6215,15 @@ bool TinyGLTF::LoadFromString(Model *model, std::string *err, std::string *warn,
           return false;
         }
         const Buffer &buffer = model->buffers[size_t(bufferView.buffer)];
+        if (bufferView.byteOffset + bufferView.byteLength > buffer.GetSize()) {
+          if (err) {
+            std::stringstream ss;
+            ss << "image[" << idx << "] bufferView \"" << image.bufferView
+               << "\" is out of its buffer." << std::endl;
+            (*err) += ss.str();
+          }
+          return false;
+        }
 
         if (*LoadImageData == nullptr) {
           if (err) {
@@ -6120,7 +6233,7 @@ bool TinyGLTF::LoadFromString(Model *model, std::string *err, std::string *warn,
         }
         bool ret = LoadImageData(
             &image, idx, err, warn, image.width, image.height,
-            &buffer.data[bufferView.byteOffset],
+            buffer.GetData() + bufferView.byteOffset,
             static_cast<int>(bufferView.byteLength), load_image_user_data);
         if (!ret) {
           return false;
@@ -6531,8 +6644,28 @@ bool TinyGLTF::LoadBinaryFromFile(Model *model, std::string *err,
     return false;
   }
 
-  std::vector<unsigned char> data;
+  std::string basedir = GetBaseDir(filename);
   std::string fileerr;
+
+  // The BIN chunk is referenced by buffers, so the file stays mapped
+  if (fs.MapWholeFile) {
+    const unsigned char *mapped_data = nullptr;
+    size_t mapped_size = 0;
+    if (!fs.MapWholeFile(&mapped_data, &mapped_size, &fileerr, filename,
+                         fs.user_data)) {
+      ss << "Failed to map file: " << filename << ": " << fileerr << std::endl;
+      if (err) {
+        (*err) = ss.str();
+      }
+      return false;
+    }
+
+    return LoadBinaryFromMemory(model, err, warn, mapped_data,
+                                static_cast<unsigned int>(mapped_size),
+                                basedir, check_sections);
+  }
+
+  std::vector<unsigned char> data;
   bool fileread = fs.ReadWholeFile(&data, &fileerr, filename, fs.user_data);
   if (!fileread) {
     ss << "Failed to read file: " << filename << ": " << fileerr << std::endl;
@@ -6542,8 +6675,6 @@ bool TinyGLTF::LoadBinaryFromFile(Model *model, std::string *err,
     return false;
   }
 
-  std::string basedir = GetBaseDir(filename);
-
   bool ret = LoadBinaryFromMemory(model, err, warn, &data.at(0),
                                   static_cast<unsigned int>(data.size()),
                                   basedir, check_sections);
@@ -1,6 +1,11 @@
 -- Fix missing targets file issue in some C++ nuget packages
 -- Ref: https://github.com/premake/premake-core/pull/2025
 
+newoption {
+    trigger = "heap-allocation-counting",
+    description = "Count heap allocations per frame in Release too",
+}
+
 workspace "benzin"
     location "../"
 
@@ -40,6 +45,11 @@ workspace "benzin"
             "BENZIN_RELEASE_BUILD",
         }
 
+    filter "options:heap-allocation-counting"
+        defines {
+            "BENZIN_HEAP_ALLOCATION_COUNTING",
+        }
+
     filter "files:**.hlsl"
         buildaction "None"
 
@@ -55,6 +65,7 @@ local packages_dir = solution_dir .. "packages/"
 local third_party_source_dir = source_dir .. "third_party/"
 local benzin_source_dir = source_dir .. "benzin/"
 local sandbox_source_dir = source_dir .. "sandbox/"
+local tests_source_dir = source_dir .. "tests/"
 local shaders_source_dir = source_dir .. "shaders/"
 
 local cpp_language = "C++"
@@ -164,3 +175,34 @@ project "sandbox"
             shaders_source_dir .. "**.hlsli"
         }
 	}
+
+project "tests"
+    kind "ConsoleApp"
+    language(cpp_language)
+    cppdialect(cpp_version)
+    location(tests_source_dir)
+
+    targetdir(bin_dir)
+    objdir(build_dir .. "%{prj.name}/%{cfg.buildcfg}")
+
+    pchheader "bootstrap.hpp"
+    pchsource(tests_source_dir .. "bootstrap.cpp")
+
+    links {
+        "benzin",
+    }
+
+    files {
+        tests_source_dir .. "**.hpp",
+        tests_source_dir .. "**.cpp",
+    }
+
+    includedirs {
+        packages_dir .. "**/include",
+        source_dir,
+    }
+
+    libdirs {
+        packages_dir .. "**/bin/x64/",
+        third_party_source_dir .. "nvapi/amd64",
+    }